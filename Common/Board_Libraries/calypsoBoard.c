@@ -25,12 +25,21 @@
  */
 #include "calypsoBoard.h"
 #include "events.h"
+#include "debuglog.h"
+#include "inflate.h"
+#include "checksum.h"
 static bool requestPending;
 static bool eventPending;
 static size_t lengthResponse;
 void Calypso_Sendbytes(CALYPSO *self, const char *sendCmd);
 bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd);
+static void Calypso_queueRequest(CALYPSO *self, const char *request, size_t length);
+static bool Calypso_finishRequest(CALYPSO *self, bool resetConfirmState);
+static bool Calypso_fileWaitChunk(Calypso_File_t *file, bool resend);
 void Calypso_HandleEvents(CALYPSO *self);
+static void Calypso_queueRead(uint8_t *data, uint16_t length);
+static void Calypso_queueMQTTMessage(const char *arguments);
+static void Calypso_MQTTonPuback();
 static void Calypso_HandleRxLine(CALYPSO *self, char *rxPacket,
                                  uint16_t rxLength);
 bool Calypso_waitForReply(CALYPSO *self, Calypso_CNFStatus_t expectedStatus,
@@ -38,19 +47,20 @@ bool Calypso_waitForReply(CALYPSO *self, Calypso_CNFStatus_t expectedStatus,
 bool Calypso_appendArgumentString(char *pOutString, const char *pInArgument,
                                   char delimeter);
 void Calypso_RxBytes(CALYPSO *self);
+static void Calypso_dropStaleLine(CALYPSO *self);
 bool Calypso_waitForEvent(CALYPSO *self);
 bool Calypso_MQTTCreate(CALYPSO *self);
 bool Calypso_MQTTCreate_AWS(CALYPSO *self);
 bool Calypso_MQTTConnToBroker(CALYPSO *self);
 bool Calypso_MQTTSet(CALYPSO *self);
 bool ATFile_open(CALYPSO *self, const char *fileName, uint32_t options,
-                 uint16_t fileSize, uint32_t *fileID, uint32_t *secureToken);
+                 uint32_t fileSize, uint32_t *fileID, uint32_t *secureToken);
 bool ATFile_close(CALYPSO *self, uint32_t fileID, char *certFileName,
                   char *signature);
 bool ATFile_write(CALYPSO *self, uint32_t fileID, uint16_t offset,
                   Calypso_DataFormat_t format, bool encodeToBase64,
                   uint16_t bytestoWrite, char *data, uint16_t *writtenBytes);
-bool ATFile_read(CALYPSO *self, uint32_t fileID, uint16_t offset,
+bool ATFile_read(CALYPSO *self, uint32_t fileID, uint32_t offset,
                  Calypso_DataFormat_t format, uint16_t bytesToRead,
                  Calypso_DataFormat_t *pOutFormat, uint16_t *byteRead,
                  char *data);
@@ -61,6 +71,86 @@ static char RxBuffer[CALYPSO_LINE_MAX_SIZE]; /* data buffer for RX */
 char requestBuffer[CALYPSO_LINE_MAX_SIZE];
 char *pRequestCommand;
 static uint16_t rxByteCounter = 0;
+static bool rxDiscardLine = false;    /* Skip to the next line end after an overflow */
+static unsigned long rxLastByteUs = 0; /* Time of the last byte received */
+
+#if (CALYPSO_MQTT_QUEUE_SIZE & (CALYPSO_MQTT_QUEUE_SIZE - 1)) != 0
+#error "CALYPSO_MQTT_QUEUE_SIZE must be a power of 2"
+#endif
+
+/* Received MQTT messages, filled from the RX path while waiting for any
+ * response and emptied by Calypso_MQTTgetMessage. Record layout: uint16_t
+ * topic length, uint16_t data length, then the topic and the data. */
+#define MQTT_QUEUE_HEADER_SIZE (2 * sizeof(uint16_t))
+static uint8_t mqttQueue[CALYPSO_MQTT_QUEUE_SIZE];
+static uint16_t mqttQueueHead = 0; /* Free running */
+static uint16_t mqttQueueTail = 0;
+static uint32_t mqttQueueDropped = 0;
+
+/* QoS 1 publications in the order they were sent. The PUBACK event of
+ * Calypso carries no packet id, the broker acknowledges each PUBLISH in the
+ * order it received them. A message published again after a timeout keeps
+ * its place for the late PUBACK of its first transmission (QoS 1 allows
+ * the duplicate). The PUBACK of the duplicate comes after the one of the
+ * newest message, it is skipped once that message is acknowledged. If the
+ * first PUBACK was lost instead, the skip takes the PUBACK of the next
+ * message: that message times out with a skipped PUBACK since it was sent
+ * and is taken as acknowledged by it. */
+typedef struct
+{
+    unsigned long sentMs;
+    uint8_t transmissions;
+    uint8_t extraAcks; /* PUBACKs of duplicates that come after its own */
+    uint16_t length;   /* Of the kept command, 0 if it was too long */
+    Calypso_MQTTAckCallback_t callback;
+    void *context;
+    char command[CALYPSO_MQTT_RETRY_SIZE];
+} Calypso_MQTTInFlight_t;
+static Calypso_MQTTInFlight_t mqttInFlight[CALYPSO_MQTT_INFLIGHT];
+static uint8_t mqttInFlightHead = 0;
+static uint8_t mqttInFlightCount = 0;
+/* PUBACKs of duplicates or of messages given up due before the one of the
+ * oldest message in flight, and the time the last one was skipped */
+static uint8_t mqttSkipAcks = 0;
+static bool mqttSkippedAck = false;
+static unsigned long mqttSkippedMs = 0;
+static Calypso_MQTTStats_t mqttStats;
+/* Bit 8 of the connack code, the broker kept the subscriptions */
+static bool mqttSessionPresent = false;
+/* Commands sent since the last answer of Calypso, of any kind */
+static uint8_t unansweredRequests = 0;
+/* Commands sent to Calypso, each retry and each chunk of a file counted */
+static uint32_t requestCount = 0;
+/* The chunk of the open file is kept in the request buffer behind the room
+ * of the AT+fileWrite header, so a chunk is sent without a copy and no file
+ * object holds a buffer on the stack. The CRLF ends the line. */
+#define CALYPSO_FILE_DATA_OFFSET (CALYPSO_FILE_HEADER_MAX - 2)
+static uint8_t *const fileData = (uint8_t *)&requestBuffer[CALYPSO_FILE_DATA_OFFSET];
+/* The open file has data in the request buffer, and a request overwrote
+ * it. The flags belong to the module, the file object is the caller's. */
+static bool fileBuffered = false;
+static bool fileBufferLost = false;
+/* File with a chunk sent and its answer not read yet, the AT+fileWrite of
+ * the chunk is kept in the request buffer for a retransmission */
+static Calypso_File_t *fileInFlight = NULL;
+static const char *fileRequest = NULL;
+static uint16_t fileRequestLength = 0;
+/* Files found or not found since the module started, by FNV-1a hash of the
+ * path. The files only change through this file, except the ones uploaded
+ * to the web server while provisioning, which ends with a reboot. */
+typedef struct
+{
+    uint32_t pathHash;
+    bool exists;
+} Calypso_FileCacheEntry_t;
+static Calypso_FileCacheEntry_t fileCache[CALYPSO_FILE_CACHE_SIZE];
+static uint8_t fileCacheCount = 0;
+static uint8_t fileCacheNext = 0; /* Entry replaced once full */
+static void Calypso_fileCacheSet(const char *path, bool exists);
+static void Calypso_fileCacheClear();
+static bool Calypso_getInfo(CALYPSO *self, const char *path);
+static bool Calypso_fileOpenWriteOptions(CALYPSO *self, Calypso_File_t *file, const char *path, uint32_t maxSize,
+                                         uint32_t options);
 char eventbuffer[CALYPSO_LINE_MAX_SIZE];
 char eventArguments[CALYPSO_LINE_MAX_SIZE];
 char *pEventBuffer;
@@ -86,6 +176,8 @@ CALYPSO *Calypso_Create(TypeSerial *serialDebug,
     allocateInit->settings.mqttSettings = settings->mqttSettings;
     allocateInit->settings.sntpSettings = settings->sntpSettings;
     rxByteCounter = 0;
+    rxDiscardLine = false;
+    Calypso_fileCacheClear();
 
     memset(allocateInit->MAC_ADDR, '\0',
            sizeof(allocateInit->MAC_ADDR));
@@ -107,6 +199,7 @@ void Calypso_Destroy(CALYPSO *calypso)
     if (calypso)
     {
         rxByteCounter = 0;
+        rxDiscardLine = false;
         free(calypso);
     }
 }
@@ -118,12 +211,12 @@ void Calypso_Destroy(CALYPSO *calypso)
 bool Calypso_simpleInit(CALYPSO *self)
 {
 #if SERIAL_DEBUG
-    SSerial_printf(self->serialDebug, "Starting Calypso...\r\n");
-    SSerial_printf(self->serialDebug, "Sending reboot\r\n");
+    DebugLog_printf("Starting Calypso...\r\n");
+    DebugLog_printf("Sending reboot\r\n");
 #endif
     if (!Calypso_WLANSetClientMode(self))
     {
-        SSerial_printf(self->serialDebug, "Unable to set Calypso as Wi-Fi client\r\n");
+        DebugLog_printf("Unable to set Calypso as Wi-Fi client\r\n");
         return false;
     }
     if (Calypso_reboot(self))
@@ -140,13 +233,14 @@ bool Calypso_simpleInit(CALYPSO *self)
  */
 bool Calypso_reboot(CALYPSO *self)
 {
+    Calypso_fileCacheClear();
     if (Calypso_SendRequest(self, "AT+reboot\r\n"))
     {
         delay(350);
         if (Calypso_waitForEvent(self))
         {
 #if SERIAL_DEBUG
-            SSerial_printf(self->serialDebug, "%s\r\n", self->bufferCalypso);
+            DebugLog_printf("%s\r\n", self->bufferCalypso);
 #endif
             return true;
         }
@@ -167,7 +261,7 @@ bool Calypso_getTime(CALYPSO *self)
             {
                 char *parameters = &(self->bufferCalypso.data[0]);
                 Calypso_getNextArgumentString(&parameters, dateTime, CONFIRM_DELIM);
-                SSerial_printf(self->serialDebug, "Date-time: %s\r\n", dateTime);
+                DebugLog_printf("Date-time: %s\r\n", dateTime);
                 return true;
             }
         }
@@ -208,13 +302,44 @@ bool Calypso_getUDID(CALYPSO *self)
                         udidArr[10], udidArr[11],
                         udidArr[12], udidArr[13],
                         udidArr[14], udidArr[15]);
-                SSerial_printf(self->serialDebug, "UDID: %s\r\n", self->udid);
+                DebugLog_printf("UDID: %s\r\n", self->udid);
                 return true;
             }
         }
     }
     return false;
 }
+/**
+ * @brief  Handle the lines received since the last call without waiting,
+ *         MQTT messages are queued
+ * @param  self Pointer to the calypso object.
+ * @retval none
+ */
+void Calypso_processRx(CALYPSO *self)
+{
+    while (HSerial_available(self->serialCalypso) > 0)
+    {
+        Calypso_RxBytes(self);
+    }
+}
+/**
+ * @brief  Check if an MQTT message was received, without waiting
+ * @param  self Pointer to the calypso object.
+ * @retval true if Calypso_MQTTgetMessage returns a message
+ */
+bool Calypso_isMessagePending(CALYPSO *self)
+{
+    Calypso_processRx(self);
+    return mqttQueueHead != mqttQueueTail;
+}
+/**
+ * @brief  Get the number of MQTT messages dropped because the queue was full
+ * @retval number of messages
+ */
+uint32_t Calypso_getDroppedMessages()
+{
+    return mqttQueueDropped;
+}
 /**
  * @brief  Check if Calypso has an IP address
  * @param  self Pointer to the calypso object.
@@ -273,6 +398,27 @@ bool Calypso_waitForResponse(CALYPSO *self)
  * @retval true if successful false in case of failure
  */
 bool Calypso_WLANconnect(CALYPSO *self)
+{
+    if (Calypso_WLANstartConnect(self))
+    {
+        if (Calypso_waitForEvent(self))
+        {
+#if SERIAL_DEBUG
+            DebugLog_printf("%s\r\n", self->bufferCalypso);
+#endif
+            return true;
+        }
+    }
+    return false;
+}
+/**
+ * @brief  Start the connection to the access point without waiting for it,
+ *         the status changes to calypso_WLAN_connected once the IP address
+ *         is acquired, see Calypso_waitForStatus
+ * @param  self Pointer to the calypso object.
+ * @retval true if the module accepted the request false otherwise
+ */
+bool Calypso_WLANstartConnect(CALYPSO *self)
 {
     bool ret = false;
     pRequestCommand = &requestBuffer[0];
@@ -288,22 +434,11 @@ bool Calypso_WLANconnect(CALYPSO *self)
     else
     {
 #if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug,
-                       "WiFi connection fail, check parameters\r\n");
+        DebugLog_printf("WiFi connection fail, check parameters\r\n");
 #endif
         return false;
     }
-    if (Calypso_SendRequest(self, pRequestCommand))
-    {
-        if (Calypso_waitForEvent(self))
-        {
-#if SERIAL_DEBUG
-            SSerial_printf(self->serialDebug, "%s\r\n", self->bufferCalypso);
-#endif
-            return true;
-        }
-    }
-    return false;
+    return Calypso_SendRequest(self, pRequestCommand);
 }
 /**
  * @brief  Disconnect from access point
@@ -339,6 +474,35 @@ bool Calypso_WLANSetClientMode(CALYPSO *self)
     sprintf(pRequestCommand, "AT+wlansetmode=STA\r\n");
     return (Calypso_SendRequest(self, pRequestCommand));
 }
+/**
+ * @brief  Set the power management policy of the WLAN. The module sleeps
+ *         between the beacons it listens to, with long_sleep for up to
+ *         maxSleepMs, which delays the downlink messages by as much.
+ * @param  self Pointer to the calypso object.
+ * @param  policy Power policy
+ * @param  maxSleepMs Longest sleep for calypso_power_long_sleep, ignored otherwise
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_WLANSetPowerPolicy(CALYPSO *self, Calypso_powerPolicy_t policy, uint16_t maxSleepMs)
+{
+    static const char *policies[] = {"normal", "low_latency", "low_power", "always_on", "long_sleep"};
+
+    if (policy > calypso_power_long_sleep)
+    {
+        return false;
+    }
+    pRequestCommand = &requestBuffer[0];
+    memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
+    if (policy == calypso_power_long_sleep)
+    {
+        sprintf(pRequestCommand, "AT+wlanPolicySet=PM,%s,%u,\r\n", policies[policy], maxSleepMs);
+    }
+    else
+    {
+        sprintf(pRequestCommand, "AT+wlanPolicySet=PM,%s,,\r\n", policies[policy]);
+    }
+    return (Calypso_SendRequest(self, pRequestCommand));
+}
 /**
  * @brief  Start provisioning
  * @param  self Pointer to the calypso object.
@@ -349,6 +513,7 @@ bool Calypso_StartProvisioning(CALYPSO *self)
     pRequestCommand = &requestBuffer[0];
     memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
     strcpy(pRequestCommand, "AT+provisioningStart\r\n");
+    Calypso_fileCacheClear();
     return (Calypso_SendRequest(self, pRequestCommand));
 }
 /**
@@ -387,7 +552,7 @@ bool Calypso_setUpSNTP(CALYPSO *self)
     if (!Calypso_SendRequest(self, pRequestCommand))
     {
 #if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug, "SNTP time_zone set fail\r\n");
+        DebugLog_printf("SNTP time_zone set fail\r\n");
 #endif
         return false;
     }
@@ -401,7 +566,7 @@ bool Calypso_setUpSNTP(CALYPSO *self)
     if (!Calypso_SendRequest(self, pRequestCommand))
     {
 #if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug, "SNTP set server failed\r\n");
+        DebugLog_printf("SNTP set server failed\r\n");
 #endif
         return false;
     }
@@ -413,7 +578,7 @@ bool Calypso_setUpSNTP(CALYPSO *self)
     if (!Calypso_SendRequest(self, pRequestCommand))
     {
 #if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug, "SNTP enable failed\r\n");
+        DebugLog_printf("SNTP enable failed\r\n");
 #endif
         return false;
     }
@@ -468,7 +633,7 @@ bool Calypso_getTimestamp(CALYPSO *self, Timestamp *timeStamp)
     else
     {
 #if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug, "SNTP get time failed \r\n");
+        DebugLog_printf("SNTP get time failed \r\n");
 #endif
     }
     return false;
@@ -490,6 +655,46 @@ bool Calypso_MQTTconnect(CALYPSO *self)
     return false;
 }
 
+/**
+ * @brief  Connect again the MQTT client created by Calypso_MQTTconnect, e.g.
+ *         after the broker closed the connection. One round trip, the
+ *         client settings are kept by Calypso.
+ * @param  self Pointer to the calypso object.
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_MQTTreconnect(CALYPSO *self)
+{
+    return Calypso_MQTTConnToBroker(self);
+}
+
+/**
+ * @brief  Check if the broker kept the session of the last connection
+ * @retval true if the subscriptions are still active
+ */
+bool Calypso_MQTTisSessionPresent()
+{
+    return mqttSessionPresent;
+}
+
+/**
+ * @brief  Get the number of commands sent since Calypso last answered
+ * @retval number of commands, each retry counted
+ */
+uint8_t Calypso_getUnansweredRequests()
+{
+    return unansweredRequests;
+}
+
+/**
+ * @brief  Get the number of commands sent to Calypso, e.g. to count the
+ *         round trips of a boot
+ * @retval number of commands, each retry and each chunk of a file counted
+ */
+uint32_t Calypso_getRequestCount()
+{
+    return requestCount;
+}
+
 bool Calypso_MQTTconnect_AWS(CALYPSO *self)
 {
     if (Calypso_MQTTCreate(self))
@@ -528,7 +733,8 @@ bool Calypso_subscribe(CALYPSO *self, uint8_t index, uint8_t numOfTopics, ATMQTT
     return ret;
 }
 /**
- *Waits for MQTT recv event, parses, decodes and response and places it into the data/topic buffer
+ *Takes the oldest received MQTT message from the queue, decodes it and places it into the data/topic buffer.
+ *Does not wait, the topic is empty if no message was received.
  *
  *input:
  * -self          Calypso object
@@ -539,20 +745,25 @@ bool Calypso_subscribe(CALYPSO *self, uint8_t index, uint8_t numOfTopics, ATMQTT
  */
 bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded)
 {
-    if (!Calypso_waitForResponse(self))
+    uint16_t lengths[2];
+
+    Calypso_processRx(self);
+    if (mqttQueueHead == mqttQueueTail)
     {
+        self->topicName.data[0] = '\0';
+        self->topicName.length = 0;
         return false;
     }
-    if (self->topicName.length != 0)
-    {
+    Calypso_queueRead((uint8_t *)lengths, sizeof(lengths));
+    Calypso_queueRead((uint8_t *)self->topicName.data, lengths[0]);
+    self->topicName.data[lengths[0]] = '\0';
+    self->topicName.length = lengths[0];
+    Calypso_queueRead((uint8_t *)self->bufferCalypso.data, lengths[1]);
+    self->bufferCalypso.data[lengths[1]] = '\0';
+    self->bufferCalypso.length = lengths[1];
 #if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug, "topic[%i]:%s\r\n", self->topicName.length, self->topicName.data);
+    DebugLog_printf("topic[%i]:%s\r\n", self->topicName.length, self->topicName.data);
 #endif
-    }
-    else
-    {
-        return false;
-    }
     if (self->bufferCalypso.length != 0)
     {
         if (encoded)
@@ -567,65 +778,392 @@ bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded)
 #if SERIAL_DEBUG
         if (self->bufferCalypso.length > 0)
         {
-            SSerial_printf(self->serialDebug, "Data[%i]:%s\r\n", self->bufferCalypso.length, self->bufferCalypso.data);
+            DebugLog_printf("Data[%i]:%s\r\n", self->bufferCalypso.length, self->bufferCalypso.data);
+        }
+#endif
+    }
+    return true;
+}
+/**
+ * @brief  Wait for a received MQTT message, for a request answered by the
+ *         broker during the connection
+ * @param  self Pointer to the calypso object.
+ * @param  encoded Base64 encoded payload
+ * @param  timeoutMs Longest wait
+ * @retval true if a message was placed into the data/topic buffer
+ */
+bool Calypso_MQTTwaitMessage(CALYPSO *self, bool encoded, unsigned long timeoutMs)
+{
+    unsigned long startTime = millis();
+
+    while (!Calypso_MQTTgetMessage(self, encoded))
+    {
+        if (millis() - startTime >= timeoutMs)
+        {
+            return false;
+        }
+        DebugLog_drain(1);
+    }
+    return true;
+}
+/**
+ * @brief  Remove the oldest message in flight and tell its publisher
+ * @param  acked true on its PUBACK, false if it was given up
+ * @retval None
+ */
+static void Calypso_MQTTpopInFlight(bool acked)
+{
+    Calypso_MQTTAckCallback_t callback = mqttInFlight[mqttInFlightHead].callback;
+    void *context = mqttInFlight[mqttInFlightHead].context;
+
+    mqttInFlightHead = (mqttInFlightHead + 1) % CALYPSO_MQTT_INFLIGHT;
+    mqttInFlightCount--;
+    if (callback != NULL)
+    {
+        callback(context, acked);
+    }
+}
+
+/**
+ * @brief  Check if the newest entry in flight is still the one at slot
+ * @param  slot Index of the entry in mqttInFlight
+ * @retval true if it is, false if it was acknowledged meanwhile
+ */
+static bool Calypso_MQTTisNewest(uint8_t slot)
+{
+    return (mqttInFlightCount > 0) &&
+           (((mqttInFlightHead + mqttInFlightCount - 1) % CALYPSO_MQTT_INFLIGHT) == slot);
+}
+
+/**
+ * @brief  Skip PUBACKs due before the one of the oldest message in flight
+ * @param  count PUBACKs to skip
+ * @retval None
+ */
+static void Calypso_MQTTskipAcks(uint8_t count)
+{
+    mqttSkipAcks = ((uint16_t)mqttSkipAcks + count > UINT8_MAX) ? UINT8_MAX : (mqttSkipAcks + count);
+}
+
+/**
+ * @brief  Handle a PUBACK event: a duplicate or the oldest message in
+ *         flight is acknowledged
+ * @retval None
+ */
+static void Calypso_MQTTonPuback()
+{
+    unsigned long ackMs;
+
+    if (mqttSkipAcks > 0)
+    {
+        mqttSkipAcks--;
+        mqttSkippedAck = true;
+        mqttSkippedMs = millis();
+        mqttStats.lateAcks++;
+        return;
+    }
+    if (mqttInFlightCount == 0)
+    {
+        mqttStats.strayAcks++;
+        return;
+    }
+    Calypso_MQTTskipAcks(mqttInFlight[mqttInFlightHead].extraAcks);
+    ackMs = millis() - mqttInFlight[mqttInFlightHead].sentMs;
+    if (ackMs > mqttStats.maxAckMs)
+    {
+        mqttStats.maxAckMs = ackMs;
+    }
+    mqttStats.acked++;
+    Calypso_MQTTpopInFlight(true);
+}
+
+/**
+ * @brief  Wait for a free slot in the in-flight window, long enough for the
+ *         oldest message to be published again after a lost PUBACK
+ * @param  self Pointer to the calypso object.
+ * @retval true if a QoS 1 message can be published
+ */
+static bool Calypso_MQTTwaitWindow(CALYPSO *self)
+{
+    unsigned long startTime = millis();
+
+    while (mqttInFlightCount >= CALYPSO_MQTT_INFLIGHT)
+    {
+        if ((millis() - startTime) >= (CALYPSO_MQTT_ACK_TIMEOUT + EVENT_WAIT_TIME))
+        {
+            return false;
         }
+        Calypso_MQTTpoll(self);
+        DebugLog_drain(1);
+    }
+    return true;
+}
+
+/**
+ * @brief  Publish data, see Calypso_MQTTPublishData
+ * @param  callback Called when a QoS 1 message leaves the in-flight window,
+ *         NULL for none
+ * @param  context Passed to the callback
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_MQTTpublish(CALYPSO *self, char *topic, ATMQTT_QoS_t qos, uint8_t retain, char *data,
+                                int length, bool encode, Calypso_MQTTAckCallback_t callback, void *context)
+{
+    bool ret = false;
+    int index = MQTT_SOCKET_INDEX;
+    uint8_t slot;
+
+    if (qos > ATMQTT_QOS_QOS1)
+    {
+        qos = ATMQTT_QOS_QOS1;
+    }
+    if (self->status != calypso_MQTT_connected)
+    {
+        mqttStats.dropped++;
+#if SERIAL_DEBUG
+        DebugLog_printf("Publish failed : Not connected to MQTT broker\r\n");
+#endif
+        return false;
+    }
+
+    /* Retransmissions go out before the new message */
+    Calypso_MQTTpoll(self);
+    if ((qos == ATMQTT_QOS_QOS1) && !Calypso_MQTTwaitWindow(self))
+    {
+        mqttStats.dropped++;
+#if SERIAL_DEBUG
+        DebugLog_printf("Publish failed : %u messages waiting for PUBACK\r\n", mqttInFlightCount);
 #endif
+        return false;
+    }
+    slot = (mqttInFlightHead + mqttInFlightCount) % CALYPSO_MQTT_INFLIGHT;
+
+    pRequestCommand = &requestBuffer[0];
+    memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
+    strcpy(pRequestCommand, "AT+mqttPublish=");
+    if (encode)
+    {
+        uint32_t elen = 0;
+        char out[CALYPSO_LINE_MAX_SIZE];
+        Calypso_encodeBase64((uint8_t *)data, length, (uint8_t *)out,
+                             &elen);
+        ret =
+            ATMQTT_addArgumentsPublish(pRequestCommand, index, topic,
+                                       qos, retain, elen, out);
     }
+    else
+    {
+        ret = ATMQTT_addArgumentsPublish(pRequestCommand, index, topic,
+                                         qos, retain, length,
+                                         data);
+    }
+    if (!ret)
+    {
+        mqttStats.dropped++;
+        return false;
+    }
+
+    if (qos == ATMQTT_QOS_QOS1)
+    {
+        /* In flight before sending, the PUBACK may come with the OK */
+        Calypso_MQTTInFlight_t *entry = &mqttInFlight[slot];
+        size_t commandLength = strlen(pRequestCommand);
+
+        entry->sentMs = millis();
+        entry->transmissions = 1;
+        entry->extraAcks = 0;
+        entry->callback = callback;
+        entry->context = context;
+        entry->length = (commandLength < CALYPSO_MQTT_RETRY_SIZE) ? commandLength : 0;
+        if (entry->length != 0)
+        {
+            memcpy(entry->command, pRequestCommand, commandLength + 1);
+        }
+        mqttInFlightCount++;
+    }
+    if (!Calypso_SendRequest(self, pRequestCommand))
+    {
+        /* Unless its PUBACK came with the error */
+        if ((qos == ATMQTT_QOS_QOS1) && Calypso_MQTTisNewest(slot))
+        {
+            mqttInFlightCount--;
+        }
+        mqttStats.dropped++;
+        return false;
+    }
+    mqttStats.published[qos]++;
     return true;
 }
+
 /**
- * @brief  Publish data to the MQTT broker
+ * @brief  Publish data to the MQTT broker. Returns once Calypso accepted the
+ *         message, a QoS 1 message then stays in flight until its PUBACK.
  * @param  self Pointer to the calypso object.
  * @param  topic Pointer to MQTT topic
+ * @param  qos ATMQTT_QOS_QOS0 for data sent again at the next interval,
+ *         ATMQTT_QOS_QOS1 for messages that must be delivered. QoS 2 is
+ *         published as QoS 1.
  * @param  retain 0=do not retain, 1=retain message
  * @param  data Pointer to the data to be published
  * @param  length data length
  * @param  encode 0=do not encode, 1=base64 encode
  * @retval true if successful false in case of failure
  */
-bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, uint8_t retain,
+bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, ATMQTT_QoS_t qos, uint8_t retain,
                              char *data, int length, bool encode)
 {
-    bool ret = false;
-    int index = MQTT_SOCKET_INDEX;
-    pRequestCommand = &requestBuffer[0];
-    if (self->status == calypso_MQTT_connected)
+    return Calypso_MQTTpublish(self, topic, qos, retain, data, length, encode, NULL, NULL);
+}
+
+/**
+ * @brief  Publish data with QoS 1 and tell the publisher when the message is
+ *         acknowledged or given up. The callback is not called if the
+ *         publish fails.
+ * @param  self Pointer to the calypso object.
+ * @param  topic Pointer to MQTT topic
+ * @param  retain 0=do not retain, 1=retain message
+ * @param  data Pointer to the data to be published
+ * @param  length data length
+ * @param  encode 0=do not encode, 1=base64 encode
+ * @param  callback Called once when the message leaves the in-flight window
+ * @param  context Passed to the callback
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_MQTTPublishAcked(CALYPSO *self, char *topic, uint8_t retain, char *data, int length, bool encode,
+                              Calypso_MQTTAckCallback_t callback, void *context)
+{
+    return Calypso_MQTTpublish(self, topic, ATMQTT_QOS_QOS1, retain, data, length, encode, callback, context);
+}
+
+/**
+ * @brief  Handle the PUBACKs received and publish again the QoS 1 messages
+ *         not acknowledged within CALYPSO_MQTT_ACK_TIMEOUT. A message is
+ *         given up after CALYPSO_MQTT_MAX_RETRANSMITS retransmissions, its
+ *         PUBACK may still come and is skipped.
+ * @param  self Pointer to the calypso object.
+ * @retval None
+ */
+void Calypso_MQTTpoll(CALYPSO *self)
+{
+    Calypso_processRx(self);
+    while (mqttInFlightCount > 0)
     {
-        memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
-        strcpy(pRequestCommand, "AT+mqttPublish=");
-        if (encode)
+        Calypso_MQTTInFlight_t *entry = &mqttInFlight[mqttInFlightHead];
+        uint8_t newest = (mqttInFlightHead + mqttInFlightCount - 1) % CALYPSO_MQTT_INFLIGHT;
+
+        if ((millis() - entry->sentMs) < CALYPSO_MQTT_ACK_TIMEOUT)
         {
-            uint32_t elen = 0;
-            char out[CALYPSO_LINE_MAX_SIZE];
-            Calypso_encodeBase64((uint8_t *)data, length, (uint8_t *)out,
-                                 &elen);
-            ret =
-                ATMQTT_addArgumentsPublish(pRequestCommand, index, topic,
-                                           ATMQTT_QOS_QOS1, retain, elen, out);
+            break;
         }
-        else
+        if (self->status != calypso_MQTT_connected)
         {
-            ret = ATMQTT_addArgumentsPublish(pRequestCommand, index, topic,
-                                             ATMQTT_QOS_QOS1, retain, length,
-                                             data);
+            /* The PUBACKs of the session are lost */
+            mqttSkipAcks = 0;
+            mqttSkippedAck = false;
+            mqttStats.unacked++;
+            Calypso_MQTTpopInFlight(false);
+            continue;
         }
-        if (ret)
+        if ((entry->transmissions > CALYPSO_MQTT_MAX_RETRANSMITS) || (entry->length == 0))
+        {
+            mqttStats.unacked++;
+            Calypso_MQTTskipAcks(1 + entry->extraAcks);
+            Calypso_MQTTpopInFlight(false);
+            continue;
+        }
+        if (mqttSkippedAck && ((long)(mqttSkippedMs - entry->sentMs) >= 0))
+        {
+            /* The PUBACK skipped was its own, the one of a duplicate was lost */
+            unsigned long ackMs = mqttSkippedMs - entry->sentMs;
+
+            mqttSkippedAck = false;
+            mqttStats.lateAcks--;
+            mqttStats.acked++;
+            if (ackMs > mqttStats.maxAckMs)
+            {
+                mqttStats.maxAckMs = ackMs;
+            }
+            Calypso_MQTTskipAcks(entry->extraAcks);
+            Calypso_MQTTpopInFlight(true);
+            continue;
+        }
+
+        /* The message keeps its place, the PUBACK of the duplicate comes
+         * after the one of the newest message */
+        entry->transmissions++;
+        entry->sentMs = millis();
+        mqttInFlight[newest].extraAcks++;
+        mqttStats.retransmitted++;
+        if (!Calypso_SendRequest(self, entry->command))
         {
-            if (Calypso_SendRequest(self, pRequestCommand))
+            if (Calypso_MQTTisNewest(newest))
             {
-                return (Calypso_waitForEvent(self));
+                mqttInFlight[newest].extraAcks--;
             }
+            else if (mqttSkipAcks > 0)
+            {
+                mqttSkipAcks--;
+            }
+            entry->length = 0;
         }
     }
-    else
+}
+
+/**
+ * @brief  Wait until all QoS 1 messages are acknowledged or given up
+ * @param  self Pointer to the calypso object.
+ * @param  timeoutMs Longest wait
+ * @retval true if no message is in flight
+ */
+bool Calypso_MQTTflush(CALYPSO *self, unsigned long timeoutMs)
+{
+    unsigned long startTime = millis();
+
+    while ((mqttInFlightCount > 0) && ((millis() - startTime) < timeoutMs))
     {
-#if SERIAL_DEBUG
-        SSerial_printf(self->serialDebug,
-                       "Publish failed : Not connected to MQTT broker\r\n");
-#endif
+        Calypso_MQTTpoll(self);
+        DebugLog_drain(1);
     }
-    return false;
+    return (mqttInFlightCount == 0);
+}
+
+/**
+ * @brief  Get the publish counters
+ * @param  stats Counters since the last reset
+ * @retval None
+ */
+void Calypso_MQTTgetStats(Calypso_MQTTStats_t *stats)
+{
+    *stats = mqttStats;
+    stats->inFlight = mqttInFlightCount;
+}
+
+/**
+ * @brief  Reset the publish counters, the messages in flight are kept
+ * @retval None
+ */
+void Calypso_MQTTresetStats()
+{
+    memset(&mqttStats, 0, sizeof(mqttStats));
 }
+
+/**
+ * @brief  Print the publish counters
+ * @param  serial Output serial port
+ * @retval None
+ */
+void Calypso_MQTTprintStats(TypeSerial *serial)
+{
+    SSerial_printf(serial,
+                   "publish %lu qos0, %lu qos1: %lu acked (max %lu ms), %lu retransmitted, %lu unacked, "
+                   "%lu dropped, %lu stray acks, %lu late acks, %u in flight\r\n",
+                   (unsigned long)mqttStats.published[0], (unsigned long)mqttStats.published[1],
+                   (unsigned long)mqttStats.acked, (unsigned long)mqttStats.maxAckMs,
+                   (unsigned long)mqttStats.retransmitted, (unsigned long)mqttStats.unacked,
+                   (unsigned long)mqttStats.dropped, (unsigned long)mqttStats.strayAcks,
+                   (unsigned long)mqttStats.lateAcks, mqttInFlightCount);
+}
+
 /**
  * @brief  Set MQTT username with parameter in the settings
  * @param  self Pointer to the calypso object.
@@ -795,185 +1333,681 @@ bool Calypso_fileList(CALYPSO *self)
     return (Calypso_SendRequest(self, pRequestCommand));
 }
 /**
- * @brief  Get the list of files in the file system
- * @param  self Pointer to the calypso object.
- * @retval true if successful false in case of failure
+ * @brief  Find a file in the cache of the files found or not found
+ * @param  pathHash FNV-1a hash of the path
+ * @retval Entry of the file, NULL if unknown
+ */
+static Calypso_FileCacheEntry_t *Calypso_fileCacheFind(uint32_t pathHash)
+{
+    for (uint8_t i = 0; i < fileCacheCount; i++)
+    {
+        if (fileCache[i].pathHash == pathHash)
+        {
+            return &fileCache[i];
+        }
+    }
+    return NULL;
+}
+/**
+ * @brief  Keep whether a file exists, the oldest entry is replaced once the
+ *         cache is full
+ * @param  path Pointer to the file path including the filename
+ * @param  exists true if the file exists
+ * @retval None
+ */
+static void Calypso_fileCacheSet(const char *path, bool exists)
+{
+    uint32_t pathHash = Checksum_fnv1aString(CHECKSUM_FNV1A_INIT, path);
+    Calypso_FileCacheEntry_t *entry = Calypso_fileCacheFind(pathHash);
+
+    if (entry == NULL)
+    {
+        if (fileCacheCount < CALYPSO_FILE_CACHE_SIZE)
+        {
+            entry = &fileCache[fileCacheCount++];
+        }
+        else
+        {
+            entry = &fileCache[fileCacheNext];
+            fileCacheNext = (fileCacheNext + 1) % CALYPSO_FILE_CACHE_SIZE;
+        }
+        entry->pathHash = pathHash;
+    }
+    entry->exists = exists;
+}
+/**
+ * @brief  Forget all the files, e.g. when the web server may write files
+ * @retval None
+ */
+static void Calypso_fileCacheClear()
+{
+    fileCacheCount = 0;
+    fileCacheNext = 0;
+}
+/**
+ * @brief  Get the info of a file and keep whether it exists. A file is only
+ *         taken for missing if Calypso answered with an error.
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_getInfo(CALYPSO *self, const char *path)
+{
+    bool ret = ATFile_getInfo(self, path, 0);
+
+    if (ret || (cmdConfirmation == Calypso_CNFStatus_Failed))
+    {
+        Calypso_fileCacheSet(path, ret);
+    }
+    return ret;
+}
+/**
+ * @brief  Check if a file exists, each file is only looked up once until
+ *         the module reboots
+ * @param  self Pointer to the calypso object.
+ * @param  fileName Pointer to the file path including the filename
+ * @retval true if the file exists
+ */
+bool Calypso_fileExists(CALYPSO *self, const char *fileName)
+{
+    Calypso_FileCacheEntry_t *entry = Calypso_fileCacheFind(Checksum_fnv1aString(CHECKSUM_FNV1A_INIT, fileName));
+
+    if (entry != NULL)
+    {
+        return entry->exists;
+    }
+    return Calypso_getInfo(self, fileName);
+}
+/**
+ * @brief  Delete the file
+ * @param  self Pointer to the calypso object.
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_deleteFile(CALYPSO *self, const char *fileName)
+{
+    bool ret = ATFile_del(self, fileName, 0);
+
+    if (ret || (cmdConfirmation == Calypso_CNFStatus_Failed))
+    {
+        /* Also if it did not exist */
+        Calypso_fileCacheSet(fileName, false);
+    }
+    return ret;
+}
+/**
+ * @brief  Get the size of a file
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  size Size of the file in bytes
+ * @retval true if successful false in case of failure, e.g. no such file
+ */
+bool Calypso_getFileSize(CALYPSO *self, const char *path, uint32_t *size)
+{
+    char *field;
+
+    /* +filegetinfo:flags,size,allocated size,... */
+    if (!Calypso_getInfo(self, path) || (0 != strncmp(self->bufferCalypso.data, "+filegetinfo:", 13)))
+    {
+        return false;
+    }
+    field = strchr(self->bufferCalypso.data, ',');
+    if (field == NULL)
+    {
+        return false;
+    }
+    *size = strtoul(field + 1, NULL, 10);
+    return true;
+}
+
+/**
+ * @brief  Open and read data from a file
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  data Pointer to data buffer, terminated if the file is shorter
+ * @param  dataLength Length of data to read
+ * @param  outputLength Length of read bytes
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_readFile(CALYPSO *self, const char *path, char *data,
+                      uint16_t dataLength, uint16_t *outputLength)
+{
+    Calypso_File_t file;
+    uint32_t bytesRead = 0;
+    bool ret;
+
+    if (!Calypso_fileOpenRead(self, &file, path))
+    {
+        return false;
+    }
+    ret = Calypso_fileRead(&file, data, dataLength, &bytesRead);
+    Calypso_fileClose(&file);
+    if (ret)
+    {
+        if (bytesRead < dataLength)
+        {
+            data[bytesRead] = '\0';
+        }
+        *outputLength = bytesRead;
+    }
+    return ret;
+}
+
+/**
+ * @brief Create/open and write data to a file
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  data Pointer to data to be written
+ * @param  dataLength Length of data to write
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_writeFile(CALYPSO *self, const char *path, const char *data,
+                       uint16_t dataLength)
+{
+    Calypso_File_t file;
+    bool ret;
+
+    if (!Calypso_fileOpenWrite(self, &file, path, dataLength, true))
+    {
+        return false;
+    }
+    ret = Calypso_fileWrite(&file, data, strlen(data));
+    return Calypso_fileClose(&file) && ret;
+}
+
+/**
+ * @brief  Create or overwrite a failsafe file: Calypso keeps the previous
+ *         content until the file is closed, a reset while writing leaves
+ *         the old file. The flag only applies when the file is created, a
+ *         file created without it is overwritten in place.
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  data Pointer to data to be written
+ * @param  dataLength Length of data to write
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_writeFailsafeFile(CALYPSO *self, const char *path, const char *data, uint32_t dataLength)
+{
+    /* Failsafe files take two copies of their max size */
+    uint32_t maxSize = (dataLength < FILE_FAILSAFE_MIN_SIZE) ? FILE_FAILSAFE_MIN_SIZE : dataLength;
+    Calypso_File_t file;
+    bool ret;
+
+    if (!Calypso_fileOpenWriteOptions(self, &file, path, maxSize,
+                                      ATFILE_OPEN_CREATE | ATFILE_OPEN_OVERWRITE | ATFILE_OPEN_CREATE_FAILSAFE))
+    {
+        return false;
+    }
+    ret = Calypso_fileWrite(&file, data, dataLength);
+    return Calypso_fileClose(&file) && ret;
+}
+
+/**
+ * @brief Write big buffer to a new file, read back to check its CRC
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  data Pointer to data to be written
+ * @param  dataLength Length of data to write
+ * @retval true if successful false in case of failure, also if the file
+ *         already exists
+ */
+bool Calypso_writeBigFile(CALYPSO *self, const char *path, const char *data, uint32_t dataLength)
+{
+    Calypso_File_t file;
+    bool ret;
+
+    DebugLog_printf("Create file %s | %lu\r\n", path, (unsigned long)dataLength);
+
+    /* Without the overwrite option the open fails if the file exists */
+    if (!Calypso_fileOpenWrite(self, &file, path, dataLength, false))
+    {
+        DebugLog_printf("Can't create file %s\r\n", path);
+        return false;
+    }
+    ret = Calypso_fileWrite(&file, data, dataLength);
+    if (!Calypso_fileClose(&file) || !ret)
+    {
+        DebugLog_printf("Error during writing to file: %s\r\n", path);
+        return false;
+    }
+    if (!Calypso_fileVerify(&file, path))
+    {
+        DebugLog_printf("File %s differs from the data written\r\n", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief  Write a part of the inflated data to the open file
+ * @param  context Pointer to the Calypso_File_t
+ * @param  data Inflated data
+ * @param  length Length of the data, at most INFLATE_OUTPUT_CHUNK
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_writeInflated(void *context, const uint8_t *data, uint16_t length)
+{
+    return Calypso_fileWrite((Calypso_File_t *)context, data, length);
+}
+
+/**
+ * @brief  Create or overwrite a file with raw DEFLATE data, inflated while
+ *         it is written in binary format
+ * @param  self Pointer to the calypso object.
+ * @param  path Pointer to the file path including the filename
+ * @param  data Pointer to the compressed data
+ * @param  dataSize Size of the compressed data
+ * @param  fileLength Length of the file once inflated
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_writeCompressedFile(CALYPSO *self, const char *path, const uint8_t *data, uint16_t dataSize,
+                                 uint16_t fileLength)
+{
+    Calypso_File_t file;
+    uint32_t inflated = 0;
+    bool ret;
+
+    DebugLog_printf("Create file %s | %i from %i\r\n", path, fileLength, dataSize);
+    if (!Calypso_fileOpenWrite(self, &file, path, fileLength, true))
+    {
+        DebugLog_printf("Can't create file %s\r\n", path);
+        return false;
+    }
+
+    /* A chunk is inflated while the previous one is transmitted */
+    ret = Inflate_raw(data, dataSize, Calypso_writeInflated, &file, &inflated) && (inflated == fileLength);
+    if (!ret)
+    {
+        DebugLog_printf("Error during writing to file: %s\r\n", path);
+    }
+    if (!Calypso_fileClose(&file))
+    {
+        DebugLog_printf("Can't close file %s\r\n", path);
+        ret = false;
+    }
+    return ret;
+}
+
+/**
+ * @brief  Open a file for a stream of writes with the options of AT+fileOpen
+ * @param  self Pointer to the calypso object.
+ * @param  file File object
+ * @param  path Pointer to the file path including the filename
+ * @param  maxSize Max file size
+ * @param  options ATFILE_OPEN_CREATE and the other create options
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_fileOpenWriteOptions(CALYPSO *self, Calypso_File_t *file, const char *path, uint32_t maxSize,
+                                         uint32_t options)
+{
+    uint32_t sToken;
+
+    memset(file, 0, sizeof(Calypso_File_t));
+    file->calypso = self;
+    file->size = (maxSize < FILE_MIN_SIZE) ? FILE_MIN_SIZE : maxSize;
+    file->crc = CHECKSUM_CRC32_INIT;
+    file->writing = true;
+    if (!ATFile_open(self, path, options, maxSize, &file->fileID, &sToken))
+    {
+        return false;
+    }
+    Calypso_fileCacheSet(path, true);
+    fileBuffered = false;
+    fileBufferLost = false;
+    return true;
+}
+
+/**
+ * @brief  Open a file for a stream of writes, see Calypso_fileWrite
+ * @param  self Pointer to the calypso object.
+ * @param  file File object
+ * @param  path Pointer to the file path including the filename
+ * @param  maxSize Max file size
+ * @param  overwrite true to overwrite an existing file, false to fail
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileOpenWrite(CALYPSO *self, Calypso_File_t *file, const char *path, uint32_t maxSize,
+                           bool overwrite)
+{
+    return Calypso_fileOpenWriteOptions(self, file, path, maxSize,
+                                        ATFILE_OPEN_CREATE | (overwrite ? ATFILE_OPEN_OVERWRITE : 0));
+}
+
+/**
+ * @brief  Open a file for a stream of reads, see Calypso_fileRead
+ * @param  self Pointer to the calypso object.
+ * @param  file File object
+ * @param  path Pointer to the file path including the filename
+ * @retval true if successful false in case of failure
+ */
+bool Calypso_fileOpenRead(CALYPSO *self, Calypso_File_t *file, const char *path)
+{
+    uint32_t sToken;
+
+    memset(file, 0, sizeof(Calypso_File_t));
+    file->calypso = self;
+    file->crc = CHECKSUM_CRC32_INIT;
+    if (!Calypso_getFileSize(self, path, &file->size) ||
+        !ATFile_open(self, path, ATFILE_OPEN_READ, 0, &file->fileID, &sToken))
+    {
+        return false;
+    }
+    fileBuffered = false;
+    fileBufferLost = false;
+    return true;
+}
+
+/**
+ * @brief  Note if the request buffer holds data of the open file
+ * @param  file Open file
+ * @retval None
+ */
+static void Calypso_fileSetBuffered(const Calypso_File_t *file)
+{
+    fileBuffered = file->writing ? (file->length > 0) : (file->position < file->length);
+}
+
+/**
+ * @brief  Fail the open file if a request overwrote its data in the request
+ *         buffer, see Calypso_Sendbytes
+ * @param  file Open file
+ * @retval None
  */
-bool Calypso_fileExists(CALYPSO *self, const char *fileName)
+static void Calypso_fileCheckBuffer(Calypso_File_t *file)
 {
-    return (ATFile_getInfo(self, fileName, 0));
+    if (fileBufferLost)
+    {
+        fileBufferLost = false;
+        file->failed = true;
+        file->length = 0;
+        file->position = 0;
+    }
 }
+
 /**
- * @brief  Delete the file
- * @param  self Pointer to the calypso object.
- * @retval true if successful false in case of failure
+ * @brief  Send the buffered data in one AT+fileWrite in binary format, the
+ *         header is written in front of the data in the request buffer. The
+ *         end of the transmission and the answer are not waited for,
+ *         Calypso_fileWaitChunk reads the answer.
+ * @param  file File open for writing
+ * @retval None
  */
-bool Calypso_deleteFile(CALYPSO *self, const char *fileName)
+static void Calypso_fileSendChunk(Calypso_File_t *file)
 {
-    return (ATFile_del(self, fileName, 0));
+    char header[CALYPSO_FILE_DATA_OFFSET + 1];
+    int headerLength;
+
+    headerLength = sprintf(header, "AT+fileWrite=%lu,%lu,%u,%u,", (unsigned long)file->fileID,
+                           (unsigned long)file->offset, (unsigned int)Calypso_DataFormat_Binary,
+                           (unsigned int)file->length);
+#if SERIAL_DEBUG
+    DebugLog_printf("Sending to Calypso: %s<%u bytes>\r\n", header, (unsigned int)file->length);
+#endif
+    /* The data is binary, the length is sent instead of terminating it */
+    pRequestCommand = &requestBuffer[CALYPSO_FILE_DATA_OFFSET - headerLength];
+    memcpy(pRequestCommand, header, headerLength);
+    memcpy(&fileData[file->length], CRLF, 2);
+    fileRequest = pRequestCommand;
+    fileRequestLength = headerLength + file->length + 2;
+
+    delay(10); /*Guard interval for calypso*/
+    cmdConfirmation = Calypso_CNFStatus_Invalid;
+    Calypso_queueRequest(file->calypso, pRequestCommand, fileRequestLength);
+    file->sent = file->length;
+    file->offset += file->length;
+    file->length = 0;
+    fileInFlight = file;
 }
+
 /**
- * @brief  Open and read data frpm a file
- * @param  self Pointer to the calypso object.
- * @param  path Pointer to the file path including the filename
- * @param  data Pointer to data buffer
- * @param  dataLength Length of data to read
- * @param  outputLength Length of read bytes
- * @retval true if successful false in case of failure
+ * @brief  Read the answer to the chunk in flight. The chunk is sent again if
+ *         there is none or if the module did not write all of it.
+ * @param  file File of the chunk in flight
+ * @param  resend false if the request buffer was reused since the chunk was
+ *         sent, the chunk is not sent again
+ * @retval true if the chunk was written
  */
-bool Calypso_readFile(CALYPSO *self, const char *path, char *data,
-                      uint16_t dataLength, uint16_t *outputLength)
+static bool Calypso_fileWaitChunk(Calypso_File_t *file, bool resend)
 {
-    bool ret = false;
-    uint32_t fileID;
-    uint32_t sToken;
-    uint16_t bytesRead;
-    char out[CALYPSO_LINE_MAX_SIZE];
-    Calypso_DataFormat_t outputFormat;
-    if (ATFile_open(self, path, ATFILE_OPEN_READ, 0, &fileID, &sToken))
+    CALYPSO *self = file->calypso;
+    uint16_t bytesWritten = 0;
+    char *temp;
+    bool ret;
+
+    fileInFlight = NULL;
+    for (uint8_t retries = 1;; retries++)
     {
-        if (ATFile_read(self, fileID, 0, Calypso_DataFormat_Base64, dataLength, &outputFormat, &bytesRead, out))
+        temp = self->bufferCalypso.data;
+        ret = Calypso_finishRequest(self, false) && ATFile_ParseResponseFileWrite(&temp, &bytesWritten) &&
+              (bytesWritten == file->sent);
+        if (ret || !resend || (retries == MAX_RETRIES))
         {
-            uint32_t elen = 0;
-
-            Calypso_decodeBase64((uint8_t *)out, bytesRead, (uint8_t *)data, &elen);
-
-            *outputLength = elen;
-            ret = true;
+            break;
         }
-        ATFile_close(self, fileID, NULL, NULL);
+        delay(10); /*Guard interval for calypso*/
+        cmdConfirmation = Calypso_CNFStatus_Invalid;
+        Calypso_queueRequest(self, fileRequest, fileRequestLength);
     }
+    if (!ret)
+    {
+        DebugLog_printf("Error during writing to file at %lu\r\n", (unsigned long)(file->offset - file->sent));
+        file->failed = true;
+    }
+    file->sent = 0;
     return ret;
 }
 
 /**
- * @brief Create/open and write data to a file
- * @param  self Pointer to the calypso object.
- * @param  path Pointer to the file path including the filename
+ * @brief  Write data of any length to a file opened by Calypso_fileOpenWrite.
+ *         The data is sent in chunks of CALYPSO_FILE_WRITE_CHUNK bytes, the
+ *         rest stays in the buffer for the next write or the close. The
+ *         answer to the last chunk is read before the buffer is filled
+ *         again or at the close.
+ * @param  file File open for writing
  * @param  data Pointer to data to be written
- * @param  dataLength Length of data to write
- * @retval true if successful false in case of failure
+ * @param  length Length of data to write
+ * @retval true if successful false in case of failure, e.g. beyond the max
+ *         file size or a chunk not written
  */
-bool Calypso_writeFile(CALYPSO *self, const char *path, const char *data,
-                       uint16_t dataLength)
+bool Calypso_fileWrite(Calypso_File_t *file, const void *data, uint32_t length)
 {
-    bool ret = false;
-    uint32_t fileID;
-    uint32_t sToken;
-    int bytesRemaining = strlen(data);
-    int startIdx = 0;
-    int writeSize = 0;
-    uint16_t bytesWritten = 0;
-    char dataToWrite[CALYPSO_FILE_WRITE_SIZE_MAX] = {0};
-    ret = ATFile_open(self, path, ATFILE_OPEN_CREATE | ATFILE_OPEN_OVERWRITE,
-                      dataLength, &fileID, &sToken);
-    if (ret)
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t part;
+
+    Calypso_fileCheckBuffer(file);
+    if (!file->writing || file->failed || (length > file->size - file->offset - file->length))
+    {
+        file->failed = true;
+        return false;
+    }
+    while (length > 0)
     {
-        while (bytesRemaining > 0)
+        /* The chunk in flight is in the buffer until it is answered */
+        if (fileInFlight != NULL)
         {
-            if (bytesRemaining > CALYPSO_FILE_WRITE_SIZE_MAX)
-            {
-                writeSize = CALYPSO_FILE_WRITE_SIZE_MAX - 1;
-            }
-            else
-            {
-                writeSize = bytesRemaining;
-            }
-            memcpy(dataToWrite, data + startIdx, writeSize);
-            dataToWrite[writeSize] = '\0';
-            ret =
-                ATFile_write(self, fileID, startIdx, Calypso_DataFormat_Binary,
-                             false, writeSize, dataToWrite, &bytesWritten);
-            if (!ret)
-            {
-                break;
-            }
-            startIdx = startIdx + bytesWritten;
-            bytesRemaining = bytesRemaining - bytesWritten;
+            Calypso_fileWaitChunk(fileInFlight, true);
+        }
+        if (file->failed)
+        {
+            return false;
         }
+        part = CALYPSO_FILE_WRITE_CHUNK - file->length;
+        if (part > length)
+        {
+            part = length;
+        }
+        memcpy(&fileData[file->length], bytes, part);
+        file->crc = Checksum_crc32(file->crc, bytes, part);
+        file->length += part;
+        bytes += part;
+        length -= part;
+        if (file->length < CALYPSO_FILE_WRITE_CHUNK)
+        {
+            break;
+        }
+        Calypso_fileSendChunk(file);
+    }
+    Calypso_fileSetBuffered(file);
+    return true;
+}
+
+/**
+ * @brief  Read the next chunk of a file into its buffer. The data is read in
+ *         base64 format, it may contain line ends.
+ * @param  file File open for reading, its buffer was read
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_fileFill(Calypso_File_t *file)
+{
+    CALYPSO *self = file->calypso;
+    uint32_t count = file->size - file->offset;
+    uint32_t decodedLength = 0;
+    uint16_t encodedLength = 0;
+    uint8_t format = 0;
+    char *temp;
+    bool ret;
+
+    if (count > CALYPSO_FILE_READ_CHUNK)
+    {
+        count = CALYPSO_FILE_READ_CHUNK;
+    }
+    /* The request of the next chunk overwrites the buffer */
+    file->length = 0;
+    file->position = 0;
+    fileBuffered = false;
+    pRequestCommand = &requestBuffer[0];
+    memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
+    strcpy(pRequestCommand, "AT+fileRead=");
+    if (!ATFile_AddArgumentsFileRead(pRequestCommand, file->fileID, file->offset, Calypso_DataFormat_Base64, count) ||
+        !Calypso_SendRequest(self, pRequestCommand))
+    {
+        file->failed = true;
+        return false;
     }
+
+    /* +fileread:format,length,data, decoded in place */
+    temp = self->bufferCalypso.data;
+    ret = (0 == strncmp(temp, "+fileread:", 10));
     if (ret)
     {
-        return (ATFile_close(self, fileID, NULL, NULL));
+        temp += 10;
+        ret = Calypso_getNextArgumentInt(&temp, &format, INTFLAGS_SIZE8, ARGUMENT_DELIM) &&
+              Calypso_getNextArgumentInt(&temp, &encodedLength, INTFLAGS_SIZE16, ARGUMENT_DELIM) &&
+              (format == Calypso_DataFormat_Base64) && (strlen(temp) == encodedLength) &&
+              Calypso_decodeBase64((uint8_t *)temp, encodedLength, fileData, &decodedLength) &&
+              (decodedLength == count);
     }
-    else
+    if (!ret)
     {
-        ret = ATFile_close(self, fileID, NULL, NULL);
+        DebugLog_printf("Error during reading from file at %lu\r\n", (unsigned long)file->offset);
+        file->failed = true;
         return false;
     }
+    file->crc = Checksum_crc32(file->crc, fileData, decodedLength);
+    file->offset += decodedLength;
+    file->length = decodedLength;
+    file->position = 0;
+    return true;
 }
 
 /**
- * @brief Write big buffer to a file
- * @param  self Pointer to the calypso object.
- * @param  path Pointer to the file path including the filename
- * @param  data Pointer to data to be written
- * @param  dataLength Length of data to write
+ * @brief  Read data of any length from a file opened by Calypso_fileOpenRead.
+ *         The file is read in chunks of CALYPSO_FILE_READ_CHUNK bytes.
+ * @param  file File open for reading
+ * @param  data Pointer to data buffer
+ * @param  length Length of data to read
+ * @param  bytesRead Length of read bytes, less than length at the end of
+ *         the file
  * @retval true if successful false in case of failure
  */
-bool Calypso_writeBigFile(CALYPSO *self, const char *path, const char *data, uint16_t dataLength)
+bool Calypso_fileRead(Calypso_File_t *file, void *data, uint32_t length, uint32_t *bytesRead)
 {
-    bool ret = false;
-    uint32_t fileID;
-    uint32_t sToken;
-    uint16_t srcOffset = 0;
-    uint16_t dstOffset = 0;
-    uint16_t bytesRemaining = dataLength;
-    uint16_t chunkSize = 0;
-    char dataToWrite[CALYPSO_FILE_WRITE_SIZE_MAX] = {0};
-
-    SSerial_printf(self->serialDebug, "Create file %s | %i\r\n", path, dataLength);
+    uint8_t *bytes = (uint8_t *)data;
+    uint32_t part;
 
-    if (Calypso_fileExists(self, path))
+    *bytesRead = 0;
+    Calypso_fileCheckBuffer(file);
+    if (file->writing || file->failed)
     {
-        SSerial_printf(self->serialDebug, "Error. File already exist: %s\r\n", path);
         return false;
     }
-
-    ret = ATFile_open(self, path, ATFILE_OPEN_CREATE | ATFILE_OPEN_OVERWRITE, dataLength, &fileID, &sToken);
-    if (ret)
+    while (length > 0)
     {
-        while (bytesRemaining > 0)
+        if (file->position == file->length)
         {
-            // Calculate how many bytes to copy in this iteration (CALYPSO_FILE_WRITE_SIZE_MAX or fewer for the last chunk)
-            chunkSize = (bytesRemaining >= CALYPSO_FILE_WRITE_SIZE_MAX) ? CALYPSO_FILE_WRITE_SIZE_MAX : bytesRemaining;
-
-            memcpy(dataToWrite, data + srcOffset, chunkSize);
-
-            SSerial_printf(self->serialDebug, "Write %i bytes, %i offset to file %s. Remaining: %i\r\n", chunkSize, srcOffset, path, bytesRemaining);
-            ret = ATFile_write(self, fileID, srcOffset, Calypso_DataFormat_Base64, true, chunkSize, dataToWrite, &dstOffset);
-            if (!ret)
+            if (file->offset >= file->size)
             {
-                SSerial_printf(self->serialDebug, "Error during writing to file: %s\r\n", path);
                 break;
             }
-
-            srcOffset += chunkSize;
-            if (bytesRemaining > chunkSize)
-            {
-                bytesRemaining -= chunkSize;
-            }
-            else
+            if (!Calypso_fileFill(file))
             {
-                bytesRemaining = 0;
+                return false;
             }
         }
+        part = file->length - file->position;
+        if (part > length)
+        {
+            part = length;
+        }
+        memcpy(bytes, &fileData[file->position], part);
+        file->position += part;
+        bytes += part;
+        length -= part;
+        *bytesRead += part;
     }
-    else
-    {
-        SSerial_printf(self->serialDebug, "Can't create file %s\r\n", path);
-    }
+    Calypso_fileSetBuffered(file);
+    return true;
+}
 
-    SSerial_printf(self->serialDebug, "Close the file: %s\r\n", path);
-    if (!ATFile_close(self, fileID, NULL, NULL))
+/**
+ * @brief  Close a file opened by Calypso_fileOpenWrite or Calypso_fileOpenRead,
+ *         the data left in the buffer of a write is sent first
+ * @param  file Open file
+ * @retval true if all the data was written and the file closed
+ */
+bool Calypso_fileClose(Calypso_File_t *file)
+{
+    Calypso_fileCheckBuffer(file);
+    if (file->writing)
     {
-        SSerial_printf(self->serialDebug, "Can't close file %s\r\n", path);
-        ret = false;
+        if (fileInFlight != NULL)
+        {
+            Calypso_fileWaitChunk(fileInFlight, true);
+        }
+        if (!file->failed && (file->length > 0))
+        {
+            Calypso_fileSendChunk(file);
+            Calypso_fileWaitChunk(file, true);
+        }
     }
+    file->length = 0;
+    file->position = 0;
+    fileBuffered = false;
+    return ATFile_close(file->calypso, file->fileID, NULL, NULL) && !file->failed;
+}
 
-    Calypso_fileExists(self, path);
+/**
+ * @brief  Read back a file written and closed with this file object, and
+ *         compare its size and CRC with the data written
+ * @param  file File object of the write, reused for the read
+ * @param  path Pointer to the file path including the filename
+ * @retval true if the file holds the data written
+ */
+bool Calypso_fileVerify(Calypso_File_t *file, const char *path)
+{
+    uint32_t length = file->offset;
+    uint32_t crc = file->crc;
+    bool ret;
 
-    return ret;
+    if (!Calypso_fileOpenRead(file->calypso, file, path))
+    {
+        return false;
+    }
+    ret = (file->size == length);
+    while (ret && (file->offset < file->size))
+    {
+        ret = Calypso_fileFill(file);
+    }
+    return Calypso_fileClose(file) && ret && (file->crc == crc);
 }
 
 /**
@@ -987,7 +2021,7 @@ bool Calypso_writeBigFile(CALYPSO *self, const char *path, const char *data, uin
  * @retval true if successful false in case of failure
  */
 bool ATFile_open(CALYPSO *self, const char *fileName, uint32_t options,
-                 uint16_t fileSize, uint32_t *fileID, uint32_t *secureToken)
+                 uint32_t fileSize, uint32_t *fileID, uint32_t *secureToken)
 {
     bool ret = false;
     pRequestCommand = &requestBuffer[0];
@@ -1078,7 +2112,7 @@ bool ATFile_write(CALYPSO *self, uint32_t fileID, uint16_t offset,
  * @param  data Pointer to data to be written
  * @retval true if successful false in case of failure
  */
-bool ATFile_read(CALYPSO *self, uint32_t fileID, uint16_t offset,
+bool ATFile_read(CALYPSO *self, uint32_t fileID, uint32_t offset,
                  Calypso_DataFormat_t format, uint16_t bytesToRead,
                  Calypso_DataFormat_t *pOutFormat, uint16_t *byteRead,
                  char *data)
@@ -1134,11 +2168,19 @@ bool ATFile_getInfo(CALYPSO *self, const char *fileName, uint32_t secureToken)
     memset(pRequestCommand, 0, CALYPSO_LINE_MAX_SIZE);
     strcpy(pRequestCommand, "AT+FileGetInfo=");
     ret = ATFile_AddArgumentsFileDel(pRequestCommand, fileName, secureToken);
-    if (ret)
+    for (int retries = 0; ret && (retries < MAX_RETRIES); retries++)
     {
-        ret = Calypso_SendRequest(self, pRequestCommand);
+        /* An error answer is final, e.g. no such file, only a request left
+         * without any answer is sent again */
+        delay(10); /*Guard interval for calypso*/
+        Calypso_Sendbytes(self, pRequestCommand);
+        if (Calypso_finishRequest(self, true))
+        {
+            return true;
+        }
+        ret = (cmdConfirmation == Calypso_CNFStatus_Invalid);
     }
-    return ret;
+    return false;
 }
 /**
  * @brief  Send a request to calypso and wait for the response
@@ -1154,7 +2196,7 @@ bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd)
     {
         delay(10); /*Guard interval for calypso*/
         Calypso_Sendbytes(self, sendCmd);
-        ret = Calypso_waitForReply(self, Calypso_CNFStatus_Success, true);
+        ret = Calypso_finishRequest(self, true);
         retries++;
         if (retries == MAX_RETRIES)
         {
@@ -1163,6 +2205,30 @@ bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd)
     }
     return ret;
 }
+/**
+ * @brief  Wait for the response to the request sent and count the requests
+ *         left without any
+ * @param  self Pointer to the calypso object.
+ * @param  resetConfirmState false if the confirm state was reset when sending
+ * @retval true if successful false in case of failure
+ */
+static bool Calypso_finishRequest(CALYPSO *self, bool resetConfirmState)
+{
+    bool ret = Calypso_waitForReply(self, Calypso_CNFStatus_Success, resetConfirmState);
+
+    if (cmdConfirmation == Calypso_CNFStatus_Invalid)
+    {
+        if (unansweredRequests < UINT8_MAX)
+        {
+            unansweredRequests++;
+        }
+    }
+    else
+    {
+        unansweredRequests = 0;
+    }
+    return ret;
+}
 /**
  * @brief  Send bytes on to the calypso serial port
  * @param  self Pointer to the calypso object.
@@ -1171,27 +2237,60 @@ bool Calypso_SendRequest(CALYPSO *self, const char *sendCmd)
  */
 void Calypso_Sendbytes(CALYPSO *self, const char *sendCmd)
 {
-    requestPending = true;
-    lengthResponse = 0;
+    if (fileBuffered)
+    {
+        /* The request overwrites the chunk of the open file, which fails
+         * at its next operation */
+        DebugLog_printf("Request while a file is open\r\n");
+        fileBuffered = false;
+        fileBufferLost = true;
+    }
+    if (fileInFlight != NULL)
+    {
+        /* The response to a file write comes first, the request buffer
+         * holds the new command */
+        Calypso_fileWaitChunk(fileInFlight, false);
+    }
 #if SERIAL_DEBUG
-    SSerial_printf(self->serialDebug, "Sending to Calypso: ");
-    SSerial_writeB(self->serialDebug, sendCmd, strlen(sendCmd));
-    SSerial_printf(self->serialDebug, "\r\n");
+    DebugLog_printf("Sending to Calypso: %s\r\n", sendCmd);
 #endif
-    int written = 1;
-    while (written)
-    {
-        while (HSerial_available(self->serialCalypso))
-        {
-            HSerial_read(self->serialCalypso);
-        }
-        if (strlen(sendCmd) <= HSerial_availableForWrite(self->serialCalypso))
+    Calypso_queueRequest(self, sendCmd, strlen(sendCmd));
+    HSerial_flush(self->serialCalypso);
+}
+/**
+ * @brief  Queue a request on the calypso serial port as room frees up in
+ *         its buffer, without waiting for the end of the transmission
+ * @param  self Pointer to the calypso object.
+ * @param  request Pointer to the data to send, binary data allowed
+ * @param  length Length of the data
+ * @retval None
+ */
+static void Calypso_queueRequest(CALYPSO *self, const char *request, size_t length)
+{
+    size_t sent = 0;
+    int room;
+
+    requestCount++;
+    requestPending = true;
+    lengthResponse = 0;
+    while (sent < length)
+    {
+        /* Lines sent before the request, e.g. MQTT messages, are handled as
+         * events instead of being taken for the response */
+        requestPending = false;
+        Calypso_processRx(self);
+        requestPending = true;
+        room = HSerial_availableForWrite(self->serialCalypso);
+        if (room > 0)
         {
-            HSerial_writeB(self->serialCalypso, sendCmd, strlen(sendCmd));
-            written = 0;
+            if ((size_t)room > length - sent)
+            {
+                room = length - sent;
+            }
+            HSerial_writeB(self->serialCalypso, &request[sent], room);
+            sent += room;
         }
     }
-    HSerial_flush(self->serialCalypso);
 }
 /**
  * @brief  Wait for an event from calypso
@@ -1203,19 +2302,42 @@ bool Calypso_waitForEvent(CALYPSO *self)
     unsigned long startTime = micros();
     unsigned long interval = 0;
     eventPending = true;
-    // Reset the RX buffer
-    rxByteCounter = 0;
+    /* A line may be half read by the background RX path, it is kept */
     while (eventPending)
     {
         interval = micros() - startTime;
         Calypso_RxBytes(self);
+        DebugLog_drain(1);
         if ((interval) >= (EVENT_WAIT_TIME * 1000)) /*ms to microseconds*/
         {
+            Calypso_dropStaleLine(self);
             break;
         }
     }
     return (!eventPending);
 }
+/**
+ * @brief  Wait for the module to reach a state, handling its events
+ * @param  self Pointer to the calypso object.
+ * @param  status Expected state
+ * @param  timeoutMs Longest wait in ms
+ * @retval true if the state was reached false otherwise
+ */
+bool Calypso_waitForStatus(CALYPSO *self, Calypso_status_t status, unsigned long timeoutMs)
+{
+    unsigned long startTime = millis();
+
+    while (self->status != status)
+    {
+        if ((millis() - startTime) >= timeoutMs)
+        {
+            return false;
+        }
+        Calypso_processRx(self);
+        DebugLog_drain(1);
+    }
+    return true;
+}
 /**
  * @brief  Wait for calypso response
  * @param  self Pointer to the calypso object.
@@ -1232,12 +2354,12 @@ bool Calypso_waitForReply(CALYPSO *self, Calypso_CNFStatus_t expectedStatus,
     {
         cmdConfirmation = Calypso_CNFStatus_Invalid;
     }
-    // Reset the RX buffer
-    rxByteCounter = 0;
+    /* A line may be half read by the background RX path, it is kept */
     while (requestPending)
     {
         interval = micros() - startTime;
         Calypso_RxBytes(self);
+        DebugLog_drain(1);
         if (Calypso_CNFStatus_Invalid != cmdConfirmation)
         {
             requestPending = false;
@@ -1252,11 +2374,83 @@ bool Calypso_waitForReply(CALYPSO *self, Calypso_CNFStatus_t expectedStatus,
         }
         if ((interval) >= (RESPONSE_WAIT_TIME * 1000)) /*ms to microseconds*/
         {
+            Calypso_dropStaleLine(self);
             break;
         }
     }
     return false;
 }
+/**
+ * @brief  Copy bytes into the MQTT message queue, the space was checked
+ * @param  data Bytes to copy
+ * @param  length Number of bytes
+ * @retval none
+ */
+static void Calypso_queueWrite(const uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        mqttQueue[mqttQueueHead++ & (CALYPSO_MQTT_QUEUE_SIZE - 1)] = data[i];
+    }
+}
+/**
+ * @brief  Copy bytes out of the MQTT message queue
+ * @param  data Destination
+ * @param  length Number of bytes
+ * @retval none
+ */
+static void Calypso_queueRead(uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        data[i] = mqttQueue[mqttQueueTail++ & (CALYPSO_MQTT_QUEUE_SIZE - 1)];
+    }
+}
+/**
+ * @brief  Queue a received MQTT message, dropped if the queue is full. The
+ *         topic and the data are copied from the line, not parsed into a
+ *         buffer.
+ * @param  arguments Arguments of the recv event: topic, QoS, retain,
+ *         duplicate, format, length and data
+ * @retval none
+ */
+static void Calypso_queueMQTTMessage(const char *arguments)
+{
+    const char *topic = arguments;
+    const char *data = strchr(arguments, ARGUMENT_DELIM);
+    uint16_t lengths[2];
+
+    if ((data == NULL) || ((size_t)(data - topic) >= MQTT_MAX_TOPIC_LENGTH))
+    {
+        mqttQueueDropped++;
+        return;
+    }
+    lengths[0] = (uint16_t)(data - topic);
+    /* QoS, retain, duplicate, format and length */
+    for (uint8_t i = 0; (i < 5) && (data != NULL); i++)
+    {
+        data = strchr(data + 1, ARGUMENT_DELIM);
+    }
+    if (data == NULL)
+    {
+        mqttQueueDropped++;
+        return;
+    }
+    data++;
+    lengths[1] = (uint16_t)strlen(data);
+    if ((uint16_t)(MQTT_QUEUE_HEADER_SIZE + lengths[0] + lengths[1]) >
+        CALYPSO_MQTT_QUEUE_SIZE - (uint16_t)(mqttQueueHead - mqttQueueTail))
+    {
+        mqttQueueDropped++;
+#if SERIAL_DEBUG
+        DebugLog_printf("MQTT message dropped, queue full\r\n");
+#endif
+        return;
+    }
+    Calypso_queueWrite((const uint8_t *)lengths, sizeof(lengths));
+    Calypso_queueWrite((const uint8_t *)topic, lengths[0]);
+    Calypso_queueWrite((const uint8_t *)data, lengths[1]);
+}
 /**
  * @brief  Handle events from calypso
  * @param  self Pointer to the calypso object.
@@ -1293,7 +2487,7 @@ void Calypso_HandleEvents(CALYPSO *self)
         eventPending = false;
         // ATEvent_NetappIP4Aquired_t *ip4Acquired =
         // (ATEvent_NetappIP4Aquired_t *)eventArguments;
-        // SSerial_printf(self->serialDebug, "Calypso connected. IP
+        // DebugLog_printf("Calypso connected. IP
         // acquired: %s\r\n", ip4Acquired->address);
         break;
     }
@@ -1303,6 +2497,12 @@ void Calypso_HandleEvents(CALYPSO *self)
         int connackCode;
         ret = Calypso_getNextArgumentString(&pEventBuffer, value,
                                             ARGUMENT_DELIM);
+        if (!ret)
+        {
+            /* Events without arguments, e.g. puback */
+            ret = Calypso_getNextArgumentString(&pEventBuffer, value,
+                                                STRING_TERMINATE);
+        }
         if (ret)
         {
             ret = false;
@@ -1317,68 +2517,58 @@ void Calypso_HandleEvents(CALYPSO *self)
                     {
                     case 0:
 #if SERIAL_DEBUG
-                        SSerial_printf(
-                            self->serialDebug,
-                            "MQTT connection accepted %i\r\n",
+                        DebugLog_printf("MQTT connection accepted %i\r\n",
                             connackCode);
 #endif
                         self->status = calypso_MQTT_connected;
+                        mqttSessionPresent = false;
                         break;
                     case 1:
 #if SERIAL_DEBUG
-                        SSerial_printf(
-                            self->serialDebug,
-                            "MQTT connection refused, Unacceptable "
+                        DebugLog_printf("MQTT connection refused, Unacceptable "
                             "protocol version %i\r\n",
                             connackCode);
 #endif
                         break;
                     case 2:
 #if SERIAL_DEBUG
-                        SSerial_printf(
-                            self->serialDebug,
-                            "MQTT connection refused,Identifier "
+                        DebugLog_printf("MQTT connection refused,Identifier "
                             "rejected %i\r\n",
                             connackCode);
 #endif
                         break;
                     case 3:
 #if SERIAL_DEBUG
-                        SSerial_printf(self->serialDebug,
-                                       "MQTT connection refused, "
+                        DebugLog_printf("MQTT connection refused, "
                                        "Server unavailable %i\r\n",
                                        connackCode);
 #endif
                         break;
                     case 4:
 #if SERIAL_DEBUG
-                        SSerial_printf(self->serialDebug,
-                                       "MQTT connection refused, Bad "
+                        DebugLog_printf("MQTT connection refused, Bad "
                                        "user name or password %i\r\n",
                                        connackCode);
 #endif
                         break;
                     case 5:
 #if SERIAL_DEBUG
-                        SSerial_printf(self->serialDebug,
-                                       "MQTT connection refused, not "
+                        DebugLog_printf("MQTT connection refused, not "
                                        "authorized %i\r\n",
                                        connackCode);
 #endif
                         break;
                     case 256:
 #if SERIAL_DEBUG
-                        SSerial_printf(
-                            self->serialDebug,
-                            "MQTT connection accepted %i\r\n",
+                        DebugLog_printf("MQTT connection accepted %i\r\n",
                             connackCode);
 #endif
                         self->status = calypso_MQTT_connected;
+                        mqttSessionPresent = true;
                         break;
                     default:
 #if SERIAL_DEBUG
-                        SSerial_printf(self->serialDebug,
-                                       "MQTT connection refused %i\r\n",
+                        DebugLog_printf("MQTT connection refused %i\r\n",
                                        connackCode);
 #endif
                         break;
@@ -1387,13 +2577,13 @@ void Calypso_HandleEvents(CALYPSO *self)
             }
             else if (0 == strcasecmp(value, "puback"))
             {
-                // SSerial_printf(self->serialDebug, "MQTT Puback\r\n");
+                Calypso_MQTTonPuback();
             }
             else if (0 == strcasecmp(value, "suback"))
             {
                 char value[64];
                 Calypso_getNextArgumentString(&pEventBuffer, value, STRING_TERMINATE);
-                SSerial_printf(self->serialDebug, "MQTT Suback:%s\r\n", value);
+                DebugLog_printf("MQTT Suback:%s\r\n", value);
             }
         }
         eventPending = false;
@@ -1401,23 +2591,43 @@ void Calypso_HandleEvents(CALYPSO *self)
     }
     case ATEvent_MQTTRecv:
     {
-        SSerial_printf(self->serialDebug, "MQTT recv\r\n");
-        char value[CALYPSO_LINE_MAX_SIZE];
-        Calypso_getNextArgumentString(&pEventBuffer, value, ARGUMENT_DELIM);
-        strcpy(self->topicName.data, value);
-        self->topicName.length = strlen(value);
-        Calypso_getNextArgumentString(&pEventBuffer, value, ARGUMENT_DELIM);
-        Calypso_getNextArgumentString(&pEventBuffer, value, ARGUMENT_DELIM);
-        Calypso_getNextArgumentString(&pEventBuffer, value, ARGUMENT_DELIM);
-        Calypso_getNextArgumentString(&pEventBuffer, value, ARGUMENT_DELIM);
-        ret = Calypso_getNextArgumentInt(
-            &pEventBuffer, &self->bufferCalypso.length, INTFLAGS_SIZE16,
-            ARGUMENT_DELIM);
-        Calypso_getNextArgumentString(&pEventBuffer, value, STRING_TERMINATE);
-        strcpy(self->bufferCalypso.data, value);
+        Calypso_queueMQTTMessage(pEventBuffer);
         eventPending = false;
         break;
     }
+    case ATEvent_MQTTDisconnect:
+    {
+        /* The client is kept, Calypso_MQTTreconnect connects it again */
+        if (self->status == calypso_MQTT_connected)
+        {
+            self->status = calypso_WLAN_connected;
+        }
+        DebugLog_printf("MQTT broker disconnected\r\n");
+        break;
+    }
+    case ATEvent_WlanDisconnect:
+    case ATEvent_NetappIPv4Lost:
+    {
+        if ((self->status == calypso_WLAN_connected) || (self->status == calypso_MQTT_connected) ||
+            (self->status == calypso_MQTT_wrong_root_ca))
+        {
+            self->status = calypso_WLAN_disconnected;
+        }
+        DebugLog_printf("Wi-Fi connection lost\r\n");
+        break;
+    }
+    case ATEvent_GeneralError:
+    case ATEvent_FatalErrorDeviceAbort:
+    case ATEvent_FatalErrorDriverAbort:
+    case ATEvent_FatalErrorSyncLost:
+    case ATEvent_FatalErrorNoCmdAck:
+    case ATEvent_FatalErrorCMDTimeout:
+    {
+        /* Only a reboot brings the module back */
+        self->status = calypso_error;
+        DebugLog_printf("Calypso error event\r\n");
+        break;
+    }
     case ATEvent_WlanProvisioningStatus:
     {
         char value[64];
@@ -1430,7 +2640,7 @@ void Calypso_HandleEvents(CALYPSO *self)
     }
     case ATEvent_WlanProvisioningProfileAdded:
     {
-        SSerial_printf(self->serialDebug, "Wi-Fi Profile added\r\n");
+        DebugLog_printf("Wi-Fi Profile added\r\n");
         break;
     }
     case ATEvent_SocketAsyncEvent:
@@ -1441,7 +2651,7 @@ void Calypso_HandleEvents(CALYPSO *self)
         if (0 == strncmp(value, "wrong_root_ca", 14))
         {
             self->status = calypso_MQTT_wrong_root_ca;
-            SSerial_printf(self->serialDebug, "Wrong root CA\n");
+            DebugLog_printf("Wrong root CA\n");
         }
         break;
     }
@@ -1460,6 +2670,13 @@ void Calypso_HandleEvents(CALYPSO *self)
  */
 void Calypso_HandleRxLine(CALYPSO *self, char *rxPacket, uint16_t rxLength)
 {
+    /* MQTT messages are queued at any time, also while waiting for the
+     * response to a request, without overwriting the response */
+    if (0 == strncasecmp(rxPacket, "+eventmqtt:recv,", 16))
+    {
+        Calypso_queueMQTTMessage(&rxPacket[16]);
+        return;
+    }
     /* AT command was sent to module. Waiting fot response*/
     if (requestPending)
     {
@@ -1511,6 +2728,24 @@ void Calypso_HandleRxLine(CALYPSO *self, char *rxPacket, uint16_t rxLength)
         }
     }
 }
+/**
+ * @brief  Drop a partial line when a wait timed out. The UART was read during
+ *         the whole wait, so a line idle for CALYPSO_RX_LINE_TIMEOUT lost its
+ *         end and would corrupt the next one.
+ * @param  self Pointer to the calypso object.
+ * @retval none
+ */
+static void Calypso_dropStaleLine(CALYPSO *self)
+{
+    if ((rxByteCounter > 0) && (HSerial_available(self->serialCalypso) == 0) &&
+        ((micros() - rxLastByteUs) >= (CALYPSO_RX_LINE_TIMEOUT * 1000)))
+    {
+        rxByteCounter = 0;
+#if SERIAL_DEBUG
+        DebugLog_printf("Calypso RX partial line dropped \r\n");
+#endif
+    }
+}
 /**
  * @brief  Receive bytes on the calypso UART port
  * @param  self Pointer to the calypso object.
@@ -1522,6 +2757,13 @@ void Calypso_RxBytes(CALYPSO *self)
     while (HSerial_available(self->serialCalypso) >= 1)
     {
         readBuffer = HSerial_read(self->serialCalypso);
+        rxLastByteUs = micros();
+        if (rxDiscardLine)
+        {
+            /* Resynchronise on the end of the line that overflowed */
+            rxDiscardLine = (readBuffer != '\n');
+            continue;
+        }
         switch (rxByteCounter)
         {
         case 0:
@@ -1540,9 +2782,11 @@ void Calypso_RxBytes(CALYPSO *self)
             if (rxByteCounter >= CALYPSO_LINE_MAX_SIZE)
             {
                 rxByteCounter = 0;
+                rxDiscardLine = (readBuffer != '\n');
 #if SERIAL_DEBUG
-                SSerial_printf(self->serialDebug, "Calypso RX buffer overflow \r\n");
+                DebugLog_printf("Calypso RX buffer overflow \r\n");
 #endif
+                break;
             }
             if (readBuffer == '\n')
             {
@@ -1551,7 +2795,7 @@ void Calypso_RxBytes(CALYPSO *self)
                     /* Line (without \r\n) ready for interpretation */
                     RxBuffer[rxByteCounter - 1] = (uint8_t)'\0';
 #if SERIAL_DEBUG
-                    SSerial_printf(self->serialDebug, "%s\r\n", RxBuffer);
+                    DebugLog_printf("%s\r\n", RxBuffer);
 #endif
                     Calypso_HandleRxLine(self, RxBuffer, rxByteCounter);
                     // Reset the RX buffer
@@ -40,6 +40,43 @@ extern "C"
 #define EVENT_WAIT_TIME 3000UL
 #define MAX_RETRIES 3
 
+/* Bytes of the queue of received MQTT messages, a power of 2. Each message
+ * takes 4 bytes plus its topic and base64 data: the largest ones, the DPS
+ * registration status and the device twin, take about 740 and 420 bytes. */
+#ifndef CALYPSO_MQTT_QUEUE_SIZE
+#define CALYPSO_MQTT_QUEUE_SIZE 1024
+#endif
+
+/* QoS 1 messages published and waiting for their PUBACK, each keeps its
+ * command: 328 bytes of RAM per message with CALYPSO_MQTT_RETRY_SIZE 320 */
+#ifndef CALYPSO_MQTT_INFLIGHT
+#define CALYPSO_MQTT_INFLIGHT 4
+#endif
+
+/* Longest publish command kept for a retransmission, longer messages are
+ * tracked but not sent again */
+#ifndef CALYPSO_MQTT_RETRY_SIZE
+#define CALYPSO_MQTT_RETRY_SIZE 320
+#endif
+
+/* A partial line with no byte for this long when a wait times out is
+ * dropped, the rest of it was lost */
+#define CALYPSO_RX_LINE_TIMEOUT 100UL
+
+#define CALYPSO_MQTT_ACK_TIMEOUT 5000UL
+#define CALYPSO_MQTT_MAX_RETRANSMITS 2
+
+/* Files whose existence is kept, see Calypso_fileExists, 8 bytes each */
+#ifndef CALYPSO_FILE_CACHE_SIZE
+#define CALYPSO_FILE_CACHE_SIZE 16
+#endif
+
+/* Room of an AT line for a file command and its arguments, the rest holds
+ * the data: binary for AT+fileWrite, base64 for the answer of AT+fileRead */
+#define CALYPSO_FILE_HEADER_MAX 64
+#define CALYPSO_FILE_WRITE_CHUNK (CALYPSO_LINE_MAX_SIZE - CALYPSO_FILE_HEADER_MAX)
+#define CALYPSO_FILE_READ_CHUNK (((CALYPSO_LINE_MAX_SIZE - CALYPSO_FILE_HEADER_MAX) / 4) * 3)
+
     typedef enum
     {
         calypso_unknown,
@@ -53,6 +90,37 @@ extern "C"
         calypso_error
     } Calypso_status_t;
 
+    /* WLAN power management policies of AT+wlanPolicySet=PM */
+    typedef enum
+    {
+        calypso_power_normal,
+        calypso_power_low_latency,
+        calypso_power_low_power,
+        calypso_power_always_on,
+        calypso_power_long_sleep
+    } Calypso_powerPolicy_t;
+
+    typedef struct
+    {
+        uint32_t published[2]; /* Accepted by Calypso, per QoS */
+        uint32_t acked;
+        uint32_t retransmitted;
+        uint32_t unacked;   /* QoS 1 given up after the retransmissions */
+        uint32_t dropped;   /* Not published: not connected, window full or no answer */
+        uint32_t strayAcks; /* PUBACK without a message in flight */
+        uint32_t lateAcks;  /* PUBACK of a retransmission or of a message given up */
+        uint32_t maxAckMs;
+        uint8_t inFlight;
+    } Calypso_MQTTStats_t;
+
+    /**
+     * @brief  Called once for a message of Calypso_MQTTPublishAcked when it
+     *         leaves the in-flight window
+     * @param  context Context given to the publish
+     * @param  acked true on its PUBACK, false if it was given up
+     */
+    typedef void (*Calypso_MQTTAckCallback_t)(void *context, bool acked);
+
     typedef struct
     {
         char timezone[5];
@@ -102,9 +170,30 @@ extern "C"
         char firmwareVersion[20];
         char MAC_ADDR[20];
         char IP_ADDR[20];
-        char udid[36];
+        char udid[37]; /* 36 characters of the UUID and the terminator */
     } CALYPSO;
 
+    /**
+     * @brief File of the Calypso file system opened for a stream of writes
+     * or reads, see Calypso_fileOpenWrite and Calypso_fileOpenRead. One
+     * file is open at a time, its chunk of data is kept in the request
+     * buffer: no other Calypso request may be made until it is closed.
+     *
+     */
+    typedef struct
+    {
+        CALYPSO *calypso;
+        uint32_t fileID;
+        uint32_t size;     /* Maximum size when writing, file size when reading */
+        uint32_t offset;   /* Next file offset to send or to read */
+        uint32_t crc;      /* CRC-32 of the data written or read so far */
+        uint16_t length;   /* Bytes in the buffer */
+        uint16_t position; /* Next byte of the buffer to read */
+        uint16_t sent;     /* Bytes of the chunk waiting for its answer */
+        bool writing;
+        bool failed;
+    } Calypso_File_t;
+
     CALYPSO *Calypso_Create(TypeSerial *serialDebug,
                             TypeHardwareSerial *serialCalypso,
                             CalypsoSettings *settings);
@@ -114,19 +203,33 @@ extern "C"
 
     bool Calypso_reboot(CALYPSO *self);
     bool Calypso_WLANconnect(CALYPSO *self);
+    bool Calypso_WLANstartConnect(CALYPSO *self);
     bool Calypso_WLANDisconnect(CALYPSO *self);
     bool Calypso_WLANSetClientMode(CALYPSO *self);
+    bool Calypso_WLANSetPowerPolicy(CALYPSO *self, Calypso_powerPolicy_t policy, uint16_t maxSleepMs);
 
     bool Calypso_WLANGetProfile(CALYPSO *self, uint8_t profileID);
     bool Calypso_WLANDeleteProfile(CALYPSO *self, uint8_t profileID);
 
     bool Calypso_MQTTconnect(CALYPSO *self);
     bool Calypso_MQTTconnect_AWS(CALYPSO *self);
+    bool Calypso_MQTTreconnect(CALYPSO *self);
+    bool Calypso_MQTTisSessionPresent();
     bool Calypso_MQTTDisconnect(CALYPSO *self);
-    bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, uint8_t retain,
+    bool Calypso_MQTTPublishData(CALYPSO *self, char *topic, ATMQTT_QoS_t qos, uint8_t retain,
                                  char *data, int length, bool encode);
+    bool Calypso_MQTTPublishAcked(CALYPSO *self, char *topic, uint8_t retain, char *data, int length, bool encode,
+                                  Calypso_MQTTAckCallback_t callback, void *context);
+    void Calypso_MQTTpoll(CALYPSO *self);
+    bool Calypso_MQTTflush(CALYPSO *self, unsigned long timeoutMs);
+    void Calypso_MQTTgetStats(Calypso_MQTTStats_t *stats);
+    void Calypso_MQTTresetStats();
+    void Calypso_MQTTprintStats(TypeSerial *serial);
     bool Calypso_subscribe(CALYPSO *self, uint8_t index, uint8_t numOfTopics, ATMQTT_subscribeTopic_t *pTopics);
     bool Calypso_MQTTgetMessage(CALYPSO *self, bool encoded);
+    bool Calypso_MQTTwaitMessage(CALYPSO *self, bool encoded, unsigned long timeoutMs);
+    bool Calypso_isMessagePending(CALYPSO *self);
+    uint32_t Calypso_getDroppedMessages();
 
     bool Calypso_StartProvisioning(CALYPSO *self);
     bool Calypso_StopProvisioning(CALYPSO *self);
@@ -138,12 +241,27 @@ extern "C"
     bool Calypso_fileExists(CALYPSO *self, const char *fileName);
     bool Calypso_writeFile(CALYPSO *self, const char *path, const char *data,
                            uint16_t dataLength);
-    bool Calypso_writeBigFile(CALYPSO *self, const char *path, const char *data, uint16_t dataLength);
+    bool Calypso_writeBigFile(CALYPSO *self, const char *path, const char *data, uint32_t dataLength);
+    bool Calypso_writeFailsafeFile(CALYPSO *self, const char *path, const char *data, uint32_t dataLength);
+    bool Calypso_writeCompressedFile(CALYPSO *self, const char *path, const uint8_t *data, uint16_t dataSize,
+                                     uint16_t fileLength);
     bool Calypso_readFile(CALYPSO *self, const char *path, char *data,
                           uint16_t dataLength, uint16_t *outputLength);
+    bool Calypso_fileOpenWrite(CALYPSO *self, Calypso_File_t *file, const char *path, uint32_t maxSize,
+                               bool overwrite);
+    bool Calypso_fileOpenRead(CALYPSO *self, Calypso_File_t *file, const char *path);
+    bool Calypso_fileWrite(Calypso_File_t *file, const void *data, uint32_t length);
+    bool Calypso_fileRead(Calypso_File_t *file, void *data, uint32_t length, uint32_t *bytesRead);
+    bool Calypso_fileClose(Calypso_File_t *file);
+    bool Calypso_fileVerify(Calypso_File_t *file, const char *path);
+    bool Calypso_getFileSize(CALYPSO *self, const char *path, uint32_t *size);
     bool Calypso_deleteFile(CALYPSO *self, const char *fileName);
     bool Calypso_waitForResponse(CALYPSO *self);
+    bool Calypso_waitForStatus(CALYPSO *self, Calypso_status_t status, unsigned long timeoutMs);
     bool Calypso_isIPConnected(CALYPSO *self);
+    uint8_t Calypso_getUnansweredRequests();
+    uint32_t Calypso_getRequestCount();
+    void Calypso_processRx(CALYPSO *self);
     bool Calypso_ProvisioningDone(CALYPSO *self);
     bool Calypso_getTime(CALYPSO *self);
     bool Calypso_getUDID(CALYPSO *self);
@@ -0,0 +1,497 @@
+/**
+ * \file
+ * \brief Configuration files of the Calypso Wi-Fi module.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "calypsoConfig.h"
+#include "json-builder.h"
+#include "debuglog.h"
+
+/* Files loaded, dropped together by CalypsoConfig_unloadAll */
+static CalypsoConfig_t *loadedConfigs = NULL;
+
+/**
+ * @brief  Find a value of an object
+ * @param  object JSON object, may be NULL
+ * @param  key Name of the value
+ * @retval Entry of the value, NULL if there is none
+ */
+static json_object_entry *CalypsoConfig_find(const json_value *object, const char *key)
+{
+    if ((object == NULL) || (object->type != json_object))
+    {
+        return NULL;
+    }
+    for (unsigned int i = 0; i < object->u.object.length; i++)
+    {
+        if (0 == strcmp(object->u.object.values[i].name, key))
+        {
+            return &object->u.object.values[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Compare two values, the objects by key regardless of the order
+ * @param  a First value
+ * @param  b Second value
+ * @retval true if equal, arrays are never taken for equal
+ */
+static bool CalypsoConfig_isEqual(const json_value *a, const json_value *b)
+{
+    json_object_entry *entry;
+
+    if (a->type != b->type)
+    {
+        return false;
+    }
+    switch (a->type)
+    {
+    case json_string:
+        return (a->u.string.length == b->u.string.length) &&
+               (0 == memcmp(a->u.string.ptr, b->u.string.ptr, a->u.string.length));
+    case json_integer:
+        return a->u.integer == b->u.integer;
+    case json_double:
+        return a->u.dbl == b->u.dbl;
+    case json_boolean:
+        return a->u.boolean == b->u.boolean;
+    case json_null:
+        return true;
+    case json_object:
+        if (a->u.object.length != b->u.object.length)
+        {
+            return false;
+        }
+        for (unsigned int i = 0; i < a->u.object.length; i++)
+        {
+            entry = CalypsoConfig_find(b, a->u.object.values[i].name);
+            if ((entry == NULL) || !CalypsoConfig_isEqual(a->u.object.values[i].value, entry->value))
+            {
+                return false;
+            }
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief  Parse a configuration, the values can be changed with json-builder
+ * @param  text JSON text
+ * @param  length Length of the text
+ * @retval JSON object, NULL if the text is not one
+ */
+static json_value *CalypsoConfig_parse(const char *text, size_t length)
+{
+    json_settings settings;
+    json_value *root;
+
+    memset(&settings, 0, sizeof(settings));
+    settings.value_extra = json_builder_extra;
+    root = json_parse_ex(&settings, text, length, NULL);
+    if ((root != NULL) && (root->type != json_object))
+    {
+        json_builder_free(root);
+        root = NULL;
+    }
+    return root;
+}
+
+/**
+ * @brief  Keep the content of a file in RAM
+ * @param  config Configuration file
+ * @param  root Parsed content, NULL if none
+ * @param  exists true if the file exists
+ * @retval None
+ */
+static void CalypsoConfig_setLoaded(CalypsoConfig_t *config, json_value *root, bool exists)
+{
+    if (!config->loaded)
+    {
+        config->next = loadedConfigs;
+        loadedConfigs = config;
+    }
+    json_builder_free(config->root);
+    config->root = root;
+    config->loaded = true;
+    config->exists = exists;
+}
+
+/**
+ * @brief  Report a change to the listener
+ * @param  config Configuration file
+ * @param  key Value changed, NULL if the whole file
+ * @retval None
+ */
+static void CalypsoConfig_changed(CalypsoConfig_t *config, const char *key)
+{
+    config->dirty = true;
+    if (config->onChange != NULL)
+    {
+        config->onChange(config, key);
+    }
+}
+
+/**
+ * @brief  Read a configuration file once, the next calls use the copy in
+ *         RAM until the file is unloaded
+ * @param  config Configuration file
+ * @param  calypso Pointer to the calypso object
+ * @retval true if the file exists and holds a JSON object
+ */
+bool CalypsoConfig_load(CalypsoConfig_t *config, CALYPSO *calypso)
+{
+    char text[CALYPSO_CONFIG_MAX_SIZE];
+    uint16_t length = 0;
+
+    if (config->loaded)
+    {
+        return config->root != NULL;
+    }
+    if (Calypso_readFile(calypso, config->path, text, sizeof(text), &length))
+    {
+        CalypsoConfig_setLoaded(config, CalypsoConfig_parse(text, length), true);
+        if (config->root == NULL)
+        {
+            DebugLog_printf("Unable to parse %s\r\n", config->path);
+        }
+    }
+    else
+    {
+        /* Missing if the read found it missing, without another command */
+        CalypsoConfig_setLoaded(config, NULL, Calypso_fileExists(calypso, config->path));
+        if (config->exists)
+        {
+            DebugLog_printf("Unable to read %s\r\n", config->path);
+        }
+    }
+    config->dirty = false;
+    return config->root != NULL;
+}
+
+/**
+ * @brief  Check if the file was found by CalypsoConfig_load, or written
+ * @param  config Configuration file
+ * @retval true if the file exists, valid or not
+ */
+bool CalypsoConfig_exists(const CalypsoConfig_t *config)
+{
+    return config->loaded && config->exists;
+}
+
+/**
+ * @brief  Drop the copy in RAM, the next CalypsoConfig_load reads the file,
+ *         e.g. after the web server wrote it. Changes not committed are lost.
+ * @param  config Configuration file
+ * @retval None
+ */
+void CalypsoConfig_unload(CalypsoConfig_t *config)
+{
+    CalypsoConfig_t **link = &loadedConfigs;
+
+    if (!config->loaded)
+    {
+        return;
+    }
+    while ((*link != NULL) && (*link != config))
+    {
+        link = &(*link)->next;
+    }
+    if (*link != NULL)
+    {
+        *link = config->next;
+    }
+    json_builder_free(config->root);
+    config->root = NULL;
+    config->next = NULL;
+    config->loaded = false;
+    config->dirty = false;
+}
+
+/**
+ * @brief  Drop the copies in RAM of all the files
+ * @retval None
+ */
+void CalypsoConfig_unloadAll()
+{
+    while (loadedConfigs != NULL)
+    {
+        CalypsoConfig_unload(loadedConfigs);
+    }
+}
+
+/**
+ * @brief  Get the whole configuration, e.g. to look for optional values
+ * @param  config Configuration file
+ * @retval JSON object, NULL if not loaded or not valid
+ */
+json_value *CalypsoConfig_getRoot(const CalypsoConfig_t *config)
+{
+    return config->root;
+}
+
+/**
+ * @brief  Get a string value
+ * @param  config Configuration file
+ * @param  key Name of the value
+ * @param  fallback Returned if there is no such string
+ * @retval Value, valid until the configuration changes
+ */
+const char *CalypsoConfig_getString(const CalypsoConfig_t *config, const char *key, const char *fallback)
+{
+    json_object_entry *entry = CalypsoConfig_find(config->root, key);
+
+    if ((entry == NULL) || (entry->value->type != json_string))
+    {
+        return fallback;
+    }
+    return entry->value->u.string.ptr;
+}
+
+/**
+ * @brief  Get an integer value, also written as a string of digits as the
+ *         web forms do
+ * @param  config Configuration file
+ * @param  key Name of the value
+ * @param  fallback Returned if there is no such integer
+ * @retval Value
+ */
+long CalypsoConfig_getInt(const CalypsoConfig_t *config, const char *key, long fallback)
+{
+    json_object_entry *entry = CalypsoConfig_find(config->root, key);
+    char *end;
+    long value;
+
+    if (entry == NULL)
+    {
+        return fallback;
+    }
+    switch (entry->value->type)
+    {
+    case json_integer:
+        return (long)entry->value->u.integer;
+    case json_string:
+        value = strtol(entry->value->u.string.ptr, &end, 10);
+        return ((end != entry->value->u.string.ptr) && (*end == '\0')) ? value : fallback;
+    default:
+        return fallback;
+    }
+}
+
+/**
+ * @brief  Get a boolean value
+ * @param  config Configuration file
+ * @param  key Name of the value
+ * @param  fallback Returned if there is no such boolean
+ * @retval Value
+ */
+bool CalypsoConfig_getBool(const CalypsoConfig_t *config, const char *key, bool fallback)
+{
+    json_object_entry *entry = CalypsoConfig_find(config->root, key);
+
+    if ((entry == NULL) || (entry->value->type != json_boolean))
+    {
+        return fallback;
+    }
+    return entry->value->u.boolean != 0;
+}
+
+/**
+ * @brief  Set a value in RAM, the listener is called if it changed
+ * @param  config Configuration file
+ * @param  key Name of the value
+ * @param  value New value, freed if not used
+ * @retval true if successful false if out of memory
+ */
+static bool CalypsoConfig_set(CalypsoConfig_t *config, const char *key, json_value *value)
+{
+    json_object_entry *entry;
+
+    if (value == NULL)
+    {
+        return false;
+    }
+    if (config->root == NULL)
+    {
+        json_value *root = json_object_new(1);
+
+        if (root == NULL)
+        {
+            json_builder_free(value);
+            return false;
+        }
+        CalypsoConfig_setLoaded(config, root, !config->loaded || config->exists);
+    }
+
+    entry = CalypsoConfig_find(config->root, key);
+    if (entry == NULL)
+    {
+        if (json_object_push(config->root, key, value) == NULL)
+        {
+            json_builder_free(value);
+            return false;
+        }
+    }
+    else if (CalypsoConfig_isEqual(entry->value, value))
+    {
+        json_builder_free(value);
+        return true;
+    }
+    else
+    {
+        json_builder_free(entry->value);
+        entry->value = value;
+        value->parent = config->root;
+    }
+    CalypsoConfig_changed(config, key);
+    return true;
+}
+
+/**
+ * @brief  Set a string value in RAM, see CalypsoConfig_commit
+ * @param  config Configuration file, loaded or not
+ * @param  key Name of the value
+ * @param  value New value
+ * @retval true if successful false if out of memory
+ */
+bool CalypsoConfig_setString(CalypsoConfig_t *config, const char *key, const char *value)
+{
+    return CalypsoConfig_set(config, key, json_string_new(value));
+}
+
+/**
+ * @brief  Set an integer value in RAM, see CalypsoConfig_commit
+ * @param  config Configuration file, loaded or not
+ * @param  key Name of the value
+ * @param  value New value
+ * @retval true if successful false if out of memory
+ */
+bool CalypsoConfig_setInt(CalypsoConfig_t *config, const char *key, long value)
+{
+    return CalypsoConfig_set(config, key, json_integer_new(value));
+}
+
+/**
+ * @brief  Set a boolean value in RAM, see CalypsoConfig_commit
+ * @param  config Configuration file, loaded or not
+ * @param  key Name of the value
+ * @param  value New value
+ * @retval true if successful false if out of memory
+ */
+bool CalypsoConfig_setBool(CalypsoConfig_t *config, const char *key, bool value)
+{
+    return CalypsoConfig_set(config, key, json_boolean_new(value));
+}
+
+/**
+ * @brief  Replace the whole configuration in RAM, e.g. with a default one.
+ *         The file is not read: if it is not loaded the content is taken
+ *         for changed and written by the next commit.
+ * @param  config Configuration file
+ * @param  text JSON object
+ * @retval true if successful false if the text is not a JSON object
+ */
+bool CalypsoConfig_replace(CalypsoConfig_t *config, const char *text)
+{
+    json_value *root = CalypsoConfig_parse(text, strlen(text));
+
+    if (root == NULL)
+    {
+        return false;
+    }
+    if (config->loaded && (config->root != NULL) && CalypsoConfig_isEqual(config->root, root))
+    {
+        json_builder_free(root);
+        return true;
+    }
+    CalypsoConfig_setLoaded(config, root, !config->loaded || config->exists);
+    CalypsoConfig_changed(config, NULL);
+    return true;
+}
+
+/**
+ * @brief  Write the configuration back if it changed in RAM. The file is
+ *         failsafe, a reset while writing leaves the previous one.
+ * @param  config Configuration file
+ * @param  calypso Pointer to the calypso object
+ * @retval true if the file holds the configuration
+ */
+bool CalypsoConfig_commit(CalypsoConfig_t *config, CALYPSO *calypso)
+{
+    json_serialize_opts opts = {json_serialize_mode_packed, 0, 0};
+    char *text;
+    bool ret;
+
+    if (!config->dirty)
+    {
+        return true;
+    }
+    if (config->root == NULL)
+    {
+        return false;
+    }
+    text = (char *)malloc(json_measure_ex(config->root, opts));
+    if (text == NULL)
+    {
+        return false;
+    }
+    json_serialize_ex(text, config->root, opts);
+    ret = Calypso_writeFailsafeFile(calypso, config->path, text, strlen(text));
+    free(text);
+    if (ret)
+    {
+        config->exists = true;
+        config->dirty = false;
+    }
+    else
+    {
+        DebugLog_printf("Unable to write %s\r\n", config->path);
+    }
+    return ret;
+}
+
+/**
+ * @brief  Delete the file and its copy in RAM
+ * @param  config Configuration file
+ * @param  calypso Pointer to the calypso object
+ * @retval true if the file does not exist any more
+ */
+bool CalypsoConfig_remove(CalypsoConfig_t *config, CALYPSO *calypso)
+{
+    bool existed = !config->loaded || config->exists;
+
+    if (existed && Calypso_fileExists(calypso, config->path) && !Calypso_deleteFile(calypso, config->path))
+    {
+        return false;
+    }
+    CalypsoConfig_setLoaded(config, NULL, false);
+    config->dirty = false;
+    if (existed && (config->onChange != NULL))
+    {
+        config->onChange(config, NULL);
+    }
+    return true;
+}
+/**         EOF         */
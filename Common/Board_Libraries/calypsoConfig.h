@@ -0,0 +1,89 @@
+/**
+ * \file
+ * \brief Configuration files of the Calypso Wi-Fi module.
+ *
+ * Keeps a JSON configuration file of the module in RAM once it was read,
+ * with typed access to its values by key. Changes are made in RAM and
+ * reported to a listener, and written back to a failsafe file on commit.
+ * The parsed file stays on the heap, about three times its size on the M0:
+ * some 950 bytes for an Azure configuration of 316 bytes.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef CALYPSOCONFIG_H
+#define CALYPSOCONFIG_H
+
+/**         Includes         */
+
+#include "calypsoBoard.h"
+#include "json.h"
+
+/* Largest configuration file read, on the stack while it is parsed */
+#ifndef CALYPSO_CONFIG_MAX_SIZE
+#define CALYPSO_CONFIG_MAX_SIZE 512
+#endif
+
+/* Configuration of a file, not read until CalypsoConfig_load */
+#define CALYPSO_CONFIG_INIT(filePath, onChange) {(filePath), (onChange), NULL, NULL, false, false, false}
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct CalypsoConfig CalypsoConfig_t;
+
+    /* Called after a value changed in RAM, key NULL if the whole file did */
+    typedef void (*CalypsoConfig_listener_t)(CalypsoConfig_t *config, const char *key);
+
+    struct CalypsoConfig
+    {
+        const char *path;
+        CalypsoConfig_listener_t onChange; /* NULL if there is none */
+        json_value *root;                  /* Object, NULL if there is no valid file */
+        CalypsoConfig_t *next;             /* In the list of the loaded files */
+        bool loaded;                       /* The content is known, in root or missing */
+        bool exists;                       /* The file may exist, root NULL if it is not valid */
+        bool dirty;                        /* Changed in RAM since the last write */
+    };
+
+    bool CalypsoConfig_load(CalypsoConfig_t *config, CALYPSO *calypso);
+    bool CalypsoConfig_exists(const CalypsoConfig_t *config);
+    void CalypsoConfig_unload(CalypsoConfig_t *config);
+    void CalypsoConfig_unloadAll();
+    json_value *CalypsoConfig_getRoot(const CalypsoConfig_t *config);
+    const char *CalypsoConfig_getString(const CalypsoConfig_t *config, const char *key, const char *fallback);
+    long CalypsoConfig_getInt(const CalypsoConfig_t *config, const char *key, long fallback);
+    bool CalypsoConfig_getBool(const CalypsoConfig_t *config, const char *key, bool fallback);
+    bool CalypsoConfig_setString(CalypsoConfig_t *config, const char *key, const char *value);
+    bool CalypsoConfig_setInt(CalypsoConfig_t *config, const char *key, long value);
+    bool CalypsoConfig_setBool(CalypsoConfig_t *config, const char *key, bool value);
+    bool CalypsoConfig_replace(CalypsoConfig_t *config, const char *text);
+    bool CalypsoConfig_commit(CalypsoConfig_t *config, CALYPSO *calypso);
+    bool CalypsoConfig_remove(CalypsoConfig_t *config, CALYPSO *calypso);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CALYPSOCONFIG_H */
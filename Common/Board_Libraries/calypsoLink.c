@@ -0,0 +1,326 @@
+/**
+ * \file
+ * \brief Connection manager of the Calypso Wi-Fi module.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "calypsoLink.h"
+#include "debuglog.h"
+
+static const char *faultNames[calypso_link_faults] = {"ok", "broker", "wifi", "module"};
+
+/**
+ * @brief  Start monitoring the connection of a module
+ * @param  link Connection manager
+ * @param  calypso Module, its settings are reused for the reconnects
+ * @param  openSession Full MQTT session setup, e.g. the platform connect
+ * @param  subscribe Subscriptions, NULL if there are none
+ * @retval None
+ */
+void CalypsoLink_init(CalypsoLink_t *link, CALYPSO *calypso, CalypsoLink_session_t openSession,
+                      CalypsoLink_session_t subscribe)
+{
+    memset(link, 0, sizeof(CalypsoLink_t));
+    link->calypso = calypso;
+    link->openSession = openSession;
+    link->subscribe = subscribe;
+    link->random = (uint32_t)micros() | 1;
+}
+
+/**
+ * @brief  Start the first connect to the broker. CalypsoLink_recover makes
+ *         the attempts with the backoff of a lost broker, the Wi-Fi must be
+ *         connected.
+ * @param  link Connection manager
+ * @retval None
+ */
+void CalypsoLink_open(CalypsoLink_t *link)
+{
+    link->fault = calypso_link_broker_lost;
+    link->layer = calypso_link_broker_lost;
+    link->layerAttempts = 0;
+    link->failures = 0;
+    link->reboots = 0;
+    link->newClient = true;
+    link->opening = true;
+    link->faultMs = millis();
+}
+
+/**
+ * @brief  Classify the state of the module, without AT commands
+ * @param  link Connection manager
+ * @retval Lowest failed layer
+ */
+static CalypsoLink_fault_t CalypsoLink_classify(const CalypsoLink_t *link)
+{
+    if ((link->calypso->status == calypso_error) ||
+        (Calypso_getUnansweredRequests() >= CALYPSO_LINK_WEDGE_REQUESTS))
+    {
+        return calypso_link_module_wedged;
+    }
+    switch (link->calypso->status)
+    {
+    case calypso_MQTT_connected:
+        return calypso_link_ok;
+    case calypso_WLAN_connected:
+    case calypso_MQTT_wrong_root_ca:
+        return calypso_link_broker_lost;
+    case calypso_unknown:
+    case calypso_started:
+    case calypso_WLAN_disconnected:
+        /* Also after a reboot of the module on its own */
+        return calypso_link_wifi_lost;
+    default:
+        /* Provisioning */
+        return calypso_link_ok;
+    }
+}
+
+/**
+ * @brief  Check the connection, a new fault starts its recovery
+ * @param  link Connection manager
+ * @retval Fault being recovered, calypso_link_ok if connected
+ */
+CalypsoLink_fault_t CalypsoLink_check(CalypsoLink_t *link)
+{
+    CalypsoLink_fault_t fault = CalypsoLink_classify(link);
+
+    if (link->fault == calypso_link_ok)
+    {
+        if (fault != calypso_link_ok)
+        {
+            link->fault = fault;
+            link->layer = fault;
+            link->layerAttempts = 0;
+            link->failures = 0;
+            link->reboots = 0;
+            link->newClient = (fault != calypso_link_broker_lost);
+            link->faultMs = millis();
+            link->stats[fault].faults++;
+            DebugLog_printf("Connection lost: %s\r\n", faultNames[fault]);
+        }
+    }
+    else if (fault > link->layer)
+    {
+        /* A lower layer failed meanwhile */
+        link->layer = fault;
+        link->layerAttempts = 0;
+        link->newClient = true;
+    }
+    return link->fault;
+}
+
+/**
+ * @brief  Reconnect a layer and the layers above it
+ * @param  link Connection manager
+ * @retval true if the MQTT client is connected
+ */
+static bool CalypsoLink_reconnect(CalypsoLink_t *link)
+{
+    CALYPSO *calypso = link->calypso;
+
+    switch (link->layer)
+    {
+    case calypso_link_module_wedged:
+        link->reboots++;
+        if (!Calypso_reboot(calypso))
+        {
+            return false;
+        }
+        /* The module answers again, an access point or broker still down
+         * is retried without further reboots */
+        link->layer = calypso_link_wifi_lost;
+        link->layerAttempts = 0;
+        link->newClient = true;
+        /* fall through */
+    case calypso_link_wifi_lost:
+        if (calypso->status == calypso_WLAN_connected)
+        {
+            /* Escalated from the broker, start the association again */
+            Calypso_WLANDisconnect(calypso);
+            calypso->status = calypso_WLAN_disconnected;
+        }
+        if (!Calypso_WLANconnect(calypso) ||
+            !Calypso_waitForStatus(calypso, calypso_WLAN_connected, EVENT_WAIT_TIME))
+        {
+            return false;
+        }
+        /* fall through */
+    case calypso_link_broker_lost:
+    default:
+        break;
+    }
+
+    if (!link->newClient)
+    {
+        if (Calypso_MQTTreconnect(calypso))
+        {
+            return Calypso_MQTTisSessionPresent() || (link->subscribe == NULL) || link->subscribe(calypso);
+        }
+        /* The client may be gone, create it at the next attempt */
+        link->newClient = true;
+        return false;
+    }
+
+    /* Delete the old client if there is one, the settings are kept. There
+     * is none before the first attempt of CalypsoLink_open. */
+    if (!link->opening || (link->failures > 0))
+    {
+        Calypso_MQTTDisconnect(calypso);
+        calypso->status = calypso_WLAN_connected;
+    }
+    if ((link->openSession == NULL) || !link->openSession(calypso))
+    {
+        return false;
+    }
+    link->newClient = false;
+    return (link->subscribe == NULL) || link->subscribe(calypso);
+}
+
+/**
+ * @brief  Delay before the next attempt, equal jitter: half of the
+ *         exponential delay plus a random part of the other half
+ * @param  link Connection manager
+ * @retval Delay in ms
+ */
+static unsigned long CalypsoLink_backoff(CalypsoLink_t *link)
+{
+    unsigned long delayMs = CALYPSO_LINK_BACKOFF_MIN;
+
+    for (uint8_t i = 1; (i < link->failures) && (delayMs < CALYPSO_LINK_BACKOFF_MAX); i++)
+    {
+        delayMs *= 2;
+    }
+    if (delayMs > CALYPSO_LINK_BACKOFF_MAX)
+    {
+        delayMs = CALYPSO_LINK_BACKOFF_MAX;
+    }
+
+    /* xorshift32 */
+    link->random ^= link->random << 13;
+    link->random ^= link->random >> 17;
+    link->random ^= link->random << 5;
+    return delayMs / 2 + link->random % (delayMs / 2 + 1);
+}
+
+/**
+ * @brief  Make one reconnect attempt for the fault found by CalypsoLink_check
+ * @param  link Connection manager
+ * @param  retryMs Delay before the next attempt if this one failed
+ * @retval true if connected to the broker again
+ */
+bool CalypsoLink_recover(CalypsoLink_t *link, unsigned long *retryMs)
+{
+    CalypsoLink_Stats_t *stats;
+    unsigned long elapsedMs;
+
+    *retryMs = 0;
+    if (CalypsoLink_check(link) == calypso_link_ok)
+    {
+        return true;
+    }
+    stats = &link->stats[link->fault];
+    if (!link->opening)
+    {
+        stats->attempts++;
+    }
+
+    if (CalypsoLink_reconnect(link) && (link->calypso->status == calypso_MQTT_connected))
+    {
+        elapsedMs = millis() - link->faultMs;
+        if (link->opening)
+        {
+            DebugLog_printf("Connected in %lu ms\r\n", elapsedMs);
+        }
+        else
+        {
+            stats->recovered++;
+            stats->totalMs += elapsedMs;
+            if (elapsedMs > stats->maxMs)
+            {
+                stats->maxMs = elapsedMs;
+            }
+            DebugLog_printf("Connection recovered: %s in %lu ms\r\n", faultNames[link->fault], elapsedMs);
+        }
+        link->fault = calypso_link_ok;
+        link->layer = calypso_link_ok;
+        link->opening = false;
+        return true;
+    }
+
+    if (link->failures < UINT8_MAX)
+    {
+        link->failures++;
+    }
+    /* A broker that stays down is retried with a new association. The
+     * module is only rebooted when CalypsoLink_check finds it wedged, not
+     * for an access point or broker outage. */
+    if ((++link->layerAttempts >= CALYPSO_LINK_ESCALATE_ATTEMPTS) && (link->layer < calypso_link_wifi_lost))
+    {
+        link->layer = (CalypsoLink_fault_t)(link->layer + 1);
+        link->layerAttempts = 0;
+        link->newClient = true;
+    }
+    *retryMs = CalypsoLink_backoff(link);
+    return false;
+}
+
+/**
+ * @brief  Check if the module failed to come back after several reboots,
+ *         only a reset of the MCU is left
+ * @param  link Connection manager
+ * @retval true if the recovery gave up
+ */
+bool CalypsoLink_isExhausted(const CalypsoLink_t *link)
+{
+    return (link->fault != calypso_link_ok) && (link->reboots >= CALYPSO_LINK_MAX_REBOOTS);
+}
+
+/**
+ * @brief  Print the faults and the time to recover of each layer
+ * @param  link Connection manager
+ * @param  serial Output serial port
+ * @retval None
+ */
+void CalypsoLink_printStats(const CalypsoLink_t *link, TypeSerial *serial)
+{
+    for (uint8_t i = calypso_link_broker_lost; i < calypso_link_faults; i++)
+    {
+        const CalypsoLink_Stats_t *stats = &link->stats[i];
+
+        SSerial_printf(serial, "link %s: %lu lost, %lu recovered in %lu attempts, mean %lu ms, max %lu ms\r\n",
+                       faultNames[i], (unsigned long)stats->faults, (unsigned long)stats->recovered,
+                       (unsigned long)stats->attempts,
+                       (unsigned long)((stats->recovered > 0) ? stats->totalMs / stats->recovered : 0),
+                       (unsigned long)stats->maxMs);
+    }
+}
+
+/**
+ * @brief  Reset the counters, a recovery in progress goes on
+ * @param  link Connection manager
+ * @retval None
+ */
+void CalypsoLink_resetStats(CalypsoLink_t *link)
+{
+    memset(link->stats, 0, sizeof(link->stats));
+}
+/**         EOF         */
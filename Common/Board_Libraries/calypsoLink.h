@@ -0,0 +1,119 @@
+/**
+ * \file
+ * \brief Connection manager of the Calypso Wi-Fi module.
+ *
+ * Tells a lost broker connection, a lost Wi-Fi connection and a wedged
+ * module apart from the Calypso events and the unanswered commands, and
+ * reconnects only the failed layer: the MQTT client alone after a broker
+ * loss, the Wi-Fi and then the MQTT client after a Wi-Fi loss, and all of
+ * them after a module reboot. The Wi-Fi and MQTT settings kept in the
+ * calypso object are reused, so a broker reconnect is one mqttConnect
+ * round trip. Failed attempts are retried after a jittered exponential
+ * backoff and escalated to the layer below.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef CALYPSOLINK_H
+#define CALYPSOLINK_H
+
+/**         Includes         */
+
+#include "calypsoBoard.h"
+
+/* Commands in a row without any answer taken for a wedged module, each
+ * retry of Calypso_SendRequest counted */
+#ifndef CALYPSO_LINK_WEDGE_REQUESTS
+#define CALYPSO_LINK_WEDGE_REQUESTS MAX_RETRIES
+#endif
+
+/* Delay before the second attempt, doubled up to the maximum after each
+ * failed attempt. The first attempt is immediate. */
+#define CALYPSO_LINK_BACKOFF_MIN 500UL
+#define CALYPSO_LINK_BACKOFF_MAX 60000UL
+
+/* Failed attempts on the broker before the Wi-Fi is reconnected too. The
+ * Wi-Fi is retried with the backoff, the module is only rebooted when it
+ * stops answering. */
+#define CALYPSO_LINK_ESCALATE_ATTEMPTS 3
+
+/* Failed module reboots before CalypsoLink_isExhausted */
+#define CALYPSO_LINK_MAX_REBOOTS 3
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* From the top layer to the module */
+    typedef enum
+    {
+        calypso_link_ok,
+        calypso_link_broker_lost,
+        calypso_link_wifi_lost,
+        calypso_link_module_wedged,
+        calypso_link_faults
+    } CalypsoLink_fault_t;
+
+    /* Sets up the MQTT session, returns true if connected */
+    typedef bool (*CalypsoLink_session_t)(CALYPSO *self);
+
+    typedef struct
+    {
+        uint32_t faults;
+        uint32_t recovered;
+        uint32_t attempts;
+        uint32_t totalMs; /* From the detection to the recovery */
+        uint32_t maxMs;
+    } CalypsoLink_Stats_t;
+
+    typedef struct
+    {
+        CALYPSO *calypso;
+        CalypsoLink_session_t openSession; /* Create, set and connect the MQTT client */
+        CalypsoLink_session_t subscribe;   /* After a connect without the stored session */
+        CalypsoLink_fault_t fault;         /* Fault being recovered */
+        CalypsoLink_fault_t layer;         /* Layer reconnected by the next attempt */
+        uint8_t layerAttempts;
+        uint8_t failures; /* Failed attempts since the fault, for the backoff */
+        uint8_t reboots;
+        bool newClient; /* The MQTT client must be created again */
+        bool opening;   /* First connect, not counted as a fault */
+        unsigned long faultMs;
+        uint32_t random;
+        CalypsoLink_Stats_t stats[calypso_link_faults];
+    } CalypsoLink_t;
+
+    void CalypsoLink_init(CalypsoLink_t *link, CALYPSO *calypso, CalypsoLink_session_t openSession,
+                          CalypsoLink_session_t subscribe);
+    void CalypsoLink_open(CalypsoLink_t *link);
+    CalypsoLink_fault_t CalypsoLink_check(CalypsoLink_t *link);
+    bool CalypsoLink_recover(CalypsoLink_t *link, unsigned long *retryMs);
+    bool CalypsoLink_isExhausted(const CalypsoLink_t *link);
+    void CalypsoLink_printStats(const CalypsoLink_t *link, TypeSerial *serial);
+    void CalypsoLink_resetStats(CalypsoLink_t *link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CALYPSOLINK_H */
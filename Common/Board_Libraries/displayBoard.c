@@ -0,0 +1,474 @@
+/**
+ * \file
+ * \brief File for the OLED display featherWing of the WE IoT design kit.
+ *
+ * The text is laid out on a grid of character cells. Only the cells whose
+ * character changed are rendered into the framebuffer, and only the changed
+ * columns of each page are sent to the SH1107 over the I2C queue, so the
+ * sensors sharing the bus are not held off by full screen redraws.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "displayBoard.h"
+
+#define SH1107_SET_PAGE 0xB0
+#define SH1107_SET_COLUMN_HIGH 0x10
+#define SH1107_SET_COLUMN_LOW 0x00
+
+/* First and last character of the font */
+#define SH1107_FONT_FIRST 0x20
+#define SH1107_FONT_LAST 0x7E
+
+typedef struct
+{
+    I2CTransfer_t command;
+    I2CTransfer_t data;
+    uint8_t commandBytes[3];
+    uint8_t page;
+    bool busy;
+} SH1107_segment_t;
+
+/* Classic 5x7 font, one byte per column with the top row in the LSB */
+static const uint8_t SH1107_font[SH1107_FONT_LAST - SH1107_FONT_FIRST + 1][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, /*   */
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, /* ! */
+    {0x00, 0x07, 0x00, 0x07, 0x00}, /* " */
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, /* # */
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, /* $ */
+    {0x23, 0x13, 0x08, 0x64, 0x62}, /* % */
+    {0x36, 0x49, 0x55, 0x22, 0x50}, /* & */
+    {0x00, 0x05, 0x03, 0x00, 0x00}, /* ' */
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, /* ( */
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, /* ) */
+    {0x14, 0x08, 0x3E, 0x08, 0x14}, /* * */
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, /* + */
+    {0x00, 0x50, 0x30, 0x00, 0x00}, /* , */
+    {0x08, 0x08, 0x08, 0x08, 0x08}, /* - */
+    {0x00, 0x60, 0x60, 0x00, 0x00}, /* . */
+    {0x20, 0x10, 0x08, 0x04, 0x02}, /* / */
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, /* 0 */
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, /* 1 */
+    {0x42, 0x61, 0x51, 0x49, 0x46}, /* 2 */
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, /* 3 */
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, /* 4 */
+    {0x27, 0x45, 0x45, 0x45, 0x39}, /* 5 */
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, /* 6 */
+    {0x01, 0x71, 0x09, 0x05, 0x03}, /* 7 */
+    {0x36, 0x49, 0x49, 0x49, 0x36}, /* 8 */
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, /* 9 */
+    {0x00, 0x36, 0x36, 0x00, 0x00}, /* : */
+    {0x00, 0x56, 0x36, 0x00, 0x00}, /* ; */
+    {0x08, 0x14, 0x22, 0x41, 0x00}, /* < */
+    {0x14, 0x14, 0x14, 0x14, 0x14}, /* = */
+    {0x00, 0x41, 0x22, 0x14, 0x08}, /* > */
+    {0x02, 0x01, 0x51, 0x09, 0x06}, /* ? */
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, /* @ */
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, /* A */
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, /* B */
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, /* C */
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, /* D */
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, /* E */
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, /* F */
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, /* G */
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, /* H */
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, /* I */
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, /* J */
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, /* K */
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, /* L */
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, /* M */
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, /* N */
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, /* O */
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, /* P */
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, /* Q */
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, /* R */
+    {0x46, 0x49, 0x49, 0x49, 0x31}, /* S */
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, /* T */
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, /* U */
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, /* V */
+    {0x3F, 0x40, 0x38, 0x40, 0x3F}, /* W */
+    {0x63, 0x14, 0x08, 0x14, 0x63}, /* X */
+    {0x07, 0x08, 0x70, 0x08, 0x07}, /* Y */
+    {0x61, 0x51, 0x49, 0x45, 0x43}, /* Z */
+    {0x00, 0x7F, 0x41, 0x41, 0x00}, /* [ */
+    {0x02, 0x04, 0x08, 0x10, 0x20}, /* \ */
+    {0x00, 0x41, 0x41, 0x7F, 0x00}, /* ] */
+    {0x04, 0x02, 0x01, 0x02, 0x04}, /* ^ */
+    {0x40, 0x40, 0x40, 0x40, 0x40}, /* _ */
+    {0x00, 0x01, 0x02, 0x04, 0x00}, /* ` */
+    {0x20, 0x54, 0x54, 0x54, 0x78}, /* a */
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, /* b */
+    {0x38, 0x44, 0x44, 0x44, 0x20}, /* c */
+    {0x38, 0x44, 0x44, 0x48, 0x7F}, /* d */
+    {0x38, 0x54, 0x54, 0x54, 0x18}, /* e */
+    {0x08, 0x7E, 0x09, 0x01, 0x02}, /* f */
+    {0x0C, 0x52, 0x52, 0x52, 0x3E}, /* g */
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, /* h */
+    {0x00, 0x44, 0x7D, 0x40, 0x00}, /* i */
+    {0x20, 0x40, 0x44, 0x3D, 0x00}, /* j */
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, /* k */
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, /* l */
+    {0x7C, 0x04, 0x18, 0x04, 0x78}, /* m */
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, /* n */
+    {0x38, 0x44, 0x44, 0x44, 0x38}, /* o */
+    {0x7C, 0x14, 0x14, 0x14, 0x08}, /* p */
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, /* q */
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, /* r */
+    {0x48, 0x54, 0x54, 0x54, 0x20}, /* s */
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, /* t */
+    {0x3C, 0x40, 0x40, 0x20, 0x7C}, /* u */
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, /* v */
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, /* w */
+    {0x44, 0x28, 0x10, 0x28, 0x44}, /* x */
+    {0x0C, 0x50, 0x50, 0x50, 0x3C}, /* y */
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, /* z */
+    {0x00, 0x08, 0x36, 0x41, 0x00}, /* { */
+    {0x00, 0x00, 0x7F, 0x00, 0x00}, /* | */
+    {0x00, 0x41, 0x36, 0x08, 0x00}, /* } */
+    {0x08, 0x04, 0x08, 0x10, 0x08}, /* ~ */
+};
+
+/* Copy of the controller memory, blank after SH1107_Init */
+static uint8_t frame[SH1107_PAGES][SH1107_PAGE_COLUMNS];
+
+/* Changed columns of each page, [start, end), clean if end is 0 */
+static uint8_t dirtyStart[SH1107_PAGES];
+static uint8_t dirtyEnd[SH1107_PAGES];
+
+/* Characters on screen, 0 for a blank cell */
+static char cells[SH1107_ROWS][SH1107_COLUMNS];
+static uint8_t layoutSize = 0;
+static uint8_t layoutY = 0;
+
+#if SH1107_PAGES > 16
+#error "pagesBusy holds a bit per page"
+#endif
+
+static SH1107_segment_t segments[SH1107_SEGMENTS];
+static uint16_t pagesBusy = 0; /* Pages with a segment on the bus */
+static uint16_t bytesQueued = 0;
+static SH1107_stats_t displayStats;
+
+static void SH1107_setPixel(int16_t x, int16_t y, bool on);
+static void SH1107_drawCell(uint8_t row, uint8_t column, char c);
+static bool SH1107_submitSegment(uint8_t page);
+static void SH1107_onSegmentDone(I2CTransfer_t *transfer);
+
+/**
+ * @brief  Set a pixel of the framebuffer and mark its page column dirty
+ * @param  x screen column
+ * @param  y screen row
+ * @param  on pixel lit
+ * @retval None
+ */
+static void SH1107_setPixel(int16_t x, int16_t y, bool on)
+{
+    uint8_t page;
+    uint8_t column;
+    uint8_t mask;
+    uint8_t value;
+
+    if (x < 0 || x >= SH1107_WIDTH || y < 0 || y >= SH1107_HEIGHT)
+    {
+        return;
+    }
+    page = x / 8;
+    column = SH1107_PAGE_COLUMNS - 1 - y;
+    mask = 1 << (x % 8);
+    value = on ? (frame[page][column] | mask) : (frame[page][column] & ~mask);
+    if (value == frame[page][column])
+    {
+        return;
+    }
+    frame[page][column] = value;
+
+    if (dirtyEnd[page] == 0)
+    {
+        dirtyStart[page] = column;
+        dirtyEnd[page] = column + 1;
+    }
+    else if (column < dirtyStart[page])
+    {
+        dirtyStart[page] = column;
+    }
+    else if (column >= dirtyEnd[page])
+    {
+        dirtyEnd[page] = column + 1;
+    }
+}
+
+/**
+ * @brief  Render a character cell of the current layout, the background
+ *         of the cell is cleared
+ * @param  row cell row
+ * @param  column cell column
+ * @param  c character, 0 for a blank cell
+ * @retval None
+ */
+static void SH1107_drawCell(uint8_t row, uint8_t column, char c)
+{
+    int16_t x0 = column * SH1107_CELL_WIDTH * layoutSize;
+    int16_t y0 = layoutY + row * SH1107_CELL_HEIGHT * layoutSize;
+    const uint8_t *glyph = ((uint8_t)c >= SH1107_FONT_FIRST && (uint8_t)c <= SH1107_FONT_LAST) ? SH1107_font[(uint8_t)c - SH1107_FONT_FIRST] : SH1107_font[0];
+
+    for (uint8_t gx = 0; gx < SH1107_CELL_WIDTH; gx++)
+    {
+        /* The last column is the space between characters */
+        uint8_t bits = (gx < 5) ? glyph[gx] : 0;
+
+        for (uint8_t gy = 0; gy < SH1107_CELL_HEIGHT; gy++)
+        {
+            bool on = (bits >> gy) & 1;
+
+            for (uint8_t sx = 0; sx < layoutSize; sx++)
+            {
+                for (uint8_t sy = 0; sy < layoutSize; sy++)
+                {
+                    SH1107_setPixel(x0 + gx * layoutSize + sx, y0 + gy * layoutSize + sy, on);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Queue the dirty columns of a page
+ * @param  page page index
+ * @retval false if all the segments are on the bus
+ */
+static bool SH1107_submitSegment(uint8_t page)
+{
+    SH1107_segment_t *segment = NULL;
+    uint8_t start = dirtyStart[page];
+    uint8_t length = dirtyEnd[page] - start;
+    uint8_t column = start + SH1107_COLUMN_OFFSET;
+
+    for (uint8_t i = 0; i < SH1107_SEGMENTS && segment == NULL; i++)
+    {
+        if (!segments[i].busy)
+        {
+            segment = &segments[i];
+        }
+    }
+    if (segment == NULL)
+    {
+        return false;
+    }
+    dirtyEnd[page] = 0;
+
+    segment->commandBytes[0] = SH1107_SET_PAGE | page;
+    segment->commandBytes[1] = SH1107_SET_COLUMN_HIGH | (column >> 4);
+    segment->commandBytes[2] = SH1107_SET_COLUMN_LOW | (column & 0x0F);
+
+    segment->command.type = i2cTransferWrite;
+    segment->command.address = SH1107_ADDRESS_I2C;
+    segment->command.regAdr = SH1107_CONTROL_COMMAND;
+    segment->command.data = segment->commandBytes;
+    segment->command.length = sizeof(segment->commandBytes);
+    segment->command.callback = NULL;
+    segment->command.context = NULL;
+
+    /* The data is sent from the framebuffer, a pixel changed in the meantime
+     * marks the page dirty again and is sent with the next segment */
+    segment->data.type = i2cTransferWrite;
+    segment->data.address = SH1107_ADDRESS_I2C;
+    segment->data.regAdr = SH1107_CONTROL_DATA;
+    segment->data.data = &frame[page][start];
+    segment->data.length = length;
+    segment->data.callback = SH1107_onSegmentDone;
+    segment->data.context = segment;
+
+    if (I2CSubmit(&segment->command) != WE_SUCCESS || I2CSubmit(&segment->data) != WE_SUCCESS)
+    {
+        displayStats.errors++;
+        return true;
+    }
+    segment->page = page;
+    segment->busy = true;
+    pagesBusy |= (uint16_t)(1u << page);
+    bytesQueued += length;
+    displayStats.segments++;
+    displayStats.bytes += length;
+    return true;
+}
+
+/**
+ * @brief  Completion of a page segment, queue the next dirty pages
+ * @param  transfer data transfer of the segment
+ * @retval None
+ */
+static void SH1107_onSegmentDone(I2CTransfer_t *transfer)
+{
+    SH1107_segment_t *segment = (SH1107_segment_t *)transfer->context;
+
+    segment->busy = false;
+    pagesBusy &= (uint16_t)~(1u << segment->page);
+    bytesQueued -= transfer->length;
+    if (segment->command.status != WE_SUCCESS || transfer->status != WE_SUCCESS)
+    {
+        displayStats.errors++;
+    }
+    SH1107_Update();
+}
+
+/**
+ * @brief  Display a string on the SH1107
+ *
+ * The previous text is replaced, only the characters that changed are
+ * redrawn. The transfer runs in the background, see SH1107_Update.
+ * @param  fontSize text magnification
+ * @param  cursorX column of the first character, rounded to the cell grid
+ * @param  cursorY row of the first line
+ * @param  text text, '\n' starts a new line and long lines are wrapped
+ * @retval None
+ */
+void SH1107_Display(uint8_t fontSize, uint8_t cursorX, uint8_t cursorY, const char *text)
+{
+    char next[SH1107_ROWS][SH1107_COLUMNS];
+    uint8_t size = (fontSize == 0) ? 1 : fontSize;
+    uint8_t columns = SH1107_WIDTH / (SH1107_CELL_WIDTH * size);
+    uint8_t rows = (cursorY >= SH1107_HEIGHT) ? 0 : (SH1107_HEIGHT - cursorY + SH1107_CELL_HEIGHT * size - 1) / (SH1107_CELL_HEIGHT * size);
+    uint8_t row = 0;
+    uint8_t column = cursorX / (SH1107_CELL_WIDTH * size);
+
+    /* Lay out the text like the Adafruit GFX print */
+    memset(next, 0, sizeof(next));
+    for (const char *c = text; *c != '\0' && row < rows; c++)
+    {
+        if (*c == '\n')
+        {
+            row++;
+            column = 0;
+            continue;
+        }
+        if (*c == '\r')
+        {
+            continue;
+        }
+        if (column >= columns)
+        {
+            row++;
+            column = 0;
+            if (row >= rows)
+            {
+                break;
+            }
+        }
+        next[row][column++] = (*c == ' ') ? 0 : *c;
+    }
+
+    if (size != layoutSize || cursorY != layoutY)
+    {
+        /* The cells move, erase the text of the previous layout */
+        for (row = 0; row < SH1107_ROWS; row++)
+        {
+            for (column = 0; column < SH1107_COLUMNS; column++)
+            {
+                if (cells[row][column] != 0)
+                {
+                    SH1107_drawCell(row, column, 0);
+                    cells[row][column] = 0;
+                }
+            }
+        }
+        layoutSize = size;
+        layoutY = cursorY;
+    }
+
+    for (row = 0; row < SH1107_ROWS; row++)
+    {
+        for (column = 0; column < SH1107_COLUMNS; column++)
+        {
+            if (next[row][column] != cells[row][column])
+            {
+                SH1107_drawCell(row, column, next[row][column]);
+                cells[row][column] = next[row][column];
+                displayStats.cellsDrawn++;
+            }
+        }
+    }
+    displayStats.frames++;
+    SH1107_Update();
+}
+
+/**
+ * @brief  Queue the dirty pages while less than SH1107_UPDATE_BUDGET bytes
+ *         are on the bus and a segment is free. Called when a page
+ *         completes, from I2CPoll.
+ * @retval None
+ */
+void SH1107_Update()
+{
+    for (uint8_t page = 0; page < SH1107_PAGES && bytesQueued < SH1107_UPDATE_BUDGET; page++)
+    {
+        if (!(pagesBusy & (1u << page)) && dirtyEnd[page] != 0 && !SH1107_submitSegment(page))
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief  Wait until the screen shows the last text, to be called before
+ *         blocking for a long time
+ * @retval None
+ */
+void SH1107_Flush()
+{
+    SH1107_Update();
+    while (SH1107_isBusy())
+    {
+        I2CPoll();
+        SH1107_Update();
+    }
+}
+
+/**
+ * @brief  Check if the screen is being updated
+ * @retval true while pages are dirty or on the bus
+ */
+bool SH1107_isBusy()
+{
+    if (bytesQueued > 0)
+    {
+        return true;
+    }
+    for (uint8_t page = 0; page < SH1107_PAGES; page++)
+    {
+        if (dirtyEnd[page] != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief  Get the rendering and transfer statistics
+ * @param  stats Returns the statistics
+ * @retval None
+ */
+void SH1107_getStats(SH1107_stats_t *stats)
+{
+    *stats = displayStats;
+}
+/**         EOF         */
@@ -0,0 +1,90 @@
+/**
+ * \file
+ * \brief File for the OLED display featherWing of the WE IoT design kit.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef DISPLAYBOARD_H
+#define DISPLAYBOARD_H
+
+/**         Includes         */
+#include "ConfigPlatform.h"
+
+/**         Functions definition         */
+#define SH1107_ADDRESS_I2C 0x3C
+
+/* Landscape screen as seen by the user */
+#define SH1107_WIDTH 128
+#define SH1107_HEIGHT 64
+
+/* Controller memory, the panel is mounted rotated: a page is 8 screen
+ * columns wide and its bytes run from the bottom to the top of the screen */
+#define SH1107_PAGES (SH1107_WIDTH / 8)
+#define SH1107_PAGE_COLUMNS SH1107_HEIGHT
+#define SH1107_COLUMN_OFFSET 0
+
+/* Text cell of the 5x7 font at size 1 */
+#define SH1107_CELL_WIDTH 6
+#define SH1107_CELL_HEIGHT 8
+#define SH1107_COLUMNS (SH1107_WIDTH / SH1107_CELL_WIDTH)
+#define SH1107_ROWS (SH1107_HEIGHT / SH1107_CELL_HEIGHT)
+
+/* Control byte before a command or data stream */
+#define SH1107_CONTROL_COMMAND 0x00
+#define SH1107_CONTROL_DATA 0x40
+
+/* Bytes queued on the I2C bus at a time, about 5 ms at 400 kHz. The rest
+ * of a frame follows as the queued pages complete. */
+#define SH1107_UPDATE_BUDGET 256
+
+/* Pages on the bus at a time, each takes two I2C transfers (68 bytes on
+ * the M0). The other dirty pages follow as they complete. */
+#ifndef SH1107_SEGMENTS
+#define SH1107_SEGMENTS 4
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        uint32_t frames;     /* SH1107_Display calls */
+        uint32_t cellsDrawn; /* Text cells rendered because their character changed */
+        uint32_t segments;   /* Page segments transmitted */
+        uint32_t bytes;      /* Framebuffer bytes transmitted */
+        uint32_t errors;     /* Page segments lost on the bus */
+    } SH1107_stats_t;
+
+    void SH1107_Display(uint8_t fontSize, uint8_t cursorX, uint8_t cursorY, const char *text);
+    void SH1107_Update();
+    void SH1107_Flush();
+    bool SH1107_isBusy();
+    void SH1107_getStats(SH1107_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISPLAYBOARD_H */
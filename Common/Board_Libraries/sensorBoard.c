@@ -29,6 +29,47 @@
 #include "WSEN_ITDS_2533020201601.h" //Acelerometer Sensor
 #include "WSEN_PADS_2511020213301.h" //Pressure Sensor
 #include "WSEN_TIDS_2521020222501.h" //Temperature Sensor
+#if VIBRATION_ANALYSIS
+#include "fft.h"
+#endif
+
+/* ITDS sensitivity at full scale 16g in normal mode in ug/LSB (14 bit) */
+#define ITDS_SENSITIVITY_16G_UG 1952
+
+static int32_t ITDS_rawToMilliG(int16_t rawAcc);
+
+#if PADS_FIFO_BATCHING
+/* R / g of dry air in 0.001 m/K, for the hypsometric altitude */
+#define PADS_SCALE_HEIGHT_MM_PER_K 29271
+
+#if PADS_FIFO_MAX_BURST * PADS_FIFO_SAMPLE_SIZE > PADS_FIFO_BURST_BYTES
+#error "PADS_FIFO_BURST_BYTES too small for PADS_FIFO_MAX_BURST"
+#endif
+
+static bool PADS_startFifoBatching(PADS *self);
+static bool PADS_submitFifoBurst(PADS *self);
+#endif
+
+#ifdef ITDS_INT_PIN
+static volatile bool itdsInterruptPending = false;
+static void ITDS_onInterrupt();
+#endif
+
+#if VIBRATION_ANALYSIS
+/* Maximum time to fill a block of samples in ms */
+#define VIBRATION_CAPTURE_TIMEOUT 1000
+
+/* Band limits in Hz, the sensor bandwidth at 1600 Hz is 400 Hz */
+static const uint16_t vibrationBandEdges[VIBRATION_BANDS + 1] = {10, 50, 100, 200, 400};
+
+/* The sample buffer is reused by the transform */
+static int16_t vibrationSamples[VIBRATION_FFT_POINTS];
+static uint16_t vibrationSpectrum[VIBRATION_FFT_POINTS / 2];
+
+static bool ITDS_captureBlock(ITDS *self, int16_t *samples, uint16_t count);
+static bool ITDS_setVibrationMode(bool enable);
+static uint16_t ITDS_spectrumToMilliG(uint64_t value, int8_t shift);
+#endif
 
 /***************************PADS OBJECT***************************/
 /**
@@ -43,6 +84,11 @@ PADS *PADSCreate(TypeSerial *serialDebug)
     strcpy(allocateInit->nameType, "PADS");
     allocateInit->data[padsPressure] = 0;
     allocateInit->dataNames[padsPressure] = "pressure";
+#if PADS_FIFO_BATCHING
+    memset(&allocateInit->batch, 0, sizeof(allocateInit->batch));
+    allocateInit->pressureTrend = 0;
+    allocateInit->altitude = 0;
+#endif
     return allocateInit;
 }
 
@@ -164,17 +210,62 @@ bool PADS_simpleInit(PADS *self)
         return false;
     }
 
+#if PADS_FIFO_BATCHING
+    return PADS_startFifoBatching(self);
+#else
     return true;
+#endif
 }
 
 /**
  * @brief  Setup the sensor in single conversion mode and trigger a readout on
- * Enter key press
+ * Enter key press. With FIFO batching the average of all samples since the
+ * last read is used instead.
  * @param  self Pointer to the sensor object.
  * @retval true if successful false in case of failure
  */
 bool PADS_readSensorData(PADS *self)
 {
+#if PADS_FIFO_BATCHING
+    PADS_batch_t *batch = &self->batch;
+    unsigned long now;
+    int32_t pressure;
+    int32_t temperature;
+
+    /*Average all samples since the last read*/
+    if (!PADS_serviceFifo(self, true) || (batch->samples == 0))
+    {
+        return false;
+    }
+    now = millis();
+    pressure = (int32_t)((batch->pressureSum + batch->samples / 2) / batch->samples);
+    temperature = batch->temperatureSum / (int32_t)batch->samples;
+
+    /* 40960 LSB/kPa -> Pa = raw * 25 / 1024, rounded */
+    self->data[padsPressure] = (pressure * 25 + 512) >> 10;
+
+    if (batch->referencePressure == 0)
+    {
+        batch->referencePressure = pressure;
+        self->pressureTrend = 0;
+    }
+    else if (now != batch->lastRead)
+    {
+        /*Pa/h from the averages of two consecutive reads*/
+        int64_t delta = (int64_t)(pressure - batch->lastPressure) * 25 * 3600000;
+        self->pressureTrend = (int32_t)(delta / ((int64_t)1024 * (int64_t)(now - batch->lastRead)));
+    }
+    /*Hypsometric equation, dh = -(R / g) * T * dp / p*/
+    self->altitude = (int32_t)(-(int64_t)PADS_SCALE_HEIGHT_MM_PER_K * (temperature + 27315) * (pressure - batch->referencePressure) /
+                               ((int64_t)1000 * pressure));
+
+    batch->lastPressure = pressure;
+    batch->lastRead = now;
+    batch->pressureSum = 0;
+    batch->temperatureSum = 0;
+    batch->samples = 0;
+    return true;
+#else
     int8_t status = WE_FAIL;
     I2CSetAddress(PADS_ADDRESS_I2C_1);
     /*Start a conversion*/
@@ -189,7 +280,7 @@ bool PADS_readSensorData(PADS *self)
 
     delay(15);
 
-    status = PADS_getPressure(&self->data[padsPressure]);
+    status = PADS_getPressure_int(&self->data[padsPressure]);
     if (status != WE_SUCCESS)
     {
 #if SERIAL_DEBUG
@@ -197,10 +288,180 @@ bool PADS_readSensorData(PADS *self)
 #endif
         return false;
     }
-    /*Round to 3 decimal places*/
-    self->data[padsPressure] = round(self->data[padsPressure] * 1000) / (float)1000;
+    return true;
+#endif
+}
+
+#if PADS_FIFO_BATCHING
+/**
+ * @brief  Start continuous conversions into the FIFO
+ * @param  self Pointer to the sensor object.
+ * @retval true if successful false in case of failure
+ */
+static bool PADS_startFifoBatching(PADS *self)
+{
+    /*Bypass mode empties the FIFO*/
+    if ((PADS_setFifoMode(PADS_bypassMode) != WE_SUCCESS) ||
+        (PADS_setFifoThr(PADS_FIFO_WATERMARK) != WE_SUCCESS) ||
+        (PADS_setFifoMode(PADS_ContinuousMode) != WE_SUCCESS) ||
+        (PADS_setOutputDataRate(PADS_outputDataRate10HZ) != WE_SUCCESS))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "Set FIFO mode error\r\n");
+#endif
+        return false;
+    }
+    self->batch.lastDrain = millis();
+    self->batch.lastRead = self->batch.lastDrain;
+    return true;
+}
+
+/**
+ * @brief  Add FIFO samples to the running sums
+ * @param  self Pointer to the sensor object.
+ * @param  samples Number of samples
+ * @param  pressure Raw pressure values
+ * @param  temperature Raw temperature values
+ * @retval none
+ */
+static void PADS_accumulateFifo(PADS *self, uint8_t samples, const int32_t *pressure, const int16_t *temperature)
+{
+    for (uint8_t i = 0; i < samples; i++)
+    {
+        self->batch.pressureSum += pressure[i];
+        self->batch.temperatureSum += temperature[i];
+    }
+    self->batch.samples += samples;
+}
+
+/**
+ * @brief  Completion of a background FIFO burst, queues the next one
+ * @param  transfer Completed transfer, the context is the sensor object
+ * @retval none
+ */
+static void PADS_onFifoBurst(I2CTransfer_t *transfer)
+{
+    PADS *self = (PADS *)transfer->context;
+    uint8_t burst = transfer->length / PADS_FIFO_SAMPLE_SIZE;
+    int32_t pressure[PADS_FIFO_MAX_BURST];
+    int16_t temperature[PADS_FIFO_MAX_BURST];
+
+    if (transfer->status != WE_SUCCESS)
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "Get FIFO data error\r\n");
+#endif
+        self->batch.pendingSamples = 0;
+        return;
+    }
+    PADS_decodeFifoRAWValues(burst, self->batch.fifoData, pressure, temperature);
+    PADS_accumulateFifo(self, burst, pressure, temperature);
+    self->batch.pendingSamples -= burst;
+    if (self->batch.pendingSamples > 0)
+    {
+        PADS_submitFifoBurst(self);
+    }
+}
+
+/**
+ * @brief  Queue the read of the next FIFO burst
+ * @param  self Pointer to the sensor object.
+ * @retval true if successful false in case of failure
+ */
+static bool PADS_submitFifoBurst(PADS *self)
+{
+    PADS_batch_t *batch = &self->batch;
+    uint8_t burst = (batch->pendingSamples > PADS_FIFO_MAX_BURST) ? PADS_FIFO_MAX_BURST : batch->pendingSamples;
+
+    batch->transfer.type = i2cTransferRead;
+    batch->transfer.address = PADS_ADDRESS_I2C_1;
+    batch->transfer.regAdr = PADS_FIFO_DATA_P_XL_REG;
+    batch->transfer.data = batch->fifoData;
+    batch->transfer.length = burst * PADS_FIFO_SAMPLE_SIZE;
+    batch->transfer.callback = PADS_onFifoBurst;
+    batch->transfer.context = self;
+    if (I2CSubmit(&batch->transfer) != WE_SUCCESS)
+    {
+        batch->pendingSamples = 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief  Drain the FIFO into the running sums once the watermark is reached
+ *
+ * The fill time of the FIFO is known, so the sensor is not polled in between.
+ * The periodic drain runs in the background on the I2C queue, a forced drain
+ * completes it and reads the rest of the FIFO before returning.
+ * @param  self Pointer to the sensor object.
+ * @param  force drain the FIFO regardless of the watermark
+ * @retval true if successful false in case of failure
+ */
+bool PADS_serviceFifo(PADS *self, bool force)
+{
+    int32_t pressure[PADS_FIFO_MAX_BURST];
+    int16_t temperature[PADS_FIFO_MAX_BURST];
+    PADS_state_t overrun = PADS_disable;
+    unsigned long now = millis();
+    uint8_t level = 0;
+
+    if (self->batch.pendingSamples > 0)
+    {
+        if (!force)
+        {
+            return true;
+        }
+        while (self->batch.pendingSamples > 0)
+        {
+            I2CPoll();
+        }
+    }
+    if (!force && (now - self->batch.lastDrain < (unsigned long)PADS_FIFO_WATERMARK * 1000 / PADS_FIFO_RATE))
+    {
+        return true;
+    }
+    self->batch.lastDrain = now;
+
+    I2CSetAddress(PADS_ADDRESS_I2C_1);
+    if ((PADS_getFifoOvrState(&overrun) != WE_SUCCESS) ||
+        (PADS_getFifoFillLevel(&level) != WE_SUCCESS))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "Get FIFO status error\r\n");
+#endif
+        return false;
+    }
+    if (overrun == PADS_enable)
+    {
+        /*The oldest samples were overwritten, the average is still valid*/
+        self->batch.overruns++;
+    }
+
+    if (!force)
+    {
+        /*Let the main loop run while the samples are moved*/
+        self->batch.pendingSamples = level;
+        return (level == 0) || PADS_submitFifoBurst(self);
+    }
+
+    while (level > 0)
+    {
+        uint8_t burst = (level > PADS_FIFO_MAX_BURST) ? PADS_FIFO_MAX_BURST : level;
+
+        if (PADS_getFifoRAWValues(burst, pressure, temperature) != WE_SUCCESS)
+        {
+#if SERIAL_DEBUG
+            SSerial_printf(self->serialDebug, "Get FIFO data error\r\n");
+#endif
+            return false;
+        }
+        PADS_accumulateFifo(self, burst, pressure, temperature);
+        level -= burst;
+    }
     return true;
 }
+#endif
 
 /***************************ITDS OBJECT***************************/
 /**
@@ -219,6 +480,12 @@ ITDS *ITDSCreate(TypeSerial *serialDebug)
     allocateInit->dataNames[itdsXAcceleration] = "x";
     allocateInit->dataNames[itdsYAcceleration] = "y";
     allocateInit->dataNames[itdsZAcceleration] = "z";
+    allocateInit->motionEventNames[itdsSingleTap] = "singleTap";
+    allocateInit->motionEventNames[itdsDoubleTap] = "doubleTap";
+    allocateInit->motionEventNames[itdsFreeFall] = "freeFall";
+    allocateInit->motionEventNames[itdsWakeUp] = "wakeUp";
+    allocateInit->motionEventNames[itdsStationary] = "stationary";
+    allocateInit->motionPollTime = 0;
     return allocateInit;
 }
 
@@ -343,6 +610,171 @@ bool ITDS_simpleInit(ITDS *self)
     return true;
 }
 
+/**
+ * @brief  Configure the tap, free-fall, wake-up and stationary detectors of the sensor
+ * @param  self Pointer to the sensor object.
+ * @retval true if successful false in case of failure
+ */
+bool ITDS_enableMotionEvents(ITDS *self)
+{
+    I2CSetAddress(ITDS_ADDRESS_I2C_1);
+
+    /*Single and double tap on all axes*/
+    if ((ITDS_setTapThresholdX(ITDS_TAP_THRESHOLD) != WE_SUCCESS) ||
+        (ITDS_setTapThresholdY(ITDS_TAP_THRESHOLD) != WE_SUCCESS) ||
+        (ITDS_setTapThresholdZ(ITDS_TAP_THRESHOLD) != WE_SUCCESS) ||
+        (ITDS_setTapAxisPriority(Z_Y_X) != WE_SUCCESS) ||
+        (ITDS_enTapX(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enTapY(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enTapZ(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_setShock(ITDS_TAP_SHOCK) != WE_SUCCESS) ||
+        (ITDS_setQuiet(ITDS_TAP_QUIET) != WE_SUCCESS) ||
+        (ITDS_setLatency(ITDS_TAP_LATENCY) != WE_SUCCESS) ||
+        (ITDS_enTapEvent(ITDS_enable) != WE_SUCCESS))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "set tap detection fail\r\n");
+#endif
+        return false;
+    }
+
+    /*Wake-up and stationary detection, the output data rate is kept in sleep*/
+    if ((ITDS_setWakeupThreshold(ITDS_WAKEUP_THRESHOLD) != WE_SUCCESS) ||
+        (ITDS_setWakeupDuration(0) != WE_SUCCESS) ||
+        (ITDS_setSleepDuration(ITDS_SLEEP_DURATION) != WE_SUCCESS) ||
+        (ITDS_enStationnaryDetection(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enInactivity(ITDS_enable) != WE_SUCCESS))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "set wake-up detection fail\r\n");
+#endif
+        return false;
+    }
+
+    /*Free-fall below 312 mg*/
+    if ((ITDS_setFreeFallThreshold(ten) != WE_SUCCESS) ||
+        (ITDS_setFreeFallDurationLSB(ITDS_FREE_FALL_DURATION) != WE_SUCCESS) ||
+        (ITDS_setFreeFallDurationMSB(ITDS_disable) != WE_SUCCESS))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "set free-fall detection fail\r\n");
+#endif
+        return false;
+    }
+
+    /*All events latched on INT_0 until ALL_INT_EVENT is read*/
+    if ((ITDS_enSingleTapINT0(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enDoubleTapINT0(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enFreeFallINT0(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enWakeupOnINT0(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enActivityINT1(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_setInt1OnInt0(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enLatchInt(ITDS_enable) != WE_SUCCESS) ||
+        (ITDS_enInterrups(ITDS_enable) != WE_SUCCESS))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "set interrupt routing fail\r\n");
+#endif
+        return false;
+    }
+
+#ifdef ITDS_INT_PIN
+    pinMode(ITDS_INT_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(ITDS_INT_PIN), ITDS_onInterrupt, RISING);
+    /*Events latched before the interrupt was attached*/
+    itdsInterruptPending = true;
+#endif
+    return true;
+}
+
+/**
+ * @brief  Check if motion events have to be read from the sensor
+ * @param  self Pointer to the sensor object.
+ * @retval true if the interrupt fired or the poll interval expired
+ */
+bool ITDS_isMotionEventPending(ITDS *self)
+{
+#ifdef ITDS_INT_PIN
+    (void)self;
+    return itdsInterruptPending;
+#else
+    unsigned long now = millis();
+    if (now - self->motionPollTime < ITDS_MOTION_POLL_INTERVAL)
+    {
+        return false;
+    }
+    self->motionPollTime = now;
+    return true;
+#endif
+}
+
+/**
+ * @brief  Read and clear the motion events detected by the sensor
+ * @param  self Pointer to the sensor object.
+ * @param  events returns a bit mask of ITDS_MOTION_EVENT_BIT
+ * @retval true if successful false in case of failure
+ */
+bool ITDS_getMotionEvents(ITDS *self, uint8_t *events)
+{
+    ITDS_all_int_event_t allEvents;
+    ITDS_state_t sleepState = ITDS_disable;
+
+    *events = 0;
+#ifdef ITDS_INT_PIN
+    /*Cleared before the read so that a new edge is not lost*/
+    itdsInterruptPending = false;
+#endif
+    I2CSetAddress(ITDS_ADDRESS_I2C_1);
+    if (ITDS_getAllInterruptEvents(&allEvents) != WE_SUCCESS)
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "read motion events fail\r\n");
+#endif
+        return false;
+    }
+
+    if (allEvents.singleTapState)
+    {
+        *events |= ITDS_MOTION_EVENT_BIT(itdsSingleTap);
+    }
+    if (allEvents.doubleTapState)
+    {
+        *events |= ITDS_MOTION_EVENT_BIT(itdsDoubleTap);
+    }
+    if (allEvents.freeFallState)
+    {
+        *events |= ITDS_MOTION_EVENT_BIT(itdsFreeFall);
+    }
+    if (allEvents.wakeupState)
+    {
+        *events |= ITDS_MOTION_EVENT_BIT(itdsWakeUp);
+    }
+    if (allEvents.sleepState)
+    {
+        /*Sleep change, only the transition to sleep is reported*/
+        if (ITDS_getsleepState(&sleepState) != WE_SUCCESS)
+        {
+            return false;
+        }
+        if (sleepState == ITDS_enable)
+        {
+            *events |= ITDS_MOTION_EVENT_BIT(itdsStationary);
+        }
+    }
+    return true;
+}
+
+#ifdef ITDS_INT_PIN
+/**
+ * @brief  Interrupt handler of the ITDS INT_0 pin
+ * @retval none
+ */
+static void ITDS_onInterrupt()
+{
+    itdsInterruptPending = true;
+}
+#endif
+
 /**
  * @brief  Read the acceleration data in normal mode
  * @param  self Pointer to the sensor object.
@@ -374,12 +806,7 @@ bool ITDS_readSensorData(ITDS *self)
 #endif
             return false;
         }
-        XRawAcc = XRawAcc >> 2;
-        self->data[itdsXAcceleration] = (float)(XRawAcc);
-        self->data[itdsXAcceleration] = (self->data[itdsXAcceleration]) / 1000;
-        self->data[itdsXAcceleration] = (self->data[itdsXAcceleration]) * 1.952;
-        /*Round to 3 decimal places*/
-        self->data[itdsXAcceleration] = round(self->data[itdsXAcceleration] * 1000) / (float)1000;
+        self->data[itdsXAcceleration] = ITDS_rawToMilliG(XRawAcc);
 
         status = ITDS_getRawAccelerationY(&YRawAcc);
         if (status != WE_SUCCESS)
@@ -389,12 +816,7 @@ bool ITDS_readSensorData(ITDS *self)
 #endif
             return false;
         }
-        YRawAcc = YRawAcc >> 2;
-        self->data[itdsYAcceleration] = (float)(YRawAcc);
-        self->data[itdsYAcceleration] = (self->data[itdsYAcceleration]) / 1000;
-        self->data[itdsYAcceleration] = (self->data[itdsYAcceleration]) * 1.952;
-        /*Round to 3 decimal places*/
-        self->data[itdsYAcceleration] = round(self->data[itdsYAcceleration] * 1000) / (float)1000;
+        self->data[itdsYAcceleration] = ITDS_rawToMilliG(YRawAcc);
 
         status = ITDS_getRawAccelerationZ(&ZRawAcc);
         if (status != WE_SUCCESS)
@@ -404,12 +826,7 @@ bool ITDS_readSensorData(ITDS *self)
 #endif
             return false;
         }
-        ZRawAcc = ZRawAcc >> 2;
-        self->data[itdsZAcceleration] = (float)(ZRawAcc);
-        self->data[itdsZAcceleration] = (self->data[itdsZAcceleration]) / 1000;
-        self->data[itdsZAcceleration] = (self->data[itdsZAcceleration]) * 1.952;
-        /*Round to 3 decimal places*/
-        self->data[itdsZAcceleration] = round(self->data[itdsZAcceleration] * 1000) / (float)1000;
+        self->data[itdsZAcceleration] = ITDS_rawToMilliG(ZRawAcc);
     }
     else
     {
@@ -422,6 +839,183 @@ bool ITDS_readSensorData(ITDS *self)
     return true;
 }
 
+/**
+ * @brief  Convert a raw acceleration value to mg
+ * @param  rawAcc left aligned 16 bit acceleration register value
+ * @retval Acceleration in mg rounded to the nearest integer
+ */
+static int32_t ITDS_rawToMilliG(int16_t rawAcc)
+{
+    /* 14 bit resolution in normal mode, 1.952 mg/LSB, round half away from zero */
+    int32_t acc = (int32_t)(rawAcc >> 2) * ITDS_SENSITIVITY_16G_UG;
+    return (acc < 0) ? (acc - 500) / 1000 : (acc + 500) / 1000;
+}
+
+#if VIBRATION_ANALYSIS
+/**
+ * @brief  Capture a block of acceleration samples and analyse its spectrum
+ * @param  self Pointer to the sensor object.
+ * @retval true if successful false in case of failure
+ */
+bool ITDS_readVibration(ITDS *self)
+{
+    FFT_Peak peaks[VIBRATION_PEAKS];
+    int8_t shift = 0;
+    bool captured;
+
+    I2CSetAddress(ITDS_ADDRESS_I2C_1);
+    if (!ITDS_setVibrationMode(true))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "set vibration mode fail\r\n");
+#endif
+        ITDS_setVibrationMode(false);
+        return false;
+    }
+    captured = ITDS_captureBlock(self, vibrationSamples, VIBRATION_FFT_POINTS);
+
+    /* Always return to the telemetry configuration */
+    if (!ITDS_setVibrationMode(false))
+    {
+#if SERIAL_DEBUG
+        SSerial_printf(self->serialDebug, "restore ITDS mode fail\r\n");
+#endif
+        return false;
+    }
+    if (!captured)
+    {
+        return false;
+    }
+
+    if (!FFT_prepareBlock(vibrationSamples, VIBRATION_FFT_POINTS, &shift) ||
+        !FFT_realMagnitude(vibrationSamples, VIBRATION_FFT_POINTS, vibrationSpectrum))
+    {
+        return false;
+    }
+
+    self->vibration.peaks = FFT_findPeaks(vibrationSpectrum, VIBRATION_FFT_POINTS / 2, peaks, VIBRATION_PEAKS);
+    for (uint8_t i = 0; i < self->vibration.peaks; i++)
+    {
+        self->vibration.peakFrequency[i] = (uint16_t)(((uint32_t)peaks[i].bin * VIBRATION_SAMPLE_RATE + VIBRATION_FFT_POINTS / 2) / VIBRATION_FFT_POINTS);
+        /* Coherent gain of the Hann window is 1/2, one sided spectrum */
+        self->vibration.peakAmplitude[i] = ITDS_spectrumToMilliG(4 * (uint64_t)peaks[i].magnitude, shift);
+    }
+
+    for (uint8_t band = 0; band < VIBRATION_BANDS; band++)
+    {
+        uint32_t firstBin = ((uint32_t)vibrationBandEdges[band] * VIBRATION_FFT_POINTS + VIBRATION_SAMPLE_RATE - 1) / VIBRATION_SAMPLE_RATE;
+        uint32_t lastBin = ((uint32_t)vibrationBandEdges[band + 1] * VIBRATION_FFT_POINTS - 1) / VIBRATION_SAMPLE_RATE;
+        uint64_t energy = 0;
+
+        if (lastBin >= VIBRATION_FFT_POINTS / 2)
+        {
+            lastBin = VIBRATION_FFT_POINTS / 2 - 1;
+        }
+        if (firstBin <= lastBin)
+        {
+            energy = FFT_bandEnergy(vibrationSpectrum, (uint16_t)firstBin, (uint16_t)lastBin);
+        }
+        /* RMS = sqrt(2 * sum |X|^2 / 0.375), 0.375 being the mean power of the Hann window */
+        self->vibration.bandRms[band] = ITDS_spectrumToMilliG(FFT_sqrt(energy * 16 / 3), shift);
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Switch between the 200 Hz telemetry mode and the 1600 Hz FIFO mode
+ * @param  enable true to start the vibration mode false to restore the telemetry mode
+ * @retval true if successful false in case of failure
+ */
+static bool ITDS_setVibrationMode(bool enable)
+{
+    /* Bypass mode empties the FIFO */
+    if (ITDS_setFifoMode(ITDS_bypassMode) != WE_SUCCESS)
+    {
+        return false;
+    }
+    if (ITDS_setOperatingMode(enable ? highPerformance : normalOrLowPower) != WE_SUCCESS)
+    {
+        return false;
+    }
+    if (ITDS_setOutputDataRate(enable ? odr9 : odr6) != WE_SUCCESS)
+    {
+        return false;
+    }
+    if (enable && ITDS_setFifoMode(ITDS_continuousMode) != WE_SUCCESS)
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief  Read a contiguous block of samples of the vibration axis from the FIFO
+ * @param  self Pointer to the sensor object.
+ * @param  samples returns the samples in LSB (14 bit)
+ * @param  count number of samples
+ * @retval true if successful false in case of failure
+ */
+static bool ITDS_captureBlock(ITDS *self, int16_t *samples, uint16_t count)
+{
+    unsigned long start = millis();
+    uint16_t captured = 0;
+
+    while (captured < count)
+    {
+        ITDS_state_t overrun = ITDS_disable;
+        uint8_t fill = 0;
+
+        if (millis() - start > VIBRATION_CAPTURE_TIMEOUT)
+        {
+#if SERIAL_DEBUG
+            SSerial_printf(self->serialDebug, "vibration capture timeout\r\n");
+#endif
+            return false;
+        }
+        if ((ITDS_getFifoOverrunState(&overrun) != WE_SUCCESS) ||
+            (ITDS_getFifoFillLevel(&fill) != WE_SUCCESS))
+        {
+            return false;
+        }
+        if (overrun == ITDS_enable)
+        {
+            /* Samples were lost, the block is no longer contiguous */
+            captured = 0;
+        }
+
+        while (fill > 0 && captured < count)
+        {
+            int16_t raw[itdsProperties];
+
+            if (ITDS_getRawAccelerations(&raw[itdsXAcceleration], &raw[itdsYAcceleration], &raw[itdsZAcceleration]) != WE_SUCCESS)
+            {
+                return false;
+            }
+            samples[captured++] = (int16_t)(raw[VIBRATION_AXIS] >> 2);
+            fill--;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Convert a spectrum value to mg
+ * @param  value spectrum value in LSB scaled by 2^shift
+ * @param  shift block scaling of the transform
+ * @retval Value in mg, saturated to 16 bit
+ */
+static uint16_t ITDS_spectrumToMilliG(uint64_t value, int8_t shift)
+{
+    /* 1.952 mg/LSB in high performance mode at 16g */
+    uint64_t ug = value * ITDS_SENSITIVITY_16G_UG;
+
+    ug = (shift >= 0) ? (ug >> shift) : (ug << -shift);
+    ug = (ug + 500) / 1000;
+    return (ug > UINT16_MAX) ? UINT16_MAX : (uint16_t)ug;
+}
+#endif
+
 /***************************TIDS OBJECT***************************/
 
 /**
@@ -546,7 +1140,8 @@ bool TIDS_readSensorData(TIDS *self)
     }
     if (temperatureDataStatus == TIDS_enable)
     {
-        status = TIDS_getTemperature(&self->data[tidsTemperature]);
+        int16_t temperature = 0;
+        status = TIDS_getTemperature_int(&temperature);
         if (status != WE_SUCCESS)
         {
 #if SERIAL_DEBUG
@@ -554,8 +1149,7 @@ bool TIDS_readSensorData(TIDS *self)
 #endif
             return false;
         }
-        /*Round to 2 decimal places*/
-        self->data[tidsTemperature] = round(self->data[tidsTemperature] * 100) / (float)100;
+        self->data[tidsTemperature] = temperature;
     }
     else
     {
@@ -696,7 +1290,8 @@ bool HIDS_readSensorData(HIDS *self)
     /*check the data status*/
     if (humStatus == HIDS_enable && tempStatus == HIDS_enable)
     {
-        status = HIDS_getHumidity(&(self->data[hidsRelHumidity]));
+        uint16_t humidity = 0;
+        status = HIDS_getHumidity_int(&humidity);
         if (status != WE_SUCCESS)
         {
 #if SERIAL_DEBUG
@@ -704,8 +1299,7 @@ bool HIDS_readSensorData(HIDS *self)
 #endif
             return false;
         }
-        /*Round to 2 decimal places*/
-        self->data[hidsRelHumidity] = round(self->data[hidsRelHumidity] * 100) / (float)100;
+        self->data[hidsRelHumidity] = humidity;
     }
     else
     {
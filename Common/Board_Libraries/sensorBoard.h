@@ -33,6 +33,41 @@
 /**         Functions definition         */
 #define LENGTH_OF_NAMES 16
 
+/* Sensor data is stored as scaled integers, divide by the scale to get the unit */
+#define PADS_PRESSURE_SCALE 1000     /* Pa, scale to kPa */
+#define ITDS_ACCELERATION_SCALE 1000 /* mg, scale to g */
+#define TIDS_TEMPERATURE_SCALE 100   /* 0.01 degC, scale to degC */
+#define HIDS_HUMIDITY_SCALE 100      /* 0.01 %RH, scale to %RH */
+#define PADS_ALTITUDE_SCALE 100      /* cm, scale to m */
+
+/* PADS FIFO batching, enable with -D PADS_FIFO_BATCHING=1 */
+#ifndef PADS_FIFO_BATCHING
+#define PADS_FIFO_BATCHING 0
+#endif
+#define PADS_FIFO_RATE 10       /* Hz, must match the configured output data rate */
+#define PADS_FIFO_WATERMARK 100 /* Samples, drained every PADS_FIFO_WATERMARK / PADS_FIFO_RATE seconds */
+#define PADS_FIFO_BURST_BYTES (32 * 5) /* PADS_FIFO_MAX_BURST samples of PADS_FIFO_SAMPLE_SIZE bytes */
+
+/* Vibration spectrum of the ITDS, enable with -D VIBRATION_ANALYSIS=1 */
+#ifndef VIBRATION_ANALYSIS
+#define VIBRATION_ANALYSIS 0
+#endif
+#define VIBRATION_FFT_POINTS 256       /* Samples per block */
+#define VIBRATION_SAMPLE_RATE 1600     /* Hz */
+#define VIBRATION_AXIS itdsZAcceleration
+#define VIBRATION_PEAKS 3
+#define VIBRATION_BANDS 4
+
+/* ITDS motion detectors, thresholds for 16g full scale at 200 Hz */
+#define ITDS_TAP_THRESHOLD 3         /* 1 LSB = FS/32, 1.5 g */
+#define ITDS_TAP_SHOCK 2             /* 1 LSB = 8/ODR, 80 ms */
+#define ITDS_TAP_QUIET 1             /* 1 LSB = 4/ODR, 20 ms */
+#define ITDS_TAP_LATENCY 3           /* 1 LSB = 32/ODR, 480 ms */
+#define ITDS_WAKEUP_THRESHOLD 1      /* 1 LSB = FS/64, 0.25 g */
+#define ITDS_SLEEP_DURATION 2        /* 1 LSB = 512/ODR, 5.1 s */
+#define ITDS_FREE_FALL_DURATION 6    /* 1 LSB = 1/ODR, 30 ms */
+#define ITDS_MOTION_POLL_INTERVAL 20 /* ms, used when ITDS_INT_PIN is not defined */
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -44,18 +79,41 @@ extern "C"
         padsProperties
     } PADS_properties_t;
 
+    typedef struct
+    {
+        int64_t pressureSum;       /* Sum of the raw pressure samples since the last read */
+        int32_t temperatureSum;    /* Sum of the raw temperature samples since the last read */
+        uint32_t samples;          /* Number of samples in the sums */
+        unsigned long lastDrain;   /* Time of the last FIFO drain in ms */
+        unsigned long lastRead;    /* Time of the last read in ms */
+        int32_t lastPressure;      /* Raw pressure average of the last read */
+        int32_t referencePressure; /* Raw pressure average of the first read */
+        uint16_t overruns;         /* FIFO overruns since start */
+        I2CTransfer_t transfer;    /* Background burst read of the FIFO */
+        uint8_t fifoData[PADS_FIFO_BURST_BYTES];
+        uint8_t pendingSamples; /* Samples left to drain in the background */
+    } PADS_batch_t;
+
     typedef struct
     {
         TypeSerial *serialDebug;
         char nameType[LENGTH_OF_NAMES];
-        float data[padsProperties];
+        int32_t data[padsProperties];
         const char *dataNames[padsProperties];
+#if PADS_FIFO_BATCHING
+        PADS_batch_t batch;
+        int32_t pressureTrend; /* Pa/h */
+        int32_t altitude;      /* cm, relative to the first read */
+#endif
     } PADS;
 
     PADS *PADSCreate(TypeSerial *serialDebug);
     void PADSDestroy(PADS *pads);
     bool PADS_simpleInit(PADS *self);
     bool PADS_readSensorData(PADS *self);
+#if PADS_FIFO_BATCHING
+    bool PADS_serviceFifo(PADS *self, bool force);
+#endif
 
     typedef enum
     {
@@ -65,17 +123,48 @@ extern "C"
         itdsProperties
     } ITDS_properties_t;
 
+    typedef struct
+    {
+        uint8_t peaks;                           /* Number of valid peaks */
+        uint16_t peakFrequency[VIBRATION_PEAKS]; /* Hz, sorted by decreasing amplitude */
+        uint16_t peakAmplitude[VIBRATION_PEAKS]; /* mg */
+        uint16_t bandRms[VIBRATION_BANDS];       /* mg */
+    } ITDS_vibration_t;
+
+    typedef enum
+    {
+        itdsSingleTap,
+        itdsDoubleTap,
+        itdsFreeFall,
+        itdsWakeUp,
+        itdsStationary,
+        itdsMotionEvents
+    } ITDS_motion_event_t;
+
+#define ITDS_MOTION_EVENT_BIT(event) (1U << (event))
+
     typedef struct
     {
         TypeSerial *serialDebug;
         char nameType[LENGTH_OF_NAMES];
-        float data[itdsProperties];
+        int32_t data[itdsProperties];
         const char *dataNames[itdsProperties];
+        const char *motionEventNames[itdsMotionEvents];
+        unsigned long motionPollTime;
+#if VIBRATION_ANALYSIS
+        ITDS_vibration_t vibration;
+#endif
     } ITDS;
     ITDS *ITDSCreate(TypeSerial *serialDebug);
     void ITDSDestroy(ITDS *itds);
     bool ITDS_readSensorData(ITDS *self);
     bool ITDS_simpleInit(ITDS *self);
+    bool ITDS_enableMotionEvents(ITDS *self);
+    bool ITDS_isMotionEventPending(ITDS *self);
+    bool ITDS_getMotionEvents(ITDS *self, uint8_t *events);
+#if VIBRATION_ANALYSIS
+    bool ITDS_readVibration(ITDS *self);
+#endif
 
     typedef enum
     {
@@ -86,7 +175,7 @@ extern "C"
     {
         TypeSerial *serialDebug;
         char nameType[LENGTH_OF_NAMES];
-        float data[tidsProperties];
+        int32_t data[tidsProperties];
         const char *dataNames[tidsProperties];
     } TIDS;
 
@@ -103,7 +192,7 @@ extern "C"
     {
         TypeSerial *serialDebug;
         char nameType[LENGTH_OF_NAMES];
-        float data[hidsProperties];
+        int32_t data[hidsProperties];
         const char *dataNames[hidsProperties];
     } HIDS;
 
@@ -685,6 +685,47 @@ int8_t HIDS_getHumidity(float *humidity)
 
 	return WE_SUCCESS;
 }
+
+/**
+* @brief  Read the Humidity data without floating point operations
+*         The result is clamped to 0..10000 (0..100 %RH), where
+*         HIDS_getHumidity returns the interpolated value unclamped
+* @param  Pointer to the Humidity data in 0.01 %RH
+* @retval error code
+*/
+int8_t HIDS_getHumidity_int(uint16_t *humidity)
+{
+	int32_t H0_rh, H1_rh, H_T_out, H0_T0_out, H1_T0_out;
+	int32_t num, den, hum;
+
+	H_T_out = (int16_t)HIDS_get_H_T_out();
+	H0_rh = HIDS_get_H0_rh() >> 1;
+	H1_rh = HIDS_get_H1_rh() >> 1;
+	H0_T0_out = (int16_t)HIDS_get_H0_T0_out();
+	H1_T0_out = (int16_t)HIDS_get_H1_T0_out();
+
+	den = H1_T0_out - H0_T0_out;
+	if (den == 0)
+		return WE_FAIL;
+
+	/* Linear interpolation between the calibration points, rounded half away from zero */
+	num = (H_T_out - H0_T0_out) * (H1_rh - H0_rh) * 100;
+	if ((num < 0) != (den < 0))
+		hum = (num - den / 2) / den;
+	else
+		hum = (num + den / 2) / den;
+
+	hum += H0_rh * 100;
+
+	if (hum < 0)
+		hum = 0;
+	else if (hum > 10000)
+		hum = 10000;
+
+	*humidity = (uint16_t)hum;
+
+	return WE_SUCCESS;
+}
 /**
 * @brief  Read the Temperature data
 * @param  Pointer to the Temperature data on °C
@@ -267,6 +267,7 @@ extern "C"
 
 	int8_t HIDS_getRAWValues(int16_t *rawHumidity, int16_t *rawTemp);
 	int8_t HIDS_getHumidity(float *humidity);
+	int8_t HIDS_getHumidity_int(uint16_t *humidity); // Humidity Value in 0.01 %RH, clamped to 0..10000
 	int8_t HIDS_getTemperature(float *tempDegC);
 
 #ifdef __cplusplus
@@ -1526,6 +1526,27 @@ int8_t ITDS_getRawAccelerationZ(int16_t *ZRawAcc)
 	return WE_SUCCESS;
 }
 
+/**
+* @brief  Read the raw acceleration of all three axes in a single transfer
+* @param  Pointer to the X axis acceleration
+* @param  Pointer to the Y axis acceleration
+* @param  Pointer to the Z axis acceleration
+* @retval Error code
+*/
+int8_t ITDS_getRawAccelerations(int16_t *XRawAcc, int16_t *YRawAcc, int16_t *ZRawAcc)
+{
+	uint8_t  tmp[6] = { 0 };
+
+	/* Requires address auto increment, reads X_OUT_L to Z_OUT_H */
+	if (WE_FAIL == ReadReg((uint8_t)ITDS_X_OUT_L_REG, 6, tmp))
+	return WE_FAIL;
+
+	*XRawAcc = (int16_t)((tmp[1] << 8) | tmp[0]);
+	*YRawAcc = (int16_t)((tmp[3] << 8) | tmp[2]);
+	*ZRawAcc = (int16_t)((tmp[5] << 8) | tmp[4]);
+	return WE_SUCCESS;
+}
+
 /*ITDS_T_OUT_REG*/
 /**
 * @brief  Read the 8 bit Temperature
@@ -2849,6 +2870,19 @@ int8_t ITDS_getSleepChangeState(ITDS_state_t *sleep)
 	return WE_SUCCESS;
 }
 
+/**
+* @brief  Read all interrupt event flags in a single transfer
+* @param  Pointer to the interrupt events (latched events are cleared by the read)
+* @retval Error code
+*/
+int8_t ITDS_getAllInterruptEvents(ITDS_all_int_event_t *events)
+{
+	if (WE_FAIL == ReadReg((uint8_t)ITDS_ALL_INT_EVENT_REG, 1, (uint8_t *)events))
+	return WE_FAIL;
+
+	return WE_SUCCESS;
+}
+
 /* X_Y_Z_OFS_USR */
 
 /**
@@ -750,6 +750,7 @@ extern "C"
 	int8_t ITDS_getRawAccelerationX(int16_t *XRawAcc);
 	int8_t ITDS_getRawAccelerationY(int16_t *YRawAcc);
 	int8_t ITDS_getRawAccelerationZ(int16_t *ZRawAcc);
+	int8_t ITDS_getRawAccelerations(int16_t *XRawAcc, int16_t *YRawAcc, int16_t *ZRawAcc);
 
 	/* Temperature output */
 	int8_t ITDS_getTemperature8bit(uint8_t *temp8bit);
@@ -853,6 +854,7 @@ extern "C"
 
 	/* ALL_INT_EVENT */
 	int8_t ITDS_getSleepChangeState(ITDS_state_t *sleep);
+	int8_t ITDS_getAllInterruptEvents(ITDS_all_int_event_t *events);
 
 	/* X_Y_Z_OFS_USR */
 	int8_t ITDS_setOffsetValueOnXAxis(uint8_t offsetvalueXAxis);
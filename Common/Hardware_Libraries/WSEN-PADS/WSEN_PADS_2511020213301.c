@@ -1497,6 +1497,36 @@ int8_t PADS_getTemperature(float *tempdegC)
 	return WE_SUCCESS;
 }
 
+/**
+* @brief  Read the measured pressure value in Pa without floating point operations
+* @param  pointer to Pressure Measurement
+* @retval Error code
+*/
+int8_t PADS_getPressure_int(int32_t *pressPa)
+{
+	int32_t rawPressure = 0;
+	if(PADS_getRAWPressure(&rawPressure) == WE_SUCCESS)
+	{
+		/* 40960 LSB/kPa -> Pa = raw * 1000 / 40960 = raw * 25 / 1024, rounded */
+		*pressPa = (rawPressure * 25 + 512) >> 10;
+	}
+	else
+	{
+		return WE_FAIL;
+	}
+	return WE_SUCCESS;
+}
+
+/**
+* @brief  Read the measured temperature value in 0.01 °C
+* @param  Pointer to Temperature Measurement
+* @retval Error code
+*/
+int8_t PADS_getTemperature_int(int16_t *temp)
+{
+	return PADS_getRAWTemperature(temp);
+}
+
 /**
 * @brief  Read the raw pressure value from Fifo
 * @param  Pointer to Fifo Pressure Measurement
@@ -1554,6 +1584,48 @@ int8_t PADS_getFifoRAWTemperature(int16_t *rawTemp)
 	return WE_SUCCESS;
 }
 
+/**
+* @brief  Read several pressure and temperature samples from Fifo in one transfer
+* @param  Number of samples to read (max PADS_FIFO_MAX_BURST)
+* @param  Pointer to the raw pressure values
+* @param  Pointer to the raw temperature values
+* @retval Error code
+*/
+int8_t PADS_getFifoRAWValues(uint8_t numSamples, int32_t *rawPres, int16_t *rawTemp)
+{
+	uint8_t tmp[PADS_FIFO_MAX_BURST * PADS_FIFO_SAMPLE_SIZE];
+
+	if (numSamples > PADS_FIFO_MAX_BURST)
+	return WE_FAIL;
+
+	/* With auto increment the address rolls back from T_H to P_XL after each sample */
+	if (WE_FAIL == ReadReg((uint8_t)PADS_FIFO_DATA_P_XL_REG, numSamples * PADS_FIFO_SAMPLE_SIZE, tmp))
+	return WE_FAIL;
+
+	PADS_decodeFifoRAWValues(numSamples, tmp, rawPres, rawTemp);
+
+	return WE_SUCCESS;
+}
+
+/**
+* @brief  Decode Fifo samples read from PADS_FIFO_DATA_P_XL_REG with auto increment
+* @param  Number of samples
+* @param  Pointer to the bytes read, PADS_FIFO_SAMPLE_SIZE per sample
+* @param  Pointer to the raw pressure values
+* @param  Pointer to the raw temperature values
+* @retval none
+*/
+void PADS_decodeFifoRAWValues(uint8_t numSamples, const uint8_t *fifoData, int32_t *rawPres, int16_t *rawTemp)
+{
+	for (uint8_t i = 0; i < numSamples; i++)
+	{
+		const uint8_t *sample = &fifoData[i * PADS_FIFO_SAMPLE_SIZE];
+
+		rawPres[i] = (int32_t)(((uint32_t)sample[2] << 16) | ((uint32_t)sample[1] << 8) | sample[0]);
+		rawTemp[i] = (int16_t)((sample[4] << 8) | sample[3]);
+	}
+}
+
 /**
 * @brief  Read the temperature value from fifo in °C
 * @param  Pointer to Fifo Temperature Measurement
@@ -71,6 +71,12 @@
 #define PADS_FIFO_DATA_T_L_REG (uint8_t)0x7B  /* Temperature LSB data in FIFO buffer */
 #define PADS_FIFO_DATA_T_H_REG (uint8_t)0x7C  /* Temperature MSB data in FIFO buffer */
 
+/**         FIFO         */
+
+#define PADS_FIFO_SIZE 128		 /* Number of pressure and temperature samples in FIFO */
+#define PADS_FIFO_SAMPLE_SIZE 5	 /* Bytes per FIFO sample, P_XL to T_H */
+#define PADS_FIFO_MAX_BURST 32	 /* Maximum samples per burst read, limited by the I2C buffer */
+
 /**         Register type definitions         */
 
 /**
@@ -483,12 +489,16 @@ extern "C"
 	int8_t PADS_getRAWTemperature(int16_t *rawTemp);
 	int8_t PADS_getPressure(float *presskPa);	 // Pressure Value in kPa
 	int8_t PADS_getTemperature(float *tempdegC); // Temperature Value in °C
+	int8_t PADS_getPressure_int(int32_t *pressPa);	 // Pressure Value in Pa
+	int8_t PADS_getTemperature_int(int16_t *temp);	 // Temperature Value in 0.01 °C
 
 	/*Fifo Data Out */
 	int8_t PADS_getFifoRAWTemperature(int16_t *rawTemp);
 	int8_t PADS_getFifoRAWPressure(int32_t *rawPres);
 	int8_t PADS_getFifoTemperature(float *tempdegC); // Temperature Value in °C
 	int8_t PADS_getFifoPressure(float *presskPa);	 // Pressure Value in kPa
+	int8_t PADS_getFifoRAWValues(uint8_t numSamples, int32_t *rawPres, int16_t *rawTemp);
+	void PADS_decodeFifoRAWValues(uint8_t numSamples, const uint8_t *fifoData, int32_t *rawPres, int16_t *rawTemp);
 
 #ifdef __cplusplus
 }
@@ -341,6 +341,17 @@ int8_t TIDS_getTemperature(float *tempdegC)
 	return WE_SUCCESS;
 }
 
+/**
+* @brief  Read the measured temperature value in 0.01 °C
+* @param  Pointer to Temperature Measurement
+* @retval Error code
+*/
+int8_t TIDS_getTemperature_int(int16_t *temp)
+{
+	/* The sensor output is already scaled in 0.01 °C */
+	return TIDS_getRAWTemperature(temp);
+}
+
 /**
 * @brief  Set temperature high limit
 * @param  High limit
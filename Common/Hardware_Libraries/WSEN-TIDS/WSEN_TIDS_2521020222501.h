@@ -169,6 +169,7 @@ extern "C"
 	/* standard Data Out */
 	int8_t TIDS_getRAWTemperature(int16_t *rawTemp);
 	int8_t TIDS_getTemperature(float *tempdegC); // Temperature Value in °C
+	int8_t TIDS_getTemperature_int(int16_t *temp); // Temperature Value in 0.01 °C
 
 #ifdef __cplusplus
 }
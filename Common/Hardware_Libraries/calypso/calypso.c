@@ -895,7 +895,7 @@ bool ATMQTT_addArgumentsSubscribe(char *pAtCommand, uint8_t index, uint8_t numOf
  * @RetVal true if arguments were added successful
  * false otherwise
  */
-bool ATFile_AddArgumentsFileOpen(char *pAtCommand, const char *fileName, uint32_t options, uint16_t fileSize)
+bool ATFile_AddArgumentsFileOpen(char *pAtCommand, const char *fileName, uint32_t options, uint32_t fileSize)
 {
     bool ret = false;
 
@@ -1025,7 +1025,7 @@ bool ATFile_AddArgumentsFileDel(char *pAtCommand, const char *fileName, uint32_t
  * @RetVal true if arguments were added successful
  * false otherwise
  */
-bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint16_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead)
+bool ATFile_AddArgumentsFileRead(char *pAtCommand, uint32_t fileID, uint32_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead)
 {
     bool ret = false;
 
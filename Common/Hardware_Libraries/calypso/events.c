@@ -124,6 +124,7 @@ static bool ATEvent_parseEventSocket(const char *eventSocketString, ATEvent_t *p
 static bool ATEvent_parseEventNetapp(const char *eventNetappString, ATEvent_t *pOutEvent);
 static bool ATEvent_parseEventMQTT(const char *eventMQTTString, ATEvent_t *pOutEvent);
 static bool ATEvent_parseEventFatalError(const char *eventFatalErrorString, ATEvent_t *pOutEvent);
+static bool ATEvent_getEventOption(char **pAtCommand, char *pOption);
 /*
  * Static Functions.
  * ########################## */
@@ -140,6 +141,23 @@ static bool ATEvent_parseEventFatalError(const char *eventFatalErrorString, ATEv
  * Exported Functions:
  */
 
+/**@brief Gets the event option, followed by arguments or alone as in
+ * "+eventmqtt:disconnect"
+ *
+ * -   pAtCommand  event arguments, moved past the option
+ * @param[out]  pOption     option string
+ *
+ * return true if parsed succesful, false otherwise
+ */
+static bool ATEvent_getEventOption(char **pAtCommand, char *pOption)
+{
+    if (Calypso_getNextArgumentString(pAtCommand, pOption, ARGUMENT_DELIM))
+    {
+        return true;
+    }
+    return Calypso_getNextArgumentString(pAtCommand, pOption, STRING_TERMINATE);
+}
+
 /**@brief Parses the command and returns the respective ATEvent_t
  *
  * -   pAtCommand  AT command starting with '+'
@@ -159,7 +177,7 @@ bool ATEvent_parseEventName(char **pAtCommand, ATEvent_t *pEvent)
     {
         if (0 == strcasecmp(cmdName, "+eventgeneral"))
         {
-            ret = Calypso_getNextArgumentString(pAtCommand, option, ARGUMENT_DELIM);
+            ret = ATEvent_getEventOption(pAtCommand, option);
             if (ret)
             {
                 ATEvent_parseEventGeneral(option, pEvent);
@@ -167,7 +185,7 @@ bool ATEvent_parseEventName(char **pAtCommand, ATEvent_t *pEvent)
         }
         else if (0 == strcasecmp(cmdName, "+eventwlan"))
         {
-            ret = Calypso_getNextArgumentString(pAtCommand, option, ARGUMENT_DELIM);
+            ret = ATEvent_getEventOption(pAtCommand, option);
             if (ret)
             {
                 ATEvent_parseEventWlan(option, pEvent);
@@ -175,7 +193,7 @@ bool ATEvent_parseEventName(char **pAtCommand, ATEvent_t *pEvent)
         }
         else if (0 == strcasecmp(cmdName, "+eventsock"))
         {
-            ret = Calypso_getNextArgumentString(pAtCommand, option, ARGUMENT_DELIM);
+            ret = ATEvent_getEventOption(pAtCommand, option);
             if (ret)
             {
                 ATEvent_parseEventSocket(option, pEvent);
@@ -184,7 +202,7 @@ bool ATEvent_parseEventName(char **pAtCommand, ATEvent_t *pEvent)
 
         else if (0 == strcasecmp(cmdName, "+eventnetapp"))
         {
-            ret = Calypso_getNextArgumentString(pAtCommand, option, ARGUMENT_DELIM);
+            ret = ATEvent_getEventOption(pAtCommand, option);
             if (ret)
             {
                 ATEvent_parseEventNetapp(option, pEvent);
@@ -193,7 +211,7 @@ bool ATEvent_parseEventName(char **pAtCommand, ATEvent_t *pEvent)
 
         else if (0 == strcasecmp(cmdName, "+eventmqtt"))
         {
-            ret = Calypso_getNextArgumentString(pAtCommand, option, ARGUMENT_DELIM);
+            ret = ATEvent_getEventOption(pAtCommand, option);
             if (ret)
             {
                 ATEvent_parseEventMQTT(option, pEvent);
@@ -202,7 +220,7 @@ bool ATEvent_parseEventName(char **pAtCommand, ATEvent_t *pEvent)
 
         else if (0 == strcasecmp(cmdName, "+eventfatalerror"))
         {
-            ret = Calypso_getNextArgumentString(pAtCommand, option, ARGUMENT_DELIM);
+            ret = ATEvent_getEventOption(pAtCommand, option);
             if (ret)
             {
                 ATEvent_parseEventFatalError(option, pEvent);
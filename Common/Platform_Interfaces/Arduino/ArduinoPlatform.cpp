@@ -47,7 +47,24 @@ Adafruit_NeoPixel pixels(1 /* LED_COUNT - 1 in case of feather m0 */,
 uint32_t NeoPixelColor;
 int deviceAddress = 0; // device Address
 
-Adafruit_SH1107 display(64, 128, &Wire);
+/* The wake-up alarm of the software timers is the compare of the RTC, in
+ * 32-bit counter mode on GCLK2 from the 32 kHz oscillator. Both are set to
+ * run in standby, where GCLK0, TC3 and SysTick stop. The counter runs
+ * freely, it measures the standby for millis() too. */
+#define WAKEUP_GCLK 2
+#define WAKEUP_RTC_HZ 1024 /* 32768 Hz / 2^(4 + 1) */
+#define WAKEUP_MAX_MS 86400000UL
+#define WAKEUP_MIN_TICKS 2 /* The compare must be ahead of the count sync */
+/* The external interrupts, the buttons and the ITDS, see their edges in
+ * standby on this generator from the same oscillator, undivided. GCLK4 is
+ * not used by the core. */
+#define WAKEUP_EIC_GCLK 4
+
+static bool wakeupReady = false;
+static bool wakeupEicReady = false;
+/* Standby measured by the RTC and the part of it reported in ms */
+static uint64_t stoppedTicks = 0;
+static uint64_t stoppedMs = 0;
 
 /**
  * @brief  Software reset for the MCU
@@ -440,6 +457,333 @@ int HSerial_read(TypeHardwareSerial *m)
   return obj->read();
 }
 
+/***************************I2C ENGINE***************************/
+
+/* SERCOM behind Wire on the Feather M0 (PERIPH_WIRE / WIRE_IT_HANDLER) */
+#define I2C_SERCOM SERCOM3
+#define I2C_SERCOM_IRQn SERCOM3_IRQn
+#define I2C_INTERRUPTS (SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_SB | SERCOM_I2CM_INTENSET_ERROR)
+
+#define I2C_CMD_READ 0x2
+#define I2C_CMD_STOP 0x3
+
+typedef enum
+{
+  i2cPhaseRegister,    /* Address sent, register byte next */
+  i2cPhaseRestart,     /* Register byte sent, repeated start next */
+  i2cPhaseWrite,       /* Data bytes being written */
+  i2cPhaseRead         /* Data bytes being read */
+} I2CPhase_t;
+
+/* Queue of pending transfers, the head is on the bus */
+static I2CTransfer_t *volatile i2cQueueHead = NULL;
+static I2CTransfer_t *volatile i2cQueueTail = NULL;
+/* Completed transfers waiting for their callback */
+static I2CTransfer_t *volatile i2cDoneHead = NULL;
+static I2CTransfer_t *volatile i2cDoneTail = NULL;
+static volatile I2CPhase_t i2cPhase;
+static volatile uint16_t i2cIndex;
+static volatile unsigned long i2cTransferStart;
+
+/* Vector table copied to RAM, Wire owns the SERCOM3_Handler symbol */
+static DeviceVectors i2cVectors __attribute__((aligned(256)));
+
+static inline void I2CSync()
+{
+  while (I2C_SERCOM->I2CM.SYNCBUSY.bit.SYSOP)
+    ;
+}
+
+static inline void I2CCommand(uint8_t command)
+{
+  I2C_SERCOM->I2CM.CTRLB.bit.CMD = command;
+  I2CSync();
+}
+
+/**
+ * @brief  Put the head transfer on the bus. Called with the I2C interrupt
+ *         masked or from the interrupt handler.
+ * @retval none
+ */
+static void I2CStartHead()
+{
+  I2CTransfer_t *transfer = i2cQueueHead;
+  bool read = (transfer->type == i2cTransferReceive);
+
+  i2cIndex = 0;
+  i2cTransferStart = millis();
+  if (transfer->type == i2cTransferWrite || transfer->type == i2cTransferRead)
+  {
+    i2cPhase = i2cPhaseRegister;
+  }
+  else
+  {
+    i2cPhase = read ? i2cPhaseRead : i2cPhaseWrite;
+  }
+  I2C_SERCOM->I2CM.CTRLB.bit.ACKACT = 0;
+  I2CSync();
+  I2C_SERCOM->I2CM.INTENSET.reg = I2C_INTERRUPTS;
+  I2C_SERCOM->I2CM.ADDR.reg = SERCOM_I2CM_ADDR_ADDR((transfer->address << 1) | (read ? 1 : 0));
+  I2CSync();
+}
+
+/**
+ * @brief  Move the head transfer to the completed list and start the next
+ *         one. Called with the I2C interrupt masked or from the handler.
+ * @param  status result of the transfer
+ * @retval none
+ */
+static void I2CComplete(int8_t status)
+{
+  I2CTransfer_t *transfer = i2cQueueHead;
+
+  I2C_SERCOM->I2CM.INTENCLR.reg = I2C_INTERRUPTS;
+  i2cQueueHead = transfer->next;
+  if (i2cQueueHead == NULL)
+  {
+    i2cQueueTail = NULL;
+  }
+
+  transfer->next = NULL;
+  transfer->status = status;
+  if (i2cDoneTail == NULL)
+  {
+    i2cDoneHead = transfer;
+  }
+  else
+  {
+    i2cDoneTail->next = transfer;
+  }
+  i2cDoneTail = transfer;
+
+  if (i2cQueueHead != NULL)
+  {
+    I2CStartHead();
+  }
+}
+
+/**
+ * @brief  SERCOM interrupt: master on bus (MB) after each written byte,
+ *         slave on bus (SB) after each received byte
+ * @retval none
+ */
+static void I2CInterruptHandler()
+{
+  SercomI2cm *i2c = &I2C_SERCOM->I2CM;
+  I2CTransfer_t *transfer = i2cQueueHead;
+  uint8_t flags = i2c->INTFLAG.reg;
+  uint16_t status = i2c->STATUS.reg;
+
+  if (transfer == NULL)
+  {
+    i2c->INTENCLR.reg = I2C_INTERRUPTS;
+    i2c->INTFLAG.reg = flags;
+    return;
+  }
+
+  if ((flags & SERCOM_I2CM_INTFLAG_ERROR) || (status & (SERCOM_I2CM_STATUS_BUSERR | SERCOM_I2CM_STATUS_ARBLOST)) ||
+      ((flags & SERCOM_I2CM_INTFLAG_MB) && (status & SERCOM_I2CM_STATUS_RXNACK)))
+  {
+    /* Address or data not acknowledged, or bus error */
+    i2c->INTFLAG.reg = SERCOM_I2CM_INTFLAG_ERROR;
+    I2CCommand(I2C_CMD_STOP);
+    I2CComplete(WE_FAIL);
+    return;
+  }
+
+  if (flags & SERCOM_I2CM_INTFLAG_MB)
+  {
+    switch (i2cPhase)
+    {
+    case i2cPhaseRegister:
+      i2cPhase = (transfer->type == i2cTransferRead) ? i2cPhaseRestart : i2cPhaseWrite;
+      i2c->DATA.reg = transfer->regAdr;
+      I2CSync();
+      return;
+    case i2cPhaseRestart:
+      i2cPhase = i2cPhaseRead;
+      i2c->ADDR.reg = SERCOM_I2CM_ADDR_ADDR((transfer->address << 1) | 1);
+      I2CSync();
+      return;
+    case i2cPhaseWrite:
+      if (i2cIndex < transfer->length)
+      {
+        i2c->DATA.reg = transfer->data[i2cIndex++];
+        I2CSync();
+        return;
+      }
+      I2CCommand(I2C_CMD_STOP);
+      I2CComplete(WE_SUCCESS);
+      return;
+    default:
+      break;
+    }
+  }
+
+  if (flags & SERCOM_I2CM_INTFLAG_SB)
+  {
+    if (i2cIndex + 1 >= transfer->length)
+    {
+      /* NACK the last byte and stop before DATA is read, so that smart
+         mode does not clock in another byte */
+      i2c->CTRLB.bit.ACKACT = 1;
+      I2CSync();
+      I2CCommand(I2C_CMD_STOP);
+      transfer->data[i2cIndex++] = i2c->DATA.reg;
+      I2CComplete(WE_SUCCESS);
+    }
+    else
+    {
+      /* Smart mode acknowledges and reads the next byte when DATA is read */
+      transfer->data[i2cIndex++] = i2c->DATA.reg;
+    }
+  }
+}
+
+/**
+ * @brief  Route the SERCOM interrupt to the I2C engine
+ * @retval none
+ */
+static void I2CInstallHandler()
+{
+  if (SCB->VTOR != (uint32_t)&i2cVectors)
+  {
+    __disable_irq();
+    memcpy(&i2cVectors, (const void *)SCB->VTOR, sizeof(i2cVectors));
+    i2cVectors.pfnSERCOM3_Handler = (void *)I2CInterruptHandler;
+    SCB->VTOR = (uint32_t)&i2cVectors;
+    __DSB();
+    __enable_irq();
+  }
+  NVIC_ClearPendingIRQ(I2C_SERCOM_IRQn);
+  NVIC_EnableIRQ(I2C_SERCOM_IRQn);
+}
+
+/**
+ * @brief  Queue a transfer. The bytes are moved by the SERCOM interrupt
+ *         while the main loop keeps running, the callback is called from
+ *         I2CPoll.
+ * @param  transfer descriptor, owned by the I2C engine until completion
+ * @retval Error Code
+ */
+int8_t I2CSubmit(I2CTransfer_t *transfer)
+{
+  if (transfer == NULL || (transfer->length == 0 && transfer->type != i2cTransferWrite && transfer->type != i2cTransferSend))
+  {
+    return WE_FAIL;
+  }
+  transfer->next = NULL;
+  transfer->status = I2C_TRANSFER_PENDING;
+
+  NVIC_DisableIRQ(I2C_SERCOM_IRQn);
+  if (i2cQueueTail == NULL)
+  {
+    i2cQueueHead = transfer;
+    i2cQueueTail = transfer;
+    I2CStartHead();
+  }
+  else
+  {
+    i2cQueueTail->next = transfer;
+    i2cQueueTail = transfer;
+  }
+  NVIC_EnableIRQ(I2C_SERCOM_IRQn);
+  return WE_SUCCESS;
+}
+
+/**
+ * @brief  Abort a stuck transfer and call the callbacks of the completed
+ *         ones, to be called from the main loop
+ * @retval none
+ */
+void I2CPoll()
+{
+  NVIC_DisableIRQ(I2C_SERCOM_IRQn);
+  if (i2cQueueHead != NULL && millis() - i2cTransferStart > TIMEOUT)
+  {
+    I2CCommand(I2C_CMD_STOP);
+    I2CComplete(WE_FAIL);
+  }
+  NVIC_EnableIRQ(I2C_SERCOM_IRQn);
+
+  for (;;)
+  {
+    I2CTransfer_t *transfer;
+
+    NVIC_DisableIRQ(I2C_SERCOM_IRQn);
+    transfer = i2cDoneHead;
+    if (transfer != NULL)
+    {
+      i2cDoneHead = transfer->next;
+      if (i2cDoneHead == NULL)
+      {
+        i2cDoneTail = NULL;
+      }
+    }
+    NVIC_EnableIRQ(I2C_SERCOM_IRQn);
+
+    if (transfer == NULL)
+    {
+      break;
+    }
+    if (transfer->callback != NULL)
+    {
+      transfer->callback(transfer);
+    }
+  }
+}
+
+/**
+ * @brief  Check if no transfer is queued
+ * @retval true if idle
+ */
+bool I2CIsIdle() { return i2cQueueHead == NULL; }
+
+/**
+ * @brief  Wait for the completion of a transfer
+ * @param  transfer queued transfer
+ * @retval Error Code of the transfer
+ */
+int8_t I2CWait(I2CTransfer_t *transfer)
+{
+  while (transfer->status == I2C_TRANSFER_PENDING)
+  {
+    I2CPoll();
+  }
+  return transfer->status;
+}
+
+/**
+ * @brief  Wait until all queued transfers are completed
+ * @retval none
+ */
+void I2CWaitIdle()
+{
+  while (!I2CIsIdle())
+  {
+    I2CPoll();
+  }
+}
+
+/**
+ * @brief  Queue a transfer to the current device address and wait for it
+ * @param  type transfer type
+ * @param  regAdr register address
+ * @param  data data buffer
+ * @param  length data length
+ * @retval Error Code
+ */
+static int8_t I2CTransferBlocking(I2CTransferType_t type, uint8_t regAdr, uint8_t *data, int length)
+{
+  I2CTransfer_t transfer = {NULL, type, (uint8_t)deviceAddress, regAdr, data, (uint16_t)length, NULL, NULL, I2C_TRANSFER_PENDING};
+
+  if (I2CSubmit(&transfer) != WE_SUCCESS)
+  {
+    return WE_FAIL;
+  }
+  return I2CWait(&transfer);
+}
+
 /**
  * @brief  Initialize the I2C Interface
  * @param  I2C address
@@ -447,9 +791,11 @@ int HSerial_read(TypeHardwareSerial *m)
  */
 int8_t I2CInit(int address)
 {
+  I2CWaitIdle();
   deviceAddress = address;
   Wire.begin();
   Wire.setClock(I2C_CLOCK_SPEED_FAST);
+  I2CInstallHandler();
   return WE_SUCCESS;
 }
 
@@ -458,7 +804,11 @@ int8_t I2CInit(int address)
  * @param  clock values accepted Standard - 100000, Fast - 400000
  * @retval Error Code
  */
-void I2CSetClock(uint32_t baudrate) { Wire.setClock(baudrate); }
+void I2CSetClock(uint32_t baudrate)
+{
+  I2CWaitIdle();
+  Wire.setClock(baudrate);
+}
 /**
  * @brief  Set I2C bus Address
  * @param  I2C address
@@ -474,17 +824,7 @@ void I2CSetAddress(int address) { deviceAddress = address; }
  */
 int8_t I2CSend(uint8_t *data, int datalen)
 {
-  Wire.beginTransmission(deviceAddress);
-
-  if (datalen != 0)
-  {
-    Wire.write(data, datalen);
-  }
-  if (Wire.endTransmission() != 0)
-  {
-    return WE_FAIL;
-  }
-  return WE_SUCCESS;
+  return I2CTransferBlocking(i2cTransferSend, 0, data, datalen);
 }
 /**
  * @brief  Receive data over I2C bus
@@ -494,17 +834,7 @@ int8_t I2CSend(uint8_t *data, int datalen)
  */
 int8_t I2CReceive(uint8_t *data, int datalen)
 {
-  int bytesAvailable =
-      Wire.requestFrom(deviceAddress, datalen); // request Bytes
-  if (bytesAvailable == 0)
-  {
-    return WE_FAIL;
-  }
-  for (int index = 0; index < bytesAvailable; index++)
-  {
-    data[index] = Wire.read();
-  }
-  return WE_SUCCESS;
+  return I2CTransferBlocking(i2cTransferReceive, 0, data, datalen);
 }
 
 /**
@@ -516,18 +846,7 @@ int8_t I2CReceive(uint8_t *data, int datalen)
  */
 int8_t ReadReg(uint8_t RegAdr, int NumByteToRead, uint8_t *Data)
 {
-  Wire.beginTransmission(deviceAddress); // set sensor target
-  Wire.write(RegAdr);                    // set memory pointer
-  unsigned long start = millis();
-  while (Wire.endTransmission() && millis() - start <= TIMEOUT)
-    ;
-  int n = Wire.requestFrom(deviceAddress, NumByteToRead); // request Bytes
-  for (int i = 0; i < n; i++)
-  {
-    Data[i] = Wire.read();
-  }
-
-  return WE_SUCCESS;
+  return I2CTransferBlocking(i2cTransferRead, RegAdr, Data, NumByteToRead);
 }
 
 /**
@@ -539,15 +858,7 @@ int8_t ReadReg(uint8_t RegAdr, int NumByteToRead, uint8_t *Data)
  */
 int8_t WriteReg(int RegAdr, int NumByteToWrite, uint8_t *Data)
 {
-  Wire.beginTransmission(deviceAddress);
-  Wire.write(RegAdr);
-  Wire.write(*Data);
-  if (Wire.endTransmission())
-  {
-    return WE_FAIL;
-  }
-
-  return WE_SUCCESS;
+  return I2CTransferBlocking(i2cTransferWrite, (uint8_t)RegAdr, Data, NumByteToWrite);
 }
 
 /**
@@ -633,6 +944,23 @@ void buttonUpdate()
   }
 }
 
+/**
+ * @brief  Check if a button is held down. Its long press is timed by
+ *         buttonUpdate, standby would only see the release.
+ * @retval true if a button is pressed
+ */
+bool buttonIsPressed()
+{
+  for (uint8_t i = 0; i < BUTTONS; i++)
+  {
+    if ((buttons[i] != NULL) && buttons[i]->isPressed())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * @brief  Read the battery voltage
  * @retval voltage in V
@@ -653,30 +981,197 @@ float getBatteryVoltage()
  */
 void SH1107_Init()
 {
+  /* Only to power up the panel: the 1 KB buffer the library allocates in
+   * begin is freed when it goes out of scope, displayBoard keeps its own */
+  Adafruit_SH1107 display(64, 128, &Wire);
+
+  /* The display uses Wire directly, the queued transfers go first */
+  I2CWaitIdle();
   display.begin(0x3C, true);
 
-  // Clear the buffer.
+  // Clear the buffer, the text is then drawn by displayBoard over the I2C queue
   display.clearDisplay();
   display.display();
   display.setRotation(1);
 }
 
 /**
- * @brief  Display string on the SH1107
- * @param fontSize
- * @param cursorX
- * @param cursorY
- * @param text
- * @retval none
+ * @brief  Read the RTC counter
+ * @retval Ticks at WAKEUP_RTC_HZ
  */
-void SH1107_Display(uint8_t fontSize, uint8_t cursorX, uint8_t cursorY, const char *text)
+static uint32_t wakeupCount()
 {
-  display.clearDisplay();
-  display.display();
-  display.setTextSize(fontSize);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(cursorX, cursorY);
-  display.print(text);
-  display.display();
+  RTC->MODE0.READREQ.reg = RTC_READREQ_RREQ;
+  while (RTC->MODE0.STATUS.bit.SYNCBUSY)
+    ;
+  return RTC->MODE0.COUNT.reg;
+}
+
+/**
+ * @brief  RTC compare interrupt, it only ends the CPU sleep
+ * @retval None
+ */
+extern "C" void RTC_Handler()
+{
+  RTC->MODE0.INTENCLR.reg = RTC_MODE0_INTENCLR_CMP0;
+  RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+}
+
+/**
+ * @brief  Set up the RTC waking up the CPU for the software timers, from
+ *         the idle mode and from standby
+ * @retval true if successful else false
+ */
+bool wakeupAlarmInit()
+{
+  /* The 32 kHz oscillator the core set up for GCLK1 */
+#if defined(CRYSTALLESS)
+  SYSCTRL->OSC32K.bit.RUNSTDBY = 1;
+  uint32_t source = GCLK_GENCTRL_SRC_OSC32K;
+#else
+  SYSCTRL->XOSC32K.bit.RUNSTDBY = 1;
+  uint32_t source = GCLK_GENCTRL_SRC_XOSC32K;
+#endif
+
+  PM->APBAMASK.reg |= PM_APBAMASK_RTC;
+  GCLK->GENDIV.reg = GCLK_GENDIV_ID(WAKEUP_GCLK) | GCLK_GENDIV_DIV(4);
+  while (GCLK->STATUS.bit.SYNCBUSY)
+    ;
+  GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(WAKEUP_GCLK) | source | GCLK_GENCTRL_DIVSEL | GCLK_GENCTRL_RUNSTDBY |
+                      GCLK_GENCTRL_GENEN;
+  while (GCLK->STATUS.bit.SYNCBUSY)
+    ;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID(RTC_GCLK_ID) | GCLK_CLKCTRL_GEN(WAKEUP_GCLK) | GCLK_CLKCTRL_CLKEN;
+  while (GCLK->STATUS.bit.SYNCBUSY)
+    ;
+  GCLK->GENDIV.reg = GCLK_GENDIV_ID(WAKEUP_EIC_GCLK);
+  while (GCLK->STATUS.bit.SYNCBUSY)
+    ;
+  GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(WAKEUP_EIC_GCLK) | source | GCLK_GENCTRL_RUNSTDBY | GCLK_GENCTRL_GENEN;
+  while (GCLK->STATUS.bit.SYNCBUSY)
+    ;
+
+  RTC->MODE0.CTRL.reg = RTC_MODE0_CTRL_SWRST;
+  while (RTC->MODE0.CTRL.bit.SWRST || RTC->MODE0.STATUS.bit.SYNCBUSY)
+    ;
+  RTC->MODE0.CTRL.reg = RTC_MODE0_CTRL_MODE_COUNT32 | RTC_MODE0_CTRL_PRESCALER_DIV1;
+  while (RTC->MODE0.STATUS.bit.SYNCBUSY)
+    ;
+  RTC->MODE0.CTRL.reg |= RTC_MODE0_CTRL_ENABLE;
+  while (RTC->MODE0.STATUS.bit.SYNCBUSY)
+    ;
+
+  NVIC_ClearPendingIRQ(RTC_IRQn);
+  NVIC_EnableIRQ(RTC_IRQn);
+  wakeupReady = true;
+  return true;
+}
+
+/**
+ * @brief  Arm the wake-up alarm, the interrupt only ends the CPU sleep and
+ *         the expired timers are handled by the main loop. The alarm fires
+ *         at the earliest after delayMs, up to 2 ms later for a short one.
+ * @param  delayMs Time to the alarm
+ * @retval Time actually programmed in ms, at most WAKEUP_MAX_MS
+ */
+uint32_t wakeupAlarmSet(uint32_t delayMs)
+{
+  uint32_t ticks;
+
+  if (!wakeupReady)
+  {
+    return 0;
+  }
+  if (delayMs > WAKEUP_MAX_MS)
+  {
+    delayMs = WAKEUP_MAX_MS;
+  }
+  ticks = (uint32_t)(((uint64_t)delayMs * WAKEUP_RTC_HZ + 999) / 1000);
+  if (ticks < WAKEUP_MIN_TICKS)
+  {
+    ticks = WAKEUP_MIN_TICKS;
+  }
+
+  RTC->MODE0.INTENCLR.reg = RTC_MODE0_INTENCLR_CMP0;
+  RTC->MODE0.COMP[0].reg = wakeupCount() + ticks;
+  while (RTC->MODE0.STATUS.bit.SYNCBUSY)
+    ;
+  RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+  RTC->MODE0.INTENSET.reg = RTC_MODE0_INTENSET_CMP0;
+  return delayMs;
+}
+
+/**
+ * @brief  Let the external interrupts attached so far wake up from standby.
+ *         attachInterrupt clocks the EIC from GCLK0, which stops there, so
+ *         it is moved to the 32 kHz generator once the EIC is enabled.
+ * @retval None
+ */
+static void wakeupEicSet()
+{
+  if (!wakeupEicReady && EIC->CTRL.bit.ENABLE)
+  {
+    /* A generic clock is disabled before it is switched */
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID(EIC_GCLK_ID);
+    while (GCLK->CLKCTRL.bit.CLKEN)
+      ;
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID(EIC_GCLK_ID) | GCLK_CLKCTRL_GEN(WAKEUP_EIC_GCLK) | GCLK_CLKCTRL_CLKEN;
+    while (GCLK->STATUS.bit.SYNCBUSY)
+      ;
+    wakeupEicReady = true;
+  }
+  EIC->WAKEUP.reg = EIC->INTENSET.reg;
+}
+
+/**
+ * @brief  Stop the CPU until an interrupt. Call with the interrupts masked
+ *         to close the race with the check for pending work, a pending
+ *         interrupt still ends the sleep.
+ *         The idle mode only stops the CPU clock (IDLE0), the AHB clock is
+ *         needed by the USB debug port. SysTick wakes it every ms.
+ *         Standby stops GCLK0, so millis(), the UARTs and USB stop as well;
+ *         SysTick is masked and the wake-up alarm on the RTC and the
+ *         attached external interrupts end it. The UARTs do not wake it up:
+ *         the start-of-frame detection only receives the first byte if the
+ *         SERCOM clock is back within a bit, 1.1 us at the 921600 baud of
+ *         the Calypso, which has no flow control. Without the alarm set up,
+ *         standby falls back to the idle mode.
+ * @param  standby true for standby, false for idle
+ * @retval Time millis() was stopped in ms, to add to SysTime
+ */
+uint32_t cpuSleep(bool standby)
+{
+  uint32_t start = 0;
+  uint64_t totalMs;
+  uint32_t stopped;
+
+  standby = standby && wakeupReady;
+  if (standby)
+  {
+    wakeupEicSet();
+    start = wakeupCount();
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+  }
+  else
+  {
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    PM->SLEEP.reg = PM_SLEEP_IDLE_CPU;
+  }
+  __DSB();
+  __WFI();
+  if (!standby)
+  {
+    return 0;
+  }
+  SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+  SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+
+  /* Whole ms of the standby so far, the rest is kept for the next one */
+  stoppedTicks += (uint32_t)(wakeupCount() - start);
+  totalMs = stoppedTicks * 1000 / WAKEUP_RTC_HZ;
+  stopped = (uint32_t)(totalMs - stoppedMs);
+  stoppedMs = totalMs;
+  return stopped;
 }
 /**         EOF         */
\ No newline at end of file
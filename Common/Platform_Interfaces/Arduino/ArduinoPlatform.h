@@ -38,6 +38,7 @@
 #define MAX_PRINT_LEN 1280
 #define I2C_CLOCK_SPEED_FAST 400000
 #define I2C_CLOCK_SPEED_STANDARD 100000
+#define I2C_TRANSFER_PENDING (-1)
 
 #define V_BAT_PIN A7
 
@@ -97,6 +98,32 @@ extern "C"
     void HSerial_flush(TypeHardwareSerial *m);
     int HSerial_read(TypeHardwareSerial *m);
 
+    typedef enum
+    {
+        i2cTransferWrite,   /* Register address then data */
+        i2cTransferRead,    /* Register address, repeated start then data */
+        i2cTransferSend,    /* Data only */
+        i2cTransferReceive  /* Read without register address */
+    } I2CTransferType_t;
+
+    /**
+     * @brief Descriptor of a queued I2C transfer. It is owned by the I2C
+     * engine from I2CSubmit until its callback is called, the data buffer
+     * must stay valid for the same time.
+     */
+    typedef struct I2CTransfer
+    {
+        struct I2CTransfer *next;
+        I2CTransferType_t type;
+        uint8_t address;
+        uint8_t regAdr;
+        uint8_t *data;
+        uint16_t length;
+        void (*callback)(struct I2CTransfer *transfer); /* Called from I2CPoll, may be NULL */
+        void *context;
+        volatile int8_t status; /* I2C_TRANSFER_PENDING, then WE_SUCCESS or WE_FAIL */
+    } I2CTransfer_t;
+
     void I2CSetAddress(int address);
     int8_t I2CInit(int address);
     void I2CSetClock(uint32_t baudrate);
@@ -104,16 +131,25 @@ extern "C"
     int8_t WriteReg(int RegAdr, int NumByteToWrite, uint8_t *Data);
     int8_t I2CReceive(uint8_t *data, int datalen);
     int8_t I2CSend(uint8_t *data, int datalen);
+    int8_t I2CSubmit(I2CTransfer_t *transfer);
+    int8_t I2CWait(I2CTransfer_t *transfer);
+    void I2CWaitIdle();
+    bool I2CIsIdle();
+    void I2CPoll();
 
     void neopixelInit();
     void neopixelSet(uint32_t color);
 
     void buttonInit(uint8_t buttonId, uint8_t pin, void (*OnBtnPress)(), void (*OnBtnLongPress)());
     void buttonUpdate();
+    bool buttonIsPressed();
     float getBatteryVoltage();
 
     void SH1107_Init();
-    void SH1107_Display(uint8_t fontSize, uint8_t cursorX, uint8_t cursorY, const char *text);
+
+    bool wakeupAlarmInit();
+    uint32_t wakeupAlarmSet(uint32_t delayMs);
+    uint32_t cpuSleep(bool standby);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,60 @@
+/**
+ * \file
+ * \brief Entry point of the host build.
+ *
+ * Runs the Arduino style setup()/loop() application on a POSIX host.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "SensorSimulator.h"
+
+/* Provided by the application, e.g. GW/src/main.cpp */
+void setup();
+void loop();
+
+int main(int argc, char **argv)
+{
+  const char *trace = getenv("SENSOR_TRACE");
+
+  BasePlatform_setArgs(argc, argv);
+
+  /* The sensors are simulated on the I2C bus, fed from a CSV trace if given */
+  SensorSim_init();
+#ifdef ITDS_INT_PIN
+  SensorSim_setItdsIntPin(ITDS_INT_PIN);
+#endif
+  if (trace != NULL && !SensorSim_loadTrace(trace, true))
+  {
+    fprintf(stderr, "Cannot load sensor trace %s\n", trace);
+  }
+
+  setup();
+  for (;;)
+  {
+    loop();
+    /* Give the host CPU back between two passes of the main loop */
+    delayMicroseconds(100);
+  }
+  return 0;
+}
+/**         EOF         */
@@ -0,0 +1,1300 @@
+/**
+ * \file
+ * \brief POSIX host platform drivers.
+ *
+ * This code is the host (Linux) implementation of the platform abstraction
+ * used by the board and PnP layers.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#define _GNU_SOURCE
+#include <stdarg.h> // for printf
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "ConfigPlatform.h"
+
+#define BASE_PINS 64
+
+BaseSerial_t Serial = {"Serial", STDIN_FILENO, STDOUT_FILENO};
+BaseSerial_t Serial1 = {"Serial1", -1, -1};
+
+static int savedArgc = 0;
+static char **savedArgv = NULL;
+
+static struct timespec startTime;
+static bool startTimeSet = false;
+
+static uint8_t pinState[BASE_PINS];
+static void (*pinInterrupt[BASE_PINS])(void);
+
+static I2CBusModel_t busModel;
+int deviceAddress = 0; // device Address
+
+/* Queued transfers, the head is on the bus since i2cTransferStart */
+static I2CTransfer_t *i2cQueueHead = NULL;
+static I2CTransfer_t *i2cQueueTail = NULL;
+static uint64_t i2cTransferStart = 0;
+static uint32_t i2cClock = I2C_CLOCK_SPEED_STANDARD;
+
+static uint32_t NeoPixelColor = 0;
+static uint32_t neoPixelChanges = 0;
+
+static float batteryVoltage = 3.7f;
+static uint32_t wakeupAlarmMs = 0;
+static uint64_t wakeupAlarmDueUs = 0;
+static bool wakeupAlarmArmed = false;
+static uint64_t clockOffsetUs = 0;
+
+typedef struct
+{
+  void (*onPress)();
+  void (*onLongPress)();
+  bool pressPending;
+  bool longPressPending;
+} BaseButton_t;
+
+static BaseButton_t buttons[BUTTONS];
+
+/**
+ * @brief  Read the monotonic clock relative to the first call. The uptime
+ *         starts at the BASE_UPTIME_MS environment variable, if set, to run
+ *         into the 32-bit millis() and micros() wraps quickly.
+ * @retval Elapsed time in microseconds, does not wrap
+ */
+uint64_t BasePlatform_micros64(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (!startTimeSet)
+  {
+    const char *uptime = getenv("BASE_UPTIME_MS");
+
+    startTime = now;
+    startTimeSet = true;
+    if (uptime != NULL)
+    {
+      clockOffsetUs += strtoull(uptime, NULL, 0) * 1000ULL;
+    }
+  }
+  return (uint64_t)(now.tv_sec - startTime.tv_sec) * 1000000ULL +
+         (uint64_t)((now.tv_nsec - startTime.tv_nsec) / 1000) + clockOffsetUs;
+}
+
+/**
+ * @brief  Move the clock forward, as if the process had been idle
+ * @param  us Time to skip in microseconds
+ * @retval None
+ */
+void BasePlatform_advanceClock(uint64_t us) { clockOffsetUs += us; }
+
+/**
+ * @brief  Milliseconds since start, wrapping at 32 bit like on the target
+ * @retval Milliseconds
+ */
+unsigned long millis(void)
+{
+  return (unsigned long)(uint32_t)(BasePlatform_micros64() / 1000);
+}
+
+/**
+ * @brief  Microseconds since start, wrapping at 32 bit like on the target
+ * @retval Microseconds
+ */
+unsigned long micros(void)
+{
+  return (unsigned long)(uint32_t)BasePlatform_micros64();
+}
+
+/**
+ * @brief  Sleep for the given time
+ * @param  ms Time in milliseconds
+ * @retval none
+ */
+void delay(unsigned long ms)
+{
+  struct timespec request = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+
+  while (nanosleep(&request, &request) != 0 && errno == EINTR)
+    ;
+}
+
+/**
+ * @brief  Sleep for the given time
+ * @param  us Time in microseconds
+ * @retval none
+ */
+void delayMicroseconds(unsigned int us)
+{
+  struct timespec request = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000L};
+
+  while (nanosleep(&request, &request) != 0 && errno == EINTR)
+    ;
+}
+
+/**
+ * @brief  Configure a pin, pull-ups read back as high
+ * @param  pin Pin number
+ * @param  mode INPUT, OUTPUT or INPUT_PULLUP
+ * @retval none
+ */
+void pinMode(uint32_t pin, uint32_t mode)
+{
+  if (pin < BASE_PINS)
+  {
+    pinState[pin] = (mode == INPUT_PULLUP) ? HIGH : LOW;
+  }
+}
+
+/**
+ * @brief  Read the recorded pin level
+ * @param  pin Pin number
+ * @retval HIGH or LOW
+ */
+int digitalRead(uint32_t pin)
+{
+  return (pin < BASE_PINS) ? pinState[pin] : LOW;
+}
+
+/**
+ * @brief  Record a pin level
+ * @param  pin Pin number
+ * @param  value HIGH or LOW
+ * @retval none
+ */
+void digitalWrite(uint32_t pin, uint32_t value)
+{
+  if (pin < BASE_PINS)
+  {
+    pinState[pin] = (value != LOW) ? HIGH : LOW;
+  }
+}
+
+/**
+ * @brief  Register an interrupt handler for a pin
+ * @param  pin Pin number
+ * @param  callback Handler called by BasePlatform_triggerInterrupt
+ * @param  mode Edge, ignored on the host
+ * @retval none
+ */
+void attachInterrupt(uint32_t pin, void (*callback)(void), uint32_t mode)
+{
+  (void)mode;
+  if (pin < BASE_PINS)
+  {
+    pinInterrupt[pin] = callback;
+  }
+}
+
+/**
+ * @brief  Raise the interrupt of a pin, used by the host bus models
+ * @param  pin Pin number
+ * @retval none
+ */
+void BasePlatform_triggerInterrupt(uint32_t pin)
+{
+  if (pin < BASE_PINS && pinInterrupt[pin] != NULL)
+  {
+    pinInterrupt[pin]();
+  }
+}
+
+/**
+ * @brief  Store the program arguments so that soft_reset can restart it
+ * @param  argc Argument count
+ * @param  argv Argument vector
+ * @retval none
+ */
+void BasePlatform_setArgs(int argc, char **argv)
+{
+  savedArgc = argc;
+  savedArgv = argv;
+}
+
+/**
+ * @brief  Software reset, restarts the host process
+ * @retval none
+ */
+void soft_reset()
+{
+  fflush(stdout);
+  if (savedArgc > 0)
+  {
+    execv("/proc/self/exe", savedArgv);
+  }
+  exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief  Switch a file descriptor to non-blocking raw mode
+ * @param  fd File descriptor
+ * @retval none
+ */
+static void BaseSerial_makeRaw(int fd)
+{
+  struct termios tio;
+
+  if (tcgetattr(fd, &tio) == 0)
+  {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+/**
+ * @brief  Map a serial port to a new pseudo terminal. The slave side is
+ *         printed so that a module or a simulator can be attached to it.
+ * @param  serial Serial port
+ * @retval true if successful false in case of failure
+ */
+bool BaseSerial_openPty(BaseSerial_t *serial)
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  int slave;
+
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    return false;
+  }
+
+  /* Keep the slave open so that reads do not fail before a peer attaches */
+  slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave >= 0)
+  {
+    BaseSerial_makeRaw(slave);
+  }
+  BaseSerial_makeRaw(master);
+
+  serial->fdIn = master;
+  serial->fdOut = master;
+  fprintf(stderr, "%s mapped to %s\r\n", serial->name, ptsname(master));
+  return true;
+}
+
+/**
+ * @brief  Convert a baud rate to the termios speed
+ * @param  baud_count Baud rate
+ * @retval termios speed
+ */
+static speed_t BaseSerial_speed(uint32_t baud_count)
+{
+  switch (baud_count)
+  {
+  case 9600:
+    return B9600;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  case 921600:
+    return B921600;
+  default:
+    return B115200;
+  }
+}
+
+/**
+ * @brief  Map a serial port to a tty device, e.g. a USB serial adapter
+ * @param  serial Serial port
+ * @param  path Device path
+ * @param  baud_count Baud rate
+ * @retval true if successful false in case of failure
+ */
+bool BaseSerial_openTty(BaseSerial_t *serial, const char *path, uint32_t baud_count)
+{
+  struct termios tio;
+  int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+  if (fd < 0)
+  {
+    return false;
+  }
+  if (tcgetattr(fd, &tio) == 0)
+  {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, BaseSerial_speed(baud_count));
+    cfsetospeed(&tio, BaseSerial_speed(baud_count));
+    tio.c_cflag |= CLOCAL | CREAD | CRTSCTS;
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+
+  serial->fdIn = fd;
+  serial->fdOut = fd;
+  return true;
+}
+
+/**
+ * @brief  Map a serial port to a pair of in-memory pipes
+ * @param  serial Serial port
+ * @param  peerIn Returns the descriptor the peer reads the port output from
+ * @param  peerOut Returns the descriptor the peer writes the port input to
+ * @retval true if successful false in case of failure
+ */
+bool BaseSerial_openPipe(BaseSerial_t *serial, int *peerIn, int *peerOut)
+{
+  int toPort[2];
+  int fromPort[2];
+
+  if (pipe(toPort) != 0)
+  {
+    return false;
+  }
+  if (pipe(fromPort) != 0)
+  {
+    close(toPort[0]);
+    close(toPort[1]);
+    return false;
+  }
+  fcntl(toPort[0], F_SETFL, fcntl(toPort[0], F_GETFL) | O_NONBLOCK);
+
+  serial->fdIn = toPort[0];
+  serial->fdOut = fromPort[1];
+  *peerOut = toPort[1];
+  *peerIn = fromPort[0];
+  return true;
+}
+
+/**
+ * @brief  Close a serial port
+ * @param  serial Serial port
+ * @retval none
+ */
+void BaseSerial_close(BaseSerial_t *serial)
+{
+  if (serial->fdIn > STDERR_FILENO)
+  {
+    close(serial->fdIn);
+  }
+  if (serial->fdOut > STDERR_FILENO && serial->fdOut != serial->fdIn)
+  {
+    close(serial->fdOut);
+  }
+  serial->fdIn = -1;
+  serial->fdOut = -1;
+}
+
+/**
+ * @brief  Open a serial port if it is not mapped yet. The CALYPSO_TTY
+ *         environment variable selects a tty, otherwise a pty is created.
+ * @param  serial Serial port
+ * @param  baud_count Baud rate
+ * @retval none
+ */
+static void BaseSerial_begin(BaseSerial_t *serial, uint32_t baud_count)
+{
+  const char *path = getenv("CALYPSO_TTY");
+
+  if (serial->fdIn >= 0)
+  {
+    return;
+  }
+  if (path != NULL && BaseSerial_openTty(serial, path, baud_count))
+  {
+    return;
+  }
+  BaseSerial_openPty(serial);
+}
+
+/**
+ * @brief  Write to a serial port
+ * @param  serial Serial port
+ * @param  buffer Bytes to be written
+ * @param  size Number of bytes to write
+ * @retval Number of bytes written
+ */
+static size_t BaseSerial_write(BaseSerial_t *serial, const char *buffer, size_t size)
+{
+  size_t written = 0;
+
+  if (serial->fdOut < 0)
+  {
+    return 0;
+  }
+  while (written < size)
+  {
+    ssize_t n = write(serial->fdOut, buffer + written, size - written);
+    if (n > 0)
+    {
+      written += (size_t)n;
+    }
+    else if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    else
+    {
+      /* No peer attached or peer not reading, drop the rest */
+      break;
+    }
+  }
+  return written;
+}
+
+/**
+ * @brief  Number of bytes waiting on a serial port
+ * @param  serial Serial port
+ * @retval Number of bytes available
+ */
+static int BaseSerial_available(BaseSerial_t *serial)
+{
+  int count = 0;
+
+  if (serial->fdIn < 0 || ioctl(serial->fdIn, FIONREAD, &count) != 0)
+  {
+    return 0;
+  }
+  return count;
+}
+
+/**
+ * @brief  Read one byte from a serial port
+ * @param  serial Serial port
+ * @retval Byte read or -1 if none is available
+ */
+static int BaseSerial_read(BaseSerial_t *serial)
+{
+  uint8_t byte;
+
+  if (serial->fdIn < 0 || BaseSerial_available(serial) <= 0)
+  {
+    return -1;
+  }
+  if (read(serial->fdIn, &byte, 1) != 1)
+  {
+    return -1;
+  }
+  return byte;
+}
+
+/**
+ * @brief  Create a serial port object for handling strings and allocate memory
+ * @param  ser Pointer to serial object
+ * @retval Created serial port
+ */
+TypeSerial *SSerial_create(void *ser)
+{
+  TypeSerial *m;
+
+  m = (typeof(m))malloc(sizeof(*m));
+  m->obj = ser;
+
+  return m;
+}
+
+/**
+ * @brief  Free memory allocated to serial port
+ * @param  m Pointer to serial object
+ * @retval none
+ */
+void SSerial_destroy(TypeSerial *m)
+{
+  if (m == NULL)
+  {
+    return;
+  }
+
+  free(m);
+}
+
+/**
+ * @brief  Serial write byte
+ * @param  m Pointer to serial object
+ * @param  byte Byte to be written
+ * @retval Return 1 if the byte is successfully written
+ */
+size_t SSerial_write(TypeSerial *m, uint8_t byte)
+{
+  if (m == NULL)
+  {
+    return 0;
+  }
+
+  return BaseSerial_write((BaseSerial_t *)m->obj, (const char *)&byte, 1);
+}
+
+/**
+ * @brief  Serial write an array of chars
+ * @param  m Pointer to serial object
+ * @param  buffer Bytes to be written
+ * @param  size Number of bytes to write
+ * @retval Return the number of bytes successfully written
+ */
+size_t SSerial_writeB(TypeSerial *m, const char *buffer, size_t size)
+{
+  if (m == NULL)
+  {
+    return 0;
+  }
+
+  return BaseSerial_write((BaseSerial_t *)m->obj, buffer, size);
+}
+
+/**
+ * @brief  Serial begin, the debug port is already mapped to stdin/stdout
+ * @param  m Pointer to serial object
+ * @param  baud_count Baud rate
+ * @retval none
+ */
+void SSerial_begin(TypeSerial *m, uint32_t baud_count)
+{
+  if (m == NULL)
+  {
+    return;
+  }
+
+  BaseSerial_begin((BaseSerial_t *)m->obj, baud_count);
+}
+
+/**
+ * @brief  Serial begin
+ * @param  m Pointer to serial object
+ * @param  baud_count Baud rate
+ * @param  parameter Parameters parity, flowcontrol etc, ignored on the host
+ * @retval none
+ */
+void SSerial_beginP(TypeSerial *m, uint32_t baud_count, uint8_t parameter)
+{
+  (void)parameter;
+  SSerial_begin(m, baud_count);
+}
+
+/**
+ * @brief  Serial check availability
+ * @param  m Pointer to serial object
+ * @retval Number of bytes available
+ */
+int SSerial_available(TypeSerial *m)
+{
+  if (m == NULL)
+    return 0;
+
+  return BaseSerial_available((BaseSerial_t *)m->obj);
+}
+
+/**
+ * @brief  Serial flush
+ * @param  m Pointer to serial object
+ * @retval none
+ */
+void SSerial_flush(TypeSerial *m)
+{
+  BaseSerial_t *obj;
+
+  if (m == NULL)
+  {
+    return;
+  }
+
+  obj = (BaseSerial_t *)m->obj;
+  if (obj->fdOut >= 0 && isatty(obj->fdOut))
+  {
+    tcdrain(obj->fdOut);
+  }
+}
+
+/**
+ * @brief  Serial printf
+ * @param  m Pointer to serial object
+ * @param  format Formatted string with optional arguments
+ * @retval none
+ */
+void SSerial_printf(TypeSerial *m, const char format[], ...)
+{
+  char buf[MAX_PRINT_LEN];
+  va_list ap;
+  int len;
+
+  if (m == NULL)
+    return;
+
+  va_start(ap, format);
+  len = vsnprintf(buf, sizeof(buf), format, ap);
+  va_end(ap);
+
+  if (len > 0)
+  {
+    BaseSerial_write((BaseSerial_t *)m->obj, buf,
+                     (len < (int)sizeof(buf)) ? (size_t)len : sizeof(buf) - 1);
+  }
+}
+
+/**
+ * @brief  Serial read
+ * @param  m Pointer to serial object
+ * @retval Byte read or -1 if none is available
+ */
+int SSerial_read(TypeSerial *m)
+{
+  if (m == NULL)
+    return 0;
+
+  return BaseSerial_read((BaseSerial_t *)m->obj);
+}
+
+/**
+ * @brief  Create a serial port object for handling bytes and allocate memory
+ * @param  ser Pointer to serial object
+ * @retval Created serial port
+ */
+TypeHardwareSerial *HSerial_create(void *ser)
+{
+  TypeHardwareSerial *m;
+
+  m = (typeof(m))malloc(sizeof(*m));
+  m->obj = ser;
+
+  return m;
+}
+
+/**
+ * @brief  Free memory allocated to serial port
+ * @param  m Pointer to serial object
+ * @retval none
+ */
+void HSerial_destroy(TypeHardwareSerial *m)
+{
+  if (m == NULL)
+  {
+    return;
+  }
+
+  free(m);
+}
+
+/**
+ * @brief  Serial write byte
+ * @param  m Pointer to serial object
+ * @param  byte Byte to be written
+ * @retval Return 1 if the byte is successfully written
+ */
+size_t HSerial_write(TypeHardwareSerial *m, uint8_t byte)
+{
+  if (m == NULL)
+  {
+    return 0;
+  }
+
+  return BaseSerial_write((BaseSerial_t *)m->obj, (const char *)&byte, 1);
+}
+
+/**
+ * @brief  Serial write an array of chars
+ * @param  m Pointer to serial object
+ * @param  buffer Bytes to be written
+ * @param  size Number of bytes to write
+ * @retval Return the number of bytes successfully written
+ */
+size_t HSerial_writeB(TypeHardwareSerial *m, const char *buffer, size_t size)
+{
+  if (m == NULL)
+  {
+    return 0;
+  }
+
+  return BaseSerial_write((BaseSerial_t *)m->obj, buffer, size);
+}
+
+/**
+ * @brief  Serial begin, opens the tty or pty the port is mapped to
+ * @param  m Pointer to serial object
+ * @param  baud_count Baud rate
+ * @retval none
+ */
+void HSerial_begin(TypeHardwareSerial *m, uint32_t baud_count)
+{
+  if (m == NULL)
+  {
+    return;
+  }
+
+  BaseSerial_begin((BaseSerial_t *)m->obj, baud_count);
+}
+
+/**
+ * @brief  Serial begin
+ * @param  m Pointer to serial object
+ * @param  baud_count Baud rate
+ * @param  parameter Parameters parity, flowcontrol etc, ignored on the host
+ * @retval none
+ */
+void HSerial_beginP(TypeHardwareSerial *m, uint32_t baud_count,
+                    uint8_t parameter)
+{
+  (void)parameter;
+  HSerial_begin(m, baud_count);
+}
+
+/**
+ * @brief  Serial end
+ * @param  m Pointer to serial object
+ * @retval none
+ */
+void HSerial_end(TypeHardwareSerial *m)
+{
+  if (m == NULL)
+  {
+    return;
+  }
+
+  BaseSerial_close((BaseSerial_t *)m->obj);
+}
+
+/**
+ * @brief  Serial check availability
+ * @param  m Pointer to serial object
+ * @retval Number of bytes available
+ */
+int HSerial_available(TypeHardwareSerial *m)
+{
+  if (m == NULL)
+    return 0;
+
+  return BaseSerial_available((BaseSerial_t *)m->obj);
+}
+
+/**
+ * @brief  Serial check availability for write
+ * @param  m Pointer to serial object
+ * @retval Number of bytes that can be written without blocking
+ */
+int HSerial_availableForWrite(TypeHardwareSerial *m)
+{
+  if (m == NULL)
+    return 0;
+
+  return BASE_SERIAL_WRITE_BUFFER;
+}
+
+/**
+ * @brief  Serial flush
+ * @param  m Pointer to serial object
+ * @retval none
+ */
+void HSerial_flush(TypeHardwareSerial *m)
+{
+  BaseSerial_t *obj;
+
+  if (m == NULL)
+  {
+    return;
+  }
+
+  obj = (BaseSerial_t *)m->obj;
+  if (obj->fdOut >= 0 && isatty(obj->fdOut))
+  {
+    tcdrain(obj->fdOut);
+  }
+}
+
+/**
+ * @brief  Serial read
+ * @param  m Pointer to serial object
+ * @retval Byte read or -1 if none is available
+ */
+int HSerial_read(TypeHardwareSerial *m)
+{
+  if (m == NULL)
+    return 0;
+
+  return BaseSerial_read((BaseSerial_t *)m->obj);
+}
+
+/**
+ * @brief  Select the bus model handling the I2C transfers
+ * @param  model Bus model, copied. NULL detaches the current model.
+ * @retval none
+ */
+void I2CSetBusModel(const I2CBusModel_t *model)
+{
+  I2CWaitIdle();
+  if (model == NULL)
+  {
+    memset(&busModel, 0, sizeof(busModel));
+    return;
+  }
+  busModel = *model;
+}
+
+/**
+ * @brief  Initialize the I2C Interface
+ * @param  I2C address
+ * @retval Error Code
+ */
+int8_t I2CInit(int address)
+{
+  deviceAddress = address;
+  I2CSetClock(I2C_CLOCK_SPEED_FAST);
+  return WE_SUCCESS;
+}
+
+/**
+ * @brief  Set I2C clock
+ * @param  clock values accepted Standard - 100000, Fast - 400000
+ * @retval Error Code
+ */
+void I2CSetClock(uint32_t baudrate)
+{
+  I2CWaitIdle();
+  if (baudrate > 0)
+  {
+    i2cClock = baudrate;
+  }
+  if (busModel.setClock != NULL)
+  {
+    busModel.setClock(busModel.context, baudrate);
+  }
+}
+/**
+ * @brief  Set I2C bus Address
+ * @param  I2C address
+ * @retval None
+ */
+void I2CSetAddress(int address) { deviceAddress = address; }
+
+/**
+ * @brief  Run a transfer on the bus model
+ * @param  transfer transfer to run
+ * @retval Error Code
+ */
+static int8_t I2CExecute(I2CTransfer_t *transfer)
+{
+  switch (transfer->type)
+  {
+  case i2cTransferWrite:
+    if (busModel.writeReg != NULL)
+      return busModel.writeReg(busModel.context, transfer->address, transfer->regAdr, transfer->length, transfer->data);
+    break;
+  case i2cTransferRead:
+    if (busModel.readReg != NULL)
+      return busModel.readReg(busModel.context, transfer->address, transfer->regAdr, transfer->length, transfer->data);
+    break;
+  case i2cTransferSend:
+    if (busModel.send != NULL)
+      return busModel.send(busModel.context, transfer->address, transfer->data, transfer->length);
+    break;
+  case i2cTransferReceive:
+    if (busModel.receive != NULL)
+      return busModel.receive(busModel.context, transfer->address, transfer->data, transfer->length);
+    break;
+  }
+  return WE_FAIL;
+}
+
+/**
+ * @brief  Time the transfer takes on the bus, with the same cycle count as
+ *         the target: start, address, register, repeated start, 9 SCL per
+ *         byte and stop
+ * @param  transfer transfer
+ * @retval Duration in us
+ */
+static uint64_t I2CDuration(const I2CTransfer_t *transfer)
+{
+  uint64_t bits = 11 + 9 * (uint64_t)transfer->length;
+
+  if (transfer->type == i2cTransferWrite)
+  {
+    bits += 9;
+  }
+  else if (transfer->type == i2cTransferRead)
+  {
+    bits += 19;
+  }
+  return (bits * 1000000 + i2cClock - 1) / i2cClock;
+}
+
+/**
+ * @brief  Queue a transfer. It completes in the background after the time
+ *         it would take on the bus, its callback is called from I2CPoll.
+ * @param  transfer descriptor, owned by the I2C engine until completion
+ * @retval Error Code
+ */
+int8_t I2CSubmit(I2CTransfer_t *transfer)
+{
+  if (transfer == NULL || (transfer->length == 0 && transfer->type != i2cTransferWrite && transfer->type != i2cTransferSend))
+  {
+    return WE_FAIL;
+  }
+  transfer->next = NULL;
+  transfer->status = I2C_TRANSFER_PENDING;
+  if (i2cQueueTail == NULL)
+  {
+    i2cQueueHead = transfer;
+    i2cTransferStart = BasePlatform_micros64();
+  }
+  else
+  {
+    i2cQueueTail->next = transfer;
+  }
+  i2cQueueTail = transfer;
+  return WE_SUCCESS;
+}
+
+/**
+ * @brief  Complete the transfers whose bus time elapsed and call their
+ *         callbacks, to be called from the main loop
+ * @retval none
+ */
+void I2CPoll()
+{
+  uint64_t now = BasePlatform_micros64();
+
+  while (i2cQueueHead != NULL && now - i2cTransferStart >= I2CDuration(i2cQueueHead))
+  {
+    I2CTransfer_t *transfer = i2cQueueHead;
+
+    i2cTransferStart += I2CDuration(transfer);
+    i2cQueueHead = transfer->next;
+    if (i2cQueueHead == NULL)
+    {
+      i2cQueueTail = NULL;
+    }
+    transfer->next = NULL;
+    transfer->status = I2CExecute(transfer);
+    if (transfer->callback != NULL)
+    {
+      transfer->callback(transfer);
+    }
+  }
+}
+
+/**
+ * @brief  Check if no transfer is queued
+ * @retval true if idle
+ */
+bool I2CIsIdle() { return i2cQueueHead == NULL; }
+
+/**
+ * @brief  Wait for the completion of a transfer
+ * @param  transfer queued transfer
+ * @retval Error Code of the transfer
+ */
+int8_t I2CWait(I2CTransfer_t *transfer)
+{
+  while (transfer->status == I2C_TRANSFER_PENDING)
+  {
+    I2CPoll();
+  }
+  return transfer->status;
+}
+
+/**
+ * @brief  Wait until all queued transfers are completed
+ * @retval none
+ */
+void I2CWaitIdle()
+{
+  while (!I2CIsIdle())
+  {
+    I2CPoll();
+  }
+}
+
+/**
+ * @brief  Run a blocking transfer after the queued ones, without bus time
+ * @param  type transfer type
+ * @param  regAdr register address
+ * @param  data data buffer
+ * @param  length data length
+ * @retval Error Code
+ */
+static int8_t I2CTransferBlocking(I2CTransferType_t type, uint8_t regAdr, uint8_t *data, int length)
+{
+  I2CTransfer_t transfer = {NULL, type, (uint8_t)deviceAddress, regAdr, data, (uint16_t)length, NULL, NULL, I2C_TRANSFER_PENDING};
+
+  I2CWaitIdle();
+  return I2CExecute(&transfer);
+}
+
+/**
+ * @brief  Send data over I2C bus
+ * @param  data : data to send
+ *         datalen : data length
+ * @retval Error Code
+ */
+int8_t I2CSend(uint8_t *data, int datalen)
+{
+  return I2CTransferBlocking(i2cTransferSend, 0, data, datalen);
+}
+
+/**
+ * @brief  Receive data over I2C bus
+ * @param  data : data received
+ *         datalen : data length
+ * @retval Error Code
+ */
+int8_t I2CReceive(uint8_t *data, int datalen)
+{
+  return I2CTransferBlocking(i2cTransferReceive, 0, data, datalen);
+}
+
+/**
+ * @brief   Read data starting from the addressed register
+ * @param  -RegAdr : the register addresse to read from
+ *         -NumByteToRead : number of bytes to read
+ *         -pointer Data : the address store the data
+ * @retval Error Code
+ */
+int8_t ReadReg(uint8_t RegAdr, int NumByteToRead, uint8_t *Data)
+{
+  return I2CTransferBlocking(i2cTransferRead, RegAdr, Data, NumByteToRead);
+}
+
+/**
+ * @brief  Write data strarting from the addressed register
+ * @param  -RegAdr : Address to write in
+ *         -NumByteToWrite : number of bytes to write
+ *         -pointer Data : Address of the data to be written
+ * @retval Error Code
+ */
+int8_t WriteReg(int RegAdr, int NumByteToWrite, uint8_t *Data)
+{
+  return I2CTransferBlocking(i2cTransferWrite, (uint8_t)RegAdr, Data, NumByteToWrite);
+}
+
+/**
+ * @brief  Initialize neopixel
+ * @param
+ * @retval None
+ */
+void neopixelInit()
+{
+  NeoPixelColor = (uint32_t)0;
+  neoPixelChanges = 0;
+}
+
+/**
+ * @brief  Set neopixel color
+ * @param  -color : color to set
+ * @retval None
+ */
+void neopixelSet(uint32_t color)
+{
+  if (color != NeoPixelColor)
+  {
+    neoPixelChanges++;
+  }
+  NeoPixelColor = color;
+}
+
+/**
+ * @brief  Get the recorded neopixel color
+ * @retval Last color set
+ */
+uint32_t neopixelGet() { return NeoPixelColor; }
+
+/**
+ * @brief  Get the number of neopixel color changes since neopixelInit
+ * @retval Number of changes
+ */
+uint32_t neopixelGetChangeCount() { return neoPixelChanges; }
+
+/**
+ * @brief  Initialise button
+ * @param  buttonId button ID
+ * @param  Pin number
+ * @param  OnBtnPress callback on button press
+ * @param  OnBtnLongPress callback on button long press
+ * @retval None
+ */
+void buttonInit(uint8_t buttonId, uint8_t pin, void (*OnBtnPress)(), void (*OnBtnLongPress)())
+{
+  (void)pin;
+  if (buttonId >= BUTTONS)
+  {
+    return;
+  }
+  buttons[buttonId].onPress = OnBtnPress;
+  buttons[buttonId].onLongPress = OnBtnLongPress;
+  buttons[buttonId].pressPending = false;
+  buttons[buttonId].longPressPending = false;
+}
+
+/**
+ * @brief  Queue a button event, delivered by the next buttonUpdate
+ * @param  buttonId button ID
+ * @param  longPress true for a long press
+ * @retval None
+ */
+void buttonPress(uint8_t buttonId, bool longPress)
+{
+  if (buttonId >= BUTTONS)
+  {
+    return;
+  }
+  if (longPress)
+  {
+    buttons[buttonId].longPressPending = true;
+  }
+  else
+  {
+    buttons[buttonId].pressPending = true;
+  }
+}
+
+/**
+ * @brief  Update button - should be called in the main loop. Keys a/b/c on
+ *         the debug input press a button, A/B/C long press it.
+ * @retval None
+ */
+void buttonUpdate()
+{
+  int key;
+
+  while ((key = BaseSerial_read(&Serial)) >= 0)
+  {
+    if (key >= 'a' && key < 'a' + BUTTONS)
+    {
+      buttonPress((uint8_t)(key - 'a'), false);
+    }
+    else if (key >= 'A' && key < 'A' + BUTTONS)
+    {
+      buttonPress((uint8_t)(key - 'A'), true);
+    }
+  }
+
+  for (uint8_t i = 0; i < BUTTONS; i++)
+  {
+    if (buttons[i].pressPending)
+    {
+      buttons[i].pressPending = false;
+      if (buttons[i].onPress != NULL)
+      {
+        buttons[i].onPress();
+      }
+    }
+    if (buttons[i].longPressPending)
+    {
+      buttons[i].longPressPending = false;
+      if (buttons[i].onLongPress != NULL)
+      {
+        buttons[i].onLongPress();
+      }
+    }
+  }
+}
+
+/**
+ * @brief  Check if a button is held down
+ * @retval false, the host buttons are pressed and released at once
+ */
+bool buttonIsPressed() { return false; }
+
+/**
+ * @brief  Read the battery voltage
+ * @retval voltage in V
+ */
+float getBatteryVoltage() { return batteryVoltage; }
+
+/**
+ * @brief  Set the battery voltage returned by getBatteryVoltage
+ * @param  voltage voltage in V
+ * @retval None
+ */
+void setBatteryVoltage(float voltage) { batteryVoltage = voltage; }
+
+/**
+ * @brief  Initialize the SH1107 display. The panel is blank at power-up,
+ *         the sensor simulator answers to its I2C address.
+ * @retval none
+ */
+void SH1107_Init() {}
+
+/**
+ * @brief  Set up the wake-up alarm. The host main loop never sleeps, the
+ *         alarm is only recorded.
+ * @retval true
+ */
+bool wakeupAlarmInit() { return true; }
+
+/**
+ * @brief  Arm the wake-up alarm
+ * @param  delayMs Time to the alarm
+ * @retval delayMs, the host has no limit
+ */
+uint32_t wakeupAlarmSet(uint32_t delayMs)
+{
+  wakeupAlarmMs = delayMs;
+  wakeupAlarmDueUs = BasePlatform_micros64() + (uint64_t)delayMs * 1000;
+  wakeupAlarmArmed = true;
+  return delayMs;
+}
+
+/**
+ * @brief  Read back the last alarm delay set by wakeupAlarmSet
+ * @retval Delay in ms
+ */
+uint32_t wakeupAlarmGet() { return wakeupAlarmMs; }
+
+/**
+ * @brief  Sleep until the wake-up alarm, at most BASE_SLEEP_MAX_US like the
+ *         SysTick interrupt waking the target, so the polled serial ports
+ *         and buttons stay responsive
+ * @param  standby ignored, the host has one sleep mode
+ * @retval 0, the host clock does not stop
+ */
+uint32_t cpuSleep(bool standby)
+{
+  uint64_t now = BasePlatform_micros64();
+  uint64_t sleepUs = BASE_SLEEP_MAX_US;
+
+  (void)standby;
+  if (wakeupAlarmArmed)
+  {
+    if (wakeupAlarmDueUs <= now)
+    {
+      /* The alarm interrupt is pending, the sleep ends at once */
+      wakeupAlarmArmed = false;
+      return 0;
+    }
+    if (wakeupAlarmDueUs - now < sleepUs)
+    {
+      sleepUs = wakeupAlarmDueUs - now;
+    }
+  }
+  delayMicroseconds((unsigned int)sleepUs);
+  return 0;
+}
+
+/**
+ * @brief  Mask the interrupts, the host interrupts are called synchronously
+ * @retval None
+ */
+void noInterrupts() {}
+
+/**
+ * @brief  Unmask the interrupts
+ * @retval None
+ */
+void interrupts() {}
+/**         EOF         */
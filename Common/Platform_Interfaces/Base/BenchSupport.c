@@ -0,0 +1,112 @@
+/**
+ * \file
+ * \brief Helpers shared by the host benchmarks.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "BenchSupport.h"
+
+/* xorshift32 state */
+static uint32_t benchRandom = 2463534242u;
+
+/**
+ * @brief  Next number of the xorshift32 sequence
+ * @retval Pseudo-random number
+ */
+uint32_t Bench_random()
+{
+  benchRandom ^= benchRandom << 13;
+  benchRandom ^= benchRandom >> 17;
+  benchRandom ^= benchRandom << 5;
+  return benchRandom;
+}
+
+static TypeSerial *Mock_init(void *Debug, void *CalypsoSerial)
+{
+  (void)Debug;
+  (void)CalypsoSerial;
+  return NULL;
+}
+
+static bool Mock_true()
+{
+  return true;
+}
+
+static void Mock_none()
+{
+}
+
+static uint32_t Mock_getConfigHash()
+{
+  return CHECKSUM_FNV1A_INIT;
+}
+
+static bool Mock_publishMotionEvent(const char *event, uint16_t count)
+{
+  (void)event;
+  (void)count;
+  return true;
+}
+
+static unsigned long Mock_getTelemetrySendInterval()
+{
+  return BENCH_MOCK_TELEMETRY_INTERVAL_MS;
+}
+
+/**
+ * @brief  Fill a platform driver with mocks, a bench then replaces the
+ *         functions it observes
+ * @param  platform Driver
+ * @param  id Platform of the driver
+ * @param  name Name and display name
+ * @retval None
+ */
+void Bench_mockPlatform(Device_Platform_t *platform, IoT_platforms_t id, const char *name)
+{
+  platform->id = id;
+  platform->name = name;
+  platform->displayName = name;
+  platform->init = Mock_init;
+  platform->configurationComplete = Mock_true;
+  platform->deletePreviousConfig = NULL;
+  platform->writeConfigFiles = Mock_none;
+  platform->getConfigHash = Mock_getConfigHash;
+  platform->isConfigured = Mock_true;
+  platform->configurationInProgress = Mock_none;
+  platform->isConnectedToWiFi = Mock_true;
+  platform->isUpToDate = Mock_true;
+  platform->isStatusOK = Mock_true;
+  platform->readSensors = Mock_none;
+  platform->MQTTConnect = Mock_none;
+  platform->subscribeToTopics = Mock_true;
+  platform->publishSensorData = Mock_none;
+  platform->publishMotionEvent = Mock_publishMotionEvent;
+  platform->displaySensorData = Mock_none;
+  platform->processCloudMessage = Mock_none;
+  platform->connectWiFi = Mock_none;
+  platform->disconnectWiFi = Mock_none;
+  platform->WiFiProvisioning = Mock_none;
+  platform->reset = Mock_none;
+  platform->restart = Mock_none;
+  platform->getTelemetrySendInterval = Mock_getTelemetrySendInterval;
+  platform->isSensorsPresent = Mock_true;
+}
+/**         EOF         */
@@ -0,0 +1,55 @@
+/**
+ * \file
+ * \brief Helpers shared by the host benchmarks.
+ *
+ * A pseudo-random generator with a fixed seed, so that every run of a
+ * bench sees the same sequence, and a mock IoT platform driver whose
+ * functions do nothing and succeed.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef BENCHSUPPORT_H
+#define BENCHSUPPORT_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+#include "PnP_Common_Device.h"
+
+/* Telemetry interval of the mock platform */
+#define BENCH_MOCK_TELEMETRY_INTERVAL_MS 30000
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    uint32_t Bench_random();
+
+    void Bench_mockPlatform(Device_Platform_t *platform, IoT_platforms_t id, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCHSUPPORT_H */
@@ -0,0 +1,228 @@
+/**
+ * \file
+ * \brief Time from power-on to the first publish of the gateway.
+ *
+ * Runs the boot sequence of GW/src/main.cpp setup() and the cloud connect
+ * against the Calypso simulator in a child process, which models the UART,
+ * the boot of the module after power-on and after AT+reboot, its file
+ * system with the flash write times, the Wi-Fi association and the MQTT
+ * connect. The module keeps its files across the boots. Boots from a
+ * module without the web and certificate files, boots through all the
+ * checks (boot snapshot deleted) and boots taking the fast path of the
+ * boot snapshot, and prints the time to the end of Device_init, of the
+ * boot checks and to the first telemetry message, and the AT commands sent
+ * up to it.
+ *
+ * Usage: boot_bench [boots]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ConfigPlatform.h"
+#include "CalypsoSimulator.h"
+#include "PnP_Common_Device.h"
+#include "SensorSimulator.h"
+
+#define BOOT_BENCH_DEFAULT_BOOTS 2
+
+typedef struct
+{
+  unsigned long initMs;
+  unsigned long checksMs;
+  unsigned long publishMs;
+  unsigned long requests; /* AT commands, each retry and file chunk counted */
+  bool snapshot;          /* The boot took the fast path */
+} BootBenchTimes_t;
+
+/* Defined by GW/src/main.cpp in the application */
+char displayText[150];
+extern CALYPSO *calypso;
+
+/**
+ * @brief  Boot sequence of setup() after the display and the buttons, then
+ *         the cloud connect of the connectivity task and the first telemetry
+ * @param  times Time from power-on to the end of each step
+ * @retval true if the telemetry was published
+ */
+static bool BootBench_boot(BootBenchTimes_t *times)
+{
+  unsigned long startTime = millis();
+  uint32_t startRequests = Calypso_getRequestCount();
+  Calypso_MQTTStats_t stats;
+  bool platformConfigured;
+
+  Device_init(&Serial, &Serial1);
+  times->initMs = millis() - startTime;
+  times->snapshot = Device_isBootSnapshotValid();
+
+  platformConfigured = Device_isIotPlatformConfigured();
+  if (!Device_isUpToDate() || !Device_isConfigured() || !Device_isConnectedToWiFi())
+  {
+    return false;
+  }
+  if (!Device_isBootSnapshotValid())
+  {
+    LED_INDICATION_SHORT_DELAY;
+    if (platformConfigured)
+    {
+      Device_saveBootSnapshot();
+    }
+  }
+  times->checksMs = millis() - startTime;
+
+  Device_MQTTConnect();
+  Device_SubscribeToTopics();
+  Calypso_MQTTresetStats();
+  Device_PublishSensorData();
+  Calypso_MQTTgetStats(&stats);
+  times->publishMs = millis() - startTime;
+  times->requests = Calypso_getRequestCount() - startRequests;
+  return ((stats.published[0] + stats.published[1]) > 0);
+}
+
+/**
+ * @brief  Power on the simulated Calypso and boot the gateway
+ * @param  control Control pipe of the simulator
+ * @param  commands Control commands sent before the power-on
+ * @param  times Time from power-on to the end of each step
+ * @retval true if the telemetry was published
+ */
+static bool BootBench_powerOn(int control, const char *commands, BootBenchTimes_t *times)
+{
+  char power = 'p';
+
+  if (calypso != NULL)
+  {
+    Calypso_Destroy(calypso);
+    calypso = NULL;
+  }
+  if ((write(control, commands, strlen(commands)) != (ssize_t)strlen(commands)) ||
+      (write(control, &power, 1) != 1))
+  {
+    return false;
+  }
+  return BootBench_boot(times);
+}
+
+/**
+ * @brief  Print the mean time of several boots
+ * @param  name Boot path
+ * @param  sum Sum of the times
+ * @param  boots Number of boots
+ * @retval None
+ */
+static void BootBench_print(const char *name, const BootBenchTimes_t *sum, uint32_t boots)
+{
+  printf("%-12s %6lu %10lu %10lu %10lu %10lu\r\n", name, (unsigned long)boots, sum->initMs / boots,
+         sum->checksMs / boots, sum->publishMs / boots, sum->requests / boots);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t boots = (argc > 1) ? (uint32_t)atol(argv[1]) : BOOT_BENCH_DEFAULT_BOOTS;
+  static const char *paths[] = {"full checks", "snapshot"};
+  static const char *commands[] = {"x", ""};
+  BootBenchTimes_t times;
+  int control[2];
+  int peerIn;
+  int peerOut;
+  bool failed = false;
+  pid_t child;
+
+  if (boots == 0)
+  {
+    boots = 1;
+  }
+  if (!BaseSerial_openPipe(&Serial1, &peerIn, &peerOut) || (pipe(control) != 0))
+  {
+    fprintf(stderr, "Unable to open the Calypso pipes\r\n");
+    return 1;
+  }
+  child = fork();
+  if (child < 0)
+  {
+    fprintf(stderr, "Unable to start the Calypso simulator\r\n");
+    return 1;
+  }
+  if (child == 0)
+  {
+    BaseSerial_close(&Serial1);
+    close(control[1]);
+    CalypsoSim_run(peerIn, peerOut, control[0]);
+    _exit(0);
+  }
+  close(peerIn);
+  close(peerOut);
+  close(control[0]);
+
+  /* The debug output of the gateway is dropped, the results go to stdout */
+  fflush(stdout);
+  Serial.fdOut = open("/dev/null", O_WRONLY);
+  SensorSim_init();
+
+  printf("%-12s %6s %10s %10s %10s %10s\r\n", "boot", "boots", "init ms", "checks ms", "publish ms", "requests");
+
+  /* Module without the web and certificate files */
+  if (!BootBench_powerOn(control[1], "f", &times))
+  {
+    fprintf(stderr, "first boot failed\r\n");
+    failed = true;
+  }
+  else
+  {
+    BootBench_print("first", &times, 1);
+  }
+
+  for (uint8_t p = 0; !failed && (p < sizeof(paths) / sizeof(paths[0])); p++)
+  {
+    BootBenchTimes_t sum = {0, 0, 0, 0, false};
+
+    for (uint32_t b = 0; b < boots; b++)
+    {
+      if (!BootBench_powerOn(control[1], commands[p], &times) || (times.snapshot != (p == 1)))
+      {
+        fprintf(stderr, "%s boot failed\r\n", paths[p]);
+        failed = true;
+        break;
+      }
+      sum.initMs += times.initMs;
+      sum.checksMs += times.checksMs;
+      sum.publishMs += times.publishMs;
+      sum.requests += times.requests;
+    }
+    if (!failed)
+    {
+      BootBench_print(paths[p], &sum, boots);
+    }
+  }
+
+  BaseSerial_close(&Serial1);
+  close(control[1]);
+  kill(child, SIGTERM);
+  waitpid(child, NULL, 0);
+  return failed ? 1 : 0;
+}
+/**         EOF         */
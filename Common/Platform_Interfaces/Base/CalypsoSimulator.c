@@ -0,0 +1,578 @@
+/**
+ * \file
+ * \brief AT command simulator of the Calypso Wi-Fi module for the host build.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <poll.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include "CalypsoSimulator.h"
+#include "PnP_Common_Device.h"
+
+#define CALYPSO_SIM_MAX_PENDING 32
+#define CALYPSO_SIM_MAX_FILES 32
+#define CALYPSO_SIM_MAX_FILE_SIZE 8192
+#define CALYPSO_SIM_FILE_NAME_SIZE 64
+
+typedef struct
+{
+  uint64_t dueUs;
+  char *line;
+} CalypsoSim_output_t;
+
+typedef struct
+{
+  char name[CALYPSO_SIM_FILE_NAME_SIZE];
+  uint8_t data[CALYPSO_SIM_MAX_FILE_SIZE];
+  size_t size;
+  bool used;
+} CalypsoSim_file_t;
+
+typedef struct
+{
+  bool wifi;
+  bool client;
+  bool broker;
+  bool session;
+  uint64_t busyUntilUs;
+  CalypsoSim_output_t pending[CALYPSO_SIM_MAX_PENDING];
+  size_t count;
+  CalypsoSim_file_t files[CALYPSO_SIM_MAX_FILES];
+  int openFile; /* Index of the open file, -1 if none */
+} CalypsoSim_module_t;
+
+static CalypsoSim_module_t module;
+static CalypsoSim_commandHook_t commandHook = NULL;
+static CalypsoSim_controlHook_t controlHook = NULL;
+
+/**
+ * @brief  Set the hooks of the bench
+ * @param  command Called for each command received, NULL for none
+ * @param  control Called for the unknown control commands, NULL for none
+ * @retval None
+ */
+void CalypsoSim_setHooks(CalypsoSim_commandHook_t command, CalypsoSim_controlHook_t control)
+{
+  commandHook = command;
+  controlHook = control;
+}
+
+/**
+ * @brief  Schedule a line sent by the simulated Calypso, in time order
+ * @param  dueUs Time to send the line
+ * @param  format Line including CRLF, printf format
+ * @retval None
+ */
+void CalypsoSim_schedule(uint64_t dueUs, const char *format, ...)
+{
+  size_t i = module.count;
+  va_list args;
+  char *line;
+
+  if (module.count >= CALYPSO_SIM_MAX_PENDING)
+  {
+    return;
+  }
+  line = malloc(CALYPSO_LINE_MAX_SIZE + 64);
+  if (line == NULL)
+  {
+    return;
+  }
+  va_start(args, format);
+  vsnprintf(line, CALYPSO_LINE_MAX_SIZE + 64, format, args);
+  va_end(args);
+  while (i > 0 && module.pending[i - 1].dueUs > dueUs)
+  {
+    module.pending[i] = module.pending[i - 1];
+    i--;
+  }
+  module.pending[i].dueUs = dueUs;
+  module.pending[i].line = line;
+  module.count++;
+}
+
+/**
+ * @brief  Check if the simulated Calypso is connected to the broker
+ * @retval true if connected
+ */
+bool CalypsoSim_isConnected()
+{
+  return module.broker;
+}
+
+/**
+ * @brief  Find a file of the simulated Calypso
+ * @param  name File name
+ * @retval Index of the file, -1 if it does not exist
+ */
+static int CalypsoSim_findFile(const char *name)
+{
+  for (int i = 0; i < CALYPSO_SIM_MAX_FILES; i++)
+  {
+    if (module.files[i].used && (0 == strcmp(module.files[i].name, name)))
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief  Create or truncate a file of the simulated Calypso
+ * @param  name File name
+ * @retval Index of the file, -1 if the file system is full
+ */
+static int CalypsoSim_createFile(const char *name)
+{
+  int index = CalypsoSim_findFile(name);
+
+  for (int i = 0; (index < 0) && (i < CALYPSO_SIM_MAX_FILES); i++)
+  {
+    if (!module.files[i].used)
+    {
+      index = i;
+    }
+  }
+  if (index >= 0)
+  {
+    strncpy(module.files[index].name, name, CALYPSO_SIM_FILE_NAME_SIZE - 1);
+    module.files[index].size = 0;
+    module.files[index].used = true;
+  }
+  return index;
+}
+
+/**
+ * @brief  Copy the first argument of a command up to a delimiter
+ * @param  line Command
+ * @param  argument Output buffer of CALYPSO_SIM_FILE_NAME_SIZE bytes
+ * @retval None
+ */
+static void CalypsoSim_getArgument(const char *line, char *argument)
+{
+  const char *start = strchr(line, '=');
+  size_t length;
+
+  argument[0] = '\0';
+  if (start == NULL)
+  {
+    return;
+  }
+  start++;
+  length = strcspn(start, ",\r\n");
+  if (length >= CALYPSO_SIM_FILE_NAME_SIZE)
+  {
+    length = CALYPSO_SIM_FILE_NAME_SIZE - 1;
+  }
+  memcpy(argument, start, length);
+  argument[length] = '\0';
+}
+
+/**
+ * @brief  Handle a file command of the simulated Calypso
+ * @param  line Command including CRLF
+ * @param  length Length of the command
+ * @param  done Time the command is handled
+ * @retval Time the response is sent
+ */
+static uint64_t CalypsoSim_fileCommand(const char *line, size_t length, uint64_t done)
+{
+  char name[CALYPSO_SIM_FILE_NAME_SIZE];
+  unsigned int id, offset, format, count;
+  int index;
+
+  (void)length;
+  CalypsoSim_getArgument(line, name);
+  if (0 == strncasecmp(line, "AT+fileGetInfo=", 15))
+  {
+    index = CalypsoSim_findFile(name);
+    if (index < 0)
+    {
+      CalypsoSim_schedule(done, "Error:-11\r\n");
+      return done;
+    }
+    CalypsoSim_schedule(done, "+filegetinfo:0,%u,4096,0,0,0\r\nOK\r\n", (unsigned int)module.files[index].size);
+  }
+  else if (0 == strncasecmp(line, "AT+fileOpen=", 12))
+  {
+    if (strstr(line, "CREATE") != NULL)
+    {
+      index = CalypsoSim_createFile(name);
+      done += CALYPSO_SIM_FILE_CREATE_US;
+    }
+    else
+    {
+      index = CalypsoSim_findFile(name);
+    }
+    if (index < 0)
+    {
+      CalypsoSim_schedule(done, "Error:-11\r\n");
+      return done;
+    }
+    module.openFile = index;
+    CalypsoSim_schedule(done, "+fileopen:%d,0\r\nOK\r\n", index + 1);
+  }
+  else if (0 == strncasecmp(line, "AT+fileRead=", 12) &&
+           (4 == sscanf(line + 12, "%u,%u,%u,%u", &id, &offset, &format, &count)) && (module.openFile >= 0))
+  {
+    static uint8_t encoded[CALYPSO_LINE_MAX_SIZE];
+    CalypsoSim_file_t *file = &module.files[module.openFile];
+    uint32_t encodedLength = 0;
+
+    if (offset > file->size)
+    {
+      offset = file->size;
+    }
+    if (count > file->size - offset)
+    {
+      count = file->size - offset;
+    }
+    if ((count + 2) / 3 * 4 >= sizeof(encoded))
+    {
+      count = (sizeof(encoded) / 4 - 1) * 3;
+    }
+    Calypso_encodeBase64(&file->data[offset], count, encoded, &encodedLength);
+    encoded[encodedLength] = '\0';
+    done += (encodedLength + 20) * CALYPSO_SIM_BYTE_US;
+    CalypsoSim_schedule(done, "+fileread:%u,%u,%s\r\nOK\r\n", (unsigned int)Calypso_DataFormat_Base64,
+                       (unsigned int)encodedLength, (char *)encoded);
+  }
+  else if (0 == strncasecmp(line, "AT+fileWrite=", 13) &&
+           (4 == sscanf(line + 13, "%u,%u,%u,%u", &id, &offset, &format, &count)) && (module.openFile >= 0))
+  {
+    static uint8_t decoded[CALYPSO_LINE_MAX_SIZE];
+    CalypsoSim_file_t *file = &module.files[module.openFile];
+    const char *data = line + 13;
+    uint32_t decodedLength = count;
+
+    for (int commas = 0; commas < 4; data++)
+    {
+      commas += (*data == ',') ? 1 : 0;
+    }
+    if (format == Calypso_DataFormat_Base64)
+    {
+      Calypso_decodeBase64((uint8_t *)data, count, decoded, &decodedLength);
+    }
+    else
+    {
+      memcpy(decoded, data, count);
+    }
+    if (offset + decodedLength > CALYPSO_SIM_MAX_FILE_SIZE)
+    {
+      CalypsoSim_schedule(done, "Error:-1\r\n");
+      return done;
+    }
+    memcpy(&file->data[offset], decoded, decodedLength);
+    if (offset + decodedLength > file->size)
+    {
+      file->size = offset + decodedLength;
+    }
+    done += CALYPSO_SIM_FILE_WRITE_US;
+    CalypsoSim_schedule(done, "+filewrite:%u\r\nOK\r\n", (unsigned int)decodedLength);
+  }
+  else if (0 == strncasecmp(line, "AT+fileClose=", 13))
+  {
+    module.openFile = -1;
+    CalypsoSim_schedule(done, "OK\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+fileDel=", 11))
+  {
+    index = CalypsoSim_findFile(name);
+    if (index < 0)
+    {
+      CalypsoSim_schedule(done, "Error:-11\r\n");
+      return done;
+    }
+    module.files[index].used = false;
+    done += CALYPSO_SIM_FILE_DELETE_US;
+    CalypsoSim_schedule(done, "OK\r\n");
+  }
+  else
+  {
+    CalypsoSim_schedule(done, "Error:-1\r\n");
+  }
+  return done;
+}
+
+/**
+ * @brief  Handle a command received by the simulated Calypso
+ * @param  line Command including CRLF
+ * @param  length Length of the command
+ * @retval None
+ */
+static void CalypsoSim_command(const char *line, size_t length)
+{
+  uint64_t now = BasePlatform_micros64();
+  uint64_t done = ((module.busyUntilUs > now) ? module.busyUntilUs : now) + length * CALYPSO_SIM_BYTE_US +
+                  CALYPSO_SIM_PROCESS_US;
+
+  if (commandHook != NULL)
+  {
+    commandHook(line, length, done);
+  }
+  if (0 == strncasecmp(line, "AT+file", 7))
+  {
+    module.busyUntilUs = CalypsoSim_fileCommand(line, length, done);
+    return;
+  }
+  if (0 == strncasecmp(line, "AT+reboot", 9))
+  {
+    module.wifi = false;
+    module.client = false;
+    module.broker = false;
+    CalypsoSim_schedule(done, "OK\r\n");
+    done += CALYPSO_SIM_REBOOT_US;
+    CalypsoSim_schedule(done, "+eventstartup:0,0,00:11:22:33:44:55,3.4.0\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+get=IOT,UDID", 15))
+  {
+    CalypsoSim_schedule(done, "+get:01,02,03,04,05,06,07,08,09,0a,0b,0c,0d,0e,0f,10\r\nOK\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+get=general,time", 19))
+  {
+    CalypsoSim_schedule(done, "+get:12,30,15,18,10,2026\r\nOK\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+netCfgGet=IPV4_STA_ADDR", 26))
+  {
+    CalypsoSim_schedule(done, "+netcfgget:DHCP,%s,255.255.255.0,192.168.1.1,192.168.1.1\r\nOK\r\n",
+                       module.wifi ? "192.168.1.20" : "0.0.0.0");
+  }
+  else if (0 == strncasecmp(line, "AT+netAppUpdateTime", 19))
+  {
+    done += CALYPSO_SIM_RTT_US;
+    CalypsoSim_schedule(done, "OK\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+wlanConnect=", 15))
+  {
+    module.wifi = true;
+    CalypsoSim_schedule(done, "OK\r\n");
+    CalypsoSim_schedule(done + CALYPSO_SIM_ASSOCIATION_US,
+                       "+eventnetapp:ipv4_acquired,192.168.1.20,192.168.1.1,192.168.1.1\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+wlanDisconnect", 17))
+  {
+    module.wifi = false;
+    module.broker = false;
+    CalypsoSim_schedule(done, "OK\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+mqttCreate=", 14))
+  {
+    CalypsoSim_schedule(done, module.client ? "Error:-1\r\n" : "OK\r\n");
+    module.client = true;
+    module.session = false;
+  }
+  else if (0 == strncasecmp(line, "AT+mqttConnect=", 15))
+  {
+    if (!module.client || !module.wifi)
+    {
+      CalypsoSim_schedule(done, "Error:-1\r\n");
+    }
+    else
+    {
+      /* The connack comes before the OK */
+      done += CALYPSO_SIM_TLS_US + CALYPSO_SIM_RTT_US;
+      module.broker = true;
+      CalypsoSim_schedule(done, "+eventmqtt:operation,connack,0\r\n");
+      done += CALYPSO_SIM_PROCESS_US;
+      CalypsoSim_schedule(done, "OK\r\n");
+    }
+  }
+  else if (0 == strncasecmp(line, "AT+mqttSubscribe=", 17))
+  {
+    CalypsoSim_schedule(done, module.broker ? "OK\r\n" : "Error:-1\r\n");
+    if (module.broker)
+    {
+      CalypsoSim_schedule(done + CALYPSO_SIM_RTT_US, "+eventmqtt:operation,suback,0\r\n");
+    }
+  }
+  else if (0 == strncasecmp(line, "AT+mqttPublish=", 15))
+  {
+    CalypsoSim_schedule(done, module.broker ? "OK\r\n" : "Error:-1\r\n");
+    if (module.broker && (strstr(line, ",QOS1,") != NULL))
+    {
+      CalypsoSim_schedule(done + CALYPSO_SIM_RTT_US, "+eventmqtt:operation,puback\r\n");
+    }
+  }
+  else if (0 == strncasecmp(line, "AT+mqttDelete", 13))
+  {
+    module.client = false;
+    module.broker = false;
+    CalypsoSim_schedule(done, "OK\r\n");
+  }
+  else
+  {
+    CalypsoSim_schedule(done, "OK\r\n");
+  }
+  module.busyUntilUs = done;
+}
+
+/**
+ * @brief  Check if a command is complete. The data of a binary file write
+ *         may contain line ends, its length is given before it.
+ * @param  line Received bytes
+ * @param  length Number of received bytes
+ * @retval true if the command is complete
+ */
+static bool CalypsoSim_isComplete(const char *line, size_t length)
+{
+  const char *data = line + 13;
+  unsigned int id, offset, format, count;
+  int commas = 0;
+
+  if ((length < 2) || (line[length - 1] != '\n'))
+  {
+    return false;
+  }
+  if ((0 != strncasecmp(line, "AT+fileWrite=", 13)) ||
+      (4 != sscanf(data, "%u,%u,%u,%u", &id, &offset, &format, &count)))
+  {
+    return true;
+  }
+  while ((commas < 4) && (data < line + length))
+  {
+    commas += (*data++ == ',') ? 1 : 0;
+  }
+  return (size_t)(line + length - data) >= count + 2;
+}
+
+/**
+ * @brief  Control command of the bench to the simulated Calypso
+ * @param  control 'p' power-on, 'f' factory file system, 'x' delete the
+ *         boot snapshot, others to the control hook
+ * @retval None
+ */
+static void CalypsoSim_control(char control)
+{
+  int index;
+
+  switch (control)
+  {
+  case 'p':
+    for (size_t i = 0; i < module.count; i++)
+    {
+      free(module.pending[i].line);
+    }
+    module.count = 0;
+    module.wifi = false;
+    module.client = false;
+    module.broker = false;
+    module.openFile = -1;
+    module.busyUntilUs = BasePlatform_micros64() + CALYPSO_SIM_POWER_ON_US;
+    CalypsoSim_schedule(module.busyUntilUs, "+eventstartup:0,0,00:11:22:33:44:55,3.4.0\r\n");
+    break;
+  case 'f':
+    memset(module.files, 0, sizeof(module.files));
+    index = CalypsoSim_createFile(PLATFORM_CONFIG_FILE_PATH);
+    strcpy((char *)module.files[index].data, "{\"platform\":\"AZURE\"}");
+    module.files[index].size = strlen((char *)module.files[index].data);
+    break;
+  case 'x':
+    index = CalypsoSim_findFile(BOOT_SNAPSHOT_FILE_PATH);
+    if (index >= 0)
+    {
+      module.files[index].used = false;
+    }
+    break;
+  default:
+    if (controlHook != NULL)
+    {
+      controlHook(control);
+    }
+    break;
+  }
+}
+
+/**
+ * @brief  Simulated Calypso, runs until the gateway side closes the pipe
+ * @param  fdIn Commands from the gateway
+ * @param  fdOut Responses and events to the gateway
+ * @param  fdControl Control commands of the bench
+ * @retval None
+ */
+void CalypsoSim_run(int fdIn, int fdOut, int fdControl)
+{
+  static char line[CALYPSO_LINE_MAX_SIZE * 2];
+  size_t length = 0;
+
+  module.openFile = -1;
+  for (;;)
+  {
+    uint64_t now = BasePlatform_micros64();
+    struct pollfd fds[2] = {{fdIn, POLLIN, 0}, {fdControl, POLLIN, 0}};
+    int timeoutMs = -1;
+    char c;
+
+    while (module.count > 0 && module.pending[0].dueUs <= now)
+    {
+      if (write(fdOut, module.pending[0].line, strlen(module.pending[0].line)) < 0)
+      {
+        return;
+      }
+      free(module.pending[0].line);
+      memmove(&module.pending[0], &module.pending[1], (module.count - 1) * sizeof(module.pending[0]));
+      module.count--;
+    }
+    if (module.count > 0)
+    {
+      timeoutMs = (int)((module.pending[0].dueUs - now + 999) / 1000);
+    }
+    if (poll(fds, 2, timeoutMs) <= 0)
+    {
+      continue;
+    }
+    if (fds[1].revents != 0)
+    {
+      if (read(fdControl, &c, 1) != 1)
+      {
+        return;
+      }
+      CalypsoSim_control(c);
+      length = 0;
+    }
+    if (fds[0].revents == 0)
+    {
+      continue;
+    }
+    if (read(fdIn, &c, 1) != 1)
+    {
+      return;
+    }
+    if (length < sizeof(line) - 1)
+    {
+      line[length++] = c;
+    }
+    line[length] = '\0';
+    if (CalypsoSim_isComplete(line, length))
+    {
+      /* Commands sent while booting are lost */
+      if (BasePlatform_micros64() >= module.busyUntilUs || module.count == 0 ||
+          (0 != strncmp(module.pending[module.count - 1].line, "+eventstartup", 13)))
+      {
+        CalypsoSim_command(line, length);
+      }
+      length = 0;
+    }
+  }
+}
+/**         EOF         */
@@ -0,0 +1,82 @@
+/**
+ * \file
+ * \brief AT command simulator of the Calypso Wi-Fi module for the host build.
+ *
+ * Runs on the other end of a serial pipe of the base platform, usually in a
+ * child process. Models the 921600 baud UART like Device_init, the AT
+ * command handling, the boot after power-on and after AT+reboot, the flash
+ * writes of the file system, the Wi-Fi association with DHCP and the MQTT
+ * client with the TLS handshake, the broker round trip and the PUBACKs of
+ * the QoS 1 publications. A bench adds cloud messages with
+ * CalypsoSim_schedule and observes the commands through a hook.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef CALYPSOSIMULATOR_H
+#define CALYPSOSIMULATOR_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/* Time of a byte on the UART and of the handling of a command */
+#define CALYPSO_SIM_BYTE_US 11
+#define CALYPSO_SIM_PROCESS_US 1000
+#define CALYPSO_SIM_POWER_ON_US 1500000
+#define CALYPSO_SIM_REBOOT_US 1200000
+#define CALYPSO_SIM_FILE_CREATE_US 15000
+#define CALYPSO_SIM_FILE_WRITE_US 6000
+#define CALYPSO_SIM_FILE_DELETE_US 10000
+#define CALYPSO_SIM_ASSOCIATION_US 1500000
+#define CALYPSO_SIM_TLS_US 800000
+#define CALYPSO_SIM_RTT_US 50000
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief  Called for each command received, before it is handled
+     * @param  line Command including CRLF
+     * @param  length Length of the command
+     * @param  doneUs Time the command is taken by the module
+     */
+    typedef void (*CalypsoSim_commandHook_t)(const char *line, size_t length, uint64_t doneUs);
+
+    /**
+     * @brief  Called for the control commands the simulator does not know
+     * @param  control Control command
+     */
+    typedef void (*CalypsoSim_controlHook_t)(char control);
+
+    void CalypsoSim_setHooks(CalypsoSim_commandHook_t command, CalypsoSim_controlHook_t control);
+    void CalypsoSim_schedule(uint64_t dueUs, const char *format, ...);
+    bool CalypsoSim_isConnected();
+    void CalypsoSim_run(int fdIn, int fdOut, int fdControl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CALYPSOSIMULATOR_H */
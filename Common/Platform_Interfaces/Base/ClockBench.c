@@ -0,0 +1,162 @@
+/**
+ * \file
+ * \brief Rollover check and cost of the 64-bit system time.
+ *
+ * Starts the host clock just before the 32-bit micros() wrap (71 minutes)
+ * and runs it past several micros() wraps and one millis() wrap (49 days),
+ * in irregular steps and in gaps longer than a micros() wrap. Every step
+ * checks SysTime_micros, SysTime_millis and SysTime_unixMillis against the
+ * 64-bit host clock and checks that they never go back. Prints the cost
+ * per timestamp.
+ *
+ * Usage: clock_bench [steps]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "systime.h"
+
+#define CLOCK_BENCH_DEFAULT_STEPS 1000000
+#define CLOCK_BENCH_TIMESTAMPS 1000000
+#define CLOCK_BENCH_UNIX_MS 1656633600000ull /* 2022-07-01 00:00:00 UTC */
+#define CLOCK_BENCH_MICROS_WRAP_US (1ull << 32)
+#define CLOCK_BENCH_MILLIS_WRAP_US ((1ull << 32) * 1000)
+
+static uint32_t benchWrong = 0;
+static uint64_t lastMicros = 0;
+static uint64_t lastMillis = 0;
+static uint64_t lastUnixMs = 0;
+
+/**
+ * @brief  Compare the system time with the host clock read around it
+ * @param  offsetMs Host time at which the wall clock was set, minus its value
+ * @retval None
+ */
+static void ClockBench_check(uint64_t offsetMs)
+{
+  uint64_t before = BasePlatform_micros64();
+  uint64_t us = SysTime_micros();
+  uint64_t ms = SysTime_millis();
+  uint64_t unixMs = SysTime_unixMillis();
+  uint64_t after = BasePlatform_micros64();
+  bool wrong = false;
+
+  /* SysTime_micros may be held back at most 1 ms by the monotonic guard */
+  if (us + 1000 < before || us > after)
+  {
+    wrong = true;
+  }
+  if (ms < before / 1000 || ms > after / 1000)
+  {
+    wrong = true;
+  }
+  if (unixMs + offsetMs < before / 1000 || unixMs + offsetMs > after / 1000 + 1)
+  {
+    wrong = true;
+  }
+  if (us < lastMicros || ms < lastMillis || unixMs < lastUnixMs)
+  {
+    wrong = true;
+  }
+  if (wrong && benchWrong++ < 10)
+  {
+    printf("wrong at %llu us: micros %llu, millis %llu, unix %llu\r\n", (unsigned long long)before,
+           (unsigned long long)us, (unsigned long long)ms, (unsigned long long)unixMs);
+  }
+  lastMicros = us;
+  lastMillis = ms;
+  lastUnixMs = unixMs;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t steps = (argc > 1) ? (uint32_t)atol(argv[1]) : CLOCK_BENCH_DEFAULT_STEPS;
+  uint32_t microsWraps = 0;
+  uint32_t millisWraps = 0;
+  uint64_t offsetMs;
+  uint64_t startUs;
+  uint64_t sum = 0;
+
+  /* 1 s before micros() wraps for the first time */
+  BasePlatform_advanceClock(CLOCK_BENCH_MICROS_WRAP_US - 1000000);
+  SysTime_setUnixTime(CLOCK_BENCH_UNIX_MS);
+  offsetMs = SysTime_millis() - CLOCK_BENCH_UNIX_MS;
+
+  for (uint32_t i = 0; i < steps; i++)
+  {
+    uint64_t before = BasePlatform_micros64();
+    uint32_t r = Bench_random();
+
+    /* Mostly short steps, sometimes minutes, rarely more than a micros() wrap.
+     * Some steps go to just before the next micros() wrap and cross it in
+     * small steps, the millisecond time is behind micros() there. */
+    if (r % 1000 == 1)
+    {
+      uint64_t wrapUs = (before / CLOCK_BENCH_MICROS_WRAP_US + 1) * CLOCK_BENCH_MICROS_WRAP_US;
+
+      BasePlatform_advanceClock(wrapUs - before - 2000);
+      for (int j = 0; j < 40; j++)
+      {
+        BasePlatform_advanceClock(Bench_random() % 200);
+        ClockBench_check(offsetMs);
+      }
+    }
+    else if (r % 1000 == 0)
+    {
+      BasePlatform_advanceClock(CLOCK_BENCH_MICROS_WRAP_US + Bench_random() % CLOCK_BENCH_MICROS_WRAP_US);
+    }
+    else if (r % 100 == 0)
+    {
+      BasePlatform_advanceClock((uint64_t)(Bench_random() % 600) * 1000000);
+    }
+    else
+    {
+      BasePlatform_advanceClock(Bench_random() % 2000000);
+    }
+    ClockBench_check(offsetMs);
+    microsWraps += (uint32_t)(BasePlatform_micros64() / CLOCK_BENCH_MICROS_WRAP_US - before / CLOCK_BENCH_MICROS_WRAP_US);
+    millisWraps += (uint32_t)(BasePlatform_micros64() / CLOCK_BENCH_MILLIS_WRAP_US - before / CLOCK_BENCH_MILLIS_WRAP_US);
+  }
+  printf("%lu steps to %llu days uptime, %lu micros() wraps, %lu millis() wraps, %lu wrong\r\n",
+         (unsigned long)steps, (unsigned long long)(BasePlatform_micros64() / 86400000000ull),
+         (unsigned long)microsWraps, (unsigned long)millisWraps, (unsigned long)benchWrong);
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < CLOCK_BENCH_TIMESTAMPS; i++)
+  {
+    sum += SysTime_micros();
+  }
+  printf("micros    %8.1f ns per call\r\n",
+         (double)(BasePlatform_micros64() - startUs) * 1000.0 / CLOCK_BENCH_TIMESTAMPS);
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < CLOCK_BENCH_TIMESTAMPS; i++)
+  {
+    sum += SysTime_unixMillis();
+  }
+  printf("unix ms   %8.1f ns per call\r\n",
+         (double)(BasePlatform_micros64() - startUs) * 1000.0 / CLOCK_BENCH_TIMESTAMPS);
+
+  return (benchWrong || sum == 0) ? 1 : 0;
+}
+/**         EOF         */
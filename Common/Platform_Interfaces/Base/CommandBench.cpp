@@ -0,0 +1,439 @@
+/**
+ * \file
+ * \brief Time from a cloud command to its acknowledgement through the tasks.
+ *
+ * Runs GW/src/main.cpp setup() and loop() against the Calypso simulator in
+ * a child process. Once the gateway is connected and has published its
+ * first telemetry, the simulated broker sends setLEDColor direct methods
+ * and a telemetrySendFrequency desired property. Each command is written
+ * to the UART as a recv event and acknowledged by the gateway with a
+ * publish, the method response or the reported property, after the
+ * background function has posted it to the cloud task. The methods are
+ * sent at random times while no telemetry is published, then each right
+ * when a telemetry message reaches the module, with the interval set to
+ * its minimum. The simulator prints the time from the recv event to the
+ * publish of the acknowledgement, the gateway prints the latency and the
+ * response time of the cloud task from its scheduler statistics.
+ *
+ * Usage: command_bench [commands]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "CalypsoSimulator.h"
+#include "PnP_Common_Device.h"
+#include "PnP_Device_Azure.h"
+#include "SensorSimulator.h"
+
+#define COMMAND_BENCH_DEFAULT_COMMANDS 10
+#define COMMAND_BENCH_MAX_COMMANDS 200
+#define COMMAND_BENCH_CONNECT_TIMEOUT_MS 60000
+/* Random time between two methods */
+#define COMMAND_BENCH_MIN_GAP_MS 100
+#define COMMAND_BENCH_MAX_GAP_MS 600
+/* Like BaseMain, the host CPU is given back between two passes */
+#define COMMAND_BENCH_PASS_US 100
+
+/* Control commands of the bench to the simulator */
+#define COMMAND_BENCH_METHOD 'm'
+#define COMMAND_BENCH_METHOD_ON_PUBLISH 'l'
+#define COMMAND_BENCH_PROPERTY 't'
+
+typedef enum
+{
+  commandBenchIdle,
+  commandBenchPublish,
+  commandBenchProperty,
+  commandBenchKinds
+} CommandBenchKind_t;
+
+typedef struct
+{
+  uint32_t count;
+  uint64_t totalUs;
+  uint64_t maxUs;
+} CommandBenchLatency_t;
+
+/* Defined by GW/src/main.cpp */
+void setup();
+void loop();
+extern SchedulerTask_t cloudTask;
+extern SchedulerTask_t publisherTask;
+extern "C" Deadband_Channel telemetryDeadband[telemetryChannels];
+
+static const char *kindNames[commandBenchKinds] = {"method idle", "method publish", "property"};
+
+/* Simulator side, in the child process */
+static uint64_t sentUs[COMMAND_BENCH_MAX_COMMANDS];
+static CommandBenchKind_t sentKind[COMMAND_BENCH_MAX_COMMANDS];
+static uint32_t nextRequestId = 0;
+static uint64_t propertySentUs = 0;
+static bool propertyPending = false;
+static bool methodOnPublish = false;
+static CommandBenchLatency_t latencies[commandBenchKinds];
+
+/* Gateway side */
+static SchedulerStats_t cloudStats[commandBenchKinds];
+static SchedulerStats_t publisherStats[commandBenchKinds];
+
+/**
+ * @brief  Send a cloud message as a recv event of the simulated Calypso.
+ *         The line is complete after its time on the UART.
+ * @param  nowUs Time the broker delivers the message
+ * @param  topic Topic of the message
+ * @param  payload JSON payload
+ * @retval None
+ */
+static void CommandBench_receive(uint64_t nowUs, const char *topic, const char *payload)
+{
+  static char line[CALYPSO_LINE_MAX_SIZE];
+  uint8_t encoded[128];
+  uint32_t encodedLength = 0;
+
+  Calypso_encodeBase64((uint8_t *)payload, strlen(payload), encoded, &encodedLength);
+  encoded[encodedLength] = '\0';
+  snprintf(line, sizeof(line), "+eventmqtt:recv,%s,QOS1,0,0,%u,%u,%s\r\n", topic,
+           (unsigned int)Calypso_DataFormat_Base64, (unsigned int)encodedLength, (char *)encoded);
+  CalypsoSim_schedule(nowUs + strlen(line) * CALYPSO_SIM_BYTE_US, "%s", line);
+}
+
+/**
+ * @brief  Send a setLEDColor direct method
+ * @param  nowUs Time the broker delivers the method
+ * @param  kind Load the method is sent under
+ * @retval None
+ */
+static void CommandBench_sendMethod(uint64_t nowUs, CommandBenchKind_t kind)
+{
+  char topic[64];
+
+  if (!CalypsoSim_isConnected() || (nextRequestId >= COMMAND_BENCH_MAX_COMMANDS))
+  {
+    return;
+  }
+  snprintf(topic, sizeof(topic), "$iothub/methods/POST/setLEDColor/?$rid=%lu", (unsigned long)nextRequestId);
+  sentUs[nextRequestId] = nowUs;
+  sentKind[nextRequestId] = kind;
+  nextRequestId++;
+  CommandBench_receive(nowUs, topic, "{\"red\":0,\"green\":128,\"blue\":255}");
+}
+
+/**
+ * @brief  Add the time from a command to its acknowledgement
+ * @param  kind Command
+ * @param  latencyUs Time
+ * @retval None
+ */
+static void CommandBench_addLatency(CommandBenchKind_t kind, uint64_t latencyUs)
+{
+  latencies[kind].count++;
+  latencies[kind].totalUs += latencyUs;
+  if (latencyUs > latencies[kind].maxUs)
+  {
+    latencies[kind].maxUs = latencyUs;
+  }
+}
+
+/**
+ * @brief  Command hook of the simulator: the acknowledgements and the
+ *         telemetry publish that triggers a method
+ * @param  line Command including CRLF
+ * @param  length Length of the command
+ * @param  doneUs Time the command is taken by the module
+ * @retval None
+ */
+static void CommandBench_onCommand(const char *line, size_t length, uint64_t doneUs)
+{
+  const char *rid = strstr(line, "$iothub/methods/res/");
+
+  (void)length;
+  if (0 != strncasecmp(line, "AT+mqttPublish=", 15))
+  {
+    return;
+  }
+  if ((rid != NULL) && ((rid = strstr(rid, "$rid=")) != NULL))
+  {
+    unsigned long id = strtoul(rid + 5, NULL, 10);
+
+    if (id < nextRequestId)
+    {
+      CommandBench_addLatency(sentKind[id], doneUs - sentUs[id]);
+    }
+  }
+  else if (propertyPending && (strstr(line, "$iothub/twin/PATCH/properties/reported/") != NULL))
+  {
+    propertyPending = false;
+    CommandBench_addLatency(commandBenchProperty, doneUs - propertySentUs);
+  }
+  else if (methodOnPublish && (strstr(line, "/messages/events/") != NULL))
+  {
+    methodOnPublish = false;
+    CommandBench_sendMethod(doneUs, commandBenchPublish);
+  }
+}
+
+/**
+ * @brief  Control hook of the simulator: the commands of the bench
+ * @param  control COMMAND_BENCH_METHOD, COMMAND_BENCH_METHOD_ON_PUBLISH or
+ *         COMMAND_BENCH_PROPERTY
+ * @retval None
+ */
+static void CommandBench_onControl(char control)
+{
+  char payload[64];
+
+  switch (control)
+  {
+  case COMMAND_BENCH_METHOD:
+    CommandBench_sendMethod(BasePlatform_micros64(), commandBenchIdle);
+    break;
+  case COMMAND_BENCH_METHOD_ON_PUBLISH:
+    methodOnPublish = true;
+    break;
+  case COMMAND_BENCH_PROPERTY:
+    snprintf(payload, sizeof(payload), "{\"telemetrySendFrequency\":%u,\"$version\":2}",
+             (unsigned int)MIN_TELEMETRY_SEND_INTERVAL);
+    propertySentUs = BasePlatform_micros64();
+    propertyPending = true;
+    CommandBench_receive(propertySentUs, "$iothub/twin/PATCH/properties/desired/?$version=2", payload);
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief  Simulated Calypso and broker, prints the acknowledgement times
+ *         once the gateway has closed the pipe
+ * @param  fdIn Commands from the gateway
+ * @param  fdOut Responses and events to the gateway
+ * @param  fdControl Control commands of the bench
+ * @retval None
+ */
+static void CommandBench_calypso(int fdIn, int fdOut, int fdControl)
+{
+  CalypsoSim_setHooks(CommandBench_onCommand, CommandBench_onControl);
+  CalypsoSim_run(fdIn, fdOut, fdControl);
+
+  printf("%-16s %6s %8s %12s %12s\r\n", "ack", "sent", "acked", "mean ms", "max ms");
+  for (uint8_t kind = 0; kind < commandBenchKinds; kind++)
+  {
+    uint32_t sent = 0;
+
+    for (uint32_t id = 0; id < nextRequestId; id++)
+    {
+      sent += (sentKind[id] == kind) ? 1 : 0;
+    }
+    if (kind == commandBenchProperty)
+    {
+      sent = latencies[kind].count + (propertyPending ? 1 : 0);
+    }
+    printf("%-16s %6lu %8lu %12.2f %12.2f\r\n", kindNames[kind], (unsigned long)sent,
+           (unsigned long)latencies[kind].count,
+           latencies[kind].count ? latencies[kind].totalUs / 1000.0 / latencies[kind].count : 0.0,
+           latencies[kind].maxUs / 1000.0);
+  }
+  fflush(stdout);
+}
+
+/**
+ * @brief  Run the main loop of the gateway
+ * @param  durationMs Time to run
+ * @retval None
+ */
+static void CommandBench_run(unsigned long durationMs)
+{
+  unsigned long startTime = millis();
+
+  while ((millis() - startTime) < durationMs)
+  {
+    loop();
+    delayMicroseconds(COMMAND_BENCH_PASS_US);
+  }
+}
+
+/**
+ * @brief  Run the main loop of the gateway until the next telemetry message
+ *         is acknowledged. The rising temperature is in every message, its
+ *         deadband is committed on the PUBACK.
+ * @param  timeoutMs Maximum time to run
+ * @retval true if the telemetry was published
+ */
+static bool CommandBench_runToPublish(unsigned long timeoutMs)
+{
+  unsigned long startTime = millis();
+  const Deadband_Channel *temperature = &telemetryDeadband[telemetryTemperature];
+  bool reported = temperature->reported;
+  unsigned long reportTime = temperature->lastReportTime;
+
+  while ((millis() - startTime) < timeoutMs)
+  {
+    loop();
+    delayMicroseconds(COMMAND_BENCH_PASS_US);
+    if ((temperature->reported != reported) || (temperature->lastReportTime != reportTime))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief  Send a control command to the simulator
+ * @param  control Control pipe
+ * @param  command Command
+ * @retval true if successful
+ */
+static bool CommandBench_control(int control, char command)
+{
+  return write(control, &command, 1) == 1;
+}
+
+/**
+ * @brief  Keep the scheduler statistics of a phase and start the next one
+ * @param  kind Phase
+ * @retval None
+ */
+static void CommandBench_endPhase(CommandBenchKind_t kind)
+{
+  cloudStats[kind] = cloudTask.stats;
+  publisherStats[kind] = publisherTask.stats;
+  Scheduler_resetStats();
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t commands = (argc > 1) ? (uint32_t)atol(argv[1]) : COMMAND_BENCH_DEFAULT_COMMANDS;
+  unsigned long intervalMs = MIN_TELEMETRY_SEND_INTERVAL * 1000UL;
+  const char factory[] = "fp";
+  SensorSim_waveform_t ramp;
+  int control[2];
+  int peerIn;
+  int peerOut;
+  bool failed = false;
+  pid_t child;
+
+  if ((commands == 0) || (commands > COMMAND_BENCH_MAX_COMMANDS / 2))
+  {
+    commands = COMMAND_BENCH_DEFAULT_COMMANDS;
+  }
+  if (!BaseSerial_openPipe(&Serial1, &peerIn, &peerOut) || (pipe(control) != 0))
+  {
+    fprintf(stderr, "Unable to open the Calypso pipes\r\n");
+    return 1;
+  }
+  fflush(stdout);
+  child = fork();
+  if (child < 0)
+  {
+    fprintf(stderr, "Unable to start the Calypso simulator\r\n");
+    return 1;
+  }
+  if (child == 0)
+  {
+    BaseSerial_close(&Serial1);
+    close(control[1]);
+    CommandBench_calypso(peerIn, peerOut, control[0]);
+    _exit(0);
+  }
+  close(peerIn);
+  close(peerOut);
+  close(control[0]);
+
+  /* The debug output of the gateway is dropped, the results go to stdout */
+  Serial.fdOut = open("/dev/null", O_WRONLY);
+  SensorSim_init();
+#ifdef ITDS_INT_PIN
+  SensorSim_setItdsIntPin(ITDS_INT_PIN);
+#endif
+  /* Rising temperature, each telemetry interval has a field beyond its deadband */
+  memset(&ramp, 0, sizeof(ramp));
+  ramp.offset = 2300;
+  ramp.slope = 10;
+  SensorSim_setWaveform(sensorSimTemperature, &ramp);
+
+  /* Module with the platform configuration only, the first boot uploads
+   * the web and certificate files */
+  if (write(control[1], factory, strlen(factory)) != (ssize_t)strlen(factory))
+  {
+    fprintf(stderr, "Unable to power on the Calypso simulator\r\n");
+    return 1;
+  }
+  setup();
+  if (!CommandBench_runToPublish(COMMAND_BENCH_CONNECT_TIMEOUT_MS))
+  {
+    fprintf(stderr, "The gateway did not connect\r\n");
+    failed = true;
+  }
+  Scheduler_resetStats();
+
+  /* Methods while no telemetry is published, before the first interval */
+  for (uint32_t i = 0; !failed && (i < commands); i++)
+  {
+    failed = !CommandBench_control(control[1], COMMAND_BENCH_METHOD);
+    CommandBench_run(COMMAND_BENCH_MIN_GAP_MS +
+                     Bench_random() % (COMMAND_BENCH_MAX_GAP_MS - COMMAND_BENCH_MIN_GAP_MS));
+  }
+  CommandBench_endPhase(commandBenchIdle);
+
+  /* Shortest telemetry interval, it applies from the next message */
+  failed = failed || !CommandBench_control(control[1], COMMAND_BENCH_PROPERTY);
+  if (!failed && !CommandBench_runToPublish(DEFAULT_TELEMETRY_SEND_INTEVAL * 1000UL + intervalMs))
+  {
+    fprintf(stderr, "No telemetry after the property update\r\n");
+    failed = true;
+  }
+  CommandBench_endPhase(commandBenchProperty);
+
+  /* Methods that reach the gateway while it publishes the telemetry */
+  for (uint32_t i = 0; !failed && (i < commands); i++)
+  {
+    failed = !CommandBench_control(control[1], COMMAND_BENCH_METHOD_ON_PUBLISH) ||
+             !CommandBench_runToPublish(intervalMs * 2);
+    CommandBench_run(intervalMs / 2);
+  }
+  CommandBench_endPhase(commandBenchPublish);
+
+  /* The simulator prints its results once the pipe is closed */
+  BaseSerial_close(&Serial1);
+  close(control[1]);
+  waitpid(child, NULL, 0);
+
+  printf("%-16s %6s %12s %12s %12s %12s\r\n", "cloud task", "events", "mean lat us", "max lat us",
+         "max resp us", "publish us");
+  for (uint8_t kind = 0; kind < commandBenchKinds; kind++)
+  {
+    const SchedulerStats_t *stats = &cloudStats[kind];
+
+    printf("%-16s %6lu %12lu %12lu %12lu %12lu\r\n", kindNames[kind], (unsigned long)stats->events,
+           (unsigned long)(stats->events ? stats->totalLatencyUs / stats->events : 0),
+           (unsigned long)stats->maxLatencyUs, (unsigned long)stats->maxResponseUs,
+           (unsigned long)publisherStats[kind].maxRunUs);
+  }
+  return failed ? 1 : 0;
+}
+/**         EOF         */
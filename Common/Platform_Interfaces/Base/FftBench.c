@@ -0,0 +1,253 @@
+/**
+ * \file
+ * \brief Accuracy and cost of the fixed-point FFT in fft.c.
+ *
+ * Runs FFT_prepareBlock and FFT_realMagnitude on single tones at every bin,
+ * two tones, white noise and on blocks from a few counts up to the full
+ * int16 range, for every supported length. Each magnitude spectrum is
+ * compared with a double precision DFT, once of the prepared block (the
+ * error of the transform) and once of the input block with the mean removed,
+ * the same scaling and an exact Hann window (the error of the whole chain).
+ * Single tones must also be found by FFT_findPeaks at their bin. Exits with
+ * an error if an error is above its bound or a tone is missed.
+ *
+ * Usage: fft_bench [random blocks per length]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <math.h>
+
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "fft.h"
+
+#define FFT_BENCH_DEFAULT_BLOCKS 1000
+#define FFT_BENCH_MIN_POINTS 16
+/* Prepared blocks stay below 2^14, the magnitudes are scaled by 1/points */
+#define FFT_BENCH_FULL_SCALE 16384.0
+/* Error bounds in magnitude LSB: the truncation of every butterfly stage
+ * and of the split adds up to one LSB per doubling of the length, the
+ * rounding of the scaled block and the Q15 window two more */
+#define FFT_BENCH_MAX_TRANSFORM_ERROR(log2Points) ((double)(log2Points))
+#define FFT_BENCH_MAX_ERROR(log2Points) ((double)(log2Points) + 2.0)
+
+/* Defined by GW/src/main.cpp in the application */
+char displayText[150];
+
+typedef struct
+{
+  double transform; /* Largest error of FFT_realMagnitude, LSB */
+  double chain;     /* Largest error of the prepared block and the transform, LSB */
+  uint32_t blocks;
+  uint32_t missedTones;
+} FftBench_result_t;
+
+/**
+ * @brief  Magnitude spectrum by a double precision DFT, scaled like
+ *         FFT_realMagnitude
+ * @param  block Input block
+ * @param  points Number of samples
+ * @param  magnitude Returns points/2 bins
+ * @retval None
+ */
+static void FftBench_dft(const double *block, uint16_t points, double *magnitude)
+{
+  for (uint16_t k = 0; k < points / 2; k++)
+  {
+    double re = 0;
+    double im = 0;
+
+    for (uint16_t n = 0; n < points; n++)
+    {
+      double angle = 2.0 * M_PI * k * n / points;
+
+      re += block[n] * cos(angle);
+      im -= block[n] * sin(angle);
+    }
+    magnitude[k] = sqrt(re * re + im * im) / points;
+  }
+}
+
+/**
+ * @brief  Run one block through the FFT and both references
+ * @param  samples Input block
+ * @param  points Number of samples
+ * @param  toneBin Bin of a single tone, 0 if none
+ * @param  result Updated with the errors
+ * @retval None
+ */
+static void FftBench_check(const int16_t *samples, uint16_t points, uint16_t toneBin, FftBench_result_t *result)
+{
+  int16_t block[FFT_MAX_POINTS];
+  uint16_t magnitude[FFT_MAX_POINTS / 2];
+  double reference[FFT_MAX_POINTS];
+  double prepared[FFT_MAX_POINTS / 2];
+  double chain[FFT_MAX_POINTS / 2];
+  double mean = 0;
+  int8_t shift;
+
+  memcpy(block, samples, points * sizeof(int16_t));
+  FFT_prepareBlock(block, points, &shift);
+
+  for (uint16_t n = 0; n < points; n++)
+  {
+    reference[n] = block[n];
+  }
+  FftBench_dft(reference, points, prepared);
+
+  for (uint16_t n = 0; n < points; n++)
+  {
+    mean += samples[n];
+  }
+  mean /= points;
+  for (uint16_t n = 0; n < points; n++)
+  {
+    reference[n] = (samples[n] - mean) * ldexp(1.0, shift) * (1.0 - cos(2.0 * M_PI * n / points)) / 2.0;
+  }
+  FftBench_dft(reference, points, chain);
+
+  FFT_realMagnitude(block, points, magnitude);
+  for (uint16_t k = 0; k < points / 2; k++)
+  {
+    result->transform = fmax(result->transform, fabs(magnitude[k] - prepared[k]));
+    result->chain = fmax(result->chain, fabs(magnitude[k] - chain[k]));
+  }
+  if (toneBin != 0)
+  {
+    FFT_Peak peak;
+
+    if (FFT_findPeaks(magnitude, points / 2, &peak, 1) != 1 || peak.bin != toneBin)
+    {
+      result->missedTones++;
+    }
+  }
+  result->blocks++;
+}
+
+/**
+ * @brief  Check the test signals at one length
+ * @param  points Number of samples
+ * @param  blocks Random blocks
+ * @param  result Returns the errors
+ * @retval None
+ */
+static void FftBench_length(uint16_t points, uint32_t blocks, FftBench_result_t *result)
+{
+  static const int16_t amplitudes[] = {3, 100, 2000, 16000, 32000};
+  int16_t samples[FFT_MAX_POINTS];
+
+  memset(result, 0, sizeof(*result));
+
+  /* Single tones on a 1 g offset, at every bin and amplitude */
+  for (uint8_t a = 0; a < sizeof(amplitudes) / sizeof(amplitudes[0]); a++)
+  {
+    for (uint16_t bin = 1; bin < points / 2; bin++)
+    {
+      int32_t offset = (amplitudes[a] < 32000) ? 1000 : 0;
+
+      for (uint16_t n = 0; n < points; n++)
+      {
+        samples[n] = (int16_t)lround(offset + amplitudes[a] * sin(2.0 * M_PI * bin * n / points + 0.3));
+      }
+      FftBench_check(samples, points, bin, result);
+    }
+  }
+
+  /* Two tones and white noise of random amplitude */
+  for (uint32_t i = 0; i < blocks; i++)
+  {
+    int32_t amplitude = 1 + (int32_t)(Bench_random() % 16000);
+    uint16_t bin1 = (uint16_t)(1 + Bench_random() % (points / 2 - 1));
+    uint16_t bin2 = (uint16_t)(1 + Bench_random() % (points / 2 - 1));
+
+    for (uint16_t n = 0; n < points; n++)
+    {
+      samples[n] = (int16_t)lround(amplitude * (0.6 * sin(2.0 * M_PI * bin1 * n / points) +
+                                                0.4 * cos(2.0 * M_PI * bin2 * n / points)));
+    }
+    FftBench_check(samples, points, 0, result);
+
+    for (uint16_t n = 0; n < points; n++)
+    {
+      samples[n] = (int16_t)((int32_t)(Bench_random() % (2 * amplitude + 1)) - amplitude);
+    }
+    FftBench_check(samples, points, 0, result);
+  }
+}
+
+/**
+ * @brief  Time the prepared block and transform of random blocks
+ * @param  points Number of samples
+ * @retval us per block
+ */
+static double FftBench_measure(uint16_t points)
+{
+  const uint32_t count = 20000;
+  int16_t samples[FFT_MAX_POINTS];
+  int16_t block[FFT_MAX_POINTS];
+  uint16_t magnitude[FFT_MAX_POINTS / 2];
+  volatile uint32_t sum = 0;
+  uint64_t startUs;
+  int8_t shift;
+
+  for (uint16_t n = 0; n < points; n++)
+  {
+    samples[n] = (int16_t)(Bench_random() % 4001) - 2000;
+  }
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < count; i++)
+  {
+    memcpy(block, samples, points * sizeof(int16_t));
+    FFT_prepareBlock(block, points, &shift);
+    FFT_realMagnitude(block, points, magnitude);
+    sum += magnitude[1];
+  }
+  return (double)(BasePlatform_micros64() - startUs) / count;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t blocks = (argc > 1) ? (uint32_t)atol(argv[1]) : FFT_BENCH_DEFAULT_BLOCKS;
+  bool failed = false;
+  uint8_t log2Points = 4;
+
+  printf("points   blocks  transform error    chain error  bounds  missed  us per block\r\n");
+  for (uint16_t points = FFT_BENCH_MIN_POINTS; points <= FFT_MAX_POINTS; points <<= 1, log2Points++)
+  {
+    FftBench_result_t result;
+
+    FftBench_length(points, blocks, &result);
+    printf("%6u %8lu %6.2f LSB %5.3f %% %6.2f LSB %5.3f %% %3.0f/%-3.0f %7lu %13.2f\r\n", points,
+           (unsigned long)result.blocks, result.transform, 100.0 * result.transform / FFT_BENCH_FULL_SCALE,
+           result.chain, 100.0 * result.chain / FFT_BENCH_FULL_SCALE, FFT_BENCH_MAX_TRANSFORM_ERROR(log2Points),
+           FFT_BENCH_MAX_ERROR(log2Points), (unsigned long)result.missedTones, FftBench_measure(points));
+    if (result.transform > FFT_BENCH_MAX_TRANSFORM_ERROR(log2Points) || result.chain > FFT_BENCH_MAX_ERROR(log2Points) ||
+        result.missedTones != 0)
+    {
+      failed = true;
+    }
+  }
+  printf("Errors in LSB of the magnitude and in %% of the %.0f full scale of the prepared block\r\n",
+         FFT_BENCH_FULL_SCALE);
+  return failed ? 1 : 0;
+}
+/**         EOF         */
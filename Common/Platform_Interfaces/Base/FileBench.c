@@ -0,0 +1,623 @@
+/**
+ * \file
+ * \brief Throughput of the Calypso file transfers.
+ *
+ * Writes and reads a file through the streaming file functions of
+ * calypsoBoard against a simulated Calypso in a child process, which models
+ * the UART, the handling of each command and the flash writes. The data
+ * is random, with NUL bytes and line ends.
+ *
+ * Runs: the 512-byte base64 chunks of the previous file functions, the
+ * stream with the data given in parts of odd sizes, Calypso_writeBigFile
+ * which reads the file back to check its CRC, and a file the simulator
+ * corrupts to show that the check fails. Prints the KB/s of the write and
+ * of the read of each run.
+ *
+ * Usage: file_bench [KB]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <poll.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "calypsoBoard.h"
+#include "checksum.h"
+
+#define FILE_BENCH_DEFAULT_KB 64
+#define FILE_BENCH_MAX_KB 1024
+/* Parts given to Calypso_fileWrite and Calypso_fileRead, not a divisor of
+ * the chunks */
+#define FILE_BENCH_PART_SIZE 1000
+
+/* Simulated Calypso: 921600 baud UART like Device_init, AT command
+ * handling, flash writes of the file system */
+#define FILE_BENCH_BYTE_US 11
+#define FILE_BENCH_PROCESS_US 1000
+#define FILE_BENCH_FILE_CREATE_US 15000
+#define FILE_BENCH_FILE_WRITE_US 6000
+#define FILE_BENCH_FLASH_BYTE_US 2
+#define FILE_BENCH_MAX_PENDING 4
+#define FILE_BENCH_MAX_FILES 8
+#define FILE_BENCH_FILE_NAME_SIZE 64
+/* Files with this in their name get one bit flipped by the simulator */
+#define FILE_BENCH_CORRUPT "corrupt"
+
+/* Request functions of calypsoBoard.c, not in its header, used for the
+ * chunks of the previous file functions */
+bool ATFile_open(CALYPSO *self, const char *fileName, uint32_t options, uint32_t fileSize, uint32_t *fileID,
+                 uint32_t *secureToken);
+bool ATFile_close(CALYPSO *self, uint32_t fileID, char *certFileName, char *signature);
+bool ATFile_write(CALYPSO *self, uint32_t fileID, uint16_t offset, Calypso_DataFormat_t format, bool encodeToBase64,
+                  uint16_t bytestoWrite, char *data, uint16_t *writtenBytes);
+bool ATFile_read(CALYPSO *self, uint32_t fileID, uint32_t offset, Calypso_DataFormat_t format, uint16_t bytesToRead,
+                 Calypso_DataFormat_t *pOutFormat, uint16_t *byteRead, char *data);
+
+typedef struct
+{
+  uint64_t dueUs;
+  char *line;
+} FileBenchOutput_t;
+
+typedef struct
+{
+  char name[FILE_BENCH_FILE_NAME_SIZE];
+  uint8_t *data;
+  size_t size;
+  size_t maxSize;
+  bool used;
+} FileBenchFile_t;
+
+typedef struct
+{
+  uint64_t busyUntilUs;
+  FileBenchOutput_t pending[FILE_BENCH_MAX_PENDING];
+  size_t count;
+  FileBenchFile_t files[FILE_BENCH_MAX_FILES];
+  int openFile; /* Index of the open file, -1 if none */
+} FileBenchModule_t;
+
+typedef struct
+{
+  uint64_t writeUs;
+  uint64_t readUs;
+  bool ok;
+} FileBenchResult_t;
+
+static FileBenchModule_t module;
+
+/**
+ * @brief  Schedule a line sent by the simulated Calypso, in time order
+ * @param  dueUs Time to send the line
+ * @param  format Line including CRLF, printf format
+ * @retval None
+ */
+static void FileBench_schedule(uint64_t dueUs, const char *format, ...)
+{
+  size_t i = module.count;
+  va_list args;
+  char *line;
+
+  if (module.count >= FILE_BENCH_MAX_PENDING)
+  {
+    return;
+  }
+  line = malloc(CALYPSO_LINE_MAX_SIZE + 64);
+  if (line == NULL)
+  {
+    return;
+  }
+  va_start(args, format);
+  vsnprintf(line, CALYPSO_LINE_MAX_SIZE + 64, format, args);
+  va_end(args);
+  while (i > 0 && module.pending[i - 1].dueUs > dueUs)
+  {
+    module.pending[i] = module.pending[i - 1];
+    i--;
+  }
+  module.pending[i].dueUs = dueUs;
+  module.pending[i].line = line;
+  module.count++;
+}
+
+/**
+ * @brief  Find a file of the simulated Calypso
+ * @param  name File name
+ * @retval Index of the file, -1 if it does not exist
+ */
+static int FileBench_findFile(const char *name)
+{
+  for (int i = 0; i < FILE_BENCH_MAX_FILES; i++)
+  {
+    if (module.files[i].used && (0 == strcmp(module.files[i].name, name)))
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief  Create or truncate a file of the simulated Calypso
+ * @param  name File name
+ * @param  maxSize Size allocated to the file
+ * @retval Index of the file, -1 if the file system is full
+ */
+static int FileBench_createFile(const char *name, size_t maxSize)
+{
+  int index = FileBench_findFile(name);
+
+  for (int i = 0; (index < 0) && (i < FILE_BENCH_MAX_FILES); i++)
+  {
+    if (!module.files[i].used)
+    {
+      index = i;
+    }
+  }
+  if (index >= 0)
+  {
+    FileBenchFile_t *file = &module.files[index];
+
+    free(file->data);
+    file->data = calloc(1, maxSize);
+    strncpy(file->name, name, FILE_BENCH_FILE_NAME_SIZE - 1);
+    file->size = 0;
+    file->maxSize = maxSize;
+    file->used = (file->data != NULL);
+  }
+  return index;
+}
+
+/**
+ * @brief  Handle a file command of the simulated Calypso, the arguments
+ *         follow the '=' of the command
+ * @param  line Command including CRLF
+ * @param  done Time the command is handled
+ * @retval Time the response is sent
+ */
+static uint64_t FileBench_command(const char *line, uint64_t done)
+{
+  const char *arguments = strchr(line, '=');
+  char name[FILE_BENCH_FILE_NAME_SIZE] = "";
+  unsigned int id, offset, format, count;
+  int index;
+
+  if (arguments != NULL)
+  {
+    size_t length = strcspn(++arguments, ",\r\n");
+
+    if (length < FILE_BENCH_FILE_NAME_SIZE)
+    {
+      memcpy(name, arguments, length);
+      name[length] = '\0';
+    }
+  }
+  if (0 == strncasecmp(line, "AT+fileGetInfo=", 15))
+  {
+    index = FileBench_findFile(name);
+    if (index < 0)
+    {
+      FileBench_schedule(done, "Error:-11\r\n");
+      return done;
+    }
+    FileBench_schedule(done, "+filegetinfo:0,%u,%u,0,0,0\r\nOK\r\n", (unsigned int)module.files[index].size,
+                       (unsigned int)module.files[index].maxSize);
+  }
+  else if (0 == strncasecmp(line, "AT+fileOpen=", 12))
+  {
+    const char *size = strrchr(line, ',');
+
+    index = FileBench_findFile(name);
+    if (strstr(line, "CREATE") != NULL)
+    {
+      if ((index >= 0) && (strstr(line, "OVERWRITE") == NULL))
+      {
+        /* Exists already */
+        FileBench_schedule(done, "Error:-10264\r\n");
+        return done;
+      }
+      index = FileBench_createFile(name, (size != NULL) ? strtoul(size + 1, NULL, 10) : 0);
+      done += FILE_BENCH_FILE_CREATE_US;
+    }
+    if (index < 0)
+    {
+      FileBench_schedule(done, "Error:-11\r\n");
+      return done;
+    }
+    module.openFile = index;
+    FileBench_schedule(done, "+fileopen:%d,0\r\nOK\r\n", index + 1);
+  }
+  else if (0 == strncasecmp(line, "AT+fileRead=", 12) &&
+           (4 == sscanf(line + 12, "%u,%u,%u,%u", &id, &offset, &format, &count)) && (module.openFile >= 0))
+  {
+    static uint8_t encoded[CALYPSO_LINE_MAX_SIZE];
+    FileBenchFile_t *file = &module.files[module.openFile];
+    uint32_t encodedLength = 0;
+
+    if (offset > file->size)
+    {
+      offset = file->size;
+    }
+    if (count > file->size - offset)
+    {
+      count = file->size - offset;
+    }
+    if ((count + 2) / 3 * 4 >= sizeof(encoded))
+    {
+      FileBench_schedule(done, "Error:-1\r\n");
+      return done;
+    }
+    Calypso_encodeBase64(&file->data[offset], count, encoded, &encodedLength);
+    encoded[encodedLength] = '\0';
+    done += (encodedLength + 20) * FILE_BENCH_BYTE_US;
+    FileBench_schedule(done, "+fileread:%u,%u,%s\r\nOK\r\n", (unsigned int)Calypso_DataFormat_Base64,
+                       (unsigned int)encodedLength, (char *)encoded);
+  }
+  else if (0 == strncasecmp(line, "AT+fileWrite=", 13) &&
+           (4 == sscanf(line + 13, "%u,%u,%u,%u", &id, &offset, &format, &count)) && (module.openFile >= 0))
+  {
+    static uint8_t decoded[CALYPSO_LINE_MAX_SIZE];
+    FileBenchFile_t *file = &module.files[module.openFile];
+    const char *data = line + 13;
+    uint32_t decodedLength = count;
+
+    for (int commas = 0; commas < 4; data++)
+    {
+      commas += (*data == ',') ? 1 : 0;
+    }
+    if (format == Calypso_DataFormat_Base64)
+    {
+      Calypso_decodeBase64((uint8_t *)data, count, decoded, &decodedLength);
+    }
+    else
+    {
+      memcpy(decoded, data, count);
+    }
+    if (offset + decodedLength > file->maxSize)
+    {
+      FileBench_schedule(done, "Error:-1\r\n");
+      return done;
+    }
+    memcpy(&file->data[offset], decoded, decodedLength);
+    if ((offset == 0) && (strstr(file->name, FILE_BENCH_CORRUPT) != NULL))
+    {
+      file->data[decodedLength / 2] ^= 0x10;
+    }
+    if (offset + decodedLength > file->size)
+    {
+      file->size = offset + decodedLength;
+    }
+    done += FILE_BENCH_FILE_WRITE_US + decodedLength * FILE_BENCH_FLASH_BYTE_US;
+    FileBench_schedule(done, "+filewrite:%u\r\nOK\r\n", (unsigned int)decodedLength);
+  }
+  else if (0 == strncasecmp(line, "AT+fileClose=", 13))
+  {
+    module.openFile = -1;
+    FileBench_schedule(done, "OK\r\n");
+  }
+  else if (0 == strncasecmp(line, "AT+fileDel=", 11))
+  {
+    index = FileBench_findFile(name);
+    if (index < 0)
+    {
+      FileBench_schedule(done, "Error:-11\r\n");
+      return done;
+    }
+    module.files[index].used = false;
+    FileBench_schedule(done, "OK\r\n");
+  }
+  else
+  {
+    FileBench_schedule(done, "Error:-1\r\n");
+  }
+  return done;
+}
+
+/**
+ * @brief  Check if a command is complete. The data of a binary file write
+ *         may contain line ends, its length is given before it.
+ * @param  line Received bytes
+ * @param  length Number of received bytes
+ * @retval true if the command is complete
+ */
+static bool FileBench_isComplete(const char *line, size_t length)
+{
+  const char *data = line + 13;
+  unsigned int id, offset, format, count;
+  int commas = 0;
+
+  if ((length < 2) || (line[length - 1] != '\n'))
+  {
+    return false;
+  }
+  if ((0 != strncasecmp(line, "AT+fileWrite=", 13)) ||
+      (4 != sscanf(data, "%u,%u,%u,%u", &id, &offset, &format, &count)))
+  {
+    return true;
+  }
+  while ((commas < 4) && (data < line + length))
+  {
+    commas += (*data++ == ',') ? 1 : 0;
+  }
+  return (size_t)(line + length - data) >= count + 2;
+}
+
+/**
+ * @brief  Simulated Calypso, runs until the gateway side closes the pipe
+ * @param  fdIn Commands from the gateway
+ * @param  fdOut Responses to the gateway
+ * @retval None
+ */
+static void FileBench_calypso(int fdIn, int fdOut)
+{
+  static char line[CALYPSO_LINE_MAX_SIZE * 2];
+  size_t length = 0;
+
+  module.openFile = -1;
+  for (;;)
+  {
+    uint64_t now = BasePlatform_micros64();
+    struct pollfd fd = {fdIn, POLLIN, 0};
+    int timeoutMs = -1;
+    char c;
+
+    while (module.count > 0 && module.pending[0].dueUs <= now)
+    {
+      if (write(fdOut, module.pending[0].line, strlen(module.pending[0].line)) < 0)
+      {
+        return;
+      }
+      free(module.pending[0].line);
+      memmove(&module.pending[0], &module.pending[1], (module.count - 1) * sizeof(module.pending[0]));
+      module.count--;
+    }
+    if (module.count > 0)
+    {
+      timeoutMs = (int)((module.pending[0].dueUs - now + 999) / 1000);
+    }
+    if (poll(&fd, 1, timeoutMs) <= 0)
+    {
+      continue;
+    }
+    if (read(fdIn, &c, 1) != 1)
+    {
+      return;
+    }
+    if (length < sizeof(line) - 1)
+    {
+      line[length++] = c;
+    }
+    line[length] = '\0';
+    if (FileBench_isComplete(line, length))
+    {
+      /* Commands are handled one after the other, the answer follows the
+       * UART transfer of the command */
+      now = BasePlatform_micros64();
+      module.busyUntilUs = FileBench_command(line, ((module.busyUntilUs > now) ? module.busyUntilUs : now) +
+                                                       length * FILE_BENCH_BYTE_US + FILE_BENCH_PROCESS_US);
+      length = 0;
+    }
+  }
+}
+
+/**
+ * @brief  Write and read a file in the 512-byte base64 chunks of the
+ *         previous Calypso_writeBigFile and Calypso_readFile, including the
+ *         probes before and after the write
+ * @param  calypso Gateway side of the simulated Calypso
+ * @param  path File name
+ * @param  data File content
+ * @param  size Size of the file
+ * @param  result Time of the write and of the read
+ * @retval None
+ */
+static void FileBench_runChunks(CALYPSO *calypso, const char *path, const uint8_t *data, uint32_t size,
+                                FileBenchResult_t *result)
+{
+  static char chunk[CALYPSO_LINE_MAX_SIZE];
+  uint8_t *copy = malloc(size + 1);
+  Calypso_DataFormat_t format;
+  uint32_t fileID;
+  uint32_t sToken;
+  uint64_t startUs = BasePlatform_micros64();
+  uint16_t length;
+  bool ok = (copy != NULL) && !Calypso_fileExists(calypso, path) &&
+            ATFile_open(calypso, path, ATFILE_OPEN_CREATE | ATFILE_OPEN_OVERWRITE, size, &fileID, &sToken);
+
+  for (uint32_t offset = 0; ok && (offset < size); offset += CALYPSO_FILE_WRITE_SIZE_MAX)
+  {
+    uint16_t count = (size - offset > CALYPSO_FILE_WRITE_SIZE_MAX) ? CALYPSO_FILE_WRITE_SIZE_MAX : size - offset;
+
+    memcpy(chunk, &data[offset], count);
+    ok = ATFile_write(calypso, fileID, offset, Calypso_DataFormat_Base64, true, count, chunk, &length);
+  }
+  ok = ATFile_close(calypso, fileID, NULL, NULL) && ok;
+  Calypso_fileExists(calypso, path);
+  result->writeUs = BasePlatform_micros64() - startUs;
+
+  startUs = BasePlatform_micros64();
+  ok = ok && ATFile_open(calypso, path, ATFILE_OPEN_READ, 0, &fileID, &sToken);
+  for (uint32_t offset = 0; ok && (offset < size); offset += CALYPSO_FILE_WRITE_SIZE_MAX)
+  {
+    uint16_t count = (size - offset > CALYPSO_FILE_WRITE_SIZE_MAX) ? CALYPSO_FILE_WRITE_SIZE_MAX : size - offset;
+    uint32_t decoded = 0;
+
+    ok = ATFile_read(calypso, fileID, offset, Calypso_DataFormat_Base64, count, &format, &length, chunk) &&
+         Calypso_decodeBase64((uint8_t *)chunk, length, &copy[offset], &decoded) && (decoded == count);
+  }
+  ok = ATFile_close(calypso, fileID, NULL, NULL) && ok;
+  result->readUs = BasePlatform_micros64() - startUs;
+  result->ok = ok && (0 == memcmp(copy, data, size));
+  free(copy);
+}
+
+/**
+ * @brief  Write and read a file through the stream, in parts of
+ *         FILE_BENCH_PART_SIZE bytes
+ * @param  calypso Gateway side of the simulated Calypso
+ * @param  path File name
+ * @param  data File content
+ * @param  size Size of the file
+ * @param  result Time of the write and of the read
+ * @retval None
+ */
+static void FileBench_runStream(CALYPSO *calypso, const char *path, const uint8_t *data, uint32_t size,
+                                FileBenchResult_t *result)
+{
+  static Calypso_File_t file;
+  uint8_t *copy = malloc(size);
+  uint64_t startUs = BasePlatform_micros64();
+  uint32_t crc;
+  uint32_t bytesRead = 0;
+  bool ok = (copy != NULL) && Calypso_fileOpenWrite(calypso, &file, path, size, true);
+
+  for (uint32_t offset = 0; ok && (offset < size); offset += FILE_BENCH_PART_SIZE)
+  {
+    ok = Calypso_fileWrite(&file, &data[offset], (size - offset > FILE_BENCH_PART_SIZE) ? FILE_BENCH_PART_SIZE
+                                                                                         : size - offset);
+  }
+  ok = ok && Calypso_fileClose(&file);
+  crc = file.crc;
+  result->writeUs = BasePlatform_micros64() - startUs;
+
+  startUs = BasePlatform_micros64();
+  ok = ok && Calypso_fileOpenRead(calypso, &file, path);
+  for (uint32_t offset = 0; ok && (offset < size); offset += bytesRead)
+  {
+    ok = Calypso_fileRead(&file, &copy[offset], FILE_BENCH_PART_SIZE, &bytesRead) && (bytesRead > 0);
+  }
+  ok = ok && Calypso_fileClose(&file);
+  result->readUs = BasePlatform_micros64() - startUs;
+  result->ok = ok && (file.crc == crc) && (crc == Checksum_crc32(CHECKSUM_CRC32_INIT, data, size)) &&
+               (0 == memcmp(copy, data, size));
+  free(copy);
+}
+
+/**
+ * @brief  Print the throughput of a run
+ * @param  name Run name
+ * @param  size Size of the file
+ * @param  result Time of the write and of the read, 0 if not part of the run
+ * @param  check Result of the run
+ * @retval None
+ */
+static void FileBench_print(const char *name, uint32_t size, const FileBenchResult_t *result, const char *check)
+{
+  printf("%-16s %10lu %10.1f %10lu %10.1f  %s\r\n", name, (unsigned long)(result->writeUs / 1000),
+         size * 1e6 / 1024 / (double)result->writeUs, (unsigned long)(result->readUs / 1000),
+         (result->readUs > 0) ? size * 1e6 / 1024 / (double)result->readUs : 0.0, check);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t kb = (argc > 1) ? (uint32_t)atol(argv[1]) : FILE_BENCH_DEFAULT_KB;
+  FileBenchResult_t result;
+  CalypsoSettings settings;
+  CALYPSO *calypso;
+  uint8_t *data;
+  uint32_t size;
+  uint64_t startUs;
+  bool failed = false;
+  int peerIn;
+  int peerOut;
+  pid_t child;
+
+  if ((kb == 0) || (kb > FILE_BENCH_MAX_KB))
+  {
+    kb = FILE_BENCH_DEFAULT_KB;
+  }
+  size = kb * 1024;
+  data = malloc(size);
+  if (data == NULL)
+  {
+    return 1;
+  }
+  for (uint32_t i = 0; i < size; i++)
+  {
+    /* Random bytes with NUL and line ends among them */
+    uint32_t r = Bench_random();
+
+    data[i] = ((r >> 8) % 16 == 0) ? "\0\r\n"[r % 3] : (uint8_t)r;
+  }
+
+  if (!BaseSerial_openPipe(&Serial1, &peerIn, &peerOut))
+  {
+    fprintf(stderr, "Unable to open the Calypso pipe\r\n");
+    return 1;
+  }
+  child = fork();
+  if (child < 0)
+  {
+    fprintf(stderr, "Unable to start the Calypso simulator\r\n");
+    return 1;
+  }
+  if (child == 0)
+  {
+    BaseSerial_close(&Serial1);
+    FileBench_calypso(peerIn, peerOut);
+    _exit(0);
+  }
+  close(peerIn);
+  close(peerOut);
+
+  /* The debug log is not initialized, the command traces are dropped */
+  memset(&settings, 0, sizeof(settings));
+  calypso = Calypso_Create(SSerial_create(&Serial), HSerial_create(&Serial1), &settings);
+
+  printf("%lu KB file, write chunk %d bytes binary, read chunk %d bytes base64\r\n", (unsigned long)kb,
+         CALYPSO_FILE_WRITE_CHUNK, CALYPSO_FILE_READ_CHUNK);
+  printf("%-16s %10s %10s %10s %10s  %s\r\n", "run", "write ms", "write KB/s", "read ms", "read KB/s", "check");
+
+  FileBench_runChunks(calypso, "user/bench512", data, size, &result);
+  FileBench_print("512 base64", size, &result, result.ok ? "ok" : "FAILED");
+  failed |= !result.ok;
+
+  FileBench_runStream(calypso, "user/benchstream", data, size, &result);
+  FileBench_print("stream", size, &result, result.ok ? "ok" : "FAILED");
+  failed |= !result.ok;
+
+  /* The read back is part of the write */
+  startUs = BasePlatform_micros64();
+  result.ok = Calypso_writeBigFile(calypso, "user/benchbig", (const char *)data, size);
+  result.writeUs = BasePlatform_micros64() - startUs;
+  result.readUs = 0;
+  FileBench_print("verified write", size, &result, result.ok ? "ok" : "FAILED");
+  failed |= !result.ok;
+
+  startUs = BasePlatform_micros64();
+  result.ok = Calypso_writeBigFile(calypso, "user/bench" FILE_BENCH_CORRUPT, (const char *)data, size);
+  result.writeUs = BasePlatform_micros64() - startUs;
+  FileBench_print("corrupted", size, &result, result.ok ? "NOT DETECTED" : "detected");
+  failed |= result.ok;
+
+  BaseSerial_close(&Serial1);
+  kill(child, SIGTERM);
+  waitpid(child, NULL, 0);
+  Calypso_Destroy(calypso);
+  free(data);
+  return failed ? 1 : 0;
+}
+/**         EOF         */
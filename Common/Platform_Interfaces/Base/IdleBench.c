@@ -0,0 +1,260 @@
+/**
+ * \file
+ * \brief Duty cycle and estimated current of the idle modes.
+ *
+ * Runs the gateway tasks on the scheduler with the host clock moved
+ * forward by the estimated run time of each task on the SAMD21 and by the
+ * sleeps of the idle manager. For each workload and the sleep modes it may
+ * use on the gateway it prints
+ * the share of time the CPU is awake, the wake-ups per second and the
+ * average current of the MCU and of the Calypso with each WLAN power
+ * policy. The currents are typical values, to be replaced by measurements
+ * of the board; the sensors and the display are not included.
+ *
+ * Usage: idle_bench [telemetry interval s] [simulated s] [battery mAh]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "idle.h"
+#include "scheduler.h"
+
+#define IDLE_BENCH_DEFAULT_INTERVAL_S 30
+#define IDLE_BENCH_DEFAULT_RUN_S 600
+#define IDLE_BENCH_DEFAULT_BATTERY_MAH 1200
+
+/* Estimated run time on the SAMD21 at 48 MHz */
+#define IDLE_BENCH_PASS_US 10        /* Scheduler pass and polled drivers, no task ready */
+#define IDLE_BENCH_SAMPLER_US 250    /* Motion event and FIFO checks */
+#define IDLE_BENCH_CONNECTIVITY_US 20
+#define IDLE_BENCH_PUBLISH_US 150000 /* AT+mqttPublish, waiting for the answer */
+
+/* Typical currents in mA at 3.3 V */
+#define IDLE_BENCH_MCU_RUN_MA 6.5f
+#define IDLE_BENCH_MCU_SLEEP_MA 3.1f
+#define IDLE_BENCH_MCU_STANDBY_MA 0.004f
+#define IDLE_BENCH_PUBLISH_MAS 4.5f /* Calypso transmission per message, mA*s */
+
+typedef struct
+{
+  const char *name;
+  float currentMa; /* Connected to the access point, no traffic */
+} IdleBenchPolicy_t;
+
+static const IdleBenchPolicy_t policies[] = {
+    {"always_on", 59.0f},
+    {"normal", 1.1f},
+    {"low_power", 0.7f},
+    {"long_sleep", 0.25f},
+};
+
+#define IDLE_BENCH_POLICIES (sizeof(policies) / sizeof(policies[0]))
+
+typedef struct
+{
+  const char *name;
+  uint32_t samplerMs; /* 0 if the task is not run */
+  uint32_t connectivityMs;
+  bool publish;
+  IdleMode_t deepest; /* Deepest mode main.cpp uses in this state */
+} IdleBenchProfile_t;
+
+/* The gateway polls the sensors and the connection as in main.cpp, cloud
+ * messages wake it through the UART, which does not wake it from standby.
+ * The event driven profile is woken by the motion interrupt too and only
+ * keeps the telemetry timer. Offline, waiting for the configuration or in
+ * the error state, the Calypso has nothing to send and the buttons wake
+ * the gateway from standby. */
+static const IdleBenchProfile_t profiles[] = {
+    {"gateway", 50, 100, true, IDLE_MODE_SLEEP},
+    {"event", 0, 0, true, IDLE_MODE_SLEEP},
+    {"offline", 0, 1000, false, IDLE_MODE_STANDBY},
+};
+
+static const char *modeNames[] = {"run", "sleep", "standby"};
+
+static SchedulerTask_t samplerTask;
+static SchedulerTask_t connectivityTask;
+static SchedulerTask_t publisherTask;
+static uint32_t telemetryIntervalMs;
+static uint32_t publishes;
+
+static void IdleBench_sampler(SchedulerTask_t *task, uint8_t event)
+{
+  (void)task;
+  (void)event;
+  BasePlatform_advanceClock(IDLE_BENCH_SAMPLER_US);
+}
+
+static void IdleBench_connectivity(SchedulerTask_t *task, uint8_t event)
+{
+  (void)task;
+  (void)event;
+  BasePlatform_advanceClock(IDLE_BENCH_CONNECTIVITY_US);
+}
+
+static void IdleBench_publisher(SchedulerTask_t *task, uint8_t event)
+{
+  (void)event;
+  BasePlatform_advanceClock(IDLE_BENCH_PUBLISH_US);
+  publishes++;
+  Scheduler_startTimer(task, telemetryIntervalMs, 0);
+}
+
+/**
+ * @brief  Time the CPU would wake up: the next SysTick interrupt in the
+ *         idle mode, the next timer expiry otherwise
+ * @param  mode Sleep mode
+ * @retval Host time in us
+ */
+static uint64_t IdleBench_wakeup(IdleMode_t mode)
+{
+  uint64_t now = BasePlatform_micros64();
+  uint64_t tick;
+
+  if (mode == IDLE_MODE_SLEEP || !TimerWheel_nextExpiry(&tick))
+  {
+    return (now / 1000 + 1) * 1000;
+  }
+  return (tick * 1000 > now) ? tick * 1000 : now;
+}
+
+/**
+ * @brief  Sleep hook of the idle manager, skips the sleep on the host clock
+ * @param  mode Sleep mode
+ * @retval None
+ */
+static void IdleBench_sleep(IdleMode_t mode)
+{
+  BasePlatform_advanceClock(IdleBench_wakeup(mode) - BasePlatform_micros64());
+}
+
+/**
+ * @brief  Run a workload in one sleep mode
+ * @param  profile Tasks to run
+ * @param  mode Deepest sleep mode
+ * @param  runUs Simulated time
+ * @param  stats Sleep statistics of the run
+ * @retval None
+ */
+static void IdleBench_run(const IdleBenchProfile_t *profile, IdleMode_t mode, uint64_t runUs, IdleStats_t *stats)
+{
+  uint64_t end;
+
+  Idle_init(Scheduler_isReady, IdleBench_sleep);
+  Idle_setMode(mode);
+  publishes = 0;
+  if (profile->samplerMs)
+  {
+    Scheduler_startTimer(&samplerTask, profile->samplerMs, profile->samplerMs);
+  }
+  if (profile->connectivityMs)
+  {
+    Scheduler_startTimer(&connectivityTask, profile->connectivityMs, profile->connectivityMs);
+  }
+  if (profile->publish)
+  {
+    Scheduler_startTimer(&publisherTask, 0, 0);
+  }
+
+  end = BasePlatform_micros64() + runUs;
+  while (BasePlatform_micros64() < end)
+  {
+    if (!Scheduler_runOnce() && !Idle_enter())
+    {
+      /* The run mode spins until the next timer */
+      BasePlatform_advanceClock(IdleBench_wakeup(IDLE_MODE_STANDBY) - BasePlatform_micros64());
+    }
+    BasePlatform_advanceClock(IDLE_BENCH_PASS_US);
+  }
+  Idle_getStats(stats);
+  stats->sinceUs = BasePlatform_micros64() - stats->sinceUs;
+
+  Scheduler_stopTimer(&samplerTask);
+  Scheduler_stopTimer(&connectivityTask);
+  Scheduler_stopTimer(&publisherTask);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t intervalS = (argc > 1) ? (uint32_t)atol(argv[1]) : IDLE_BENCH_DEFAULT_INTERVAL_S;
+  uint32_t runS = (argc > 2) ? (uint32_t)atol(argv[2]) : IDLE_BENCH_DEFAULT_RUN_S;
+  float batteryMah = (argc > 3) ? (float)atof(argv[3]) : IDLE_BENCH_DEFAULT_BATTERY_MAH;
+  float bestMa = 0.0f;
+
+  telemetryIntervalMs = (intervalS ? intervalS : 1) * 1000;
+  if (runS == 0)
+  {
+    runS = 1;
+  }
+
+  TimerWheel_init(NULL, NULL);
+  Scheduler_addTask(&connectivityTask, "connectivity", 2, IdleBench_connectivity);
+  Scheduler_addTask(&samplerTask, "sampler", 3, IdleBench_sampler);
+  Scheduler_addTask(&publisherTask, "publisher", 4, IdleBench_publisher);
+
+  printf("telemetry every %lu s, %lu s simulated, MCU and Calypso current in mA\r\n", (unsigned long)intervalS,
+         (unsigned long)runS);
+  printf("%-8s %-8s %8s %10s %7s", "profile", "mode", "awake %", "wakeups/s", "MCU");
+  for (size_t p = 0; p < IDLE_BENCH_POLICIES; p++)
+  {
+    printf(" %10s", policies[p].name);
+  }
+  printf("\r\n");
+
+  for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++)
+  {
+    for (IdleMode_t mode = IDLE_MODE_RUN; mode <= profiles[i].deepest; mode++)
+    {
+      IdleStats_t stats;
+      float elapsed;
+      float awake;
+      float mcuMa;
+      float publishMa;
+
+      IdleBench_run(&profiles[i], mode, (uint64_t)runS * 1000000, &stats);
+      elapsed = (float)stats.sinceUs;
+      awake = (elapsed - (float)stats.sleptUs) / elapsed;
+      mcuMa = awake * IDLE_BENCH_MCU_RUN_MA +
+              (float)(stats.sleptUs - stats.standbyUs) / elapsed * IDLE_BENCH_MCU_SLEEP_MA +
+              (float)stats.standbyUs / elapsed * IDLE_BENCH_MCU_STANDBY_MA;
+      publishMa = (float)publishes * IDLE_BENCH_PUBLISH_MAS / (elapsed / 1e6f);
+
+      printf("%-8s %-8s %8.3f %10.1f %7.3f", profiles[i].name, modeNames[mode], awake * 100.0f,
+             (float)stats.sleeps / (elapsed / 1e6f), mcuMa);
+      for (size_t p = 0; p < IDLE_BENCH_POLICIES; p++)
+      {
+        float totalMa = mcuMa + policies[p].currentMa + publishMa;
+
+        printf(" %10.3f", totalMa);
+        if (bestMa == 0.0f || totalMa < bestMa)
+        {
+          bestMa = totalMa;
+        }
+      }
+      printf("\r\n");
+    }
+  }
+  printf("lowest %.3f mA, %.1f days on %.0f mAh\r\n", bestMa, batteryMah / bestMa / 24.0f, batteryMah);
+  return 0;
+}
+/**         EOF         */
@@ -0,0 +1,583 @@
+/**
+ * \file
+ * \brief Time to recover of the Calypso connection manager.
+ *
+ * Runs the connection manager (Board_Libraries/calypsoLink.c) against a
+ * simulated Calypso in a child process, which models the UART, the boot
+ * of the module, the Wi-Fi association and the MQTT connect. A broker
+ * disconnect, a Wi-Fi loss or a wedged module that stops answering is
+ * injected while the gateway publishes telemetry, optionally with an
+ * outage during which the access point or the broker refuse the
+ * reconnects. The outage goes on across a reboot of the module. Prints the
+ * mean time from the fault to the detection and to the recovery for each
+ * class with the attempts and module reboots, and the time of the restart
+ * path the gateway took before: a reboot with the boot delay and the full
+ * setup.
+ *
+ * Usage: link_bench [trials] [outage ms]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ConfigPlatform.h"
+#include "calypsoLink.h"
+
+#define LINK_BENCH_DEFAULT_TRIALS 3
+#define LINK_BENCH_TELEMETRY_PERIOD 1000
+#define LINK_BENCH_SETTLE_MS 500
+
+/* Restart path of the gateway: boot delay of setup() and the Wi-Fi delay
+ * of the device files */
+#define LINK_BENCH_BOOT_DELAY 9000
+#define LINK_BENCH_WIFI_CONNECT_DELAY 5000
+
+/* Simulated Calypso: 921600 baud UART like Device_init, AT command handling,
+ * boot, Wi-Fi association with DHCP, MQTT connect with the TLS handshake
+ * and broker round trip */
+#define LINK_BENCH_BYTE_US 11
+#define LINK_BENCH_PROCESS_US 1000
+#define LINK_BENCH_BOOT_US 1200000
+#define LINK_BENCH_ASSOCIATION_US 1500000
+#define LINK_BENCH_TLS_US 800000
+#define LINK_BENCH_RTT_US 50000
+#define LINK_BENCH_MAX_PENDING 16
+#define LINK_BENCH_LINE_SIZE 2048
+
+typedef struct
+{
+  uint64_t dueUs;
+  const char *line;
+} LinkBenchOutput_t;
+
+typedef struct
+{
+  char fault; /* 'b' broker, 'w' Wi-Fi, 'm' module */
+  uint32_t outageMs;
+} LinkBenchFault_t;
+
+typedef struct
+{
+  bool wedged;
+  bool wifi;
+  bool client;
+  bool broker;
+  bool session; /* Subscriptions kept by the broker for the client */
+  uint64_t accessPointDownUntilUs;
+  uint64_t brokerDownUntilUs;
+  uint64_t busyUntilUs;
+  LinkBenchOutput_t pending[LINK_BENCH_MAX_PENDING];
+  size_t count;
+} LinkBenchModule_t;
+
+static const char *faultNames[calypso_link_faults] = {"ok", "broker", "wifi", "module"};
+
+/**
+ * @brief  Schedule a line sent by the simulated Calypso, in time order
+ * @param  module Simulated Calypso
+ * @param  dueUs Time to send the line
+ * @param  line Line including CRLF
+ * @retval None
+ */
+static void LinkBench_schedule(LinkBenchModule_t *module, uint64_t dueUs, const char *line)
+{
+  size_t i = module->count;
+
+  if (module->count >= LINK_BENCH_MAX_PENDING)
+  {
+    return;
+  }
+  while (i > 0 && module->pending[i - 1].dueUs > dueUs)
+  {
+    module->pending[i] = module->pending[i - 1];
+    i--;
+  }
+  module->pending[i].dueUs = dueUs;
+  module->pending[i].line = line;
+  module->count++;
+}
+
+/**
+ * @brief  Inject a fault into the simulated Calypso
+ * @param  module Simulated Calypso
+ * @param  fault Fault and outage
+ * @retval None
+ */
+static void LinkBench_inject(LinkBenchModule_t *module, const LinkBenchFault_t *fault)
+{
+  uint64_t now = BasePlatform_micros64();
+  uint64_t until = now + (uint64_t)fault->outageMs * 1000;
+
+  switch (fault->fault)
+  {
+  case 'b':
+    module->broker = false;
+    module->brokerDownUntilUs = until;
+    LinkBench_schedule(module, now, "+eventmqtt:disconnect\r\n");
+    break;
+  case 'w':
+    module->wifi = false;
+    module->broker = false;
+    module->accessPointDownUntilUs = until;
+    LinkBench_schedule(module, now, "+eventwlan:disconnect,home_ap,00:11:22:33:44:55,0\r\n");
+    break;
+  case 'm':
+    /* Stops answering, the AT host only still takes a reboot */
+    module->wedged = true;
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief  Handle a command received by the simulated Calypso
+ * @param  module Simulated Calypso
+ * @param  line Command including CRLF
+ * @param  length Length of the command
+ * @retval None
+ */
+static void LinkBench_command(LinkBenchModule_t *module, const char *line, size_t length)
+{
+  uint64_t now = BasePlatform_micros64();
+  uint64_t done = ((module->busyUntilUs > now) ? module->busyUntilUs : now) + length * LINK_BENCH_BYTE_US +
+                  LINK_BENCH_PROCESS_US;
+  const char *response = "OK\r\n";
+
+  if (0 == strncasecmp(line, "AT+reboot", 9))
+  {
+    /* The outage of the access point or the broker goes on */
+    memset(module, 0, offsetof(LinkBenchModule_t, accessPointDownUntilUs));
+    LinkBench_schedule(module, done, response);
+    done += LINK_BENCH_BOOT_US;
+    LinkBench_schedule(module, done, "+eventstartup:0,0,00:11:22:33:44:55,3.4.0\r\n");
+    module->busyUntilUs = done;
+    return;
+  }
+  if (module->wedged)
+  {
+    return;
+  }
+
+  if (0 == strncasecmp(line, "AT+wlanConnect=", 15))
+  {
+    if (now >= module->accessPointDownUntilUs)
+    {
+      module->wifi = true;
+      LinkBench_schedule(module, done + LINK_BENCH_ASSOCIATION_US,
+                         "+eventnetapp:ipv4_acquired,192.168.1.20,192.168.1.1,192.168.1.1\r\n");
+    }
+  }
+  else if (0 == strncasecmp(line, "AT+wlanDisconnect", 17))
+  {
+    module->wifi = false;
+    module->broker = false;
+  }
+  else if (0 == strncasecmp(line, "AT+mqttCreate=", 14))
+  {
+    if (module->client)
+    {
+      response = "Error:-1\r\n";
+    }
+    module->client = true;
+    module->session = false;
+  }
+  else if (0 == strncasecmp(line, "AT+mqttConnect=", 15))
+  {
+    if (!module->client || !module->wifi)
+    {
+      response = "Error:-1\r\n";
+    }
+    else
+    {
+      /* The connack comes before the OK */
+      done += LINK_BENCH_TLS_US + LINK_BENCH_RTT_US;
+      if (now < module->brokerDownUntilUs)
+      {
+        LinkBench_schedule(module, done, "+eventmqtt:operation,connack,3\r\n");
+      }
+      else
+      {
+        module->broker = true;
+        LinkBench_schedule(module, done,
+                           module->session ? "+eventmqtt:operation,connack,256\r\n"
+                                           : "+eventmqtt:operation,connack,0\r\n");
+      }
+      done += LINK_BENCH_PROCESS_US;
+    }
+  }
+  else if (0 == strncasecmp(line, "AT+mqttDisconnect", 17))
+  {
+    module->broker = false;
+  }
+  else if (0 == strncasecmp(line, "AT+mqttDelete", 13))
+  {
+    module->client = false;
+    module->broker = false;
+    module->session = false;
+  }
+  else if (0 == strncasecmp(line, "AT+mqttSubscribe=", 17))
+  {
+    if (!module->broker)
+    {
+      response = "Error:-1\r\n";
+    }
+    else
+    {
+      module->session = true;
+      LinkBench_schedule(module, done + LINK_BENCH_RTT_US, "+eventmqtt:operation,suback,0\r\n");
+    }
+  }
+  else if (0 == strncasecmp(line, "AT+mqttPublish=", 15))
+  {
+    if (!module->broker)
+    {
+      response = "Error:-1\r\n";
+    }
+  }
+  LinkBench_schedule(module, done, response);
+  module->busyUntilUs = done;
+}
+
+/**
+ * @brief  Simulated Calypso, runs until the gateway side closes the pipe
+ * @param  fdIn Commands from the gateway
+ * @param  fdOut Responses and events to the gateway
+ * @param  fdControl Faults injected by the bench
+ * @retval None
+ */
+static void LinkBench_calypso(int fdIn, int fdOut, int fdControl)
+{
+  static LinkBenchModule_t module;
+  static char line[LINK_BENCH_LINE_SIZE];
+  size_t length = 0;
+
+  for (;;)
+  {
+    uint64_t now = BasePlatform_micros64();
+    struct pollfd fds[2] = {{fdIn, POLLIN, 0}, {fdControl, POLLIN, 0}};
+    int timeoutMs = -1;
+    char c;
+
+    while (module.count > 0 && module.pending[0].dueUs <= now)
+    {
+      if (write(fdOut, module.pending[0].line, strlen(module.pending[0].line)) < 0)
+      {
+        return;
+      }
+      memmove(&module.pending[0], &module.pending[1], (module.count - 1) * sizeof(module.pending[0]));
+      module.count--;
+    }
+    if (module.count > 0)
+    {
+      timeoutMs = (int)((module.pending[0].dueUs - now + 999) / 1000);
+    }
+    if (poll(fds, 2, timeoutMs) <= 0)
+    {
+      continue;
+    }
+    if (fds[1].revents != 0)
+    {
+      LinkBenchFault_t fault;
+
+      if (read(fdControl, &fault, sizeof(fault)) != sizeof(fault))
+      {
+        return;
+      }
+      LinkBench_inject(&module, &fault);
+    }
+    if (fds[0].revents == 0)
+    {
+      continue;
+    }
+    if (read(fdIn, &c, 1) != 1)
+    {
+      return;
+    }
+    if (length < sizeof(line) - 1)
+    {
+      line[length++] = c;
+    }
+    if (c == '\n')
+    {
+      line[length] = '\0';
+      LinkBench_command(&module, line, length);
+      length = 0;
+    }
+  }
+}
+
+/**
+ * @brief  MQTT session setup of the gateway: create, set and connect
+ * @param  self Pointer to the calypso object.
+ * @retval true if connected to the broker
+ */
+static bool LinkBench_openSession(CALYPSO *self)
+{
+  strcpy(self->settings.mqttSettings.clientID, "gw-7f3a91");
+  strcpy(self->settings.mqttSettings.serverInfo.address, "hub.example.net");
+  self->settings.mqttSettings.serverInfo.port = 8883;
+  strcpy(self->settings.mqttSettings.userOptions.userName, "hub.example.net/gw-7f3a91");
+  return Calypso_MQTTconnect(self);
+}
+
+/**
+ * @brief  Subscriptions of the Azure device
+ * @param  self Pointer to the calypso object.
+ * @retval true if successful false otherwise
+ */
+static bool LinkBench_subscribe(CALYPSO *self)
+{
+  ATMQTT_subscribeTopic_t topics[3];
+
+  memset(topics, 0, sizeof(topics));
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    topics[i].QoS = ATMQTT_QOS_QOS1;
+  }
+  strcpy(topics[0].topicString, "$iothub/twin/res/#");
+  strcpy(topics[1].topicString, "$iothub/twin/PATCH/properties/desired/#");
+  strcpy(topics[2].topicString, "$iothub/methods/POST/#");
+  return Calypso_subscribe(self, 0, 3, topics);
+}
+
+/**
+ * @brief  Run the gateway for a while: handle the Calypso events and
+ *         publish telemetry while connected
+ * @param  calypso Gateway side of the simulated Calypso
+ * @param  link Connection manager
+ * @param  durationMs Time to run, 0 to stop at the first fault
+ * @param  lastPublish Time of the last telemetry message
+ * @retval Fault found, calypso_link_ok if none
+ */
+static CalypsoLink_fault_t LinkBench_run(CALYPSO *calypso, CalypsoLink_t *link, unsigned long durationMs,
+                                         unsigned long *lastPublish)
+{
+  static char telemetry[] = "{\"temperature\":21.5,\"humidity\":40.2,\"pressure\":98.7}";
+  unsigned long startTime = millis();
+  CalypsoLink_fault_t fault = calypso_link_ok;
+
+  while ((durationMs == 0) || ((millis() - startTime) < durationMs))
+  {
+    Calypso_processRx(calypso);
+    fault = CalypsoLink_check(link);
+    if (fault != calypso_link_ok)
+    {
+      if (durationMs == 0)
+      {
+        break;
+      }
+    }
+    else if ((millis() - *lastPublish) >= LINK_BENCH_TELEMETRY_PERIOD)
+    {
+      *lastPublish = millis();
+      Calypso_MQTTPublishData(calypso, "devices/gw-7f3a91/messages/events/", ATMQTT_QOS_QOS0, 0, telemetry,
+                              strlen(telemetry), true);
+    }
+    delay(2);
+  }
+  return fault;
+}
+
+/**
+ * @brief  Reconnect with the backoff of the connection manager
+ * @param  calypso Gateway side of the simulated Calypso
+ * @param  link Connection manager
+ * @retval true if recovered, false if the manager gave up
+ */
+static bool LinkBench_recover(CALYPSO *calypso, CalypsoLink_t *link)
+{
+  unsigned long retryMs;
+
+  while (!CalypsoLink_recover(link, &retryMs))
+  {
+    unsigned long startTime = millis();
+
+    if (CalypsoLink_isExhausted(link))
+    {
+      return false;
+    }
+    while ((millis() - startTime) < retryMs)
+    {
+      Calypso_processRx(calypso);
+      delay(2);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief  Time of the restart path: boot delay, reboot of Calypso, Wi-Fi
+ *         with its delay, SNTP setup and the full MQTT session. The reads
+ *         of the configuration files are not counted.
+ * @param  calypso Gateway side of the simulated Calypso
+ * @retval Time in ms, 0 if it failed
+ */
+static unsigned long LinkBench_restartPath(CALYPSO *calypso)
+{
+  unsigned long startTime = millis();
+
+  if (!Calypso_simpleInit(calypso) || !Calypso_WLANconnect(calypso))
+  {
+    return 0;
+  }
+  delay(LINK_BENCH_WIFI_CONNECT_DELAY);
+  Calypso_setUpSNTP(calypso);
+  if (!LinkBench_openSession(calypso) || !LinkBench_subscribe(calypso))
+  {
+    return 0;
+  }
+  return LINK_BENCH_BOOT_DELAY + (millis() - startTime);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t trials = (argc > 1) ? (uint32_t)atol(argv[1]) : LINK_BENCH_DEFAULT_TRIALS;
+  uint32_t outageMs = (argc > 2) ? (uint32_t)atol(argv[2]) : 0;
+  static const char faults[] = {'b', 'w', 'm'};
+  CalypsoSettings settings;
+  CalypsoLink_t link;
+  CALYPSO *calypso;
+  unsigned long lastPublish = 0;
+  unsigned long restartMs;
+  int control[2];
+  int peerIn;
+  int peerOut;
+  bool failed = false;
+  pid_t child;
+
+  if (trials == 0)
+  {
+    trials = 1;
+  }
+  if (!BaseSerial_openPipe(&Serial1, &peerIn, &peerOut) || (pipe(control) != 0))
+  {
+    fprintf(stderr, "Unable to open the Calypso pipes\r\n");
+    return 1;
+  }
+  child = fork();
+  if (child < 0)
+  {
+    fprintf(stderr, "Unable to start the Calypso simulator\r\n");
+    return 1;
+  }
+  if (child == 0)
+  {
+    BaseSerial_close(&Serial1);
+    close(control[1]);
+    LinkBench_calypso(peerIn, peerOut, control[0]);
+    _exit(0);
+  }
+  close(peerIn);
+  close(peerOut);
+  close(control[0]);
+
+  /* The debug log is not initialized, the command traces are dropped */
+  memset(&settings, 0, sizeof(settings));
+  strcpy(settings.wifiSettings.SSID, "home_ap");
+  strcpy(settings.wifiSettings.securityParams.securityKey, "secret-key");
+  calypso = Calypso_Create(SSerial_create(&Serial), HSerial_create(&Serial1), &settings);
+  CalypsoLink_init(&link, calypso, LinkBench_openSession, LinkBench_subscribe);
+
+  printf("%lu trials per fault, %lu ms outage\r\n", (unsigned long)trials, (unsigned long)outageMs);
+  printf("%-8s %10s %10s %10s %10s %10s %10s\r\n", "fault", "detect ms", "recover ms", "total ms", "max ms", "attempts",
+         "reboots");
+
+  /* First connection through the manager too */
+  CalypsoLink_check(&link);
+  if (!LinkBench_recover(calypso, &link))
+  {
+    fprintf(stderr, "Unable to connect\r\n");
+    failed = true;
+  }
+
+  for (uint8_t f = 0; !failed && (f < sizeof(faults)); f++)
+  {
+    CalypsoLink_fault_t expected = (CalypsoLink_fault_t)(calypso_link_broker_lost + f);
+    uint64_t detectMs = 0;
+    uint64_t totalMs = 0;
+    unsigned long maxMs = 0;
+    uint32_t reboots = 0;
+    const CalypsoLink_Stats_t *stats = &link.stats[expected];
+
+    CalypsoLink_resetStats(&link);
+    for (uint32_t t = 0; t < trials; t++)
+    {
+      LinkBenchFault_t fault = {faults[f], outageMs};
+      unsigned long faultTime;
+      unsigned long elapsedMs;
+
+      LinkBench_run(calypso, &link, LINK_BENCH_SETTLE_MS, &lastPublish);
+      if (write(control[1], &fault, sizeof(fault)) != sizeof(fault))
+      {
+        failed = true;
+        break;
+      }
+      faultTime = millis();
+      if (LinkBench_run(calypso, &link, 0, &lastPublish) != expected)
+      {
+        fprintf(stderr, "%s fault detected as %s\r\n", faultNames[expected], faultNames[link.fault]);
+        failed = true;
+        break;
+      }
+      detectMs += millis() - faultTime;
+      if (!LinkBench_recover(calypso, &link))
+      {
+        fprintf(stderr, "%s fault not recovered\r\n", faultNames[expected]);
+        failed = true;
+        break;
+      }
+      elapsedMs = millis() - faultTime;
+      reboots += link.reboots;
+      totalMs += elapsedMs;
+      if (elapsedMs > maxMs)
+      {
+        maxMs = elapsedMs;
+      }
+    }
+    if (failed)
+    {
+      break;
+    }
+    printf("%-8s %10lu %10lu %10lu %10lu %10.1f %10.1f\r\n", faultNames[expected], (unsigned long)(detectMs / trials),
+           (unsigned long)(stats->totalMs / trials), (unsigned long)(totalMs / trials), maxMs,
+           (double)stats->attempts / trials, (double)reboots / trials);
+  }
+
+  if (!failed)
+  {
+    restartMs = LinkBench_restartPath(calypso);
+    printf("%-8s %10s %10s %10lu %10s %10s %10s\r\n", "restart", "-", "-", restartMs, "-", "-", "-");
+    failed = (restartMs == 0);
+  }
+
+  BaseSerial_close(&Serial1);
+  close(control[1]);
+  kill(child, SIGTERM);
+  waitpid(child, NULL, 0);
+  Calypso_Destroy(calypso);
+  return failed ? 1 : 0;
+}
+/**         EOF         */
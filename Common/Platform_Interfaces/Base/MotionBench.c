@@ -0,0 +1,274 @@
+/**
+ * \file
+ * \brief Publishing of the ITDS motion events on the simulated sensor.
+ *
+ * Configures the tap, free-fall, wake-up and stationary detectors of the
+ * simulated ITDS like Device_init does, raises events with
+ * SensorSim_injectItdsEvent and runs Device_processMotionEvents every
+ * millisecond of a simulated clock. The messages go to a mock platform
+ * driver that records the event, the count and the time. Each scenario
+ * checks the messages and the detections they carry and prints the latency
+ * from the event to its message. Exits with an error on a mismatch.
+ *
+ * Usage: motion_bench [taps]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "SensorSimulator.h"
+#include "PnP_Common_Device.h"
+
+#define MOTION_BENCH_DEFAULT_TAPS 10
+#define MOTION_BENCH_TAP_PERIOD_MS 100
+/* Events of one scenario are apart by more than the rate limit */
+#define MOTION_BENCH_EVENT_GAP_MS 2000
+
+/* Bits of ALL_INT_EVENT */
+#define MOTION_BENCH_FREE_FALL 0x01
+#define MOTION_BENCH_WAKE_UP 0x02
+#define MOTION_BENCH_SINGLE_TAP 0x04
+#define MOTION_BENCH_DOUBLE_TAP 0x08
+#define MOTION_BENCH_SLEEP_CHANGE 0x20
+
+/* Defined by GW/src/main.cpp in the application */
+char displayText[150];
+
+/* Sensor and state of the PnP layer */
+extern ITDS *sensorITDS;
+extern bool motionEventsEnabled;
+
+typedef struct
+{
+  uint32_t messages;
+  uint32_t detections;
+  unsigned long firstMs; /* Time of the first message */
+} MotionBench_event_t;
+
+static MotionBench_event_t published[itdsMotionEvents];
+static bool publishFails = false;
+static uint32_t publishAttempts = 0;
+static uint32_t benchWrong = 0;
+static Device_Platform_t mockPlatform;
+
+/**
+ * @brief  Record a motion event message, or fail like a broken link
+ * @param  event name of the event
+ * @param  count number of detections carried by the message
+ * @retval true if published false otherwise
+ */
+static bool Mock_publishMotionEvent(const char *event, uint16_t count)
+{
+  publishAttempts++;
+  if (publishFails)
+  {
+    return false;
+  }
+  for (uint8_t i = 0; i < itdsMotionEvents; i++)
+  {
+    if (strcmp(event, sensorITDS->motionEventNames[i]) == 0)
+    {
+      if (published[i].messages++ == 0)
+      {
+        published[i].firstMs = millis();
+      }
+      published[i].detections += count;
+      return true;
+    }
+  }
+  printf("Unknown event %s\r\n", event);
+  benchWrong++;
+  return true;
+}
+
+/**
+ * @brief  Run the idle loop of the application for a while, one pass per ms
+ * @param  ms Simulated time
+ * @retval None
+ */
+static void MotionBench_run(uint32_t ms)
+{
+  for (uint32_t i = 0; i < ms; i++)
+  {
+    BasePlatform_advanceClock(1000);
+    Device_processMotionEvents();
+  }
+}
+
+/**
+ * @brief  Check and print the messages of a scenario, then clear them
+ * @param  name Scenario
+ * @param  startMs Time of the first event
+ * @param  expectedMessages Messages expected per event type
+ * @param  expectedDetections Detections expected per event type
+ * @retval None
+ */
+static void MotionBench_report(const char *name, unsigned long startMs, const uint32_t *expectedMessages,
+                               const uint32_t *expectedDetections)
+{
+  bool wrong = false;
+  uint32_t messages = 0;
+  uint32_t detections = 0;
+  long latencyMs = -1;
+
+  for (uint8_t i = 0; i < itdsMotionEvents; i++)
+  {
+    if ((published[i].messages != expectedMessages[i]) || (published[i].detections != expectedDetections[i]))
+    {
+      printf("  %s: %lu messages with %lu detections, expected %lu with %lu\r\n", sensorITDS->motionEventNames[i],
+             (unsigned long)published[i].messages, (unsigned long)published[i].detections,
+             (unsigned long)expectedMessages[i], (unsigned long)expectedDetections[i]);
+      wrong = true;
+    }
+    if ((published[i].messages != 0) && ((long)(published[i].firstMs - startMs) > latencyMs))
+    {
+      latencyMs = (long)(published[i].firstMs - startMs);
+    }
+    messages += published[i].messages;
+    detections += published[i].detections;
+  }
+  printf("%-24s %8lu %10lu %11ld %s\r\n", name, (unsigned long)messages, (unsigned long)detections, latencyMs,
+         wrong ? "WRONG" : "ok");
+  benchWrong += wrong ? 1 : 0;
+  memset(published, 0, sizeof(published));
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t taps = (argc > 1) ? (uint32_t)atol(argv[1]) : MOTION_BENCH_DEFAULT_TAPS;
+  uint32_t messages[itdsMotionEvents];
+  uint32_t detections[itdsMotionEvents];
+  unsigned long startMs;
+  uint32_t failedAttempts;
+  TypeSerial *debug;
+
+  SensorSim_init();
+  debug = SSerial_create(&Serial);
+  sensorITDS = ITDSCreate(debug);
+  if (!ITDS_simpleInit(sensorITDS) || !ITDS_enableMotionEvents(sensorITDS))
+  {
+    fprintf(stderr, "ITDS init failed\r\n");
+    return 1;
+  }
+  motionEventsEnabled = true;
+  Bench_mockPlatform(&mockPlatform, AZURE, "MOCK");
+  mockPlatform.publishMotionEvent = Mock_publishMotionEvent;
+  if (!Device_registerPlatform(&mockPlatform) || !Device_selectPlatform(AZURE))
+  {
+    fprintf(stderr, "Mock platform not selected\r\n");
+    return 1;
+  }
+  MotionBench_run(MOTION_BENCH_EVENT_GAP_MS);
+
+  printf("scenario                 messages detections latency ms\r\n");
+
+  /* One event of each type, a message each */
+  {
+    static const struct
+    {
+      const char *name;
+      uint8_t bits;
+      ITDS_motion_event_t event;
+    } single[] = {
+        {"single tap", MOTION_BENCH_SINGLE_TAP, itdsSingleTap},
+        {"double tap", MOTION_BENCH_DOUBLE_TAP, itdsDoubleTap},
+        {"free-fall", MOTION_BENCH_FREE_FALL, itdsFreeFall},
+        {"wake-up", MOTION_BENCH_WAKE_UP, itdsWakeUp},
+        {"stationary", MOTION_BENCH_SLEEP_CHANGE, itdsStationary},
+    };
+
+    for (uint8_t i = 0; i < sizeof(single) / sizeof(single[0]); i++)
+    {
+      memset(messages, 0, sizeof(messages));
+      memset(detections, 0, sizeof(detections));
+      messages[single[i].event] = 1;
+      detections[single[i].event] = 1;
+      startMs = millis();
+      SensorSim_injectItdsEvent(single[i].bits, true);
+      MotionBench_run(MOTION_BENCH_EVENT_GAP_MS);
+      MotionBench_report(single[i].name, startMs, messages, detections);
+    }
+  }
+
+  /* Leaving sleep is not reported */
+  memset(messages, 0, sizeof(messages));
+  memset(detections, 0, sizeof(detections));
+  startMs = millis();
+  SensorSim_injectItdsEvent(MOTION_BENCH_SLEEP_CHANGE, false);
+  MotionBench_run(MOTION_BENCH_EVENT_GAP_MS);
+  MotionBench_report("leaving sleep", startMs, messages, detections);
+
+  /* A fall: free-fall and the wake-up of the impact latched together */
+  messages[itdsFreeFall] = 1;
+  detections[itdsFreeFall] = 1;
+  messages[itdsWakeUp] = 1;
+  detections[itdsWakeUp] = 1;
+  startMs = millis();
+  SensorSim_injectItdsEvent(MOTION_BENCH_FREE_FALL | MOTION_BENCH_WAKE_UP, true);
+  MotionBench_run(MOTION_BENCH_EVENT_GAP_MS);
+  MotionBench_report("free-fall and wake-up", startMs, messages, detections);
+
+  /* Taps faster than the rate limit are counted into one message per second */
+  memset(messages, 0, sizeof(messages));
+  memset(detections, 0, sizeof(detections));
+  /* The first tap is sent at once, the rest at the end of every interval */
+  messages[itdsSingleTap] =
+      (taps == 0) ? 0
+                  : 1 + ((taps - 1) * MOTION_BENCH_TAP_PERIOD_MS + MOTION_EVENT_MIN_INTERVAL - 1) / MOTION_EVENT_MIN_INTERVAL;
+  detections[itdsSingleTap] = taps;
+  startMs = millis();
+  for (uint32_t i = 0; i < taps; i++)
+  {
+    SensorSim_injectItdsEvent(MOTION_BENCH_SINGLE_TAP, true);
+    MotionBench_run(MOTION_BENCH_TAP_PERIOD_MS);
+  }
+  MotionBench_run(MOTION_BENCH_EVENT_GAP_MS);
+  MotionBench_report("tap burst", startMs, messages, detections);
+
+  /* Taps while the publish fails are retried once per interval and sent
+   * once it works again */
+  messages[itdsSingleTap] = (taps == 0) ? 0 : 1;
+  publishFails = true;
+  publishAttempts = 0;
+  startMs = millis();
+  for (uint32_t i = 0; i < taps; i++)
+  {
+    SensorSim_injectItdsEvent(MOTION_BENCH_SINGLE_TAP, true);
+    MotionBench_run(MOTION_BENCH_TAP_PERIOD_MS);
+  }
+  failedAttempts = publishAttempts;
+  publishFails = false;
+  MotionBench_run(MOTION_BENCH_EVENT_GAP_MS);
+  MotionBench_report("taps while link down", startMs, messages, detections);
+  printf("%lu failed publishes in %lu ms of link down\r\n", (unsigned long)failedAttempts,
+         (unsigned long)taps * MOTION_BENCH_TAP_PERIOD_MS);
+  if (failedAttempts > 1 + taps * MOTION_BENCH_TAP_PERIOD_MS / MOTION_EVENT_MIN_INTERVAL)
+  {
+    printf("Failed publishes retried faster than the rate limit\r\n");
+    benchWrong++;
+  }
+
+  ITDSDestroy(sensorITDS);
+  SSerial_destroy(debug);
+  return benchWrong ? 1 : 0;
+}
+/**         EOF         */
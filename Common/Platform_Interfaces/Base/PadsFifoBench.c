@@ -0,0 +1,226 @@
+/**
+ * \file
+ * \brief PADS FIFO batching of the sensor board on the simulated sensor.
+ *
+ * Built with PADS_FIFO_BATCHING=1. Runs the PADS at 10 Hz into its FIFO
+ * while the simulated pressure falls by 1 Pa/s, a lift going up, and
+ * services the FIFO every 50 ms like the sampler task. At each telemetry
+ * interval it checks the averaged pressure, the pressure trend and the
+ * altitude of PADS_readSensorData against the pressure ramp, and the
+ * number of samples drained against the output data rate. The FIFO is
+ * then left without service until it overruns, and the overrun count and
+ * the average of the samples that were kept are checked. Prints each read
+ * with its I2C transactions and exits with an error on a mismatch.
+ *
+ * Usage: pads_fifo_bench [reads] [interval s]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <math.h>
+
+#include "ConfigPlatform.h"
+#include "SensorSimulator.h"
+#include "WSEN_PADS_2511020213301.h"
+#include "sensorBoard.h"
+
+#if !PADS_FIFO_BATCHING
+#error "pads_fifo_bench needs PADS_FIFO_BATCHING=1"
+#endif
+
+#define PADS_FIFO_BENCH_DEFAULT_READS 10
+#define PADS_FIFO_BENCH_DEFAULT_INTERVAL 30 /* s, DEFAULT_TELEMETRY_SEND_INTEVAL */
+#define PADS_FIFO_BENCH_PASS_MS 50          /* SAMPLER_PERIOD of GW/src/main.cpp */
+#define PADS_FIFO_BENCH_PRESSURE 101325     /* Pa */
+#define PADS_FIFO_BENCH_SLOPE -1            /* Pa/s */
+#define PADS_FIFO_BENCH_TEMPERATURE 2000    /* 0.01 degC */
+/* Left without service for longer than the 128 samples of the FIFO */
+#define PADS_FIFO_BENCH_STALL_S 20
+/* The samples of a read are within one period of the interval, the
+ * pressure is rounded to Pa */
+#define PADS_FIFO_BENCH_PRESSURE_TOLERANCE 1 /* Pa */
+#define PADS_FIFO_BENCH_TREND_TOLERANCE 20   /* Pa/h */
+#define PADS_FIFO_BENCH_ALTITUDE_TOLERANCE 2 /* cm */
+#define PADS_FIFO_BENCH_SAMPLE_TOLERANCE 1
+
+/* Defined by GW/src/main.cpp in the application */
+char displayText[150];
+
+/**
+ * @brief  Simulated pressure
+ * @param  timeS Simulation time in s
+ * @retval Pressure in Pa
+ */
+static double PadsFifoBench_pressure(double timeS)
+{
+  return PADS_FIFO_BENCH_PRESSURE + PADS_FIFO_BENCH_SLOPE * timeS;
+}
+
+/**
+ * @brief  Run the sampler task for a time
+ * @param  pads Sensor object
+ * @param  ms Time to run
+ * @param  service true to service the FIFO on each pass
+ * @retval true if successful false if the FIFO service failed
+ */
+static bool PadsFifoBench_run(PADS *pads, uint32_t ms, bool service)
+{
+  for (uint32_t t = 0; t < ms; t += PADS_FIFO_BENCH_PASS_MS)
+  {
+    BasePlatform_advanceClock(PADS_FIFO_BENCH_PASS_MS * 1000);
+    I2CPoll();
+    if (service && !PADS_serviceFifo(pads, false))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief  Check a value against its expected value
+ * @param  name Quantity
+ * @param  value Value read
+ * @param  expected Expected value
+ * @param  tolerance Largest difference
+ * @retval true if within the tolerance
+ */
+static bool PadsFifoBench_check(const char *name, double value, double expected, double tolerance)
+{
+  if (fabs(value - expected) <= tolerance)
+  {
+    return true;
+  }
+  fprintf(stderr, "%s %.2f, expected %.2f\r\n", name, value, expected);
+  return false;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t reads = (argc > 1) ? (uint32_t)atol(argv[1]) : PADS_FIFO_BENCH_DEFAULT_READS;
+  uint32_t intervalS = (argc > 2) ? (uint32_t)atol(argv[2]) : PADS_FIFO_BENCH_DEFAULT_INTERVAL;
+  SensorSim_waveform_t waveform;
+  SensorSim_stats_t stats;
+  TypeSerial *debug;
+  PADS *pads;
+  double startS;
+  double referencePressure = 0;
+  double temperatureK = PADS_FIFO_BENCH_TEMPERATURE / 100.0 + 273.15;
+  uint16_t overruns;
+  bool ok = true;
+
+  if ((intervalS == 0) || (intervalS * PADS_FIFO_RATE > PADS_FIFO_SIZE * 100))
+  {
+    intervalS = PADS_FIFO_BENCH_DEFAULT_INTERVAL;
+  }
+
+  SensorSim_init();
+  memset(&waveform, 0, sizeof(waveform));
+  waveform.offset = PADS_FIFO_BENCH_PRESSURE;
+  waveform.slope = PADS_FIFO_BENCH_SLOPE;
+  SensorSim_setWaveform(sensorSimPressure, &waveform);
+  memset(&waveform, 0, sizeof(waveform));
+  waveform.offset = PADS_FIFO_BENCH_TEMPERATURE;
+  SensorSim_setWaveform(sensorSimTemperature, &waveform);
+
+  debug = SSerial_create(&Serial);
+  pads = PADSCreate(debug);
+  if (!PADS_simpleInit(pads))
+  {
+    fprintf(stderr, "PADS init failed\r\n");
+    return 1;
+  }
+  startS = BasePlatform_micros64() / 1000000.0;
+
+  printf("%4s %10s %10s %10s %10s %8s %8s\r\n", "read", "samples", "kPa", "Pa/h", "altitude m", "overruns",
+         "I2C");
+  for (uint32_t r = 0; ok && (r <= reads); r++)
+  {
+    bool stall = (r == reads);
+    double nowS;
+    double windowS;
+    double expected;
+    uint32_t samples;
+
+    SensorSim_resetStats();
+    if (stall)
+    {
+      ok = PadsFifoBench_run(pads, PADS_FIFO_BENCH_STALL_S * 1000, false);
+    }
+    else
+    {
+      ok = PadsFifoBench_run(pads, intervalS * 1000, true);
+    }
+    /* The forced drain of the read, the samples are counted before */
+    ok = ok && PADS_serviceFifo(pads, true);
+    samples = pads->batch.samples;
+    overruns = pads->batch.overruns;
+    ok = ok && PADS_readSensorData(pads);
+    SensorSim_getStats(sensorSimPADS, &stats);
+    if (!ok)
+    {
+      fprintf(stderr, "PADS read failed\r\n");
+      break;
+    }
+    printf("%4lu %10lu %10.3f %10ld %10.2f %8u %8lu\r\n", (unsigned long)r, (unsigned long)samples,
+           (double)pads->data[padsPressure] / PADS_PRESSURE_SCALE, (long)pads->pressureTrend,
+           (double)pads->altitude / PADS_ALTITUDE_SCALE, (unsigned int)overruns,
+           (unsigned long)stats.transactions);
+
+    nowS = BasePlatform_micros64() / 1000000.0;
+    if (stall)
+    {
+      /* Only the newest samples are kept */
+      windowS = (double)PADS_FIFO_SIZE / PADS_FIFO_RATE;
+      ok = PadsFifoBench_check("overruns", overruns, 1, 0) &&
+           PadsFifoBench_check("samples", samples, PADS_FIFO_SIZE, 0);
+    }
+    else
+    {
+      windowS = (r == 0) ? nowS - startS : intervalS;
+      ok = PadsFifoBench_check("overruns", overruns, 0, 0) &&
+           PadsFifoBench_check("samples", samples, windowS * PADS_FIFO_RATE, PADS_FIFO_BENCH_SAMPLE_TOLERANCE);
+    }
+    /* Average of a ramp, the value in the middle of the samples */
+    expected = PadsFifoBench_pressure(nowS - windowS / 2);
+    ok = ok && PadsFifoBench_check("pressure", pads->data[padsPressure], expected,
+                                   PADS_FIFO_BENCH_PRESSURE_TOLERANCE + 0.5 * fabs(PADS_FIFO_BENCH_SLOPE) / PADS_FIFO_RATE);
+    if (r == 0)
+    {
+      referencePressure = expected;
+      continue;
+    }
+    if (!stall)
+    {
+      ok = ok && PadsFifoBench_check("trend", pads->pressureTrend, PADS_FIFO_BENCH_SLOPE * 3600,
+                                     PADS_FIFO_BENCH_TREND_TOLERANCE);
+    }
+    /* Hypsometric equation with R / g of dry air, 29.271 m/K */
+    ok = ok && PadsFifoBench_check("altitude", pads->altitude,
+                                   -2927.1 * temperatureK * (expected - referencePressure) / expected,
+                                   PADS_FIFO_BENCH_ALTITUDE_TOLERANCE);
+  }
+
+  PADSDestroy(pads);
+  SSerial_destroy(debug);
+  return ok ? 0 : 1;
+}
+/**         EOF         */
@@ -0,0 +1,342 @@
+/**
+ * \file
+ * \brief Platform driver registry and dispatch cost of the common layer.
+ *
+ * Registers mock drivers in place of the built-in Azure and KaaIoT ones,
+ * checks the registration, the selection and the platform switching, then
+ * runs the Device_* calls of a telemetry cycle on the mock. Prints the cost
+ * per call through the driver, through the per-call platform branches the
+ * common layer used before and of the mock called directly, and checks
+ * that every call reached the mock once.
+ *
+ * Usage: platform_bench [cycles]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "PnP_Common_Device.h"
+
+#define PLATFORM_BENCH_DEFAULT_CYCLES 1000000
+/* Device_* calls per telemetry cycle */
+#define PLATFORM_BENCH_CALLS 7
+
+/* Kept as calls like the Device_* functions in their own file */
+#define MOCK __attribute__((noinline))
+
+typedef enum
+{
+  mockReadSensors,
+  mockPublishSensorData,
+  mockPublishMotionEvent,
+  mockDisplaySensorData,
+  mockProcessCloudMessage,
+  mockGetTelemetrySendInterval,
+  mockIsStatusOK,
+  mockCalls
+} PlatformBenchCall_t;
+
+/* Defined by GW/src/main.cpp in the application */
+char displayText[150];
+
+static uint32_t mockCount[mockCalls];
+static uint32_t benchWrong = 0;
+
+static MOCK void Mock_readSensors()
+{
+  mockCount[mockReadSensors]++;
+}
+
+static MOCK void Mock_publishSensorData()
+{
+  mockCount[mockPublishSensorData]++;
+}
+
+static MOCK bool Mock_publishMotionEvent(const char *event, uint16_t count)
+{
+  (void)event;
+  mockCount[mockPublishMotionEvent] += count;
+  return true;
+}
+
+static MOCK void Mock_displaySensorData()
+{
+  mockCount[mockDisplaySensorData]++;
+}
+
+static MOCK void Mock_processCloudMessage()
+{
+  mockCount[mockProcessCloudMessage]++;
+}
+
+static MOCK unsigned long Mock_getTelemetrySendInterval()
+{
+  mockCount[mockGetTelemetrySendInterval]++;
+  return 30000;
+}
+
+static MOCK bool Mock_isStatusOK()
+{
+  mockCount[mockIsStatusOK]++;
+  return true;
+}
+
+static Device_Platform_t mockAzure;
+static Device_Platform_t mockKaaiot;
+static Device_Platform_t mockExtra[DEVICE_PLATFORMS_MAX - 1];
+
+/**
+ * @brief  Fill a mock driver that counts the calls of the cycles
+ * @param  platform Driver
+ * @param  id Platform of the driver
+ * @param  name Name and display name
+ * @retval None
+ */
+static void PlatformBench_mockPlatform(Device_Platform_t *platform, IoT_platforms_t id, const char *name)
+{
+  Bench_mockPlatform(platform, id, name);
+  platform->isStatusOK = Mock_isStatusOK;
+  platform->readSensors = Mock_readSensors;
+  platform->publishSensorData = Mock_publishSensorData;
+  platform->publishMotionEvent = Mock_publishMotionEvent;
+  platform->displaySensorData = Mock_displaySensorData;
+  platform->processCloudMessage = Mock_processCloudMessage;
+  platform->getTelemetrySendInterval = Mock_getTelemetrySendInterval;
+}
+
+/* Selected platform of the per-call branches */
+static IoT_platforms_t branchPlatform = AZURE;
+
+static void PlatformBench_check(bool ok, const char *what)
+{
+  if (!ok)
+  {
+    benchWrong++;
+    printf("wrong: %s\r\n", what);
+  }
+}
+
+/**
+ * @brief  Register the mocks and check the registry
+ * @retval None
+ */
+static void PlatformBench_checkRegistry()
+{
+  uint8_t registered = 0;
+  static const char *extraNames[DEVICE_PLATFORMS_MAX - 1] = {"MOCK_2", "MOCK_3", "MOCK_4"};
+
+  PlatformBench_mockPlatform(&mockAzure, AZURE, "MOCK_AZURE");
+  PlatformBench_mockPlatform(&mockKaaiot, KAAIOT, "MOCK_KAAIOT");
+  for (uint8_t i = 0; i < DEVICE_PLATFORMS_MAX - 1; i++)
+  {
+    PlatformBench_mockPlatform(&mockExtra[i], (IoT_platforms_t)(i + 2), extraNames[i]);
+  }
+  PlatformBench_check(Device_registerPlatform(&mockAzure), "replace Azure");
+  PlatformBench_check(Device_registerPlatform(&mockKaaiot), "replace KaaIoT");
+  PlatformBench_check(Device_findPlatform(AZURE) == &mockAzure, "find Azure mock");
+  PlatformBench_check(Device_findPlatform(KAAIOT) == &mockKaaiot, "find KaaIoT mock");
+  PlatformBench_check(Device_getPlatformDriver() == NULL, "no driver before the selection");
+
+  /* The built-in drivers take 2 places, or 1 if a platform is left out */
+  for (uint8_t i = 0; i < DEVICE_PLATFORMS_MAX - 1; i++)
+  {
+    registered += Device_registerPlatform(&mockExtra[i]);
+  }
+  PlatformBench_check(registered == DEVICE_PLATFORMS_MAX - 2, "table full");
+  PlatformBench_check(!Device_selectPlatform((IoT_platforms_t)4), "select an unregistered platform");
+
+  PlatformBench_check(Device_selectPlatform(KAAIOT) && (getPlatform() == KAAIOT), "select KaaIoT");
+  PlatformBench_check(Device_getNextPlatform() == &mockExtra[0], "next after KaaIoT");
+  PlatformBench_check(Device_selectPlatform((IoT_platforms_t)3), "select the last one");
+  PlatformBench_check(Device_getNextPlatform() == &mockAzure, "next wraps around");
+  PlatformBench_check(Device_selectPlatform(AZURE) && (Device_getPlatformDriver() == &mockAzure), "select Azure");
+}
+
+/* The per-call branches of the common layer before the drivers */
+static MOCK void Branch_readSensors()
+{
+  if (branchPlatform == KAAIOT)
+  {
+    mockKaaiot.readSensors();
+  }
+  else if (branchPlatform == AZURE)
+  {
+    mockAzure.readSensors();
+  }
+}
+
+static MOCK void Branch_publishSensorData()
+{
+  if (branchPlatform == KAAIOT)
+  {
+    mockKaaiot.publishSensorData();
+  }
+  else if (branchPlatform == AZURE)
+  {
+    mockAzure.publishSensorData();
+  }
+}
+
+static MOCK bool Branch_publishMotionEvent(const char *event, uint16_t count)
+{
+  if (branchPlatform == KAAIOT)
+  {
+    return mockKaaiot.publishMotionEvent(event, count);
+  }
+  else if (branchPlatform == AZURE)
+  {
+    return mockAzure.publishMotionEvent(event, count);
+  }
+  return false;
+}
+
+static MOCK void Branch_displaySensorData()
+{
+  if (branchPlatform == KAAIOT)
+  {
+    mockKaaiot.displaySensorData();
+  }
+  else if (branchPlatform == AZURE)
+  {
+    mockAzure.displaySensorData();
+  }
+}
+
+static MOCK void Branch_processCloudMessage()
+{
+  if (branchPlatform == KAAIOT)
+  {
+    mockKaaiot.processCloudMessage();
+  }
+  else if (branchPlatform == AZURE)
+  {
+    mockAzure.processCloudMessage();
+  }
+}
+
+static MOCK unsigned long Branch_getTelemetrySendInterval()
+{
+  if (branchPlatform == KAAIOT)
+  {
+    return mockKaaiot.getTelemetrySendInterval();
+  }
+  else if (branchPlatform == AZURE)
+  {
+    return mockAzure.getTelemetrySendInterval();
+  }
+  return 0;
+}
+
+static MOCK bool Branch_isStatusOK()
+{
+  if (branchPlatform == KAAIOT)
+  {
+    return mockKaaiot.isStatusOK();
+  }
+  else if (branchPlatform == AZURE)
+  {
+    return mockAzure.isStatusOK();
+  }
+  return false;
+}
+
+/**
+ * @brief  Check that every call of the cycles reached the mock once
+ * @param  cycles Telemetry cycles run
+ * @param  name Dispatch
+ * @retval None
+ */
+static void PlatformBench_checkCounts(uint32_t cycles, const char *name)
+{
+  for (uint8_t call = 0; call < mockCalls; call++)
+  {
+    if (mockCount[call] != cycles)
+    {
+      benchWrong++;
+      printf("wrong: %s call %u reached the mock %lu times\r\n", name, (unsigned int)call,
+             (unsigned long)mockCount[call]);
+    }
+  }
+  memset(mockCount, 0, sizeof(mockCount));
+}
+
+static double PlatformBench_nsPer(uint64_t startUs, uint64_t count)
+{
+  return count ? (double)(BasePlatform_micros64() - startUs) * 1000.0 / (double)count : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t cycles = (argc > 1) ? (uint32_t)atol(argv[1]) : PLATFORM_BENCH_DEFAULT_CYCLES;
+  uint64_t calls = (uint64_t)cycles * PLATFORM_BENCH_CALLS;
+  volatile unsigned long sink = 0;
+  uint64_t startUs;
+
+  PlatformBench_checkRegistry();
+  memset(mockCount, 0, sizeof(mockCount));
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < cycles; i++)
+  {
+    Device_readSensors();
+    Device_PublishSensorData();
+    sink += Device_PublishMotionEvent("doubleTap", 1);
+    Device_displaySensorData();
+    Device_processCloudMessage();
+    sink += Device_getTelemetrySendInterval();
+    sink += Device_isStatusOK();
+  }
+  printf("driver   %8.2f ns per call, Device_* through the selected driver\r\n", PlatformBench_nsPer(startUs, calls));
+  PlatformBench_checkCounts(cycles, "driver");
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < cycles; i++)
+  {
+    Branch_readSensors();
+    Branch_publishSensorData();
+    sink += Branch_publishMotionEvent("doubleTap", 1);
+    Branch_displaySensorData();
+    Branch_processCloudMessage();
+    sink += Branch_getTelemetrySendInterval();
+    sink += Branch_isStatusOK();
+  }
+  printf("branches %8.2f ns per call, platform compared at each call\r\n", PlatformBench_nsPer(startUs, calls));
+  PlatformBench_checkCounts(cycles, "branches");
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < cycles; i++)
+  {
+    Mock_readSensors();
+    Mock_publishSensorData();
+    sink += Mock_publishMotionEvent("doubleTap", 1);
+    Mock_displaySensorData();
+    Mock_processCloudMessage();
+    sink += Mock_getTelemetrySendInterval();
+    sink += Mock_isStatusOK();
+  }
+  printf("direct   %8.2f ns per call, single platform without dispatch\r\n", PlatformBench_nsPer(startUs, calls));
+  PlatformBench_checkCounts(cycles, "direct");
+
+  printf("%lu cycles of %u calls, %lu wrong\r\n", (unsigned long)cycles, PLATFORM_BENCH_CALLS,
+         (unsigned long)benchWrong);
+  return benchWrong ? 1 : 0;
+}
@@ -0,0 +1,280 @@
+/**
+ * \file
+ * \brief Throughput benchmark of the MQTT publish pipeline.
+ *
+ * Publishes telemetry sized messages through Calypso_MQTTPublishData to a
+ * simulated Calypso on a pipe. The simulator runs in a child process and
+ * answers each command with OK after the UART time of the command and a
+ * processing time, and sends a PUBACK event one broker round trip after
+ * the OK of a QoS 1 publish. A share of the PUBACKs can be lost to show
+ * the retransmissions. A share of them can come late, after the message
+ * was published again: the broker stalls and the PUBACKs behind stay in
+ * order. A late PUBACK counted for another message shows as a stray one.
+ *
+ * Three runs: QoS 1 waiting for each PUBACK like the publish did before,
+ * QoS 0, and QoS 1 with the in-flight window. Prints the messages per
+ * second and the publish counters of each run.
+ *
+ * Usage: publish_bench [messages] [round trip ms] [lost PUBACK %] [late PUBACK %]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "calypsoBoard.h"
+
+#define PUBLISH_BENCH_DEFAULT_MESSAGES 200
+#define PUBLISH_BENCH_DEFAULT_RTT_MS 50
+/* Fits CALYPSO_MQTT_RETRY_SIZE once encoded, to be published again */
+#define PUBLISH_BENCH_PAYLOAD_SIZE 160
+/* Long enough for the retransmissions of a lost PUBACK */
+#define PUBLISH_BENCH_FLUSH_MS ((CALYPSO_MQTT_MAX_RETRANSMITS + 1) * CALYPSO_MQTT_ACK_TIMEOUT + EVENT_WAIT_TIME)
+#define PUBLISH_BENCH_TOPIC "devices/gw-7f3a91/messages/events/"
+
+/* Simulated Calypso: 921600 baud UART like Device_init and AT command
+ * handling time */
+#define PUBLISH_BENCH_BYTE_US 11
+#define PUBLISH_BENCH_PROCESS_US 1000
+#define PUBLISH_BENCH_MAX_PENDING 64
+/* Delay of a late PUBACK, after the retransmission of its message */
+#define PUBLISH_BENCH_LATE_US ((CALYPSO_MQTT_ACK_TIMEOUT + 1000) * 1000)
+#define PUBLISH_BENCH_LINE_SIZE 2048
+
+typedef struct
+{
+  uint64_t dueUs;
+  const char *line;
+} PublishBenchOutput_t;
+
+/**
+ * @brief  Schedule a line sent by the simulated Calypso, in time order
+ * @param  pending Scheduled lines
+ * @param  count Number of scheduled lines
+ * @param  dueUs Time to send the line
+ * @param  line Line including CRLF
+ * @retval None
+ */
+static void PublishBench_schedule(PublishBenchOutput_t *pending, size_t *count, uint64_t dueUs, const char *line)
+{
+  size_t i = *count;
+
+  if (*count >= PUBLISH_BENCH_MAX_PENDING)
+  {
+    return;
+  }
+  while (i > 0 && pending[i - 1].dueUs > dueUs)
+  {
+    pending[i] = pending[i - 1];
+    i--;
+  }
+  pending[i].dueUs = dueUs;
+  pending[i].line = line;
+  (*count)++;
+}
+
+/**
+ * @brief  Simulated Calypso, runs until the gateway side closes the pipe
+ * @param  fdIn Commands from the gateway
+ * @param  fdOut Responses and events to the gateway
+ * @param  rttUs Broker round trip
+ * @param  lossPercent Share of the PUBACKs lost
+ * @param  latePercent Share of the PUBACKs sent PUBLISH_BENCH_LATE_US late
+ * @retval None
+ */
+static void PublishBench_calypso(int fdIn, int fdOut, uint64_t rttUs, uint32_t lossPercent, uint32_t latePercent)
+{
+  static char line[PUBLISH_BENCH_LINE_SIZE];
+  PublishBenchOutput_t pending[PUBLISH_BENCH_MAX_PENDING];
+  size_t count = 0;
+  size_t length = 0;
+  uint64_t busyUntilUs = 0;
+  uint64_t lastAckUs = 0;
+
+  for (;;)
+  {
+    uint64_t now = BasePlatform_micros64();
+    struct pollfd fd = {fdIn, POLLIN, 0};
+    int timeoutMs = -1;
+    char c;
+
+    while (count > 0 && pending[0].dueUs <= now)
+    {
+      if (write(fdOut, pending[0].line, strlen(pending[0].line)) < 0)
+      {
+        return;
+      }
+      memmove(&pending[0], &pending[1], (count - 1) * sizeof(pending[0]));
+      count--;
+    }
+    if (count > 0)
+    {
+      timeoutMs = (int)((pending[0].dueUs - now + 999) / 1000);
+    }
+    if (poll(&fd, 1, timeoutMs) <= 0)
+    {
+      continue;
+    }
+    if (read(fdIn, &c, 1) != 1)
+    {
+      return;
+    }
+    if (length < sizeof(line) - 1)
+    {
+      line[length++] = c;
+    }
+    if (c != '\n')
+    {
+      continue;
+    }
+
+    /* Commands are handled one after the other, the OK follows the UART
+     * transfer of the command */
+    line[length] = '\0';
+    now = BasePlatform_micros64();
+    busyUntilUs = ((busyUntilUs > now) ? busyUntilUs : now) + length * PUBLISH_BENCH_BYTE_US +
+                  PUBLISH_BENCH_PROCESS_US;
+    PublishBench_schedule(pending, &count, busyUntilUs, "OK\r\n");
+    if ((0 == strncasecmp(line, "AT+mqttPublish=", 15)) && (strstr(line, ",QOS1,") != NULL) &&
+        (Bench_random() % 100 >= lossPercent))
+    {
+      uint64_t ackUs = busyUntilUs + rttUs;
+
+      if (Bench_random() % 100 < latePercent)
+      {
+        ackUs += PUBLISH_BENCH_LATE_US;
+      }
+      /* The broker acknowledges in the order it received the messages */
+      if (ackUs < lastAckUs)
+      {
+        ackUs = lastAckUs;
+      }
+      lastAckUs = ackUs;
+      PublishBench_schedule(pending, &count, ackUs, "+eventmqtt:operation,puback\r\n");
+    }
+    length = 0;
+  }
+}
+
+/**
+ * @brief  Publish messages and wait for the acknowledgements
+ * @param  calypso Gateway side of the simulated Calypso
+ * @param  name Run name
+ * @param  qos QoS of the messages
+ * @param  waitAck true to wait for each PUBACK before the next message
+ * @param  messages Number of messages
+ * @retval None
+ */
+static void PublishBench_run(CALYPSO *calypso, const char *name, ATMQTT_QoS_t qos, bool waitAck, uint32_t messages)
+{
+  char payload[PUBLISH_BENCH_PAYLOAD_SIZE + 1];
+  Calypso_MQTTStats_t stats;
+  uint64_t startUs;
+  uint64_t sentUs;
+  uint64_t doneUs;
+
+  memset(payload, 'x', PUBLISH_BENCH_PAYLOAD_SIZE);
+  payload[PUBLISH_BENCH_PAYLOAD_SIZE] = '\0';
+  Calypso_MQTTresetStats();
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < messages; i++)
+  {
+    Calypso_MQTTPublishData(calypso, PUBLISH_BENCH_TOPIC, qos, 0, payload, PUBLISH_BENCH_PAYLOAD_SIZE, true);
+    if (waitAck)
+    {
+      Calypso_MQTTflush(calypso, PUBLISH_BENCH_FLUSH_MS);
+    }
+  }
+  sentUs = BasePlatform_micros64();
+  Calypso_MQTTflush(calypso, PUBLISH_BENCH_FLUSH_MS);
+  doneUs = BasePlatform_micros64();
+
+  Calypso_MQTTgetStats(&stats);
+  printf("%-12s %8.1f %8.1f %6lu %6lu %6lu %6lu %6lu %6lu %6lu %6lu\r\n", name,
+         messages * 1e6 / (double)(sentUs - startUs), messages * 1e6 / (double)(doneUs - startUs),
+         (unsigned long)(stats.published[0] + stats.published[1]), (unsigned long)stats.acked,
+         (unsigned long)stats.maxAckMs, (unsigned long)stats.retransmitted, (unsigned long)stats.unacked,
+         (unsigned long)stats.dropped, (unsigned long)stats.strayAcks, (unsigned long)stats.lateAcks);
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t messages = (argc > 1) ? (uint32_t)atol(argv[1]) : PUBLISH_BENCH_DEFAULT_MESSAGES;
+  uint32_t rttMs = (argc > 2) ? (uint32_t)atol(argv[2]) : PUBLISH_BENCH_DEFAULT_RTT_MS;
+  uint32_t lossPercent = (argc > 3) ? (uint32_t)atol(argv[3]) : 0;
+  uint32_t latePercent = (argc > 4) ? (uint32_t)atol(argv[4]) : 0;
+  CalypsoSettings settings;
+  CALYPSO *calypso;
+  int peerIn;
+  int peerOut;
+  pid_t child;
+
+  if (messages == 0)
+  {
+    messages = 1;
+  }
+  if (!BaseSerial_openPipe(&Serial1, &peerIn, &peerOut))
+  {
+    fprintf(stderr, "Unable to open the Calypso pipe\r\n");
+    return 1;
+  }
+  child = fork();
+  if (child < 0)
+  {
+    fprintf(stderr, "Unable to start the Calypso simulator\r\n");
+    return 1;
+  }
+  if (child == 0)
+  {
+    BaseSerial_close(&Serial1);
+    PublishBench_calypso(peerIn, peerOut, (uint64_t)rttMs * 1000, lossPercent, latePercent);
+    _exit(0);
+  }
+  close(peerIn);
+  close(peerOut);
+
+  /* The debug log is not initialized, the command traces are dropped */
+  memset(&settings, 0, sizeof(settings));
+  calypso = Calypso_Create(SSerial_create(&Serial), HSerial_create(&Serial1), &settings);
+  calypso->status = calypso_MQTT_connected;
+
+  printf("%lu messages of %d bytes, %lu ms round trip, %lu %% PUBACKs lost, %lu %% late, window %d\r\n",
+         (unsigned long)messages, PUBLISH_BENCH_PAYLOAD_SIZE, (unsigned long)rttMs, (unsigned long)lossPercent,
+         (unsigned long)latePercent, CALYPSO_MQTT_INFLIGHT);
+  printf("%-12s %8s %8s %6s %6s %6s %6s %6s %6s %6s %6s\r\n", "run", "sent/s", "acked/s", "sent", "acked", "max ms",
+         "resent", "unack", "drop", "stray", "late");
+  PublishBench_run(calypso, "qos1 wait", ATMQTT_QOS_QOS1, true, messages);
+  PublishBench_run(calypso, "qos0", ATMQTT_QOS_QOS0, false, messages);
+  PublishBench_run(calypso, "qos1 window", ATMQTT_QOS_QOS1, false, messages);
+
+  BaseSerial_close(&Serial1);
+  kill(child, SIGTERM);
+  waitpid(child, NULL, 0);
+  Calypso_Destroy(calypso);
+  return 0;
+}
+/**         EOF         */
@@ -0,0 +1,217 @@
+/**
+ * \file
+ * \brief I2C bus benchmark of the sensor drivers on the simulated WSEN sensors.
+ *
+ * Initializes the four sensors and reads them a number of times, then prints
+ * the transfers and the bus time at 100 and 400 kHz. Run it before and after
+ * a driver change to measure its effect on the bus. Then sweeps the
+ * simulated temperature and humidity over the sensor ranges and compares
+ * the integer readings with the float conversion the drivers used before.
+ *
+ * Usage: sensor_bench [reads] [period ms] [trace.csv]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <math.h>
+
+#include "ConfigPlatform.h"
+#include "SensorSimulator.h"
+#include "WSEN_HIDS_2523020210001.h"
+#include "WSEN_TIDS_2521020222501.h"
+#include "displayBoard.h"
+#include "sensorBoard.h"
+
+#define SENSOR_BENCH_DEFAULT_READS 5
+/* Slightly above the 1 Hz output data rate of the HIDS */
+#define SENSOR_BENCH_DEFAULT_PERIOD_MS 1100
+/* Sweeps in 0.01 degC and 0.01 %rH, the humidity beyond 0..100 % */
+#define SENSOR_BENCH_TEMPERATURE_MIN -4000
+#define SENSOR_BENCH_TEMPERATURE_MAX 12500
+#define SENSOR_BENCH_HUMIDITY_MIN -1000
+#define SENSOR_BENCH_HUMIDITY_MAX 11000
+/* Rounding error of the float interpolation, in 0.01 %rH */
+#define SENSOR_BENCH_HUMIDITY_TOLERANCE 1
+
+/**
+ * @brief  Show the readings like the PnP layer does after a publish and
+ *         wait until the display is up to date
+ * @retval Bytes sent to the display, control and address bytes excluded
+ */
+static uint64_t SensorBench_refreshDisplay(PADS *pads, ITDS *itds, TIDS *tids, HIDS *hids)
+{
+  char text[150];
+  SensorSim_stats_t before;
+  SensorSim_stats_t after;
+
+  snprintf(text, sizeof(text), "Status: Connected\r\nP:%0.2f kPa\r\nT:%0.2f C\r\nRH:%0.2f %%\r\nAcc: x:%0.2f g\r\n     y:%0.2f g\r\n     z:%0.2f g",
+           (float)pads->data[padsPressure] / PADS_PRESSURE_SCALE, (float)tids->data[tidsTemperature] / TIDS_TEMPERATURE_SCALE,
+           (float)hids->data[hidsRelHumidity] / HIDS_HUMIDITY_SCALE, (float)itds->data[itdsXAcceleration] / ITDS_ACCELERATION_SCALE,
+           (float)itds->data[itdsYAcceleration] / ITDS_ACCELERATION_SCALE, (float)itds->data[itdsZAcceleration] / ITDS_ACCELERATION_SCALE);
+  SensorSim_getStats(sensorSimSH1107, &before);
+  SH1107_Display(1, 0, 0, text);
+  SH1107_Flush();
+  SensorSim_getStats(sensorSimSH1107, &after);
+  return after.bytes - before.bytes;
+}
+
+/**
+ * @brief  Compare the integer readings of the TIDS and HIDS with the float
+ *         path, round(value * 100) of TIDS_getTemperature and
+ *         HIDS_getHumidity, over the sweeps. The float humidity is clamped
+ *         to 0..10000 like HIDS_getHumidity_int.
+ * @retval true if the temperatures are identical and the humidities within
+ *         the tolerance, false otherwise
+ */
+static bool SensorBench_checkConversions(TIDS *tids, HIDS *hids)
+{
+  SensorSim_waveform_t waveform;
+  uint32_t values = 0;
+  uint32_t mismatches = 0;
+  uint32_t clamped = 0;
+  int32_t maxDiff = 0;
+
+  memset(&waveform, 0, sizeof(waveform));
+  for (int32_t t = SENSOR_BENCH_TEMPERATURE_MIN; t <= SENSOR_BENCH_TEMPERATURE_MAX; t++)
+  {
+    float temperature;
+
+    waveform.offset = t;
+    SensorSim_setWaveform(sensorSimTemperature, &waveform);
+    BasePlatform_advanceClock(SENSOR_SIM_TIDS_CONVERSION_US);
+    if (!TIDS_readSensorData(tids) || (TIDS_getTemperature(&temperature) != WE_SUCCESS))
+    {
+      fprintf(stderr, "TIDS read failed at %ld\r\n", (long)t);
+      return false;
+    }
+    values++;
+    if ((int32_t)round(temperature * 100) != tids->data[tidsTemperature])
+    {
+      mismatches++;
+    }
+  }
+  printf("TIDS: %lu temperatures, %lu differ from the float path\r\n", (unsigned long)values, (unsigned long)mismatches);
+  if (mismatches != 0)
+  {
+    return false;
+  }
+
+  values = 0;
+  for (int32_t h = SENSOR_BENCH_HUMIDITY_MIN; h <= SENSOR_BENCH_HUMIDITY_MAX; h++)
+  {
+    float humidity;
+    int32_t expected;
+    int32_t diff;
+
+    waveform.offset = h;
+    SensorSim_setWaveform(sensorSimHumidity, &waveform);
+    BasePlatform_advanceClock((uint64_t)SENSOR_BENCH_DEFAULT_PERIOD_MS * 1000);
+    if (!HIDS_readSensorData(hids) || (HIDS_getHumidity(&humidity) != WE_SUCCESS))
+    {
+      fprintf(stderr, "HIDS read failed at %ld\r\n", (long)h);
+      return false;
+    }
+    values++;
+    expected = (int32_t)round(humidity * 100);
+    if ((expected < 0) || (expected > 10000))
+    {
+      clamped++;
+      expected = (expected < 0) ? 0 : 10000;
+    }
+    diff = labs(expected - hids->data[hidsRelHumidity]);
+    if (diff != 0)
+    {
+      mismatches++;
+      maxDiff = (diff > maxDiff) ? diff : maxDiff;
+    }
+  }
+  printf("HIDS: %lu humidities, %lu clamped, %lu differ from the float path, by %ld at most\r\n",
+         (unsigned long)values, (unsigned long)clamped, (unsigned long)mismatches, (long)maxDiff);
+  return maxDiff <= SENSOR_BENCH_HUMIDITY_TOLERANCE;
+}
+
+int main(int argc, char **argv)
+{
+  int reads = (argc > 1) ? atoi(argv[1]) : SENSOR_BENCH_DEFAULT_READS;
+  int periodMs = (argc > 2) ? atoi(argv[2]) : SENSOR_BENCH_DEFAULT_PERIOD_MS;
+  TypeSerial *debug;
+  PADS *pads;
+  ITDS *itds;
+  TIDS *tids;
+  HIDS *hids;
+  uint64_t displayBytes = 0;
+  uint64_t firstFrameBytes;
+
+  BasePlatform_setArgs(argc, argv);
+  SensorSim_init();
+  if (argc > 3 && !SensorSim_loadTrace(argv[3], true))
+  {
+    fprintf(stderr, "Cannot load trace %s\r\n", argv[3]);
+    return 1;
+  }
+
+  debug = SSerial_create(&Serial);
+  pads = PADSCreate(debug);
+  itds = ITDSCreate(debug);
+  tids = TIDSCreate(debug);
+  hids = HIDSCreate(debug);
+
+  if (!PADS_simpleInit(pads) || !ITDS_simpleInit(itds) || !TIDS_simpleInit(tids) || !HIDS_simpleInit(hids))
+  {
+    fprintf(stderr, "Sensor init failed\r\n");
+    return 1;
+  }
+  printf("Init\r\n");
+  SensorSim_printStats(stdout);
+  firstFrameBytes = SensorBench_refreshDisplay(pads, itds, tids, hids);
+  SensorSim_resetStats();
+
+  for (int i = 0; i < reads; i++)
+  {
+    delay(periodMs);
+    PADS_readSensorData(pads);
+    ITDS_readSensorData(itds);
+    TIDS_readSensorData(tids);
+    HIDS_readSensorData(hids);
+    displayBytes += SensorBench_refreshDisplay(pads, itds, tids, hids);
+  }
+  printf("%d reads, last: %ld Pa, %ld/%ld/%ld mg, %ld 0.01degC, %ld 0.01%%rH\r\n", reads,
+         (long)pads->data[padsPressure], (long)itds->data[itdsXAcceleration], (long)itds->data[itdsYAcceleration],
+         (long)itds->data[itdsZAcceleration], (long)tids->data[tidsTemperature], (long)hids->data[hidsRelHumidity]);
+  SensorSim_printStats(stdout);
+  /* A full redraw clears and rewrites the whole controller memory */
+  printf("Display: first frame %llu bytes, %llu bytes per refresh, full redraw %u bytes\r\n",
+         (unsigned long long)firstFrameBytes, (unsigned long long)(reads > 0 ? displayBytes / reads : 0),
+         2 * SH1107_PAGES * SH1107_PAGE_COLUMNS);
+  if (!SensorBench_checkConversions(tids, hids))
+  {
+    fprintf(stderr, "Integer conversion differs from the float path\r\n");
+    return 1;
+  }
+
+  PADSDestroy(pads);
+  ITDSDestroy(itds);
+  TIDSDestroy(tids);
+  HIDSDestroy(hids);
+  SSerial_destroy(debug);
+  return 0;
+}
+/**         EOF         */
@@ -0,0 +1,1520 @@
+/**
+ * \file
+ * \brief Register level I2C simulator of the WSEN sensors for the host build.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <strings.h>
+#include "SensorSimulator.h"
+#include "WSEN_HIDS_2523020210001.h"
+#include "WSEN_ITDS_2533020201601.h"
+#include "WSEN_PADS_2511020213301.h"
+#include "WSEN_TIDS_2521020222501.h"
+
+#define SENSOR_SIM_REGS 128
+#define SENSOR_SIM_FIFO_BYTES (PADS_FIFO_SIZE * PADS_FIFO_SAMPLE_SIZE)
+#define SENSOR_SIM_ITDS_FIFO_SIZE 32
+#define SENSOR_SIM_ITDS_SAMPLE_SIZE 6
+
+/* SCL cycles of a transfer: start, stop, 9 per byte, repeated start for reads */
+#define SENSOR_SIM_READ_BITS(n) (30 + 9 * (uint64_t)(n))
+#define SENSOR_SIM_WRITE_BITS(n) (20 + 9 * (uint64_t)(n))
+#define SENSOR_SIM_RAW_BITS(n) (11 + 9 * (uint64_t)(n))
+
+/* SH1107 display controller memory */
+#define SENSOR_SIM_SH1107_ADDRESS 0x3C
+#define SENSOR_SIM_SH1107_PAGES 16
+#define SENSOR_SIM_SH1107_COLUMNS 128
+
+typedef struct
+{
+  uint8_t address;
+  uint8_t regs[SENSOR_SIM_REGS];
+  uint8_t pointer; /* Register used by I2CReceive */
+
+  /* Continuous conversions */
+  uint32_t odrMilliHz;
+  uint64_t odrStartUs;
+  uint64_t samples;
+
+  /* One-shot conversion */
+  bool conversionPending;
+  uint64_t conversionDoneUs;
+
+  /* FIFO, a ring of samples in output register layout */
+  uint8_t fifo[SENSOR_SIM_FIFO_BYTES];
+  uint16_t fifoSize;
+  uint8_t sampleSize;
+  uint16_t fifoHead;
+  uint16_t fifoLevel;
+  bool fifoOverrun;
+
+  SensorSim_stats_t stats;
+} SensorSim_sensor_t;
+
+typedef struct
+{
+  void (*reset)(SensorSim_sensor_t *s);
+  void (*sample)(SensorSim_sensor_t *s, uint64_t timeUs);
+  void (*completeConversion)(SensorSim_sensor_t *s);
+  uint8_t (*read)(SensorSim_sensor_t *s, uint8_t reg);
+  void (*write)(SensorSim_sensor_t *s, uint8_t reg, uint8_t value);
+  bool (*autoIncrement)(SensorSim_sensor_t *s, uint8_t regAdr);
+  uint8_t (*next)(SensorSim_sensor_t *s, uint8_t reg);
+} SensorSim_ops_t;
+
+typedef struct
+{
+  uint32_t rows;
+  double *timeMs;
+  double *value;
+  bool loop;
+} SensorSim_trace_t;
+
+static const char *const channelNames[sensorSimChannels] = {
+    "pressure", "temperature", "humidity", "accX", "accY", "accZ"};
+
+static SensorSim_sensor_t sensors[sensorSimDevices];
+static SensorSim_waveform_t waveforms[sensorSimChannels];
+static SensorSim_trace_t traces[sensorSimChannels];
+static SensorSim_stats_t totalStats;
+static uint32_t busClock = I2C_CLOCK_SPEED_STANDARD;
+static uint64_t simNow = 0;
+static uint32_t noiseSeed = 1;
+static int itdsIntPin = -1;
+
+static uint8_t sh1107Ram[SENSOR_SIM_SH1107_PAGES][SENSOR_SIM_SH1107_COLUMNS];
+static uint8_t sh1107Page = 0;
+static uint8_t sh1107Column = 0;
+static uint8_t sh1107Arguments = 0; /* Argument bytes of the last command still expected */
+
+/***************************SIGNALS***************************/
+
+/**
+ * @brief  Uniform noise in [-1, 1], reproducible between runs
+ * @retval Noise sample
+ */
+static double SensorSim_noise()
+{
+  noiseSeed = noiseSeed * 1664525u + 1013904223u;
+  return ((double)(noiseSeed >> 8) / (double)(1u << 23)) - 1.0;
+}
+
+/**
+ * @brief  Interpolate a trace
+ * @param  trace Trace of the channel
+ * @param  timeUs Simulation time
+ * @retval Value in channel unit
+ */
+static double SensorSim_traceValue(const SensorSim_trace_t *trace, uint64_t timeUs)
+{
+  double first = trace->timeMs[0];
+  double last = trace->timeMs[trace->rows - 1];
+  double t = first + (double)timeUs / 1000.0;
+  uint32_t low = 0;
+  uint32_t high = trace->rows - 1;
+
+  if (trace->loop && last > first)
+  {
+    t = first + fmod(t - first, last - first);
+  }
+  if (t <= first)
+  {
+    return trace->value[0];
+  }
+  if (t >= last)
+  {
+    return trace->value[trace->rows - 1];
+  }
+  while (high - low > 1)
+  {
+    uint32_t mid = (low + high) / 2;
+    if (trace->timeMs[mid] <= t)
+    {
+      low = mid;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  if (trace->timeMs[high] == trace->timeMs[low])
+  {
+    return trace->value[low];
+  }
+  return trace->value[low] + (trace->value[high] - trace->value[low]) *
+                                 (t - trace->timeMs[low]) / (trace->timeMs[high] - trace->timeMs[low]);
+}
+
+/**
+ * @brief  Value of a physical quantity at a given time
+ * @param  channel Quantity
+ * @param  timeUs Simulation time
+ * @retval Value in channel unit
+ */
+static int32_t SensorSim_value(SensorSim_channel_t channel, uint64_t timeUs)
+{
+  const SensorSim_waveform_t *w = &waveforms[channel];
+  double t = (double)timeUs / 1000000.0;
+  double value;
+
+  if (traces[channel].rows > 0)
+  {
+    value = SensorSim_traceValue(&traces[channel], timeUs);
+  }
+  else
+  {
+    value = w->offset + w->slope * t;
+    if (w->amplitude != 0 && w->frequencyMilliHz != 0)
+    {
+      value += w->amplitude * sin(2.0 * M_PI * (w->frequencyMilliHz / 1000.0) * t);
+    }
+  }
+  if (waveforms[channel].noise != 0)
+  {
+    value += w->noise * SensorSim_noise();
+  }
+  return (int32_t)lround(value);
+}
+
+/***************************COMMON***************************/
+
+/**
+ * @brief  Empty the FIFO of a sensor
+ * @param  s Simulated sensor
+ * @retval none
+ */
+static void SensorSim_fifoClear(SensorSim_sensor_t *s)
+{
+  s->fifoHead = 0;
+  s->fifoLevel = 0;
+  s->fifoOverrun = false;
+}
+
+/**
+ * @brief  Store a sample in the FIFO
+ * @param  s Simulated sensor
+ * @param  sample Sample in output register layout
+ * @param  capacity Number of samples before the FIFO is full
+ * @param  stopWhenFull true in FIFO mode, false in continuous mode
+ * @retval none
+ */
+static void SensorSim_fifoPush(SensorSim_sensor_t *s, const uint8_t *sample, uint16_t capacity, bool stopWhenFull)
+{
+  if (s->fifoLevel >= capacity)
+  {
+    if (stopWhenFull)
+    {
+      return;
+    }
+    /* Continuous mode overwrites the oldest sample */
+    s->fifoHead = (s->fifoHead + 1) % s->fifoSize;
+    s->fifoLevel--;
+    s->fifoOverrun = true;
+  }
+  memcpy(&s->fifo[((s->fifoHead + s->fifoLevel) % s->fifoSize) * s->sampleSize], sample, s->sampleSize);
+  s->fifoLevel++;
+}
+
+/**
+ * @brief  Read a byte of the oldest sample in the FIFO
+ * @param  s Simulated sensor
+ * @param  offset Byte offset in the sample
+ * @param  pop remove the sample once read
+ * @retval Byte read
+ */
+static uint8_t SensorSim_fifoRead(SensorSim_sensor_t *s, uint8_t offset, bool pop)
+{
+  uint8_t value = s->fifo[s->fifoHead * s->sampleSize + offset];
+
+  if (pop)
+  {
+    s->fifoHead = (s->fifoHead + 1) % s->fifoSize;
+    s->fifoLevel--;
+    s->fifoOverrun = false;
+  }
+  return value;
+}
+
+/**
+ * @brief  Restart the continuous conversions of a sensor
+ * @param  s Simulated sensor
+ * @param  odrMilliHz New output data rate, 0 to stop
+ * @retval none
+ */
+static void SensorSim_setOdr(SensorSim_sensor_t *s, uint32_t odrMilliHz)
+{
+  s->odrMilliHz = odrMilliHz;
+  s->odrStartUs = simNow;
+  s->samples = 0;
+}
+
+/**
+ * @brief  Start a one-shot conversion
+ * @param  s Simulated sensor
+ * @param  latencyUs Conversion time
+ * @retval none
+ */
+static void SensorSim_startConversion(SensorSim_sensor_t *s, uint32_t latencyUs)
+{
+  s->conversionPending = true;
+  s->conversionDoneUs = simNow + latencyUs;
+}
+
+/***************************PADS***************************/
+
+static const uint32_t padsOdrMilliHz[8] = {0, 1000, 10000, 25000, 50000, 75000, 100000, 200000};
+
+static void PADS_simReset(SensorSim_sensor_t *s)
+{
+  memset(s->regs, 0, sizeof(s->regs));
+  s->regs[PADS_DEVICE_ID_REG] = PADS_DEVICE_ID_VALUE;
+  s->regs[PADS_CTRL_2_REG] = 0x10; /* IF_ADD_INC */
+  s->fifoSize = PADS_FIFO_SIZE;
+  s->sampleSize = PADS_FIFO_SAMPLE_SIZE;
+  s->conversionPending = false;
+  SensorSim_fifoClear(s);
+  SensorSim_setOdr(s, 0);
+}
+
+static uint16_t PADS_simFifoCapacity(SensorSim_sensor_t *s)
+{
+  uint8_t watermark = s->regs[PADS_FIFO_WTM_REG] & 0x7F;
+
+  /* STOP_ON_WTM limits the FIFO depth to the watermark */
+  if ((s->regs[PADS_FIFO_CTRL_REG] & 0x08) && watermark > 0)
+  {
+    return watermark;
+  }
+  return PADS_FIFO_SIZE;
+}
+
+static void PADS_simSample(SensorSim_sensor_t *s, uint64_t timeUs)
+{
+  /* 40960 LSB/kPa and 100 LSB/°C */
+  int32_t pressure = (int32_t)(((int64_t)SensorSim_value(sensorSimPressure, timeUs) * 1024 + 12) / 25);
+  int16_t temperature = (int16_t)SensorSim_value(sensorSimTemperature, timeUs);
+  uint8_t *out = &s->regs[PADS_DATA_P_XL_REG];
+  uint8_t *status = &s->regs[PADS_STATUS_REG];
+  uint8_t fifoMode = s->regs[PADS_FIFO_CTRL_REG] & 0x03;
+
+  out[0] = (uint8_t)pressure;
+  out[1] = (uint8_t)(pressure >> 8);
+  out[2] = (uint8_t)(pressure >> 16);
+  out[3] = (uint8_t)temperature;
+  out[4] = (uint8_t)(temperature >> 8);
+
+  /* P_OR and T_OR when the previous sample was not read */
+  *status |= (uint8_t)((*status & 0x03) << 4);
+  *status |= 0x03;
+
+  if (fifoMode != 0)
+  {
+    SensorSim_fifoPush(s, out, PADS_simFifoCapacity(s), fifoMode == 1);
+  }
+}
+
+static void PADS_simCompleteConversion(SensorSim_sensor_t *s)
+{
+  s->regs[PADS_CTRL_2_REG] &= (uint8_t)~0x01;
+}
+
+static uint8_t PADS_simRead(SensorSim_sensor_t *s, uint8_t reg)
+{
+  uint8_t watermark = s->regs[PADS_FIFO_WTM_REG] & 0x7F;
+  uint8_t value;
+
+  switch (reg)
+  {
+  case PADS_FIFO_STATUS1_REG:
+    return (uint8_t)s->fifoLevel;
+  case PADS_FIFO_STATUS2_REG:
+    value = 0;
+    if (watermark > 0 && s->fifoLevel >= watermark)
+      value |= 0x80;
+    if (s->fifoOverrun)
+      value |= 0x40;
+    if (s->fifoLevel >= PADS_simFifoCapacity(s))
+      value |= 0x20;
+    return value;
+  case PADS_DATA_P_H_REG:
+    s->regs[PADS_STATUS_REG] &= (uint8_t)~0x11;
+    return s->regs[reg];
+  case PADS_DATA_T_H_REG:
+    s->regs[PADS_STATUS_REG] &= (uint8_t)~0x22;
+    return s->regs[reg];
+  case PADS_FIFO_DATA_P_XL_REG:
+  case PADS_FIFO_DATA_P_L_REG:
+  case PADS_FIFO_DATA_P_H_REG:
+  case PADS_FIFO_DATA_T_L_REG:
+  case PADS_FIFO_DATA_T_H_REG:
+    if (s->fifoLevel == 0)
+    {
+      return s->regs[PADS_DATA_P_XL_REG + (reg - PADS_FIFO_DATA_P_XL_REG)];
+    }
+    /* The sample is released once its last byte is read */
+    return SensorSim_fifoRead(s, (uint8_t)(reg - PADS_FIFO_DATA_P_XL_REG), reg == PADS_FIFO_DATA_T_H_REG);
+  default:
+    return s->regs[reg];
+  }
+}
+
+static void PADS_simWrite(SensorSim_sensor_t *s, uint8_t reg, uint8_t value)
+{
+  switch (reg)
+  {
+  case PADS_DEVICE_ID_REG:
+  case PADS_INT_SOURCE_REG:
+  case PADS_FIFO_STATUS1_REG:
+  case PADS_FIFO_STATUS2_REG:
+  case PADS_STATUS_REG:
+    /* Read only */
+    break;
+  case PADS_CTRL_1_REG:
+    s->regs[reg] = value;
+    SensorSim_setOdr(s, padsOdrMilliHz[(value >> 4) & 0x07]);
+    break;
+  case PADS_CTRL_2_REG:
+    if (value & 0x04)
+    {
+      /* SWRESET restores the default register content */
+      PADS_simReset(s);
+      break;
+    }
+    s->regs[reg] = value & (uint8_t)~0x80;
+    if ((value & 0x01) && s->odrMilliHz == 0)
+    {
+      SensorSim_startConversion(s, SENSOR_SIM_PADS_CONVERSION_US);
+    }
+    else
+    {
+      s->regs[reg] &= (uint8_t)~0x01;
+    }
+    break;
+  case PADS_FIFO_CTRL_REG:
+    s->regs[reg] = value;
+    if ((value & 0x03) == 0)
+    {
+      /* Bypass mode */
+      SensorSim_fifoClear(s);
+    }
+    break;
+  default:
+    if (reg < PADS_FIFO_DATA_P_XL_REG)
+    {
+      s->regs[reg] = value;
+    }
+    break;
+  }
+}
+
+static bool PADS_simAutoIncrement(SensorSim_sensor_t *s, uint8_t regAdr)
+{
+  (void)regAdr;
+  return (s->regs[PADS_CTRL_2_REG] & 0x10) != 0;
+}
+
+static uint8_t PADS_simNext(SensorSim_sensor_t *s, uint8_t reg)
+{
+  (void)s;
+  /* Burst reads of the FIFO roll over to the next sample */
+  return (reg == PADS_FIFO_DATA_T_H_REG) ? PADS_FIFO_DATA_P_XL_REG : (uint8_t)((reg + 1) & 0x7F);
+}
+
+/***************************ITDS***************************/
+
+/* Per ODR[3:0], columns high performance, normal and low power */
+static const uint32_t itdsOdrMilliHz[3][10] = {
+    {0, 12500, 12500, 25000, 50000, 100000, 200000, 400000, 800000, 1600000},
+    {0, 12500, 12500, 25000, 50000, 100000, 200000, 200000, 800000, 1600000},
+    {0, 1600, 12500, 25000, 50000, 100000, 200000, 200000, 200000, 200000}};
+
+static void ITDS_simReset(SensorSim_sensor_t *s)
+{
+  memset(s->regs, 0, sizeof(s->regs));
+  s->regs[ITDS_DEVICE_ID_REG] = ITDS_DEVICE_ID_VALUE;
+  s->fifoSize = SENSOR_SIM_ITDS_FIFO_SIZE;
+  s->sampleSize = SENSOR_SIM_ITDS_SAMPLE_SIZE;
+  s->conversionPending = false;
+  SensorSim_fifoClear(s);
+  SensorSim_setOdr(s, 0);
+}
+
+static bool ITDS_simLowPower(SensorSim_sensor_t *s)
+{
+  uint8_t ctrl1 = s->regs[ITDS_CTRL_1_REG];
+  return (((ctrl1 >> 2) & 0x03) == 0) && ((ctrl1 & 0x03) == 0);
+}
+
+static void ITDS_simUpdateOdr(SensorSim_sensor_t *s)
+{
+  uint8_t ctrl1 = s->regs[ITDS_CTRL_1_REG];
+  uint8_t odr = ctrl1 >> 4;
+  uint8_t mode = (ctrl1 >> 2) & 0x03;
+
+  if (odr > 9 || mode > 1)
+  {
+    /* Power down or single data conversion on demand */
+    SensorSim_setOdr(s, 0);
+    return;
+  }
+  SensorSim_setOdr(s, itdsOdrMilliHz[(mode == 1) ? 0 : (ITDS_simLowPower(s) ? 2 : 1)][odr]);
+}
+
+static int16_t ITDS_simAcceleration(SensorSim_sensor_t *s, SensorSim_channel_t channel, uint64_t timeUs)
+{
+  uint8_t fullScale = (s->regs[ITDS_CTRL_6_REG] >> 4) & 0x03;
+  bool lowPower = ITDS_simLowPower(s);
+  /* 0.244 mg/LSB at 2g with 14 bit, 4x with 12 bit */
+  int64_t sensitivityUg = (int64_t)(lowPower ? 976 : 244) << fullScale;
+  int64_t limit = lowPower ? 2047 : 8191;
+  int64_t counts = ((int64_t)SensorSim_value(channel, timeUs) * 1000) / sensitivityUg;
+
+  if (counts > limit)
+    counts = limit;
+  else if (counts < -limit - 1)
+    counts = -limit - 1;
+  /* Left aligned in the 16 bit output */
+  return (int16_t)(counts * (lowPower ? 16 : 4));
+}
+
+static void ITDS_simSample(SensorSim_sensor_t *s, uint64_t timeUs)
+{
+  int16_t acc[3];
+  int32_t temperature = SensorSim_value(sensorSimTemperature, timeUs);
+  int16_t temp12 = (int16_t)(((temperature - 2500) * 16 / 100) * 16);
+  uint8_t *out = &s->regs[ITDS_X_OUT_L_REG];
+  uint8_t fifoMode = s->regs[ITDS_FIFO_CTRL_REG] >> 5;
+
+  acc[0] = ITDS_simAcceleration(s, sensorSimAccX, timeUs);
+  acc[1] = ITDS_simAcceleration(s, sensorSimAccY, timeUs);
+  acc[2] = ITDS_simAcceleration(s, sensorSimAccZ, timeUs);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    out[2 * i] = (uint8_t)acc[i];
+    out[2 * i + 1] = (uint8_t)(acc[i] >> 8);
+  }
+
+  /* 16 LSB/°C in T_OUT_L/H, 1 LSB/°C in T_OUT, 0 at 25 °C */
+  s->regs[ITDS_T_OUT_L_REG] = (uint8_t)temp12;
+  s->regs[ITDS_T_OUT_H_REG] = (uint8_t)(temp12 >> 8);
+  s->regs[ITDS_T_OUT_REG] = (uint8_t)(int8_t)((temperature - 2500) / 100);
+
+  s->regs[ITDS_STATUS_REG] |= 0x01;
+  s->regs[ITDS_STATUS_DETECT_REG] |= 0x41;
+
+  if (fifoMode != 0)
+  {
+    SensorSim_fifoPush(s, out, SENSOR_SIM_ITDS_FIFO_SIZE, fifoMode == 1);
+  }
+}
+
+static void ITDS_simCompleteConversion(SensorSim_sensor_t *s)
+{
+  s->regs[ITDS_CTRL_3_REG] &= (uint8_t)~0x01;
+}
+
+static uint8_t ITDS_simRead(SensorSim_sensor_t *s, uint8_t reg)
+{
+  uint8_t threshold = s->regs[ITDS_FIFO_CTRL_REG] & 0x1F;
+  bool fifoActive = (s->regs[ITDS_FIFO_CTRL_REG] >> 5) != 0;
+  bool thresholdReached = (threshold > 0) && (s->fifoLevel >= threshold);
+  uint8_t value;
+
+  switch (reg)
+  {
+  case ITDS_FIFO_SAMPLES_REG:
+    value = (uint8_t)s->fifoLevel;
+    if (s->fifoOverrun)
+      value |= 0x40;
+    if (thresholdReached)
+      value |= 0x80;
+    return value;
+  case ITDS_STATUS_REG:
+    return (uint8_t)((s->regs[reg] & 0x7F) | (thresholdReached ? 0x80 : 0));
+  case ITDS_STATUS_DETECT_REG:
+    return (uint8_t)((s->regs[reg] & 0x7F) | (s->fifoOverrun ? 0x80 : 0));
+  case ITDS_X_OUT_L_REG:
+  case ITDS_X_OUT_H_REG:
+  case ITDS_Y_OUT_L_REG:
+  case ITDS_Y_OUT_H_REG:
+  case ITDS_Z_OUT_L_REG:
+  case ITDS_Z_OUT_H_REG:
+    if (fifoActive && s->fifoLevel > 0)
+    {
+      return SensorSim_fifoRead(s, (uint8_t)(reg - ITDS_X_OUT_L_REG), reg == ITDS_Z_OUT_H_REG);
+    }
+    if (reg == ITDS_Z_OUT_H_REG)
+    {
+      s->regs[ITDS_STATUS_REG] &= (uint8_t)~0x01;
+      s->regs[ITDS_STATUS_DETECT_REG] &= (uint8_t)~0x01;
+    }
+    return s->regs[reg];
+  case ITDS_T_OUT_H_REG:
+    s->regs[ITDS_STATUS_DETECT_REG] &= (uint8_t)~0x40;
+    return s->regs[reg];
+  case ITDS_ALL_INT_EVENT_REG:
+    /* Reading ALL_INT_EVENT releases the latched events */
+    value = s->regs[reg];
+    s->regs[reg] = 0;
+    s->regs[ITDS_WAKE_UP_EVENT_REG] &= (uint8_t)~0x28;
+    s->regs[ITDS_TAP_EVENT_REG] = 0;
+    s->regs[ITDS_STATUS_REG] &= (uint8_t)~0x5E;
+    s->regs[ITDS_STATUS_DETECT_REG] &= (uint8_t)~0x1E;
+    return value;
+  default:
+    return s->regs[reg];
+  }
+}
+
+static void ITDS_simWrite(SensorSim_sensor_t *s, uint8_t reg, uint8_t value)
+{
+  switch (reg)
+  {
+  case ITDS_DEVICE_ID_REG:
+  case ITDS_T_OUT_L_REG:
+  case ITDS_T_OUT_H_REG:
+  case ITDS_T_OUT_REG:
+  case ITDS_STATUS_REG:
+  case ITDS_FIFO_SAMPLES_REG:
+  case ITDS_STATUS_DETECT_REG:
+  case ITDS_WAKE_UP_EVENT_REG:
+  case ITDS_TAP_EVENT_REG:
+  case ITDS_6D_EVENT_REG:
+  case ITDS_ALL_INT_EVENT_REG:
+    /* Read only */
+    break;
+  case ITDS_CTRL_1_REG:
+    s->regs[reg] = value;
+    ITDS_simUpdateOdr(s);
+    break;
+  case ITDS_CTRL_2_REG:
+    if (value & 0x40)
+    {
+      /* SOFT_RESET restores the default register content */
+      ITDS_simReset(s);
+      break;
+    }
+    s->regs[reg] = value & (uint8_t)~0x80;
+    break;
+  case ITDS_CTRL_3_REG:
+    s->regs[reg] = value;
+    /* SLP_MODE_1 triggered over I2C in single data conversion mode */
+    if ((value & 0x03) == 0x03 && ((s->regs[ITDS_CTRL_1_REG] >> 2) & 0x03) == 2)
+    {
+      SensorSim_startConversion(s, SENSOR_SIM_ITDS_CONVERSION_US);
+    }
+    break;
+  case ITDS_FIFO_CTRL_REG:
+    s->regs[reg] = value;
+    if ((value >> 5) == 0)
+    {
+      /* Bypass mode */
+      SensorSim_fifoClear(s);
+    }
+    break;
+  default:
+    if (reg >= ITDS_X_OUT_L_REG && reg <= ITDS_Z_OUT_H_REG)
+    {
+      break;
+    }
+    s->regs[reg] = value;
+    break;
+  }
+}
+
+static bool ITDS_simAutoIncrement(SensorSim_sensor_t *s, uint8_t regAdr)
+{
+  (void)regAdr;
+  return (s->regs[ITDS_CTRL_2_REG] & 0x04) != 0;
+}
+
+static uint8_t ITDS_simNext(SensorSim_sensor_t *s, uint8_t reg)
+{
+  (void)s;
+  return (uint8_t)((reg + 1) & 0x7F);
+}
+
+/***************************TIDS***************************/
+
+static const uint32_t tidsOdrMilliHz[4] = {25000, 50000, 100000, 200000};
+
+static void TIDS_simReset(SensorSim_sensor_t *s)
+{
+  /* The data registers keep the last conversion */
+  uint8_t dataL = s->regs[TIDS_DATA_T_L_REG];
+  uint8_t dataH = s->regs[TIDS_DATA_T_H_REG];
+
+  memset(s->regs, 0, sizeof(s->regs));
+  s->regs[TIDS_DEVICE_ID_REG] = TIDS_DEVICE_ID_VALUE;
+  s->regs[TIDS_DATA_T_L_REG] = dataL;
+  s->regs[TIDS_DATA_T_H_REG] = dataH;
+  s->conversionPending = false;
+  SensorSim_setOdr(s, 0);
+}
+
+static void TIDS_simSample(SensorSim_sensor_t *s, uint64_t timeUs)
+{
+  int16_t temperature = (int16_t)SensorSim_value(sensorSimTemperature, timeUs);
+  uint8_t high = s->regs[TIDS_LIMIT_T_H_REG];
+  uint8_t low = s->regs[TIDS_LIMIT_T_L_REG];
+
+  /* Output in 0.01 °C, limits in steps of 0.64 °C with 0 at 63 */
+  s->regs[TIDS_DATA_T_L_REG] = (uint8_t)temperature;
+  s->regs[TIDS_DATA_T_H_REG] = (uint8_t)(temperature >> 8);
+  if (high != 0 && temperature > ((int32_t)high - 63) * 64)
+  {
+    s->regs[TIDS_STATUS_REG] |= 0x02;
+  }
+  if (low != 0 && temperature < ((int32_t)low - 63) * 64)
+  {
+    s->regs[TIDS_STATUS_REG] |= 0x04;
+  }
+}
+
+static void TIDS_simCompleteConversion(SensorSim_sensor_t *s)
+{
+  s->regs[TIDS_CTRL_REG] &= (uint8_t)~0x01;
+  s->regs[TIDS_STATUS_REG] &= (uint8_t)~0x01;
+}
+
+static uint8_t TIDS_simRead(SensorSim_sensor_t *s, uint8_t reg)
+{
+  uint8_t value = s->regs[reg];
+
+  if (reg == TIDS_STATUS_REG)
+  {
+    /* Limit flags are cleared by reading the status */
+    s->regs[reg] &= 0x01;
+  }
+  return value;
+}
+
+static void TIDS_simWrite(SensorSim_sensor_t *s, uint8_t reg, uint8_t value)
+{
+  switch (reg)
+  {
+  case TIDS_DEVICE_ID_REG:
+  case TIDS_STATUS_REG:
+  case TIDS_DATA_T_L_REG:
+  case TIDS_DATA_T_H_REG:
+    /* Read only */
+    break;
+  case TIDS_CTRL_REG:
+    s->regs[reg] = value;
+    if (value & 0x04)
+    {
+      SensorSim_setOdr(s, tidsOdrMilliHz[(value >> 4) & 0x03]);
+    }
+    else
+    {
+      SensorSim_setOdr(s, 0);
+      if (value & 0x01)
+      {
+        s->regs[TIDS_STATUS_REG] |= 0x01;
+        SensorSim_startConversion(s, SENSOR_SIM_TIDS_CONVERSION_US);
+      }
+    }
+    break;
+  case TIDS_SOFT_RESET_REG:
+    if (value & 0x02)
+    {
+      TIDS_simReset(s);
+    }
+    s->regs[reg] = value;
+    break;
+  default:
+    s->regs[reg] = value;
+    break;
+  }
+}
+
+static bool TIDS_simAutoIncrement(SensorSim_sensor_t *s, uint8_t regAdr)
+{
+  (void)regAdr;
+  return (s->regs[TIDS_CTRL_REG] & 0x08) != 0;
+}
+
+/***************************HIDS***************************/
+
+/* Calibration: 20 %rH -> 0, 80 %rH -> 12000, 10 °C -> 0, 35 °C -> 2500 */
+#define HIDS_SIM_H0_RH_X2 40
+#define HIDS_SIM_H1_RH_X2 160
+#define HIDS_SIM_H1_T0_OUT 12000
+#define HIDS_SIM_T0_DEGC_X8 80
+#define HIDS_SIM_T1_DEGC_X8 280
+#define HIDS_SIM_T1_OUT 2500
+
+static const uint32_t hidsOdrMilliHz[4] = {0, 1000, 7000, 12500};
+
+static void HIDS_simReset(SensorSim_sensor_t *s)
+{
+  memset(s->regs, 0, sizeof(s->regs));
+  s->regs[HIDS_DEVICE_ID_REG] = HIDS_DEVICE_ID_VALUE;
+  s->regs[HIDS_Average_REG] = 0x1B;
+  s->regs[HIDS_H0_RH_X2] = HIDS_SIM_H0_RH_X2;
+  s->regs[HIDS_H1_RH_X2] = HIDS_SIM_H1_RH_X2;
+  s->regs[HIDS_T0_DEGC_X8] = (uint8_t)HIDS_SIM_T0_DEGC_X8;
+  s->regs[HIDS_T1_DEGC_X8] = (uint8_t)HIDS_SIM_T1_DEGC_X8;
+  s->regs[HIDS_T0_T1_DEGC_H2] = (uint8_t)(((HIDS_SIM_T1_DEGC_X8 >> 8) << 2) | (HIDS_SIM_T0_DEGC_X8 >> 8));
+  s->regs[HIDS_H1_T0_OUT_L] = (uint8_t)HIDS_SIM_H1_T0_OUT;
+  s->regs[HIDS_H1_T0_OUT_H] = (uint8_t)(HIDS_SIM_H1_T0_OUT >> 8);
+  s->regs[HIDS_T1_OUT_L] = (uint8_t)HIDS_SIM_T1_OUT;
+  s->regs[HIDS_T1_OUT_H] = (uint8_t)(HIDS_SIM_T1_OUT >> 8);
+  s->conversionPending = false;
+  SensorSim_setOdr(s, 0);
+}
+
+static void HIDS_simSample(SensorSim_sensor_t *s, uint64_t timeUs)
+{
+  int32_t humidity = SensorSim_value(sensorSimHumidity, timeUs);
+  int32_t temperature = SensorSim_value(sensorSimTemperature, timeUs);
+  int32_t h0 = HIDS_SIM_H0_RH_X2 * 50;
+  int32_t h1 = HIDS_SIM_H1_RH_X2 * 50;
+  int32_t t0 = HIDS_SIM_T0_DEGC_X8 * 25 / 2;
+  int32_t t1 = HIDS_SIM_T1_DEGC_X8 * 25 / 2;
+  int16_t hOut = (int16_t)((humidity - h0) * HIDS_SIM_H1_T0_OUT / (h1 - h0));
+  int16_t tOut = (int16_t)((temperature - t0) * HIDS_SIM_T1_OUT / (t1 - t0));
+
+  s->regs[HIDS_H_OUT_L_REG] = (uint8_t)hOut;
+  s->regs[HIDS_H_OUT_H_REG] = (uint8_t)(hOut >> 8);
+  s->regs[HIDS_T_OUT_L_REG] = (uint8_t)tOut;
+  s->regs[HIDS_T_OUT_H_REG] = (uint8_t)(tOut >> 8);
+  s->regs[HIDS_STATUS_REG] |= 0x03;
+}
+
+static void HIDS_simCompleteConversion(SensorSim_sensor_t *s)
+{
+  s->regs[HIDS_CTRL_REG_2] &= (uint8_t)~0x01;
+}
+
+static uint8_t HIDS_simRead(SensorSim_sensor_t *s, uint8_t reg)
+{
+  if (reg == HIDS_H_OUT_H_REG)
+  {
+    s->regs[HIDS_STATUS_REG] &= (uint8_t)~0x01;
+  }
+  else if (reg == HIDS_T_OUT_H_REG)
+  {
+    s->regs[HIDS_STATUS_REG] &= (uint8_t)~0x02;
+  }
+  return s->regs[reg];
+}
+
+static void HIDS_simWrite(SensorSim_sensor_t *s, uint8_t reg, uint8_t value)
+{
+  bool active = (s->regs[HIDS_CTRL_REG_1] & 0x80) != 0;
+
+  if (reg == HIDS_DEVICE_ID_REG || reg == HIDS_STATUS_REG ||
+      (reg >= HIDS_H_OUT_L_REG && reg <= HIDS_T1_OUT_H))
+  {
+    /* Read only and calibration registers */
+    return;
+  }
+  switch (reg)
+  {
+  case HIDS_CTRL_REG_1:
+    s->regs[reg] = value;
+    SensorSim_setOdr(s, (value & 0x80) ? hidsOdrMilliHz[value & 0x03] : 0);
+    break;
+  case HIDS_CTRL_REG_2:
+    if (value & 0x80)
+    {
+      /* BOOT reloads the calibration */
+      HIDS_simReset(s);
+      s->regs[HIDS_CTRL_REG_1] = 0;
+    }
+    s->regs[reg] = value & (uint8_t)~0x80;
+    if ((value & 0x01) && active && s->odrMilliHz == 0)
+    {
+      SensorSim_startConversion(s, SENSOR_SIM_HIDS_CONVERSION_US);
+    }
+    else
+    {
+      s->regs[reg] &= (uint8_t)~0x01;
+    }
+    break;
+  default:
+    s->regs[reg] = value;
+    break;
+  }
+}
+
+static bool HIDS_simAutoIncrement(SensorSim_sensor_t *s, uint8_t regAdr)
+{
+  (void)s;
+  /* The MSB of the sub-address enables the auto increment */
+  return (regAdr & 0x80) != 0;
+}
+
+/***************************SH1107***************************/
+
+static void SH1107_simReset(SensorSim_sensor_t *s)
+{
+  (void)s;
+  memset(sh1107Ram, 0, sizeof(sh1107Ram));
+  sh1107Page = 0;
+  sh1107Column = 0;
+  sh1107Arguments = 0;
+}
+
+static void SH1107_simSample(SensorSim_sensor_t *s, uint64_t timeUs)
+{
+  (void)s;
+  (void)timeUs;
+}
+
+static void SH1107_simCompleteConversion(SensorSim_sensor_t *s)
+{
+  (void)s;
+}
+
+static uint8_t SH1107_simRead(SensorSim_sensor_t *s, uint8_t reg)
+{
+  (void)s;
+  (void)reg;
+  /* Status byte, never busy */
+  return 0;
+}
+
+/* The register address is the control byte: D/C selects commands or data */
+static void SH1107_simWrite(SensorSim_sensor_t *s, uint8_t reg, uint8_t value)
+{
+  (void)s;
+  if (reg & 0x40)
+  {
+    sh1107Ram[sh1107Page][sh1107Column] = value;
+    sh1107Column = (sh1107Column + 1) % SENSOR_SIM_SH1107_COLUMNS;
+    return;
+  }
+  if (sh1107Arguments > 0)
+  {
+    sh1107Arguments--;
+    return;
+  }
+  if ((value & 0xF0) == 0xB0)
+  {
+    sh1107Page = value & 0x0F;
+  }
+  else if ((value & 0xF0) == 0x00)
+  {
+    sh1107Column = (sh1107Column & 0x70) | (value & 0x0F);
+  }
+  else if ((value & 0xF8) == 0x10)
+  {
+    sh1107Column = (sh1107Column & 0x0F) | ((value & 0x07) << 4);
+  }
+  else
+  {
+    /* Contrast, multiplex, offset, clock, charge periods, VCOM, start line, DC-DC */
+    switch (value)
+    {
+    case 0x81:
+    case 0xA8:
+    case 0xAD:
+    case 0xD3:
+    case 0xD5:
+    case 0xD9:
+    case 0xDB:
+    case 0xDC:
+      sh1107Arguments = 1;
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+static bool SH1107_simAutoIncrement(SensorSim_sensor_t *s, uint8_t regAdr)
+{
+  (void)s;
+  (void)regAdr;
+  /* Every byte goes through the same control byte */
+  return false;
+}
+
+static const SensorSim_ops_t sensorOps[sensorSimDevices] = {
+    {PADS_simReset, PADS_simSample, PADS_simCompleteConversion, PADS_simRead, PADS_simWrite, PADS_simAutoIncrement, PADS_simNext},
+    {ITDS_simReset, ITDS_simSample, ITDS_simCompleteConversion, ITDS_simRead, ITDS_simWrite, ITDS_simAutoIncrement, ITDS_simNext},
+    {TIDS_simReset, TIDS_simSample, TIDS_simCompleteConversion, TIDS_simRead, TIDS_simWrite, TIDS_simAutoIncrement, ITDS_simNext},
+    {HIDS_simReset, HIDS_simSample, HIDS_simCompleteConversion, HIDS_simRead, HIDS_simWrite, HIDS_simAutoIncrement, ITDS_simNext},
+    {SH1107_simReset, SH1107_simSample, SH1107_simCompleteConversion, SH1107_simRead, SH1107_simWrite, SH1107_simAutoIncrement, ITDS_simNext}};
+
+/***************************BUS MODEL***************************/
+
+/**
+ * @brief  Find the simulated sensor answering to an address
+ * @param  address I2C address
+ * @retval Sensor index or sensorSimDevices if none answers
+ */
+static SensorSim_device_t SensorSim_find(int address)
+{
+  for (uint8_t i = 0; i < sensorSimDevices; i++)
+  {
+    if (sensors[i].address == address)
+    {
+      return (SensorSim_device_t)i;
+    }
+  }
+  return sensorSimDevices;
+}
+
+/**
+ * @brief  Bring a sensor up to the current time before an access
+ * @param  device Simulated sensor
+ * @retval none
+ */
+static void SensorSim_update(SensorSim_device_t device)
+{
+  SensorSim_sensor_t *s = &sensors[device];
+  const SensorSim_ops_t *ops = &sensorOps[device];
+  uint64_t due;
+
+  simNow = BasePlatform_micros64();
+
+  if (s->conversionPending && simNow >= s->conversionDoneUs)
+  {
+    s->conversionPending = false;
+    ops->sample(s, s->conversionDoneUs);
+    ops->completeConversion(s);
+  }
+
+  if (s->odrMilliHz == 0)
+  {
+    return;
+  }
+  due = (simNow - s->odrStartUs) * s->odrMilliHz / 1000000000ULL;
+  if (due > s->samples + s->fifoSize + 1)
+  {
+    /* Older samples would be lost anyway, only replay enough to overrun */
+    s->samples = due - s->fifoSize - 1;
+  }
+  while (s->samples < due)
+  {
+    s->samples++;
+    ops->sample(s, s->odrStartUs + s->samples * 1000000000ULL / s->odrMilliHz);
+  }
+}
+
+/**
+ * @brief  Account a transfer in the statistics of a sensor and the total
+ * @param  device Simulated sensor
+ * @param  read true for a read
+ * @param  bytes Payload bytes
+ * @param  bits SCL cycles of the transfer
+ * @retval none
+ */
+static void SensorSim_count(SensorSim_device_t device, bool read, int bytes, uint64_t bits)
+{
+  SensorSim_stats_t *stats[2] = {&totalStats, (device < sensorSimDevices) ? &sensors[device].stats : NULL};
+  uint64_t timeNs = bits * 1000000000ULL / busClock;
+
+  for (uint8_t i = 0; i < 2; i++)
+  {
+    if (stats[i] == NULL)
+    {
+      continue;
+    }
+    stats[i]->transactions++;
+    if (device >= sensorSimDevices)
+    {
+      stats[i]->nacks++;
+    }
+    else if (read)
+    {
+      stats[i]->reads++;
+    }
+    else
+    {
+      stats[i]->writes++;
+    }
+    stats[i]->bytes += (uint64_t)bytes;
+    stats[i]->busBits += bits;
+    stats[i]->busTimeNs += timeNs;
+  }
+}
+
+static int8_t SensorSim_readReg(void *context, int address, uint8_t regAdr, int length, uint8_t *data)
+{
+  SensorSim_device_t device = SensorSim_find(address);
+  SensorSim_sensor_t *s;
+  const SensorSim_ops_t *ops;
+  uint8_t reg = regAdr & 0x7F;
+  bool autoIncrement;
+
+  (void)context;
+  if (device == sensorSimDevices)
+  {
+    /* Address not acknowledged */
+    SensorSim_count(device, true, 0, SENSOR_SIM_RAW_BITS(0));
+    return WE_FAIL;
+  }
+  s = &sensors[device];
+  ops = &sensorOps[device];
+  SensorSim_update(device);
+  SensorSim_count(device, true, length, SENSOR_SIM_READ_BITS(length));
+
+  autoIncrement = ops->autoIncrement(s, regAdr);
+  for (int i = 0; i < length; i++)
+  {
+    data[i] = ops->read(s, reg);
+    if (autoIncrement)
+    {
+      reg = ops->next(s, reg);
+    }
+  }
+  s->pointer = reg;
+  return WE_SUCCESS;
+}
+
+static int8_t SensorSim_writeReg(void *context, int address, uint8_t regAdr, int length, const uint8_t *data)
+{
+  SensorSim_device_t device = SensorSim_find(address);
+  SensorSim_sensor_t *s;
+  const SensorSim_ops_t *ops;
+  uint8_t reg = regAdr & 0x7F;
+  bool autoIncrement;
+
+  (void)context;
+  if (device == sensorSimDevices)
+  {
+    SensorSim_count(device, false, 0, SENSOR_SIM_RAW_BITS(0));
+    return WE_FAIL;
+  }
+  s = &sensors[device];
+  ops = &sensorOps[device];
+  SensorSim_update(device);
+  SensorSim_count(device, false, length, SENSOR_SIM_WRITE_BITS(length));
+
+  autoIncrement = ops->autoIncrement(s, regAdr);
+  for (int i = 0; i < length; i++)
+  {
+    ops->write(s, reg, data[i]);
+    if (autoIncrement)
+    {
+      reg = ops->next(s, reg);
+    }
+  }
+  s->pointer = reg;
+  return WE_SUCCESS;
+}
+
+static int8_t SensorSim_send(void *context, int address, const uint8_t *data, int length)
+{
+  SensorSim_device_t device = SensorSim_find(address);
+
+  if (length == 0 || device == sensorSimDevices)
+  {
+    /* Address only, used to probe the bus */
+    SensorSim_count(device, false, 0, SENSOR_SIM_RAW_BITS(0));
+    return (device == sensorSimDevices) ? WE_FAIL : WE_SUCCESS;
+  }
+  /* The first byte sets the register pointer */
+  return SensorSim_writeReg(context, address, data[0], length - 1, data + 1);
+}
+
+static int8_t SensorSim_receive(void *context, int address, uint8_t *data, int length)
+{
+  SensorSim_device_t device = SensorSim_find(address);
+  SensorSim_sensor_t *s;
+  const SensorSim_ops_t *ops;
+  uint8_t reg;
+  bool autoIncrement;
+
+  (void)context;
+  if (device == sensorSimDevices)
+  {
+    SensorSim_count(device, true, 0, SENSOR_SIM_RAW_BITS(0));
+    return WE_FAIL;
+  }
+  s = &sensors[device];
+  ops = &sensorOps[device];
+  reg = s->pointer;
+  SensorSim_update(device);
+  SensorSim_count(device, true, length, SENSOR_SIM_RAW_BITS(length));
+
+  autoIncrement = ops->autoIncrement(s, reg);
+  for (int i = 0; i < length; i++)
+  {
+    data[i] = ops->read(s, reg);
+    if (autoIncrement)
+    {
+      reg = ops->next(s, reg);
+    }
+  }
+  s->pointer = reg;
+  return WE_SUCCESS;
+}
+
+static void SensorSim_setClock(void *context, uint32_t baudrate)
+{
+  (void)context;
+  if (baudrate > 0)
+  {
+    busClock = baudrate;
+  }
+}
+
+/***************************API***************************/
+
+/**
+ * @brief  Reset the simulated sensors to their power-on state, restore the
+ *         default signals and attach the simulator to the I2C bus
+ * @retval none
+ */
+void SensorSim_init()
+{
+  static const uint8_t addresses[sensorSimDevices] = {
+      PADS_ADDRESS_I2C_1, ITDS_ADDRESS_I2C_1, TIDS_ADDRESS_I2C_1, HIDS_ADDRESS_I2C_0, SENSOR_SIM_SH1107_ADDRESS};
+  I2CBusModel_t model = {NULL, SensorSim_readReg, SensorSim_writeReg, SensorSim_send, SensorSim_receive, SensorSim_setClock};
+
+  simNow = BasePlatform_micros64();
+  for (uint8_t i = 0; i < sensorSimDevices; i++)
+  {
+    memset(&sensors[i], 0, sizeof(sensors[i]));
+    sensors[i].address = addresses[i];
+    SensorSim_reset((SensorSim_device_t)i);
+  }
+
+  /* Standard atmosphere, 23 °C, 45 %rH, lying flat */
+  memset(waveforms, 0, sizeof(waveforms));
+  waveforms[sensorSimPressure].offset = 101325;
+  waveforms[sensorSimTemperature].offset = 2300;
+  waveforms[sensorSimHumidity].offset = 4500;
+  waveforms[sensorSimAccZ].offset = 1000;
+  SensorSim_clearTraces();
+
+  busClock = I2C_CLOCK_SPEED_STANDARD;
+  noiseSeed = 1;
+  itdsIntPin = -1;
+  SensorSim_resetStats();
+  I2CSetBusModel(&model);
+}
+
+/**
+ * @brief  Reset a simulated sensor to its power-on state
+ * @param  device Simulated sensor
+ * @retval none
+ */
+void SensorSim_reset(SensorSim_device_t device)
+{
+  if (device >= sensorSimDevices)
+  {
+    return;
+  }
+  simNow = BasePlatform_micros64();
+  sensorOps[device].reset(&sensors[device]);
+}
+
+/**
+ * @brief  Set the waveform of a quantity, used when no trace is loaded for it
+ * @param  channel Quantity
+ * @param  waveform Waveform, copied
+ * @retval none
+ */
+void SensorSim_setWaveform(SensorSim_channel_t channel, const SensorSim_waveform_t *waveform)
+{
+  if (channel < sensorSimChannels && waveform != NULL)
+  {
+    waveforms[channel] = *waveform;
+  }
+}
+
+/**
+ * @brief  Load a recorded CSV trace. The first column is the time in ms, the
+ *         header names the other columns after the quantities (pressure,
+ *         temperature, humidity, accX, accY, accZ) in the channel units.
+ *         Unknown columns are ignored.
+ * @param  path CSV file
+ * @param  loop replay the trace from the start once its end is reached
+ * @retval true if successful false in case of failure
+ */
+bool SensorSim_loadTrace(const char *path, bool loop)
+{
+  char line[512];
+  int columns[sensorSimChannels + 1];
+  int columnCount = 0;
+  uint32_t capacity = 0;
+  uint32_t rows = 0;
+  double *timeMs = NULL;
+  double *values[sensorSimChannels] = {NULL};
+  bool found = false;
+  FILE *file = fopen(path, "r");
+
+  if (file == NULL)
+  {
+    return false;
+  }
+
+  /* Header */
+  if (fgets(line, sizeof(line), file) == NULL)
+  {
+    fclose(file);
+    return false;
+  }
+  for (char *token = strtok(line, ",\r\n"); token != NULL && columnCount <= sensorSimChannels; token = strtok(NULL, ",\r\n"))
+  {
+    columns[columnCount] = -1;
+    while (*token == ' ')
+    {
+      token++;
+    }
+    for (int c = 0; columnCount > 0 && c < sensorSimChannels; c++)
+    {
+      if (strcasecmp(token, channelNames[c]) == 0)
+      {
+        columns[columnCount] = c;
+        found = true;
+      }
+    }
+    columnCount++;
+  }
+  if (!found)
+  {
+    fclose(file);
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), file) != NULL && rows < SENSOR_SIM_TRACE_MAX_ROWS)
+  {
+    char *cursor = line;
+    char *end;
+    double fields[sensorSimChannels + 1];
+    int count = 0;
+
+    if (line[0] == '#' || line[0] == '\r' || line[0] == '\n')
+    {
+      continue;
+    }
+    while (count < columnCount)
+    {
+      fields[count] = strtod(cursor, &end);
+      if (end == cursor)
+      {
+        break;
+      }
+      count++;
+      cursor = (*end == ',') ? end + 1 : end;
+    }
+    if (count < columnCount)
+    {
+      continue;
+    }
+
+    if (rows == capacity)
+    {
+      capacity = capacity ? capacity * 2 : 256;
+      timeMs = (double *)realloc(timeMs, capacity * sizeof(double));
+      for (int c = 0; c < sensorSimChannels; c++)
+      {
+        values[c] = (double *)realloc(values[c], capacity * sizeof(double));
+      }
+    }
+    timeMs[rows] = fields[0];
+    for (int i = 1; i < columnCount; i++)
+    {
+      if (columns[i] >= 0)
+      {
+        values[columns[i]][rows] = fields[i];
+      }
+    }
+    rows++;
+  }
+  fclose(file);
+
+  for (int i = 1; i < columnCount; i++)
+  {
+    int c = columns[i];
+    if (c < 0 || rows == 0)
+    {
+      continue;
+    }
+    free(traces[c].timeMs);
+    free(traces[c].value);
+    traces[c].rows = rows;
+    traces[c].loop = loop;
+    traces[c].timeMs = (double *)malloc(rows * sizeof(double));
+    traces[c].value = values[c];
+    values[c] = NULL;
+    memcpy(traces[c].timeMs, timeMs, rows * sizeof(double));
+  }
+  free(timeMs);
+  for (int c = 0; c < sensorSimChannels; c++)
+  {
+    free(values[c]);
+  }
+  return rows > 0;
+}
+
+/**
+ * @brief  Unload all traces, the waveforms are used again
+ * @retval none
+ */
+void SensorSim_clearTraces()
+{
+  for (uint8_t c = 0; c < sensorSimChannels; c++)
+  {
+    free(traces[c].timeMs);
+    free(traces[c].value);
+    memset(&traces[c], 0, sizeof(traces[c]));
+  }
+}
+
+/**
+ * @brief  Set the host pin the ITDS INT_0 output is wired to
+ * @param  pin Pin number, -1 if not connected
+ * @retval none
+ */
+void SensorSim_setItdsIntPin(int pin)
+{
+  itdsIntPin = pin;
+}
+
+/**
+ * @brief  Latch motion events in the ITDS as its detectors would, and raise
+ *         INT_0 if one of them is routed to it
+ * @param  allIntEvents bits of ALL_INT_EVENT (free-fall, wake-up, single
+ *         tap, double tap, 6D, sleep change)
+ * @param  sleep new sleep state, reported with a sleep change
+ * @retval none
+ */
+void SensorSim_injectItdsEvent(uint8_t allIntEvents, bool sleep)
+{
+  SensorSim_sensor_t *s = &sensors[sensorSimITDS];
+  uint8_t ctrl4 = s->regs[ITDS_CTRL_4_REG];
+  uint8_t routed = 0;
+
+  SensorSim_update(sensorSimITDS);
+
+  s->regs[ITDS_ALL_INT_EVENT_REG] |= allIntEvents & 0x3F;
+  if (allIntEvents & 0x01)
+  {
+    s->regs[ITDS_STATUS_REG] |= 0x02;
+    s->regs[ITDS_STATUS_DETECT_REG] |= 0x02;
+    s->regs[ITDS_WAKE_UP_EVENT_REG] |= 0x20;
+  }
+  if (allIntEvents & 0x02)
+  {
+    s->regs[ITDS_STATUS_REG] |= 0x40;
+    s->regs[ITDS_WAKE_UP_EVENT_REG] |= 0x08;
+  }
+  if (allIntEvents & 0x04)
+  {
+    s->regs[ITDS_STATUS_REG] |= 0x08;
+    s->regs[ITDS_STATUS_DETECT_REG] |= 0x08;
+    s->regs[ITDS_TAP_EVENT_REG] |= 0x60;
+  }
+  if (allIntEvents & 0x08)
+  {
+    s->regs[ITDS_STATUS_REG] |= 0x10;
+    s->regs[ITDS_STATUS_DETECT_REG] |= 0x10;
+    s->regs[ITDS_TAP_EVENT_REG] |= 0x50;
+  }
+  if (allIntEvents & 0x20)
+  {
+    if (sleep)
+    {
+      s->regs[ITDS_STATUS_REG] |= 0x20;
+      s->regs[ITDS_STATUS_DETECT_REG] |= 0x20;
+      s->regs[ITDS_WAKE_UP_EVENT_REG] |= 0x10;
+    }
+    else
+    {
+      s->regs[ITDS_STATUS_REG] &= (uint8_t)~0x20;
+      s->regs[ITDS_STATUS_DETECT_REG] &= (uint8_t)~0x20;
+      s->regs[ITDS_WAKE_UP_EVENT_REG] &= (uint8_t)~0x10;
+    }
+  }
+
+  /* CTRL_4 routes to INT_0, the sleep change of CTRL_5 needs INT1_ON_INT0 */
+  if ((allIntEvents & 0x01) && (ctrl4 & 0x10))
+    routed = 1;
+  if ((allIntEvents & 0x02) && (ctrl4 & 0x20))
+    routed = 1;
+  if ((allIntEvents & 0x04) && (ctrl4 & 0x40))
+    routed = 1;
+  if ((allIntEvents & 0x08) && (ctrl4 & 0x08))
+    routed = 1;
+  if ((allIntEvents & 0x20) && (s->regs[ITDS_CTRL_5_REG] & 0x40) && (s->regs[ITDS_CTRL_7_REG] & 0x40))
+    routed = 1;
+  if (routed && (s->regs[ITDS_CTRL_7_REG] & 0x20) && itdsIntPin >= 0)
+  {
+    BasePlatform_triggerInterrupt((uint32_t)itdsIntPin);
+  }
+}
+
+/**
+ * @brief  Get the bus clock used for the bus time
+ * @retval Clock in Hz
+ */
+uint32_t SensorSim_getClock()
+{
+  return busClock;
+}
+
+/**
+ * @brief  Get the bus statistics of a sensor
+ * @param  device Simulated sensor, sensorSimDevices for the whole bus
+ * @param  stats Returns the statistics
+ * @retval none
+ */
+void SensorSim_getStats(SensorSim_device_t device, SensorSim_stats_t *stats)
+{
+  *stats = (device < sensorSimDevices) ? sensors[device].stats : totalStats;
+}
+
+/**
+ * @brief  Clear the bus statistics
+ * @retval none
+ */
+void SensorSim_resetStats()
+{
+  memset(&totalStats, 0, sizeof(totalStats));
+  for (uint8_t i = 0; i < sensorSimDevices; i++)
+  {
+    memset(&sensors[i].stats, 0, sizeof(sensors[i].stats));
+  }
+}
+
+/**
+ * @brief  Print the bus statistics, with the bus time at the clock in use
+ *         and at 100 and 400 kHz
+ * @param  out Output stream
+ * @retval none
+ */
+void SensorSim_printStats(FILE *out)
+{
+  static const char *const names[sensorSimDevices + 1] = {"PADS", "ITDS", "TIDS", "HIDS", "SH1107", "total"};
+
+  fprintf(out, "%-6s %9s %8s %8s %6s %10s %12s %12s %12s\r\n", "device", "transfers", "reads", "writes", "nacks",
+          "bytes", "bus us", "us@100k", "us@400k");
+  for (uint8_t i = 0; i <= sensorSimDevices; i++)
+  {
+    SensorSim_stats_t stats;
+
+    SensorSim_getStats((SensorSim_device_t)i, &stats);
+    fprintf(out, "%-6s %9u %8u %8u %6u %10llu %12llu %12llu %12llu\r\n", names[i], stats.transactions, stats.reads,
+            stats.writes, stats.nacks, (unsigned long long)stats.bytes, (unsigned long long)(stats.busTimeNs / 1000),
+            (unsigned long long)(stats.busBits * 10), (unsigned long long)(stats.busBits * 10 / 4));
+  }
+}
+/**         EOF         */
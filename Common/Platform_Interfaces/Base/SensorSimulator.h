@@ -0,0 +1,125 @@
+/**
+ * \file
+ * \brief Register level I2C simulator of the WSEN sensors for the host build.
+ *
+ * Plugs into the I2C bus model of the base platform and emulates the
+ * register maps of the WSEN-PADS, WSEN-ITDS, WSEN-TIDS and WSEN-HIDS. The
+ * SH1107 display controller sharing the bus is emulated as a memory sink.
+ * The measured quantities come from waveform generators or recorded CSV
+ * traces. Every transfer is counted together with the time it would take
+ * on the bus at the configured clock.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef SENSORSIMULATOR_H
+#define SENSORSIMULATOR_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/* Conversion time of a one-shot measurement */
+#define SENSOR_SIM_PADS_CONVERSION_US 14000
+#define SENSOR_SIM_ITDS_CONVERSION_US 1250
+#define SENSOR_SIM_TIDS_CONVERSION_US 10000
+#define SENSOR_SIM_HIDS_CONVERSION_US 4000
+
+/* Maximum number of rows of a CSV trace */
+#define SENSOR_SIM_TRACE_MAX_ROWS 100000
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        sensorSimPADS,
+        sensorSimITDS,
+        sensorSimTIDS,
+        sensorSimHIDS,
+        sensorSimSH1107,
+        sensorSimDevices
+    } SensorSim_device_t;
+
+    /**
+     * @brief Physical quantities seen by the simulated sensors. The ambient
+     * temperature is shared by all four parts.
+     */
+    typedef enum
+    {
+        sensorSimPressure,    /* Pa */
+        sensorSimTemperature, /* 0.01 °C */
+        sensorSimHumidity,    /* 0.01 %rH */
+        sensorSimAccX,        /* mg */
+        sensorSimAccY,        /* mg */
+        sensorSimAccZ,        /* mg */
+        sensorSimChannels
+    } SensorSim_channel_t;
+
+    /**
+     * @brief value(t) = offset + slope * t + amplitude * sin(2 pi f t) + noise
+     */
+    typedef struct
+    {
+        int32_t offset;            /* Channel unit */
+        int32_t slope;             /* Channel unit per second */
+        int32_t amplitude;         /* Channel unit */
+        uint32_t frequencyMilliHz; /* Frequency of the sine in mHz */
+        int32_t noise;             /* Peak of the uniform noise, channel unit */
+    } SensorSim_waveform_t;
+
+    /**
+     * @brief Bus statistics. A register access counts as one transaction
+     * with a repeated start for reads.
+     */
+    typedef struct
+    {
+        uint32_t transactions;
+        uint32_t reads;
+        uint32_t writes;
+        uint32_t nacks;
+        uint64_t bytes;     /* Payload bytes, without address and register bytes */
+        uint64_t busBits;   /* SCL cycles including start, stop and acknowledge */
+        uint64_t busTimeNs; /* Bus time at the clock in use for each transfer */
+    } SensorSim_stats_t;
+
+    void SensorSim_init();
+    void SensorSim_reset(SensorSim_device_t device);
+    void SensorSim_setWaveform(SensorSim_channel_t channel, const SensorSim_waveform_t *waveform);
+    bool SensorSim_loadTrace(const char *path, bool loop);
+    void SensorSim_clearTraces();
+
+    void SensorSim_setItdsIntPin(int pin);
+    void SensorSim_injectItdsEvent(uint8_t allIntEvents, bool sleep);
+
+    uint32_t SensorSim_getClock();
+    void SensorSim_getStats(SensorSim_device_t device, SensorSim_stats_t *stats);
+    void SensorSim_resetStats();
+    void SensorSim_printStats(FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SENSORSIMULATOR_H */
@@ -0,0 +1,208 @@
+/**
+ * \file
+ * \brief Messages saved by the report-by-exception telemetry on a trace.
+ *
+ * Replays a CSV trace through the simulated sensors, reads them with the
+ * sensor drivers at the telemetry interval and runs the deadband filter of
+ * the PnP layer with its default thresholds and heartbeat. Prints the
+ * messages and fields published against a publish of all the fields at
+ * every interval. Without a trace, a day of an indoor room is generated:
+ * a daily temperature and humidity swing with a heating cycle, a
+ * semi-diurnal pressure tide, a board lying still and sensor noise.
+ *
+ * Usage: telemetry_bench [hours] [interval s] [trace.csv]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <math.h>
+#include <unistd.h>
+
+#include "ConfigPlatform.h"
+#include "SensorSimulator.h"
+#include "PnP_Common_Device.h"
+
+#define TELEMETRY_BENCH_DEFAULT_HOURS 24
+#define TELEMETRY_BENCH_DEFAULT_INTERVAL 30 /* s, DEFAULT_TELEMETRY_SEND_INTEVAL */
+#define TELEMETRY_BENCH_TRACE_STEP_MS 60000
+
+/* Defined by GW/src/main.cpp in the application */
+char displayText[150];
+
+/* Sensors of the PnP layer, read by Device_getTelemetryValues */
+extern PADS *sensorPADS;
+extern ITDS *sensorITDS;
+extern TIDS *sensorTIDS;
+extern HIDS *sensorHIDS;
+
+static const char *channelNames[telemetryChannels] = {"pressure",     "humidity",     "temperature",
+                                                      "acceleration x", "acceleration y", "acceleration z",
+#if VIBRATION_ANALYSIS
+                                                      "vibration",
+#endif
+};
+
+/**
+ * @brief  Write the generated indoor day as a trace
+ * @param  path Output file
+ * @param  hours Length of the trace
+ * @retval true if successful false otherwise
+ */
+static bool TelemetryBench_writeIndoorDay(const char *path, uint32_t hours)
+{
+  FILE *file = fopen(path, "w");
+
+  if (file == NULL)
+  {
+    return false;
+  }
+  fprintf(file, "time_ms,pressure,temperature,humidity,accX,accY,accZ\n");
+  for (uint64_t t = 0; t <= (uint64_t)hours * 3600000; t += TELEMETRY_BENCH_TRACE_STEP_MS)
+  {
+    double day = 2.0 * M_PI * (double)t / 86400000.0;
+    /* Heating on for 20 of every 60 minutes */
+    double heating = ((t / 60000) % 60 < 20) ? 1.0 : 0.0;
+
+    fprintf(file, "%llu,%ld,%ld,%ld,0,0,1000\n", (unsigned long long)t,
+            lround(101325 + 120 * sin(2 * day)),
+            lround(2150 - 150 * cos(day) + 40 * heating),
+            lround(4500 + 400 * cos(day) - 60 * heating));
+  }
+  return fclose(file) == 0;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t hours = (argc > 1) ? (uint32_t)atol(argv[1]) : TELEMETRY_BENCH_DEFAULT_HOURS;
+  uint32_t intervalS = (argc > 2) ? (uint32_t)atol(argv[2]) : TELEMETRY_BENCH_DEFAULT_INTERVAL;
+  char generated[] = "/tmp/telemetry_bench_XXXXXX";
+  const char *path = (argc > 3) ? argv[3] : generated;
+  SensorSim_waveform_t noise;
+  TypeSerial *debug;
+  int32_t values[telemetryChannels];
+  uint32_t reports[telemetryChannels];
+  uint32_t intervals;
+  uint32_t messages = 0;
+  uint32_t fields = 0;
+
+  if (intervalS == 0)
+  {
+    intervalS = TELEMETRY_BENCH_DEFAULT_INTERVAL;
+  }
+  intervals = hours * 3600 / intervalS;
+
+  SensorSim_init();
+  if (argc <= 3)
+  {
+    int fd = mkstemp(generated);
+
+    if ((fd < 0) || (close(fd) != 0) || !TelemetryBench_writeIndoorDay(generated, hours))
+    {
+      fprintf(stderr, "Cannot write the trace\r\n");
+      return 1;
+    }
+  }
+  if (!SensorSim_loadTrace(path, true))
+  {
+    fprintf(stderr, "Cannot load trace %s\r\n", path);
+    return 1;
+  }
+  if (argc <= 3)
+  {
+    unlink(generated);
+  }
+  /* Noise of the sensors, added to the trace */
+  memset(&noise, 0, sizeof(noise));
+  noise.noise = 4;
+  SensorSim_setWaveform(sensorSimPressure, &noise);
+  noise.noise = 2;
+  SensorSim_setWaveform(sensorSimTemperature, &noise);
+  noise.noise = 15;
+  SensorSim_setWaveform(sensorSimHumidity, &noise);
+  noise.noise = 5;
+  SensorSim_setWaveform(sensorSimAccX, &noise);
+  SensorSim_setWaveform(sensorSimAccY, &noise);
+  SensorSim_setWaveform(sensorSimAccZ, &noise);
+
+  debug = SSerial_create(&Serial);
+  sensorPADS = PADSCreate(debug);
+  sensorITDS = ITDSCreate(debug);
+  sensorTIDS = TIDSCreate(debug);
+  sensorHIDS = HIDSCreate(debug);
+  if (!PADS_simpleInit(sensorPADS) || !ITDS_simpleInit(sensorITDS) || !TIDS_simpleInit(sensorTIDS) ||
+      !HIDS_simpleInit(sensorHIDS))
+  {
+    fprintf(stderr, "Sensor init failed\r\n");
+    return 1;
+  }
+  Device_initTelemetryFilter();
+  memset(reports, 0, sizeof(reports));
+
+  for (uint32_t i = 0; i < intervals; i++)
+  {
+    uint8_t reportMask;
+
+    BasePlatform_advanceClock((uint64_t)intervalS * 1000000);
+    PADS_readSensorData(sensorPADS);
+    ITDS_readSensorData(sensorITDS);
+    TIDS_readSensorData(sensorTIDS);
+    HIDS_readSensorData(sensorHIDS);
+
+    Device_getTelemetryValues(values);
+    reportMask = Device_getTelemetryReportMask(values);
+    if (reportMask == 0)
+    {
+      continue;
+    }
+    messages++;
+    for (uint8_t channel = 0; channel < telemetryChannels; channel++)
+    {
+      if (reportMask & TELEMETRY_BIT(channel))
+      {
+        reports[channel]++;
+        fields++;
+      }
+    }
+    /* The publish is taken as successful */
+    Device_commitTelemetry(values, reportMask);
+  }
+
+  printf("%lu h at %lu s, %s\r\n", (unsigned long)hours, (unsigned long)intervalS,
+         (argc > 3) ? path : "generated indoor day");
+  for (uint8_t channel = 0; channel < telemetryChannels; channel++)
+  {
+    printf("%-16s %7lu reports\r\n", channelNames[channel], (unsigned long)reports[channel]);
+  }
+  printf("messages %7lu of %7lu, %5.1f %% fewer\r\n", (unsigned long)messages, (unsigned long)intervals,
+         intervals ? 100.0 * (intervals - messages) / intervals : 0.0);
+  printf("fields   %7lu of %7lu, %5.1f %% fewer\r\n", (unsigned long)fields,
+         (unsigned long)intervals * telemetryChannels,
+         intervals ? 100.0 * ((double)intervals * telemetryChannels - fields) / ((double)intervals * telemetryChannels)
+                   : 0.0);
+
+  PADSDestroy(sensorPADS);
+  ITDSDestroy(sensorITDS);
+  TIDSDestroy(sensorTIDS);
+  HIDSDestroy(sensorHIDS);
+  SSerial_destroy(debug);
+  return 0;
+}
+/**         EOF         */
@@ -0,0 +1,201 @@
+/**
+ * \file
+ * \brief Test vectors and cost of the calendar conversion in time.c.
+ *
+ * Converts every day from 1970 to 2400 (including the leap centuries 2000
+ * and 2400 and the common ones 2100, 2200 and 2300) both ways and compares
+ * with the C library (timegm, gmtime_r). The loop over the years time.c
+ * used before is kept here as a reference, it is compared up to 2038 and
+ * timed against Time_ConvertToUnix.
+ *
+ * Usage: time_bench [conversions]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include <time.h>
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "time.h"
+
+#define TIME_BENCH_DEFAULT_CONVERSIONS 1000000
+#define TIME_BENCH_FIRST_YEAR 1970
+#define TIME_BENCH_LAST_YEAR 2400
+
+#define LEAP_YEAR(Y) (((1970 + (Y)) > 0) && !((1970 + (Y)) % 4) && (((1970 + (Y)) % 100) || !((1970 + (Y)) % 400)))
+
+static const uint8_t monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+static uint32_t benchWrong = 0;
+
+/**
+ * @brief  Previous Time_ConvertToUnix, one iteration per year since 1970
+ * @param  time pointer to time
+ * @retval UNIX time stamp
+ */
+static unsigned long long TimeBench_loopToUnix(Timestamp *time)
+{
+  unsigned long long seconds = 0;
+  int unixYear = time->year - 1970;
+
+  seconds = unixYear * (365 * SECONDS_PER_DAY);
+  for (int i = 0; i < unixYear; i++)
+  {
+    if (LEAP_YEAR(i))
+    {
+      seconds += SECONDS_PER_DAY;
+    }
+  }
+  for (int i = 1; i < time->month; i++)
+  {
+    seconds += SECONDS_PER_DAY * monthDays[i - 1];
+    if ((i == 2) && LEAP_YEAR(unixYear))
+    {
+      seconds += SECONDS_PER_DAY;
+    }
+  }
+  seconds += (time->day - 1) * SECONDS_PER_DAY;
+  seconds += time->hour * SECONDS_PER_HOUR;
+  seconds += time->minute * SECONDS_PER_MINUTES;
+  seconds += time->second;
+  return seconds;
+}
+
+static void TimeBench_report(const char *what, const Timestamp *time, unsigned long long got,
+                             unsigned long long expected)
+{
+  if (benchWrong++ < 10)
+  {
+    printf("%s wrong for %04u-%02u-%02u %02u:%02u:%02u: %llu, expected %llu\r\n", what, time->year, time->month,
+           time->day, time->hour, time->minute, time->second, got, expected);
+  }
+}
+
+/**
+ * @brief  Check one calendar time against the C library, both ways
+ * @param  time Time to check
+ * @param  checkLoop Also check the previous conversion
+ * @retval None
+ */
+static void TimeBench_check(Timestamp *time, bool checkLoop)
+{
+  struct tm tm = {0};
+  struct tm back;
+  Timestamp converted;
+  unsigned long long expected;
+  unsigned long long seconds = Time_ConvertToUnix(time);
+
+  tm.tm_year = time->year - 1900;
+  tm.tm_mon = time->month - 1;
+  tm.tm_mday = time->day;
+  tm.tm_hour = time->hour;
+  tm.tm_min = time->minute;
+  tm.tm_sec = time->second;
+  expected = (unsigned long long)timegm(&tm);
+  if (seconds != expected)
+  {
+    TimeBench_report("to unix", time, seconds, expected);
+  }
+  if (checkLoop && TimeBench_loopToUnix(time) != expected)
+  {
+    TimeBench_report("loop", time, TimeBench_loopToUnix(time), expected);
+  }
+
+  Time_ConvertFromUnix(expected, &converted);
+  gmtime_r(&(time_t){(time_t)expected}, &back);
+  if (converted.year != back.tm_year + 1900 || converted.month != back.tm_mon + 1 || converted.day != back.tm_mday ||
+      converted.hour != back.tm_hour || converted.minute != back.tm_min || converted.second != back.tm_sec)
+  {
+    TimeBench_report("from unix", time, Time_ConvertToUnix(&converted), expected);
+  }
+}
+
+/**
+ * @brief  Time the conversion of random times in 2020 to 2039
+ * @param  convert Conversion to time
+ * @param  times Times to convert
+ * @param  count Number of times
+ * @retval ns per conversion
+ */
+static double TimeBench_measure(unsigned long long (*convert)(Timestamp *), Timestamp *times, uint32_t count)
+{
+  volatile unsigned long long sum = 0;
+  uint64_t startUs = BasePlatform_micros64();
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    sum += convert(&times[i]);
+  }
+  return (double)(BasePlatform_micros64() - startUs) * 1000.0 / count;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t conversions = (argc > 1) ? (uint32_t)atol(argv[1]) : TIME_BENCH_DEFAULT_CONVERSIONS;
+  uint32_t days = 0;
+  Timestamp *times;
+
+  if (conversions == 0)
+  {
+    conversions = 1;
+  }
+
+  /* Every day, at a random time of day; the previous conversion overflowed
+   * an int from 2039 on */
+  for (uint16_t year = TIME_BENCH_FIRST_YEAR; year <= TIME_BENCH_LAST_YEAR; year++)
+  {
+    for (uint8_t month = 1; month <= 12; month++)
+    {
+      struct tm tm = {.tm_year = year - 1900, .tm_mon = month, .tm_mday = 0};
+      uint8_t lastDay;
+
+      /* Day 0 of the next month is the last day of this one */
+      timegm(&tm);
+      lastDay = (uint8_t)tm.tm_mday;
+      for (uint8_t day = 1; day <= lastDay; day++)
+      {
+        uint32_t r = Bench_random();
+        Timestamp time = {year, month, day, (uint8_t)(r % 24), (uint8_t)(r / 24 % 60), (uint8_t)(r / 1440 % 60)};
+
+        TimeBench_check(&time, year < 2039);
+        days++;
+      }
+    }
+  }
+  printf("%lu days from %u to %u, %lu wrong\r\n", (unsigned long)days, TIME_BENCH_FIRST_YEAR,
+         TIME_BENCH_LAST_YEAR, (unsigned long)benchWrong);
+
+  times = calloc(conversions, sizeof(Timestamp));
+  if (times == NULL)
+  {
+    fprintf(stderr, "Out of memory\r\n");
+    return 1;
+  }
+  for (uint32_t i = 0; i < conversions; i++)
+  {
+    Time_ConvertFromUnix(1577836800ull + Bench_random() % (20u * 365 * SECONDS_PER_DAY), &times[i]);
+  }
+  printf("loop      %8.1f ns per conversion\r\n", TimeBench_measure(TimeBench_loopToUnix, times, conversions));
+  printf("to unix   %8.1f ns per conversion\r\n", TimeBench_measure(Time_ConvertToUnix, times, conversions));
+
+  free(times);
+  return benchWrong ? 1 : 0;
+}
+/**         EOF         */
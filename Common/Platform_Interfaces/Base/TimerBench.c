@@ -0,0 +1,216 @@
+/**
+ * \file
+ * \brief Throughput benchmark of the software timer wheel.
+ *
+ * Runs the wheel on a simulated clock: starts a number of one-shot timers,
+ * stops half of them, lets the rest expire, then runs periodic timers for
+ * an hour of simulated time. Last it starts one-shot and periodic timers
+ * with no delay on every tick of a 64 ms block, which expire on the next
+ * tick. Prints the cost per operation and the ticks the wheel had to
+ * handle, and checks that every timer expired on its tick.
+ *
+ * Usage: timer_bench [timers] [max delay ms]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "timerwheel.h"
+
+#define TIMER_BENCH_DEFAULT_TIMERS 100000
+#define TIMER_BENCH_DEFAULT_MAX_DELAY_MS 3600000
+#define TIMER_BENCH_PERIODIC_TIMERS 1000
+#define TIMER_BENCH_PERIODIC_RUN_MS 3600000
+#define TIMER_BENCH_ZERO_DELAY_PERIOD_MS 64
+#define TIMER_BENCH_ZERO_DELAY_RUN_MS 200
+
+/* Simulated clock, the wheel is advanced explicitly */
+static uint64_t benchNow = 0;
+static uint64_t *benchDue = NULL;
+static uint32_t benchExpired = 0;
+static uint32_t benchWrong = 0;
+
+static uint64_t TimerBench_clock() { return benchNow; }
+
+/**
+ * @brief  Check the expiry against the tick recorded at start
+ * @param  timer Expired timer
+ * @retval None
+ */
+static void TimerBench_onExpiry(TimerWheelTimer_t *timer)
+{
+  size_t index = (size_t)(uintptr_t)timer->context;
+
+  benchExpired++;
+  if (timer->expired != benchDue[index] || benchNow != benchDue[index])
+  {
+    benchWrong++;
+  }
+  benchDue[index] += timer->period;
+}
+
+/**
+ * @brief  Advance the simulated clock from expiry to expiry, like the
+ *         tickless alarm does
+ * @param  end Time to stop at
+ * @retval None
+ */
+static void TimerBench_run(uint64_t end)
+{
+  uint64_t tick;
+
+  while (TimerWheel_nextExpiry(&tick) && tick <= end)
+  {
+    benchNow = tick;
+    TimerWheel_advance(benchNow);
+  }
+  benchNow = end;
+  TimerWheel_advance(benchNow);
+}
+
+static double TimerBench_nsPer(uint64_t startUs, uint32_t count)
+{
+  return count ? (double)(BasePlatform_micros64() - startUs) * 1000.0 / count : 0.0;
+}
+
+static void TimerBench_printStats(const char *phase, uint64_t elapsedMs)
+{
+  TimerWheelStats_t stats;
+
+  TimerWheel_getStats(&stats);
+  printf("%-9s %9lu expired, %9lu cascaded, %9lu ticks handled in %llu ms, %lu wrong\r\n", phase,
+         (unsigned long)stats.expired, (unsigned long)stats.cascaded, (unsigned long)stats.wakeups,
+         (unsigned long long)elapsedMs, (unsigned long)benchWrong);
+  TimerWheel_resetStats();
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t timers = (argc > 1) ? (uint32_t)atol(argv[1]) : TIMER_BENCH_DEFAULT_TIMERS;
+  uint32_t maxDelayMs = (argc > 2) ? (uint32_t)atol(argv[2]) : TIMER_BENCH_DEFAULT_MAX_DELAY_MS;
+  TimerWheelTimer_t *wheelTimers;
+  uint64_t startUs;
+  uint64_t startMs;
+  uint32_t stopped = 0;
+
+  if (timers < TIMER_BENCH_PERIODIC_TIMERS)
+  {
+    timers = TIMER_BENCH_PERIODIC_TIMERS;
+  }
+  if (maxDelayMs == 0)
+  {
+    maxDelayMs = 1;
+  }
+  wheelTimers = calloc(timers, sizeof(TimerWheelTimer_t));
+  benchDue = calloc(timers, sizeof(uint64_t));
+  if (wheelTimers == NULL || benchDue == NULL)
+  {
+    fprintf(stderr, "Out of memory\r\n");
+    return 1;
+  }
+
+  /* Start in the middle of the 32-bit millis() range, the wheel does not care */
+  benchNow = 0xFFFF0000ull;
+  TimerWheel_init(TimerBench_clock, NULL);
+  for (uint32_t i = 0; i < timers; i++)
+  {
+    TimerWheel_initTimer(&wheelTimers[i], TimerBench_onExpiry, (void *)(uintptr_t)i);
+  }
+
+  /* One-shot timers */
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < timers; i++)
+  {
+    uint32_t delayMs = 1 + Bench_random() % maxDelayMs;
+
+    benchDue[i] = benchNow + delayMs;
+    TimerWheel_start(&wheelTimers[i], delayMs, 0);
+  }
+  printf("start     %8.1f ns per timer, %lu timers up to %lu ms\r\n", TimerBench_nsPer(startUs, timers),
+         (unsigned long)timers, (unsigned long)maxDelayMs);
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t i = 0; i < timers; i += 2)
+  {
+    TimerWheel_stop(&wheelTimers[i]);
+    stopped++;
+  }
+  printf("stop      %8.1f ns per timer\r\n", TimerBench_nsPer(startUs, stopped));
+
+  startMs = benchNow;
+  startUs = BasePlatform_micros64();
+  TimerBench_run(benchNow + maxDelayMs);
+  printf("expire    %8.1f ns per timer\r\n", TimerBench_nsPer(startUs, benchExpired));
+  if (benchExpired != timers - stopped)
+  {
+    benchWrong += (timers - stopped) - benchExpired;
+  }
+  TimerBench_printStats("one-shot", benchNow - startMs);
+
+  /* Periodic timers, 10 ms to 10 s */
+  benchExpired = 0;
+  for (uint32_t i = 0; i < TIMER_BENCH_PERIODIC_TIMERS; i++)
+  {
+    uint32_t periodMs = 10 + Bench_random() % 10000;
+
+    benchDue[i] = benchNow + periodMs;
+    TimerWheel_start(&wheelTimers[i], periodMs, periodMs);
+  }
+  startMs = benchNow;
+  startUs = BasePlatform_micros64();
+  TimerBench_run(benchNow + TIMER_BENCH_PERIODIC_RUN_MS);
+  printf("periodic  %8.1f ns per expiry, %lu timers\r\n", TimerBench_nsPer(startUs, benchExpired),
+         (unsigned long)TIMER_BENCH_PERIODIC_TIMERS);
+  TimerBench_printStats("periodic", benchNow - startMs);
+
+  for (uint32_t i = 0; i < TIMER_BENCH_PERIODIC_TIMERS; i++)
+  {
+    TimerWheel_stop(&wheelTimers[i]);
+  }
+
+  /* No delay on every phase of a level 0 turn, the next tick may start a
+   * level 1 slot */
+  benchExpired = 0;
+  startMs = benchNow;
+  for (uint32_t phase = 0; phase < TIMER_BENCH_ZERO_DELAY_PERIOD_MS; phase++)
+  {
+    benchNow += (phase - benchNow) % TIMER_BENCH_ZERO_DELAY_PERIOD_MS;
+    TimerWheel_advance(benchNow);
+    benchDue[0] = benchNow + 1;
+    benchDue[1] = benchNow + 1;
+    TimerWheel_start(&wheelTimers[0], 0, 0);
+    TimerWheel_start(&wheelTimers[1], 0, TIMER_BENCH_ZERO_DELAY_PERIOD_MS);
+    TimerBench_run(benchNow + TIMER_BENCH_ZERO_DELAY_RUN_MS);
+    TimerWheel_stop(&wheelTimers[1]);
+  }
+  if (benchExpired != TIMER_BENCH_ZERO_DELAY_PERIOD_MS *
+                          (2 + (TIMER_BENCH_ZERO_DELAY_RUN_MS - 1) / TIMER_BENCH_ZERO_DELAY_PERIOD_MS))
+  {
+    benchWrong++;
+  }
+  TimerBench_printStats("no delay", benchNow - startMs);
+
+  free(wheelTimers);
+  free(benchDue);
+  return benchWrong ? 1 : 0;
+}
+/**         EOF         */
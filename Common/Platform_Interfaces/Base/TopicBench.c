@@ -0,0 +1,484 @@
+/**
+ * \file
+ * \brief Throughput benchmark of the MQTT topic router.
+ *
+ * Routes a mix of the topics the gateway receives from Azure IoT Hub and
+ * from KaaIoT, with random request ids, status codes and command types
+ * plus topics no pattern matches, through the routers set up like in the
+ * device files. Checks the matched route and the captured fields of every
+ * topic and compares the cost with the strstr and strtok classification
+ * the device files used before.
+ *
+ * Usage: topic_bench [topics] [rounds]
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE
+ * THAT WÜRTH ELEKTRONIK EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY
+ * KIND RELATED TO, BUT NOT LIMITED TO THE NON-INFRINGEMENT OF THIRD PARTIES’
+ * INTELLECTUAL PROPERTY RIGHTS OR THE MERCHANTABILITY OR FITNESS FOR YOUR
+ * INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT WARRANT OR
+ * REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY
+ * PATENT RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY
+ * RIGHT RELATING TO ANY COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT
+ * IS USED. INFORMATION PUBLISHED BY WÜRTH ELEKTRONIK EISOS REGARDING
+ * THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE FROM WÜRTH
+ * ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR
+ * ENDORSEMENT THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+#include "ConfigPlatform.h"
+#include "BenchSupport.h"
+#include "topicrouter.h"
+
+#define TOPIC_BENCH_DEFAULT_TOPICS 10000
+#define TOPIC_BENCH_DEFAULT_ROUNDS 100
+#define TOPIC_BENCH_TOPIC_SIZE 128
+
+#define TOPIC_BENCH_APP "cs6ldrs2sf3c-v1"
+#define TOPIC_BENCH_TOKEN "gw-7f3a91"
+
+typedef enum
+{
+  route_none,
+  route_twin_response,
+  route_desired,
+  route_set_led,
+  route_method,
+  route_dps_response,
+  route_kaa_switch,
+  route_kaa_command,
+  route_kaa_data_status,
+  route_count
+} TopicBenchRoute_t;
+
+static const char *routeNames[route_count] = {"no match", "twin/res", "desired", "setLEDColor", "other method",
+                                              "dps/res", "kaa switch", "kaa command", "kaa data status"};
+
+typedef struct
+{
+  char topic[TOPIC_BENCH_TOPIC_SIZE];
+  uint16_t length;
+  uint8_t platform; /* 0 Azure, 1 KaaIoT */
+  uint8_t route;
+  long value; /* Status code, request id or version expected in the captures */
+} TopicBenchTopic_t;
+
+static TopicRouter_t azureRouter;
+static TopicRouter_t kaaRouter;
+static uint32_t routed[route_count];
+static uint32_t benchWrong = 0;
+static long handledValue;
+static uint8_t handledRoute;
+/* The handlers record what they extracted, the check is done by the caller */
+static void TopicBench_onTwinResponse(const TopicMatch_t *match, void *message)
+{
+  TopicSpan_t rid;
+
+  (void)message;
+  handledRoute = route_twin_response;
+  handledValue = TopicSpan_toLong(&match->captures[0]) * 100000 +
+                 (TopicRouter_getProperty(&match->captures[1], "$rid", &rid) ? TopicSpan_toLong(&rid) : -1);
+}
+
+static void TopicBench_onDesired(const TopicMatch_t *match, void *message)
+{
+  TopicSpan_t version;
+
+  (void)message;
+  handledRoute = route_desired;
+  handledValue = TopicRouter_getProperty(&match->captures[0], "$version", &version) ? TopicSpan_toLong(&version) : -1;
+}
+
+static void TopicBench_onSetLED(const TopicMatch_t *match, void *message)
+{
+  TopicSpan_t rid;
+
+  (void)message;
+  handledRoute = route_set_led;
+  handledValue = TopicRouter_getProperty(&match->captures[0], "$rid", &rid) ? TopicSpan_toLong(&rid) : -1;
+}
+
+static void TopicBench_onMethod(const TopicMatch_t *match, void *message)
+{
+  TopicSpan_t rid;
+
+  (void)message;
+  handledRoute = route_method;
+  handledValue = TopicRouter_getProperty(&match->captures[1], "$rid", &rid) ? TopicSpan_toLong(&rid) : -1;
+}
+
+static void TopicBench_onDpsResponse(const TopicMatch_t *match, void *message)
+{
+  (void)message;
+  handledRoute = route_dps_response;
+  handledValue = TopicSpan_toLong(&match->captures[0]);
+}
+
+static void TopicBench_onKaaSwitch(const TopicMatch_t *match, void *message)
+{
+  (void)message;
+  handledRoute = route_kaa_switch;
+  handledValue = TopicSpan_equals(&match->captures[0], TOPIC_BENCH_APP) &&
+                 TopicSpan_equals(&match->captures[1], TOPIC_BENCH_TOKEN);
+}
+
+static void TopicBench_onKaaCommand(const TopicMatch_t *match, void *message)
+{
+  (void)message;
+  handledRoute = route_kaa_command;
+  handledValue = match->captures[2].length;
+}
+
+static void TopicBench_onKaaDataStatus(const TopicMatch_t *match, void *message)
+{
+  (void)message;
+  handledRoute = route_kaa_data_status;
+  handledValue = TopicSpan_toLong(&match->captures[2]);
+}
+
+/**
+ * @brief  Set up the routers with the patterns of the device files plus
+ *         the provisioning and data collection responses
+ * @retval true if all patterns fit
+ */
+static bool TopicBench_initRouters()
+{
+  bool ok = true;
+
+  TopicRouter_init(&azureRouter);
+  ok &= TopicRouter_add(&azureRouter, "$iothub/twin/res/+/#", TopicBench_onTwinResponse);
+  ok &= TopicRouter_add(&azureRouter, "$iothub/twin/PATCH/properties/desired/#", TopicBench_onDesired);
+  ok &= TopicRouter_add(&azureRouter, "$iothub/methods/POST/setLEDColor/#", TopicBench_onSetLED);
+  ok &= TopicRouter_add(&azureRouter, "$iothub/methods/POST/+/#", TopicBench_onMethod);
+  ok &= TopicRouter_add(&azureRouter, "$dps/registrations/res/+/#", TopicBench_onDpsResponse);
+
+  TopicRouter_init(&kaaRouter);
+  ok &= TopicRouter_add(&kaaRouter, "kp1/+/cex/+/command/switch_on_off/status", TopicBench_onKaaSwitch);
+  ok &= TopicRouter_add(&kaaRouter, "kp1/+/cex/+/command/+/status", TopicBench_onKaaCommand);
+  ok &= TopicRouter_add(&kaaRouter, "kp1/+/dcx/+/json/+/status", TopicBench_onKaaDataStatus);
+  return ok;
+}
+
+/**
+ * @brief  Check the pattern validation and the MQTT matching rules
+ * @retval Number of failed checks
+ */
+static uint32_t TopicBench_checkRules()
+{
+  static const struct
+  {
+    const char *pattern;
+    const char *topic;
+    bool matches;
+  } rules[] = {
+      {"a/#", "a", true},
+      {"a/#", "a/b/c", true},
+      {"a/+", "a/", true},
+      {"a/+", "a", false},
+      {"a/+/c", "a/b/c/d", false},
+      {"+/b", "$a/b", false},
+      {"#", "$SYS/x", false},
+      {"$SYS/#", "$SYS/x", true},
+      {"a/b", "a/bc", false},
+      {"a//c", "a//c", true},
+  };
+  static const char *invalid[] = {"", "a/#/b", "a/b+", "a/#b", "a+/b"};
+  TopicRouter_t router;
+  TopicMatch_t match;
+  TopicHandler_t handler;
+  uint32_t failed = 0;
+
+  for (size_t i = 0; i < sizeof(rules) / sizeof(rules[0]); i++)
+  {
+    TopicRouter_init(&router);
+    TopicRouter_add(&router, rules[i].pattern, TopicBench_onDpsResponse);
+    if (TopicRouter_match(&router, rules[i].topic, (uint16_t)strlen(rules[i].topic), &match, &handler) !=
+        rules[i].matches)
+    {
+      printf("rule failed: %s on %s\r\n", rules[i].pattern, rules[i].topic);
+      failed++;
+    }
+  }
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+  {
+    TopicRouter_init(&router);
+    if (TopicRouter_add(&router, invalid[i], TopicBench_onDpsResponse))
+    {
+      printf("invalid pattern accepted: \"%s\"\r\n", invalid[i]);
+      failed++;
+    }
+  }
+  TopicRouter_init(&router);
+  TopicRouter_add(&router, "a/+", TopicBench_onDpsResponse);
+  if (TopicRouter_add(&router, "a/+", TopicBench_onDpsResponse))
+  {
+    printf("duplicate pattern accepted\r\n");
+    failed++;
+  }
+  return failed;
+}
+
+/**
+ * @brief  Generate a received topic with its expected route
+ * @param  topic Generated topic
+ * @retval None
+ */
+static void TopicBench_generate(TopicBenchTopic_t *topic)
+{
+  static const char *methods[] = {"reboot", "getMaxMinReport", "firmwareUpdate"};
+  static const char *commands[] = {"reboot", "set_interval", "blink"};
+  static const int statuses[] = {200, 204, 400, 429};
+  uint32_t kind = Bench_random() % 100;
+  long rid = Bench_random() % 65536;
+  int n;
+
+  topic->platform = 0;
+  if (kind < 25)
+  {
+    int status = statuses[Bench_random() % 4];
+
+    n = snprintf(topic->topic, sizeof(topic->topic), "$iothub/twin/res/%d/?$rid=%ld", status, rid);
+    topic->route = route_twin_response;
+    topic->value = status * 100000L + rid;
+  }
+  else if (kind < 40)
+  {
+    n = snprintf(topic->topic, sizeof(topic->topic), "$iothub/twin/PATCH/properties/desired/?$version=%ld", rid);
+    topic->route = route_desired;
+    topic->value = rid;
+  }
+  else if (kind < 55)
+  {
+    n = snprintf(topic->topic, sizeof(topic->topic), "$iothub/methods/POST/setLEDColor/?$rid=%ld", rid);
+    topic->route = route_set_led;
+    topic->value = rid;
+  }
+  else if (kind < 60)
+  {
+    n = snprintf(topic->topic, sizeof(topic->topic), "$iothub/methods/POST/%s/?$rid=%ld",
+                 methods[Bench_random() % 3], rid);
+    topic->route = route_method;
+    topic->value = rid;
+  }
+  else if (kind < 65)
+  {
+    n = snprintf(topic->topic, sizeof(topic->topic), "$dps/registrations/res/202/?$rid=%ld&retry-after=3", rid);
+    topic->route = route_dps_response;
+    topic->value = 202;
+  }
+  else if (kind < 70)
+  {
+    /* Cloud to device messages are not subscribed */
+    n = snprintf(topic->topic, sizeof(topic->topic), "devices/%s/messages/devicebound/%%24.mid=%ld", TOPIC_BENCH_TOKEN,
+                 rid);
+    topic->route = route_none;
+    topic->value = 0;
+  }
+  else
+  {
+    topic->platform = 1;
+    if (kind < 85)
+    {
+      n = snprintf(topic->topic, sizeof(topic->topic), "kp1/%s/cex/%s/command/switch_on_off/status", TOPIC_BENCH_APP,
+                   TOPIC_BENCH_TOKEN);
+      topic->route = route_kaa_switch;
+      topic->value = 1;
+    }
+    else if (kind < 92)
+    {
+      const char *command = commands[Bench_random() % 3];
+
+      n = snprintf(topic->topic, sizeof(topic->topic), "kp1/%s/cex/%s/command/%s/status", TOPIC_BENCH_APP,
+                   TOPIC_BENCH_TOKEN, command);
+      topic->route = route_kaa_command;
+      topic->value = (long)strlen(command);
+    }
+    else if (kind < 97)
+    {
+      n = snprintf(topic->topic, sizeof(topic->topic), "kp1/%s/dcx/%s/json/%ld/status", TOPIC_BENCH_APP,
+                   TOPIC_BENCH_TOKEN, rid);
+      topic->route = route_kaa_data_status;
+      topic->value = rid;
+    }
+    else
+    {
+      n = snprintf(topic->topic, sizeof(topic->topic), "kp1/%s/cex/%s/result/switch_on_off", TOPIC_BENCH_APP,
+                   TOPIC_BENCH_TOKEN);
+      topic->route = route_none;
+      topic->value = 0;
+    }
+  }
+  topic->length = (uint16_t)n;
+}
+
+/**
+ * @brief  Classification of the device files before the router: strstr on
+ *         the topic, then strtok on a copy to get the fields
+ * @param  topic Received topic
+ * @retval Route, the status or request id in handledValue
+ */
+static uint8_t TopicBench_legacy(const TopicBenchTopic_t *topic)
+{
+  char buffer[TOPIC_BENCH_TOPIC_SIZE];
+  char *token;
+
+  strcpy(buffer, topic->topic);
+  if (topic->platform == 0)
+  {
+    if (strstr(buffer, "$iothub/twin/res/"))
+    {
+      strtok(buffer, "/");
+      strtok(NULL, "/");
+      strtok(NULL, "/");
+      token = strtok(NULL, "/");
+      handledValue = atoi(token);
+      return route_twin_response;
+    }
+    else if (strstr(buffer, "$iothub/twin/PATCH/properties/desired/"))
+    {
+      return route_desired;
+    }
+    else if (strstr(buffer, "iothub/methods/POST/setLEDColor/"))
+    {
+      strtok(buffer, "/");
+      strtok(NULL, "/");
+      strtok(NULL, "/");
+      strtok(NULL, "/");
+      token = strtok(NULL, "/");
+      strtok(token, "=");
+      handledValue = atoi(strtok(NULL, "="));
+      return route_set_led;
+    }
+    return route_none;
+  }
+
+  strtok(buffer, "/");
+  char *app = strtok(NULL, "/");
+  strtok(NULL, "/");
+  char *token2 = strtok(NULL, "/");
+  strtok(NULL, "/");
+  char *type = strtok(NULL, "/");
+  char *status = strtok(NULL, "/");
+  if (!app || !token2 || !type || !status || !strstr(app, TOPIC_BENCH_APP) || !strstr(token2, TOPIC_BENCH_TOKEN) ||
+      !strstr(status, "status"))
+  {
+    return route_none;
+  }
+  return strstr(type, "switch_on_off") ? route_kaa_switch : route_kaa_command;
+}
+
+static double TopicBench_nsPer(uint64_t startUs, uint64_t count)
+{
+  return count ? (double)(BasePlatform_micros64() - startUs) * 1000.0 / (double)count : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t count = (argc > 1) ? (uint32_t)atol(argv[1]) : TOPIC_BENCH_DEFAULT_TOPICS;
+  uint32_t rounds = (argc > 2) ? (uint32_t)atol(argv[2]) : TOPIC_BENCH_DEFAULT_ROUNDS;
+  TopicBenchTopic_t *topics;
+  uint64_t startUs;
+  uint32_t sink = 0;
+
+  if (count == 0)
+  {
+    count = 1;
+  }
+  if (rounds == 0)
+  {
+    rounds = 1;
+  }
+  topics = calloc(count, sizeof(TopicBenchTopic_t));
+  if (topics == NULL)
+  {
+    fprintf(stderr, "Out of memory\r\n");
+    return 1;
+  }
+  if (!TopicBench_initRouters())
+  {
+    fprintf(stderr, "Patterns do not fit, increase TOPIC_ROUTER_MAX_NODES\r\n");
+    return 1;
+  }
+  benchWrong += TopicBench_checkRules();
+  printf("router    %lu of %d nodes Azure, %lu KaaIoT, %lu bytes each\r\n", (unsigned long)azureRouter.nodeCount,
+         TOPIC_ROUTER_MAX_NODES, (unsigned long)kaaRouter.nodeCount, (unsigned long)sizeof(TopicRouter_t));
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    TopicBench_generate(&topics[i]);
+  }
+
+  /* Check every topic once */
+  for (uint32_t i = 0; i < count; i++)
+  {
+    const TopicBenchTopic_t *topic = &topics[i];
+    const TopicRouter_t *router = topic->platform ? &kaaRouter : &azureRouter;
+
+    handledRoute = route_none;
+    handledValue = 0;
+    TopicRouter_dispatch(router, topic->topic, topic->length, NULL);
+    routed[handledRoute]++;
+    if ((handledRoute != topic->route) || (handledValue != topic->value))
+    {
+      if (benchWrong < 10)
+      {
+        printf("wrong: %s -> %s %ld\r\n", topic->topic, routeNames[handledRoute], handledValue);
+      }
+      benchWrong++;
+    }
+  }
+  for (int r = 0; r < route_count; r++)
+  {
+    printf("%-16s %7lu\r\n", routeNames[r], (unsigned long)routed[r]);
+  }
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t r = 0; r < rounds; r++)
+  {
+    for (uint32_t i = 0; i < count; i++)
+    {
+      const TopicBenchTopic_t *topic = &topics[i];
+
+      sink += TopicRouter_dispatch(topic->platform ? &kaaRouter : &azureRouter, topic->topic, topic->length, NULL);
+    }
+  }
+  printf("dispatch %8.1f ns per topic, match and handler fields\r\n",
+         TopicBench_nsPer(startUs, (uint64_t)count * rounds));
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t r = 0; r < rounds; r++)
+  {
+    for (uint32_t i = 0; i < count; i++)
+    {
+      const TopicBenchTopic_t *topic = &topics[i];
+      TopicMatch_t match;
+      TopicHandler_t handler;
+
+      sink += TopicRouter_match(topic->platform ? &kaaRouter : &azureRouter, topic->topic, topic->length, &match,
+                                &handler);
+    }
+  }
+  printf("match    %8.1f ns per topic, route and captures\r\n", TopicBench_nsPer(startUs, (uint64_t)count * rounds));
+
+  startUs = BasePlatform_micros64();
+  for (uint32_t r = 0; r < rounds; r++)
+  {
+    for (uint32_t i = 0; i < count; i++)
+    {
+      sink += TopicBench_legacy(&topics[i]);
+    }
+  }
+  printf("strtok   %8.1f ns per topic, fewer routes and checks\r\n",
+         TopicBench_nsPer(startUs, (uint64_t)count * rounds));
+
+  printf("%lu wrong (%lu)\r\n", (unsigned long)benchWrong, (unsigned long)(sink & 1));
+  free(topics);
+  return benchWrong ? 1 : 0;
+}
+/**         EOF         */
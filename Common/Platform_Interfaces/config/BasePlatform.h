@@ -1,16 +1,240 @@
+/**
+ * \file
+ * \brief POSIX host platform drivers.
+ *
+ * This code is the host (Linux) implementation of the platform abstraction
+ * used by the board and PnP layers. It allows the application to be built
+ * and run on a PC with the serial ports mapped to a pty or a tty, the I2C
+ * bus mapped to a pluggable bus model and the board peripherals recorded
+ * in memory.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
 #ifndef BASEPLATFORM_H
 #define BASEPLATFORM_H
 
 /**         Includes         */
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define WE_SUCCESS 0
+#define WE_FAIL 1
+#define MAX_PRINT_LEN 1280
+#define I2C_CLOCK_SPEED_FAST 400000
+#define I2C_CLOCK_SPEED_STANDARD 100000
+#define I2C_TRANSFER_PENDING (-1)
+
+#define V_BAT_PIN 7
+
+#define NEO_PIXEL_RED ((uint32_t)(50 << 16) + (uint32_t)(0 << 8) + (uint32_t)0)
+#define NEO_PIXEL_ORANGE ((uint32_t)(50 << 16) + (uint32_t)(15 << 8) + (uint32_t)0)
+#define NEO_PIXEL_GREEN ((uint32_t)(0 << 16) + (uint32_t)(50 << 8) + (uint32_t)0)
+#define NEO_PIXEL_OFF (uint32_t)0
+
+#define BTN_LONG_PRESS_DURATION_MS 2000
+
+#define BUTTONS 3
+#define BUTTON_A_ID 0
+#define BUTTON_B_ID 1
+#define BUTTON_C_ID 2
+
+/* Arduino core compatibility */
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 2
+#define FALLING 3
+#define RISING 4
+#define digitalPinToInterrupt(p) (p)
+
+/* Size reported by HSerial_availableForWrite, the host write never blocks */
+#define BASE_SERIAL_WRITE_BUFFER 8192
+/* Longest sleep of cpuSleep, the SysTick period of the target */
+#define BASE_SLEEP_MAX_US 1000
+
 /**         Functions definition         */
 
 #ifdef __cplusplus
-extern "C" {
+extern "C"
+{
 #endif
 
+    typedef uint8_t byte;
+
+    /**
+     * @brief Host serial port, passed to Device_init in place of the
+     * Arduino Serial/Serial1 objects
+     */
+    typedef struct
+    {
+        const char *name; /* Name shown in the debug output */
+        int fdIn;         /* File descriptor read from, -1 if not open */
+        int fdOut;        /* File descriptor written to, -1 if not open */
+    } BaseSerial_t;
+
+    extern BaseSerial_t Serial;  /* Debug port, mapped to stdin/stdout */
+    extern BaseSerial_t Serial1; /* Calypso port, mapped to a pty or a tty */
+
+    bool BaseSerial_openPty(BaseSerial_t *serial);
+    bool BaseSerial_openTty(BaseSerial_t *serial, const char *path, uint32_t baud_count);
+    bool BaseSerial_openPipe(BaseSerial_t *serial, int *peerIn, int *peerOut);
+    void BaseSerial_close(BaseSerial_t *serial);
+
+    /**
+     * @brief Pluggable I2C bus model. Every callback receives the currently
+     * addressed device. A NULL callback makes the transfer fail.
+     */
+    typedef struct
+    {
+        void *context;
+        int8_t (*readReg)(void *context, int address, uint8_t regAdr, int length, uint8_t *data);
+        int8_t (*writeReg)(void *context, int address, uint8_t regAdr, int length, const uint8_t *data);
+        int8_t (*send)(void *context, int address, const uint8_t *data, int length);
+        int8_t (*receive)(void *context, int address, uint8_t *data, int length);
+        void (*setClock)(void *context, uint32_t baudrate);
+    } I2CBusModel_t;
+
+    void I2CSetBusModel(const I2CBusModel_t *model);
+
+    uint64_t BasePlatform_micros64(void);
+    void BasePlatform_advanceClock(uint64_t us);
+    unsigned long millis(void);
+    unsigned long micros(void);
+    void delay(unsigned long ms);
+    void delayMicroseconds(unsigned int us);
+    void pinMode(uint32_t pin, uint32_t mode);
+    int digitalRead(uint32_t pin);
+    void digitalWrite(uint32_t pin, uint32_t value);
+    void attachInterrupt(uint32_t pin, void (*callback)(void), uint32_t mode);
+    void BasePlatform_triggerInterrupt(uint32_t pin);
+
+    void BasePlatform_setArgs(int argc, char **argv);
+
+    typedef struct
+    {
+        void *obj;
+    } TypeSerial;
+
+    typedef struct
+    {
+        void *obj;
+    } TypeHardwareSerial;
+
+    void soft_reset();
+    void SSerial_destroy(TypeSerial *m);
+    TypeSerial *SSerial_create(void *ser);
+
+    size_t SSerial_write(TypeSerial *m, uint8_t byte);
+    size_t SSerial_writeB(TypeSerial *m, const char *buffer, size_t size);
+    void SSerial_begin(TypeSerial *m, uint32_t baud_count);
+    void SSerial_beginP(TypeSerial *m, uint32_t baud_count, uint8_t parameter);
+    int SSerial_available(TypeSerial *m);
+    void SSerial_flush(TypeSerial *m);
+    void SSerial_printf(TypeSerial *m, const char format[], ...);
+    int SSerial_read(TypeSerial *m);
+
+    void HSerial_destroy(TypeHardwareSerial *m);
+    TypeHardwareSerial *HSerial_create(void *ser);
+
+    size_t HSerial_write(TypeHardwareSerial *m, uint8_t byte);
+    size_t HSerial_writeB(TypeHardwareSerial *m, const char *buffer, size_t size);
+    void HSerial_begin(TypeHardwareSerial *m, uint32_t baud_count);
+    void HSerial_beginP(TypeHardwareSerial *m, uint32_t baud_count,
+                        uint8_t parameter);
+    void HSerial_end(TypeHardwareSerial *m);
+    int HSerial_available(TypeHardwareSerial *m);
+    int HSerial_availableForWrite(TypeHardwareSerial *m);
+    void HSerial_flush(TypeHardwareSerial *m);
+    int HSerial_read(TypeHardwareSerial *m);
+
+    typedef enum
+    {
+        i2cTransferWrite,   /* Register address then data */
+        i2cTransferRead,    /* Register address, repeated start then data */
+        i2cTransferSend,    /* Data only */
+        i2cTransferReceive  /* Read without register address */
+    } I2CTransferType_t;
+
+    /**
+     * @brief Descriptor of a queued I2C transfer. It is owned by the I2C
+     * engine from I2CSubmit until its callback is called, the data buffer
+     * must stay valid for the same time.
+     */
+    typedef struct I2CTransfer
+    {
+        struct I2CTransfer *next;
+        I2CTransferType_t type;
+        uint8_t address;
+        uint8_t regAdr;
+        uint8_t *data;
+        uint16_t length;
+        void (*callback)(struct I2CTransfer *transfer); /* Called from I2CPoll, may be NULL */
+        void *context;
+        volatile int8_t status; /* I2C_TRANSFER_PENDING, then WE_SUCCESS or WE_FAIL */
+    } I2CTransfer_t;
+
+    void I2CSetAddress(int address);
+    int8_t I2CInit(int address);
+    void I2CSetClock(uint32_t baudrate);
+    int8_t ReadReg(uint8_t RegAdr, int NumByteToRead, uint8_t *Data);
+    int8_t WriteReg(int RegAdr, int NumByteToWrite, uint8_t *Data);
+    int8_t I2CReceive(uint8_t *data, int datalen);
+    int8_t I2CSend(uint8_t *data, int datalen);
+    int8_t I2CSubmit(I2CTransfer_t *transfer);
+    int8_t I2CWait(I2CTransfer_t *transfer);
+    void I2CWaitIdle();
+    bool I2CIsIdle();
+    void I2CPoll();
+
+    void neopixelInit();
+    void neopixelSet(uint32_t color);
+    uint32_t neopixelGet();
+    uint32_t neopixelGetChangeCount();
+
+    void buttonInit(uint8_t buttonId, uint8_t pin, void (*OnBtnPress)(), void (*OnBtnLongPress)());
+    void buttonUpdate();
+    bool buttonIsPressed();
+    void buttonPress(uint8_t buttonId, bool longPress);
+    float getBatteryVoltage();
+    void setBatteryVoltage(float voltage);
+
+    void SH1107_Init();
+
+    bool wakeupAlarmInit();
+    uint32_t wakeupAlarmSet(uint32_t delayMs);
+    uint32_t wakeupAlarmGet();
+    uint32_t cpuSleep(bool standby);
+    void noInterrupts();
+    void interrupts();
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* BASEPLATFORM_H */
\ No newline at end of file
+#endif /* BASEPLATFORM_H */
@@ -3,7 +3,9 @@
 
 /**         Includes         */
 
+#ifndef BASE_PLATFORM
 #define ARDUINO_PLATFORM 1
+#endif
 
 #ifndef SERIAL_DEBUG
 #define SERIAL_DEBUG 1
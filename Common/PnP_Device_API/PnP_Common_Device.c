@@ -28,6 +28,12 @@
 #include "PnP_Common_Device.h"
 #include "PnP_Device_Azure.h"
 #include "PnP_Device_KaaIoT.h"
+#include "PnP_Web_Assets.h"
+#include "inflate.h"
+
+#if WEB_ASSETS_WINDOW_BITS > INFLATE_WINDOW_BITS
+#error "Web assets compressed with a larger window than the inflater keeps"
+#endif
 
 IoT_platforms_t platform = AZURE;
 
@@ -51,7 +57,48 @@ TIDS *sensorTIDS;
 //------WSEN_HIDS
 HIDS *sensorHIDS;
 
+// Connection manager of the Calypso
+static CalypsoLink_t calypsoLink;
+static bool Device_openSession(CALYPSO *self);
+static bool Device_resubscribe(CALYPSO *self);
+
+// State of the module files checked at a previous boot
+static bool bootSnapshotValid = false;
+
+// Registered platform drivers and the one selected at init
+static const Device_Platform_t *platformDrivers[DEVICE_PLATFORMS_MAX];
+static uint8_t platformDriverCount = 0;
+static const Device_Platform_t noPlatform;
+static const Device_Platform_t *driver = &noPlatform;
+
+// Selected IoT platform
+static CalypsoConfig_t platformConfig = CALYPSO_CONFIG_INIT(PLATFORM_CONFIG_FILE_PATH, Device_configChanged);
+
+// Web files written from the firmware, in the order they are written.
+// Generated from GW/web by GW/scripts/web_assets.py.
+typedef struct
+{
+    const char *path;
+    const uint8_t *data; /* Raw DEFLATE */
+    uint16_t size;       /* Of the compressed data */
+    uint16_t length;     /* Of the file */
+    bool kaaiotOnly;
+} Device_WebAsset_t;
+
+static const Device_WebAsset_t webAssets[] = {
+    {INDEX_HTML_SRC_FILE_PATH, indexHtmlSrcFile, INDEX_HTML_SRC_FILE_SIZE, INDEX_HTML_SRC_FILE_LENGTH, false},
+    {INDEX_HTML_FILE_PATH, indexHtmlFile, INDEX_HTML_FILE_SIZE, INDEX_HTML_FILE_LENGTH, false},
+    {KAAIOT_HTML_FILE_PATH, kaaiotHtmlFile, KAAIOT_HTML_FILE_SIZE, KAAIOT_HTML_FILE_LENGTH, true},
+    {KAAIOT_JS_FILE_PATH, kaaiotJsFile, KAAIOT_JS_FILE_SIZE, KAAIOT_JS_FILE_LENGTH, true}};
+
+#define WEB_ASSETS_COUNT (sizeof(webAssets) / sizeof(webAssets[0]))
+
+// Hashes of the web files, computed at the first use
+static uint32_t webAssetHashes[WEB_ASSETS_COUNT];
+static bool Device_loadBootSnapshot();
+
 bool sensorsPresent = false;
+bool motionEventsEnabled = false;
 bool deviceProvisioned = false;
 bool deviceConfigured = false;
 
@@ -70,6 +117,36 @@ float lastBattVolt = 0;
 
 char pubtopic[128];
 
+Deadband_Channel telemetryDeadband[telemetryChannels];
+/*Telemetry published and waiting for its PUBACK. One more than the messages
+  in flight, the slot of a new message is filled before it waits for room.*/
+#define DEVICE_PENDING_TELEMETRY (CALYPSO_MQTT_INFLIGHT + 1)
+typedef struct
+{
+    int32_t values[telemetryChannels];
+    uint8_t reportMask;
+} Device_pendingTelemetry_t;
+static Device_pendingTelemetry_t pendingTelemetry[DEVICE_PENDING_TELEMETRY];
+static uint8_t pendingTelemetryNext = 0;
+/*Sensor data units per property unit of each telemetry channel*/
+static const int32_t telemetryScale[telemetryChannels] = {
+    PADS_PRESSURE_SCALE,
+    HIDS_HUMIDITY_SCALE,
+    TIDS_TEMPERATURE_SCALE,
+    ITDS_ACCELERATION_SCALE,
+    ITDS_ACCELERATION_SCALE,
+    ITDS_ACCELERATION_SCALE,
+#if VIBRATION_ANALYSIS
+    ITDS_ACCELERATION_SCALE,
+#endif
+};
+volatile unsigned long telemetryHeartbeat = (unsigned long)(DEFAULT_TELEMETRY_HEARTBEAT * 1000);
+
+/*Rate limiting of motion events*/
+static unsigned long motionEventTime[itdsMotionEvents];
+static uint16_t motionEventSuppressed[itdsMotionEvents];
+static uint8_t motionEventSent = 0;
+
 extern char displayText[];
 
 IoT_platforms_t getPlatform()
@@ -77,6 +154,207 @@ IoT_platforms_t getPlatform()
     return platform;
 }
 
+/* Driver selected until Device_init selects one, its functions fail */
+static void Device_noPlatform()
+{
+    SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+}
+
+static TypeSerial *Device_noPlatformInit(void *Debug, void *CalypsoSerial)
+{
+    (void)Debug;
+    (void)CalypsoSerial;
+    Device_noPlatform();
+    return NULL;
+}
+
+static bool Device_noPlatformBool()
+{
+    Device_noPlatform();
+    return false;
+}
+
+static uint32_t Device_noPlatformConfigHash()
+{
+    return 0;
+}
+
+static bool Device_noPlatformPublishMotionEvent(const char *event, uint16_t count)
+{
+    (void)event;
+    (void)count;
+    Device_noPlatform();
+    return false;
+}
+
+static unsigned long Device_noPlatformInterval()
+{
+    Device_noPlatform();
+    return 0;
+}
+
+static const Device_Platform_t noPlatform = {
+    AZURE,
+    "",
+    "",
+    Device_noPlatformInit,
+    Device_noPlatformBool,
+    NULL,
+    Device_noPlatform,
+    Device_noPlatformConfigHash,
+    Device_noPlatformBool,
+    Device_noPlatform,
+    Device_noPlatformBool,
+    Device_noPlatformBool,
+    Device_noPlatformBool,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatformBool,
+    Device_noPlatform,
+    Device_noPlatformPublishMotionEvent,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatform,
+    Device_noPlatformInterval,
+    Device_noPlatformBool};
+
+/**
+ * @brief  Register the drivers of the platforms built into the firmware,
+ *         once before the first use of the driver table
+ * @retval None
+ */
+static void Device_registerBuiltinPlatforms()
+{
+    static bool registered = false;
+
+    if (registered)
+    {
+        return;
+    }
+    registered = true;
+#if PNP_PLATFORM_AZURE
+    Device_registerPlatform(&Azure_Device_platform);
+#endif
+#if PNP_PLATFORM_KAAIOT
+    Device_registerPlatform(&Kaaiot_Device_platform);
+#endif
+}
+
+/**
+ * @brief  Register a platform driver. A driver with the id of a registered
+ *         one replaces it, e.g. a mock of a built-in platform on the host.
+ * @param  platformDriver Driver, must stay valid
+ * @retval true if successful false if the table is full
+ */
+bool Device_registerPlatform(const Device_Platform_t *platformDriver)
+{
+    Device_registerBuiltinPlatforms();
+    for (uint8_t i = 0; i < platformDriverCount; i++)
+    {
+        if (platformDrivers[i]->id == platformDriver->id)
+        {
+            if (driver == platformDrivers[i])
+            {
+                driver = platformDriver;
+            }
+            platformDrivers[i] = platformDriver;
+            return true;
+        }
+    }
+    if (platformDriverCount >= DEVICE_PLATFORMS_MAX)
+    {
+        return false;
+    }
+    platformDrivers[platformDriverCount++] = platformDriver;
+    return true;
+}
+
+/**
+ * @brief  Driver of a platform
+ * @param  id IoT platform
+ * @retval Driver, NULL if the platform is not registered
+ */
+const Device_Platform_t *Device_findPlatform(IoT_platforms_t id)
+{
+    Device_registerBuiltinPlatforms();
+    for (uint8_t i = 0; i < platformDriverCount; i++)
+    {
+        if (platformDrivers[i]->id == id)
+        {
+            return platformDrivers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Driver of a platform by its name in the platform file
+ * @param  name Platform name
+ * @retval Driver, NULL if the platform is not registered
+ */
+static const Device_Platform_t *Device_findPlatformByName(const char *name)
+{
+    Device_registerBuiltinPlatforms();
+    for (uint8_t i = 0; i < platformDriverCount; i++)
+    {
+        if (strcmp(platformDrivers[i]->name, name) == 0)
+        {
+            return platformDrivers[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Select the driver the Device_* functions call
+ * @param  id IoT platform
+ * @retval true if successful false if the platform is not registered
+ */
+bool Device_selectPlatform(IoT_platforms_t id)
+{
+    const Device_Platform_t *platformDriver = Device_findPlatform(id);
+
+    if (platformDriver == NULL)
+    {
+        return false;
+    }
+    driver = platformDriver;
+    platform = id;
+    return true;
+}
+
+/**
+ * @brief  Driver selected at init
+ * @retval Driver, NULL if none is selected
+ */
+const Device_Platform_t *Device_getPlatformDriver()
+{
+    return (driver != &noPlatform) ? driver : NULL;
+}
+
+/**
+ * @brief  Registered platform following the selected one, for switching
+ * @retval Driver, NULL if no other platform is registered
+ */
+const Device_Platform_t *Device_getNextPlatform()
+{
+    Device_registerBuiltinPlatforms();
+    for (uint8_t i = 0; i < platformDriverCount; i++)
+    {
+        if (platformDrivers[i] == driver)
+        {
+            const Device_Platform_t *next = platformDrivers[(i + 1) % platformDriverCount];
+
+            return (next != driver) ? next : NULL;
+        }
+    }
+    return (platformDriverCount > 0) ? platformDrivers[0] : NULL;
+}
+
 void deadLoop()
 {
     while (true)
@@ -97,11 +375,13 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
     SerialCalypso = HSerial_create(CalypsoSerial);
 
     SSerial_begin(SerialDebug, 115200);
+    DebugLog_init(SerialDebug);
 
     HSerial_beginP(SerialCalypso, 921600,
                    (uint8_t)((0x10ul) | (0x1ul) | (0x400ul)));
 
     calypso = Calypso_Create(SerialDebug, SerialCalypso, &calypsoParams);
+    CalypsoLink_init(&calypsoLink, calypso, Device_openSession, Device_resubscribe);
 
     sensorPADS = PADSCreate(SerialDebug);
     sensorITDS = ITDSCreate(SerialDebug);
@@ -110,13 +390,7 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
 
     SSerial_printf(SerialDebug, "Starting the application...\r\n");
 
-    if (!Calypso_simpleInit(calypso))
-    {
-        SSerial_printf(SerialDebug, "Calypso init failed \r\n");
-        sprintf(displayText, "Calypso Init Failed...");
-        SH1107_Display(1, 0, 24, displayText);
-    }
-
+    /* The sensors do not depend on Calypso, they are set up while it boots */
     if (!PADS_simpleInit(sensorPADS))
     {
         SSerial_printf(SerialDebug, "PADS init failed \r\n");
@@ -137,6 +411,11 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
     else
     {
         sensorsPresent = true;
+        motionEventsEnabled = ITDS_enableMotionEvents(sensorITDS);
+        if (!motionEventsEnabled)
+        {
+            SSerial_printf(SerialDebug, "ITDS motion events init failed \r\n");
+        }
     }
 
     if (!TIDS_simpleInit(sensorTIDS))
@@ -160,50 +439,70 @@ TypeSerial *Device_init(void *Debug, void *CalypsoSerial)
     {
         sensorsPresent = true;
     }
-    packetLost = 0;
 
-    Device_loadPlatformId();
+    /* Calypso boots slower than the MCU after power-on and reports the end
+     * of its boot. It is already running after a reset of the MCU alone. */
+    Calypso_waitForStatus(calypso, calypso_started, CALYPSO_STARTUP_TIMEOUT);
 
-    if (platform == KAAIOT)
-    {
-        return Kaaiot_Device_init(Debug, CalypsoSerial);
-    }
-    if (platform == AZURE)
+    if (!Calypso_simpleInit(calypso))
     {
-        return Azure_Device_init(Debug, CalypsoSerial);
+        SSerial_printf(SerialDebug, "Calypso init failed \r\n");
+        sprintf(displayText, "Calypso Init Failed...");
+        SH1107_Display(1, 0, 24, displayText);
     }
-}
 
-bool Device_ConfigurationComplete()
-{
-    if (platform == KAAIOT)
-    {
-        return Kaaiot_Device_ConfigurationComplete();
-    }
-    else if (platform == AZURE)
+    packetLost = 0;
+
+    /* The files are read again after a reset of the MCU alone */
+    CalypsoConfig_unloadAll();
+    Device_initTelemetryFilter();
+    if (!Device_loadBootSnapshot())
     {
-        return Azure_Device_ConfigurationComplete();
+        Device_loadPlatformId();
     }
-    else
+
+    /* The driver of the first platform built in if the stored one is not */
+    if (!Device_selectPlatform(platform) && !Device_selectPlatform(platformDrivers[0]->id))
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
         return NULL;
     }
+    return driver->init(Debug, CalypsoSerial);
+}
+
+bool Device_ConfigurationComplete()
+{
+    Device_invalidateBootSnapshot();
+    /* The web server wrote the configuration files */
+    CalypsoConfig_unloadAll();
+    return driver->configurationComplete();
 }
 
 void Device_deletePreviousConfigIfExist()
 {
-    if (platform == KAAIOT)
+    if (driver->deletePreviousConfig != NULL)
     {
-        Kaaiot_Device_deletePreviousConfig();
+        driver->deletePreviousConfig();
     }
 }
 
-bool Device_writeConfigFile(const char *path, const char *data)
+/**
+ * @brief  Store the IoT platform used from the next boot on
+ * @param  id IoT platform
+ * @retval true if successful false in case of failure
+ */
+bool Device_savePlatformId(IoT_platforms_t id)
 {
-    if (!Calypso_writeFile(calypso, path, data, strlen(data)))
+    const Device_Platform_t *platformDriver = Device_findPlatform(id);
+
+    if (platformDriver == NULL)
+    {
+        SSerial_printf(SerialDebug, "Platform not built in\r\n");
+        return false;
+    }
+    if (!CalypsoConfig_setString(&platformConfig, "platform", platformDriver->name) ||
+        !CalypsoConfig_commit(&platformConfig, calypso))
     {
-        SSerial_printf(SerialDebug, "Unable to write file: %s\r\n", path);
+        SSerial_printf(SerialDebug, "Unable to write file: %s\r\n", PLATFORM_CONFIG_FILE_PATH);
         return false;
     }
     return true;
@@ -211,490 +510,1028 @@ bool Device_writeConfigFile(const char *path, const char *data)
 
 void Device_writeConfigFiles()
 {
-    if (platform == KAAIOT)
-    {
-        Kaaiot_Device_writeConfigFiles();
-    }
-    else if (platform == AZURE)
-    {
-        Azure_Device_writeConfigFiles();
-    }
-    else
-    {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-    }
+    driver->writeConfigFiles();
 }
 
 void Device_restart()
 {
-    if (platform == KAAIOT)
-    {
-        Kaaiot_Device_restart();
-    }
-    else if (platform == AZURE)
-    {
-        Azure_Device_restart();
-    }
-    else
-    {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-    }
+    driver->restart();
 }
 
 bool Device_isStatusOK()
 {
-    if (platform == KAAIOT)
-    {
-        return Kaaiot_Device_isStatusOK();
-    }
-    else if (platform == AZURE)
-    {
-        return Azure_Device_isStatusOK();
-    }
-    else
-    {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-        return NULL;
-    }
+    return driver->isStatusOK();
 }
 
 bool Device_isConnectedToWiFi()
 {
-    if (platform == KAAIOT)
-    {
-        return Kaaiot_Device_isConnectedToWiFi();
-    }
-    else if (platform == AZURE)
-    {
-        return Azure_Device_isConnectedToWiFi();
-    }
-    else
-    {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-        return NULL;
-    }
+    return driver->isConnectedToWiFi();
 }
 
 bool Device_isUpToDate()
 {
-    if (platform == KAAIOT)
-    {
-        return Kaaiot_Device_isUpToDate();
-    }
-    else if (platform == AZURE)
-    {
-        return Azure_Device_isUpToDate();
-    }
-    else
-    {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-        return NULL;
-    }
+    return driver->isUpToDate();
 }
 
 static int getFileLength(char *path)
 {
-    char buffer[100];
+    uint32_t fileSize;
 
-    if (Calypso_fileExists(calypso, path))
+    if (!Calypso_getFileSize(calypso, path, &fileSize))
     {
-        // parse file length
-        if (0 == strncmp(calypso->bufferCalypso.data, "+filegetinfo:", 13))
-        {
-            strncpy(buffer, calypso->bufferCalypso.data, sizeof(buffer));
-
-            // Use strtok to split the string by commas
-            char *token = strtok(buffer, ",");
-
-            int tokenIndex = 0, fileSize = 0;
-
-            // Iterate through tokens
-            while (token != NULL)
-            {
-                tokenIndex++;
-                // The second token is the file size
-                if (tokenIndex == 2)
-                {
-                    fileSize = atoi(token); // Convert the token (which is a string) to an integer
-                    break;
-                }
-                token = strtok(NULL, ",");
-            }
-
-            return fileSize;
-        }
+        return -1;
     }
-    return -1;
+    return (int)fileSize;
 }
 
 bool Device_loadPlatformId()
 {
-    bool ret = true;
-    char configBuf[256];
-    uint16_t len;
+    const Device_Platform_t *platformDriver;
+    const char *id;
 
-    // check if platform.json exist
-    if (!Calypso_fileExists(calypso, PLATFORM_CONFIG_FILE_PATH))
+    if (!CalypsoConfig_load(&platformConfig, calypso))
     {
-        SSerial_printf(SerialDebug, "%s file not exist\r\n", PLATFORM_CONFIG_FILE_PATH);
-        if (Device_writeConfigFile(PLATFORM_CONFIG_FILE_PATH, "{\"platform\":\"KAAIOT\"}"))
+        if (CalypsoConfig_exists(&platformConfig))
         {
-            SSerial_printf(SerialDebug, "Platform default is KAAIOT\r\n");
-            platform = KAAIOT;
-            sprintf(displayText, "Error! File not exist\r\n%s\r\n\r\nPlatform not\r\nconfigured.\r\n\r\nLoad default\r\nplatform: KAAIOT", PLATFORM_CONFIG_FILE_PATH);
+            SSerial_printf(SerialDebug, "Unable to parse config file %s\r\n", PLATFORM_CONFIG_FILE_PATH);
+            sprintf(displayText, "Error!!!\r\n\r\nCan't parse file\r\n\r\n%s", PLATFORM_CONFIG_FILE_PATH);
+            Device_displayMessageWithDelay(displayText);
+            return false;
         }
-        else
+        SSerial_printf(SerialDebug, "%s file not exist\r\n", PLATFORM_CONFIG_FILE_PATH);
+        platformDriver = Device_findPlatform(PNP_DEFAULT_PLATFORM);
+        if ((platformDriver != NULL) && Device_savePlatformId(platformDriver->id))
         {
-            SSerial_printf(SerialDebug, "Can't write file: %s\r\n", PLATFORM_CONFIG_FILE_PATH);
-            sprintf(displayText, "Error!!!\r\n\r\nCan't write file\r\n\r\n%s", PLATFORM_CONFIG_FILE_PATH);
-            ret = false;
+            SSerial_printf(SerialDebug, "Platform default is %s\r\n", platformDriver->name);
+            platform = platformDriver->id;
+            sprintf(displayText, "Error! File not exist\r\n%s\r\n\r\nPlatform not\r\nconfigured.\r\n\r\nLoad default\r\nplatform: %s", PLATFORM_CONFIG_FILE_PATH, platformDriver->name);
+            Device_displayMessageWithDelay(displayText);
+            return true;
         }
+        SSerial_printf(SerialDebug, "Can't write file: %s\r\n", PLATFORM_CONFIG_FILE_PATH);
+        sprintf(displayText, "Error!!!\r\n\r\nCan't write file\r\n\r\n%s", PLATFORM_CONFIG_FILE_PATH);
         Device_displayMessageWithDelay(displayText);
+        return false;
     }
-    else
+
+    id = CalypsoConfig_getString(&platformConfig, "platform", "");
+    platformDriver = Device_findPlatformByName(id);
+    if (platformDriver == NULL)
     {
-        if (Calypso_readFile(calypso, PLATFORM_CONFIG_FILE_PATH, (char *)configBuf, 256, &len))
-        {
-            json_value *platformConfig = json_parse(configBuf, len);
-            if (platformConfig == NULL)
-            {
-                SSerial_printf(SerialDebug, "Unable to parse config file %s\r\n", PLATFORM_CONFIG_FILE_PATH);
-                sprintf(displayText, "Error!!!\r\n\r\nCan't parse file\r\n\r\n%s", PLATFORM_CONFIG_FILE_PATH);
-                Device_displayMessageWithDelay(displayText);
-                return false;
-            }
-            if (strcmp("KAAIOT", platformConfig->u.object.values[0].value->u.string.ptr) == 0)
-            {
-                platform = KAAIOT;
-                sprintf(displayText, "Selected IoT platform\r\n\r\n       KAAIOT");
-                Device_displayMessageWithDelay(displayText);
-            }
-            else if (strcmp("AZURE", platformConfig->u.object.values[0].value->u.string.ptr) == 0)
-            {
-                platform = AZURE;
-                sprintf(displayText, "Selected IoT platform\r\n\r\n       AZURE");
-                Device_displayMessageWithDelay(displayText);
-            }
-            else
-            {
-                SSerial_printf(SerialDebug, "Unknown platform value: %s\r\n", platformConfig->u.object.values[0].value->u.string.ptr);
-                sprintf(displayText, "Selected IoT platform:\r\n\r\n       UNKNOWN");
-                Device_displayMessageWithDelay(displayText);
-                return false;
-            }
-        }
+        /* Unknown or not built into this firmware */
+        SSerial_printf(SerialDebug, "Unknown platform value: %s\r\n", id);
+        sprintf(displayText, "Selected IoT platform:\r\n\r\n       UNKNOWN");
+        Device_displayMessageWithDelay(displayText);
+        return false;
     }
-    return ret;
+    platform = platformDriver->id;
+    sprintf(displayText, "Selected IoT platform\r\n\r\n       %s", platformDriver->name);
+    Device_displayMessageWithDelay(displayText);
+    return true;
 }
 
-bool Device_isIotPlatformConfigured()
+/**
+ * @brief  Hash of the compressed data of a web file, computed once
+ * @param  index Index in webAssets
+ * @retval FNV-1a hash
+ */
+static uint32_t Device_getWebAssetHash(uint8_t index)
+{
+    if (webAssetHashes[index] == 0)
+    {
+        webAssetHashes[index] = Checksum_fnv1a(CHECKSUM_FNV1A_INIT, webAssets[index].data, webAssets[index].size);
+    }
+    return webAssetHashes[index];
+}
+
+/**
+ * @brief  Check if a web file is used by a platform
+ * @param  index Index in webAssets
+ * @param  id IoT platform
+ * @retval true if the platform uses the file
+ */
+static bool Device_isWebAssetUsed(uint8_t index, IoT_platforms_t id)
+{
+    return !webAssets[index].kaaiotOnly || (id == KAAIOT);
+}
+
+/**
+ * @brief  Write the web files of the platform that changed since they were
+ *         last written. The manifest keeps a hash,length,path line for each
+ *         written file, a file is only rewritten if its line is missing or
+ *         its size on the module differs.
+ * @param  id IoT platform
+ * @retval true if all the web files of the platform are up to date
+ */
+static bool Device_syncWebAssets(IoT_platforms_t id)
 {
+    char manifest[WEB_MANIFEST_MAX_LEN];
+    char updated[WEB_MANIFEST_MAX_LEN];
+    char entry[WEB_MANIFEST_ENTRY_LEN];
+    uint16_t len = 0;
     bool ret = true;
 
-    // create index_src.html - it is original index.html file
-    if (!Calypso_fileExists(calypso, INDEX_HTML_SRC_FILE_PATH))
+    if (!Calypso_readFile(calypso, WEB_MANIFEST_FILE_PATH, manifest, sizeof(manifest) - 1, &len))
     {
-        SSerial_printf(SerialDebug, "%s file not exist\r\n", INDEX_HTML_SRC_FILE_PATH);
-        sprintf(displayText, "Error!!!\r\n\r\nFile not exist\r\n\r\n%s\r\n", INDEX_HTML_SRC_FILE_PATH);
-        Device_displayMessageWithDelay(displayText);
+        len = 0;
+    }
+    manifest[len] = '\0';
+    updated[0] = '\0';
 
-        if (!Calypso_writeBigFile(calypso, INDEX_HTML_SRC_FILE_PATH, INDEX_HTML_SRC_FILE, strlen(INDEX_HTML_SRC_FILE)))
+    for (uint8_t i = 0; i < WEB_ASSETS_COUNT; i++)
+    {
+        const Device_WebAsset_t *asset = &webAssets[i];
+        bool listed;
+        int fileSize;
+
+        snprintf(entry, sizeof(entry), "%08lx,%u,%s\n", (unsigned long)Device_getWebAssetHash(i),
+                 (unsigned int)asset->length, asset->path);
+        listed = (strstr(manifest, entry) != NULL);
+
+        if (!Device_isWebAssetUsed(i, id) || !ret)
         {
-            SSerial_printf(SerialDebug, "Unable to write file %s\r\n", INDEX_HTML_SRC_FILE_PATH);
-            sprintf(displayText, "Error!!!\r\nUnable to write file\r\n%s", INDEX_HTML_SRC_FILE_PATH);
-            Device_displayMessageWithDelay(displayText);
-            return false; // to avoid rewriting of index.html
+            /* Not checked now, its line stays for a later platform switch */
+            if (listed)
+            {
+                strncat(updated, entry, sizeof(updated) - strlen(updated) - 1);
+            }
+            continue;
         }
-        else
+
+        fileSize = getFileLength((char *)asset->path);
+        if (listed && (fileSize == asset->length))
         {
-            sprintf(displayText, "Backup index.html\r\nfile created:\r\n\r\n%s\r\n", INDEX_HTML_SRC_FILE_PATH);
-            Device_displayMessageWithDelay(displayText);
+            strncat(updated, entry, sizeof(updated) - strlen(updated) - 1);
+            continue;
         }
-    }
-
-    // check if the index.html file updated and rewrite it
-    if (!Calypso_fileExists(calypso, INDEX_HTML_FILE_PATH))
-    {
-        SSerial_printf(SerialDebug, "%s file not exist\r\n", INDEX_HTML_FILE_PATH);
-        sprintf(displayText, "Error!!!\r\n\r\nFile not exist\r\n\r\n%s\r\n", INDEX_HTML_FILE_PATH);
-        Device_displayMessageWithDelay(displayText);
 
-        if (!Calypso_writeBigFile(calypso, INDEX_HTML_FILE_PATH, INDEX_HTML_FILE, strlen(INDEX_HTML_FILE)))
+        SSerial_printf(SerialDebug, "%s not updated. Current size:%i. Expected size:%u\r\n", asset->path, fileSize,
+                       (unsigned int)asset->length);
+        if (fileSize >= 0)
         {
-            SSerial_printf(SerialDebug, "Unable to write file %s\r\n", INDEX_HTML_FILE_PATH);
-            sprintf(displayText, "Error!!!\r\nUnable to write file\r\n%s", INDEX_HTML_FILE_PATH);
-            Device_displayMessageWithDelay(displayText);
-            ret = false;
+            Calypso_deleteFile(calypso, asset->path);
         }
-        else
+        if (!Calypso_writeCompressedFile(calypso, asset->path, asset->data, asset->size, asset->length))
         {
-            sprintf(displayText, "File created:\r\n\r\n%s\r\n", INDEX_HTML_FILE_PATH);
+            SSerial_printf(SerialDebug, "Unable to write file %s\r\n", asset->path);
+            sprintf(displayText, "Error!!!\r\nUnable to write file\r\n%s", asset->path);
             Device_displayMessageWithDelay(displayText);
+            /* Keeps index.html from being written without its backup */
+            ret = false;
+            continue;
         }
-    }
-    else
-    {
-        int fileSize = getFileLength(INDEX_HTML_FILE_PATH);
-        if (fileSize != strlen(INDEX_HTML_FILE))
-        {
-            SSerial_printf(SerialDebug, "%s file not updated. Current size:%i. Expected size:%i\r\n",
-                           INDEX_HTML_FILE_PATH, fileSize, strlen(INDEX_HTML_FILE));
-            Calypso_deleteFile(calypso, INDEX_HTML_FILE_PATH);
-
-            if (!Calypso_writeBigFile(calypso, INDEX_HTML_FILE_PATH, INDEX_HTML_FILE, strlen(INDEX_HTML_FILE)))
-            {
-                SSerial_printf(SerialDebug, "Unable to write %s\r\n", INDEX_HTML_FILE_PATH);
-                sprintf(displayText, "Error!!!\r\n\r\nUnable to write\r\n\r\n%s\r\n", INDEX_HTML_FILE_PATH);
-                Device_displayMessageWithDelay(displayText);
-                ret = false;
-            }
-            else
-            {
-                sprintf(displayText, "File updated:\r\n\r\n%s\r\n", INDEX_HTML_FILE_PATH);
-                Device_displayMessageWithDelay(displayText);
-            }
-        }
+        strncat(updated, entry, sizeof(updated) - strlen(updated) - 1);
+        sprintf(displayText, "%s\r\n\r\n%s\r\n", (fileSize < 0) ? "File created:" : "File updated:", asset->path);
+        Device_displayMessageWithDelay(displayText);
     }
 
-    if (platform == KAAIOT && !Kaaiot_Device_isConfiguredForPlatform())
+    if ((strcmp(manifest, updated) != 0) &&
+        !Calypso_writeFile(calypso, WEB_MANIFEST_FILE_PATH, updated, strlen(updated)))
     {
-        SSerial_printf(SerialDebug, "Device was not configured for the KaaIoT\r\n");
-        return false;
+        /* The files are checked again at the next boot */
+        SSerial_printf(SerialDebug, "Unable to write file %s\r\n", WEB_MANIFEST_FILE_PATH);
     }
-
     return ret;
 }
 
-bool Device_isConfigured()
+bool Device_isIotPlatformConfigured()
 {
-    if (platform == KAAIOT)
-    {
-        return Kaaiot_Device_isConfigured();
-    }
-    else if (platform == AZURE)
+    if (bootSnapshotValid)
     {
-        return Azure_Device_isConfigured();
-    }
-    else
-    {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-        return NULL;
+        /* The web files match the firmware, checked at a previous boot */
+        return true;
     }
+
+    return Device_syncWebAssets(platform);
 }
 
-void Device_configurationInProgress()
+/**
+ * @brief  Hash of the files the platform writes to Calypso at boot
+ * @param  id IoT platform
+ * @retval FNV-1a hash
+ */
+static uint32_t Device_getConfigHash(IoT_platforms_t id)
 {
-    if (platform == KAAIOT)
-    {
-        Kaaiot_Device_configurationInProgress();
-    }
-    else if (platform == AZURE)
+    const Device_Platform_t *platformDriver = Device_findPlatform(id);
+
+    return (platformDriver != NULL) ? platformDriver->getConfigHash() : 0;
+}
+
+/**
+ * @brief  Hash of the web files checked by Device_isIotPlatformConfigured
+ * @param  id IoT platform
+ * @retval FNV-1a hash
+ */
+static uint32_t Device_getWebFilesHash(IoT_platforms_t id)
+{
+    uint32_t hash = CHECKSUM_FNV1A_INIT;
+
+    for (uint8_t i = 0; i < WEB_ASSETS_COUNT; i++)
     {
-        Azure_Device_configurationInProgress();
+        if (Device_isWebAssetUsed(i, id))
+        {
+            uint32_t assetHash = Device_getWebAssetHash(i);
+
+            hash = Checksum_fnv1a(hash, &assetHash, sizeof(assetHash));
+        }
     }
-    else
+    return hash;
+}
+
+/**
+ * @brief  Format the boot snapshot of the current firmware and module
+ * @param  snapshot Output buffer of BOOT_SNAPSHOT_MAX_LEN bytes
+ * @param  id IoT platform
+ * @retval None
+ */
+static void Device_formatBootSnapshot(char *snapshot, IoT_platforms_t id)
+{
+    int length = snprintf(snapshot, BOOT_SNAPSHOT_MAX_LEN, "%u,%u,%08lx,%08lx,%s,", BOOT_SNAPSHOT_VERSION,
+                          (unsigned int)id, (unsigned long)Device_getConfigHash(id),
+                          (unsigned long)Device_getWebFilesHash(id), calypso->firmwareVersion);
+
+    if ((length > 0) && (length < BOOT_SNAPSHOT_MAX_LEN))
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        snprintf(snapshot + length, BOOT_SNAPSHOT_MAX_LEN - length, "%08lx",
+                 (unsigned long)Checksum_fnv1a(CHECKSUM_FNV1A_INIT, snapshot, length));
     }
 }
 
-void Device_readSensors()
+/**
+ * @brief  Read the boot snapshot and compare it with the firmware and the
+ *         module, replaces Device_loadPlatformId if it matches
+ * @retval true if the platform was loaded from a valid snapshot
+ */
+static bool Device_loadBootSnapshot()
 {
-    if (platform == KAAIOT)
+    char stored[BOOT_SNAPSHOT_MAX_LEN];
+    char expected[BOOT_SNAPSHOT_MAX_LEN];
+    char *field;
+    uint16_t len = 0;
+    int id;
+
+    bootSnapshotValid = false;
+    if (!Calypso_readFile(calypso, BOOT_SNAPSHOT_FILE_PATH, stored, sizeof(stored) - 1, &len))
     {
-        Kaaiot_Device_readSensors();
+        SSerial_printf(SerialDebug, "No boot snapshot\r\n");
+        return false;
     }
-    else if (platform == AZURE)
+    stored[len] = '\0';
+
+    /* The platform is the second field, all the others are recomputed */
+    field = strchr(stored, ',');
+    id = (field != NULL) ? atoi(field + 1) : -1;
+    if ((id < 0) || (Device_findPlatform((IoT_platforms_t)id) == NULL))
     {
-        Azure_Device_readSensors();
+        SSerial_printf(SerialDebug, "Invalid boot snapshot\r\n");
+        return false;
     }
-    else
+    Device_formatBootSnapshot(expected, (IoT_platforms_t)id);
+    if (strcmp(stored, expected) != 0)
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        /* Other firmware, other Calypso firmware or corrupted */
+        SSerial_printf(SerialDebug, "Boot snapshot outdated\r\n");
+        return false;
     }
+
+    platform = (IoT_platforms_t)id;
+    bootSnapshotValid = true;
+    SSerial_printf(SerialDebug, "Boot snapshot valid, platform %s\r\n", Device_findPlatform(platform)->name);
+    return true;
 }
 
-void Device_MQTTConnect()
+/**
+ * @brief  Check if the files of the module were found unchanged since a
+ *         boot that went through all the checks
+ * @retval true if the boot checks can be skipped
+ */
+bool Device_isBootSnapshotValid()
+{
+    return bootSnapshotValid;
+}
+
+/**
+ * @brief  Store the boot snapshot after a boot that went through all the
+ *         checks, so that the next boot skips them
+ * @retval None
+ */
+void Device_saveBootSnapshot()
 {
-    if (platform == KAAIOT)
+    char snapshot[BOOT_SNAPSHOT_MAX_LEN];
+
+    if (bootSnapshotValid)
     {
-        Kaaiot_Device_MQTTConnect();
+        return;
     }
-    else if (platform == AZURE)
+    Device_formatBootSnapshot(snapshot, platform);
+    if (Calypso_writeFile(calypso, BOOT_SNAPSHOT_FILE_PATH, snapshot, strlen(snapshot)))
     {
-        Azure_Device_MQTTConnect();
+        bootSnapshotValid = true;
     }
-    else
+}
+
+/**
+ * @brief  Delete the boot snapshot before the platform or the configuration
+ *         files change, the next boot goes through all the checks
+ * @retval None
+ */
+void Device_invalidateBootSnapshot()
+{
+    bootSnapshotValid = false;
+    if (Calypso_fileExists(calypso, BOOT_SNAPSHOT_FILE_PATH))
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        Calypso_deleteFile(calypso, BOOT_SNAPSHOT_FILE_PATH);
     }
 }
 
+/**
+ * @brief  Listener of the configuration files: the boot snapshot is deleted
+ *         before they change
+ * @param  config Configuration file
+ * @param  key Value changed, NULL if the whole file
+ * @retval None
+ */
+void Device_configChanged(CalypsoConfig_t *config, const char *key)
+{
+    (void)config;
+    (void)key;
+    Device_invalidateBootSnapshot();
+}
+
+bool Device_isConfigured()
+{
+    return driver->isConfigured();
+}
+
+void Device_configurationInProgress()
+{
+    driver->configurationInProgress();
+}
+
+void Device_readSensors()
+{
+    driver->readSensors();
+}
+
+void Device_MQTTConnect()
+{
+    driver->MQTTConnect();
+}
+
 bool Device_SubscribeToTopics()
 {
-    if (platform == KAAIOT)
+    return driver->subscribeToTopics();
+}
+
+void Device_PublishSensorData()
+{
+    driver->publishSensorData();
+}
+
+/**
+ * @brief  Publish the motion events detected by the accelerometer
+ *
+ * Each event type is sent at most once per MOTION_EVENT_MIN_INTERVAL.
+ * Events detected in between, or not sent because the publish failed, are
+ * counted and sent with the next message.
+ * @retval None
+ */
+void Device_processMotionEvents()
+{
+    uint8_t events = 0;
+    unsigned long now;
+
+    if (!motionEventsEnabled)
     {
-        return Kaaiot_Device_SubscribeToTopics();
+        return;
     }
-    else if (platform == AZURE)
+    if (ITDS_isMotionEventPending(sensorITDS) && !ITDS_getMotionEvents(sensorITDS, &events))
     {
-        return Azure_Device_SubscribeToTopics();
+        SSerial_printf(SerialDebug, "Error reading motion events\r\n");
+        return;
     }
-    else
+
+    now = millis();
+    for (uint8_t event = 0; event < itdsMotionEvents; event++)
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-        return NULL;
+        uint16_t count = motionEventSuppressed[event];
+
+        if (events & ITDS_MOTION_EVENT_BIT(event))
+        {
+            count++;
+        }
+        if (count == 0)
+        {
+            continue;
+        }
+        if ((motionEventSent & ITDS_MOTION_EVENT_BIT(event)) && (now - motionEventTime[event] < MOTION_EVENT_MIN_INTERVAL))
+        {
+            motionEventSuppressed[event] = count;
+            continue;
+        }
+        /*A failed publish is retried after the same interval, not on every pass*/
+        motionEventSent |= ITDS_MOTION_EVENT_BIT(event);
+        motionEventTime[event] = now;
+        if (Device_PublishMotionEvent(sensorITDS->motionEventNames[event], count))
+        {
+            count = 0;
+        }
+        motionEventSuppressed[event] = count;
     }
 }
 
-void Device_PublishSensorData()
+/**
+ * @brief  Drain the sensor FIFOs that reached their watermark
+ * @retval None
+ */
+void Device_processSensorFifo()
 {
-    if (platform == KAAIOT)
+#if PADS_FIFO_BATCHING
+    if (!PADS_serviceFifo(sensorPADS, false))
     {
-        Kaaiot_Device_PublishSensorData();
+        SSerial_printf(SerialDebug, "Error reading pressure FIFO\r\n");
     }
-    else if (platform == AZURE)
+#endif
+}
+
+/**
+ * @brief  Publish a motion event to the cloud
+ * @param  event name of the event
+ * @param  count number of detections since the last message of this event
+ * @retval true if successful false otherwise
+ */
+bool Device_PublishMotionEvent(const char *event, uint16_t count)
+{
+    return driver->publishMotionEvent(event, count);
+}
+
+void Device_displaySensorData()
+{
+    driver->displaySensorData();
+}
+
+void Device_processCloudMessage()
+{
+    driver->processCloudMessage();
+}
+
+/**
+ * @brief  Check if a cloud message was received. The lines sent by Calypso
+ *         are handled without waiting and the messages queued, so that
+ *         Device_processCloudMessage never waits for one.
+ * @retval true if a message is queued
+ */
+bool Device_isCloudMessagePending()
+{
+    return Calypso_isMessagePending(calypso);
+}
+
+/**
+ * @brief  Handle the PUBACKs and retransmit the unacknowledged QoS 1
+ *         messages, called periodically while connected
+ * @retval None
+ */
+void Device_pollPublisher()
+{
+    Calypso_MQTTpoll(calypso);
+}
+
+/**
+ * @brief  Full MQTT session setup of the platform, for the connection
+ *         manager when the MQTT client must be created again
+ * @param  self Pointer to the calypso object.
+ * @retval true if connected to the broker
+ */
+static bool Device_openSession(CALYPSO *self)
+{
+    Device_MQTTConnect();
+    return (self->status == calypso_MQTT_connected);
+}
+
+/**
+ * @brief  Subscriptions of the platform, for the connection manager
+ * @param  self Pointer to the calypso object.
+ * @retval true if successful false otherwise
+ */
+static bool Device_resubscribe(CALYPSO *self)
+{
+    (void)self;
+    return Device_SubscribeToTopics();
+}
+
+/**
+ * @brief  Start the connection to the broker of the platform, the attempts
+ *         are made by Device_recoverLink
+ * @retval None
+ */
+void Device_openLink()
+{
+    CalypsoLink_open(&calypsoLink);
+}
+
+/**
+ * @brief  Check the connection to the broker, without AT commands
+ * @retval true if connected, false if a layer must be reconnected
+ */
+bool Device_isLinkUp()
+{
+    return (CalypsoLink_check(&calypsoLink) == calypso_link_ok);
+}
+
+/**
+ * @brief  Make one attempt to reconnect the failed layer with the cached
+ *         settings. The MCU is restarted once reboots of Calypso failed.
+ * @param  retryMs Delay before the next attempt if this one failed
+ * @retval true if connected to the broker again
+ */
+bool Device_recoverLink(unsigned long *retryMs)
+{
+    if (CalypsoLink_recover(&calypsoLink, retryMs))
     {
-        Azure_Device_PublishSensorData();
+        return true;
     }
-    else
+    if (CalypsoLink_isExhausted(&calypsoLink))
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        SSerial_printf(SerialDebug, "Calypso not responding, restarting\r\n");
+        Device_restart();
     }
+    return false;
 }
 
-void Device_displaySensorData()
+/**
+ * @brief  Print the connection losses and their time to recover
+ * @param  serial Output serial port
+ * @retval None
+ */
+void Device_printLinkStats(TypeSerial *serial)
+{
+    CalypsoLink_printStats(&calypsoLink, serial);
+}
+
+/**
+ * @brief  Reset the connection counters
+ * @retval None
+ */
+void Device_resetLinkStats()
+{
+    CalypsoLink_resetStats(&calypsoLink);
+}
+
+/**
+ * @brief  Set the wall clock from the SNTP time of Calypso. The timestamps
+ *         are then taken from the local time base without AT commands.
+ * @retval true if successful false otherwise
+ */
+static bool Device_synchronizeTime()
 {
-    if (platform == KAAIOT)
+    Timestamp now;
+    long long seconds;
+
+    if (!Calypso_getTimestamp(calypso, &now) || now.year < TIME_SYNC_MIN_YEAR)
     {
-        Kaaiot_Device_displaySensorData();
+        SSerial_printf(SerialDebug, "Time not synchronized\r\n");
+        return false;
     }
-    else if (platform == AZURE)
+    /* Calypso keeps the local time of the SNTP time zone, given in minutes */
+    seconds = (long long)Time_ConvertToUnix(&now) -
+              (long long)atoi(calypso->settings.sntpSettings.timezone) * SECONDS_PER_MINUTES;
+    SysTime_setUnixTime((uint64_t)seconds * 1000);
+    SSerial_printf(SerialDebug, "Time synchronized: %lu\r\n", (unsigned long)seconds);
+    return true;
+}
+
+void Device_connect_WiFi()
+{
+    driver->connectWiFi();
+
+    if (calypso->status != calypso_WLAN_connected)
     {
-        Azure_Device_displaySensorData();
+        return;
     }
-    else
+    if (!SysTime_isSynchronized())
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        Device_synchronizeTime();
+    }
+    if ((CALYPSO_POWER_POLICY != calypso_power_normal) &&
+        !Calypso_WLANSetPowerPolicy(calypso, CALYPSO_POWER_POLICY, CALYPSO_LONG_SLEEP_MS))
+    {
+        SSerial_printf(SerialDebug, "WLAN power policy not set\r\n");
     }
 }
 
-void Device_processCloudMessage()
+void Device_disconnect_WiFi()
 {
-    if (platform == KAAIOT)
-    {
-        Kaaiot_Device_processCloudMessage();
-    }
-    else if (platform == AZURE)
+    driver->disconnectWiFi();
+}
+
+void Device_reset()
+{
+    Device_invalidateBootSnapshot();
+    driver->reset();
+}
+
+void Device_WiFi_provisioning()
+{
+    /* The configuration files are uploaded through the web server */
+    Device_invalidateBootSnapshot();
+    driver->WiFiProvisioning();
+}
+
+unsigned long Device_getTelemetrySendInterval()
+{
+    return driver->getTelemetrySendInterval();
+}
+
+bool Device_isSensorsPresent()
+{
+    return driver->isSensorsPresent();
+}
+
+void Device_displayMessageWithDelay(const char *message)
+{
+    SH1107_Display(1, 0, 0, message);
+    LED_INDICATION_LONG_DELAY;
+}
+/**
+ * @brief  Initialize the deadband of all telemetry channels with the default thresholds
+ * @retval None
+ */
+void Device_initTelemetryFilter()
+{
+    Deadband_init(&telemetryDeadband[telemetryPressure], DEFAULT_PRESSURE_DEADBAND, 0);
+    Deadband_init(&telemetryDeadband[telemetryHumidity], DEFAULT_HUMIDITY_DEADBAND, 0);
+    Deadband_init(&telemetryDeadband[telemetryTemperature], DEFAULT_TEMPERATURE_DEADBAND, 0);
+    Deadband_init(&telemetryDeadband[telemetryXAcceleration], DEFAULT_ACCELERATION_DEADBAND, 0);
+    Deadband_init(&telemetryDeadband[telemetryYAcceleration], DEFAULT_ACCELERATION_DEADBAND, 0);
+    Deadband_init(&telemetryDeadband[telemetryZAcceleration], DEFAULT_ACCELERATION_DEADBAND, 0);
+#if VIBRATION_ANALYSIS
+    Deadband_init(&telemetryDeadband[telemetryVibration], DEFAULT_VIBRATION_DEADBAND, 0);
+#endif
+    telemetryHeartbeat = (unsigned long)(DEFAULT_TELEMETRY_HEARTBEAT * 1000);
+}
+
+/**
+ * @brief  Force a full report of all telemetry channels on the next publish
+ * @retval None
+ */
+void Device_resetTelemetryFilter()
+{
+    for (uint8_t channel = 0; channel < telemetryChannels; channel++)
     {
-        Azure_Device_processCloudMessage();
+        Deadband_reset(&telemetryDeadband[channel]);
     }
-    else
+}
+
+/**
+ * @brief  Collect the last sensor readings in telemetry channel order
+ * @param  values array of telemetryChannels elements
+ * @retval None
+ */
+void Device_getTelemetryValues(int32_t *values)
+{
+    values[telemetryPressure] = sensorPADS->data[padsPressure];
+    values[telemetryHumidity] = sensorHIDS->data[hidsRelHumidity];
+    values[telemetryTemperature] = sensorTIDS->data[tidsTemperature];
+    values[telemetryXAcceleration] = sensorITDS->data[itdsXAcceleration];
+    values[telemetryYAcceleration] = sensorITDS->data[itdsYAcceleration];
+    values[telemetryZAcceleration] = sensorITDS->data[itdsZAcceleration];
+#if VIBRATION_ANALYSIS
+    values[telemetryVibration] = (sensorITDS->vibration.peaks > 0) ? sensorITDS->vibration.peakAmplitude[0] : 0;
+#endif
+}
+
+/**
+ * @brief  Get the telemetry channels that have to be reported
+ * @param  values current values in telemetry channel order
+ * @retval Bit mask of the channels to report, 0 if nothing has to be published
+ */
+uint8_t Device_getTelemetryReportMask(const int32_t *values)
+{
+    uint8_t reportMask = 0;
+    unsigned long now = millis();
+
+    for (uint8_t channel = 0; channel < telemetryChannels; channel++)
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        if (Deadband_isReportDue(&telemetryDeadband[channel], values[channel], now, telemetryHeartbeat))
+        {
+            reportMask |= TELEMETRY_BIT(channel);
+        }
     }
+    return reportMask;
 }
 
-void Device_connect_WiFi()
+/**
+ * @brief  Store the telemetry values that were published
+ * @param  values published values in telemetry channel order
+ * @param  reportMask bit mask of the published channels
+ * @retval None
+ */
+void Device_commitTelemetry(const int32_t *values, uint8_t reportMask)
 {
-    if (platform == KAAIOT)
+    unsigned long now = millis();
+
+    for (uint8_t channel = 0; channel < telemetryChannels; channel++)
     {
-        Kaaiot_Device_connect_WiFi();
+        if (reportMask & TELEMETRY_BIT(channel))
+        {
+            Deadband_commit(&telemetryDeadband[channel], values[channel], now);
+        }
     }
-    else if (platform == AZURE)
+}
+
+/**
+ * @brief  Commit the values of a telemetry message once the broker has it
+ * @param  context Pending telemetry of the message
+ * @param  acked true on its PUBACK, false if it was given up
+ * @retval None
+ */
+static void Device_onTelemetryAck(void *context, bool acked)
+{
+    const Device_pendingTelemetry_t *pending = (const Device_pendingTelemetry_t *)context;
+
+    if (acked)
     {
-        Azure_Device_connect_WiFi();
+        Device_commitTelemetry(pending->values, pending->reportMask);
     }
-    else
+}
+
+/**
+ * @brief  Publish filtered telemetry with QoS 1. The values are committed to
+ *         the deadband filter on the PUBACK, a message lost is sent again at
+ *         the next interval.
+ * @param  topic MQTT topic
+ * @param  data serialized telemetry
+ * @param  values published values in telemetry channel order
+ * @param  reportMask bit mask of the published channels
+ * @retval true if Calypso accepted the message false otherwise
+ */
+bool Device_publishTelemetry(char *topic, char *data, const int32_t *values, uint8_t reportMask)
+{
+    Device_pendingTelemetry_t *pending = &pendingTelemetry[pendingTelemetryNext];
+
+    memcpy(pending->values, values, sizeof(pending->values));
+    pending->reportMask = reportMask;
+    if (!Calypso_MQTTPublishAcked(calypso, topic, 1, data, strlen(data), true, Device_onTelemetryAck, pending))
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        return false;
     }
+    pendingTelemetryNext = (pendingTelemetryNext + 1) % DEVICE_PENDING_TELEMETRY;
+    return true;
 }
 
-void Device_disconnect_WiFi()
+/**
+ * @brief  Get a numeric JSON value
+ * @param  value JSON value
+ * @param  number pointer to the number
+ * @retval true if the value is a number false otherwise
+ */
+static bool getJsonNumber(json_value *value, double *number)
 {
-    if (platform == KAAIOT)
+    if (value == NULL)
     {
-        Kaaiot_Device_disconnect_WiFi();
+        return false;
     }
-    else if (platform == AZURE)
+    if (value->type == json_integer)
     {
-        Azure_Device_disconnect_WiFi();
+        *number = (double)value->u.integer;
+        return true;
     }
-    else
+    if (value->type == json_double)
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        *number = value->u.dbl;
+        return true;
     }
+    return false;
 }
 
-void Device_reset()
+/**
+ * @brief  Get the telemetry channels controlled by a deadband property
+ * @param  name property name
+ * @param  first pointer to the first channel
+ * @param  last pointer to the last channel
+ * @retval true if the name is a deadband property false otherwise
+ */
+static bool getDeadbandChannels(const char *name, uint8_t *first, uint8_t *last)
 {
-    if (platform == KAAIOT)
+    if (0 == strcmp(name, PRESSURE_DEADBAND_PROPERTY))
+    {
+        *first = *last = telemetryPressure;
+    }
+    else if (0 == strcmp(name, HUMIDITY_DEADBAND_PROPERTY))
+    {
+        *first = *last = telemetryHumidity;
+    }
+    else if (0 == strcmp(name, TEMPERATURE_DEADBAND_PROPERTY))
     {
-        Kaaiot_Device_reset();
+        *first = *last = telemetryTemperature;
     }
-    else if (platform == AZURE)
+    else if (0 == strcmp(name, ACCELERATION_DEADBAND_PROPERTY))
     {
-        Azure_Device_reset();
+        *first = telemetryXAcceleration;
+        *last = telemetryZAcceleration;
     }
+#if VIBRATION_ANALYSIS
+    else if (0 == strcmp(name, VIBRATION_DEADBAND_PROPERTY))
+    {
+        *first = *last = telemetryVibration;
+    }
+#endif
     else
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        return false;
     }
+    return true;
 }
 
-void Device_WiFi_provisioning()
+/**
+ * @brief  Check if a property controls the telemetry filter
+ * @param  name property name
+ * @retval true if the property belongs to the telemetry filter false otherwise
+ */
+bool Device_isTelemetryFilterProperty(const char *name)
 {
-    if (platform == KAAIOT)
+    uint8_t first, last;
+
+    if (0 == strcmp(name, TELEMETRY_HEARTBEAT_PROPERTY))
     {
-        Kaaiot_Device_WiFi_provisioning();
+        return true;
     }
-    else if (platform == AZURE)
+    return getDeadbandChannels(name, &first, &last);
+}
+
+/**
+ * @brief  Set a telemetry filter property
+ *
+ * The heartbeat is a number of seconds, 0 disables it. A deadband is either a
+ * number (absolute threshold) or an object with the optional members
+ * "absolute" and "relative" (percent of the last reported value). An
+ * absolute threshold beyond the int32 range of the sensor data is invalid.
+ *
+ * @param  name property name
+ * @param  value property value
+ * @retval true if the value was applied false if it is invalid
+ */
+bool Device_setTelemetryFilterProperty(const char *name, json_value *value)
+{
+    uint8_t first, last;
+    double number;
+    double absThreshold, relThreshold;
+
+    if (0 == strcmp(name, TELEMETRY_HEARTBEAT_PROPERTY))
     {
-        Azure_Device_WiFi_provisioning();
+        if (!getJsonNumber(value, &number) || (number < 0) || (number > MAX_TELEMETRY_HEARTBEAT))
+        {
+            return false;
+        }
+        telemetryHeartbeat = (unsigned long)(number * 1000);
+        return true;
     }
-    else
+
+    if (!getDeadbandChannels(name, &first, &last))
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
+        return false;
     }
-}
 
-unsigned long Device_getTelemetrySendInterval()
-{
-    if (platform == KAAIOT)
+    absThreshold = (double)telemetryDeadband[first].absThreshold / telemetryScale[first];
+    relThreshold = (double)telemetryDeadband[first].relThreshold / 100;
+
+    if (getJsonNumber(value, &number))
     {
-        return Kaaiot_Device_getTelemetrySendInterval();
+        absThreshold = number;
     }
-    else if (platform == AZURE)
+    else if ((value != NULL) && (value->type == json_object))
     {
-        return Azure_Device_getTelemetrySendInterval();
+        for (unsigned int i = 0; i < value->u.object.length; i++)
+        {
+            if (!getJsonNumber(value->u.object.values[i].value, &number))
+            {
+                return false;
+            }
+            if (0 == strcmp(value->u.object.values[i].name, "absolute"))
+            {
+                absThreshold = number;
+            }
+            else if (0 == strcmp(value->u.object.values[i].name, "relative"))
+            {
+                relThreshold = number;
+            }
+        }
     }
     else
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
-        return 0;
+        return false;
+    }
+
+    if ((absThreshold < 0) || (relThreshold < 0) || (relThreshold > MAX_TELEMETRY_REL_DEADBAND))
+    {
+        return false;
     }
+    /*The threshold must fit in the sensor data units of every channel*/
+    for (uint8_t channel = first; channel <= last; channel++)
+    {
+        if (absThreshold * telemetryScale[channel] + 0.5 >= (double)INT32_MAX)
+        {
+            return false;
+        }
+    }
+
+    /*Convert to sensor data units and 0.01 %*/
+    for (uint8_t channel = first; channel <= last; channel++)
+    {
+        Deadband_setThresholds(&telemetryDeadband[channel],
+                               (int32_t)(absThreshold * telemetryScale[channel] + 0.5),
+                               (int32_t)(relThreshold * 100 + 0.5));
+    }
+    return true;
 }
 
-bool Device_isSensorsPresent()
+/**
+ * @brief  Get the current value of a telemetry filter property
+ * @param  name property name
+ * @retval JSON value to be freed by the caller or NULL if the name is unknown
+ */
+json_value *Device_getTelemetryFilterProperty(const char *name)
 {
-    if (platform == KAAIOT)
+    uint8_t first, last;
+
+    if (0 == strcmp(name, TELEMETRY_HEARTBEAT_PROPERTY))
     {
-        return Kaaiot_Device_isSensorsPresent();
+        return json_integer_new(telemetryHeartbeat / 1000);
     }
-    else if (platform == AZURE)
+
+    if (!getDeadbandChannels(name, &first, &last))
     {
-        return Azure_Device_isSensorsPresent();
+        return NULL;
     }
-    else
+
+    json_value *deadband = json_object_new(2);
+    if (deadband == NULL)
     {
-        SSerial_printf(SerialDebug, "Platform not specified.\r\n");
         return NULL;
     }
+    json_object_push(deadband, "absolute", json_double_new((double)telemetryDeadband[first].absThreshold / telemetryScale[first]));
+    json_object_push(deadband, "relative", json_double_new((double)telemetryDeadband[first].relThreshold / 100));
+    return deadband;
 }
 
-void Device_displayMessageWithDelay(const char *message)
+/**
+ * @brief  Apply all telemetry filter properties found in a configuration object
+ * @param  config parsed configuration file
+ * @retval None
+ */
+void Device_loadTelemetryFilterConfig(json_value *config)
 {
-    SH1107_Display(1, 0, 0, message);
-    LED_INDICATION_LONG_DELAY;
-}
\ No newline at end of file
+    if ((config == NULL) || (config->type != json_object))
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < config->u.object.length; i++)
+    {
+        const char *name = config->u.object.values[i].name;
+        if (Device_isTelemetryFilterProperty(name) &&
+            !Device_setTelemetryFilterProperty(name, config->u.object.values[i].value))
+        {
+            SSerial_printf(SerialDebug, "Invalid value for %s\r\n", name);
+        }
+    }
+}
+
+#if VIBRATION_ANALYSIS
+/**
+ * @brief  Get the last vibration spectrum summary as telemetry
+ * @retval JSON object with the spectral peaks and band RMS values in g, NULL if out of memory
+ */
+json_value *Device_getVibrationTelemetry()
+{
+    json_value *vibration = json_object_new(3);
+    json_value *frequency = json_array_new(VIBRATION_PEAKS);
+    json_value *amplitude = json_array_new(VIBRATION_PEAKS);
+    json_value *band = json_array_new(VIBRATION_BANDS);
+
+    if ((vibration == NULL) || (frequency == NULL) || (amplitude == NULL) || (band == NULL))
+    {
+        json_builder_free(vibration);
+        json_builder_free(frequency);
+        json_builder_free(amplitude);
+        json_builder_free(band);
+        return NULL;
+    }
+
+    for (uint8_t i = 0; i < sensorITDS->vibration.peaks; i++)
+    {
+        json_array_push(frequency, json_integer_new(sensorITDS->vibration.peakFrequency[i]));
+        json_array_push(amplitude, json_double_new((double)sensorITDS->vibration.peakAmplitude[i] / ITDS_ACCELERATION_SCALE));
+    }
+    for (uint8_t i = 0; i < VIBRATION_BANDS; i++)
+    {
+        json_array_push(band, json_double_new((double)sensorITDS->vibration.bandRms[i] / ITDS_ACCELERATION_SCALE));
+    }
+
+    /*Freed together with the object*/
+    json_object_push(vibration, "peakFrequency", frequency);
+    json_object_push(vibration, "peakAmplitude", amplitude);
+    json_object_push(vibration, "bandRms", band);
+    return vibration;
+}
+#endif
@@ -23,14 +23,24 @@
  */
 
 #ifndef P_N_P_COMMON_DEVICE_H
-#define P_N_P_COMMON__DEVICE_H
+#define P_N_P_COMMON_DEVICE_H
 
 /**         Includes         */
 
 #include <stdint.h>
 #include "calypsoBoard.h"
+#include "calypsoConfig.h"
+#include "calypsoLink.h"
+#include "checksum.h"
 #include "ConfigPlatform.h"
+#include "deadband.h"
+#include "debuglog.h"
+#include "displayBoard.h"
+#include "idle.h"
+#include "json-builder.h"
+#include "scheduler.h"
 #include "sensorBoard.h"
+#include "systime.h"
 
 /**         Functions definition         */
 
@@ -45,89 +55,33 @@ extern "C"
 #define PLATFORM_HTML_FILE_PATH "/www/platform.html"
 #define PLATFORM_JS_FILE_PATH "/www/js/platform.js"
 #define PLATFORM_CONFIG_FILE_PATH "user/platform.json"
+#define BOOT_SNAPSHOT_FILE_PATH "user/bootsnapshot"
+#define WEB_MANIFEST_FILE_PATH "user/webmanifest"
 
-#define INDEX_HTML_SRC_FILE "<!doctypehtml><meta content=\"text/html; charset=utf-8\"http-equiv=Content-Type><meta content=\"width=device-width,initial-scale=1\"name=viewport><title>Wuerth Elektronik eiSos Calypso</title><link href=css/bootstrap.min.css rel=stylesheet><link href=css/style.css rel=stylesheet><script src=js/jquery-3.6.0.min.js></script><script src=js/general.js></script><div class=wrapper><div class=header id=main><div class=headerIn onclick=openNav()><div class=row><div class=\"col-md-3 menuTop\"></div><div class=col-md-9><h1>Calypso WLAN module</h1></div></div></div></div><div class=sidebar id=mySidebar onmouseleave=closeNav()><a href=javascript:void(0); onclick=closeNav() class=closebtn>×</a> <a href=javascript:void(0); onclick='openNavElement(\"baseFrame\")'>Home</a> <a href=javascript:void(0); onclick='openNavElement(\"settingsFrame\")'>Settings</a> <a href=javascript:void(0); onclick='openNavElement(\"otaFrame\")'>OTA</a> <a href=javascript:void(0); onclick='openNavElement(\"gpioFrame\")'>GPIO</a> <a href=javascript:void(0); onclick='openNavElement(\"userFrame\")'>User settings</a> <a href=javascript:void(0); onclick='openNavElement(\"customFrame\")'>Custom</a> <a href=javascript:void(0); onclick='openNavElement(\"fileFrame\")'>File upload</a> <a href=javascript:void(0); onclick='openNavElement(\"azureFrame\")'>Azure</a> <a href=javascript:void(0); onclick='openNavElement(\"kaaiotFrame\")'>KaaIoT</a> <a href=javascript:void(0); onclick='openNavElement(\"helpFrame\")'>About</a></div><div class=contentSplash><div class=frame id=baseFrame style=display:block><iframe data-src=base.html id=ibaseFrame src=base.html></iframe></div><div class=frame id=otaFrame><iframe data-src=ota.html id=iotaFrame></iframe></div><div class=frame id=settingsFrame><iframe data-src=settings.html id=isettingsFrame></iframe></div><div class=frame id=gpioFrame><iframe data-src=gpio.html id=igpioFrame></iframe></div><div class=frame id=userFrame><iframe data-src=usersettings.html id=iuserFrame></iframe></div><div class=frame id=customFrame><iframe data-src=custom.html id=icustomFrame></iframe></div><div class=frame id=fileFrame><iframe data-src=file.html id=ifileFrame></iframe></div><div class=frame id=azureFrame><iframe data-src=azure.html id=iazureFrame></iframe></div><div class=frame id=kaaiotFrame><iframe data-src=kaaiot.html id=ikaaiotFrame></iframe></div><div class=frame id=helpFrame><iframe data-src=help.html id=ihelpFrame></iframe></div><br></div></div>"
-
-#define INDEX_HTML_FILE "<!DOCTYPE HTML>\
-<html>\
-\
-<head>\
-    <meta http-equiv=\"Content-Type\" content=\"text/html; charset=utf-8\">\
-    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1\">\
-    <title>Wuerth Elektronik eiSos Calypso</title>\
-    <link rel=\"stylesheet\" type=\"text/css\" href=\"css/bootstrap.min.css\">\
-    <link rel=\"stylesheet\" type=\"text/css\" href=\"css/style.css\">\
-    <script type=\"text/javascript\" src=\"js/jquery-3.6.0.min.js\"></script>\
-    <script type=\"text/javascript\" src=\"js/general.js\"></script>\
-</head>\
-\
-<body>\
-    <div class=\"wrapper\">\
-        <div class=\"header\" id=\"main\">\
-            <div class=\"headerIn\" onclick=\"openNav()\">\
-                <div class=\"row\">\
-                    <div class=\"col-md-3 menuTop\"></div>\
-                    <div class=\"col-md-9\">\
-                        <h1>Calypso WLAN module</h1>\
-                    </div>\
-                </div>\
-            </div>\
-        </div>\
-\
-        <div id=\"mySidebar\" class=\"sidebar\" onmouseleave=\"closeNav()\">\
-\
-            <a href=\"javascript:void(0);\" class=\"closebtn\" onclick=\"closeNav()\">×</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('baseFrame')\">Home</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('settingsFrame')\">Settings</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('otaFrame')\">OTA</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('gpioFrame')\">GPIO</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('userFrame')\">User settings</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('customFrame')\">Custom</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('fileFrame')\">File upload</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('azureFrame')\">Azure</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('kaaiotFrame')\">KaaIoT</a>\
-            <a href=\"javascript:void(0);\" onclick=\"openNavElement('helpFrame')\">About</a>\
-          </div>\
-\
-        <div class=\"contentSplash\">\
-            <div class=\"frame\" id=\"baseFrame\" style=\"display: block;\">\
-                <iframe id=\"ibaseFrame\" src=\"base.html\" data-src=\"base.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"otaFrame\">\
-                <iframe id=\"iotaFrame\" data-src=\"ota.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"settingsFrame\">\
-                <iframe id=\"isettingsFrame\" data-src=\"settings.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"gpioFrame\">\
-                <iframe id=\"igpioFrame\" data-src=\"gpio.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"userFrame\">\
-                <iframe id=\"iuserFrame\" data-src=\"usersettings.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"customFrame\">\
-                <iframe id=\"icustomFrame\" data-src=\"custom.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"fileFrame\">\
-                <iframe id=\"ifileFrame\" data-src=\"file.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"azureFrame\">\
-                <iframe id=\"iazureFrame\" data-src=\"azure.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"kaaiotFrame\">\
-                <iframe id=\"ikaaiotFrame\" data-src=\"kaaiot.html\"></iframe>\
-            </div>\
-            <div class=\"frame\" id=\"helpFrame\">\
-                <iframe id=\"ihelpFrame\" data-src=\"help.html\"></iframe>\
-            </div>\
-            <br>\
-        </div>\
-    </div>\
-</body>\
-</html>"
-
-#define LED_INDICATION_SHORT_DELAY delay(1000)
-#define LED_INDICATION_LONG_DELAY delay(5000)
+/*Boot snapshot: version,platform,config hash,web files hash,Calypso firmware,check*/
+#define BOOT_SNAPSHOT_VERSION 1
+#define BOOT_SNAPSHOT_MAX_LEN 64
+
+/*Web asset manifest: one hash,length,path line per web file written from the firmware*/
+#define WEB_MANIFEST_MAX_LEN 256
+#define WEB_MANIFEST_ENTRY_LEN 64
+
+/*Longest boot of Calypso after power-on, it is already running after a reset of the MCU alone*/
+#define CALYPSO_STARTUP_TIMEOUT 9000
+
+/* The display is updated in the background, show the message before blocking */
+#define LED_INDICATION_SHORT_DELAY \
+    do                             \
+    {                              \
+        SH1107_Flush();            \
+        delay(1000);               \
+    } while (0)
+#define LED_INDICATION_LONG_DELAY \
+    do                            \
+    {                             \
+        SH1107_Flush();           \
+        delay(5000);              \
+    } while (0)
 
 #define BUTTON_A (byte)9
 #define BUTTON_B (byte)6
@@ -137,23 +91,151 @@ extern "C"
 #define DEVICE_CREDENTIALS_MAX_LEN 48
 #define AWS_ENDPOINT_MAX_LEN 128
 
+/*Report-by-exception telemetry*/
+#define DEFAULT_TELEMETRY_HEARTBEAT 300 // seconds
+#define MAX_TELEMETRY_HEARTBEAT 86400   // seconds
+#define MAX_TELEMETRY_REL_DEADBAND 100  // percent
+
+/*Default deadbands in sensor data units*/
+#define DEFAULT_PRESSURE_DEADBAND 50     // Pa
+#define DEFAULT_HUMIDITY_DEADBAND 100    // 0.01 %RH
+#define DEFAULT_TEMPERATURE_DEADBAND 20  // 0.01 degC
+#define DEFAULT_ACCELERATION_DEADBAND 50 // mg
+#define DEFAULT_VIBRATION_DEADBAND 20    // mg
+
+#define TELEMETRY_HEARTBEAT_PROPERTY "telemetryHeartbeat"
+#define PRESSURE_DEADBAND_PROPERTY "pressureDeadband"
+#define HUMIDITY_DEADBAND_PROPERTY "humidityDeadband"
+#define TEMPERATURE_DEADBAND_PROPERTY "temperatureDeadband"
+#define ACCELERATION_DEADBAND_PROPERTY "accelerationDeadband"
+#define VIBRATION_DEADBAND_PROPERTY "vibrationDeadband"
+
+#define TELEMETRY_BIT(channel) (1U << (channel))
+
+/*Motion events*/
+#define MOTION_EVENT_MIN_INTERVAL 1000 // ms between two messages of the same event
+#define MOTION_EVENT_PROPERTY "motionEvent"
+#define MOTION_EVENT_COUNT_PROPERTY "count"
+
+/*Timestamps*/
+#define TIMESTAMP_PROPERTY "timestamp"   // ms since 1970-01-01 UTC
+#define TIME_SYNC_MIN_YEAR 2022          // Calypso time is older before the SNTP update
+
+/*WLAN power policy set after the connection, normal is the Calypso default*/
+#ifndef CALYPSO_POWER_POLICY
+#define CALYPSO_POWER_POLICY calypso_power_normal
+#endif
+#define CALYPSO_LONG_SLEEP_MS 1000 // Longest sleep of calypso_power_long_sleep, delays the cloud messages
+
+/*MQTT QoS: the battery voltage is sent again at the next interval, properties, events and command responses must
+  arrive. Telemetry goes with QoS 1 as the deadband filter only commits the values the broker acknowledged.*/
+#define TELEMETRY_QOS ATMQTT_QOS_QOS0
+#define MESSAGE_QOS ATMQTT_QOS_QOS1
+
+/*Platforms built into the firmware, build with -D PNP_PLATFORM_<name>=0 to leave one out*/
+#ifndef PNP_PLATFORM_AZURE
+#define PNP_PLATFORM_AZURE 1
+#endif
+#ifndef PNP_PLATFORM_KAAIOT
+#define PNP_PLATFORM_KAAIOT 1
+#endif
+#if !PNP_PLATFORM_AZURE && !PNP_PLATFORM_KAAIOT
+#error "At least one IoT platform must be built in"
+#endif
+
+/*Platform written to the platform file when it is missing*/
+#ifndef PNP_DEFAULT_PLATFORM
+#if PNP_PLATFORM_KAAIOT
+#define PNP_DEFAULT_PLATFORM KAAIOT
+#else
+#define PNP_DEFAULT_PLATFORM AZURE
+#endif
+#endif
+
+/*Platform drivers registered at once, the built-in ones included*/
+#define DEVICE_PLATFORMS_MAX 4
+
     typedef enum
     {
         AZURE,
         KAAIOT
     } IoT_platforms_t;
 
+    typedef enum
+    {
+        telemetryPressure,
+        telemetryHumidity,
+        telemetryTemperature,
+        telemetryXAcceleration,
+        telemetryYAcceleration,
+        telemetryZAcceleration,
+#if VIBRATION_ANALYSIS
+        telemetryVibration, /* Amplitude of the dominant spectral peak */
+#endif
+        telemetryChannels
+    } Telemetry_channels_t;
+
+    /* Functions of an IoT platform, the Device_* functions call the driver
+     * selected at init. Optional functions are NULL. */
+    typedef struct
+    {
+        IoT_platforms_t id;
+        const char *name;        /* In the platform file */
+        const char *displayName; /* On the display */
+        TypeSerial *(*init)(void *Debug, void *CalypsoSerial);
+        bool (*configurationComplete)();
+        void (*deletePreviousConfig)(); /* Optional */
+        void (*writeConfigFiles)();
+        uint32_t (*getConfigHash)();
+        bool (*isConfigured)();
+        void (*configurationInProgress)();
+        bool (*isConnectedToWiFi)();
+        bool (*isUpToDate)();
+        bool (*isStatusOK)();
+        void (*readSensors)();
+        void (*MQTTConnect)();
+        bool (*subscribeToTopics)();
+        void (*publishSensorData)();
+        bool (*publishMotionEvent)(const char *event, uint16_t count);
+        void (*displaySensorData)();
+        void (*processCloudMessage)();
+        void (*connectWiFi)();
+        void (*disconnectWiFi)();
+        void (*WiFiProvisioning)();
+        void (*reset)();
+        void (*restart)();
+        unsigned long (*getTelemetrySendInterval)();
+        bool (*isSensorsPresent)();
+    } Device_Platform_t;
+
+#if PNP_PLATFORM_AZURE
+    extern const Device_Platform_t Azure_Device_platform;
+#endif
+#if PNP_PLATFORM_KAAIOT
+    extern const Device_Platform_t Kaaiot_Device_platform;
+#endif
+
     extern const char *configuration;
 
     IoT_platforms_t getPlatform();
 
+    bool Device_registerPlatform(const Device_Platform_t *driver);
+    const Device_Platform_t *Device_findPlatform(IoT_platforms_t id);
+    bool Device_selectPlatform(IoT_platforms_t id);
+    const Device_Platform_t *Device_getPlatformDriver();
+    const Device_Platform_t *Device_getNextPlatform();
+
     TypeSerial *Device_init(void *Debug, void *CalypsoSerial);
     void deadLoop();
     void Device_deletePreviousConfigIfExist();
-    bool Device_writeConfigFile(const char *path, const char *data);
+    bool Device_savePlatformId(IoT_platforms_t id);
     void Device_writeConfigFiles();
     bool Device_loadPlatformId();
     bool Device_isIotPlatformConfigured();
+    bool Device_isBootSnapshotValid();
+    void Device_saveBootSnapshot();
+    void Device_invalidateBootSnapshot();
+    void Device_configChanged(CalypsoConfig_t *config, const char *key);
     bool Device_isConfigured();
     bool Device_isConnectedToWiFi();
     void Device_MQTTConnect();
@@ -169,12 +251,37 @@ extern "C"
     void Device_restart();
     bool Device_isStatusOK();
     void Device_processCloudMessage();
+    bool Device_isCloudMessagePending();
+    void Device_pollPublisher();
+    void Device_openLink();
+    bool Device_isLinkUp();
+    bool Device_recoverLink(unsigned long *retryMs);
+    void Device_printLinkStats(TypeSerial *serial);
+    void Device_resetLinkStats();
     bool Device_ConfigurationComplete();
     void Device_displaySensorData();
     bool Device_isUpToDate();
     unsigned long Device_getTelemetrySendInterval();
     bool Device_isSensorsPresent();
     void Device_displayMessageWithDelay(const char *message);
+
+    void Device_initTelemetryFilter();
+    void Device_resetTelemetryFilter();
+    void Device_getTelemetryValues(int32_t *values);
+    uint8_t Device_getTelemetryReportMask(const int32_t *values);
+    void Device_commitTelemetry(const int32_t *values, uint8_t reportMask);
+    bool Device_publishTelemetry(char *topic, char *data, const int32_t *values, uint8_t reportMask);
+    bool Device_isTelemetryFilterProperty(const char *name);
+    bool Device_setTelemetryFilterProperty(const char *name, json_value *value);
+    json_value *Device_getTelemetryFilterProperty(const char *name);
+    void Device_loadTelemetryFilterConfig(json_value *config);
+#if VIBRATION_ANALYSIS
+    json_value *Device_getVibrationTelemetry();
+#endif
+
+    void Device_processMotionEvents();
+    void Device_processSensorFifo();
+    bool Device_PublishMotionEvent(const char *event, uint16_t count);
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,9 @@
 #include "PnP_Common_Device.h"
 #include "PnP_Device_Azure.h"
 #include "time.h"
+#include "topicrouter.h"
+
+#if PNP_PLATFORM_AZURE
 
 #define MAX_PACKET_LOSS 3
 
@@ -75,6 +78,7 @@ static char displayText[128];
 extern char pubtopic[128];
 #define MAX_PAYLOAD_LENGTH 1024
 static char sensorPayload[MAX_PAYLOAD_LENGTH];
+static TopicRouter_t topicRouter;
 
 // Certificates
 const char *rootCACert = BALTIMORE_CYBERTRUST_ROOT_CERT;
@@ -84,16 +88,22 @@ const char *deviceCert = DEVICE_CERT;
 const char *deviceKey = DEVICE_KEY;
 const char *configuration = CONFIGURATION_DATA_2;
 
+// Device configuration
+static CalypsoConfig_t azureConfig = CALYPSO_CONFIG_INIT(CONFIG_FILE_PATH, Device_configChanged);
+
 static bool Device_loadConfiguration();
-static char *Device_SerializeData();
+static char *Device_SerializeData(uint8_t reportMask);
+static void Device_setTelemetryTopic(uint64_t timestamp);
+static char *Device_SerializeMotionEvent(const char *event, uint16_t count);
 static char *Device_SerializeVoltageData(float voltage);
 static char *Device_SerializeSendInterval(uint16_t val, uint16_t ac, uint16_t av, char *ad);
+static char *Device_SerializeFilterProperty(const char *name, uint16_t ac, uint16_t av, char *ad);
 
 static bool Device_PublishRegReq();
 static char *Device_SerializeProvReq();
 static bool Device_PublishProvStatusReq(char *operationID);
 
-static json_value *Device_GetCloudResponse();
+static json_value *Device_GetCloudResponse(unsigned long waitMs);
 static void removeChar(char *s, char c);
 static void Device_PublishVoltage();
 static void Device_PublishMACAddress();
@@ -101,7 +111,13 @@ static void Device_PublishUDID();
 static void Device_PublishSWVersion();
 
 static void Device_PublishSendInterval(uint16_t val, uint16_t ac, uint16_t av, char *ad);
+static void Device_PublishFilterProperty(const char *name, uint16_t ac, uint16_t av, char *ad);
+static void Device_updateSendInterval(unsigned long desiredVal, uint16_t version);
+static void Device_updateDesiredProperties(json_value *desired, bool initial);
 static void Device_PublishDirectCmdResponse(int status, int requestID);
+static void Device_initTopicRouter();
+static bool Device_startWiFi();
+static void Device_waitForWiFi();
 /**
  * @brief  Initialize all components of a device
  * @param  Debug Debug port
@@ -110,7 +126,13 @@ static void Device_PublishDirectCmdResponse(int status, int requestID);
  */
 TypeSerial *Azure_Device_init(void *Debug, void *CalypsoSerial)
 {
-    Azure_Device_writeConfigFiles();
+    bool wifiStarted = false;
+
+    Device_initTopicRouter();
+    if (!Device_isBootSnapshotValid())
+    {
+        Azure_Device_writeConfigFiles();
+    }
     sprintf(displayText, "Loading configuration...");
     SH1107_Display(1, 0, 24, displayText);
     if (Device_loadConfiguration() == true)
@@ -118,16 +140,17 @@ TypeSerial *Azure_Device_init(void *Debug, void *CalypsoSerial)
         deviceConfigured = true;
         sprintf(displayText, "Connecting to Wi-Fi..");
         SH1107_Display(1, 0, 24, displayText);
-        Azure_Device_connect_WiFi();
+        wifiStarted = Device_startWiFi();
     }
     else
     {
         SSerial_printf(SerialDebug, "Loading config file failed\r\n");
     }
 
-    if (Calypso_fileExists(calypso, DEVICE_IOT_HUB_ADDRESS))
+    /* Read while Calypso associates with the access point, the read finds
+     * a missing file */
+    if (Calypso_readFile(calypso, DEVICE_IOT_HUB_ADDRESS, (char *)iotHubAddress, MAX_URL_LEN, &iotHubAddrLen))
     {
-        Calypso_readFile(calypso, DEVICE_IOT_HUB_ADDRESS, (char *)iotHubAddress, MAX_URL_LEN, &iotHubAddrLen);
         deviceProvisioned = true;
     }
     else
@@ -136,9 +159,29 @@ TypeSerial *Azure_Device_init(void *Debug, void *CalypsoSerial)
         memset(iotHubAddress, 0, MAX_URL_LEN);
         iotHubAddrLen = MAX_URL_LEN;
     }
+
+    if (wifiStarted)
+    {
+        Device_waitForWiFi();
+    }
     return SerialDebug;
 }
 
+/**
+ * @brief  Hash of the certificates and the configuration written by
+ *         Azure_Device_writeConfigFiles
+ * @retval FNV-1a hash
+ */
+uint32_t Azure_Device_getConfigHash()
+{
+    uint32_t hash = Checksum_fnv1aString(CHECKSUM_FNV1A_INIT, rootCACert);
+
+    hash = Checksum_fnv1aString(hash, rootCACert1);
+    hash = Checksum_fnv1aString(hash, deviceCert);
+    hash = Checksum_fnv1aString(hash, deviceKey);
+    return Checksum_fnv1aString(hash, configuration);
+}
+
 /**
  * @brief Function to run on completion of device configuration
  *
@@ -163,9 +206,8 @@ bool Azure_Device_ConfigurationComplete()
         return false;
     }
 
-    if (Calypso_fileExists(calypso, DEVICE_IOT_HUB_ADDRESS))
+    if (Calypso_readFile(calypso, DEVICE_IOT_HUB_ADDRESS, (char *)iotHubAddress, MAX_URL_LEN, &iotHubAddrLen))
     {
-        Calypso_readFile(calypso, DEVICE_IOT_HUB_ADDRESS, (char *)iotHubAddress, MAX_URL_LEN, &iotHubAddrLen);
         deviceProvisioned = true;
     }
     return deviceConfigured;
@@ -179,55 +221,45 @@ bool Azure_Device_ConfigurationComplete()
  */
 static bool Device_loadConfiguration()
 {
-    char configBuf[512];
-    uint16_t len;
-    if (!Calypso_fileExists(calypso, CONFIG_FILE_PATH))
-    {
-        return false;
-    }
+    long version;
+
     SSerial_printf(SerialDebug, "Load Config File\r\n");
-    if (Calypso_readFile(calypso, CONFIG_FILE_PATH, (char *)configBuf, 512, &len))
+    if (!CalypsoConfig_load(&azureConfig, calypso))
     {
-        json_value *configuration = json_parse(configBuf, len);
-        if (configuration == NULL)
+        if (CalypsoConfig_exists(&azureConfig))
         {
             SSerial_printf(SerialDebug, "Unable to parse config file\r\n");
-            return false;
-        }
-        if (AZURE_IOT_PNP_CONFIG_VERSION == configuration->u.object.values[0].value->u.integer)
-        {
-            modeOfOperation = AZURE_IOT_PNP_CONFIG_VERSION;
-            SSerial_printf(SerialDebug, "Loading Azure Config\r\n");
-            strcpy(kitID, configuration->u.object.values[1].value->u.string.ptr);
-            strcpy(scopeID, configuration->u.object.values[2].value->u.string.ptr);
-            strcpy(dpsServerAddress, configuration->u.object.values[3].value->u.string.ptr);
-            strcpy(modelID, configuration->u.object.values[4].value->u.string.ptr);
-            strcpy(calypso->settings.sntpSettings.server, configuration->u.object.values[5].value->u.string.ptr);
-            strcpy(calypso->settings.sntpSettings.timezone, configuration->u.object.values[6].value->u.string.ptr);
-            strcpy(calypso->settings.wifiSettings.SSID, configuration->u.object.values[7].value->u.string.ptr);
-            strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configuration->u.object.values[8].value->u.string.ptr);
-            calypso->settings.wifiSettings.securityParams.securityType = configuration->u.object.values[9].value->u.integer;
-        }
-
-        if (AWS_CONFIG_VERSION == configuration->u.object.values[0].value->u.integer)
-        {
-            modeOfOperation = AWS_CONFIG_VERSION;
-            SSerial_printf(SerialDebug, "Loading Web Service Config\r\n");
-            strcpy(kitID, configuration->u.object.values[1].value->u.string.ptr);
-            strcpy(awsendpoint, configuration->u.object.values[2].value->u.string.ptr);
-            strcpy(calypso->settings.sntpSettings.server, configuration->u.object.values[3].value->u.string.ptr);
-            strcpy(calypso->settings.sntpSettings.timezone, configuration->u.object.values[4].value->u.string.ptr);
-            strcpy(calypso->settings.wifiSettings.SSID, configuration->u.object.values[5].value->u.string.ptr);
-            strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configuration->u.object.values[6].value->u.string.ptr);
-            calypso->settings.wifiSettings.securityParams.securityType = configuration->u.object.values[7].value->u.integer;
         }
+        return false;
+    }
 
-        else
-        {
-            SSerial_printf(SerialDebug, "Wrong config file version\r\n");
-            return false;
-        }
+    version = CalypsoConfig_getInt(&azureConfig, "version", 0);
+    if (AZURE_IOT_PNP_CONFIG_VERSION == version)
+    {
+        modeOfOperation = AZURE_IOT_PNP_CONFIG_VERSION;
+        SSerial_printf(SerialDebug, "Loading Azure Config\r\n");
+        strcpy(kitID, CalypsoConfig_getString(&azureConfig, "deviceId", ""));
+        strcpy(scopeID, CalypsoConfig_getString(&azureConfig, "scopeId", ""));
+        strcpy(dpsServerAddress, CalypsoConfig_getString(&azureConfig, "DPSServer", ""));
+        strcpy(modelID, CalypsoConfig_getString(&azureConfig, "modelId", ""));
     }
+    else if (AWS_CONFIG_VERSION == version)
+    {
+        modeOfOperation = AWS_CONFIG_VERSION;
+        SSerial_printf(SerialDebug, "Loading Web Service Config\r\n");
+        strcpy(kitID, CalypsoConfig_getString(&azureConfig, "deviceId", ""));
+        strcpy(awsendpoint, CalypsoConfig_getString(&azureConfig, "awsendpoint", ""));
+    }
+    else
+    {
+        SSerial_printf(SerialDebug, "Wrong config file version\r\n");
+        return false;
+    }
+    strcpy(calypso->settings.sntpSettings.server, CalypsoConfig_getString(&azureConfig, "SNTPServer", ""));
+    strcpy(calypso->settings.sntpSettings.timezone, CalypsoConfig_getString(&azureConfig, "timezone", ""));
+    strcpy(calypso->settings.wifiSettings.SSID, CalypsoConfig_getString(&azureConfig, "WiFiSSID", ""));
+    strcpy(calypso->settings.wifiSettings.securityParams.securityKey, CalypsoConfig_getString(&azureConfig, "WiFiPassword", ""));
+    calypso->settings.wifiSettings.securityParams.securityType = CalypsoConfig_getInt(&azureConfig, "WiFiSecurity", 0);
 
     // MQTT Settings
     calypso->settings.mqttSettings.flags = ATMQTT_CREATE_FLAGS_URL | ATMQTT_CREATE_FLAGS_SEC;
@@ -269,7 +301,8 @@ void Azure_Device_writeConfigFiles()
     {
         SSerial_printf(SerialDebug, "Unable to write device key\r\n");
     }
-    if (!Calypso_writeFile(calypso, CONFIG_FILE_PATH, configuration, strlen(configuration)))
+    /* Written only if it differs from the file loaded, then kept in RAM */
+    if (!CalypsoConfig_replace(&azureConfig, configuration) || !CalypsoConfig_commit(&azureConfig, calypso))
     {
         SSerial_printf(SerialDebug, "Unable to configuration data\r\n");
     }
@@ -281,6 +314,7 @@ void Azure_Device_writeConfigFiles()
  */
 void Azure_Device_restart()
 {
+    DebugLog_flush();
     soft_reset();
 }
 
@@ -428,7 +462,7 @@ bool Azure_Device_provision()
 
             if (Device_PublishRegReq())
             {
-                json_value *provResponse = Device_GetCloudResponse();
+                json_value *provResponse = Device_GetCloudResponse(EVENT_WAIT_TIME);
                 bool provDone = false;
                 if (provResponse != NULL)
                 {
@@ -450,7 +484,7 @@ bool Azure_Device_provision()
                         }
 
                         Device_PublishProvStatusReq(provResponse->u.object.values[0].value->u.string.ptr);
-                        json_value *provResponse = Device_GetCloudResponse();
+                        json_value *provResponse = Device_GetCloudResponse(EVENT_WAIT_TIME);
                         SSerial_printf(SerialDebug, "%s\r\n", provResponse->u.object.values[1].value->u.string.ptr);
                         strtok(calypso->topicName.data, equals);
                         strtok(NULL, equals);
@@ -562,6 +596,13 @@ void Azure_Device_readSensors()
         SSerial_printf(SerialDebug, "Error reading acceleration data\r\n");
     }
 
+#if VIBRATION_ANALYSIS
+    if (!ITDS_readVibration(sensorITDS))
+    {
+        SSerial_printf(SerialDebug, "Error reading vibration data\r\n");
+    }
+#endif
+
     if (!TIDS_readSensorData(sensorTIDS))
     {
         SSerial_printf(SerialDebug, "Error reading temperature data\r\n");
@@ -692,7 +733,7 @@ static bool Device_PublishRegReq()
 
     char *provReq = Device_SerializeProvReq();
 
-    if (!Calypso_MQTTPublishData(calypso, provReqTopic, 1, provReq, strlen(provReq), true))
+    if (!Calypso_MQTTPublishData(calypso, provReqTopic, MESSAGE_QOS, 1, provReq, strlen(provReq), true))
     {
         ret = false;
         SSerial_printf(SerialDebug, "Provision Publish failed\n\r");
@@ -718,7 +759,7 @@ static bool Device_PublishProvStatusReq(char *operationID)
     reqID++;
     sprintf(provStatusTopic, "%s%u&operationId=%s", PROVISIONING_STATUS_REQ_TOPIC, reqID, operationID);
 
-    if (!Calypso_MQTTPublishData(calypso, provStatusTopic, 1, payload, 0, true))
+    if (!Calypso_MQTTPublishData(calypso, provStatusTopic, MESSAGE_QOS, 1, payload, 0, true))
     {
         ret = false;
         SSerial_printf(SerialDebug, "Provision Publish failed\n\r");
@@ -731,13 +772,14 @@ static bool Device_PublishProvStatusReq(char *operationID)
 }
 
 /**
- * @brief  Wait for response from the cloud
+ * @brief  Get the next message from the cloud
+ * @param  waitMs Longest wait for a message, 0 to only take a queued one
  * @retval JSON message or NULL
  */
-static json_value *Device_GetCloudResponse()
+static json_value *Device_GetCloudResponse(unsigned long waitMs)
 {
     json_value *response = NULL;
-    if ((Calypso_MQTTgetMessage(calypso, true)) && (calypso->bufferCalypso.length > 4))
+    if ((Calypso_MQTTwaitMessage(calypso, true, waitMs)) && (calypso->bufferCalypso.length > 4))
     {
         response = json_parse(calypso->bufferCalypso.data, calypso->bufferCalypso.length);
         memset(calypso->bufferCalypso.data, 0, CALYPSO_LINE_MAX_SIZE);
@@ -750,21 +792,65 @@ static json_value *Device_GetCloudResponse()
     return response;
 }
 
+/**
+ * @brief  Write the telemetry topic to pubtopic. The time of the reading is
+ *         passed as the creation time of the message.
+ * @param  timestamp time of the reading in ms since 1970, 0 if unknown
+ * @retval None
+ */
+static void Device_setTelemetryTopic(uint64_t timestamp)
+{
+    Timestamp time;
+    int length = snprintf(pubtopic, sizeof(pubtopic), "devices/%s/messages/events/", kitID);
+    int propertyLength;
+
+    if ((timestamp == 0) || (length < 0) || (length >= (int)sizeof(pubtopic)))
+    {
+        return;
+    }
+    Time_ConvertFromUnix(timestamp / 1000, &time);
+    /* URL encoded property bag, ':' is %3A */
+    propertyLength = snprintf(&pubtopic[length], sizeof(pubtopic) - length,
+                              "iothub-creation-time-utc=%04u-%02u-%02uT%02u%%3A%02u%%3A%02u.%03uZ",
+                              time.year, time.month, time.day, time.hour, time.minute, time.second,
+                              (unsigned int)(timestamp % 1000));
+    if ((propertyLength < 0) || (propertyLength >= (int)sizeof(pubtopic) - length))
+    {
+        /* Does not fit, publish without the creation time */
+        pubtopic[length] = '\0';
+    }
+}
+
 /**
  * @brief  Publish the values of sensors connected to the device
  * @retval None
  */
 void Azure_Device_PublishSensorData()
 {
+    int32_t values[telemetryChannels];
+    uint8_t reportMask;
+    uint64_t timestamp;
+
     Azure_Device_readSensors();
-    char *dataSerialized = Device_SerializeData();
+    timestamp = SysTime_unixMillis();
+    Device_getTelemetryValues(values);
+    reportMask = Device_getTelemetryReportMask(values);
+    if (reportMask == 0)
+    {
+        /*Nothing changed beyond the deadband and the heartbeat is not due*/
+        return;
+    }
+    char *dataSerialized = Device_SerializeData(reportMask);
+    if (dataSerialized == NULL)
+    {
+        return;
+    }
 #if SERIAL_DEBUG
     // SSerial_writeB(SerialDebug, dataSerialized, strlen(dataSerialized));
     // SSerial_printf(SerialDebug, "\r\n");
 #endif
-    pubtopic[0] = '\0';
-    sprintf(pubtopic, "devices/%s/messages/events/", kitID);
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, dataSerialized, strlen(dataSerialized), true))
+    Device_setTelemetryTopic(timestamp);
+    if (!Device_publishTelemetry(pubtopic, dataSerialized, values, reportMask))
     {
         packetLost++;
         SSerial_printf(SerialDebug, "Publish failed %u\r\n", packetLost);
@@ -775,6 +861,29 @@ void Azure_Device_PublishSensorData()
     }
 }
 
+/**
+ * @brief  Publish a motion event detected by the accelerometer
+ * @param  event name of the event
+ * @param  count number of detections since the last message of this event
+ * @retval true if successful false otherwise
+ */
+bool Azure_Device_PublishMotionEvent(const char *event, uint16_t count)
+{
+    char *dataSerialized = Device_SerializeMotionEvent(event, count);
+    if (dataSerialized == NULL)
+    {
+        return false;
+    }
+    pubtopic[0] = '\0';
+    sprintf(pubtopic, "devices/%s/messages/events/", kitID);
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, dataSerialized, strlen(dataSerialized), true))
+    {
+        SSerial_printf(SerialDebug, "Motion event publish failed\r\n");
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief  Display sensor data on OLED display
  * @retval None
@@ -782,12 +891,12 @@ void Azure_Device_PublishSensorData()
 void Azure_Device_displaySensorData()
 {
     sprintf(displayText, "Status: Connected\r\nP:%0.2f kPa\r\nT:%0.2f C\r\nRH:%0.2f %%\r\nAcc: x:%0.2f g\r\n     y:%0.2f g\r\n     z:%0.2f g",
-            sensorPADS->data[0],
-            sensorTIDS->data[0],
-            sensorHIDS->data[0],
-            sensorITDS->data[0],
-            sensorITDS->data[1],
-            sensorITDS->data[2]);
+            (float)sensorPADS->data[0] / PADS_PRESSURE_SCALE,
+            (float)sensorTIDS->data[0] / TIDS_TEMPERATURE_SCALE,
+            (float)sensorHIDS->data[0] / HIDS_HUMIDITY_SCALE,
+            (float)sensorITDS->data[0] / ITDS_ACCELERATION_SCALE,
+            (float)sensorITDS->data[1] / ITDS_ACCELERATION_SCALE,
+            (float)sensorITDS->data[2] / ITDS_ACCELERATION_SCALE);
     SH1107_Display(1, 0, 0, displayText);
 }
 
@@ -805,7 +914,7 @@ static void Device_PublishVoltage()
     sprintf(pubtopic, "%s%u", DEVICE_TWIN_MESSAGE_PATCH, reqID);
 
     SSerial_printf(SerialDebug, "%s\r\n", dataSerializedVolt);
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, dataSerializedVolt, strlen(dataSerializedVolt), true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, TELEMETRY_QOS, 1, dataSerializedVolt, strlen(dataSerializedVolt), true))
     {
         SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
         sprintf(displayText, "Error: Property update\r\n failed");
@@ -829,13 +938,12 @@ static void Device_PublishSWVersion()
     memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(sensorPayload, payload);
     json_builder_free(payload);
-    json_builder_free(fwVersion);
 
     reqID++;
     pubtopic[0] = '\0';
     sprintf(pubtopic, "%s%u", DEVICE_TWIN_MESSAGE_PATCH, reqID);
 
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, sensorPayload, strlen(sensorPayload), true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, sensorPayload, strlen(sensorPayload), true))
     {
         SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
         sprintf(displayText, "Error: Property update\r\n failed");
@@ -858,13 +966,12 @@ static void Device_PublishUDID()
     memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(sensorPayload, payload);
     json_builder_free(payload);
-    json_builder_free(jsonUdid);
 
     reqID++;
     pubtopic[0] = '\0';
     sprintf(pubtopic, "%s%u", DEVICE_TWIN_MESSAGE_PATCH, reqID);
 
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, sensorPayload, strlen(sensorPayload), true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, sensorPayload, strlen(sensorPayload), true))
     {
         SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
         sprintf(displayText, "Error: Property update\r\n failed");
@@ -887,7 +994,6 @@ static void Device_PublishMACAddress()
     memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(sensorPayload, payload);
     json_builder_free(payload);
-    json_builder_free(macAddr);
 
     reqID++;
     pubtopic[0] = '\0';
@@ -895,7 +1001,7 @@ static void Device_PublishMACAddress()
 
     SSerial_printf(SerialDebug, "%s\r\n", sensorPayload);
 
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, sensorPayload, strlen(sensorPayload), true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, sensorPayload, strlen(sensorPayload), true))
     {
         SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
         sprintf(displayText, "Error: Property update\r\n failed");
@@ -920,7 +1026,7 @@ void Azure_Device_PublishProperties()
     pubtopic[0] = '\0';
     sprintf(pubtopic, "%s%u", DEVICE_TWIN_GET_TOPIC, reqID);
 
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, NULL, 0, true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, NULL, 0, true))
     {
         SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
     }
@@ -949,7 +1055,7 @@ static void Device_PublishDirectCmdResponse(int status, int requestID)
 {
     pubtopic[0] = '\0';
     sprintf(pubtopic, "$iothub/methods/res/%i/?$rid=%i", status, requestID);
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, NULL, 0, true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, NULL, 0, true))
     {
         SSerial_printf(SerialDebug, "Publish method response failed\r\n");
     }
@@ -966,128 +1072,261 @@ static void Device_PublishSendInterval(uint16_t val, uint16_t ac, uint16_t av, c
     sprintf(pubtopic, "%s%u", DEVICE_TWIN_MESSAGE_PATCH, reqID);
     char *dataSerializedInterval = Device_SerializeSendInterval(val, ac, av, ad);
     SSerial_printf(SerialDebug, "%s\r\n", dataSerializedInterval);
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, dataSerializedInterval, strlen(dataSerializedInterval), true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, dataSerializedInterval, strlen(dataSerializedInterval), true))
     {
         SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
     }
 }
 /**
- * @brief  Process messages from the cloud
+ * @brief  Publish the state of a telemetry filter property (Writable property)
+ * @param  name property name
+ * @param  ac status code
+ * @param  av desired version
+ * @param  ad status description
  * @retval None
  */
-void Azure_Device_processCloudMessage()
+static void Device_PublishFilterProperty(const char *name, uint16_t ac, uint16_t av, char *ad)
 {
-    json_value *cloudResponse = NULL;
-    const char backsSlash[2] = "/";
-    const char equals[2] = "=";
-    char *token;
-    char *reqIDstr;
-    cloudResponse = Device_GetCloudResponse();
-
-    if (strstr(calypso->topicName.data, "$iothub/twin/res/"))
+    char *dataSerializedProperty = Device_SerializeFilterProperty(name, ac, av, ad);
+    if (dataSerializedProperty == NULL)
     {
+        return;
+    }
+    reqID++;
+    pubtopic[0] = '\0';
+    sprintf(pubtopic, "%s%u", DEVICE_TWIN_MESSAGE_PATCH, reqID);
+    SSerial_printf(SerialDebug, "%s\r\n", dataSerializedProperty);
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, dataSerializedProperty, strlen(dataSerializedProperty), true))
+    {
+        SSerial_printf(SerialDebug, "Properties Publish failed\r\n");
+    }
+}
 
-        strtok(calypso->topicName.data, backsSlash);
-        strtok(NULL, backsSlash);
-        strtok(NULL, backsSlash);
-        token = strtok(NULL, backsSlash);
-
-        if (atoi(token) == STATUS_CLOUD_SUCCESS)
+/**
+ * @brief  Find a member of a JSON object by name
+ * @param  object JSON object
+ * @param  name Member name
+ * @retval Value, NULL if the member is missing
+ */
+static json_value *Device_findMember(json_value *object, const char *name)
+{
+    if ((object == NULL) || (object->type != json_object))
+    {
+        return NULL;
+    }
+    for (unsigned int i = 0; i < object->u.object.length; i++)
+    {
+        if (0 == strcmp(object->u.object.values[i].name, name))
         {
-            SSerial_printf(SerialDebug, "Device property updated successfully!\r\n");
+            return object->u.object.values[i].value;
         }
-        else if (atoi(token) == STATUS_SUCCESS)
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Apply and report all the known desired properties, in any order
+ * @param  desired Desired properties with their $version
+ * @param  initial true for the full twin, the send interval is then
+ *         initialized by the device if the cloud has none
+ * @retval None
+ */
+static void Device_updateDesiredProperties(json_value *desired, bool initial)
+{
+    json_value *versionValue = Device_findMember(desired, "$version");
+    uint16_t version = 0;
+    bool sendIntervalFound = false;
+
+    if ((versionValue != NULL) && (versionValue->type == json_integer))
+    {
+        version = (uint16_t)versionValue->u.integer;
+    }
+
+    for (unsigned int i = 0; (desired != NULL) && (desired->type == json_object) && (i < desired->u.object.length); i++)
+    {
+        const char *name = desired->u.object.values[i].name;
+        json_value *value = desired->u.object.values[i].value;
+
+        if (0 == strcmp(name, "telemetrySendFrequency"))
         {
-            unsigned long desiredVal = 0;
-            uint16_t version = 0;
-            /*Received response for the properties get request*/
-            if (0 == strncmp(cloudResponse->u.object.values[0].value->u.object.values[0].name, "telemetrySendFrequency", strlen("telemetrySendFrequency")))
+            sendIntervalFound = true;
+            if (value->type == json_integer)
             {
-                desiredVal = (unsigned long)cloudResponse->u.object.values[0].value->u.object.values[0].value->u.integer;
-                version = (unsigned long)cloudResponse->u.object.values[0].value->u.object.values[1].value->u.integer;
-                /*Defualt value set by the cloud */
-                if ((desiredVal > MAX_TELEMETRY_SEND_INTERVAL) || (desiredVal < MIN_TELEMETRY_SEND_INTERVAL))
-                {
-                    // value out of range, send response
-                    Device_PublishSendInterval(desiredVal, STATUS_BAD_REQUEST, version, "invalid parameter");
-                }
-                else
-                {
-                    // set the value
-                    telemetrySendInterval = desiredVal * 1000;
-                    Device_PublishSendInterval(desiredVal, STATUS_SUCCESS, version, "success");
-
-                    sprintf(displayText, "Property updated\r\nsend interval: %lu s", desiredVal);
-                    SH1107_Display(1, 0, 24, displayText);
-                }
+                SSerial_printf(SerialDebug, "desired val %li, version %u\r\n", (long)value->u.integer,
+                               (unsigned int)version);
+                Device_updateSendInterval((unsigned long)value->u.integer, version);
             }
             else
             {
-                /*No default value available, setting the value from the device*/
-                version = (unsigned long)0;
-                desiredVal = (unsigned long)DEFAULT_TELEMETRY_SEND_INTEVAL;
-                Device_PublishSendInterval(desiredVal, STATUS_SET_BY_DEV, version, "initialize");
+                Device_PublishSendInterval(0, STATUS_BAD_REQUEST, version, "invalid parameter");
             }
         }
-        else
+        else if (Device_isTelemetryFilterProperty(name))
         {
-            SSerial_printf(SerialDebug, "Request failed error:%i\r\n", atoi(token));
+            if (Device_setTelemetryFilterProperty(name, value))
+            {
+                Device_PublishFilterProperty(name, STATUS_SUCCESS, version, "success");
+            }
+            else
+            {
+                Device_PublishFilterProperty(name, STATUS_BAD_REQUEST, version, "invalid parameter");
+            }
         }
     }
-    else if (strstr(calypso->topicName.data, "$iothub/twin/PATCH/properties/desired/"))
+
+    if (initial && !sendIntervalFound)
     {
-        /*Request to update writable property from cloud*/
-        unsigned long desiredVal = (unsigned long)cloudResponse->u.object.values[0].value->u.integer;
-        uint16_t version = (uint16_t)cloudResponse->u.object.values[1].value->u.integer;
+        /*No default value available, setting the value from the device*/
+        Device_PublishSendInterval(DEFAULT_TELEMETRY_SEND_INTEVAL, STATUS_SET_BY_DEV, 0, "initialize");
+    }
+}
 
-        SSerial_printf(SerialDebug, "desired val %i, version %i\r\n", desiredVal, version);
-        if ((desiredVal > MAX_TELEMETRY_SEND_INTERVAL) || (desiredVal < MIN_TELEMETRY_SEND_INTERVAL))
-        {
-            // value out of range, send response
-            Device_PublishSendInterval(desiredVal, STATUS_BAD_REQUEST, version, "invalid parameter");
-        }
-        else
-        {
-            // set the value
-            telemetrySendInterval = desiredVal * 1000;
-            Device_PublishSendInterval(desiredVal, STATUS_SUCCESS, version, "success");
-            sprintf(displayText, "Property updated\r\nsend interval: %lu s", desiredVal);
-            SH1107_Display(1, 0, 24, displayText);
-        }
+/**
+ * @brief  Apply a desired send interval and report it
+ * @param  desiredVal Interval in seconds
+ * @param  version Desired properties version
+ * @retval None
+ */
+static void Device_updateSendInterval(unsigned long desiredVal, uint16_t version)
+{
+    if ((desiredVal > MAX_TELEMETRY_SEND_INTERVAL) || (desiredVal < MIN_TELEMETRY_SEND_INTERVAL))
+    {
+        // value out of range, send response
+        Device_PublishSendInterval(desiredVal, STATUS_BAD_REQUEST, version, "invalid parameter");
     }
-    else if (strstr(calypso->topicName.data, "iothub/methods/POST/setLEDColor/"))
+    else
     {
+        // set the value
+        telemetrySendInterval = desiredVal * 1000;
+        Device_PublishSendInterval(desiredVal, STATUS_SUCCESS, version, "success");
 
-        strtok(calypso->topicName.data, backsSlash);
-        strtok(NULL, backsSlash);
-        strtok(NULL, backsSlash);
-        strtok(NULL, backsSlash);
-        token = strtok(NULL, backsSlash);
-        strtok(token, equals);
-        reqIDstr = strtok(NULL, equals);
+        sprintf(displayText, "Property updated\r\nsend interval: %lu s", desiredVal);
+        SH1107_Display(1, 0, 24, displayText);
+    }
+}
 
-        int red = cloudResponse->u.object.values[0].value->u.integer;
-        int green = cloudResponse->u.object.values[1].value->u.integer;
-        int blue = cloudResponse->u.object.values[2].value->u.integer;
+/**
+ * @brief  Response to a device twin request, $iothub/twin/res/{status}/?$rid={request id}
+ * @param  match Captures: status, properties
+ * @param  message Parsed payload
+ * @retval None
+ */
+static void Device_onTwinResponse(const TopicMatch_t *match, void *message)
+{
+    json_value *cloudResponse = (json_value *)message;
+    long status = TopicSpan_toLong(&match->captures[0]);
 
-        /*Direct command to set LED color*/
-        if ((red < 0) || (red > 0xFF) ||
-            (green < 0) || (green > 0xFF) ||
-            (blue < 0) || (blue > 0xFF))
-        {
-            // value out of range, send response
-            Device_PublishDirectCmdResponse(STATUS_BAD_REQUEST, atoi(reqIDstr));
-        }
-        else
-        {
-            // value valid, set and send response
-            uint32_t color = ((uint32_t)(red << 16) + (uint32_t)(green << 8) + (uint32_t)blue);
-            neopixelSet(color);
-            Device_PublishDirectCmdResponse(STATUS_SUCCESS, atoi(reqIDstr));
-            sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u", red, green, blue);
-            SH1107_Display(1, 0, 16, displayText);
-        }
+    if (status == STATUS_CLOUD_SUCCESS)
+    {
+        SSerial_printf(SerialDebug, "Device property updated successfully!\r\n");
+    }
+    else if ((status == STATUS_SUCCESS) && (cloudResponse != NULL))
+    {
+        /*Received response for the properties get request*/
+        Device_updateDesiredProperties(Device_findMember(cloudResponse, "desired"), true);
+    }
+    else
+    {
+        SSerial_printf(SerialDebug, "Request failed error:%i\r\n", (int)status);
+    }
+}
+
+/**
+ * @brief  Request to update writable properties, $iothub/twin/PATCH/properties/desired/?$version={version}
+ * @param  match Captures: properties
+ * @param  message Parsed payload
+ * @retval None
+ */
+static void Device_onDesiredProperties(const TopicMatch_t *match, void *message)
+{
+    json_value *cloudResponse = (json_value *)message;
+    (void)match;
+
+    if ((cloudResponse == NULL) || (cloudResponse->type != json_object) || (cloudResponse->u.object.length == 0))
+    {
+        return;
+    }
+    Device_updateDesiredProperties(cloudResponse, false);
+}
+
+/**
+ * @brief  Direct command to set the LED color, $iothub/methods/POST/setLEDColor/?$rid={request id}
+ * @param  match Captures: properties
+ * @param  message Parsed payload
+ * @retval None
+ */
+static void Device_onSetLEDColor(const TopicMatch_t *match, void *message)
+{
+    json_value *cloudResponse = (json_value *)message;
+    TopicSpan_t rid;
+    int requestID;
+
+    if (!TopicRouter_getProperty(&match->captures[0], "$rid", &rid) || (cloudResponse == NULL))
+    {
+        return;
+    }
+    requestID = (int)TopicSpan_toLong(&rid);
+
+    int red = cloudResponse->u.object.values[0].value->u.integer;
+    int green = cloudResponse->u.object.values[1].value->u.integer;
+    int blue = cloudResponse->u.object.values[2].value->u.integer;
+
+    if ((red < 0) || (red > 0xFF) ||
+        (green < 0) || (green > 0xFF) ||
+        (blue < 0) || (blue > 0xFF))
+    {
+        // value out of range, send response
+        Device_PublishDirectCmdResponse(STATUS_BAD_REQUEST, requestID);
+    }
+    else
+    {
+        // value valid, set and send response
+        uint32_t color = ((uint32_t)(red << 16) + (uint32_t)(green << 8) + (uint32_t)blue);
+        neopixelSet(color);
+        Device_PublishDirectCmdResponse(STATUS_SUCCESS, requestID);
+        sprintf(displayText, "LED color set\r\nR: %u\r\nG: %u\r\nB: %u", red, green, blue);
+        SH1107_Display(1, 0, 16, displayText);
     }
+}
+
+/**
+ * @brief  Direct command without a handler, $iothub/methods/POST/{method}/?$rid={request id}
+ * @param  match Captures: method, properties
+ * @param  message Parsed payload
+ * @retval None
+ */
+static void Device_onUnknownMethod(const TopicMatch_t *match, void *message)
+{
+    (void)message;
+    SSerial_printf(SerialDebug, "Unknown method: %.*s\r\n", match->captures[0].length, match->captures[0].data);
+}
+
+/**
+ * @brief  Register the handlers of the subscribed topics
+ * @retval None
+ */
+static void Device_initTopicRouter()
+{
+    TopicRouter_init(&topicRouter);
+    TopicRouter_add(&topicRouter, "$iothub/twin/res/+/#", Device_onTwinResponse);
+    TopicRouter_add(&topicRouter, "$iothub/twin/PATCH/properties/desired/#", Device_onDesiredProperties);
+    TopicRouter_add(&topicRouter, "$iothub/methods/POST/setLEDColor/#", Device_onSetLEDColor);
+    TopicRouter_add(&topicRouter, "$iothub/methods/POST/+/#", Device_onUnknownMethod);
+}
+
+/**
+ * @brief  Process messages from the cloud
+ * @retval None
+ */
+void Azure_Device_processCloudMessage()
+{
+    json_value *cloudResponse = Device_GetCloudResponse(0);
+
+    if (calypso->topicName.length == 0)
+    {
+        return;
+    }
+    TopicRouter_dispatch(&topicRouter, calypso->topicName.data, calypso->topicName.length, cloudResponse);
     if (cloudResponse != NULL)
     {
         json_value_free(cloudResponse);
@@ -1100,15 +1339,35 @@ void Azure_Device_processCloudMessage()
  */
 void Azure_Device_connect_WiFi()
 {
-    if (!Calypso_WLANconnect(calypso))
+    if (Device_startWiFi())
+    {
+        Device_waitForWiFi();
+    }
+}
+
+/**
+ * @brief  Start the connection to the access point
+ * @retval true if Calypso accepted the request
+ */
+static bool Device_startWiFi()
+{
+    if (!Calypso_WLANstartConnect(calypso))
     {
         SSerial_printf(calypso->serialDebug, "WiFi connect fail\r\n");
         sprintf(displayText, "Error: Wi-Fi connect \r\nfailed");
         SH1107_Display(1, 0, 24, displayText);
-        return;
+        return false;
     }
-    delay(WI_FI_CONNECT_DELAY);
-    if (calypso->status == calypso_WLAN_connected)
+    return true;
+}
+
+/**
+ * @brief  Wait for the IP address, then set up SNTP
+ * @retval None
+ */
+static void Device_waitForWiFi()
+{
+    if (Calypso_waitForStatus(calypso, calypso_WLAN_connected, WI_FI_CONNECT_DELAY))
     {
         sprintf(displayText, "Connected to Wi-Fi");
         SH1107_Display(1, 0, 24, displayText);
@@ -1143,10 +1402,8 @@ void Azure_Device_reset()
     {
         Calypso_deleteFile(calypso, DEVICE_IOT_HUB_ADDRESS);
     }
-    if (Calypso_fileExists(calypso, CONFIG_FILE_PATH))
-    {
-        Calypso_deleteFile(calypso, CONFIG_FILE_PATH);
-    }
+    CalypsoConfig_remove(&azureConfig, calypso);
+    DebugLog_flush();
     soft_reset();
 }
 
@@ -1172,9 +1429,10 @@ void Azure_Device_WiFi_provisioning()
 
 /**
  * @brief  Serialize data to send
+ * @param  reportMask bit mask of the telemetry channels to include
  * @retval Pointer to serialized data
  */
-static char *Device_SerializeData()
+static char *Device_SerializeData(uint8_t reportMask)
 {
     uint8_t idx = 0;
     json_value *payload = json_object_new(padsProperties + tidsProperties + hidsProperties + 1);
@@ -1183,41 +1441,101 @@ static char *Device_SerializeData()
         SSerial_printf(SerialDebug, "Payload memory full \r\n");
         return NULL;
     }
-    json_value *acceleration = json_object_new(3);
-    if (acceleration == NULL)
-    {
-        json_builder_free(payload);
-        SSerial_printf(SerialDebug, "acceleration memory full \r\n");
-        return NULL;
-    }
 
     for (idx = 0; idx < padsProperties; idx++)
     {
-        json_object_push(payload, sensorPADS->dataNames[idx],
-                         json_double_new(sensorPADS->data[idx]));
+        if (reportMask & TELEMETRY_BIT(telemetryPressure + idx))
+        {
+            json_object_push(payload, sensorPADS->dataNames[idx],
+                             json_double_new((double)sensorPADS->data[idx] / PADS_PRESSURE_SCALE));
+        }
     }
+#if PADS_FIFO_BATCHING
+    if (reportMask & TELEMETRY_BIT(telemetryPressure))
+    {
+        json_object_push(payload, "pressureTrend", json_double_new((double)sensorPADS->pressureTrend / PADS_PRESSURE_SCALE));
+        json_object_push(payload, "altitude", json_double_new((double)sensorPADS->altitude / PADS_ALTITUDE_SCALE));
+    }
+#endif
     for (idx = 0; idx < hidsProperties; idx++)
     {
-        json_object_push(payload, sensorHIDS->dataNames[idx],
-                         json_double_new(sensorHIDS->data[idx]));
+        if (reportMask & TELEMETRY_BIT(telemetryHumidity + idx))
+        {
+            json_object_push(payload, sensorHIDS->dataNames[idx],
+                             json_double_new((double)sensorHIDS->data[idx] / HIDS_HUMIDITY_SCALE));
+        }
     }
     for (idx = 0; idx < tidsProperties; idx++)
     {
-        json_object_push(payload, sensorTIDS->dataNames[idx],
-                         json_double_new(sensorTIDS->data[idx]));
+        if (reportMask & TELEMETRY_BIT(telemetryTemperature + idx))
+        {
+            json_object_push(payload, sensorTIDS->dataNames[idx],
+                             json_double_new((double)sensorTIDS->data[idx] / TIDS_TEMPERATURE_SCALE));
+        }
     }
 
-    for (idx = 0; idx < itdsProperties; idx++)
+    if (reportMask & (TELEMETRY_BIT(telemetryXAcceleration) | TELEMETRY_BIT(telemetryYAcceleration) | TELEMETRY_BIT(telemetryZAcceleration)))
+    {
+        json_value *acceleration = json_object_new(3);
+        if (acceleration == NULL)
+        {
+            json_builder_free(payload);
+            SSerial_printf(SerialDebug, "acceleration memory full \r\n");
+            return NULL;
+        }
+        for (idx = 0; idx < itdsProperties; idx++)
+        {
+            if (reportMask & TELEMETRY_BIT(telemetryXAcceleration + idx))
+            {
+                json_object_push(acceleration, sensorITDS->dataNames[idx],
+                                 json_double_new((double)sensorITDS->data[idx] / ITDS_ACCELERATION_SCALE));
+            }
+        }
+        /*Freed together with the payload*/
+        json_object_push(payload, "acceleration", acceleration);
+    }
+#if VIBRATION_ANALYSIS
+    if (reportMask & TELEMETRY_BIT(telemetryVibration))
+    {
+        json_value *vibration = Device_getVibrationTelemetry();
+        if (vibration == NULL)
+        {
+            json_builder_free(payload);
+            SSerial_printf(SerialDebug, "vibration memory full \r\n");
+            return NULL;
+        }
+        json_object_push(payload, "vibration", vibration);
+    }
+#endif
+
+    memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
+    json_serialize(sensorPayload, payload);
+
+    json_builder_free(payload);
+    return sensorPayload;
+}
+
+/**
+ * @brief  Serialize a motion event
+ * @param  event name of the event
+ * @param  count number of detections
+ * @retval Pointer to serialized data
+ */
+static char *Device_SerializeMotionEvent(const char *event, uint16_t count)
+{
+    json_value *payload = json_object_new(2);
+    if (payload == NULL)
     {
-        json_object_push(acceleration, sensorITDS->dataNames[idx],
-                         json_double_new(sensorITDS->data[idx]));
+        SSerial_printf(SerialDebug, "Payload memory full \r\n");
+        return NULL;
     }
-    json_object_push(payload, "acceleration", acceleration);
+    json_object_push(payload, MOTION_EVENT_PROPERTY, json_string_new(event));
+    json_object_push(payload, MOTION_EVENT_COUNT_PROPERTY, json_integer_new(count));
+
     memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(sensorPayload, payload);
 
     json_builder_free(payload);
-    json_builder_free(acceleration);
     return sensorPayload;
 }
 
@@ -1255,8 +1573,48 @@ static char *Device_SerializeSendInterval(uint16_t val, uint16_t ac, uint16_t av
     memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(sensorPayload, payload);
 
+    /*Nested values are freed together with the payload*/
+    json_builder_free(payload);
+    return sensorPayload;
+}
+
+/**
+ * @brief  Serialize the state of a telemetry filter property
+ * @param  name property name
+ * @param  ac status code
+ * @param  av desired version
+ * @param  ad status description
+ * @retval Pointer to serialized data or NULL
+ */
+static char *Device_SerializeFilterProperty(const char *name, uint16_t ac, uint16_t av, char *ad)
+{
+    json_value *value = Device_getTelemetryFilterProperty(name);
+    if (value == NULL)
+    {
+        return NULL;
+    }
+    json_value *payload = json_object_new(1);
+    json_value *obj = json_object_new(4);
+    if ((payload == NULL) || (obj == NULL))
+    {
+        json_builder_free(value);
+        json_builder_free(payload);
+        json_builder_free(obj);
+        SSerial_printf(SerialDebug, "Payload memory full \r\n");
+        return NULL;
+    }
+
+    json_object_push(obj, "value", value);
+    json_object_push(obj, "ac", json_integer_new(ac));
+    json_object_push(obj, "av", json_integer_new(av));
+    json_object_push(obj, "ad", json_string_new(ad));
+
+    json_object_push(payload, name, obj);
+    memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
+    json_serialize(sensorPayload, payload);
+
+    /*Nested values are freed together with the payload*/
     json_builder_free(payload);
-    json_builder_free(obj);
     return sensorPayload;
 }
 
@@ -1283,7 +1641,6 @@ static char *Device_SerializeProvReq()
     json_serialize(sensorPayload, prov_payload_);
 
     json_builder_free(prov_payload_);
-    json_builder_free(prov_modelID_);
 
     return sensorPayload;
 }
@@ -1313,4 +1670,36 @@ unsigned long Azure_Device_getTelemetrySendInterval()
 bool Azure_Device_isSensorsPresent()
 {
     return sensorsPresent;
-}
\ No newline at end of file
+}
+
+/* Driver called by the Device_* functions when Azure is selected */
+const Device_Platform_t Azure_Device_platform = {
+    AZURE,
+    "AZURE",
+    "Azure",
+    Azure_Device_init,
+    Azure_Device_ConfigurationComplete,
+    NULL,
+    Azure_Device_writeConfigFiles,
+    Azure_Device_getConfigHash,
+    Azure_Device_isConfigured,
+    Azure_Device_configurationInProgress,
+    Azure_Device_isConnectedToWiFi,
+    Azure_Device_isUpToDate,
+    Azure_Device_isStatusOK,
+    Azure_Device_readSensors,
+    Azure_Device_MQTTConnect,
+    Azure_Device_SubscribeToTopics,
+    Azure_Device_PublishSensorData,
+    Azure_Device_PublishMotionEvent,
+    Azure_Device_displaySensorData,
+    Azure_Device_processCloudMessage,
+    Azure_Device_connect_WiFi,
+    Azure_Device_disconnect_WiFi,
+    Azure_Device_WiFi_provisioning,
+    Azure_Device_reset,
+    Azure_Device_restart,
+    Azure_Device_getTelemetrySendInterval,
+    Azure_Device_isSensorsPresent};
+
+#endif /* PNP_PLATFORM_AZURE */
@@ -204,7 +204,8 @@ IYjBFg+ez+rlZ3w3INSJ9Ze6aNmoK3oPfr9j0t+6SKVbuwurAgTlgQ==\n\
 #define CONFIG_FILE_PATH "user/azdevconf"
 
 /*Wi-Fi settings*/
-#define WI_FI_CONNECT_DELAY 5000UL
+/*Longest wait for the IP address, the connection ends earlier*/
+#define WI_FI_CONNECT_DELAY 8000UL
 
 /*MQTT settings*/
 #define DPS_SERVER_ADDRESS "global.azure-devices-provisioning.net"
@@ -248,12 +249,14 @@ IYjBFg+ez+rlZ3w3INSJ9Ze6aNmoK3oPfr9j0t+6SKVbuwurAgTlgQ==\n\
   extern volatile unsigned long telemetrySendInterval;
   TypeSerial *Azure_Device_init(void *Debug, void *CalypsoSerial);
   void Azure_Device_writeConfigFiles();
+  uint32_t Azure_Device_getConfigHash();
   bool Azure_Device_isConfigured();
   bool Azure_Device_isConnectedToWiFi();
   bool Azure_Device_isProvisioned();
   void Azure_Device_MQTTConnect();
   void Azure_Device_readSensors();
   void Azure_Device_PublishSensorData();
+  bool Azure_Device_PublishMotionEvent(const char *event, uint16_t count);
   void Azure_Device_PublishProperties();
   void Azure_Device_connect_WiFi();
   void Azure_Device_disconnect_WiFi();
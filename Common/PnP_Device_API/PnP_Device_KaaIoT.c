@@ -28,6 +28,9 @@
 #include "PnP_Common_Device.h"
 #include "PnP_Device_KaaIoT.h"
 #include "time.h"
+#include "topicrouter.h"
+
+#if PNP_PLATFORM_KAAIOT
 
 #define MAX_PACKET_LOSS 3
 
@@ -72,20 +75,26 @@ extern char pubtopic[128];
 #define MAX_PAYLOAD_LENGTH 1024
 static char sensorPayload[MAX_PAYLOAD_LENGTH];
 static char cmdResponseData[MAX_PAYLOAD_LENGTH];
+static TopicRouter_t topicRouter;
 
 // Certificates
 const char *configurationKaaiot = KAAIOT_CONFIGURATION_DATA;
 
-const char *fileToWrite;
+static void Device_configChangedKaaiot(CalypsoConfig_t *config, const char *key);
+// Device configuration, uploaded through the web server
+static CalypsoConfig_t kaaiotConfig = CALYPSO_CONFIG_INIT(KAAIOT_CONFIG_FILE_PATH, Device_configChangedKaaiot);
 
+static void Device_pause();
 static bool Device_loadConfiguration();
-static char *Device_SerializeData();
+static char *Device_SerializeData(uint8_t reportMask, uint64_t timestamp);
+static char *Device_SerializeMotionEvent(const char *event, uint16_t count);
 static char *Device_CommandResponseData(int requestId, int statusCode, char *reasonPhrase);
 
 static json_value *Device_GetCloudMessage();
 static void removeChar(char *s, char c);
 
 static void Device_PublishDirectCmdResponse(char *appVersion, char *token, char *commandType, int requestId, int statusCode, char *reasonPhrase);
+static void Device_initTopicRouter();
 
 /**
  * @brief  Initialize all components of a device
@@ -95,10 +104,11 @@ static void Device_PublishDirectCmdResponse(char *appVersion, char *token, char
  */
 TypeSerial *Kaaiot_Device_init(void *Debug, void *CalypsoSerial)
 {
+    Device_initTopicRouter();
     // Kaaiot_Device_writeConfigFiles();
     sprintf(displayText, "Loading configuration...");
     SH1107_Display(1, 0, 24, displayText);
-    LED_INDICATION_SHORT_DELAY;
+    Device_pause();
     if (Device_loadConfiguration() == true)
     {
         deviceConfigured = true;
@@ -115,6 +125,32 @@ TypeSerial *Kaaiot_Device_init(void *Debug, void *CalypsoSerial)
     return SerialDebug;
 }
 
+/**
+ * @brief  Hash of the configuration written by Kaaiot_Device_writeConfigFiles
+ * @retval FNV-1a hash
+ */
+uint32_t Kaaiot_Device_getConfigHash()
+{
+    return Checksum_fnv1aString(CHECKSUM_FNV1A_INIT, configurationKaaiot);
+}
+
+/**
+ * @brief  Keep a boot message on the display for a while, not when the
+ *         boot takes the fast path of the boot snapshot
+ * @retval None
+ */
+static void Device_pause()
+{
+    if (Device_isBootSnapshotValid())
+    {
+        SH1107_Flush();
+    }
+    else
+    {
+        LED_INDICATION_SHORT_DELAY;
+    }
+}
+
 /**
  * @brief Function to run on completion of device configuration
  *
@@ -151,9 +187,7 @@ bool Kaaiot_Device_ConfigurationComplete()
  */
 static bool Device_loadConfiguration()
 {
-    char configBuf[512];
-    uint16_t len;
-    if (!Calypso_fileExists(calypso, KAAIOT_CONFIG_FILE_PATH))
+    if (!CalypsoConfig_load(&kaaiotConfig, calypso) && !CalypsoConfig_exists(&kaaiotConfig))
     {
         sprintf(displayText, "Error! Config file\r\n\r\nnot found:\r\n\r\n%s", KAAIOT_CONFIG_FILE_PATH);
         SH1107_Display(1, 0, 0, displayText);
@@ -187,23 +221,23 @@ static bool Device_loadConfiguration()
         LED_INDICATION_LONG_DELAY;
     }
 
-    if (Calypso_readFile(calypso, KAAIOT_CONFIG_FILE_PATH, (char *)configBuf, 512, &len))
+    if (CalypsoConfig_getRoot(&kaaiotConfig) == NULL)
     {
-        json_value *configurationKaaiot = json_parse(configBuf, len);
-        if (configurationKaaiot == NULL)
-        {
-            SSerial_printf(SerialDebug, "Unable to parse config file\r\n");
-            return false;
-        }
-        strcpy(kitID, configurationKaaiot->u.object.values[0].value->u.string.ptr);
-        strcpy(appVersion, configurationKaaiot->u.object.values[1].value->u.string.ptr);
-        strcpy(kaaMqttServerAddress, configurationKaaiot->u.object.values[2].value->u.string.ptr);
-        strcpy(calypso->settings.sntpSettings.server, configurationKaaiot->u.object.values[3].value->u.string.ptr);
-        strcpy(calypso->settings.sntpSettings.timezone, configurationKaaiot->u.object.values[4].value->u.string.ptr);
-        strcpy(calypso->settings.wifiSettings.SSID, configurationKaaiot->u.object.values[5].value->u.string.ptr);
-        calypso->settings.wifiSettings.securityParams.securityType = atoi(configurationKaaiot->u.object.values[6].value->u.string.ptr);
-        strcpy(calypso->settings.wifiSettings.securityParams.securityKey, configurationKaaiot->u.object.values[7].value->u.string.ptr);
+        SSerial_printf(SerialDebug, "Unable to parse config file\r\n");
+        return false;
     }
+    strcpy(kitID, CalypsoConfig_getString(&kaaiotConfig, "token", ""));
+    strcpy(appVersion, CalypsoConfig_getString(&kaaiotConfig, "appVersion", ""));
+    strcpy(kaaMqttServerAddress, CalypsoConfig_getString(&kaaiotConfig, "mqttServer", ""));
+    strcpy(calypso->settings.sntpSettings.server, CalypsoConfig_getString(&kaaiotConfig, "sntpServer", ""));
+    strcpy(calypso->settings.sntpSettings.timezone, CalypsoConfig_getString(&kaaiotConfig, "timezone", ""));
+    strcpy(calypso->settings.wifiSettings.SSID, CalypsoConfig_getString(&kaaiotConfig, "wifiSsid", ""));
+    /* A string from the web form, a number in the default configuration */
+    calypso->settings.wifiSettings.securityParams.securityType = CalypsoConfig_getInt(&kaaiotConfig, "wifiSecurityType", 0);
+    strcpy(calypso->settings.wifiSettings.securityParams.securityKey, CalypsoConfig_getString(&kaaiotConfig, "wifiKey", ""));
+
+    /*Optional telemetry filter settings, e.g. "telemetryHeartbeat" or "pressureDeadband"*/
+    Device_loadTelemetryFilterConfig(CalypsoConfig_getRoot(&kaaiotConfig));
 
     // MQTT Settings
     calypso->settings.mqttSettings.flags = ATMQTT_CREATE_FLAGS_URL | ATMQTT_CREATE_FLAGS_SEC | ATMQTT_CREATE_FLAGS_SKIP_DATE_VERIFY | ATMQTT_CREATE_FLAGS_SKIP_CERT_VERIFY | ATMQTT_CREATE_FLAGS_SKIP_DOMAIN_VERIFY;
@@ -227,48 +261,24 @@ static bool Device_loadConfiguration()
     return true;
 }
 
-/**
- * @brief Check if the device is configured for the KaaIoT (exist files kaaiot.html, kaaiot.js and updated index.html)
- *
- * @return true Device is configured for the KaaIoT
- * @return false Device is not configured for the KaaIoT
- */
-bool Kaaiot_Device_isConfiguredForPlatform()
+void Kaaiot_Device_deletePreviousConfig()
 {
-    bool ret = false;
-
-    ret = Calypso_fileExists(calypso, KAAIOT_HTML_FILE_PATH);
-    if (!ret)
-    {
-        SSerial_printf(SerialDebug, "%s file not exist\r\n", KAAIOT_HTML_FILE_PATH);
-
-        fileToWrite = KAAIOT_HTML_FILE;
-        if (!Calypso_writeBigFile(calypso, KAAIOT_HTML_FILE_PATH, fileToWrite, strlen(KAAIOT_HTML_FILE)))
-        {
-            SSerial_printf(SerialDebug, "Unable to write %s\r\n", KAAIOT_HTML_FILE_PATH);
-        }
-    }
-
-    ret = Calypso_fileExists(calypso, KAAIOT_JS_FILE_PATH);
-    if (!ret)
-    {
-        SSerial_printf(SerialDebug, "%s file not exist\r\n", KAAIOT_JS_FILE_PATH);
-
-        fileToWrite = KAAIOT_JS_FILE;
-        if (!Calypso_writeBigFile(calypso, KAAIOT_JS_FILE_PATH, fileToWrite, strlen(KAAIOT_JS_FILE)))
-        {
-            SSerial_printf(SerialDebug, "Unable to write %s\r\n", KAAIOT_JS_FILE_PATH);
-        }
-    }
-
-    return ret;
+    CalypsoConfig_remove(&kaaiotConfig, calypso);
 }
 
-void Kaaiot_Device_deletePreviousConfig()
+/**
+ * @brief  Listener of the configuration file, the telemetry filter follows
+ *         the values changed
+ * @param  config Configuration file
+ * @param  key Value changed, NULL if the whole file
+ * @retval None
+ */
+static void Device_configChangedKaaiot(CalypsoConfig_t *config, const char *key)
 {
-    if (Calypso_fileExists(calypso, KAAIOT_CONFIG_FILE_PATH))
+    Device_configChanged(config, key);
+    if ((key == NULL) || Device_isTelemetryFilterProperty(key))
     {
-        Calypso_deleteFile(calypso, KAAIOT_CONFIG_FILE_PATH);
+        Device_loadTelemetryFilterConfig(CalypsoConfig_getRoot(config));
     }
 }
 
@@ -280,7 +290,7 @@ void Kaaiot_Device_writeConfigFiles()
 {
     Kaaiot_Device_disconnect_WiFi();
 
-    if (!Calypso_writeFile(calypso, KAAIOT_CONFIG_FILE_PATH, configurationKaaiot, strlen(configurationKaaiot)))
+    if (!CalypsoConfig_replace(&kaaiotConfig, configurationKaaiot) || !CalypsoConfig_commit(&kaaiotConfig, calypso))
     {
         SSerial_printf(SerialDebug, "Unable to configuration data\r\n");
     }
@@ -292,6 +302,7 @@ void Kaaiot_Device_writeConfigFiles()
  */
 void Kaaiot_Device_restart()
 {
+    DebugLog_flush();
     soft_reset();
 }
 
@@ -425,6 +436,13 @@ void Kaaiot_Device_readSensors()
         SSerial_printf(SerialDebug, "Error reading acceleration data\r\n");
     }
 
+#if VIBRATION_ANALYSIS
+    if (!ITDS_readVibration(sensorITDS))
+    {
+        SSerial_printf(SerialDebug, "Error reading vibration data\r\n");
+    }
+#endif
+
     if (!TIDS_readSensorData(sensorTIDS))
     {
         SSerial_printf(SerialDebug, "Error reading temperature data\r\n");
@@ -495,7 +513,7 @@ bool Kaaiot_Device_SubscribeToTopics()
 }
 
 /**
- * @brief  Get message from the cloud
+ * @brief  Get the next queued message from the cloud, does not wait
  * @retval JSON message or NULL
  */
 static json_value *Device_GetCloudMessage()
@@ -520,15 +538,31 @@ static json_value *Device_GetCloudMessage()
  */
 void Kaaiot_Device_PublishSensorData()
 {
+    int32_t values[telemetryChannels];
+    uint8_t reportMask;
+    uint64_t timestamp;
+
     Kaaiot_Device_readSensors();
-    char *dataSerialized = Device_SerializeData();
+    timestamp = SysTime_unixMillis();
+    Device_getTelemetryValues(values);
+    reportMask = Device_getTelemetryReportMask(values);
+    if (reportMask == 0)
+    {
+        /*Nothing changed beyond the deadband and the heartbeat is not due*/
+        return;
+    }
+    char *dataSerialized = Device_SerializeData(reportMask, timestamp);
+    if (dataSerialized == NULL)
+    {
+        return;
+    }
 #if SERIAL_DEBUG
     // SSerial_writeB(SerialDebug, dataSerialized, strlen(dataSerialized));
     // SSerial_printf(SerialDebug, "\r\n");
 #endif
     pubtopic[0] = '\0';
     sprintf(pubtopic, KAA_DATA_SAMPLES_TOPIC, appVersion, kitID);
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, dataSerialized, strlen(dataSerialized), true))
+    if (!Device_publishTelemetry(pubtopic, dataSerialized, values, reportMask))
     {
         packetLost++;
         SSerial_printf(SerialDebug, "Publish failed %u\r\n", packetLost);
@@ -539,6 +573,29 @@ void Kaaiot_Device_PublishSensorData()
     }
 }
 
+/**
+ * @brief  Publish a motion event detected by the accelerometer
+ * @param  event name of the event
+ * @param  count number of detections since the last message of this event
+ * @retval true if successful false otherwise
+ */
+bool Kaaiot_Device_PublishMotionEvent(const char *event, uint16_t count)
+{
+    char *dataSerialized = Device_SerializeMotionEvent(event, count);
+    if (dataSerialized == NULL)
+    {
+        return false;
+    }
+    pubtopic[0] = '\0';
+    sprintf(pubtopic, KAA_DATA_SAMPLES_TOPIC, appVersion, kitID);
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, dataSerialized, strlen(dataSerialized), true))
+    {
+        SSerial_printf(SerialDebug, "Motion event publish failed\r\n");
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief  Display sensor data on OLED display
  * @retval None
@@ -546,12 +603,12 @@ void Kaaiot_Device_PublishSensorData()
 void Kaaiot_Device_displaySensorData()
 {
     sprintf(displayText, "Status: Connected\r\nP:%0.2f kPa\r\nT:%0.2f C\r\nRH:%0.2f %%\r\nAcc: x:%0.2f g\r\n     y:%0.2f g\r\n     z:%0.2f g",
-            sensorPADS->data[0],
-            sensorTIDS->data[0],
-            sensorHIDS->data[0],
-            sensorITDS->data[0],
-            sensorITDS->data[1],
-            sensorITDS->data[2]);
+            (float)sensorPADS->data[0] / PADS_PRESSURE_SCALE,
+            (float)sensorTIDS->data[0] / TIDS_TEMPERATURE_SCALE,
+            (float)sensorHIDS->data[0] / HIDS_HUMIDITY_SCALE,
+            (float)sensorITDS->data[0] / ITDS_ACCELERATION_SCALE,
+            (float)sensorITDS->data[1] / ITDS_ACCELERATION_SCALE,
+            (float)sensorITDS->data[2] / ITDS_ACCELERATION_SCALE);
     SH1107_Display(1, 0, 0, displayText);
 }
 
@@ -565,59 +622,44 @@ static void Device_PublishDirectCmdResponse(char *appVersion, char *token, char
 
     pubtopic[0] = '\0';
     sprintf(pubtopic, KAA_COMMANDS_RESPONSE_TOPIC, appVersion, token, commandType);
-    if (!Calypso_MQTTPublishData(calypso, pubtopic, 1, responseData, strlen(responseData), true))
+    if (!Calypso_MQTTPublishData(calypso, pubtopic, MESSAGE_QOS, 1, responseData, strlen(responseData), true))
     {
         SSerial_printf(SerialDebug, "Publish command response failed\r\n");
     }
 }
 
 /**
- * @brief  Process messages from the cloud
+ * @brief  Check that a command topic is addressed to this endpoint
+ * @param  match Captures: application version, endpoint token, ...
+ * @retval true if both match the configuration
+ */
+static bool Device_isOwnCommand(const TopicMatch_t *match)
+{
+    return TopicSpan_equals(&match->captures[0], appVersion) && TopicSpan_equals(&match->captures[1], kitID);
+}
+
+/**
+ * @brief  Switch command, kp1/{app version}/cex/{token}/command/switch_on_off/status
+ * @param  match Captures: application version, token
+ * @param  message Parsed payload
  * @retval None
  */
-void Kaaiot_Device_processCloudMessage()
+static void Device_onSwitchCommand(const TopicMatch_t *match, void *message)
 {
-    json_value *cloudMessage = NULL;
-    const char backsSlash[2] = "/";
-    char *msgAppVersion;
-    char *msgToken;
-    char *msgCommandType;
-    char *topicStatus;
+    json_value *cloudMessage = (json_value *)message;
+    char msgCommandType[] = "switch_on_off";
     int commandId;
     char *commandPayloadKey;
     char *commandPayloadValue;
-    cloudMessage = Device_GetCloudMessage();
 
-    strtok(calypso->topicName.data, backsSlash);
-    msgAppVersion = strtok(NULL, backsSlash);
-    strtok(NULL, backsSlash);
-    msgToken = strtok(NULL, backsSlash);
-    strtok(NULL, backsSlash);
-    msgCommandType = strtok(NULL, backsSlash);
-    topicStatus = strtok(NULL, backsSlash);
-
-    if (!strstr(msgAppVersion, appVersion) || !strstr(msgToken, kitID) || !strstr(topicStatus, "status"))
+    if (!Device_isOwnCommand(match))
     {
-        if (cloudMessage != NULL)
-        {
-            json_value_free(cloudMessage);
-        }
         return;
     }
 
-    if (!strstr(msgCommandType, "switch_on_off"))
-    {
-        SSerial_printf(SerialDebug, "Unexpected command type: %s\r\n", msgCommandType);
-        if (cloudMessage != NULL)
-        {
-            json_value_free(cloudMessage);
-        }
-        return;
-    }
-
-    SSerial_printf(SerialDebug, "Commands received. Type: %s, appVersion: %s, token: %s.\r\n", msgCommandType, msgAppVersion, msgToken);
+    SSerial_printf(SerialDebug, "Commands received. Type: %s, appVersion: %s, token: %s.\r\n", msgCommandType, appVersion, kitID);
 
-    if (cloudMessage->type == json_array)
+    if ((cloudMessage != NULL) && (cloudMessage->type == json_array))
     {
         unsigned int length = cloudMessage->u.array.length;
         for (unsigned int i = 0; i < length; i++)
@@ -633,26 +675,66 @@ void Kaaiot_Device_processCloudMessage()
 
             if (0 == strncmp(commandPayloadValue, "on", strlen("on")))
             {
-                Device_PublishDirectCmdResponse(appVersion, msgToken, msgCommandType, commandId, 200, "OK");
+                Device_PublishDirectCmdResponse(appVersion, kitID, msgCommandType, commandId, 200, "OK");
                 sprintf(displayText, "State: \"%s\"", commandPayloadValue);
                 SSerial_printf(SerialDebug, "State changed to \"%s\"\r\n", commandPayloadValue);
             }
             else if (0 == strncmp(commandPayloadValue, "off", strlen("off")))
             {
-                Device_PublishDirectCmdResponse(appVersion, msgToken, msgCommandType, commandId, 200, "OK");
+                Device_PublishDirectCmdResponse(appVersion, kitID, msgCommandType, commandId, 200, "OK");
                 sprintf(displayText, "State: \"%s\"", commandPayloadValue);
                 SSerial_printf(SerialDebug, "State changed to \"%s\"\r\n", commandPayloadValue);
             }
             else
             {
-                Device_PublishDirectCmdResponse(appVersion, msgToken, msgCommandType, commandId, 400, "Unknown state");
+                Device_PublishDirectCmdResponse(appVersion, kitID, msgCommandType, commandId, 400, "Unknown state");
                 sprintf(displayText, "Unknown state: %s", commandPayloadValue);
                 SSerial_printf(SerialDebug, "Unknown state: %s\r\n", commandPayloadValue);
             }
             SH1107_Display(1, 0, 16, displayText);
         }
     }
+}
+
+/**
+ * @brief  Command without a handler, kp1/{app version}/cex/{token}/command/{type}/status
+ * @param  match Captures: application version, token, command type
+ * @param  message Parsed payload
+ * @retval None
+ */
+static void Device_onUnexpectedCommand(const TopicMatch_t *match, void *message)
+{
+    (void)message;
+    if (Device_isOwnCommand(match))
+    {
+        SSerial_printf(SerialDebug, "Unexpected command type: %.*s\r\n", match->captures[2].length, match->captures[2].data);
+    }
+}
+
+/**
+ * @brief  Register the handlers of the subscribed topics
+ * @retval None
+ */
+static void Device_initTopicRouter()
+{
+    TopicRouter_init(&topicRouter);
+    TopicRouter_add(&topicRouter, "kp1/+/cex/+/command/switch_on_off/status", Device_onSwitchCommand);
+    TopicRouter_add(&topicRouter, "kp1/+/cex/+/command/+/status", Device_onUnexpectedCommand);
+}
 
+/**
+ * @brief  Process messages from the cloud
+ * @retval None
+ */
+void Kaaiot_Device_processCloudMessage()
+{
+    json_value *cloudMessage = Device_GetCloudMessage();
+
+    if (calypso->topicName.length == 0)
+    {
+        return;
+    }
+    TopicRouter_dispatch(&topicRouter, calypso->topicName.data, calypso->topicName.length, cloudMessage);
     if (cloudMessage != NULL)
     {
         json_value_free(cloudMessage);
@@ -665,24 +747,23 @@ void Kaaiot_Device_processCloudMessage()
  */
 void Kaaiot_Device_connect_WiFi()
 {
-    if (!Calypso_WLANconnect(calypso))
+    if (!Calypso_WLANstartConnect(calypso))
     {
         SSerial_printf(calypso->serialDebug, "WiFi connect fail\r\n");
         sprintf(displayText, "Error!!!\r\n\r\nWi-Fi connect failed\r\n\r\nCheck configuration!");
         SH1107_Display(1, 0, 0, displayText);
         return;
     }
-    delay(WI_FI_CONNECT_DELAY);
-    if (calypso->status == calypso_WLAN_connected)
+    if (Calypso_waitForStatus(calypso, calypso_WLAN_connected, WI_FI_CONNECT_DELAY))
     {
         sprintf(displayText, "Connected to Wi-Fi");
         SH1107_Display(1, 0, 24, displayText);
-        LED_INDICATION_SHORT_DELAY;
+        Device_pause();
     }
 
     sprintf(displayText, "SNTP time sync...");
     SH1107_Display(1, 0, 24, displayText);
-    LED_INDICATION_SHORT_DELAY;
+    Device_pause();
     if (!Calypso_setUpSNTP(calypso))
     {
         SSerial_printf(calypso->serialDebug, "SNTP config fail\r\n");
@@ -694,7 +775,7 @@ void Kaaiot_Device_connect_WiFi()
     }
     Calypso_getTime(calypso);
     SH1107_Display(1, 0, 24, displayText);
-    LED_INDICATION_SHORT_DELAY;
+    Device_pause();
 }
 
 /**
@@ -717,10 +798,7 @@ void Kaaiot_Device_reset()
 {
     Kaaiot_Device_disconnect_WiFi();
     /*Delete device credentials*/
-    if (Calypso_fileExists(calypso, KAAIOT_CONFIG_FILE_PATH))
-    {
-        Calypso_deleteFile(calypso, KAAIOT_CONFIG_FILE_PATH);
-    }
+    CalypsoConfig_remove(&kaaiotConfig, calypso);
     if (Calypso_fileExists(calypso, KAAIOT_ROOT_CA_PATH))
     {
         Calypso_deleteFile(calypso, KAAIOT_ROOT_CA_PATH);
@@ -733,6 +811,7 @@ void Kaaiot_Device_reset()
     {
         Calypso_deleteFile(calypso, KAAIOT_DEVICE_KEY_PATH);
     }
+    DebugLog_flush();
     soft_reset();
 }
 
@@ -758,52 +837,121 @@ void Kaaiot_Device_WiFi_provisioning()
 
 /**
  * @brief  Serialize data to send
+ * @param  reportMask bit mask of the telemetry channels to include
+ * @param  timestamp time of the reading in ms since 1970, 0 if unknown
  * @retval Pointer to serialized data
  */
-static char *Device_SerializeData()
+static char *Device_SerializeData(uint8_t reportMask, uint64_t timestamp)
 {
     uint8_t idx = 0;
-    json_value *payload = json_object_new(padsProperties + tidsProperties + hidsProperties + 1);
+    json_value *payload = json_object_new(padsProperties + tidsProperties + hidsProperties + 2);
     if (payload == NULL)
     {
         SSerial_printf(SerialDebug, "Payload memory full \r\n");
         return NULL;
     }
-    json_value *acceleration = json_object_new(3);
-    if (acceleration == NULL)
+
+    /* Time of the reading, used by the KaaIoT time series instead of the
+     * time of arrival */
+    if (timestamp != 0)
     {
-        json_builder_free(payload);
-        SSerial_printf(SerialDebug, "acceleration memory full \r\n");
-        return NULL;
+        json_object_push(payload, TIMESTAMP_PROPERTY, json_integer_new((json_int_t)timestamp));
     }
 
     for (idx = 0; idx < padsProperties; idx++)
     {
-        json_object_push(payload, sensorPADS->dataNames[idx],
-                         json_double_new(sensorPADS->data[idx]));
+        if (reportMask & TELEMETRY_BIT(telemetryPressure + idx))
+        {
+            json_object_push(payload, sensorPADS->dataNames[idx],
+                             json_double_new((double)sensorPADS->data[idx] / PADS_PRESSURE_SCALE));
+        }
     }
+#if PADS_FIFO_BATCHING
+    if (reportMask & TELEMETRY_BIT(telemetryPressure))
+    {
+        json_object_push(payload, "pressureTrend", json_double_new((double)sensorPADS->pressureTrend / PADS_PRESSURE_SCALE));
+        json_object_push(payload, "altitude", json_double_new((double)sensorPADS->altitude / PADS_ALTITUDE_SCALE));
+    }
+#endif
     for (idx = 0; idx < hidsProperties; idx++)
     {
-        json_object_push(payload, sensorHIDS->dataNames[idx],
-                         json_double_new(sensorHIDS->data[idx]));
+        if (reportMask & TELEMETRY_BIT(telemetryHumidity + idx))
+        {
+            json_object_push(payload, sensorHIDS->dataNames[idx],
+                             json_double_new((double)sensorHIDS->data[idx] / HIDS_HUMIDITY_SCALE));
+        }
     }
     for (idx = 0; idx < tidsProperties; idx++)
     {
-        json_object_push(payload, sensorTIDS->dataNames[idx],
-                         json_double_new(sensorTIDS->data[idx]));
+        if (reportMask & TELEMETRY_BIT(telemetryTemperature + idx))
+        {
+            json_object_push(payload, sensorTIDS->dataNames[idx],
+                             json_double_new((double)sensorTIDS->data[idx] / TIDS_TEMPERATURE_SCALE));
+        }
+    }
+
+    if (reportMask & (TELEMETRY_BIT(telemetryXAcceleration) | TELEMETRY_BIT(telemetryYAcceleration) | TELEMETRY_BIT(telemetryZAcceleration)))
+    {
+        json_value *acceleration = json_object_new(3);
+        if (acceleration == NULL)
+        {
+            json_builder_free(payload);
+            SSerial_printf(SerialDebug, "acceleration memory full \r\n");
+            return NULL;
+        }
+        for (idx = 0; idx < itdsProperties; idx++)
+        {
+            if (reportMask & TELEMETRY_BIT(telemetryXAcceleration + idx))
+            {
+                json_object_push(acceleration, sensorITDS->dataNames[idx],
+                                 json_double_new((double)sensorITDS->data[idx] / ITDS_ACCELERATION_SCALE));
+            }
+        }
+        /*Freed together with the payload*/
+        json_object_push(payload, "acceleration", acceleration);
+    }
+#if VIBRATION_ANALYSIS
+    if (reportMask & TELEMETRY_BIT(telemetryVibration))
+    {
+        json_value *vibration = Device_getVibrationTelemetry();
+        if (vibration == NULL)
+        {
+            json_builder_free(payload);
+            SSerial_printf(SerialDebug, "vibration memory full \r\n");
+            return NULL;
+        }
+        json_object_push(payload, "vibration", vibration);
     }
+#endif
+
+    memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
+    json_serialize(sensorPayload, payload);
+
+    json_builder_free(payload);
+    return sensorPayload;
+}
 
-    for (idx = 0; idx < itdsProperties; idx++)
+/**
+ * @brief  Serialize a motion event
+ * @param  event name of the event
+ * @param  count number of detections
+ * @retval Pointer to serialized data
+ */
+static char *Device_SerializeMotionEvent(const char *event, uint16_t count)
+{
+    json_value *payload = json_object_new(2);
+    if (payload == NULL)
     {
-        json_object_push(acceleration, sensorITDS->dataNames[idx],
-                         json_double_new(sensorITDS->data[idx]));
+        SSerial_printf(SerialDebug, "Payload memory full \r\n");
+        return NULL;
     }
-    json_object_push(payload, "acceleration", acceleration);
+    json_object_push(payload, MOTION_EVENT_PROPERTY, json_string_new(event));
+    json_object_push(payload, MOTION_EVENT_COUNT_PROPERTY, json_integer_new(count));
+
     memset(sensorPayload, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(sensorPayload, payload);
 
     json_builder_free(payload);
-    json_builder_free(acceleration);
     return sensorPayload;
 }
 
@@ -841,9 +989,7 @@ static char *Device_CommandResponseData(int requestId, int statusCode, char *rea
     memset(cmdResponseData, 0, MAX_PAYLOAD_LENGTH);
     json_serialize(cmdResponseData, payloadArray);
 
-    json_builder_free(payload);
     json_builder_free(payloadArray);
-    json_builder_free(responsePayload);
     return cmdResponseData;
 }
 
@@ -872,4 +1018,36 @@ unsigned long Kaaiot_Device_getTelemetrySendInterval()
 bool Kaaiot_Device_isSensorsPresent()
 {
     return sensorsPresent;
-}
\ No newline at end of file
+}
+
+/* Driver called by the Device_* functions when KaaIoT is selected */
+const Device_Platform_t Kaaiot_Device_platform = {
+    KAAIOT,
+    "KAAIOT",
+    "KaaIoT",
+    Kaaiot_Device_init,
+    Kaaiot_Device_ConfigurationComplete,
+    Kaaiot_Device_deletePreviousConfig,
+    Kaaiot_Device_writeConfigFiles,
+    Kaaiot_Device_getConfigHash,
+    Kaaiot_Device_isConfigured,
+    Kaaiot_Device_configurationInProgress,
+    Kaaiot_Device_isConnectedToWiFi,
+    Kaaiot_Device_isUpToDate,
+    Kaaiot_Device_isStatusOK,
+    Kaaiot_Device_readSensors,
+    Kaaiot_Device_MQTTConnect,
+    Kaaiot_Device_SubscribeToTopics,
+    Kaaiot_Device_PublishSensorData,
+    Kaaiot_Device_PublishMotionEvent,
+    Kaaiot_Device_displaySensorData,
+    Kaaiot_Device_processCloudMessage,
+    Kaaiot_Device_connect_WiFi,
+    Kaaiot_Device_disconnect_WiFi,
+    Kaaiot_Device_WiFi_provisioning,
+    Kaaiot_Device_reset,
+    Kaaiot_Device_restart,
+    Kaaiot_Device_getTelemetrySendInterval,
+    Kaaiot_Device_isSensorsPresent};
+
+#endif /* PNP_PLATFORM_KAAIOT */
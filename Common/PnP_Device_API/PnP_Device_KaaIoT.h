@@ -39,98 +39,6 @@ extern "C"
 {
 #endif
 
-#define KAAIOT_HTML_FILE "<html><script type=\"text/javascript\" src=\"js/jquery-3.6.0.min.js\"></script><script type=\"text/javascript\" src=\"js/settings.js\"></script><script type=\"text/javascript\" src=\"js/general.js\"></script><link rel=\"stylesheet\" type=\"text/css\" href=\"css/bootstrap.min.css\"><link rel=\"stylesheet\" type=\"text/css\" href=\"css/style.css\"><body onload=\"cbLoad()\"><form id=\"kaaiot-form\"><div class=\"alert alert-success alert-dismissable\"><div class=\"alertwrapper clearfix\"><div class=\"alertcontent\"><h4>Info!</h4>To upload a KaaIoT configuration, fill out the form below.</div></div></div><div class=\"headerInSub\"><div class=\"subTitle\">KaaIoT Configuration Upload</div></div><div class=\"c\"><fieldset class=\"wrapSection\"><legend>Enter KaaIoT Device Configuration</legend><div class=\"row mb-3\"><label class=\"form-label\">Token</label> <input class=\"form-control\" type=\"text\" id=\"token\" maxlength=\"50\" required></div><div class=\"row mb-3\"><label class=\"form-label\">Application Version</label> <input class=\"form-control\" type=\"text\" id=\"appVersion\" maxlength=\"40\" required></div><div class=\"row mb-3\"><label class=\"form-label\">MQTT Server</label> <input class=\"form-control\" type=\"text\" id=\"mqttServer\" maxlength=\"100\" placeholder=\"mqtt.cloud.kaaiot.com\" required></div><div class=\"row mb-3\"><label class=\"form-label\">SNTP Server</label> <input class=\"form-control\" type=\"text\" id=\"sntpServer\" maxlength=\"100\" placeholder=\"0.de.pool.ntp.org\" required></div><div class=\"row mb-3\"><label class=\"form-label\">Timezone(UTC ± minutes)</label> <input class=\"form-control\" type=\"number\" id=\"timezone\" maxlength=\"3\" placeholder=\"60\" required></div><div class=\"row mb-3\"><label class=\"form-label\">WiFi SSID</label> <input class=\"form-control\" type=\"text\" id=\"wifiSsid\" maxlength=\"40\" required></div><div class=\"row mb-3\"><label class=\"form-label\">WiFi Security Type</label> <select class=\"form-control\" id=\"wifiSecurityType\" required><option value=\"0\">Open</option><option value=\"1\">WEP</option><option value=\"2\">WEP Shared</option><option value=\"3\">WPA_WPA2</option><option value=\"4\">WPA2_PLUS</option><option value=\"5\">WPA3</option></select></div><div class=\"row mb-3\"><label class=\"form-label\">WiFi Security Key</label> <input class=\"form-control\" type=\"password\" id=\"wifiKey\" maxlength=\"40\" required></div><div class=\"row mb-3\"><label for=\"formFile\" class=\"form-label\">All files (Device certificate (kaadevcert), device key (kaadevkey) and Root CA (kaarootca))</label> <input class=\"form-control\" type=\"file\" id=\"file-input\" multiple=\"multiple\"></div><div class=\"row mb-3\"><div class=\"col-md-4 offset-md-8\"><input name=\"Upload\" type=\"submit\" value=\"UPLOAD\" class=\"btn btn-primary\" style=\"height:40px\"></div></div><div class=\"row\"><ul class=\"list-group\" id=\"file-list-display\"></ul></div><div class=\"result\" id=\"result\" style=\"display: none\"></div></fieldset></div></form></body><script type=\"text/javascript\" src=\"js/kaaiot.js\"></script></html>"
-
-#define KAAIOT_JS_FILE "(function() {\
-  var form = document.getElementById('kaaiot-form');\
-  var fileInput = document.getElementById('file-input');\
-  var fileListDisplay = document.getElementById('file-list-display');\
-\
-  form.addEventListener('submit', function(evnt) {\
-    evnt.preventDefault();\
-    var kaadevconf = {\
-      token: document.getElementById('token').value,\
-      appVersion: document.getElementById('appVersion').value,\
-      mqttServer: document.getElementById('mqttServer').value,\
-      sntpServer: document.getElementById('sntpServer').value,\
-      timezone: document.getElementById('timezone').value,\
-      wifiSsid: document.getElementById('wifiSsid').value,\
-      wifiSecurityType: document.getElementById('wifiSecurityType').value,\
-      wifiKey: document.getElementById('wifiKey').value\
-    };\
-    var jsonFile = createJSONFile(kaadevconf);\
-    sendFile(jsonFile);\
-\
-    fileList.forEach(function(file) {\
-      sendFile(file);\
-    });\
-  });\
-\
-  var fileList = [];\
-  var renderFileList, sendFile;\
-\
-  fileInput.addEventListener('change', function(evnt) {\
-    fileList = [];\
-    for (var i = 0; i < fileInput.files.length; i++) {\
-      fileList.push(fileInput.files[i]);\
-    }\
-    renderFileList();\
-  });\
-\
-  renderFileList = function() {\
-    fileListDisplay.innerHTML = '';\
-    fileList.forEach(function(file, index) {\
-      var fileDisplayEl = document.createElement('li');\
-      fileDisplayEl.classList.add('list-group-item');\
-      fileDisplayEl.id = file.name;\
-      fileDisplayEl.innerHTML = file.name;\
-      fileListDisplay.appendChild(fileDisplayEl);\
-    });\
-  };\
-\
-  function createJSONFile(data) {\
-    var jsonString = JSON.stringify(data, null, 2);\
-    var blob = new Blob([jsonString], {\
-      type: 'application/json'\
-    });\
-    var file = new File([blob], \"kaadevconf.json\", {\
-      type: 'application/json'\
-    });\
-    return file;\
-  }\
-\
-  function sendFile(file) {\
-    var formData = new FormData();\
-    var request = new XMLHttpRequest();\
-    request.onreadystatechange = () => {\
-      if (request.readyState === XMLHttpRequest.DONE) {\
-        var fileNameStr = \"#\" + request.responseURL.substring(request.responseURL.indexOf('=') + 1);\
-        if (request.status === 200 || request.status === 204) {\
-          if (request.responseText != \"\") {\
-            $('.result').html(request.responseText);\
-          } else {\
-            $('.result').html(\"Success: \" + request.status + \": \" + request.statusText);\
-            $(fileNameStr).html($(fileNameStr).html() + \" - uploaded.\");\
-          }\
-        } else {\
-          $('.result').html(\"Error \" + request.status + \": \" + request.statusText);\
-          $(fileNameStr).html($(fileNameStr).html() + \" - error, file not uploaded!\");\
-        }\
-      }\
-      $('.result').css('display', 'block');\
-    };\
-    request.onerror = () => {\
-      console.log(\"Failed to upload configuration\");\
-      $('.result').html(\"Error \" + request.status + \": \" + request.statusText);\
-      document.getElementById('result').style.display = 'block';\
-    };\
-    formData.set('file', file);\
-    var put_uri = \"file?filename=\" + file.name;\
-    request.open(\"PUT\", put_uri, true);\
-    request.send(file);\
-  }\
-  })();"
-
 #define KAAIOT_CONFIGURATION_DATA "{\n\
 	\"token\": \"kaa-token\",\n\
 	\"appVersion\": \"kaa-app-version\",\n\
@@ -152,7 +60,8 @@ extern "C"
 #define KAAIOT_DEVICE_KEY_PATH "user/kaadevkey"
 
 /*Wi-Fi settings*/
-#define WI_FI_CONNECT_DELAY 5000UL
+/*Longest wait for the IP address, the connection ends earlier*/
+#define WI_FI_CONNECT_DELAY 8000UL
 
 /*MQTT settings*/
 #define MQTT_PORT_SECURE 8883
@@ -183,12 +92,13 @@ extern "C"
   TypeSerial *Kaaiot_Device_init(void *Debug, void *CalypsoSerial);
   void Kaaiot_Device_deletePreviousConfig();
   void Kaaiot_Device_writeConfigFiles();
-  bool Kaaiot_Device_isConfiguredForPlatform();
+  uint32_t Kaaiot_Device_getConfigHash();
   bool Kaaiot_Device_isConfigured();
   bool Kaaiot_Device_isConnectedToWiFi();
   void Kaaiot_Device_MQTTConnect();
   void Kaaiot_Device_readSensors();
   void Kaaiot_Device_PublishSensorData();
+  bool Kaaiot_Device_PublishMotionEvent(const char *event, uint16_t count);
   void Kaaiot_Device_connect_WiFi();
   void Kaaiot_Device_disconnect_WiFi();
   void Kaaiot_Device_WiFi_provisioning();
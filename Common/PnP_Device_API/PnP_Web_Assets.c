@@ -0,0 +1,252 @@
+/**
+ * \file
+ * \brief Web files written to Calypso, compressed with raw DEFLATE.
+ *
+ * Generated by GW/scripts/web_assets.py from GW/web, do not edit.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "PnP_Web_Assets.h"
+
+const uint8_t indexHtmlSrcFile[INDEX_HTML_SRC_FILE_SIZE] = {
+    0xa5, 0x92, 0xd1, 0x6e, 0x9b, 0x30, 0x14, 0x86, 0x5f, 0xc5, 0xcb, 0x4d, 0x5b, 0x69, 0x84, 0x56,
+    0x95, 0xa6, 0xad, 0x05, 0xa4, 0xaa, 0x5a, 0xb7, 0x6a, 0xd3, 0x3a, 0x29, 0x99, 0x7a, 0x7d, 0x30,
+    0x27, 0xc1, 0x89, 0xb1, 0xa9, 0x7d, 0xa0, 0x4b, 0x5f, 0x64, 0x0f, 0xb4, 0x17, 0x9b, 0x09, 0x09,
+    0xd0, 0x64, 0x88, 0x89, 0xdd, 0x20, 0x8e, 0xff, 0xef, 0x7c, 0x3e, 0x18, 0x07, 0x6f, 0x12, 0xcd,
+    0x69, 0x93, 0x63, 0x4a, 0x99, 0x8c, 0x82, 0x0c, 0x09, 0x18, 0xd7, 0x8a, 0x50, 0x51, 0x38, 0x21,
+    0xfc, 0x49, 0x7e, 0x15, 0x5c, 0x33, 0x9e, 0x82, 0xb1, 0x48, 0x61, 0x41, 0x0b, 0xef, 0xfd, 0x24,
+    0x25, 0xca, 0x3d, 0x7c, 0x2a, 0x44, 0x19, 0xde, 0xd6, 0xb0, 0x37, 0x77, 0x8e, 0xc3, 0xfe, 0x67,
+    0x91, 0x50, 0x1a, 0x26, 0x58, 0x0a, 0x8e, 0xde, 0xb6, 0x78, 0x2b, 0x94, 0x20, 0x01, 0xd2, 0xb3,
+    0x1c, 0x24, 0x86, 0x17, 0x13, 0x05, 0x19, 0x86, 0xa5, 0xc0, 0xe7, 0x5c, 0x1b, 0x8a, 0x02, 0x12,
+    0x24, 0x31, 0x7a, 0x2c, 0xd0, 0x50, 0xca, 0x3e, 0x4a, 0x5c, 0x93, 0xd1, 0x4a, 0xac, 0x19, 0x8a,
+    0x99, 0xb6, 0xec, 0x16, 0xe4, 0x26, 0xb7, 0x3a, 0xf0, 0x6b, 0x2c, 0x90, 0x42, 0xad, 0x59, 0x6a,
+    0x70, 0x11, 0x72, 0x6b, 0xfd, 0x58, 0x6b, 0xb2, 0x64, 0x20, 0x9f, 0x66, 0x42, 0x4d, 0xdd, 0x0a,
+    0x33, 0x28, 0x43, 0x4b, 0x1b, 0x89, 0x36, 0x45, 0xa4, 0x43, 0x7e, 0x9b, 0xfc, 0x95, 0xb3, 0xdc,
+    0x88, 0x9c, 0x98, 0x35, 0x3c, 0x5c, 0x59, 0x7f, 0xf5, 0xe4, 0xc6, 0xd9, 0x78, 0x97, 0xd3, 0x77,
+    0xd3, 0xf3, 0xad, 0x7a, 0x65, 0xa3, 0xc0, 0xaf, 0x99, 0x43, 0x76, 0x89, 0x0a, 0x0d, 0xc8, 0xd7,
+    0x48, 0x22, 0x4a, 0xc6, 0x25, 0x58, 0x1b, 0x3e, 0xbb, 0xe9, 0x72, 0x34, 0xdd, 0xa5, 0x14, 0x21,
+    0x41, 0xc3, 0x44, 0x12, 0x66, 0x20, 0xd4, 0x71, 0x72, 0xaf, 0x98, 0x56, 0x5c, 0x0a, 0xbe, 0x0e,
+    0x75, 0x8e, 0xea, 0x1b, 0x94, 0xa7, 0x67, 0x5d, 0xca, 0xe8, 0xe7, 0x6e, 0x39, 0xe1, 0x5a, 0x7a,
+    0x59, 0xe2, 0x5d, 0xb2, 0x0c, 0x55, 0x31, 0xd7, 0xf9, 0xc4, 0x0d, 0xe2, 0xe2, 0x2e, 0xb3, 0x43,
+    0x3e, 0x44, 0x41, 0x7a, 0x11, 0xed, 0xce, 0x94, 0x3d, 0x7e, 0xbd, 0xf9, 0xc6, 0x32, 0x9d, 0x14,
+    0x12, 0x03, 0xdf, 0xad, 0xef, 0xba, 0x8e, 0x9f, 0xad, 0xc7, 0x8a, 0x04, 0x63, 0xa8, 0x67, 0xdf,
+    0xcc, 0x76, 0x85, 0x56, 0x99, 0x2e, 0x2c, 0x4a, 0x84, 0x12, 0x43, 0x2e, 0xb5, 0xc5, 0xdd, 0xc8,
+    0x50, 0x9f, 0xfc, 0x0a, 0x4a, 0xa8, 0x0f, 0xe6, 0xaa, 0xd4, 0x22, 0x39, 0x3d, 0x3f, 0xbb, 0x6e,
+    0x3e, 0xb0, 0xc5, 0xf7, 0x93, 0x56, 0x0b, 0x31, 0xa9, 0xe8, 0xf7, 0xaf, 0xc0, 0x87, 0x88, 0xfd,
+    0x8b, 0xe4, 0x64, 0x77, 0x4c, 0xee, 0xf6, 0xb8, 0x23, 0xa0, 0xd3, 0x49, 0x0c, 0x16, 0xef, 0x8c,
+    0xbb, 0x67, 0x93, 0xb3, 0x93, 0xe8, 0xb3, 0xce, 0x70, 0xbc, 0xca, 0x22, 0x91, 0x50, 0x4b, 0xdb,
+    0xe8, 0x66, 0xbb, 0x85, 0xf1, 0x4a, 0x4d, 0xd0, 0xd8, 0x1e, 0xe6, 0x37, 0xe3, 0x45, 0xcb, 0x5c,
+    0xe8, 0xc6, 0xf4, 0xe9, 0xfb, 0xfd, 0xc3, 0x78, 0x95, 0xfb, 0x7f, 0xa6, 0x51, 0xfd, 0x70, 0x05,
+    0xb3, 0xff, 0xfd, 0x9d, 0xbc, 0xb0, 0xa4, 0xb3, 0xc6, 0x7a, 0xbb, 0x2d, 0xc7, 0xeb, 0x16, 0x42,
+    0xb6, 0x3f, 0xf5, 0xce, 0x15, 0xac, 0xc8, 0xa5, 0x86, 0x64, 0xbc, 0x11, 0x5e, 0x0a, 0xd3, 0x2a,
+    0x6f, 0xaa, 0x6a, 0xbc, 0x6c, 0x0d, 0x20, 0x34, 0x35, 0xb6, 0x2f, 0x00, 0xf7, 0x7a, 0x3e, 0x5e,
+    0x97, 0xa2, 0xcc, 0xdb, 0xd1, 0x62, 0x5d, 0x50, 0xe5, 0x0a, 0xfc, 0x44, 0x94, 0x51, 0xe0, 0x1e,
+    0x8c, 0x4b, 0xb0, 0x36, 0xe4, 0x5a, 0x91, 0xe3, 0x67, 0xb9, 0xab, 0xd2, 0x6e, 0xb0, 0xa8, 0x7a,
+    0x99, 0x48, 0xc2, 0x18, 0x6c, 0xfd, 0x8d, 0xcc, 0xd2, 0x46, 0x62, 0x98, 0x08, 0xeb, 0xe0, 0xcd,
+    0x55, 0x2c, 0x35, 0x5f, 0x47, 0x81, 0xa8, 0xc1, 0x04, 0x08, 0x3c, 0x6b, 0xf8, 0x16, 0x9f, 0xa6,
+    0x94, 0xc9, 0xaa, 0x57, 0x74, 0x9a, 0xbb, 0x99, 0x9b, 0xa3, 0xee, 0x3b, 0x1e, 0xa8, 0xd9, 0x77,
+    0x7f, 0xcb, 0x8f, 0xb7, 0x70, 0x49, 0xbb, 0x43, 0x8b, 0x0d, 0x2b, 0xf7, 0x57, 0xb2, 0xc7, 0xbb,
+    0x8f, 0x5b, 0xf9, 0x41, 0xc3, 0xf0, 0x0e, 0xcb, 0x5c, 0xe8, 0x1e, 0x7b, 0x15, 0xb5, 0xe6, 0x0e,
+    0x38, 0x6c, 0x2d, 0x2c, 0x9a, 0x1e, 0x6b, 0x15, 0x1d, 0xcf, 0xdd, 0x69, 0x18, 0xb6, 0xf3, 0xc2,
+    0x92, 0xce, 0x7a, 0xfc, 0x75, 0xd8, 0x9a, 0x5f, 0xc1, 0xc3, 0xee, 0x85, 0x90, 0xd8, 0x63, 0xae,
+    0xa2, 0xd6, 0xdb, 0x01, 0x87, 0xad, 0xf0, 0x52, 0x98, 0x3e, 0xed, 0x36, 0x6b, 0xbd, 0x5d, 0x74,
+    0x58, 0xbc, 0x06, 0x70, 0x17, 0xaa, 0xc7, 0x5c, 0x87, 0xad, 0xfa, 0x15, 0x3c, 0xec, 0x4e, 0x51,
+    0xe6, 0x3d, 0xe6, 0x2a, 0x6a, 0xbd, 0x1d, 0xf0, 0xc0, 0x1a, 0x9b, 0xfd, 0xdb, 0xf6, 0xf9, 0x07,
+};
+
+const uint8_t indexHtmlFile[INDEX_HTML_FILE_SIZE] = {
+    0xad, 0x92, 0xdd, 0x6e, 0xd3, 0x30, 0x14, 0xc7, 0xef, 0x79, 0x0a, 0xe3, 0x1b, 0x86, 0x44, 0x1a,
+    0x26, 0x24, 0x04, 0xac, 0xa9, 0x34, 0x8d, 0xaf, 0x89, 0xc1, 0x90, 0x56, 0x84, 0xb8, 0x3c, 0x71,
+    0x4e, 0x17, 0xaf, 0x4e, 0x1c, 0xec, 0x93, 0x8c, 0xf0, 0x22, 0x3c, 0x10, 0x2f, 0x86, 0x9d, 0xb4,
+    0x89, 0x57, 0x05, 0x41, 0x29, 0x37, 0x3d, 0x3d, 0x1f, 0xff, 0xdf, 0xdf, 0xc7, 0xce, 0xfc, 0xfe,
+    0xcb, 0xcb, 0xb3, 0xe5, 0x97, 0x8f, 0xaf, 0xd8, 0xdb, 0xe5, 0xfb, 0x8b, 0xc5, 0xbd, 0x79, 0x4e,
+    0x85, 0xf2, 0x01, 0x21, 0x73, 0xa1, 0x40, 0x02, 0x96, 0x13, 0x55, 0x11, 0x7e, 0xad, 0x65, 0x93,
+    0xf0, 0x33, 0x5d, 0x12, 0x96, 0x14, 0x2d, 0xdb, 0x0a, 0x39, 0x13, 0x7d, 0x96, 0x70, 0xc2, 0x6f,
+    0x14, 0x7b, 0xe9, 0x09, 0x13, 0x39, 0x18, 0x8b, 0x94, 0xd4, 0xb4, 0x8a, 0x9e, 0xf1, 0x2d, 0xa3,
+    0x84, 0x02, 0x13, 0xde, 0x48, 0xbc, 0xad, 0xb4, 0xa1, 0x40, 0x79, 0x2b, 0x33, 0xca, 0x93, 0x0c,
+    0x1b, 0x29, 0x30, 0xea, 0x92, 0x47, 0x4c, 0x96, 0x92, 0x24, 0xa8, 0xc8, 0x0a, 0x50, 0x98, 0x1c,
+    0x7b, 0x08, 0x49, 0x52, 0xb8, 0xf8, 0x5c, 0xa3, 0xa1, 0x9c, 0xbd, 0x52, 0xb8, 0x26, 0xa3, 0x4b,
+    0xb9, 0x66, 0x28, 0xaf, 0xb4, 0x65, 0x67, 0xa0, 0xda, 0xca, 0xea, 0x79, 0xdc, 0x8f, 0xdd, 0x9b,
+    0x2b, 0x59, 0xae, 0x99, 0x41, 0x95, 0x70, 0x4b, 0xad, 0x42, 0x9b, 0x23, 0x3a, 0x53, 0x72, 0x87,
+    0xde, 0x9c, 0x55, 0x58, 0xcb, 0x59, 0x6e, 0x70, 0x95, 0x70, 0xf7, 0x37, 0x4e, 0xb5, 0x26, 0x4b,
+    0x06, 0xaa, 0x59, 0x21, 0xcb, 0x99, 0x6f, 0xfe, 0x03, 0xa4, 0x9b, 0xda, 0x8a, 0xad, 0x30, 0xb2,
+    0xa2, 0x70, 0xfa, 0x06, 0x1a, 0xe8, 0xab, 0x9c, 0x59, 0x23, 0x12, 0x7e, 0x63, 0xe3, 0x9b, 0xaf,
+    0x6e, 0xa3, 0x36, 0x7a, 0x32, 0x7b, 0x3a, 0x7b, 0xdc, 0x59, 0xdf, 0x38, 0xf1, 0x3c, 0xee, 0xc7,
+    0xfe, 0x9a, 0x72, 0x8d, 0x25, 0x1a, 0x50, 0xbb, 0xe2, 0x78, 0xf3, 0x88, 0xa9, 0xce, 0x5a, 0x17,
+    0x32, 0xd9, 0x30, 0xa1, 0xc0, 0x5a, 0x77, 0xe9, 0x6e, 0xd3, 0x0a, 0x0d, 0xbf, 0x5b, 0xf5, 0xe3,
+    0xae, 0xc8, 0x64, 0x96, 0xf0, 0x02, 0x64, 0x39, 0xd9, 0x3e, 0x2f, 0x39, 0xd3, 0xa5, 0x50, 0x52,
+    0xac, 0x13, 0xae, 0x2b, 0x2c, 0x3f, 0x40, 0x73, 0xf4, 0x70, 0x67, 0xd4, 0xe8, 0xdb, 0x9d, 0x8a,
+    0xd0, 0x2a, 0x2a, 0xb2, 0xe8, 0x09, 0x2b, 0xb0, 0xac, 0x97, 0xba, 0xf2, 0x07, 0x75, 0xed, 0xc9,
+    0xa1, 0xe7, 0x5e, 0x9b, 0x1f, 0x2f, 0x36, 0xaf, 0xca, 0x3e, 0x5f, 0x9c, 0x7e, 0x60, 0x85, 0xce,
+    0x6a, 0x85, 0x6e, 0xa7, 0x63, 0xbf, 0x59, 0x2f, 0x9d, 0x0c, 0x9e, 0xd7, 0x6d, 0xd0, 0x5e, 0xc9,
+    0x0c, 0x53, 0x70, 0x0b, 0x6d, 0xf0, 0x76, 0x9b, 0xeb, 0xb2, 0xd0, 0xb5, 0x45, 0x85, 0xd0, 0xb8,
+    0x6b, 0x15, 0x4a, 0x5b, 0x1c, 0xb6, 0x80, 0xcd, 0x83, 0x8e, 0xf7, 0xfc, 0xa2, 0xd1, 0x32, 0x3b,
+    0x7a, 0xfc, 0xf0, 0x64, 0x00, 0x75, 0x8a, 0x94, 0xc2, 0x9b, 0x08, 0x21, 0x3f, 0x7f, 0xcc, 0x63,
+    0xf8, 0x13, 0x6a, 0xf7, 0x0e, 0xdd, 0x37, 0xed, 0xae, 0x86, 0x8e, 0x1e, 0xa4, 0x60, 0xf1, 0xb5,
+    0x81, 0x02, 0x1f, 0x38, 0xd4, 0x5b, 0x5d, 0xe0, 0x21, 0x30, 0x8b, 0x44, 0xb2, 0xbc, 0xb6, 0x03,
+    0xf0, 0x6a, 0x53, 0x38, 0x04, 0xaa, 0x09, 0x06, 0xde, 0xe5, 0xf2, 0xf4, 0x10, 0xd4, 0x75, 0x25,
+    0xf5, 0xc0, 0x7a, 0xf3, 0xf1, 0xfc, 0xf2, 0x10, 0x98, 0x7b, 0x52, 0x33, 0xc0, 0x3e, 0xb9, 0x84,
+    0xd9, 0xff, 0xb0, 0xad, 0xa8, 0x2d, 0xe9, 0x62, 0xe0, 0x9e, 0x75, 0xe9, 0x21, 0xc0, 0x95, 0x54,
+    0xe3, 0x03, 0xbf, 0x76, 0x09, 0xab, 0x2b, 0xa5, 0x21, 0x3b, 0x84, 0x09, 0xdf, 0x6b, 0x33, 0x42,
+    0x4f, 0x7d, 0x76, 0x08, 0x6e, 0x0d, 0x20, 0x35, 0x0d, 0xbc, 0x77, 0x00, 0xe7, 0x7a, 0x79, 0x08,
+    0x30, 0x47, 0x55, 0x8d, 0xc7, 0x4b, 0x75, 0x4d, 0x3d, 0x2d, 0xce, 0x64, 0xe3, 0x82, 0xfb, 0x65,
+    0x42, 0x81, 0xb5, 0x09, 0x17, 0xba, 0x24, 0x27, 0xb9, 0xaa, 0x5c, 0x9a, 0xf3, 0xbb, 0xbd, 0x95,
+    0x27, 0x70, 0x26, 0xb3, 0x84, 0xa7, 0x60, 0xfb, 0x7d, 0x39, 0xb3, 0xd4, 0x2a, 0x4c, 0x78, 0x26,
+    0xad, 0xd3, 0xb4, 0x2f, 0x58, 0xaa, 0xb4, 0x58, 0x9f, 0x78, 0xa9, 0xec, 0x04, 0xdd, 0xbc, 0x0c,
+    0x05, 0x46, 0xf4, 0x80, 0x59, 0x4e, 0x85, 0xe2, 0x2c, 0x03, 0x82, 0x68, 0xa7, 0xb8, 0x98, 0xc7,
+    0xbd, 0x7a, 0xf2, 0x90, 0xc1, 0x41, 0x34, 0x41, 0x8f, 0xdd, 0xf1, 0x1b, 0xea, 0x01, 0xde, 0xd5,
+    0xf6, 0xa4, 0x6f, 0x3f, 0xe0, 0x49, 0x8b, 0xbb, 0xcd, 0xc0, 0x67, 0xdb, 0xd8, 0xd3, 0xec, 0xba,
+    0x92, 0x7a, 0xd2, 0x68, 0x6c, 0x04, 0x26, 0xbe, 0xb8, 0xa7, 0x41, 0x6d, 0xd1, 0x4c, 0x1a, 0x8c,
+    0x8d, 0xc0, 0xc0, 0x17, 0xff, 0x71, 0x13, 0x51, 0x5b, 0xd2, 0xc5, 0xa4, 0x55, 0xd8, 0x0a, 0xcc,
+    0xfa, 0xf2, 0x9e, 0x36, 0x2b, 0xa9, 0x70, 0xd2, 0x64, 0x6c, 0x04, 0x16, 0xbe, 0xb8, 0xa7, 0x01,
+    0x7c, 0xaf, 0xcd, 0xb4, 0x43, 0xd0, 0x09, 0x2c, 0xba, 0xea, 0x9e, 0x1e, 0x6b, 0x00, 0xf7, 0xb1,
+    0x4e, 0x9a, 0x84, 0xad, 0xc0, 0xa5, 0x2f, 0xef, 0x69, 0x93, 0xa3, 0xaa, 0x26, 0x4d, 0xc6, 0x46,
+    0x60, 0xe1, 0x8b, 0xbf, 0x35, 0x48, 0xcd, 0xf8, 0x7f, 0x1b, 0x52, 0x9d, 0xb5, 0x3e, 0x7a, 0xcd,
+    0xe2, 0x17,
+};
+
+const uint8_t kaaiotHtmlFile[KAAIOT_HTML_FILE_SIZE] = {
+    0xad, 0x52, 0xe1, 0x6e, 0xe2, 0x38, 0x10, 0x7e, 0x15, 0x5f, 0x7e, 0x15, 0x69, 0x49, 0xd8, 0xb6,
+    0xbb, 0x3a, 0xad, 0x00, 0x09, 0xb5, 0xbb, 0x52, 0xb5, 0xbd, 0x5b, 0xee, 0x80, 0xdb, 0x9f, 0x2b,
+    0xc7, 0x9e, 0x10, 0x83, 0x63, 0xbb, 0xb6, 0x03, 0xe4, 0xde, 0xea, 0x5e, 0xe1, 0x9e, 0xec, 0xc6,
+    0x49, 0x28, 0x50, 0xc1, 0xa9, 0x94, 0xfd, 0x91, 0x64, 0x32, 0x33, 0xdf, 0xcc, 0xf7, 0xcd, 0x4c,
+    0x3f, 0xf7, 0x85, 0x1c, 0xf6, 0x1d, 0xb3, 0xc2, 0x78, 0xe2, 0x2b, 0x03, 0x83, 0xc8, 0xc3, 0xc6,
+    0x27, 0x0b, 0xba, 0xa2, 0x8d, 0x37, 0x22, 0xce, 0xb2, 0x41, 0xb4, 0x70, 0xc9, 0xe2, 0xa9, 0x04,
+    0x5b, 0x75, 0x6f, 0xe2, 0x8f, 0x71, 0x2f, 0x2e, 0x84, 0x8a, 0x17, 0x2e, 0x1a, 0xf6, 0x93, 0x26,
+    0xed, 0xb5, 0x45, 0x1c, 0x78, 0x2f, 0xd4, 0xdc, 0xbd, 0x09, 0x3c, 0x07, 0x05, 0x96, 0xca, 0x17,
+    0x58, 0x29, 0xd4, 0x92, 0x58, 0x90, 0x83, 0xc8, 0xf9, 0x4a, 0x82, 0xcb, 0x01, 0x10, 0xb3, 0x57,
+    0x8a, 0x39, 0x17, 0x91, 0xdc, 0x42, 0x36, 0x88, 0xd0, 0x4c, 0x52, 0xad, 0xbd, 0xf3, 0x96, 0x9a,
+    0x5a, 0x44, 0x08, 0x9e, 0x5f, 0xa3, 0xce, 0x6a, 0xb1, 0xa9, 0xe6, 0x15, 0xd1, 0x4a, 0x6a, 0xca,
+    0x31, 0x98, 0x3e, 0xe2, 0xf7, 0xaa, 0x83, 0xfe, 0x4c, 0xdb, 0x82, 0x08, 0xf4, 0x2d, 0x29, 0x15,
+    0xda, 0x77, 0xc3, 0x3f, 0xba, 0xb9, 0x58, 0x11, 0x26, 0xa9, 0x73, 0x83, 0x88, 0x4a, 0xb0, 0x9e,
+    0xd4, 0xef, 0xae, 0x2b, 0x19, 0x03, 0xe7, 0xda, 0x3f, 0x2e, 0x5c, 0x21, 0x9c, 0xa3, 0xa9, 0x84,
+    0x23, 0x90, 0x35, 0x92, 0x37, 0x60, 0xd1, 0x07, 0xd4, 0x66, 0x62, 0x73, 0x24, 0x85, 0x69, 0xe5,
+    0x41, 0x79, 0x8c, 0xe4, 0xb7, 0xc3, 0x07, 0x95, 0xe9, 0x5f, 0xfa, 0x09, 0x5a, 0x53, 0x4d, 0x4a,
+    0x13, 0x98, 0x12, 0x4a, 0xbe, 0x52, 0xfa, 0xa0, 0xa7, 0x04, 0x33, 0x33, 0x31, 0x2f, 0x2d, 0xf5,
+    0x42, 0xab, 0x77, 0x24, 0x13, 0x52, 0x12, 0x5d, 0xe2, 0x2e, 0x72, 0x20, 0xb5, 0x84, 0x14, 0xa4,
+    0x5e, 0xc7, 0xfd, 0x04, 0x5b, 0x0c, 0x0f, 0xde, 0x7b, 0x3d, 0x73, 0xa0, 0x1c, 0xec, 0x83, 0x9a,
+    0x94, 0xe9, 0x21, 0x19, 0x57, 0xa6, 0x53, 0xe1, 0x83, 0x8a, 0xb6, 0xdd, 0xdd, 0x7e, 0x3b, 0x32,
+    0xab, 0xc9, 0x9c, 0xaa, 0xca, 0xc2, 0x14, 0x05, 0x48, 0x8e, 0x57, 0xb3, 0xf5, 0x05, 0xed, 0x13,
+    0x60, 0x01, 0x1d, 0xf6, 0x06, 0x78, 0x13, 0x7c, 0xf8, 0x19, 0xc5, 0xda, 0xad, 0xa0, 0x7b, 0x58,
+    0x09, 0x06, 0x87, 0x8d, 0xfa, 0x49, 0x9b, 0xb9, 0x5f, 0xde, 0xea, 0x35, 0x29, 0xd2, 0xee, 0x4d,
+    0xa8, 0x43, 0x51, 0xe5, 0xd6, 0x1f, 0x54, 0x77, 0x6b, 0x4f, 0x84, 0x03, 0x5b, 0x42, 0x40, 0x87,
+    0xbf, 0x21, 0xe9, 0x0b, 0x65, 0x4a, 0x7f, 0x90, 0x17, 0x06, 0x6d, 0xb5, 0xdc, 0x3f, 0x96, 0xa8,
+    0xde, 0xba, 0x0f, 0xc8, 0x88, 0x14, 0x74, 0x23, 0x41, 0xcd, 0x7d, 0x3e, 0x88, 0x3e, 0xf4, 0x22,
+    0xbc, 0xb1, 0xa7, 0x52, 0x58, 0xe0, 0x47, 0xd4, 0xbe, 0x86, 0xce, 0xc8, 0x18, 0x29, 0x58, 0x33,
+    0xbb, 0xbf, 0xc0, 0xba, 0x46, 0xda, 0xf9, 0xe4, 0xf0, 0x7e, 0x5a, 0xf8, 0x01, 0xc3, 0xdb, 0xcb,
+    0x19, 0xfe, 0xf6, 0xc7, 0x74, 0x4a, 0x26, 0x60, 0x57, 0x60, 0xdf, 0xc4, 0xac, 0x78, 0xf2, 0xbe,
+    0x81, 0x1f, 0x30, 0x7b, 0xdf, 0x43, 0x6a, 0x46, 0x52, 0x06, 0xb9, 0x96, 0x78, 0x6a, 0x4d, 0x62,
+    0xcc, 0xa4, 0x2e, 0x79, 0xbc, 0xa4, 0x54, 0x68, 0xfc, 0xd1, 0xc5, 0xc5, 0xf4, 0x27, 0xbf, 0x4f,
+    0xc7, 0x97, 0xd0, 0x77, 0xca, 0x9b, 0x57, 0xd1, 0xef, 0xc5, 0x1c, 0x62, 0xa3, 0xb5, 0x8c, 0x11,
+    0x11, 0x6b, 0x3b, 0xbf, 0x98, 0xfa, 0x54, 0x14, 0xf0, 0xb7, 0x56, 0x70, 0x35, 0x9b, 0xde, 0x91,
+    0x7f, 0xff, 0x21, 0x85, 0x50, 0xa5, 0x07, 0xd7, 0x39, 0x43, 0x87, 0x2a, 0x8b, 0x34, 0x30, 0xaf,
+    0xef, 0xb7, 0x2d, 0x77, 0xa0, 0xe3, 0xe6, 0x85, 0x8a, 0x8f, 0x97, 0x1f, 0xcc, 0x77, 0xf1, 0x45,
+    0x90, 0xc9, 0xe4, 0xe1, 0xfe, 0x4d, 0xf3, 0x5e, 0x8b, 0x4c, 0x4c, 0x9c, 0xe0, 0x3f, 0xfb, 0x8c,
+    0x1b, 0x56, 0xc0, 0x4a, 0x2b, 0x7c, 0x45, 0xa6, 0xd8, 0x75, 0x47, 0xcf, 0x81, 0x04, 0x76, 0x82,
+    0xdf, 0x33, 0xa7, 0x16, 0x1a, 0x90, 0xfb, 0x64, 0xb4, 0xf1, 0x42, 0x2b, 0xb2, 0xa2, 0xb2, 0x44,
+    0x1d, 0xbd, 0x68, 0xf8, 0xcd, 0x80, 0xea, 0x27, 0x8d, 0xfb, 0x65, 0xf8, 0x3d, 0xf2, 0xf8, 0x3c,
+    0x3e, 0x15, 0xbd, 0xae, 0xa3, 0x64, 0x92, 0x53, 0xac, 0x7c, 0x2a, 0x09, 0x45, 0x7e, 0x1f, 0x8f,
+    0x7e, 0xe0, 0x73, 0x7d, 0x2a, 0xe5, 0xb6, 0x4e, 0xb9, 0xfe, 0x31, 0x7e, 0x9c, 0x4d, 0x4e, 0xe5,
+    0x7c, 0xa8, 0x73, 0x6e, 0x76, 0xe1, 0xa4, 0x19, 0xc2, 0x4f, 0x99, 0xee, 0x57, 0xa8, 0xce, 0xd8,
+    0xbd, 0xc1, 0xc8, 0x5a, 0x5b, 0xbe, 0x9b, 0x35, 0xe2, 0x2f, 0x5a, 0x3f, 0x76, 0x69, 0x5a, 0x7d,
+    0x11, 0x12, 0x97, 0x75, 0x84, 0xef, 0x48, 0x62, 0x16, 0x06, 0x1d, 0xb9, 0xba, 0x87, 0x95, 0x60,
+    0x40, 0x18, 0x58, 0x8f, 0xad, 0x19, 0xf5, 0x40, 0xae, 0x96, 0x94, 0x72, 0x58, 0x05, 0x57, 0xe7,
+    0x1d, 0xe1, 0x4d, 0xc2, 0x12, 0xaa, 0x6d, 0x00, 0xcd, 0x0e, 0xa1, 0x8a, 0x93, 0x3f, 0xb5, 0xf6,
+    0xe4, 0x6e, 0x54, 0xfb, 0x2d, 0xda, 0x8c, 0x76, 0x3a, 0x67, 0x28, 0xcf, 0x6a, 0x7a, 0x41, 0x75,
+    0xb0, 0xba, 0x75, 0x3e, 0x0a, 0x2f, 0xa5, 0x17, 0x46, 0x62, 0x7c, 0x6b, 0x45, 0xff, 0x2f, 0x7a,
+    0xcf, 0xcb, 0xb4, 0xec, 0x16, 0xbc, 0x7b, 0x4b, 0x74, 0x96, 0x39, 0xf0, 0xc1, 0xfe, 0x15, 0x33,
+    0x1a, 0x26, 0x8a, 0x16, 0x58, 0x74, 0x66, 0xa4, 0xa6, 0x7c, 0x4b, 0xc1, 0x95, 0x69, 0x21, 0xb0,
+    0x69, 0x7b, 0x16, 0xb3, 0xf1, 0xe3, 0xb7, 0xd1, 0xfd, 0xf3, 0xc8, 0x52, 0xaf, 0x08, 0x3e, 0x5d,
+    0x63, 0x45, 0x41, 0x2d, 0x2e, 0xc5, 0xf9, 0x2a, 0x10, 0xcb, 0x41, 0xcc, 0x73, 0xff, 0xe9, 0xb6,
+    0x67, 0x36, 0xcf, 0xdc, 0x8e, 0x31, 0xc4, 0x60, 0xf9, 0x7c, 0x2f, 0x52, 0x38, 0xdf, 0x9d, 0x5b,
+    0x5d, 0x9a, 0x3d, 0xcd, 0xb5, 0x93, 0x0b, 0x67, 0x24, 0xad, 0x42, 0xa9, 0x52, 0x1e, 0xab, 0x04,
+    0x0e, 0x27, 0xd1, 0xa0, 0xb6, 0x76, 0xcb, 0xa4, 0x85, 0x7e, 0x22, 0x4a, 0xab, 0xdd, 0x9c, 0x92,
+    0x4c, 0x80, 0xe4, 0x38, 0x80, 0x9d, 0x03, 0xc7, 0x8f, 0x9f, 0x54, 0xf3, 0x6a, 0xd8, 0x77, 0xcc,
+    0x0a, 0xe3, 0xdb, 0x09, 0x78, 0xd8, 0xf8, 0x64, 0x41, 0x57, 0xb4, 0xf1, 0x62, 0x65, 0xcb, 0x06,
+    0xd1, 0xc2, 0x25, 0xb8, 0x53, 0xa1, 0x7d, 0xbc, 0x70, 0xa1, 0x6c, 0x13, 0x44, 0x23, 0xf7, 0x85,
+    0x1c, 0xfe, 0x07,
+};
+
+const uint8_t kaaiotJsFile[KAAIOT_JS_FILE_SIZE] = {
+    0xb5, 0x52, 0x5d, 0x6f, 0xdb, 0x46, 0x10, 0x7c, 0xf7, 0xaf, 0xb8, 0xb0, 0x01, 0x78, 0x82, 0x29,
+    0x36, 0x0d, 0xfa, 0x64, 0x57, 0x2d, 0xe0, 0x4a, 0x46, 0xdc, 0x3a, 0x76, 0x11, 0x39, 0x45, 0x01,
+    0xc3, 0x28, 0xce, 0xe4, 0x52, 0xba, 0xfa, 0x78, 0xc7, 0xdc, 0x87, 0x12, 0x36, 0xc9, 0x7f, 0xef,
+    0x2e, 0x45, 0x52, 0x94, 0xac, 0x4a, 0x2f, 0xed, 0x83, 0xad, 0xe3, 0xdd, 0xcc, 0xec, 0xec, 0xee,
+    0xf0, 0x22, 0xe8, 0xcc, 0x4b, 0xa3, 0xf9, 0x88, 0x7d, 0x3e, 0x59, 0x09, 0xcb, 0x0a, 0x63, 0x4b,
+    0x36, 0x61, 0xb9, 0xc9, 0x42, 0x09, 0xda, 0xa7, 0x0b, 0xf0, 0x33, 0x05, 0x74, 0xbc, 0xa8, 0xaf,
+    0x72, 0x1e, 0x3f, 0x09, 0x21, 0x8d, 0x1f, 0x13, 0x2c, 0x1e, 0x9d, 0xaf, 0x29, 0x52, 0xc1, 0x95,
+    0xae, 0x82, 0x3f, 0xc4, 0x23, 0xd0, 0x58, 0x12, 0x6a, 0x48, 0xbb, 0x96, 0xce, 0x4f, 0xa5, 0xab,
+    0x94, 0xa8, 0x8f, 0x92, 0x15, 0x62, 0xc7, 0xf9, 0x1a, 0x4c, 0x1a, 0x64, 0x21, 0x15, 0x79, 0x3e,
+    0x5b, 0x21, 0x8e, 0x84, 0x40, 0x83, 0xe5, 0xb1, 0x0b, 0x8f, 0xa5, 0xf4, 0x71, 0xc2, 0xfa, 0xd6,
+    0x60, 0xa5, 0x3d, 0xb5, 0x47, 0xbf, 0x69, 0x65, 0x81, 0xf0, 0x53, 0x28, 0x44, 0x50, 0x9e, 0xb7,
+    0x5e, 0xb0, 0xab, 0x1c, 0x56, 0x99, 0xd1, 0x05, 0xda, 0xf8, 0x7c, 0xe2, 0xcd, 0x13, 0xe8, 0xb3,
+    0x7f, 0xf7, 0xd3, 0xbc, 0xc7, 0xa3, 0x74, 0x25, 0x54, 0x80, 0xe4, 0x44, 0x54, 0xd5, 0xef, 0x60,
+    0x1d, 0xd6, 0x3a, 0xc0, 0xd9, 0x80, 0x36, 0xc4, 0xf2, 0x83, 0xf7, 0x73, 0xb0, 0x2b, 0xb0, 0x07,
+    0x88, 0x1b, 0xd0, 0x86, 0xe8, 0xb4, 0xaf, 0x8e, 0x12, 0x37, 0xa0, 0x0d, 0xd1, 0xcb, 0x12, 0xfe,
+    0x36, 0x1a, 0x0e, 0x35, 0xd7, 0x42, 0x36, 0xa4, 0x8f, 0xb2, 0x90, 0x73, 0x27, 0xf3, 0x03, 0xa4,
+    0x0e, 0xb2, 0x43, 0x82, 0x2c, 0x58, 0xe9, 0xeb, 0xbb, 0xba, 0x82, 0x63, 0xe4, 0x01, 0x74, 0x5b,
+    0xe4, 0x57, 0xa8, 0x8f, 0x70, 0x11, 0xd1, 0x51, 0x4e, 0xbe, 0xae, 0x17, 0xfa, 0x97, 0x33, 0xfa,
+    0x12, 0x53, 0x83, 0xeb, 0xcc, 0x2c, 0x08, 0x0f, 0xbf, 0xcc, 0x6f, 0x6f, 0xe8, 0x82, 0x6f, 0x56,
+    0x8d, 0xbb, 0x77, 0xa0, 0xf3, 0xe6, 0xb6, 0xc3, 0x53, 0xae, 0xda, 0x5c, 0xa6, 0x18, 0xb0, 0x99,
+    0xc8, 0x96, 0xbc, 0x0f, 0x12, 0xbd, 0x50, 0x90, 0x7a, 0x56, 0xb1, 0x66, 0x7c, 0x6d, 0xff, 0x86,
+    0xa9, 0xc6, 0xc2, 0xf7, 0x0f, 0xeb, 0x2b, 0x8b, 0x70, 0xb0, 0x97, 0xed, 0x43, 0xc2, 0x3a, 0xfa,
+    0xba, 0xd4, 0x95, 0xae, 0x82, 0xdf, 0x93, 0xe3, 0x6c, 0x29, 0xf4, 0x02, 0xf6, 0xe5, 0x78, 0xa7,
+    0x04, 0xda, 0x64, 0x9c, 0xea, 0x48, 0xbc, 0x78, 0x75, 0x8e, 0x3f, 0x3f, 0xb0, 0x8d, 0x30, 0x9d,
+    0x5c, 0xaa, 0x40, 0x2f, 0xfc, 0x12, 0xdf, 0x4e, 0x4f, 0x87, 0x0a, 0x69, 0x15, 0xdc, 0x92, 0xef,
+    0x80, 0xef, 0xe5, 0x03, 0xf5, 0x73, 0xb2, 0x6d, 0x9b, 0xb7, 0x3d, 0x6e, 0xdf, 0x62, 0xc5, 0xde,
+    0xde, 0x50, 0x78, 0x2a, 0x5d, 0xa5, 0x44, 0x9d, 0x4a, 0x8d, 0xbd, 0xbc, 0xb9, 0x7b, 0x7b, 0x8d,
+    0xc0, 0x38, 0x3e, 0x36, 0xdb, 0x84, 0x49, 0x14, 0xff, 0x44, 0x42, 0xdd, 0x28, 0x5b, 0xa1, 0x99,
+    0x42, 0x81, 0x3e, 0x03, 0xeb, 0x8d, 0xb6, 0x31, 0xe0, 0xb1, 0x92, 0x71, 0xbb, 0xb6, 0x1e, 0x9d,
+    0x66, 0x4a, 0x38, 0xd7, 0x54, 0xc2, 0xc9, 0x12, 0xc4, 0xf9, 0xf1, 0xc2, 0x9a, 0x50, 0x8d, 0xa5,
+    0x87, 0xf2, 0x39, 0x5e, 0xe6, 0xd4, 0x0a, 0x5e, 0xa5, 0x5a, 0x94, 0xf0, 0xec, 0x75, 0xd0, 0xc6,
+    0x0e, 0x68, 0xd8, 0xad, 0xa8, 0x2a, 0x9c, 0xce, 0xcf, 0x4b, 0xa9, 0x72, 0xbe, 0x25, 0xd0, 0x65,
+    0x04, 0x29, 0x6d, 0xbf, 0xbb, 0xa9, 0xcc, 0x85, 0x17, 0x5d, 0xdf, 0x94, 0xc5, 0xb9, 0xb7, 0x52,
+    0x2f, 0xb0, 0x1c, 0x21, 0x52, 0xd7, 0x7c, 0xc9, 0xa2, 0x6e, 0x70, 0x09, 0xd3, 0x41, 0xa9, 0x84,
+    0xbd, 0x6e, 0x23, 0xf7, 0xa8, 0xcc, 0x23, 0x22, 0x35, 0x7c, 0x64, 0x17, 0x78, 0xe4, 0xf7, 0x1b,
+    0x81, 0x87, 0x04, 0x35, 0x7d, 0x5d, 0xc1, 0x19, 0x8b, 0xd1, 0x9d, 0x92, 0x99, 0xa0, 0xea, 0xdf,
+    0x12, 0x22, 0xde, 0xca, 0x6c, 0x2b, 0xd0, 0x98, 0xb9, 0x27, 0x45, 0xa4, 0x46, 0x4f, 0x42, 0xe4,
+    0xb0, 0xca, 0x8c, 0x2e, 0x52, 0x62, 0x44, 0x47, 0xd5, 0x2c, 0xf8, 0x60, 0x75, 0x23, 0x48, 0x11,
+    0xea, 0xbb, 0xed, 0x22, 0xdf, 0x8c, 0xa5, 0xdf, 0xaf, 0xb1, 0xe5, 0x14, 0xfb, 0xe9, 0x4a, 0xb7,
+    0x9f, 0xbc, 0x75, 0x65, 0xe1, 0x43, 0x80, 0x26, 0x62, 0xf4, 0xfa, 0xc7, 0xdb, 0xeb, 0x37, 0xde,
+    0x57, 0xef, 0xd6, 0x97, 0xbc, 0xa9, 0xd5, 0x1c, 0x53, 0xa3, 0x71, 0x94, 0x79, 0xed, 0x3c, 0xce,
+    0x33, 0x5b, 0x0a, 0xbd, 0xa0, 0x5e, 0x30, 0x8d, 0x93, 0x1f, 0xb1, 0x8e, 0x2c, 0x18, 0xef, 0x80,
+    0x0d, 0x6c, 0x4e, 0x30, 0x36, 0x99, 0x4c, 0x76, 0x14, 0xd3, 0xe9, 0xed, 0xcd, 0x6c, 0x98, 0xbc,
+    0x1b, 0x5c, 0x31, 0x0e, 0x11, 0xb5, 0xa2, 0x6f, 0x22, 0x76, 0xca, 0x36, 0x2a, 0xae, 0x32, 0xda,
+    0xc1, 0xfb, 0x77, 0xd7, 0xa9, 0x0b, 0x8f, 0xeb, 0xd5, 0xf0, 0x7d, 0xaf, 0x4d, 0x98, 0x6f, 0x0b,
+    0x1e, 0x4f, 0xe2, 0x11, 0x0a, 0x7c, 0x87, 0x9e, 0x87, 0x76, 0xc8, 0x70, 0x70, 0x8d, 0x95, 0xd7,
+    0xaf, 0x5e, 0xb1, 0x2f, 0x5f, 0xd8, 0xde, 0x97, 0xef, 0x47, 0xcf, 0xda, 0x58, 0x97, 0xb8, 0x83,
+    0x4f, 0x9e, 0xbd, 0x40, 0x7b, 0x11, 0x21, 0x5e, 0xf2, 0x98, 0x5e, 0x82, 0xf2, 0xf1, 0x28, 0x5d,
+    0xfa, 0x52, 0xed, 0xc5, 0x53, 0x08, 0x19, 0x28, 0x07, 0x7b, 0x19, 0xd1, 0x3c, 0x64, 0x19, 0x38,
+    0x77, 0xc6, 0x86, 0x0d, 0xb7, 0x6e, 0x4e, 0x59, 0xb4, 0xef, 0xbe, 0x55, 0x7d, 0xc9, 0x07, 0x33,
+    0x6b, 0xe5, 0xf6, 0xdd, 0xd1, 0x20, 0x22, 0x36, 0x66, 0xa1, 0x52, 0x06, 0xb3, 0x95, 0xa7, 0x11,
+    0x59, 0x3a, 0x68, 0x6a, 0x66, 0xad, 0xb1, 0xff, 0xbf, 0x23, 0xa0, 0x32, 0x49, 0xb3, 0x7a, 0xa6,
+    0x8d, 0xef, 0x1d, 0xbe, 0x68, 0x1d, 0x6e, 0x5b, 0xcb, 0x9c, 0xe3, 0x71, 0x2e, 0x5d, 0xa5, 0x44,
+    0x1d, 0x27, 0x2c, 0x7e, 0x54, 0x26, 0x7b, 0x8a, 0x09, 0x39, 0x0c, 0x66, 0xa3, 0x39, 0x48, 0x63,
+    0x86, 0x7b, 0x30, 0x0a, 0x52, 0x65, 0x16, 0x3c, 0xba, 0x14, 0x58, 0x2a, 0x67, 0xde, 0xb4, 0xa5,
+    0x18, 0xbe, 0x16, 0x72, 0x11, 0xac, 0xf0, 0xd2, 0xe8, 0xa8, 0x69, 0xe1, 0xbf, 0x1a, 0x46, 0x6e,
+    0xb2, 0x50, 0x82, 0xf6, 0xe9, 0x02, 0xfc, 0x4c, 0x01, 0x1d, 0x2f, 0xea, 0xab, 0x9c, 0xc7, 0xbd,
+    0xbc, 0xf3, 0x35, 0x1a, 0x6b, 0x3b, 0x42, 0xcb, 0x6d, 0x47, 0x4d, 0x43, 0x85, 0xb1, 0xe5, 0x54,
+    0x78, 0x91, 0x3a, 0xf0, 0x3c, 0xa6, 0x09, 0xc5, 0xeb, 0x41, 0xa1, 0xf2, 0x4a, 0x58, 0x56, 0x05,
+    0xff, 0x67, 0xb0, 0x12, 0x59, 0x11, 0xdd, 0xfe, 0x44, 0xff, 0x34, 0x0e, 0x79, 0x42, 0x7e, 0xe8,
+    0x23, 0xa5, 0xaf, 0xc1, 0x60, 0x2a, 0xd0, 0x3c, 0xfa, 0xed, 0xfd, 0x5d, 0x94, 0x74, 0xdc, 0x84,
+    0x79, 0x1b, 0x48, 0xaf, 0xb7, 0x0f, 0x3a, 0xe7, 0x6d, 0x0d, 0x9c, 0xfe, 0x88, 0x8f, 0xce, 0xff,
+    0x01,
+};
@@ -0,0 +1,64 @@
+/**
+ * \file
+ * \brief Web files written to Calypso, compressed with raw DEFLATE.
+ *
+ * Generated by GW/scripts/web_assets.py from GW/web, do not edit.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef P_N_P_WEB_ASSETS_H
+#define P_N_P_WEB_ASSETS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*Window of the compressor, the inflater needs as many bytes*/
+#define WEB_ASSETS_WINDOW_BITS 10
+
+/*index_src.html: 2441 bytes, 688 compressed*/
+#define INDEX_HTML_SRC_FILE_LENGTH 2441
+#define INDEX_HTML_SRC_FILE_SIZE 688
+    extern const uint8_t indexHtmlSrcFile[INDEX_HTML_SRC_FILE_SIZE];
+
+/*index.html: 2773 bytes, 754 compressed*/
+#define INDEX_HTML_FILE_LENGTH 2773
+#define INDEX_HTML_FILE_SIZE 754
+    extern const uint8_t indexHtmlFile[INDEX_HTML_FILE_SIZE];
+
+/*kaaiot.html: 2919 bytes, 931 compressed*/
+#define KAAIOT_HTML_FILE_LENGTH 2919
+#define KAAIOT_HTML_FILE_SIZE 931
+    extern const uint8_t kaaiotHtmlFile[KAAIOT_HTML_FILE_SIZE];
+
+/*js/kaaiot.js: 2733 bytes, 993 compressed*/
+#define KAAIOT_JS_FILE_LENGTH 2733
+#define KAAIOT_JS_FILE_SIZE 993
+    extern const uint8_t kaaiotJsFile[KAAIOT_JS_FILE_SIZE];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* P_N_P_WEB_ASSETS_H */
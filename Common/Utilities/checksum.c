@@ -0,0 +1,89 @@
+/**
+ * \file
+ * \brief Checksums of stored data.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "checksum.h"
+
+#define CHECKSUM_FNV1A_PRIME 16777619UL
+
+/* CRC-32 of IEEE 802.3 (zlib, PNG), reflected polynomial 0xEDB88320, one
+ * lookup per 4 bits: 64 bytes of table instead of 1 KB */
+static const uint32_t crc32Table[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL, 0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL, 0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL};
+
+/**
+ * @brief  Add data to a 32-bit FNV-1a hash, data given in several parts
+ *         gives the same hash as in one
+ * @param  hash CHECKSUM_FNV1A_INIT or the hash of the previous parts
+ * @param  data pointer to the data
+ * @param  length length of the data in bytes
+ * @retval Updated hash
+ */
+uint32_t Checksum_fnv1a(uint32_t hash, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= CHECKSUM_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief  Add a string and its terminator to a 32-bit FNV-1a hash, so that
+ *         moving characters between two strings changes the hash
+ * @param  hash CHECKSUM_FNV1A_INIT or the hash of the previous parts
+ * @param  string string to add
+ * @retval Updated hash
+ */
+uint32_t Checksum_fnv1aString(uint32_t hash, const char *string)
+{
+    return Checksum_fnv1a(hash, string, strlen(string) + 1);
+}
+
+/**
+ * @brief  Add data to a CRC-32, data given in several parts gives the same
+ *         CRC as in one
+ * @param  crc CHECKSUM_CRC32_INIT or the CRC of the previous parts
+ * @param  data pointer to the data
+ * @param  length length of the data in bytes
+ * @retval Updated CRC
+ */
+uint32_t Checksum_crc32(uint32_t crc, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ crc32Table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32Table[crc & 0x0F];
+    }
+    return ~crc;
+}
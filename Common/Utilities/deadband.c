@@ -0,0 +1,132 @@
+/**
+ * \file
+ * \brief Deadband filter for report-by-exception telemetry.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "deadband.h"
+
+/**
+ * @brief  Initialize a telemetry channel
+ * @param  channel pointer to the channel
+ * @param  absThreshold absolute change that triggers a report (0 to disable)
+ * @param  relThreshold relative change in 0.01 % that triggers a report (0 to disable)
+ * @retval None
+ */
+void Deadband_init(Deadband_Channel *channel, int32_t absThreshold, int32_t relThreshold)
+{
+    Deadband_setThresholds(channel, absThreshold, relThreshold);
+    Deadband_reset(channel);
+}
+
+/**
+ * @brief  Change the thresholds of a telemetry channel
+ * @param  channel pointer to the channel
+ * @param  absThreshold absolute change that triggers a report (0 to disable)
+ * @param  relThreshold relative change in 0.01 % that triggers a report (0 to disable)
+ * @retval None
+ */
+void Deadband_setThresholds(Deadband_Channel *channel, int32_t absThreshold, int32_t relThreshold)
+{
+    channel->absThreshold = (absThreshold > 0) ? absThreshold : 0;
+    channel->relThreshold = (relThreshold > 0) ? relThreshold : 0;
+}
+
+/**
+ * @brief  Check if a new value of the channel has to be reported
+ * @param  channel pointer to the channel
+ * @param  value current value of the channel
+ * @param  now current time in ms
+ * @param  heartbeat maximum time in ms without a report (0 to disable)
+ * @retval true if the value has to be reported false otherwise
+ */
+bool Deadband_isReportDue(const Deadband_Channel *channel, int32_t value, unsigned long now, unsigned long heartbeat)
+{
+    int64_t delta, reference;
+
+    if (!channel->reported)
+    {
+        return true;
+    }
+
+    if ((heartbeat > 0) && ((unsigned long)(now - channel->lastReportTime) >= heartbeat))
+    {
+        return true;
+    }
+
+    /* Without any threshold every value is reported */
+    if ((channel->absThreshold == 0) && (channel->relThreshold == 0))
+    {
+        return true;
+    }
+
+    delta = (int64_t)value - channel->lastReported;
+    if (delta < 0)
+    {
+        delta = -delta;
+    }
+
+    if ((channel->absThreshold > 0) && (delta >= channel->absThreshold))
+    {
+        return true;
+    }
+
+    if ((channel->relThreshold > 0) && (delta > 0))
+    {
+        reference = channel->lastReported;
+        if (reference < 0)
+        {
+            reference = -reference;
+        }
+        if (delta * 10000 >= reference * channel->relThreshold)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief  Store the value that has been reported
+ * @param  channel pointer to the channel
+ * @param  value reported value
+ * @param  now current time in ms
+ * @retval None
+ */
+void Deadband_commit(Deadband_Channel *channel, int32_t value, unsigned long now)
+{
+    channel->lastReported = value;
+    channel->lastReportTime = now;
+    channel->reported = true;
+}
+
+/**
+ * @brief  Forget the last reported value so that the next value is always reported
+ * @param  channel pointer to the channel
+ * @retval None
+ */
+void Deadband_reset(Deadband_Channel *channel)
+{
+    channel->lastReported = 0;
+    channel->lastReportTime = 0;
+    channel->reported = false;
+}
@@ -0,0 +1,61 @@
+/**
+ * \file
+ * \brief Deadband filter for report-by-exception telemetry.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef DEADBAND_H
+#define DEADBAND_H
+
+/**         Includes         */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* State of a single telemetry channel.
+     * A threshold of 0 disables the corresponding check. */
+    typedef struct Deadband_Channel
+    {
+        int32_t absThreshold;         /* Absolute change in channel units */
+        int32_t relThreshold;         /* Relative change in 0.01 % of the last reported value */
+        int32_t lastReported;         /* Last value that was sent to the cloud */
+        unsigned long lastReportTime; /* Time of the last report in ms */
+        bool reported;                /* A value has been reported since init */
+    } Deadband_Channel;
+
+    void Deadband_init(Deadband_Channel *channel, int32_t absThreshold, int32_t relThreshold);
+    void Deadband_setThresholds(Deadband_Channel *channel, int32_t absThreshold, int32_t relThreshold);
+    bool Deadband_isReportDue(const Deadband_Channel *channel, int32_t value, unsigned long now, unsigned long heartbeat);
+    void Deadband_commit(Deadband_Channel *channel, int32_t value, unsigned long now);
+    void Deadband_reset(Deadband_Channel *channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEADBAND_H */
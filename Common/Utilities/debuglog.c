@@ -0,0 +1,515 @@
+/**
+ * \file
+ * \brief Deferred debug log.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <stdarg.h>
+#include "debuglog.h"
+
+#if (DEBUG_LOG_BUFFER_SIZE & (DEBUG_LOG_BUFFER_SIZE - 1)) != 0
+#error "DEBUG_LOG_BUFFER_SIZE must be a power of 2"
+#endif
+
+/* Argument types, stored with their native size */
+typedef enum
+{
+    debugLogArgNone,
+    debugLogArgInt,
+    debugLogArgLong,
+    debugLogArgLongLong,
+    debugLogArgSize,
+    debugLogArgPointer,
+    debugLogArgDouble,
+    debugLogArgString
+} DebugLog_arg_t;
+
+/* Record layout: uint16_t size, const char *format, then the arguments in
+ * format order. A string is stored as its length on one byte followed by
+ * the characters. */
+#define DEBUG_LOG_HEADER_SIZE (sizeof(uint16_t) + sizeof(const char *))
+
+static TypeSerial *serialOut = NULL;
+static uint8_t ring[DEBUG_LOG_BUFFER_SIZE];
+/* Free running indexes, head is written by DebugLog_printf only and tail by
+ * DebugLog_drain only, so no lock is needed between the two */
+static volatile uint16_t head = 0;
+static volatile uint16_t tail = 0;
+static uint32_t dropped = 0;
+static uint32_t droppedReported = 0;
+
+/**
+ * @brief  Parse a conversion specification
+ * @param  spec pointer after the '%'
+ * @param  stars returns the number of '*' width and precision arguments
+ * @param  type returns the type of the argument
+ * @retval pointer after the conversion character
+ */
+static const char *DebugLog_parseSpec(const char *spec, uint8_t *stars, DebugLog_arg_t *type)
+{
+    uint8_t longs = 0;
+    bool size = false;
+
+    *stars = 0;
+    /* Flags, width and precision */
+    while (*spec != '\0' && strchr("-+ #0123456789.*", *spec) != NULL)
+    {
+        if (*spec == '*')
+        {
+            (*stars)++;
+        }
+        spec++;
+    }
+    /* Length modifier */
+    while (*spec != '\0' && strchr("hlzjt", *spec) != NULL)
+    {
+        if (*spec == 'l')
+        {
+            longs++;
+        }
+        else if (*spec != 'h')
+        {
+            size = true;
+        }
+        spec++;
+    }
+
+    switch (*spec)
+    {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        *type = size ? debugLogArgSize : (longs >= 2) ? debugLogArgLongLong
+                                     : (longs == 1)   ? debugLogArgLong
+                                                      : debugLogArgInt;
+        break;
+    case 'c':
+        *type = debugLogArgInt;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+        *type = debugLogArgDouble;
+        break;
+    case 'p':
+        *type = debugLogArgPointer;
+        break;
+    case 's':
+        *type = debugLogArgString;
+        break;
+    default:
+        /* %% or unsupported conversion */
+        *type = debugLogArgNone;
+        break;
+    }
+    return (*spec != '\0') ? spec + 1 : spec;
+}
+
+/**
+ * @brief  Append bytes to a record
+ * @retval false if the record is full
+ */
+static bool DebugLog_put(uint8_t *record, uint16_t *size, const void *data, uint16_t length)
+{
+    if (*size + length > DEBUG_LOG_MAX_RECORD)
+    {
+        return false;
+    }
+    memcpy(&record[*size], data, length);
+    *size += length;
+    return true;
+}
+
+/**
+ * @brief  Write the text formatted so far to the debug serial port
+ * @param  line formatted text
+ * @param  length length of the text, returns 0
+ * @retval none
+ */
+static void DebugLog_writeLine(const char *line, size_t *length)
+{
+    if (*length > 0)
+    {
+        SSerial_writeB(serialOut, line, *length);
+    }
+    *length = 0;
+}
+
+/**
+ * @brief  Print the text formatted from a record to the debug serial port,
+ *         in pieces of up to DEBUG_LOG_LINE_LEN characters
+ * @param  record record read from the ring
+ * @retval none
+ */
+static void DebugLog_format(const uint8_t *record)
+{
+    static char line[DEBUG_LOG_LINE_LEN];
+    const uint8_t *arg = record + DEBUG_LOG_HEADER_SIZE;
+    const uint8_t *end;
+    const char *format;
+    uint16_t size;
+    size_t length = 0;
+
+    memcpy(&size, record, sizeof(size));
+    memcpy(&format, record + sizeof(uint16_t), sizeof(format));
+    end = record + size;
+    while (*format != '\0')
+    {
+        const char *specStart;
+        char spec[24];
+        size_t specLength = 0;
+        uint8_t stars;
+        DebugLog_arg_t type;
+        int written = 0;
+
+        if (length >= sizeof(line) - 1)
+        {
+            DebugLog_writeLine(line, &length);
+        }
+        if (*format != '%')
+        {
+            line[length++] = *format++;
+            continue;
+        }
+        specStart = format;
+        format = DebugLog_parseSpec(format + 1, &stars, &type);
+        if (type == debugLogArgNone)
+        {
+            line[length++] = '%';
+            continue;
+        }
+
+        /* Copy the specification with the '*' replaced by their value */
+        for (const char *c = specStart; c < format && specLength < sizeof(spec) - 12; c++)
+        {
+            if (*c == '*' && arg + sizeof(int) <= end)
+            {
+                int value;
+                memcpy(&value, arg, sizeof(value));
+                arg += sizeof(value);
+                specLength += sprintf(&spec[specLength], "%d", value);
+            }
+            else
+            {
+                spec[specLength++] = *c;
+            }
+        }
+        spec[specLength] = '\0';
+
+/* A conversion that does not fit behind the text is formatted again at the
+ * start of an empty line */
+#define DEBUG_LOG_PRINT(...)                                                        \
+    {                                                                               \
+        written = snprintf(&line[length], sizeof(line) - length, spec, __VA_ARGS__); \
+        if ((written >= (int)(sizeof(line) - length)) && (length > 0))              \
+        {                                                                           \
+            DebugLog_writeLine(line, &length);                                      \
+            written = snprintf(line, sizeof(line), spec, __VA_ARGS__);              \
+        }                                                                           \
+    }
+#define DEBUG_LOG_FORMAT_ARG(ctype)                                                 \
+    {                                                                               \
+        ctype value;                                                                \
+        if (arg + sizeof(value) > end)                                              \
+            break;                                                                  \
+        memcpy(&value, arg, sizeof(value));                                         \
+        arg += sizeof(value);                                                       \
+        DEBUG_LOG_PRINT(value);                                                     \
+    }
+        switch (type)
+        {
+        case debugLogArgInt:
+            DEBUG_LOG_FORMAT_ARG(int);
+            break;
+        case debugLogArgLong:
+            DEBUG_LOG_FORMAT_ARG(long);
+            break;
+        case debugLogArgLongLong:
+            DEBUG_LOG_FORMAT_ARG(long long);
+            break;
+        case debugLogArgSize:
+            DEBUG_LOG_FORMAT_ARG(size_t);
+            break;
+        case debugLogArgPointer:
+            DEBUG_LOG_FORMAT_ARG(void *);
+            break;
+        case debugLogArgDouble:
+            DEBUG_LOG_FORMAT_ARG(double);
+            break;
+        case debugLogArgString:
+        {
+            const char *text;
+            uint8_t textLength;
+            char *precision;
+            int limit;
+
+            if (arg >= end)
+                break;
+            textLength = *arg++;
+            if (arg + textLength > end)
+                break;
+            text = (const char *)arg;
+            arg += textLength;
+            if (0 == strcmp(spec, "%s"))
+            {
+                DebugLog_writeLine(line, &length);
+                SSerial_writeB(serialOut, text, textLength);
+                break;
+            }
+            /* The characters are not terminated in the record, the stored
+             * length is given as the precision */
+            limit = textLength;
+            precision = strchr(spec, '.');
+            if (precision == NULL)
+            {
+                precision = &spec[specLength - 1];
+            }
+            else if ((atoi(precision + 1) >= 0) && (atoi(precision + 1) < limit))
+            {
+                limit = atoi(precision + 1);
+            }
+            strcpy(precision, ".*s");
+            DEBUG_LOG_PRINT(limit, text);
+            break;
+        }
+        default:
+            break;
+        }
+#undef DEBUG_LOG_FORMAT_ARG
+#undef DEBUG_LOG_PRINT
+        if (written > 0)
+        {
+            length += (size_t)written;
+            if (length > sizeof(line) - 1)
+            {
+                length = sizeof(line) - 1;
+            }
+        }
+    }
+    DebugLog_writeLine(line, &length);
+}
+
+/**
+ * @brief  Set the serial port the log is written to
+ * @param  serialDebug debug serial port
+ * @retval none
+ */
+void DebugLog_init(TypeSerial *serialDebug)
+{
+    serialOut = serialDebug;
+}
+
+/**
+ * @brief  Record a log message. Only the format string address and the
+ *         arguments are copied, the format string must be a literal.
+ *         Must not be called from an interrupt.
+ * @param  format printf format string
+ * @retval none
+ */
+void DebugLog_printf(const char *format, ...)
+{
+#if DEBUG_LOG_DEFERRED
+    uint8_t record[DEBUG_LOG_MAX_RECORD];
+    uint16_t size = DEBUG_LOG_HEADER_SIZE;
+    const char *c = format;
+    va_list ap;
+
+    memcpy(&record[sizeof(uint16_t)], &format, sizeof(format));
+    va_start(ap, format);
+    while ((c = strchr(c, '%')) != NULL)
+    {
+        uint8_t stars;
+        DebugLog_arg_t type;
+        bool fits = true;
+
+        c = DebugLog_parseSpec(c + 1, &stars, &type);
+        for (uint8_t i = 0; i < stars && fits; i++)
+        {
+            int value = va_arg(ap, int);
+            fits = DebugLog_put(record, &size, &value, sizeof(value));
+        }
+        switch (type)
+        {
+        case debugLogArgInt:
+        {
+            int value = va_arg(ap, int);
+            fits = fits && DebugLog_put(record, &size, &value, sizeof(value));
+            break;
+        }
+        case debugLogArgLong:
+        {
+            long value = va_arg(ap, long);
+            fits = fits && DebugLog_put(record, &size, &value, sizeof(value));
+            break;
+        }
+        case debugLogArgLongLong:
+        {
+            long long value = va_arg(ap, long long);
+            fits = fits && DebugLog_put(record, &size, &value, sizeof(value));
+            break;
+        }
+        case debugLogArgSize:
+        {
+            size_t value = va_arg(ap, size_t);
+            fits = fits && DebugLog_put(record, &size, &value, sizeof(value));
+            break;
+        }
+        case debugLogArgPointer:
+        {
+            void *value = va_arg(ap, void *);
+            fits = fits && DebugLog_put(record, &size, &value, sizeof(value));
+            break;
+        }
+        case debugLogArgDouble:
+        {
+            double value = va_arg(ap, double);
+            fits = fits && DebugLog_put(record, &size, &value, sizeof(value));
+            break;
+        }
+        case debugLogArgString:
+        {
+            const char *value = va_arg(ap, const char *);
+            size_t length = (value != NULL) ? strlen(value) : 0;
+            uint8_t stored;
+
+            if (length > DEBUG_LOG_MAX_STRING)
+            {
+                length = DEBUG_LOG_MAX_STRING;
+            }
+            if (size + 1 + length > DEBUG_LOG_MAX_RECORD)
+            {
+                length = (size + 1 < DEBUG_LOG_MAX_RECORD) ? DEBUG_LOG_MAX_RECORD - size - 1 : 0;
+            }
+            stored = (uint8_t)length;
+            fits = fits && DebugLog_put(record, &size, &stored, 1) &&
+                   DebugLog_put(record, &size, value, stored);
+            break;
+        }
+        default:
+            break;
+        }
+        if (!fits)
+        {
+            /* The formatter stops at the first missing argument */
+            break;
+        }
+    }
+    va_end(ap);
+    memcpy(record, &size, sizeof(size));
+
+    if ((uint16_t)(DEBUG_LOG_BUFFER_SIZE - (uint16_t)(head - tail)) < size)
+    {
+        dropped++;
+        return;
+    }
+    for (uint16_t i = 0; i < size; i++)
+    {
+        ring[(uint16_t)(head + i) & (DEBUG_LOG_BUFFER_SIZE - 1)] = record[i];
+    }
+    head += size;
+#else
+    char buf[MAX_PRINT_LEN];
+    va_list ap;
+
+    if (serialOut == NULL)
+    {
+        return;
+    }
+    va_start(ap, format);
+    vsnprintf(buf, sizeof(buf), format, ap);
+    va_end(ap);
+    SSerial_writeB(serialOut, buf, strlen(buf));
+#endif
+}
+
+/**
+ * @brief  Format and print recorded messages
+ * @param  maxRecords maximum number of messages printed
+ * @retval number of messages printed
+ */
+uint16_t DebugLog_drain(uint16_t maxRecords)
+{
+    uint8_t record[DEBUG_LOG_MAX_RECORD];
+    uint16_t count = 0;
+
+    if (serialOut == NULL)
+    {
+        return 0;
+    }
+    if (dropped != droppedReported)
+    {
+        char text[48];
+        int length = snprintf(text, sizeof(text), "[%lu log messages dropped]\r\n",
+                              (unsigned long)(dropped - droppedReported));
+        droppedReported = dropped;
+        SSerial_writeB(serialOut, text, (size_t)length);
+    }
+    while (count < maxRecords && head != tail)
+    {
+        uint16_t size;
+
+        record[0] = ring[tail & (DEBUG_LOG_BUFFER_SIZE - 1)];
+        record[1] = ring[(uint16_t)(tail + 1) & (DEBUG_LOG_BUFFER_SIZE - 1)];
+        memcpy(&size, record, sizeof(size));
+        for (uint16_t i = 2; i < size; i++)
+        {
+            record[i] = ring[(uint16_t)(tail + i) & (DEBUG_LOG_BUFFER_SIZE - 1)];
+        }
+        tail += size;
+        DebugLog_format(record);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief  Check if all recorded messages were printed
+ * @retval true if nothing is left to drain
+ */
+bool DebugLog_isEmpty()
+{
+    return (head == tail) && (dropped == droppedReported);
+}
+
+/**
+ * @brief  Print all recorded messages, e.g. before a reset
+ * @retval none
+ */
+void DebugLog_flush()
+{
+    while (DebugLog_drain(UINT16_MAX) > 0)
+        ;
+}
+
+/**
+ * @brief  Get the number of messages dropped because the ring was full
+ * @retval number of messages
+ */
+uint32_t DebugLog_getDropped()
+{
+    return dropped;
+}
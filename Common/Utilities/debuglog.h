@@ -0,0 +1,72 @@
+/**
+ * \file
+ * \brief Deferred debug log.
+ *
+ * Log calls store the address of the format string and the raw arguments
+ * in a RAM ring buffer. The text is only formatted and written to the debug
+ * serial port by DebugLog_drain, called where the application has time to
+ * spare, so that logging does not distort the timing of the caller.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef DEBUGLOG_H
+#define DEBUGLOG_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/* Record the log calls and format them later, 0 to print them immediately */
+#ifndef DEBUG_LOG_DEFERRED
+#define DEBUG_LOG_DEFERRED 1
+#endif
+
+/* Size of the ring buffer in bytes, a power of 2 not below
+ * DEBUG_LOG_MAX_RECORD. The Calypso waits drain it, a boot fills up to about
+ * 160 bytes. */
+#ifndef DEBUG_LOG_BUFFER_SIZE
+#define DEBUG_LOG_BUFFER_SIZE 512
+#endif
+
+#define DEBUG_LOG_MAX_RECORD 256 /* Bytes of a record, longer records are truncated */
+#define DEBUG_LOG_MAX_STRING 120 /* Characters kept of a %s argument */
+#define DEBUG_LOG_LINE_LEN 64    /* Characters formatted before they are written */
+#define DEBUG_LOG_DRAIN_RECORDS 4 /* Messages printed per pass of the main loop */
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void DebugLog_init(TypeSerial *serialDebug);
+    void DebugLog_printf(const char *format, ...);
+    uint16_t DebugLog_drain(uint16_t maxRecords);
+    bool DebugLog_isEmpty();
+    void DebugLog_flush();
+    uint32_t DebugLog_getDropped();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEBUGLOG_H */
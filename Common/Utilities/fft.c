@@ -0,0 +1,365 @@
+/**
+ * \file
+ * \brief Fixed-point real FFT for vibration spectrum analysis.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "fft.h"
+
+/* sin(2*pi*i/FFT_MAX_POINTS) in Q15 for the first quarter wave */
+static const int16_t FFT_sineTable[FFT_MAX_POINTS / 4 + 1] = {
+    0, 804, 1608, 2411, 3212, 4011, 4808, 5602,
+    6393, 7180, 7962, 8740, 9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32767};
+
+/* Normalized blocks stay below this bound to leave headroom for the butterflies */
+#define FFT_NORMALIZED_MAX (1L << 14)
+
+static bool FFT_isValidLength(uint16_t points);
+static int16_t FFT_sin(uint16_t index);
+static int16_t FFT_cos(uint16_t index);
+static void FFT_complex(int16_t *data, uint16_t points);
+
+/**
+ * @brief  Remove the mean, normalize and apply a Hann window to a block
+ * @param  samples block of samples, processed in place
+ * @param  points number of samples (power of two, max FFT_MAX_POINTS)
+ * @param  shift returns the power of two the samples were scaled by
+ * @retval true if successful false in case of invalid parameters
+ */
+bool FFT_prepareBlock(int16_t *samples, uint16_t points, int8_t *shift)
+{
+    int32_t sum = 0;
+    int32_t peak = 0;
+    int8_t scale = 0;
+    int8_t log2Points = 0;
+    uint16_t step;
+
+    if (!FFT_isValidLength(points))
+    {
+        return false;
+    }
+
+    while ((1U << log2Points) < points)
+    {
+        log2Points++;
+    }
+
+    for (uint16_t i = 0; i < points; i++)
+    {
+        sum += samples[i];
+    }
+
+    /* Deviations are taken times points so that the mean is removed exactly */
+    for (uint16_t i = 0; i < points; i++)
+    {
+        int32_t value = (int32_t)samples[i] * points - sum;
+        if (value < 0)
+        {
+            value = -value;
+        }
+        if (value > peak)
+        {
+            peak = value;
+        }
+    }
+    peak = (peak + points - 1) >> log2Points;
+
+    /* Block floating point: use the full headroom for small signals */
+    if (peak != 0)
+    {
+        while (peak >= FFT_NORMALIZED_MAX)
+        {
+            peak >>= 1;
+            scale--;
+        }
+        while ((peak << 1) < FFT_NORMALIZED_MAX)
+        {
+            peak <<= 1;
+            scale++;
+        }
+    }
+
+    step = FFT_MAX_POINTS / points;
+    for (uint16_t i = 0; i < points; i++)
+    {
+        int32_t value = (int32_t)samples[i] * points - sum;
+        int8_t right = (int8_t)(log2Points - scale);
+        /* Hann window w = (1 - cos) / 2 in Q15 */
+        int32_t window = (32767 - (int32_t)FFT_cos((uint16_t)(i * step))) >> 1;
+
+        /* Scale by 2^scale / points, rounded */
+        value = (right > 0) ? ((value + (1L << (right - 1))) >> right) : (value * (1L << -right));
+        samples[i] = (int16_t)((value * window) >> 15);
+    }
+
+    *shift = scale;
+    return true;
+}
+
+/**
+ * @brief  Compute the magnitude spectrum of a real block
+ * @param  samples block of samples, destroyed by the transform
+ * @param  points number of samples (power of two, max FFT_MAX_POINTS)
+ * @param  magnitude returns points/2 bins scaled by 1/points (bin 0 is DC)
+ * @retval true if successful false in case of invalid parameters
+ */
+bool FFT_realMagnitude(int16_t *samples, uint16_t points, uint16_t *magnitude)
+{
+    uint16_t half = points / 2;
+    uint16_t step;
+
+    if (!FFT_isValidLength(points))
+    {
+        return false;
+    }
+
+    /* Even and odd samples form the real and imaginary part of a half length transform */
+    FFT_complex(samples, half);
+
+    step = FFT_MAX_POINTS / points;
+    for (uint16_t k = 0; k <= half / 2; k++)
+    {
+        uint16_t mirror = (k == 0) ? 0 : (uint16_t)(half - k);
+        int16_t *a = &samples[2 * k];
+        int16_t *b = &samples[2 * mirror];
+
+        /* Process bin k and its mirror half - k from the same pair of inputs */
+        for (uint8_t pass = 0; pass < 2; pass++)
+        {
+            uint16_t bin = (pass == 0) ? k : (uint16_t)(half - k);
+            int16_t *x = (pass == 0) ? a : b;
+            int16_t *y = (pass == 0) ? b : a;
+            int32_t c = FFT_cos((uint16_t)(bin * step));
+            int32_t s = FFT_sin((uint16_t)(bin * step));
+            int32_t evenRe = (int32_t)x[0] + y[0];
+            int32_t evenIm = (int32_t)x[1] - y[1];
+            int32_t oddRe = (int32_t)x[0] - y[0];
+            int32_t oddIm = (int32_t)x[1] + y[1];
+            /* Even and odd parts carry a factor 2 and the half length transform another one */
+            int32_t re = (evenRe + ((c * oddIm - s * oddRe) >> 15)) >> 2;
+            int32_t im = (evenIm - ((s * oddIm + c * oddRe) >> 15)) >> 2;
+
+            if (bin < half)
+            {
+                magnitude[bin] = (uint16_t)FFT_sqrt((uint64_t)((int64_t)re * re + (int64_t)im * im));
+            }
+            if (k == 0 || 2 * k == half)
+            {
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Find the largest local maxima of a magnitude spectrum
+ * @param  magnitude magnitude spectrum
+ * @param  bins number of bins
+ * @param  peaks returns the peaks sorted by decreasing magnitude
+ * @param  maxPeaks maximum number of peaks
+ * @retval Number of peaks found
+ */
+uint8_t FFT_findPeaks(const uint16_t *magnitude, uint16_t bins, FFT_Peak *peaks, uint8_t maxPeaks)
+{
+    uint8_t count = 0;
+
+    /* Bin 0 is DC and is skipped */
+    for (uint16_t k = 1; k < bins; k++)
+    {
+        uint16_t value = magnitude[k];
+        uint8_t pos;
+
+        if (value == 0 || value <= magnitude[k - 1] || ((k + 1 < bins) && value < magnitude[k + 1]))
+        {
+            continue;
+        }
+
+        pos = count;
+        while (pos > 0 && peaks[pos - 1].magnitude < value)
+        {
+            if (pos < maxPeaks)
+            {
+                peaks[pos] = peaks[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < maxPeaks)
+        {
+            peaks[pos].bin = k;
+            peaks[pos].magnitude = value;
+            if (count < maxPeaks)
+            {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief  Sum of the squared magnitudes of a range of bins
+ * @param  magnitude magnitude spectrum
+ * @param  firstBin first bin of the band
+ * @param  lastBin last bin of the band (inclusive)
+ * @retval Energy of the band
+ */
+uint64_t FFT_bandEnergy(const uint16_t *magnitude, uint16_t firstBin, uint16_t lastBin)
+{
+    uint64_t energy = 0;
+
+    for (uint16_t k = firstBin; k <= lastBin; k++)
+    {
+        energy += (uint32_t)magnitude[k] * magnitude[k];
+    }
+    return energy;
+}
+
+/**
+ * @brief  Integer square root
+ * @param  value input value
+ * @retval Square root rounded down
+ */
+uint32_t FFT_sqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+static bool FFT_isValidLength(uint16_t points)
+{
+    return (points >= 4) && (points <= FFT_MAX_POINTS) && ((points & (points - 1)) == 0);
+}
+
+/**
+ * @brief  Sine of 2*pi*index/FFT_MAX_POINTS in Q15
+ */
+static int16_t FFT_sin(uint16_t index)
+{
+    const uint16_t quarter = FFT_MAX_POINTS / 4;
+
+    index &= FFT_MAX_POINTS - 1;
+    if (index <= quarter)
+    {
+        return FFT_sineTable[index];
+    }
+    if (index <= 2 * quarter)
+    {
+        return FFT_sineTable[2 * quarter - index];
+    }
+    if (index <= 3 * quarter)
+    {
+        return -FFT_sineTable[index - 2 * quarter];
+    }
+    return -FFT_sineTable[4 * quarter - index];
+}
+
+/**
+ * @brief  Cosine of 2*pi*index/FFT_MAX_POINTS in Q15
+ */
+static int16_t FFT_cos(uint16_t index)
+{
+    return FFT_sin((uint16_t)(index + FFT_MAX_POINTS / 4));
+}
+
+/**
+ * @brief  In place radix-2 complex FFT on interleaved Q15 data, scaled by 1/points
+ * @param  data interleaved real and imaginary parts
+ * @param  points number of complex points (power of two)
+ */
+static void FFT_complex(int16_t *data, uint16_t points)
+{
+    /* Bit reversal permutation */
+    for (uint16_t i = 0, j = 0; i < points; i++)
+    {
+        uint16_t bit = points >> 1;
+
+        if (i < j)
+        {
+            int16_t re = data[2 * i];
+            int16_t im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+        while (j & bit)
+        {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+
+    /* Butterflies, halving every stage to avoid overflow */
+    for (uint16_t size = 2; size <= points; size <<= 1)
+    {
+        uint16_t half = size >> 1;
+        uint16_t step = FFT_MAX_POINTS / size;
+
+        for (uint16_t k = 0; k < half; k++)
+        {
+            int32_t wr = FFT_cos((uint16_t)(k * step));
+            int32_t wi = -(int32_t)FFT_sin((uint16_t)(k * step));
+
+            for (uint16_t i = k; i < points; i += size)
+            {
+                int16_t *top = &data[2 * i];
+                int16_t *bottom = &data[2 * (i + half)];
+                int32_t tr = (wr * bottom[0] - wi * bottom[1]) >> 15;
+                int32_t ti = (wr * bottom[1] + wi * bottom[0]) >> 15;
+
+                bottom[0] = (int16_t)((top[0] - tr) >> 1);
+                bottom[1] = (int16_t)((top[1] - ti) >> 1);
+                top[0] = (int16_t)((top[0] + tr) >> 1);
+                top[1] = (int16_t)((top[1] + ti) >> 1);
+            }
+        }
+    }
+}
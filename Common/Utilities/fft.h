@@ -0,0 +1,60 @@
+/**
+ * \file
+ * \brief Fixed-point real FFT for vibration spectrum analysis.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+/**         Includes         */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Largest supported transform length in real samples (power of two) */
+#define FFT_MAX_POINTS 256
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* Spectral peak */
+    typedef struct FFT_Peak
+    {
+        uint16_t bin;       /* Index of the frequency bin */
+        uint16_t magnitude; /* Magnitude of the bin */
+    } FFT_Peak;
+
+    bool FFT_prepareBlock(int16_t *samples, uint16_t points, int8_t *shift);
+    bool FFT_realMagnitude(int16_t *samples, uint16_t points, uint16_t *magnitude);
+    uint8_t FFT_findPeaks(const uint16_t *magnitude, uint16_t bins, FFT_Peak *peaks, uint8_t maxPeaks);
+    uint64_t FFT_bandEnergy(const uint16_t *magnitude, uint16_t firstBin, uint16_t lastBin);
+    uint32_t FFT_sqrt(uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFT_H */
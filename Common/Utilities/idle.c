@@ -0,0 +1,180 @@
+/**
+ * \file
+ * \brief Idle manager, sleeps the CPU while no task is ready.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "idle.h"
+#include "systime.h"
+#include "timerwheel.h"
+
+static bool (*busyCheck)(void) = NULL;
+static void (*sleepHook)(IdleMode_t mode) = NULL;
+static IdleMode_t idleMode = IDLE_MODE_RUN;
+static IdleStats_t idleStats;
+
+/**
+ * @brief  Default sleep, the platform sleep of the CPU. millis() stops in
+ *         standby, the time measured by the platform is added to SysTime.
+ * @param  mode IDLE_MODE_SLEEP or IDLE_MODE_STANDBY
+ * @retval None
+ */
+static void Idle_cpuSleep(IdleMode_t mode)
+{
+    SysTime_addStopped(cpuSleep(mode == IDLE_MODE_STANDBY));
+}
+
+/**
+ * @brief  Initialize the idle manager, the mode is IDLE_MODE_RUN until set
+ * @param  isBusy Returns true while there is work the sleep would delay,
+ *         called with the interrupts masked. NULL to always sleep.
+ * @param  sleep Sleeps until the next interrupt, NULL for cpuSleep
+ * @retval None
+ */
+void Idle_init(bool (*isBusy)(void), void (*sleep)(IdleMode_t mode))
+{
+    busyCheck = isBusy;
+    sleepHook = (sleep != NULL) ? sleep : Idle_cpuSleep;
+    idleMode = IDLE_MODE_RUN;
+    Idle_resetStats();
+}
+
+/**
+ * @brief  Set the deepest mode the idle manager may use
+ * @param  mode Sleep mode
+ * @retval None
+ */
+void Idle_setMode(IdleMode_t mode)
+{
+    idleMode = mode;
+}
+
+/**
+ * @brief  Get the deepest mode the idle manager may use
+ * @retval Sleep mode
+ */
+IdleMode_t Idle_getMode()
+{
+    return idleMode;
+}
+
+/**
+ * @brief  Sleep until the next interrupt unless there is work pending. The
+ *         interrupts are masked between the busy check and the sleep, so an
+ *         event posted by an interrupt in between ends the sleep at once.
+ * @retval true if the CPU slept
+ */
+bool Idle_enter()
+{
+    IdleMode_t mode = idleMode;
+    uint64_t start;
+    uint64_t slept;
+
+    if (mode == IDLE_MODE_RUN || sleepHook == NULL)
+    {
+        return false;
+    }
+    if (mode == IDLE_MODE_STANDBY)
+    {
+        uint64_t tick;
+
+        /* Waking up from standby takes the clocks time to restart */
+        if (TimerWheel_nextExpiry(&tick) && tick < TimerWheel_now() + IDLE_STANDBY_MIN_MS)
+        {
+            mode = IDLE_MODE_SLEEP;
+        }
+    }
+
+    noInterrupts();
+    if (busyCheck != NULL && busyCheck())
+    {
+        interrupts();
+        idleStats.vetoed++;
+        return false;
+    }
+    start = SysTime_micros();
+    sleepHook(mode);
+    interrupts();
+    slept = SysTime_micros() - start;
+
+    idleStats.sleeps++;
+    idleStats.sleptUs += slept;
+    if (mode == IDLE_MODE_STANDBY)
+    {
+        idleStats.standbys++;
+        idleStats.standbyUs += slept;
+    }
+    return true;
+}
+
+/**
+ * @brief  Get the sleep statistics since the last reset
+ * @param  stats Copy of the statistics
+ * @retval None
+ */
+void Idle_getStats(IdleStats_t *stats)
+{
+    *stats = idleStats;
+}
+
+/**
+ * @brief  Share of the time the CPU was awake since the last reset
+ * @retval Duty cycle in 0.01 %
+ */
+uint16_t Idle_getDutyCycle()
+{
+    uint64_t elapsed = SysTime_micros() - idleStats.sinceUs;
+
+    if (elapsed == 0)
+    {
+        return 10000;
+    }
+    if (idleStats.sleptUs >= elapsed)
+    {
+        return 0;
+    }
+    return (uint16_t)((elapsed - idleStats.sleptUs) * 10000 / elapsed);
+}
+
+/**
+ * @brief  Clear the statistics
+ * @retval None
+ */
+void Idle_resetStats()
+{
+    memset(&idleStats, 0, sizeof(idleStats));
+    idleStats.sinceUs = SysTime_micros();
+}
+
+/**
+ * @brief  Print the duty cycle and the sleeps
+ * @param  serial Output serial port
+ * @retval None
+ */
+void Idle_printStats(TypeSerial *serial)
+{
+    uint16_t duty = Idle_getDutyCycle();
+
+    SSerial_printf(serial, "awake %u.%02u %%, %lu sleeps (%lu standby, %lu ms), %lu vetoed\r\n", duty / 100,
+                   duty % 100, (unsigned long)idleStats.sleeps, (unsigned long)idleStats.standbys,
+                   (unsigned long)(idleStats.standbyUs / 1000), (unsigned long)idleStats.vetoed);
+}
+/**         EOF         */
@@ -0,0 +1,84 @@
+/**
+ * \file
+ * \brief Idle manager, sleeps the CPU while no task is ready.
+ *
+ * Called by the main loop when the scheduler found nothing to run. Unless
+ * the busy check reports pending work, the CPU sleeps until the next
+ * interrupt: the wake-up alarm of the timer wheel, a UART, I2C or button
+ * interrupt, or SysTick in the idle mode. Standby is only entered when the
+ * next timer is far enough away. The time spent asleep is accounted for
+ * the duty cycle.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/* Standby is only entered if the next timer expires later than this. The
+ * RTC alarm ending it is up to 2 ms late, and the timers of the wheel move
+ * to a finer level up to 64 ms before they expire, so a longer minimum
+ * spends that time in the idle mode woken by SysTick every ms. */
+#ifndef IDLE_STANDBY_MIN_MS
+#define IDLE_STANDBY_MIN_MS 5
+#endif
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        IDLE_MODE_RUN,    /* Never sleep */
+        IDLE_MODE_SLEEP,  /* CPU stopped, clocks and peripherals running */
+        IDLE_MODE_STANDBY /* All clocks stopped but the ones set to run in standby */
+    } IdleMode_t;
+
+    typedef struct
+    {
+        uint32_t sleeps;    /* Sleeps entered, in any mode */
+        uint32_t standbys;  /* Sleeps entered in standby */
+        uint32_t vetoed;    /* Calls with pending work */
+        uint64_t sleptUs;
+        uint64_t standbyUs; /* Part of sleptUs spent in standby */
+        uint64_t sinceUs;   /* SysTime_micros() of the last reset */
+    } IdleStats_t;
+
+    void Idle_init(bool (*isBusy)(void), void (*sleep)(IdleMode_t mode));
+    void Idle_setMode(IdleMode_t mode);
+    IdleMode_t Idle_getMode();
+    bool Idle_enter();
+    void Idle_getStats(IdleStats_t *stats);
+    uint16_t Idle_getDutyCycle();
+    void Idle_resetStats();
+    void Idle_printStats(TypeSerial *serial);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IDLE_H */
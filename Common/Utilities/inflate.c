@@ -0,0 +1,451 @@
+/**
+ * \file
+ * \brief Decompression of raw DEFLATE data (RFC 1951).
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include <string.h>
+
+#include "inflate.h"
+
+#define INFLATE_MAX_BITS 15
+#define INFLATE_MAX_LENGTH_CODES 288
+#define INFLATE_MAX_DISTANCE_CODES 30
+#define INFLATE_FIXED_LENGTH_CODES 288
+
+/* Canonical Huffman code: number of codes of each length and the symbols
+ * ordered by code */
+typedef struct
+{
+    uint16_t count[INFLATE_MAX_BITS + 1];
+    uint16_t symbol[INFLATE_MAX_LENGTH_CODES];
+} Inflate_huffman_t;
+
+typedef struct
+{
+    const uint8_t *source;
+    uint32_t sourceLength;
+    uint32_t sourcePos;
+    uint32_t bitBuffer;
+    uint8_t bitCount;
+    bool error;
+    uint8_t window[INFLATE_WINDOW_SIZE];
+    uint32_t total; /* Bytes output so far */
+    Inflate_sink_t sink;
+    void *context;
+    Inflate_huffman_t lengthCode;
+    Inflate_huffman_t distanceCode;
+} Inflate_t;
+
+static const uint16_t lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                          193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                          6145, 8193, 12289, 16385, 24577};
+static const uint8_t distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                          6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/* Order of the code length code lengths of a dynamic block */
+static const uint8_t codeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+/**
+ * @brief  Read bits from the source, least significant bit first
+ * @param  s Decoder state
+ * @param  need Number of bits, at most 16
+ * @retval Bits read, sets the error past the end of the source
+ */
+static uint16_t Inflate_bits(Inflate_t *s, uint8_t need)
+{
+    uint32_t value = s->bitBuffer;
+
+    while (s->bitCount < need)
+    {
+        if (s->sourcePos >= s->sourceLength)
+        {
+            s->error = true;
+            return 0;
+        }
+        value |= (uint32_t)s->source[s->sourcePos++] << s->bitCount;
+        s->bitCount += 8;
+    }
+    s->bitBuffer = value >> need;
+    s->bitCount -= need;
+    return (uint16_t)(value & ((1UL << need) - 1));
+}
+
+/**
+ * @brief  Add a byte to the output, each full half of the window is passed
+ *         to the sink while the other half still serves the back references
+ * @param  s Decoder state
+ * @param  byte Output byte
+ * @retval None, sets the error if the sink stops
+ */
+static void Inflate_output(Inflate_t *s, uint8_t byte)
+{
+    uint16_t pos = (uint16_t)(s->total % INFLATE_WINDOW_SIZE);
+
+    s->window[pos] = byte;
+    s->total++;
+    if ((s->total % INFLATE_OUTPUT_CHUNK) == 0)
+    {
+        if (!s->sink(s->context, &s->window[pos + 1 - INFLATE_OUTPUT_CHUNK], INFLATE_OUTPUT_CHUNK))
+        {
+            s->error = true;
+        }
+    }
+}
+
+/**
+ * @brief  Build a canonical Huffman code from the code lengths
+ * @param  h Code to build
+ * @param  length Code length of each symbol, 0 if unused
+ * @param  n Number of symbols
+ * @retval false if the code is over-subscribed
+ */
+static bool Inflate_build(Inflate_huffman_t *h, const uint8_t *length, uint16_t n)
+{
+    uint16_t offset[INFLATE_MAX_BITS + 1];
+    int32_t left = 1;
+
+    memset(h->count, 0, sizeof(h->count));
+    for (uint16_t symbol = 0; symbol < n; symbol++)
+    {
+        h->count[length[symbol]]++;
+    }
+    for (uint8_t len = 1; len <= INFLATE_MAX_BITS; len++)
+    {
+        left = (left << 1) - h->count[len];
+        if (left < 0)
+        {
+            return false;
+        }
+    }
+
+    offset[1] = 0;
+    for (uint8_t len = 1; len < INFLATE_MAX_BITS; len++)
+    {
+        offset[len + 1] = offset[len] + h->count[len];
+    }
+    for (uint16_t symbol = 0; symbol < n; symbol++)
+    {
+        if (length[symbol] != 0)
+        {
+            h->symbol[offset[length[symbol]]++] = symbol;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Decode a symbol, one bit at a time
+ * @param  s Decoder state
+ * @param  h Huffman code
+ * @retval Symbol, -1 if the code is invalid
+ */
+static int Inflate_decode(Inflate_t *s, const Inflate_huffman_t *h)
+{
+    int code = 0;  /* Bits read so far */
+    int first = 0; /* First code of the current length */
+    int index = 0; /* Index of the first code of the current length in symbol */
+
+    for (uint8_t len = 1; len <= INFLATE_MAX_BITS; len++)
+    {
+        int count = h->count[len];
+
+        code |= Inflate_bits(s, 1);
+        if (s->error)
+        {
+            return -1;
+        }
+        if (code - count < first)
+        {
+            return h->symbol[index + (code - first)];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+/**
+ * @brief  Decode the literals and the back references of a compressed block
+ * @param  s Decoder state, with the codes of the block
+ * @retval true at the end of the block
+ */
+static bool Inflate_codes(Inflate_t *s)
+{
+    for (;;)
+    {
+        int symbol = Inflate_decode(s, &s->lengthCode);
+        uint16_t length;
+        uint32_t distance;
+
+        if ((symbol < 0) || s->error)
+        {
+            return false;
+        }
+        if (symbol < 256)
+        {
+            Inflate_output(s, (uint8_t)symbol);
+            continue;
+        }
+        if (symbol == 256)
+        {
+            return true;
+        }
+
+        symbol -= 257;
+        if (symbol >= 29)
+        {
+            return false;
+        }
+        length = lengthBase[symbol] + Inflate_bits(s, lengthExtra[symbol]);
+        symbol = Inflate_decode(s, &s->distanceCode);
+        if ((symbol < 0) || (symbol >= INFLATE_MAX_DISTANCE_CODES))
+        {
+            return false;
+        }
+        distance = distanceBase[symbol] + Inflate_bits(s, distanceExtra[symbol]);
+        if (s->error || (distance > s->total) || (distance > INFLATE_WINDOW_SIZE))
+        {
+            /* Compressed with a larger window than INFLATE_WINDOW_BITS */
+            return false;
+        }
+        while ((length-- > 0) && !s->error)
+        {
+            Inflate_output(s, s->window[(s->total - distance) % INFLATE_WINDOW_SIZE]);
+        }
+    }
+}
+
+/**
+ * @brief  Copy a stored block
+ * @param  s Decoder state
+ * @retval true if successful
+ */
+static bool Inflate_stored(Inflate_t *s)
+{
+    uint16_t length;
+
+    /* Starts at a byte boundary */
+    s->bitBuffer = 0;
+    s->bitCount = 0;
+    if (s->sourcePos + 4 > s->sourceLength)
+    {
+        return false;
+    }
+    length = s->source[s->sourcePos] | (s->source[s->sourcePos + 1] << 8);
+    if ((uint16_t)~length != (s->source[s->sourcePos + 2] | (s->source[s->sourcePos + 3] << 8)))
+    {
+        return false;
+    }
+    s->sourcePos += 4;
+    if (s->sourcePos + length > s->sourceLength)
+    {
+        return false;
+    }
+    while ((length-- > 0) && !s->error)
+    {
+        Inflate_output(s, s->source[s->sourcePos++]);
+    }
+    return !s->error;
+}
+
+/**
+ * @brief  Set up the fixed codes of RFC 1951 3.2.6
+ * @param  s Decoder state
+ * @retval None
+ */
+static void Inflate_fixed(Inflate_t *s)
+{
+    uint8_t length[INFLATE_FIXED_LENGTH_CODES];
+    uint16_t symbol = 0;
+
+    for (; symbol < 144; symbol++)
+    {
+        length[symbol] = 8;
+    }
+    for (; symbol < 256; symbol++)
+    {
+        length[symbol] = 9;
+    }
+    for (; symbol < 280; symbol++)
+    {
+        length[symbol] = 7;
+    }
+    for (; symbol < INFLATE_FIXED_LENGTH_CODES; symbol++)
+    {
+        length[symbol] = 8;
+    }
+    Inflate_build(&s->lengthCode, length, INFLATE_FIXED_LENGTH_CODES);
+
+    memset(length, 5, INFLATE_MAX_DISTANCE_CODES);
+    Inflate_build(&s->distanceCode, length, INFLATE_MAX_DISTANCE_CODES);
+}
+
+/**
+ * @brief  Read the codes of a dynamic block
+ * @param  s Decoder state
+ * @retval true if successful
+ */
+static bool Inflate_dynamic(Inflate_t *s)
+{
+    uint8_t length[INFLATE_MAX_LENGTH_CODES + INFLATE_MAX_DISTANCE_CODES + 2];
+    uint16_t lengthCodes = Inflate_bits(s, 5) + 257;
+    uint16_t distanceCodes = Inflate_bits(s, 5) + 1;
+    uint16_t codeLengthCodes = Inflate_bits(s, 4) + 4;
+    uint16_t index = 0;
+
+    if (s->error || (lengthCodes > INFLATE_MAX_LENGTH_CODES) || (distanceCodes > INFLATE_MAX_DISTANCE_CODES))
+    {
+        return false;
+    }
+
+    /* Code of the code lengths, kept in the length code meanwhile */
+    memset(length, 0, 19);
+    for (uint8_t i = 0; i < codeLengthCodes; i++)
+    {
+        length[codeLengthOrder[i]] = (uint8_t)Inflate_bits(s, 3);
+    }
+    if (s->error || !Inflate_build(&s->lengthCode, length, 19))
+    {
+        return false;
+    }
+
+    while (index < lengthCodes + distanceCodes)
+    {
+        int symbol = Inflate_decode(s, &s->lengthCode);
+        uint8_t value = 0;
+        uint16_t repeat;
+
+        if (symbol < 0)
+        {
+            return false;
+        }
+        if (symbol < 16)
+        {
+            length[index++] = (uint8_t)symbol;
+            continue;
+        }
+        if (symbol == 16)
+        {
+            if (index == 0)
+            {
+                return false;
+            }
+            value = length[index - 1];
+            repeat = 3 + Inflate_bits(s, 2);
+        }
+        else if (symbol == 17)
+        {
+            repeat = 3 + Inflate_bits(s, 3);
+        }
+        else
+        {
+            repeat = 11 + Inflate_bits(s, 7);
+        }
+        if (s->error || (index + repeat > lengthCodes + distanceCodes))
+        {
+            return false;
+        }
+        while (repeat-- > 0)
+        {
+            length[index++] = value;
+        }
+    }
+
+    /* The end of block code is required */
+    if (length[256] == 0)
+    {
+        return false;
+    }
+    return Inflate_build(&s->lengthCode, length, lengthCodes) &&
+           Inflate_build(&s->distanceCode, length + lengthCodes, distanceCodes);
+}
+
+/**
+ * @brief  Decompress raw DEFLATE data, e.g. zlib with negative window bits
+ *         or gzip without its header and trailer
+ * @param  source Compressed data
+ * @param  sourceLength Length of the compressed data
+ * @param  sink Takes the output in parts of at most INFLATE_OUTPUT_CHUNK bytes
+ * @param  context Passed to the sink
+ * @param  outputLength Length of the output, may be NULL
+ * @retval true if the data was complete and valid and the sink took all of it
+ */
+bool Inflate_raw(const uint8_t *source, uint32_t sourceLength, Inflate_sink_t sink, void *context,
+                 uint32_t *outputLength)
+{
+    Inflate_t s;
+    uint16_t last;
+    bool ret = true;
+
+    memset(&s, 0, sizeof(s));
+    s.source = source;
+    s.sourceLength = sourceLength;
+    s.sink = sink;
+    s.context = context;
+
+    do
+    {
+        uint16_t type;
+
+        last = Inflate_bits(&s, 1);
+        type = Inflate_bits(&s, 2);
+        if (s.error)
+        {
+            ret = false;
+        }
+        else if (type == 0)
+        {
+            ret = Inflate_stored(&s);
+        }
+        else if (type == 1)
+        {
+            Inflate_fixed(&s);
+            ret = Inflate_codes(&s);
+        }
+        else if (type == 2)
+        {
+            ret = Inflate_dynamic(&s) && Inflate_codes(&s);
+        }
+        else
+        {
+            ret = false;
+        }
+    } while (ret && !last);
+
+    if (ret && ((s.total % INFLATE_OUTPUT_CHUNK) != 0))
+    {
+        uint16_t remaining = (uint16_t)(s.total % INFLATE_OUTPUT_CHUNK);
+        uint16_t start = (uint16_t)((s.total - remaining) % INFLATE_WINDOW_SIZE);
+
+        ret = sink(context, &s.window[start], remaining);
+    }
+    if (outputLength != NULL)
+    {
+        *outputLength = s.total;
+    }
+    return ret && !s.error;
+}
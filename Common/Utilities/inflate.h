@@ -0,0 +1,60 @@
+/**
+ * \file
+ * \brief Decompression of raw DEFLATE data (RFC 1951).
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef INFLATE_H
+#define INFLATE_H
+
+/**         Includes         */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Largest back reference of the compressed data is 2^INFLATE_WINDOW_BITS
+ * bytes, the window is kept on the stack while inflating */
+#ifndef INFLATE_WINDOW_BITS
+#define INFLATE_WINDOW_BITS 10
+#endif
+#define INFLATE_WINDOW_SIZE (1U << INFLATE_WINDOW_BITS)
+
+/* Output is passed to the sink in parts of at most this size */
+#define INFLATE_OUTPUT_CHUNK (INFLATE_WINDOW_SIZE / 2)
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* Takes the next part of the output, returns false to stop */
+    typedef bool (*Inflate_sink_t)(void *context, const uint8_t *data, uint16_t length);
+
+    bool Inflate_raw(const uint8_t *source, uint32_t sourceLength, Inflate_sink_t sink, void *context,
+                     uint32_t *outputLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INFLATE_H */
@@ -0,0 +1,269 @@
+/**
+ * \file
+ * \brief Cooperative run-to-completion scheduler.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+
+#include "scheduler.h"
+
+#if (SCHEDULER_QUEUE_LENGTH & (SCHEDULER_QUEUE_LENGTH - 1)) != 0
+#error "SCHEDULER_QUEUE_LENGTH must be a power of 2"
+#endif
+
+/* Tasks sorted by priority, most urgent first */
+static SchedulerTask_t *tasks = NULL;
+static void (*backgroundHook)() = NULL;
+
+/**
+ * @brief  Timer wheel callback of the task timers
+ * @param  timer Timer of a task
+ * @retval None
+ */
+static void Scheduler_onTimer(TimerWheelTimer_t *timer)
+{
+    SchedulerTask_t *task = (SchedulerTask_t *)timer->context;
+
+    /* Expiries not handled yet are merged into the oldest one */
+    if (!task->timerExpired)
+    {
+        task->timerExpired = true;
+        task->timerDue = timer->expired;
+    }
+}
+
+/**
+ * @brief  Register a task, its timer is stopped and its queue empty
+ * @param  task Task, must stay valid while the scheduler runs
+ * @param  name Name shown in the statistics
+ * @param  priority 0 is the most urgent, tasks of the same priority run in
+ *         the order they were added
+ * @param  handler Called with SCHEDULER_EVENT_TIMER or a posted event
+ * @retval None
+ */
+void Scheduler_addTask(SchedulerTask_t *task, const char *name, uint8_t priority, SchedulerHandler_t handler)
+{
+    SchedulerTask_t **link = &tasks;
+
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->priority = priority;
+    task->handler = handler;
+    TimerWheel_initTimer(&task->timer, Scheduler_onTimer, task);
+
+    while (*link != NULL && (*link)->priority <= priority)
+    {
+        link = &(*link)->next;
+    }
+    task->next = *link;
+    *link = task;
+}
+
+/**
+ * @brief  Set the function called on every pass of the scheduler, for the
+ *         polled drivers
+ * @param  background function, NULL for none
+ * @retval None
+ */
+void Scheduler_setBackground(void (*background)())
+{
+    backgroundHook = background;
+}
+
+/**
+ * @brief  Start the timer of a task, a running timer is restarted
+ * @param  task Task
+ * @param  delayMs Time to the first expiry
+ * @param  periodMs Time between the next expiries, 0 for a one-shot timer
+ * @retval None
+ */
+void Scheduler_startTimer(SchedulerTask_t *task, unsigned long delayMs, unsigned long periodMs)
+{
+    task->timerExpired = false;
+    TimerWheel_start(&task->timer, delayMs, periodMs);
+}
+
+/**
+ * @brief  Stop the timer of a task
+ * @param  task Task
+ * @retval None
+ */
+void Scheduler_stopTimer(SchedulerTask_t *task)
+{
+    TimerWheel_stop(&task->timer);
+    task->timerExpired = false;
+}
+
+/**
+ * @brief  Queue an event for a task. Safe from one interrupt or the main
+ *         loop per task, not both.
+ * @param  task Task
+ * @param  event Event, SCHEDULER_EVENT_TIMER is reserved
+ * @retval true if queued false if the queue is full
+ */
+bool Scheduler_post(SchedulerTask_t *task, uint8_t event)
+{
+    uint8_t head = task->head;
+
+    if ((uint8_t)(head - task->tail) >= SCHEDULER_QUEUE_LENGTH)
+    {
+        task->stats.dropped++;
+        return false;
+    }
+    task->events[head % SCHEDULER_QUEUE_LENGTH] = event;
+    task->postedUs[head % SCHEDULER_QUEUE_LENGTH] = micros();
+    task->head = head + 1;
+    return true;
+}
+
+/**
+ * @brief  Check if a task has a queued event or an expired timer, or if the
+ *         timer wheel is due. The wake-up alarm has no callback, an alarm
+ *         that fired after the last TimerWheel_poll is only seen here, so
+ *         call it with the interrupts masked before a sleep.
+ * @retval true if Scheduler_runOnce would run a task
+ */
+bool Scheduler_isReady()
+{
+    uint64_t tick;
+
+    for (SchedulerTask_t *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->head != task->tail) || task->timerExpired)
+        {
+            return true;
+        }
+    }
+    return TimerWheel_nextExpiry(&tick) && (tick <= TimerWheel_now());
+}
+
+/**
+ * @brief  Call the handler of a task and account its run time
+ * @param  task Task
+ * @param  event Event
+ * @retval Time the handler returned, micros()
+ */
+static unsigned long Scheduler_dispatch(SchedulerTask_t *task, uint8_t event)
+{
+    unsigned long start = micros();
+    unsigned long end;
+
+    task->handler(task, event);
+    end = micros();
+    task->stats.runs++;
+    if (end - start > task->stats.maxRunUs)
+    {
+        task->stats.maxRunUs = end - start;
+    }
+    return end;
+}
+
+/**
+ * @brief  Run the most urgent ready task once: its oldest event first, else
+ *         its expired timer. The timer wheel is polled before and the
+ *         background function is called after it.
+ * @retval true if a task ran
+ */
+bool Scheduler_runOnce()
+{
+    bool ran = false;
+
+    TimerWheel_poll();
+
+    for (SchedulerTask_t *task = tasks; task != NULL && !ran; task = task->next)
+    {
+        if (task->head != task->tail)
+        {
+            uint8_t slot = task->tail % SCHEDULER_QUEUE_LENGTH;
+            uint8_t event = task->events[slot];
+            unsigned long posted = task->postedUs[slot];
+            unsigned long latency = micros() - posted;
+            unsigned long end;
+
+            task->tail++;
+            task->stats.events++;
+            task->stats.totalLatencyUs += latency;
+            if (latency > task->stats.maxLatencyUs)
+            {
+                task->stats.maxLatencyUs = latency;
+            }
+            end = Scheduler_dispatch(task, event);
+            if (end - posted > task->stats.maxResponseUs)
+            {
+                task->stats.maxResponseUs = end - posted;
+            }
+            ran = true;
+        }
+        else if (task->timerExpired)
+        {
+            uint64_t late = TimerWheel_now() - task->timerDue;
+
+            if (late > task->stats.maxTimerLateMs)
+            {
+                task->stats.maxTimerLateMs = late;
+            }
+            task->timerExpired = false;
+            Scheduler_dispatch(task, SCHEDULER_EVENT_TIMER);
+            ran = true;
+        }
+    }
+
+    if (backgroundHook != NULL)
+    {
+        backgroundHook();
+    }
+    return ran;
+}
+
+/**
+ * @brief  Print the run time and latency statistics of the tasks
+ * @param  serial Output serial port
+ * @retval None
+ */
+void Scheduler_printStats(TypeSerial *serial)
+{
+    SSerial_printf(serial, "%-12s %8s %7s %10s %7s %10s %10s %11s %8s\r\n", "task", "runs", "dropped", "max run us",
+                   "events", "avg lat us", "max lat us", "max resp us", "late ms");
+    for (SchedulerTask_t *task = tasks; task != NULL; task = task->next)
+    {
+        const SchedulerStats_t *stats = &task->stats;
+
+        SSerial_printf(serial, "%-12s %8lu %7lu %10lu %7lu %10lu %10lu %11lu %8lu\r\n", task->name,
+                       (unsigned long)stats->runs, (unsigned long)stats->dropped, (unsigned long)stats->maxRunUs,
+                       (unsigned long)stats->events,
+                       (unsigned long)(stats->events ? stats->totalLatencyUs / stats->events : 0),
+                       (unsigned long)stats->maxLatencyUs, (unsigned long)stats->maxResponseUs,
+                       (unsigned long)stats->maxTimerLateMs);
+    }
+}
+
+/**
+ * @brief  Clear the statistics of all tasks
+ * @retval None
+ */
+void Scheduler_resetStats()
+{
+    for (SchedulerTask_t *task = tasks; task != NULL; task = task->next)
+    {
+        memset(&task->stats, 0, sizeof(task->stats));
+    }
+}
+/**         EOF         */
@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief Cooperative run-to-completion scheduler.
+ *
+ * Tasks are handlers called with an event, either posted to the queue of
+ * the task or raised by its timer. The most urgent ready task runs first
+ * and always to completion, so a task must return quickly instead of
+ * waiting.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+#include "timerwheel.h"
+
+/* Events queued per task, a power of 2 */
+#ifndef SCHEDULER_QUEUE_LENGTH
+#define SCHEDULER_QUEUE_LENGTH 8
+#endif
+
+/* Event passed to the handler when the timer of the task expires */
+#define SCHEDULER_EVENT_TIMER 0
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        uint32_t runs;
+        uint32_t dropped;        /* Events lost on a full queue */
+        uint32_t maxRunUs;       /* Longest handler call */
+        uint32_t events;         /* Posted events handled */
+        uint64_t totalLatencyUs; /* From Scheduler_post to the handler call */
+        uint32_t maxLatencyUs;
+        uint32_t maxResponseUs;  /* From Scheduler_post to the handler return */
+        uint32_t maxTimerLateMs; /* Timer expiry to the handler call */
+    } SchedulerStats_t;
+
+    typedef struct SchedulerTask
+    {
+        const char *name;
+        void (*handler)(struct SchedulerTask *task, uint8_t event);
+        uint8_t priority; /* 0 is the most urgent */
+        struct SchedulerTask *next;
+
+        TimerWheelTimer_t timer;
+        bool timerExpired;  /* Set by the wheel, cleared when the handler runs */
+        uint64_t timerDue;  /* Expiry not handled yet, TimerWheel_now() ticks */
+
+        /* Written by Scheduler_post (head) and the scheduler (tail) only */
+        uint8_t events[SCHEDULER_QUEUE_LENGTH];
+        unsigned long postedUs[SCHEDULER_QUEUE_LENGTH];
+        volatile uint8_t head;
+        volatile uint8_t tail;
+
+        SchedulerStats_t stats;
+    } SchedulerTask_t;
+
+    typedef void (*SchedulerHandler_t)(SchedulerTask_t *task, uint8_t event);
+
+    void Scheduler_addTask(SchedulerTask_t *task, const char *name, uint8_t priority, SchedulerHandler_t handler);
+    void Scheduler_setBackground(void (*background)());
+    void Scheduler_startTimer(SchedulerTask_t *task, unsigned long delayMs, unsigned long periodMs);
+    void Scheduler_stopTimer(SchedulerTask_t *task);
+    bool Scheduler_post(SchedulerTask_t *task, uint8_t event);
+    bool Scheduler_runOnce();
+    bool Scheduler_isReady();
+    void Scheduler_printStats(TypeSerial *serial);
+    void Scheduler_resetStats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDULER_H */
@@ -0,0 +1,139 @@
+/**
+ * \file
+ * \brief Monotonic 64-bit time base and wall clock timestamps.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "systime.h"
+
+#define SYSTIME_WRAP_US ((uint64_t)1 << 32)
+#define SYSTIME_HALF_WRAP_US ((uint64_t)1 << 31)
+
+/* millis() extended to 64 bit, it wraps after 49 days */
+static uint32_t lastMillis = 0;
+static uint64_t extendedMillis = 0;
+static uint64_t lastMicros = 0;
+/* Time millis() and micros() were stopped, in standby */
+static uint32_t stoppedUs = 0;
+
+/* Wall clock minus monotonic time, set by SysTime_setUnixTime */
+static bool synchronized = false;
+static uint64_t unixOffsetMs = 0;
+static uint64_t lastUnixMs = 0;
+
+/**
+ * @brief  Monotonic milliseconds. Main loop only, called at least once per
+ *         millis() wrap (49 days), which the timer wheel alarm ensures.
+ * @retval Milliseconds since the first call plus the millis() value then
+ */
+uint64_t SysTime_millis()
+{
+    uint32_t now = (uint32_t)millis();
+
+    extendedMillis += (uint32_t)(now - lastMillis);
+    lastMillis = now;
+    return extendedMillis;
+}
+
+/**
+ * @brief  Monotonic microseconds, on the same time base as SysTime_millis.
+ *         micros() wraps every 71 minutes, the wraps are counted from the
+ *         extended millis() so calls may be further apart. Main loop only.
+ * @retval Microseconds
+ */
+uint64_t SysTime_micros()
+{
+    /* Up to 1 ms behind, and equal to the true time modulo 2^32 us */
+    uint64_t approx = SysTime_millis() * 1000;
+    uint64_t now = (approx & ~(SYSTIME_WRAP_US - 1)) | (uint32_t)(micros() + stoppedUs);
+
+    /* Take the micros() value closest to the millisecond time */
+    if (now + SYSTIME_HALF_WRAP_US < approx)
+    {
+        now += SYSTIME_WRAP_US;
+    }
+    else if (now > approx + SYSTIME_HALF_WRAP_US)
+    {
+        now -= SYSTIME_WRAP_US;
+    }
+
+    if (now < lastMicros)
+    {
+        now = lastMicros;
+    }
+    lastMicros = now;
+    return now;
+}
+
+/**
+ * @brief  Add the time millis() and micros() were stopped, e.g. the standby
+ *         measured by the RTC. Main loop only.
+ * @param  ms Time stopped
+ * @retval None
+ */
+void SysTime_addStopped(uint32_t ms)
+{
+    SysTime_millis();
+    extendedMillis += ms;
+    stoppedUs += ms * 1000;
+}
+
+/**
+ * @brief  Set the wall clock, e.g. from the SNTP time of the Calypso
+ * @param  unixMs Milliseconds since 1970-01-01 UTC
+ * @retval None
+ */
+void SysTime_setUnixTime(uint64_t unixMs)
+{
+    unixOffsetMs = unixMs - SysTime_millis();
+    synchronized = true;
+}
+
+/**
+ * @brief  Check if the wall clock was set
+ * @retval true if SysTime_unixMillis returns the time of day
+ */
+bool SysTime_isSynchronized()
+{
+    return synchronized;
+}
+
+/**
+ * @brief  Wall clock time, never going back even if the clock is set again
+ * @retval Milliseconds since 1970-01-01 UTC, 0 if the clock was never set
+ */
+uint64_t SysTime_unixMillis()
+{
+    uint64_t now;
+
+    if (!synchronized)
+    {
+        return 0;
+    }
+    now = SysTime_millis() + unixOffsetMs;
+    if (now < lastUnixMs)
+    {
+        now = lastUnixMs;
+    }
+    lastUnixMs = now;
+    return now;
+}
+/**         EOF         */
@@ -0,0 +1,55 @@
+/**
+ * \file
+ * \brief Monotonic 64-bit time base and wall clock timestamps.
+ *
+ * The 32-bit millis() and micros() counters of the platform are extended
+ * to 64 bit, so intervals can be computed at any uptime. The wall clock is
+ * the monotonic time plus an offset taken once from the SNTP time of the
+ * Calypso, so a timestamp costs no AT command.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef SYSTIME_H
+#define SYSTIME_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    uint64_t SysTime_millis();
+    uint64_t SysTime_micros();
+    void SysTime_addStopped(uint32_t ms);
+    void SysTime_setUnixTime(uint64_t unixMs);
+    bool SysTime_isSynchronized();
+    uint64_t SysTime_unixMillis();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYSTIME_H */
@@ -24,51 +24,53 @@
 
 #include "time.h"
 
-// leap year calculator expects year argument as years offset from 1970
-#define LEAP_YEAR(Y) (((1970 + (Y)) > 0) && !((1970 + (Y)) % 4) && (((1970 + (Y)) % 100) || !((1970 + (Y)) % 400)))
-
-static const uint8_t monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}; // API starts months from 1, this array starts from 0
-
 /**
- * @brief  Convert time to unix time stamp
- * @param  time pointer to time
+ * @brief  Convert time to unix time stamp, in constant time
+ * @param  time pointer to time, from 1970-01-01
  * @retval UNIX time stamp
  */
 unsigned long long Time_ConvertToUnix(Timestamp *time)
 {
-    unsigned long long seconds = 0;
-    int unixYear = 0;
-    /* Unit epoch starts in 1970 */
-    unixYear = time->year - 1970;
-    seconds = unixYear * (365 * SECONDS_PER_DAY);
+    /* Years counted from March, so the leap day is the last day of a year,
+     * in 400-year eras from 0000-03-01 */
+    int32_t year = (int32_t)time->year - (time->month <= 2);
+    int32_t era = ((year >= 0) ? year : year - 399) / 400;
+    uint32_t yearOfEra = (uint32_t)(year - era * 400);
+    uint32_t monthFromMarch = (time->month > 2) ? time->month - 3 : time->month + 9;
+    uint32_t dayOfYear = (153 * monthFromMarch + 2) / 5 + time->day - 1;
+    uint32_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    int64_t days = (int64_t)era * 146097 + dayOfEra - 719468;
 
-    for (int i = 0; i < unixYear; i++)
-    {
-        if (LEAP_YEAR(i))
-        {
-            seconds += SECONDS_PER_DAY; // add extra days for leap years
-        }
-    }
-
-    // add days for this year, months start from 1
-    for (int i = 1; i < time->month; i++)
-    {
-        seconds += SECONDS_PER_DAY * monthDays[i - 1];
-
-        /* if february of a leap year, add one extra day  */
-        if ((i == 2) && LEAP_YEAR(unixYear))
-        {
-            seconds += SECONDS_PER_DAY;
-        }
-    }
+    return (unsigned long long)(days * SECONDS_PER_DAY + (int32_t)time->hour * SECONDS_PER_HOUR +
+                                (int32_t)time->minute * SECONDS_PER_MINUTES + time->second);
+}
 
-    seconds += (time->day - 1) * SECONDS_PER_DAY;
-    seconds += time->hour * SECONDS_PER_HOUR;
-    seconds += time->minute * SECONDS_PER_MINUTES;
-    seconds += time->second;
+/**
+ * @brief  Convert a unix time stamp to the calendar time, in constant time
+ * @param  seconds UNIX time stamp
+ * @param  time pointer to the converted time
+ * @retval none
+ */
+void Time_ConvertFromUnix(unsigned long long seconds, Timestamp *time)
+{
+    /* Days counted in 400-year eras from 0000-03-01, so the leap day is the
+     * last day of a year */
+    uint32_t days = (uint32_t)(seconds / SECONDS_PER_DAY) + 719468;
+    uint32_t secondOfDay = (uint32_t)(seconds % SECONDS_PER_DAY);
+    uint32_t era = days / 146097;
+    uint32_t dayOfEra = days - era * 146097;
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    uint32_t monthFromMarch = (5 * dayOfYear + 2) / 153;
 
-    return seconds;
+    time->day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+    time->month = (monthFromMarch < 10) ? monthFromMarch + 3 : monthFromMarch - 9;
+    time->year = yearOfEra + era * 400 + (time->month <= 2);
+    time->hour = secondOfDay / SECONDS_PER_HOUR;
+    time->minute = (secondOfDay % SECONDS_PER_HOUR) / SECONDS_PER_MINUTES;
+    time->second = secondOfDay % SECONDS_PER_MINUTES;
 }
+
 /**
  * @brief  Initialize time stamp
  * @param  time pointer to time
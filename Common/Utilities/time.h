@@ -47,6 +47,7 @@ extern "C"
     } Timestamp;
 
     unsigned long long Time_ConvertToUnix(Timestamp *time);
+    void Time_ConvertFromUnix(unsigned long long seconds, Timestamp *time);
     void Timer_initTime(Timestamp *time);
 
 #ifdef __cplusplus
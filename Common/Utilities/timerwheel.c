@@ -0,0 +1,431 @@
+/**
+ * \file
+ * \brief Hierarchical software timer wheel.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "timerwheel.h"
+#include "systime.h"
+
+#define TIMERWHEEL_SLOT_MASK (TIMERWHEEL_SLOTS - 1)
+#define TIMERWHEEL_SHIFT(level) (TIMERWHEEL_LEVEL_BITS * (level))
+
+/* Timers of a level are in the same block of the next level as the current
+ * tick and in a later slot, an occupied bit is set per non-empty slot */
+static TimerWheelTimer_t *slots[TIMERWHEEL_LEVELS][TIMERWHEEL_SLOTS];
+static uint64_t occupied[TIMERWHEEL_LEVELS];
+static TimerWheelTimer_t *overflow = NULL;
+
+/* Every expiry up to and including this tick has been handled */
+static uint64_t wheelTick = 0;
+/* Time the running TimerWheel_advance catches up to */
+static uint64_t advanceTarget = 0;
+static bool advancing = false;
+
+static uint64_t (*clockSource)(void) = SysTime_millis;
+static uint32_t (*alarmHook)(uint32_t delayMs) = NULL;
+static uint64_t alarmNext = UINT64_MAX; /* Tick the alarm was programmed for */
+static uint64_t alarmTick = 0;          /* Time the alarm fires, earlier if capped */
+
+static TimerWheelStats_t stats;
+
+/**
+ * @brief  Link a timer into the slot of a tick
+ * @param  timer Timer, not linked
+ * @param  tick Expiry tick, not before the current tick
+ * @retval None
+ */
+static void TimerWheel_link(TimerWheelTimer_t *timer, uint64_t tick)
+{
+    uint8_t level = 0;
+    TimerWheelTimer_t **head;
+
+    /* Coarsest level at which the tick is in the current block */
+    while (level < TIMERWHEEL_LEVELS &&
+           (tick >> TIMERWHEEL_SHIFT(level + 1)) != (wheelTick >> TIMERWHEEL_SHIFT(level + 1)))
+    {
+        level++;
+    }
+
+    timer->level = level;
+    if (level == TIMERWHEEL_LEVELS)
+    {
+        timer->slot = 0;
+        head = &overflow;
+    }
+    else
+    {
+        timer->slot = (tick >> TIMERWHEEL_SHIFT(level)) & TIMERWHEEL_SLOT_MASK;
+        head = &slots[level][timer->slot];
+        occupied[level] |= (uint64_t)1 << timer->slot;
+    }
+
+    timer->next = *head;
+    timer->pprev = head;
+    if (*head != NULL)
+    {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+}
+
+/**
+ * @brief  Remove a timer from its slot
+ * @param  timer Linked timer
+ * @retval None
+ */
+static void TimerWheel_unlink(TimerWheelTimer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    if (timer->level < TIMERWHEEL_LEVELS && slots[timer->level][timer->slot] == NULL)
+    {
+        occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * @brief  Move the timers of a slot to the finer levels, the current tick
+ *         is the first tick of the slot
+ * @param  head Slot
+ * @retval None
+ */
+static void TimerWheel_cascade(TimerWheelTimer_t **head)
+{
+    while (*head != NULL)
+    {
+        TimerWheelTimer_t *timer = *head;
+
+        TimerWheel_unlink(timer);
+        TimerWheel_link(timer, timer->expires);
+        stats.cascaded++;
+    }
+}
+
+/**
+ * @brief  Handle the current tick: cascade the slots starting at it, from
+ *         the coarsest level down, then expire the timers of its slot
+ * @retval None
+ */
+static void TimerWheel_processTick()
+{
+    TimerWheelTimer_t **head;
+
+    stats.wakeups++;
+    if ((wheelTick & (((uint64_t)1 << TIMERWHEEL_SHIFT(TIMERWHEEL_LEVELS)) - 1)) == 0)
+    {
+        TimerWheel_cascade(&overflow);
+    }
+    for (uint8_t level = TIMERWHEEL_LEVELS - 1; level > 0; level--)
+    {
+        if ((wheelTick & (((uint64_t)1 << TIMERWHEEL_SHIFT(level)) - 1)) == 0)
+        {
+            TimerWheel_cascade(&slots[level][(wheelTick >> TIMERWHEEL_SHIFT(level)) & TIMERWHEEL_SLOT_MASK]);
+        }
+    }
+
+    /* A callback may start or stop any timer, including the ones left in
+     * this slot, so they are taken one at a time */
+    head = &slots[0][wheelTick & TIMERWHEEL_SLOT_MASK];
+    while (*head != NULL)
+    {
+        TimerWheelTimer_t *timer = *head;
+
+        TimerWheel_unlink(timer);
+        timer->expired = timer->expires;
+        if (advanceTarget - timer->expires > stats.maxLateMs)
+        {
+            stats.maxLateMs = advanceTarget - timer->expires;
+        }
+
+        if (timer->period == 0)
+        {
+            timer->running = false;
+            stats.running--;
+        }
+        else
+        {
+            /* Keep the period, do not catch up on missed expiries */
+            timer->expires += timer->period;
+            if (timer->expires <= advanceTarget)
+            {
+                timer->expires = advanceTarget + timer->period;
+            }
+            TimerWheel_link(timer, timer->expires);
+        }
+
+        stats.expired++;
+        timer->callback(timer);
+    }
+}
+
+/**
+ * @brief  Program the hardware alarm for the next tick holding timers, if
+ *         it changed or the capped alarm has passed
+ * @retval None
+ */
+static void TimerWheel_updateAlarm()
+{
+    uint64_t now;
+    uint64_t next;
+    uint32_t delayMs = TIMERWHEEL_MAX_ALARM_MS;
+
+    if (alarmHook == NULL)
+    {
+        return;
+    }
+
+    now = clockSource();
+    if (!TimerWheel_nextExpiry(&next))
+    {
+        next = UINT64_MAX;
+    }
+    if (next == alarmNext && now < alarmTick)
+    {
+        return;
+    }
+
+    if (next <= now)
+    {
+        delayMs = 0;
+    }
+    else if (next - now < TIMERWHEEL_MAX_ALARM_MS)
+    {
+        delayMs = next - now;
+    }
+    alarmNext = next;
+    alarmTick = now + alarmHook(delayMs);
+}
+
+/**
+ * @brief  Set the time source and the hardware alarm, stopping all timers.
+ *         Without this call the wheel runs on SysTime_millis with no alarm.
+ * @param  clock 64-bit millisecond clock, NULL for SysTime_millis
+ * @param  alarm Called with the time to the next expiry after the timers
+ *         changed, returns the time actually programmed, which may be
+ *         shorter. TimerWheel_poll must be called when the alarm fires.
+ *         NULL if TimerWheel_poll is called continuously.
+ * @retval None
+ */
+void TimerWheel_init(uint64_t (*clock)(void), uint32_t (*alarm)(uint32_t delayMs))
+{
+    memset(slots, 0, sizeof(slots));
+    memset(occupied, 0, sizeof(occupied));
+    memset(&stats, 0, sizeof(stats));
+    overflow = NULL;
+    clockSource = (clock != NULL) ? clock : SysTime_millis;
+    alarmHook = alarm;
+    alarmNext = UINT64_MAX;
+    alarmTick = 0;
+    wheelTick = clockSource();
+    advanceTarget = wheelTick;
+    TimerWheel_updateAlarm();
+}
+
+/**
+ * @brief  Current time of the wheel clock
+ * @retval Milliseconds
+ */
+uint64_t TimerWheel_now()
+{
+    return clockSource();
+}
+
+/**
+ * @brief  Initialize a stopped timer
+ * @param  timer Timer, must stay valid while it runs
+ * @param  callback Called from TimerWheel_poll on every expiry
+ * @param  context Free for the user of the timer
+ * @retval None
+ */
+void TimerWheel_initTimer(TimerWheelTimer_t *timer, TimerWheelCallback_t callback, void *context)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->callback = callback;
+    timer->context = context;
+}
+
+/**
+ * @brief  Start a timer, a running timer is restarted. Main loop only.
+ * @param  timer Timer
+ * @param  delayMs Time to the first expiry
+ * @param  periodMs Time between the next expiries, 0 for a one-shot timer
+ * @retval None
+ */
+void TimerWheel_start(TimerWheelTimer_t *timer, uint32_t delayMs, uint32_t periodMs)
+{
+    uint64_t tick;
+
+    if (timer->running)
+    {
+        TimerWheel_unlink(timer);
+    }
+    else
+    {
+        timer->running = true;
+        stats.running++;
+    }
+    stats.started++;
+
+    /* The current tick is handled already. The expiry is moved with the
+     * tick, a cascade links the timer again at its expiry. */
+    tick = clockSource() + delayMs;
+    timer->expires = (tick > wheelTick) ? tick : wheelTick + 1;
+    timer->period = periodMs;
+    TimerWheel_link(timer, timer->expires);
+
+    if (!advancing)
+    {
+        TimerWheel_updateAlarm();
+    }
+}
+
+/**
+ * @brief  Stop a timer, nothing is done for a stopped timer. Main loop only.
+ * @param  timer Timer
+ * @retval None
+ */
+void TimerWheel_stop(TimerWheelTimer_t *timer)
+{
+    if (!timer->running)
+    {
+        return;
+    }
+    TimerWheel_unlink(timer);
+    timer->running = false;
+    stats.running--;
+    stats.stopped++;
+}
+
+/**
+ * @brief  Check if a timer is running
+ * @param  timer Timer
+ * @retval true if it will expire again
+ */
+bool TimerWheel_isRunning(const TimerWheelTimer_t *timer)
+{
+    return timer->running;
+}
+
+/**
+ * @brief  Get the next tick the wheel has to handle. It is the expiry of a
+ *         timer or earlier, when timers move to a finer level.
+ * @param  tick Next tick
+ * @retval true if a timer is running
+ */
+bool TimerWheel_nextExpiry(uint64_t *tick)
+{
+    for (uint8_t level = 0; level < TIMERWHEEL_LEVELS; level++)
+    {
+        uint8_t shift = TIMERWHEEL_SHIFT(level);
+        uint8_t index = (wheelTick >> shift) & TIMERWHEEL_SLOT_MASK;
+        uint64_t pending = 0;
+
+        if (index < TIMERWHEEL_SLOT_MASK)
+        {
+            pending = occupied[level] & (~(uint64_t)0 << (index + 1));
+        }
+        if (pending != 0)
+        {
+            uint64_t block = (wheelTick >> (shift + TIMERWHEEL_LEVEL_BITS)) << (shift + TIMERWHEEL_LEVEL_BITS);
+
+            *tick = block | ((uint64_t)__builtin_ctzll(pending) << shift);
+            return true;
+        }
+    }
+
+    if (overflow != NULL)
+    {
+        *tick = ((wheelTick >> TIMERWHEEL_SHIFT(TIMERWHEEL_LEVELS)) + 1) << TIMERWHEEL_SHIFT(TIMERWHEEL_LEVELS);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief  Call the callbacks of the timers expired up to a time, skipping
+ *         the ticks without timers
+ * @param  now Time in ticks of the wheel clock
+ * @retval None
+ */
+void TimerWheel_advance(uint64_t now)
+{
+    uint64_t tick;
+
+    if (advancing)
+    {
+        return;
+    }
+    advancing = true;
+    advanceTarget = now;
+
+    while (wheelTick < now)
+    {
+        if (!TimerWheel_nextExpiry(&tick) || tick > now)
+        {
+            wheelTick = now;
+            break;
+        }
+        wheelTick = tick;
+        TimerWheel_processTick();
+    }
+
+    advancing = false;
+}
+
+/**
+ * @brief  Call the callbacks of the expired timers and program the alarm
+ *         for the next expiry. Main loop only.
+ * @retval None
+ */
+void TimerWheel_poll()
+{
+    TimerWheel_advance(clockSource());
+    TimerWheel_updateAlarm();
+}
+
+/**
+ * @brief  Get the counters of the wheel
+ * @param  out Counters
+ * @retval None
+ */
+void TimerWheel_getStats(TimerWheelStats_t *out)
+{
+    *out = stats;
+}
+
+/**
+ * @brief  Clear the counters of the wheel, except the running timers
+ * @retval None
+ */
+void TimerWheel_resetStats()
+{
+    uint32_t running = stats.running;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.running = running;
+}
+/**         EOF         */
@@ -0,0 +1,103 @@
+/**
+ * \file
+ * \brief Hierarchical software timer wheel.
+ *
+ * Any number of one-shot and periodic software timers share one hardware
+ * alarm. Starting and stopping a timer is O(1): a timer is linked into the
+ * slot of its expiry tick, at the coarsest level still in the same block as
+ * the current tick, and moves to a finer level when the wheel reaches its
+ * slot. The wheel is tickless, it skips the empty slots and the hardware
+ * alarm is only programmed for the next slot holding timers.
+ *
+ * Ticks are milliseconds of a 64-bit clock, so the expiries never wrap.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/* 64 slots per level, 6 levels reach 2^36 ms (795 days). Later expiries
+ * wait in an overflow list. */
+#define TIMERWHEEL_LEVEL_BITS 6
+#define TIMERWHEEL_SLOTS (1 << TIMERWHEEL_LEVEL_BITS)
+#define TIMERWHEEL_LEVELS 6
+
+/* Longest alarm requested from the hardware. The default clock,
+ * SysTime_millis, must be read at least once per millis() wrap (49 days). */
+#ifndef TIMERWHEEL_MAX_ALARM_MS
+#define TIMERWHEEL_MAX_ALARM_MS 3600000UL
+#endif
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct TimerWheelTimer
+    {
+        struct TimerWheelTimer *next;
+        struct TimerWheelTimer **pprev; /* Link pointing to this timer */
+        uint64_t expires;               /* Tick of the next expiry */
+        uint64_t expired;               /* Tick of the expiry being handled, valid in the callback */
+        uint32_t period;                /* ms, 0 for a one-shot timer */
+        uint8_t level;                  /* TIMERWHEEL_LEVELS for the overflow list */
+        uint8_t slot;
+        bool running;
+        void (*callback)(struct TimerWheelTimer *timer);
+        void *context;
+    } TimerWheelTimer_t;
+
+    typedef void (*TimerWheelCallback_t)(TimerWheelTimer_t *timer);
+
+    typedef struct
+    {
+        uint32_t running;  /* Timers currently started */
+        uint32_t started;
+        uint32_t stopped;  /* Running timers stopped before their expiry */
+        uint32_t expired;  /* Callbacks called */
+        uint32_t cascaded; /* Timers moved to a finer level */
+        uint32_t wakeups;  /* Ticks processed, empty ticks are skipped */
+        uint32_t maxLateMs;
+    } TimerWheelStats_t;
+
+    void TimerWheel_init(uint64_t (*clock)(void), uint32_t (*alarm)(uint32_t delayMs));
+    uint64_t TimerWheel_now();
+    void TimerWheel_initTimer(TimerWheelTimer_t *timer, TimerWheelCallback_t callback, void *context);
+    void TimerWheel_start(TimerWheelTimer_t *timer, uint32_t delayMs, uint32_t periodMs);
+    void TimerWheel_stop(TimerWheelTimer_t *timer);
+    bool TimerWheel_isRunning(const TimerWheelTimer_t *timer);
+    bool TimerWheel_nextExpiry(uint64_t *tick);
+    void TimerWheel_advance(uint64_t now);
+    void TimerWheel_poll();
+    void TimerWheel_getStats(TimerWheelStats_t *stats);
+    void TimerWheel_resetStats();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMERWHEEL_H */
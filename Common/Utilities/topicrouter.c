@@ -0,0 +1,387 @@
+/**
+ * \file
+ * \brief MQTT topic router.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#include "topicrouter.h"
+
+/* Node types, in the order the children of a level are tried */
+#define TOPIC_LEVEL_LITERAL 0
+#define TOPIC_LEVEL_PLUS 1
+#define TOPIC_LEVEL_HASH 2
+
+#define TOPIC_ROUTER_ROOT 0
+
+static bool TopicRouter_matchNode(const TopicRouter_t *router, uint8_t index, const char *level, const char *end,
+                                  TopicMatch_t *match, uint8_t *route);
+
+/**
+ * @brief  Remove all routes
+ * @param  router Router
+ * @retval None
+ */
+void TopicRouter_init(TopicRouter_t *router)
+{
+    memset(router, 0, sizeof(TopicRouter_t));
+    /* Node 0 is the root, before the first level */
+    router->nodeCount = 1;
+}
+
+/**
+ * @brief  Find or insert the child of a node for one pattern level. The
+ *         children are kept ordered literal, '+', '#'.
+ * @param  router Router
+ * @param  parent Parent node
+ * @param  level Pattern level
+ * @param  length Length of the level
+ * @param  type Level type
+ * @retval Child node, 0 if the router is full
+ */
+static uint8_t TopicRouter_child(TopicRouter_t *router, uint8_t parent, const char *level, uint8_t length, uint8_t type)
+{
+    uint8_t *link = &router->nodes[parent].child;
+    TopicRouterNode_t *node;
+    uint8_t index;
+
+    while (*link != 0)
+    {
+        node = &router->nodes[*link];
+        if (node->type > type)
+        {
+            break;
+        }
+        if ((node->type == type) &&
+            ((type != TOPIC_LEVEL_LITERAL) ||
+             ((node->length == length) && (0 == memcmp(node->level, level, length)))))
+        {
+            return *link;
+        }
+        link = &node->sibling;
+    }
+
+    if (router->nodeCount >= TOPIC_ROUTER_MAX_NODES)
+    {
+        return 0;
+    }
+    index = router->nodeCount++;
+    node = &router->nodes[index];
+    node->length = length;
+    node->type = type;
+    node->child = 0;
+    node->route = 0;
+    node->level = level;
+    node->sibling = *link;
+    *link = index;
+    return index;
+}
+
+/**
+ * @brief  Add a subscription pattern. The pattern is not copied and must
+ *         stay valid as long as the router is used.
+ * @param  router Router
+ * @param  pattern Topic filter, '+' and '#' only as whole levels, '#' last
+ * @param  handler Function called for the matching topics
+ * @retval true if the pattern was added, false if it is invalid, already
+ *         added or the router is full
+ */
+bool TopicRouter_add(TopicRouter_t *router, const char *pattern, TopicHandler_t handler)
+{
+    const char *level = pattern;
+    uint8_t node = TOPIC_ROUTER_ROOT;
+    uint8_t wildcards = 0;
+
+    if ((pattern == NULL) || (*pattern == '\0') || (handler == NULL) ||
+        (router->routeCount >= TOPIC_ROUTER_MAX_ROUTES))
+    {
+        return false;
+    }
+
+    while (level != NULL)
+    {
+        const char *slash = strchr(level, '/');
+        size_t length = (slash != NULL) ? (size_t)(slash - level) : strlen(level);
+        uint8_t type = TOPIC_LEVEL_LITERAL;
+
+        if (length > UINT8_MAX)
+        {
+            return false;
+        }
+        if ((length == 1) && (*level == '+'))
+        {
+            type = TOPIC_LEVEL_PLUS;
+        }
+        else if ((length == 1) && (*level == '#'))
+        {
+            if (slash != NULL)
+            {
+                return false;
+            }
+            type = TOPIC_LEVEL_HASH;
+        }
+        else if ((memchr(level, '+', length) != NULL) || (memchr(level, '#', length) != NULL))
+        {
+            return false;
+        }
+        if ((type != TOPIC_LEVEL_LITERAL) && (++wildcards > TOPIC_ROUTER_MAX_CAPTURES))
+        {
+            return false;
+        }
+
+        node = TopicRouter_child(router, node, level, (uint8_t)length, type);
+        if (node == 0)
+        {
+            return false;
+        }
+        level = (slash != NULL) ? slash + 1 : NULL;
+    }
+
+    if (router->nodes[node].route != 0)
+    {
+        return false;
+    }
+    router->handlers[router->routeCount++] = handler;
+    router->nodes[node].route = router->routeCount;
+    return true;
+}
+
+/**
+ * @brief  Match the rest of a topic below a node, backtracking to the less
+ *         specific children when a branch fails
+ * @param  router Router
+ * @param  index Node matching the topic up to level
+ * @param  level Next topic level, NULL after the last one
+ * @param  end End of the topic
+ * @param  match Captures, restored when a branch fails
+ * @param  route Matching route plus 1
+ * @retval true if a route matches
+ */
+static bool TopicRouter_matchNode(const TopicRouter_t *router, uint8_t index, const char *level, const char *end,
+                                  TopicMatch_t *match, uint8_t *route)
+{
+    const TopicRouterNode_t *node;
+    const char *next = NULL;
+    uint16_t length = 0;
+    uint8_t count = match->count;
+    /* Wildcards do not match a first level starting with '$' */
+    bool wildcards = !((index == TOPIC_ROUTER_ROOT) && (level != NULL) && (level < end) && (*level == '$'));
+
+    if (level == NULL)
+    {
+        if (router->nodes[index].route != 0)
+        {
+            *route = router->nodes[index].route;
+            return true;
+        }
+    }
+    else
+    {
+        const char *slash = (const char *)memchr(level, '/', (size_t)(end - level));
+
+        length = (uint16_t)(((slash != NULL) ? slash : end) - level);
+        next = (slash != NULL) ? slash + 1 : NULL;
+    }
+
+    for (uint8_t i = router->nodes[index].child; i != 0; i = node->sibling)
+    {
+        node = &router->nodes[i];
+        if (node->type == TOPIC_LEVEL_HASH)
+        {
+            if (!wildcards)
+            {
+                break;
+            }
+            /* Also matches the parent level alone */
+            match->captures[count].data = (level != NULL) ? level : end;
+            match->captures[count].length = (level != NULL) ? (uint16_t)(end - level) : 0;
+            match->count = count + 1;
+            *route = node->route;
+            return true;
+        }
+        if (level == NULL)
+        {
+            continue;
+        }
+        if (node->type == TOPIC_LEVEL_PLUS)
+        {
+            if (!wildcards)
+            {
+                continue;
+            }
+            match->captures[count].data = level;
+            match->captures[count].length = length;
+            match->count = count + 1;
+        }
+        else if ((node->length != length) || (0 != memcmp(node->level, level, length)))
+        {
+            continue;
+        }
+        if (TopicRouter_matchNode(router, i, next, end, match, route))
+        {
+            return true;
+        }
+        match->count = count;
+    }
+    return false;
+}
+
+/**
+ * @brief  Find the most specific pattern matching a topic
+ * @param  router Router
+ * @param  topic Received topic, not modified
+ * @param  length Length of the topic
+ * @param  match Wildcard captures of the match
+ * @param  handler Handler of the matching pattern
+ * @retval true if a pattern matches
+ */
+bool TopicRouter_match(const TopicRouter_t *router, const char *topic, uint16_t length, TopicMatch_t *match,
+                       TopicHandler_t *handler)
+{
+    uint8_t route = 0;
+
+    match->topic = topic;
+    match->topicLength = length;
+    match->count = 0;
+    if ((topic == NULL) || (length == 0) ||
+        !TopicRouter_matchNode(router, TOPIC_ROUTER_ROOT, topic, topic + length, match, &route))
+    {
+        return false;
+    }
+    *handler = router->handlers[route - 1];
+    return true;
+}
+
+/**
+ * @brief  Call the handler of the most specific pattern matching a topic
+ * @param  router Router
+ * @param  topic Received topic, not modified
+ * @param  length Length of the topic
+ * @param  message Passed to the handler, e.g. the parsed payload
+ * @retval true if a handler was called
+ */
+bool TopicRouter_dispatch(const TopicRouter_t *router, const char *topic, uint16_t length, void *message)
+{
+    TopicMatch_t match;
+    TopicHandler_t handler;
+
+    if (!TopicRouter_match(router, topic, length, &match, &handler))
+    {
+        return false;
+    }
+    handler(&match, message);
+    return true;
+}
+
+/**
+ * @brief  Find a property in a property bag like "?$rid=1&$version=2"
+ * @param  properties Topic level holding the properties
+ * @param  name Property name, e.g. "$rid"
+ * @param  value Property value, empty if the property has no '='
+ * @retval true if the property was found
+ */
+bool TopicRouter_getProperty(const TopicSpan_t *properties, const char *name, TopicSpan_t *value)
+{
+    const char *property = properties->data;
+    const char *end = properties->data + properties->length;
+    size_t nameLength = strlen(name);
+
+    if ((property < end) && (*property == '?'))
+    {
+        property++;
+    }
+    while (property < end)
+    {
+        const char *next = (const char *)memchr(property, '&', (size_t)(end - property));
+        const char *propertyEnd = (next != NULL) ? next : end;
+        const char *equals = (const char *)memchr(property, '=', (size_t)(propertyEnd - property));
+        const char *nameEnd = (equals != NULL) ? equals : propertyEnd;
+
+        if (((size_t)(nameEnd - property) == nameLength) && (0 == memcmp(property, name, nameLength)))
+        {
+            value->data = (equals != NULL) ? equals + 1 : propertyEnd;
+            value->length = (uint16_t)(propertyEnd - value->data);
+            return true;
+        }
+        if (next == NULL)
+        {
+            break;
+        }
+        property = next + 1;
+    }
+    return false;
+}
+
+/**
+ * @brief  Compare a span with a string
+ * @param  span Span
+ * @param  text Null terminated string
+ * @retval true if both are equal
+ */
+bool TopicSpan_equals(const TopicSpan_t *span, const char *text)
+{
+    return (strlen(text) == span->length) && (0 == memcmp(span->data, text, span->length));
+}
+
+/**
+ * @brief  Parse a decimal number at the start of a span
+ * @param  span Span
+ * @retval Number, 0 if the span does not start with one
+ */
+long TopicSpan_toLong(const TopicSpan_t *span)
+{
+    long value = 0;
+    bool negative = false;
+    uint16_t i = 0;
+
+    if ((span->length > 0) && (span->data[0] == '-'))
+    {
+        negative = true;
+        i++;
+    }
+    for (; (i < span->length) && (span->data[i] >= '0') && (span->data[i] <= '9'); i++)
+    {
+        value = value * 10 + (span->data[i] - '0');
+    }
+    return negative ? -value : value;
+}
+
+/**
+ * @brief  Copy a span to a null terminated string
+ * @param  span Span
+ * @param  buffer Destination
+ * @param  size Size of the destination
+ * @retval true if the span fits, the buffer is empty otherwise
+ */
+bool TopicSpan_copy(const TopicSpan_t *span, char *buffer, size_t size)
+{
+    if ((size == 0) || (span->length >= size))
+    {
+        if (size > 0)
+        {
+            buffer[0] = '\0';
+        }
+        return false;
+    }
+    memcpy(buffer, span->data, span->length);
+    buffer[span->length] = '\0';
+    return true;
+}
+/**         EOF         */
@@ -0,0 +1,107 @@
+/**
+ * \file
+ * \brief MQTT topic router.
+ *
+ * Subscription patterns with the MQTT wildcards '+' (one level) and '#'
+ * (the remaining levels) are compiled once into a trie of topic levels.
+ * A received topic is then matched level by level in one pass without
+ * copying or modifying it: literal levels are tried before '+' and '+'
+ * before '#', so the most specific pattern wins. The levels matched by
+ * the wildcards are handed to the handler as spans into the topic.
+ *
+ * \copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+
+#ifndef TOPICROUTER_H
+#define TOPICROUTER_H
+
+/**         Includes         */
+
+#include "ConfigPlatform.h"
+
+/* Trie levels of all patterns of a router, the root included */
+#ifndef TOPIC_ROUTER_MAX_NODES
+#define TOPIC_ROUTER_MAX_NODES 24
+#endif
+
+#ifndef TOPIC_ROUTER_MAX_ROUTES
+#define TOPIC_ROUTER_MAX_ROUTES 8
+#endif
+
+/* Wildcards of one pattern */
+#define TOPIC_ROUTER_MAX_CAPTURES 6
+
+/**         Functions definition         */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /* Part of a topic, not null terminated */
+    typedef struct
+    {
+        const char *data;
+        uint16_t length;
+    } TopicSpan_t;
+
+    typedef struct
+    {
+        const char *topic;
+        uint16_t topicLength;
+        uint8_t count;                                  /* Wildcards matched */
+        TopicSpan_t captures[TOPIC_ROUTER_MAX_CAPTURES]; /* In pattern order, '#' captures the rest of the topic */
+    } TopicMatch_t;
+
+    typedef void (*TopicHandler_t)(const TopicMatch_t *match, void *message);
+
+    typedef struct
+    {
+        uint8_t length;
+        uint8_t type;    /* Literal, '+' or '#' */
+        uint8_t child;   /* First child, 0 if none */
+        uint8_t sibling; /* Next child of the parent, 0 if none */
+        uint8_t route;   /* Route ending at this level plus 1, 0 if none */
+        const char *level;
+    } TopicRouterNode_t;
+
+    typedef struct
+    {
+        TopicRouterNode_t nodes[TOPIC_ROUTER_MAX_NODES];
+        TopicHandler_t handlers[TOPIC_ROUTER_MAX_ROUTES];
+        uint8_t nodeCount;
+        uint8_t routeCount;
+    } TopicRouter_t;
+
+    void TopicRouter_init(TopicRouter_t *router);
+    bool TopicRouter_add(TopicRouter_t *router, const char *pattern, TopicHandler_t handler);
+    bool TopicRouter_match(const TopicRouter_t *router, const char *topic, uint16_t length, TopicMatch_t *match,
+                           TopicHandler_t *handler);
+    bool TopicRouter_dispatch(const TopicRouter_t *router, const char *topic, uint16_t length, void *message);
+    bool TopicRouter_getProperty(const TopicSpan_t *properties, const char *name, TopicSpan_t *value);
+    bool TopicSpan_equals(const TopicSpan_t *span, const char *text);
+    long TopicSpan_toLong(const TopicSpan_t *span);
+    bool TopicSpan_copy(const TopicSpan_t *span, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOPICROUTER_H */
@@ -0,0 +1,140 @@
+"""Minify and compress the web files written to Calypso into C byte arrays.
+
+The files in GW/web are minified, compressed with raw DEFLATE and written to
+Common/PnP_Device_API/PnP_Web_Assets.{c,h}. The gateway inflates them with
+Common/Utilities/inflate.c while writing them to the module.
+
+Runs before each PlatformIO build (extra_scripts in platformio.ini), or by
+hand:
+
+    python3 GW/scripts/web_assets.py
+
+The output files are only written if their content changed.
+"""
+
+import os
+import zlib
+
+# Must not exceed INFLATE_WINDOW_BITS of Common/Utilities/inflate.h
+WINDOW_BITS = 10
+
+# Source file in GW/web, C array, macro prefix
+ASSETS = [
+    ("index_src.html", "indexHtmlSrcFile", "INDEX_HTML_SRC_FILE"),
+    ("index.html", "indexHtmlFile", "INDEX_HTML_FILE"),
+    ("kaaiot.html", "kaaiotHtmlFile", "KAAIOT_HTML_FILE"),
+    ("js/kaaiot.js", "kaaiotJsFile", "KAAIOT_JS_FILE"),
+]
+
+HEADER_PREFIX = """/**
+ * \\file
+ * \\brief Web files written to Calypso, compressed with raw DEFLATE.
+ *
+ * Generated by GW/scripts/web_assets.py from GW/web, do not edit.
+ *
+ * \\copyright (c) 2022 Würth Elektronik eiSos GmbH & Co. KG
+ *
+ * \\page License
+ *
+ * THE SOFTWARE INCLUDING THE SOURCE CODE IS PROVIDED “AS IS”. YOU ACKNOWLEDGE THAT WÜRTH ELEKTRONIK
+ * EISOS MAKES NO REPRESENTATIONS AND WARRANTIES OF ANY KIND RELATED TO, BUT NOT LIMITED
+ * TO THE NON-INFRINGEMENT OF THIRD PARTIES’ INTELLECTUAL PROPERTY RIGHTS OR THE
+ * MERCHANTABILITY OR FITNESS FOR YOUR INTENDED PURPOSE OR USAGE. WÜRTH ELEKTRONIK EISOS DOES NOT
+ * WARRANT OR REPRESENT THAT ANY LICENSE, EITHER EXPRESS OR IMPLIED, IS GRANTED UNDER ANY PATENT
+ * RIGHT, COPYRIGHT, MASK WORK RIGHT, OR OTHER INTELLECTUAL PROPERTY RIGHT RELATING TO ANY
+ * COMBINATION, MACHINE, OR PROCESS IN WHICH THE PRODUCT IS USED. INFORMATION PUBLISHED BY
+ * WÜRTH ELEKTRONIK EISOS REGARDING THIRD-PARTY PRODUCTS OR SERVICES DOES NOT CONSTITUTE A LICENSE
+ * FROM WÜRTH ELEKTRONIK EISOS TO USE SUCH PRODUCTS OR SERVICES OR A WARRANTY OR ENDORSEMENT
+ * THEREOF
+ *
+ * THIS SOURCE CODE IS PROTECTED BY A LICENSE.
+ * FOR MORE INFORMATION PLEASE CAREFULLY READ THE LICENSE AGREEMENT FILE LOCATED
+ * IN THE ROOT DIRECTORY OF THIS PACKAGE
+ */
+"""
+
+
+def minify(data):
+    """Drop the indentation and the empty lines. The line ends are kept, the
+    files have no constructs where they would differ from a space."""
+    lines = [line.strip() for line in data.decode("utf-8").split("\n")]
+    return "\n".join(line for line in lines if line).encode("utf-8")
+
+
+def compress(data):
+    compressor = zlib.compressobj(9, zlib.DEFLATED, -WINDOW_BITS, 9)
+    return compressor.compress(data) + compressor.flush()
+
+
+def format_array(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def write_if_changed(path, text):
+    if os.path.exists(path):
+        with open(path, "r", encoding="utf-8", newline="") as f:
+            if f.read() == text:
+                return False
+    with open(path, "w", encoding="utf-8", newline="") as f:
+        f.write(text)
+    return True
+
+
+def generate(root):
+    web_dir = os.path.join(root, "GW", "web")
+    out_dir = os.path.join(root, "Common", "PnP_Device_API")
+    header = [HEADER_PREFIX,
+              "#ifndef P_N_P_WEB_ASSETS_H",
+              "#define P_N_P_WEB_ASSETS_H",
+              "",
+              "#include <stdint.h>",
+              "",
+              "#ifdef __cplusplus",
+              "extern \"C\"",
+              "{",
+              "#endif",
+              "",
+              "/*Window of the compressor, the inflater needs as many bytes*/",
+              "#define WEB_ASSETS_WINDOW_BITS %d" % WINDOW_BITS,
+              ""]
+    source = [HEADER_PREFIX, "#include \"PnP_Web_Assets.h\"", ""]
+    total_source = 0
+    total_minified = 0
+    total_compressed = 0
+
+    for name, array, macro in ASSETS:
+        with open(os.path.join(web_dir, name), "rb") as f:
+            original = f.read()
+        data = minify(original)
+        compressed = compress(data)
+        total_source += len(original)
+        total_minified += len(data)
+        total_compressed += len(compressed)
+
+        header.append("/*%s: %d bytes, %d compressed*/" % (name, len(data), len(compressed)))
+        header.append("#define %s_LENGTH %d" % (macro, len(data)))
+        header.append("#define %s_SIZE %d" % (macro, len(compressed)))
+        header.append("    extern const uint8_t %s[%s_SIZE];" % (array, macro))
+        header.append("")
+        source.append("const uint8_t %s[%s_SIZE] = {" % (array, macro))
+        source.append(format_array(compressed))
+        source.append("};")
+        source.append("")
+
+    header += ["#ifdef __cplusplus", "}", "#endif", "", "#endif /* P_N_P_WEB_ASSETS_H */", ""]
+    changed = write_if_changed(os.path.join(out_dir, "PnP_Web_Assets.h"), "\n".join(header))
+    changed |= write_if_changed(os.path.join(out_dir, "PnP_Web_Assets.c"), "\n".join(source))
+    print("Web assets: %d bytes, %d minified, %d compressed%s" %
+          (total_source, total_minified, total_compressed, "" if changed else ", unchanged"))
+
+
+try:
+    Import("env")  # noqa: F821, defined by PlatformIO
+    ROOT = os.path.join(env.subst("$PROJECT_DIR"), os.pardir)  # noqa: F821
+except NameError:
+    ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, os.pardir)
+
+generate(os.path.normpath(ROOT))
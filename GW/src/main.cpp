@@ -30,31 +30,83 @@
 //------User Debug Interface
 TypeSerial *Debug;
 
-enum
+typedef enum
 {
     invalidFirmwareVersion,
     waitingForConfig,
     configuringDevice,
-    provisioning,
     connectingToCloud,
     idle,
-    sendSensorData,
+    reconnecting,
     errorState,
     factoryReset,
     numOfStatus
-} statusFlag;
+} GatewayStatus_t;
+
+GatewayStatus_t statusFlag;
+
+/* Task periods in ms */
+#define CONNECTIVITY_CHECK_PERIOD 100
+#define SAMPLER_PERIOD 50
+#define CONFIG_BLINK_PERIOD 3500
+#define INVALID_FIRMWARE_PERIOD 5000
+#define ERROR_STATE_PERIOD 1000
+#define EVENT_MESSAGE_DURATION 5000
+#define FACTORY_RESET_DELAY 1000
+#define RECONNECT_MESSAGE_DELAY 2000
+
+/* Task priorities, 0 is the most urgent */
+enum
+{
+    uiPriority,
+    cloudPriority,
+    connectivityPriority,
+    samplerPriority,
+    publisherPriority
+};
+
+/* Events, 0 is SCHEDULER_EVENT_TIMER */
+enum
+{
+    uiButtonA = 1,
+    uiButtonBLong,
+    uiButtonC,
+    uiButtonCLong
+};
 
-/*Timer to periodically send sensor data*/
-unsigned long startTime = 0;
-unsigned long interval = 0;
-volatile uint8_t buttonPressCount = 0;
+enum
+{
+    connectivityEnter = 1
+};
+
+enum
+{
+    cloudMessage = 1
+};
+
+SchedulerTask_t uiTask;
+SchedulerTask_t cloudTask;
+SchedulerTask_t connectivityTask;
+SchedulerTask_t samplerTask;
+SchedulerTask_t publisherTask;
 
 char displayText[150];
 char displayEventText[120];
 
-extern IoT_platforms_t platform;
-
 bool previousConfigDeleted = false;
+bool configLedOn = false;
+bool cloudMessagePosted = false;
+
+/**
+ * @brief  Switch the connectivity manager to a new state
+ * @param  status new state
+ * @retval None
+ */
+static void setStatus(GatewayStatus_t status)
+{
+    statusFlag = status;
+    Scheduler_post(&connectivityTask, connectivityEnter);
+}
 
 // Long press callback
 void OnBtnLongPress_A()
@@ -63,71 +115,384 @@ void OnBtnLongPress_A()
 
 void OnBtnLongPress_B()
 {
-    // switch to another platform
-    if ((platform == AZURE) && Device_writeConfigFile(PLATFORM_CONFIG_FILE_PATH, "{\"platform\":\"KAAIOT\"}"))
+    Scheduler_post(&uiTask, uiButtonBLong);
+}
+
+void OnBtnLongPress_C()
+{
+    Scheduler_post(&uiTask, uiButtonCLong);
+}
+
+void OnBtnPress_A()
+{
+#if SERIAL_DEBUG
+    Scheduler_post(&uiTask, uiButtonA);
+#endif
+}
+
+void OnBtnPress_B()
+{
+}
+
+// Switch the device to configuration mode
+void OnBtnPress_C()
+{
+    Scheduler_post(&uiTask, uiButtonC);
+}
+
+/**
+ * @brief  UI task: button actions and temporary messages
+ */
+static void uiHandler(SchedulerTask_t *task, uint8_t event)
+{
+    const Device_Platform_t *nextPlatform;
+
+    switch (event)
     {
-        SSerial_printf(Debug, "Platform config switched to KAAIOT. Reboot device to apply changes\r\n");
-        sprintf(displayEventText, "Platform config\r\n\r\nswitched to KAAIOT.\r\n\r\nReboot device\r\n\r\nto apply changes");
-        Device_displayMessageWithDelay(displayEventText);
+    case SCHEDULER_EVENT_TIMER:
+        /* End of a temporary message */
         if (statusFlag == waitingForConfig)
         {
             SH1107_Display(1, 0, 0, displayText);
         }
-    }
+        break;
 
-    else if ((platform == KAAIOT) && Device_writeConfigFile(PLATFORM_CONFIG_FILE_PATH, "{\"platform\":\"AZURE\"}"))
-    {
-        SSerial_printf(Debug, "Platform config switched to AZURE. Reboot device to apply changes\r\n");
-        sprintf(displayEventText, "Platform config\r\n\r\nswitched to AZURE.\r\n\r\nReboot device\r\n\r\nto apply changes");
-        Device_displayMessageWithDelay(displayEventText);
+#if SERIAL_DEBUG
+    /* Statistics on the debug port, each reset for the next measurement */
+    case uiButtonA:
+        Scheduler_printStats(Debug);
+        Scheduler_resetStats();
+        Idle_printStats(Debug);
+        Idle_resetStats();
+        Calypso_MQTTprintStats(Debug);
+        Calypso_MQTTresetStats();
+        Device_printLinkStats(Debug);
+        Device_resetLinkStats();
+        break;
+#endif
+
+    case uiButtonBLong:
+        // switch to the next platform built into the firmware
+        nextPlatform = Device_getNextPlatform();
+        if ((nextPlatform != NULL) && Device_savePlatformId(nextPlatform->id))
+        {
+            SSerial_printf(Debug, "Platform config switched to %s. Reboot device to apply changes\r\n", nextPlatform->name);
+            sprintf(displayEventText, "Platform config\r\n\r\nswitched to %s.\r\n\r\nReboot device\r\n\r\nto apply changes", nextPlatform->name);
+        }
+        else
+        {
+            SSerial_printf(Debug, "Unknown platform selected\r\n");
+            break;
+        }
+        SH1107_Display(1, 0, 0, displayEventText);
+        Scheduler_startTimer(task, EVENT_MESSAGE_DURATION, 0);
+        break;
+
+    case uiButtonC:
         if (statusFlag == waitingForConfig)
         {
-            SH1107_Display(1, 0, 0, displayText);
+            previousConfigDeleted = true;
+            setStatus(configuringDevice);
         }
+        break;
+
+    case uiButtonCLong:
+        setStatus(factoryReset);
+        break;
+
+    default:
+        break;
     }
+}
 
-    else
+/**
+ * @brief  Cloud command task: handle the messages sent by the cloud, one
+ *         per cloudMessage event posted by the background function
+ */
+static void cloudHandler(SchedulerTask_t *task, uint8_t event)
+{
+    (void)task;
+    if (event == cloudMessage)
     {
-        SSerial_printf(Debug, "Unknown platform selected\r\n");
-        return;
+        cloudMessagePosted = false;
+        Device_processCloudMessage();
     }
 }
 
-void OnBtnLongPress_C()
+/**
+ * @brief  Sampler task: motion events and sensor FIFOs
+ */
+static void samplerHandler(SchedulerTask_t *task, uint8_t event)
 {
-    statusFlag = factoryReset;
+    (void)task;
+    (void)event;
+    Device_processMotionEvents();
+    Device_processSensorFifo();
 }
 
-void OnBtnPress_A()
+/**
+ * @brief  Publisher task: telemetry at the send interval set by the cloud
+ */
+static void publisherHandler(SchedulerTask_t *task, uint8_t event)
 {
+    (void)event;
+    if (Device_isSensorsPresent() == true)
+    {
+        SSerial_printf(Debug, "Publishing sensor data...\r\n");
+        Device_PublishSensorData();
+        Device_displaySensorData();
+    }
+    Scheduler_startTimer(task, Device_getTelemetrySendInterval(), 0);
 }
 
-void OnBtnPress_B()
+/**
+ * @brief  Start or stop the tasks that need the cloud connection
+ * @param  run true to start them
+ * @retval None
+ */
+static void runCloudTasks(bool run)
 {
+    if (run)
+    {
+        Scheduler_startTimer(&samplerTask, 0, SAMPLER_PERIOD);
+        Scheduler_startTimer(&publisherTask, 0, 0);
+    }
+    else
+    {
+        Scheduler_stopTimer(&samplerTask);
+        Scheduler_stopTimer(&publisherTask);
+    }
 }
 
-// Switch the device to configuration mode
-void OnBtnPress_C()
+/**
+ * @brief  Connectivity manager task: configuration, cloud connection and
+ *         error states. Entered with connectivityEnter on a state change,
+ *         then on its timer.
+ */
+static void connectivityHandler(SchedulerTask_t *task, uint8_t event)
 {
-    buttonPressCount++;
-    if (buttonPressCount >= 1)
+    if (event == connectivityEnter)
     {
-        if (statusFlag == waitingForConfig)
+        Scheduler_stopTimer(task);
+        runCloudTasks(statusFlag == idle);
+    }
+
+    switch (statusFlag)
+    {
+    case invalidFirmwareVersion:
+        if (event == connectivityEnter)
         {
-            statusFlag = configuringDevice;
-            previousConfigDeleted = true;
+            Scheduler_startTimer(task, INVALID_FIRMWARE_PERIOD, INVALID_FIRMWARE_PERIOD);
         }
-        buttonPressCount = 0;
+        neopixelSet(NEO_PIXEL_RED);
+        // The kit requires a minimum software version on Calypso
+        SSerial_printf(Debug, "Older firmware detected\r\n");
+        sprintf(displayText, "Calypso Firmware old \r\n\r\nUpdate Calypso");
+        SH1107_Display(1, 0, 16, displayText);
+        break;
+
+    case waitingForConfig:
+        /*Waiting on button press from the user*/
+        break;
+
+    case configuringDevice:
+        if (event == connectivityEnter)
+        {
+            if (!previousConfigDeleted)
+            {
+                Device_deletePreviousConfigIfExist();
+                previousConfigDeleted = true;
+            }
+            configLedOn = false;
+            Scheduler_startTimer(task, 0, CONFIG_BLINK_PERIOD);
+            break;
+        }
+        configLedOn = !configLedOn;
+        if (configLedOn)
+        {
+            Device_WiFi_provisioning();
+            Device_configurationInProgress();
+            neopixelSet(NEO_PIXEL_RED);
+        }
+        else
+        {
+            neopixelSet(NEO_PIXEL_OFF);
+        }
+        break;
+
+    case connectingToCloud:
+    {
+        unsigned long retryMs;
+
+        if (event == connectivityEnter)
+        {
+            neopixelSet(NEO_PIXEL_ORANGE);
+            if (Device_getPlatformDriver() != NULL)
+            {
+                sprintf(displayText, "Connecting to \r\n\r\n%s...", Device_getPlatformDriver()->displayName);
+            }
+            SH1107_Display(1, 0, 16, displayText);
+            SH1107_Flush();
+            /* One attempt per run, failed attempts are retried with the
+             * backoff of the reconnects */
+            Device_openLink();
+            Scheduler_startTimer(task, 0, 0);
+            break;
+        }
+        if (Device_recoverLink(&retryMs))
+        {
+            neopixelSet(NEO_PIXEL_GREEN);
+            setStatus(idle);
+            break;
+        }
+        Scheduler_startTimer(task, retryMs, 0);
+        break;
+    }
+
+    case idle:
+        if (event == connectivityEnter)
+        {
+            Scheduler_startTimer(task, CONNECTIVITY_CHECK_PERIOD, CONNECTIVITY_CHECK_PERIOD);
+        }
+        else if (!Device_isLinkUp())
+        {
+            setStatus(reconnecting);
+        }
+        else
+        {
+            Device_pollPublisher();
+        }
+        break;
+
+    case reconnecting:
+    {
+        unsigned long retryMs;
+
+        if (event == connectivityEnter)
+        {
+            /* First attempt right away */
+            neopixelSet(NEO_PIXEL_ORANGE);
+            Scheduler_startTimer(task, 0, 0);
+            break;
+        }
+        if (Device_recoverLink(&retryMs))
+        {
+            neopixelSet(NEO_PIXEL_GREEN);
+            setStatus(idle);
+            break;
+        }
+        if (retryMs >= RECONNECT_MESSAGE_DELAY)
+        {
+            sprintf(displayText, "Connection lost\r\n\r\nReconnecting...");
+            SH1107_Display(1, 0, 16, displayText);
+        }
+        Scheduler_startTimer(task, retryMs, 0);
+        break;
+    }
+
+    case errorState:
+        if (event == connectivityEnter)
+        {
+            Scheduler_startTimer(task, ERROR_STATE_PERIOD, ERROR_STATE_PERIOD);
+        }
+        neopixelSet(NEO_PIXEL_RED);
+        /*End up here only if the device is not configured correctly*/
+        SSerial_printf(Debug, "Error, unknown state...\r\n");
+        sprintf(displayText, "Error state: \r\nReset/reconfigure device");
+        SH1107_Display(1, 0, 24, displayText);
+        break;
+
+    case factoryReset:
+        if (event == connectivityEnter)
+        {
+            sprintf(displayText, "Reset device to \r\n\r\nFactory state");
+            SH1107_Display(1, 0, 16, displayText);
+            Scheduler_startTimer(task, FACTORY_RESET_DELAY, 0);
+            break;
+        }
+        SH1107_Flush();
+        neopixelSet(NEO_PIXEL_RED);
+        Device_reset();
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief  Work that a sleep would delay, checked with the interrupts masked
+ * @retval true if the main loop must not sleep
+ */
+static bool isBusy()
+{
+    return Scheduler_isReady() || !DebugLog_isEmpty();
+}
+
+/**
+ * @brief  Deepest sleep of the current state. Standby is only used while
+ *         the Calypso has nothing to send, its UART does not wake the CPU
+ *         up, and while no button is held. It stops the USB debug port, so
+ *         builds with SERIAL_DEBUG only idle.
+ * @retval Sleep mode for the idle manager
+ */
+static IdleMode_t idleMode()
+{
+#if SERIAL_DEBUG
+    return IDLE_MODE_SLEEP;
+#else
+    switch (statusFlag)
+    {
+    case invalidFirmwareVersion:
+    case waitingForConfig:
+    case errorState:
+        return buttonIsPressed() ? IDLE_MODE_SLEEP : IDLE_MODE_STANDBY;
+    default:
+        return IDLE_MODE_SLEEP;
+    }
+#endif
+}
+
+/**
+ * @brief  Polled drivers, called on every pass of the scheduler
+ */
+static void background()
+{
+    buttonUpdate();
+    /* Completion callbacks of the background sensor and display transfers */
+    I2CPoll();
+    DebugLog_drain(DEBUG_LOG_DRAIN_RECORDS);
+    /* The Calypso UART is read on every pass, a received message wakes the
+     * cloud task without polling */
+    if ((statusFlag == idle) && !cloudMessagePosted && Device_isCloudMessagePending())
+    {
+        cloudMessagePosted = Scheduler_post(&cloudTask, cloudMessage);
     }
 }
 
 void setup()
 {
-    delay(9000);
+    bool platformConfigured;
 
     pinMode(BUTTON_A, INPUT_PULLUP);
     pinMode(BUTTON_B, INPUT_PULLUP);
 
+    /* All task timers share one hardware alarm */
+    if (wakeupAlarmInit())
+    {
+        TimerWheel_init(NULL, wakeupAlarmSet);
+    }
+
+    Scheduler_addTask(&uiTask, "ui", uiPriority, uiHandler);
+    Scheduler_addTask(&cloudTask, "cloud", cloudPriority, cloudHandler);
+    Scheduler_addTask(&connectivityTask, "connectivity", connectivityPriority, connectivityHandler);
+    Scheduler_addTask(&samplerTask, "sampler", samplerPriority, samplerHandler);
+    Scheduler_addTask(&publisherTask, "publisher", publisherPriority, publisherHandler);
+    Scheduler_setBackground(background);
+
+    /* Sleep while no task is ready, in the mode of the state */
+    Idle_init(isBusy, NULL);
+
     /*Initialize the OLED display*/
     SH1107_Init();
 
@@ -146,7 +511,8 @@ void setup()
     neopixelInit();
     neopixelSet(NEO_PIXEL_RED);
 
-    if (!Device_isIotPlatformConfigured())
+    platformConfigured = Device_isIotPlatformConfigured();
+    if (!platformConfigured)
     {
         SSerial_printf(Debug, "Device IoT platform not configured. Use web menu to configure.\r\n");
         sprintf(displayText, "Error! IoT platform\r\n\r\nnot configured\r\n\r\nUse following info\r\n\r\nto configure.");
@@ -158,21 +524,21 @@ void setup()
     {
         if (!Device_isConfigured()) /*Check if the device has the config file*/
         {
-            statusFlag = waitingForConfig;
             SSerial_printf(Debug, "Waiting for a device configuration...\r\n");
             SSerial_printf(Debug, "Push the button C twice to enter configuration mode\r\n");
             sprintf(displayText, "Device not configured\r\n\r\n\r\nTo switch platform:\r\n<- btn B long press\r\n\r\nTo configure:\r\n<- btn C double click");
             SH1107_Display(1, 0, 0, displayText);
             neopixelSet(NEO_PIXEL_RED);
+            setStatus(waitingForConfig);
         }
         else if (!Device_isConnectedToWiFi())
         {
-            statusFlag = waitingForConfig;
             SSerial_printf(Debug, "Device was not connected to WiFi. Maybe WiFi configuration is wrong. Check device configuration\r\n");
             SSerial_printf(Debug, "Push the button C twice to enter configuration mode\r\n");
             sprintf(displayText, "WiFi not connected\r\nCheck configuration!\r\n\r\nTo switch platform:\r\n<- btn B long press\r\n\r\nTo configure:\r\n<- btn C double click");
             SH1107_Display(1, 0, 0, displayText);
             neopixelSet(NEO_PIXEL_RED);
+            setStatus(waitingForConfig);
         }
         else
         {
@@ -180,137 +546,29 @@ void setup()
             SSerial_printf(Debug, "Device is configured\r\n");
             sprintf(displayText, "Device is configured");
             SH1107_Display(1, 0, 24, displayText);
-            LED_INDICATION_SHORT_DELAY;
-            statusFlag = connectingToCloud;
+            if (!Device_isBootSnapshotValid())
+            {
+                LED_INDICATION_SHORT_DELAY;
+                if (platformConfigured)
+                {
+                    /* All checks passed, the next boot takes the fast path */
+                    Device_saveBootSnapshot();
+                }
+            }
+            setStatus(connectingToCloud);
         }
     }
     else
     {
-        statusFlag = invalidFirmwareVersion;
+        setStatus(invalidFirmwareVersion);
     }
 }
 
 void loop()
 {
-    switch (statusFlag)
-    {
-
-    case invalidFirmwareVersion:
-    {
-        neopixelSet(NEO_PIXEL_RED);
-        // The kit requires a minimum software version on Calypso
-        SSerial_printf(Debug, "Older firmware detected\r\n");
-        sprintf(displayText, "Calypso Firmware old \r\n\r\nUpdate Calypso");
-        SH1107_Display(1, 0, 16, displayText);
-        LED_INDICATION_LONG_DELAY;
-        break;
-    }
-    break;
-
-    case waitingForConfig:
-        /*Waiting on button press from the user*/
-        break;
-    case configuringDevice:
-    {
-        if (!previousConfigDeleted)
-        {
-            Device_deletePreviousConfigIfExist();
-            previousConfigDeleted = true;
-        }
-        Device_WiFi_provisioning();
-        Device_configurationInProgress();
-        neopixelSet(NEO_PIXEL_RED);
-        delay(3500);
-        neopixelSet(NEO_PIXEL_OFF);
-        delay(3500);
-    }
-    break;
-
-    case provisioning:
+    if (!Scheduler_runOnce())
     {
-        neopixelSet(NEO_PIXEL_ORANGE);
-        if (Azure_Device_provision())
-        {
-            statusFlag = connectingToCloud;
-        }
-        else
-        {
-            sprintf(displayText, "Error:Provisioning failed");
-            SH1107_Display(1, 0, 24, displayText);
-            statusFlag = errorState;
-        }
-    }
-
-    case connectingToCloud:
-    {
-        neopixelSet(NEO_PIXEL_ORANGE);
-        if (platform == KAAIOT)
-        {
-            sprintf(displayText, "Connecting to \r\n\r\nKaaIoT...");
-        }
-        else if (platform == AZURE)
-        {
-            sprintf(displayText, "Connecting to \r\n\r\nAzure...");
-        }
-        SH1107_Display(1, 0, 16, displayText);
-
-        /*Connect to the cloud*/
-        Device_MQTTConnect();
-        Device_SubscribeToTopics();
-        neopixelSet(NEO_PIXEL_GREEN);
-        statusFlag = idle;
-
-        break;
+        Idle_setMode(idleMode());
+        Idle_enter();
     }
-    case idle:
-    {
-        if (!Device_isStatusOK())
-        {
-            Device_restart();
-        }
-        Device_processCloudMessage();
-        if (Device_isSensorsPresent() == true)
-        {
-            interval = micros() - startTime;
-            if (interval >= (Device_getTelemetrySendInterval() * 1000))
-            {
-                /*Time to send sensor data*/
-                statusFlag = sendSensorData;
-                startTime = micros();
-                interval = 0;
-            }
-        }
-    }
-    break;
-    case sendSensorData:
-    {
-        SSerial_printf(Debug, "Publishing sensor data...\r\n");
-        Device_PublishSensorData();
-        Device_displaySensorData();
-        statusFlag = idle;
-        break;
-    }
-    case errorState:
-    {
-        neopixelSet(NEO_PIXEL_RED);
-        /*End up here only if the device is not configured correctly*/
-        SSerial_printf(Debug, "Error, unknown state...\r\n");
-        sprintf(displayText, "Error state: \r\nReset/reconfigure device");
-        SH1107_Display(1, 0, 24, displayText);
-        LED_INDICATION_SHORT_DELAY;
-        break;
-    }
-    case factoryReset:
-    {
-        sprintf(displayText, "Reset device to \r\n\r\nFactory state");
-        SH1107_Display(1, 0, 16, displayText);
-        LED_INDICATION_SHORT_DELAY;
-        neopixelSet(NEO_PIXEL_RED);
-        Device_reset();
-    }
-    break;
-    default:
-        break;
-    }
-    buttonUpdate();
 }
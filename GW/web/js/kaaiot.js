@@ -0,0 +1,89 @@
+(function() {
+  var form = document.getElementById('kaaiot-form');
+  var fileInput = document.getElementById('file-input');
+  var fileListDisplay = document.getElementById('file-list-display');
+
+  form.addEventListener('submit', function(evnt) {
+    evnt.preventDefault();
+    var kaadevconf = {
+      token: document.getElementById('token').value,
+      appVersion: document.getElementById('appVersion').value,
+      mqttServer: document.getElementById('mqttServer').value,
+      sntpServer: document.getElementById('sntpServer').value,
+      timezone: document.getElementById('timezone').value,
+      wifiSsid: document.getElementById('wifiSsid').value,
+      wifiSecurityType: document.getElementById('wifiSecurityType').value,
+      wifiKey: document.getElementById('wifiKey').value
+    };
+    var jsonFile = createJSONFile(kaadevconf);
+    sendFile(jsonFile);
+
+    fileList.forEach(function(file) {
+      sendFile(file);
+    });
+  });
+
+  var fileList = [];
+  var renderFileList, sendFile;
+
+  fileInput.addEventListener('change', function(evnt) {
+    fileList = [];
+    for (var i = 0; i < fileInput.files.length; i++) {
+      fileList.push(fileInput.files[i]);
+    }
+    renderFileList();
+  });
+
+  renderFileList = function() {
+    fileListDisplay.innerHTML = '';
+    fileList.forEach(function(file, index) {
+      var fileDisplayEl = document.createElement('li');
+      fileDisplayEl.classList.add('list-group-item');
+      fileDisplayEl.id = file.name;
+      fileDisplayEl.innerHTML = file.name;
+      fileListDisplay.appendChild(fileDisplayEl);
+    });
+  };
+
+  function createJSONFile(data) {
+    var jsonString = JSON.stringify(data, null, 2);
+    var blob = new Blob([jsonString], {
+      type: 'application/json'
+    });
+    var file = new File([blob], "kaadevconf.json", {
+      type: 'application/json'
+    });
+    return file;
+  }
+
+  function sendFile(file) {
+    var formData = new FormData();
+    var request = new XMLHttpRequest();
+    request.onreadystatechange = () => {
+      if (request.readyState === XMLHttpRequest.DONE) {
+        var fileNameStr = "#" + request.responseURL.substring(request.responseURL.indexOf('=') + 1);
+        if (request.status === 200 || request.status === 204) {
+          if (request.responseText != "") {
+            $('.result').html(request.responseText);
+          } else {
+            $('.result').html("Success: " + request.status + ": " + request.statusText);
+            $(fileNameStr).html($(fileNameStr).html() + " - uploaded.");
+          }
+        } else {
+          $('.result').html("Error " + request.status + ": " + request.statusText);
+          $(fileNameStr).html($(fileNameStr).html() + " - error, file not uploaded!");
+        }
+      }
+      $('.result').css('display', 'block');
+    };
+    request.onerror = () => {
+      console.log("Failed to upload configuration");
+      $('.result').html("Error " + request.status + ": " + request.statusText);
+      document.getElementById('result').style.display = 'block';
+    };
+    formData.set('file', file);
+    var put_uri = "file?filename=" + file.name;
+    request.open("PUT", put_uri, true);
+    request.send(file);
+  }
+  })();